@@ -36,3 +36,15 @@ int AndJob::run()
 	delete[] prf_output;
 	return i_gate;
 }
+
+int PRFJob::run()
+{
+	ProgramParty& party = ProgramParty::s();
+	int n_parties = party.get_n_parties();
+	GarbledGate gate(n_parties);
+	auto& in_wires = *this->in_wires;
+	for (size_t i = start; i < end; i++)
+		gate.compute_prfs_outputs(&in_wires[2 * i], party.get_id(),
+				(*outputs)[i], gate_id + i);
+	return end - start;
+}
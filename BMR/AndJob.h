@@ -40,4 +40,34 @@ public:
 	int run();
 };
 
+/**
+ * PRF computation for a range of AND gates when garbling.
+ * Every job uses its own gate object for the PRF inputs
+ * and expands the key schedules locally.
+ */
+class PRFJob
+{
+	vector<const Register*>* in_wires;
+	vector<PRFOutputs>* outputs;
+
+public:
+	size_t start, end;
+	gate_id_t gate_id;
+
+	PRFJob() : in_wires(0), outputs(0), start(0), end(0), gate_id(0) {}
+
+	void reset(vector<const Register*>& in_wires,
+			vector<PRFOutputs>& outputs, size_t start, size_t end,
+			gate_id_t gate_id)
+	{
+		this->in_wires = &in_wires;
+		this->outputs = &outputs;
+		this->start = start;
+		this->end = end;
+		this->gate_id = gate_id;
+	}
+
+	int run();
+};
+
 #endif /* BMR_ANDJOB_H_ */
@@ -205,6 +205,8 @@ ProgramParty::ProgramParty() :
 	threshold = 128;
 	eval_threads = new Worker<AndJob>[N_EVAL_THREADS];
 	and_jobs.resize(N_EVAL_THREADS);
+	garble_threads = new Worker<PRFJob>[N_EVAL_THREADS];
+	prf_jobs.resize(N_EVAL_THREADS);
 }
 
 FakeProgramParty::FakeProgramParty(int argc, const char** argv) :
@@ -265,6 +267,7 @@ ProgramParty::~ProgramParty()
 		delete P;
 	}
 	delete[] eval_threads;
+	delete[] garble_threads;
 #ifdef VERBOSE
 	if (spdz_counters[SPDZ_LOAD])
 	    cerr << "SPDZ loading: " << spdz_counters[SPDZ_LOAD] << endl;
@@ -94,6 +94,9 @@ protected:
 	Worker<AndJob>* eval_threads;
 	vector<AndJob> and_jobs;
 
+	Worker<PRFJob>* garble_threads;
+	vector<PRFJob> prf_jobs;
+
 	ReceivedMsgStore output_masks_store;
 	ReceivedMsgStore input_masks_store;
 
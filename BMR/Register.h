@@ -337,6 +337,16 @@ public:
 	static void load(vector<GC::ReadAccess<T> >& accesses,
 			const NoMemory& source);
 
+	template <class T>
+	static void andrs(T& processor, const vector<int>& args)
+	{ garble_ands(processor, args, true); }
+	template <class T>
+	static void ands(T& processor, const vector<int>& args)
+	{ garble_ands(processor, args, false); }
+	template <class T>
+	static void garble_ands(GC::Processor<T>& processor,
+			const vector<int>& args, bool repeat);
+
 	void op(const PRFRegister& left, const PRFRegister& right, Function func);
 	void XOR(const Register& left, const Register& right);
 	void input(party_id_t from, char input = -1);
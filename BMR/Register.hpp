@@ -39,6 +39,72 @@ void PRFRegister::load(vector<GC::ReadAccess<T> >& accesses,
         }
 }
 
+template<class T>
+void PRFRegister::garble_ands(GC::Processor<T>& processor,
+		const vector<int>& args, bool repeat)
+{
+	ProgramParty& party = ProgramParty::s();
+	int total = 0;
+	for (size_t j = 0; j < args.size(); j += 4)
+		total += args[j];
+	if (total < party.threshold)
+	{
+		// run in single thread
+		processor.and_(args, repeat);
+		return;
+	}
+
+	// keys and gate numbers in the order of the single-threaded version
+	int dl = T::default_length;
+	vector<PRFRegister*> out_wires;
+	vector<const Register*> in_wires;
+	out_wires.reserve(total);
+	in_wires.reserve(2 * total);
+	gate_id_t gate_id = 0;
+	for (size_t j = 0; j < args.size(); j += 4)
+	{
+		for (int i = 0; i < args[j]; i += dl)
+			processor.S[args[j + 1] + i / dl].resize_regs(
+					min(args[j] - i, dl));
+		for (int i = 0; i < args[j]; i++)
+		{
+			auto& out = processor.S[args[j + 1] + i / dl].get_reg(i % dl);
+			out_wires.push_back(&out);
+			in_wires.push_back(
+					&processor.S[args[j + 2] + i / dl].get_reg(i % dl));
+			in_wires.push_back(
+					repeat ? &processor.S[args[j + 3]].get_reg(0) :
+							&processor.S[args[j + 3] + i / dl].get_reg(i % dl));
+			party.receive_keys(out);
+			gate_id_t id = party.new_gate();
+			if (out_wires.size() == 1)
+				gate_id = id;
+			assert(id == gate_id + out_wires.size() - 1);
+		}
+		processor.complexity += args[j];
+	}
+
+	vector<PRFOutputs> outputs(total, {party.get_n_parties()});
+	auto& jobs = party.prf_jobs;
+	size_t n_jobs = jobs.size();
+	for (size_t i = 0; i < n_jobs; i++)
+	{
+		jobs[i].reset(in_wires, outputs, total * i / n_jobs,
+				total * (i + 1) / n_jobs, gate_id);
+		party.garble_threads[i].request(jobs[i]);
+	}
+
+	// process the results in order while later jobs are still running
+	for (size_t i = 0; i < n_jobs; i++)
+	{
+		party.garble_threads[i].done();
+		for (size_t k = jobs[i].start; k < jobs[i].end; k++)
+			party.process_prf_output(outputs[k], out_wires[k],
+					static_cast<const PRFRegister*>(in_wires[2 * k]),
+					static_cast<const PRFRegister*>(in_wires[2 * k + 1]));
+	}
+}
+
 template <class T>
 void EvalRegister::store_clear_in_dynamic(GC::Memory<T>& mem,
 		const vector<GC::ClearWriteAccess>& accesses)
@@ -905,6 +905,12 @@ class sbitvec(_vec, _bit, _binary):
                     prog.use_edabit(backup)
                     return
                 comparison.require_ring_size(length, 'A2B conversion')
+                if prog.use_native_conversion() and length <= 64:
+                    self.v = [sbits.get_type(elements.size)()
+                              for i in range(length)]
+                    from Compiler.instructions import a2b
+                    a2b(elements, *self.v)
+                    return
                 l = int(Program.prog.options.ring)
                 r, r_bits = sint.get_edabit(length, size=elements.size)
                 c = ((elements - r) << (l - length)).reveal()
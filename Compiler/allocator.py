@@ -338,8 +338,9 @@ def determine_scope(block, options):
     block.used_from_scope = used_from_scope
 
 class Merger:
-    def __init__(self, block, options, merge_classes):
+    def __init__(self, block, options, merge_classes, free_classes=()):
         self.block = block
+        self.free_classes = free_classes
         self.instructions = block.instructions
         self.options = options
         if options.max_parallel_open:
@@ -385,9 +386,12 @@ class Merger:
         merge_nodes = self.open_nodes
         depths = self.depths
         self.req_num = defaultdict(lambda: 0)
-        if not merge_nodes:
+        if not merge_nodes and not self.free_classes:
             return 0
 
+        # needs to happen before merging changes the graph
+        free_merges = self.free_layers()
+
         # merge opens at same depth
         merges = defaultdict(list)
         for node in merge_nodes:
@@ -407,6 +411,11 @@ class Merger:
             self.do_merge(merge)
             self.req_num[t.__name__, 'round'] += 1
 
+        for merge in free_merges:
+            if len(merge) > 1:
+                self.counter[type(self.instructions[merge[0]])] += len(merge)
+                self.do_merge(merge)
+
         preorder = None
 
         if len(instructions) > 1000000:
@@ -418,6 +427,29 @@ class Merger:
 
         return len(merges)
 
+    def free_layers(self):
+        """ Group instructions without communication (e.g., XOR in
+        garbled circuits) by the round they follow and their local
+        depth within that round. Instructions in the same group are
+        independent and can be merged without adding rounds. """
+        G = self.G
+        depths = self.depths
+        levels = [0] * len(self.instructions)
+        layers = defaultdict(list)
+        for n, instr in enumerate(self.instructions):
+            if instr is None:
+                continue
+            level = 0
+            for i in G.pred[n]:
+                if depths[i] == depths[n]:
+                    level = max(level, levels[i])
+            if isinstance(instr, self.free_classes):
+                level += 1
+                layers[depths[n], level, instr.merge_id()].append(n)
+                G.add_node(n, merges=[])
+            levels[n] = level
+        return list(layers.values())
+
     def dependency_graph(self, merge_classes):
         """ Create the program dependency graph. """
         block = self.block
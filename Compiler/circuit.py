@@ -13,9 +13,86 @@ import math
 from Compiler.GC.types import *
 from Compiler.library import *
 from Compiler import util
+import Compiler.GC.instructions as inst
 import itertools
 import struct
 import os
+import pickle
+
+# parsed circuits by filename
+_parsed_circuits = {}
+
+def parse_circuit(filename):
+    """ Parse a circuit in Bristol Fashion and sort the gates by AND
+    depth. The result is cached in memory and in a file next to the
+    circuit, which is used as long as the circuit remains unchanged.
+
+    :returns: tuple of number of wires, numbers of input and output
+      wires, and list of layers. Each layer consists of the AND gates
+      of the same depth and the following XOR and INV gates, given as
+      tuples of inputs and output wires.
+
+    """
+    stat = os.stat(filename)
+    key = stat.st_mtime_ns, stat.st_size
+    if filename in _parsed_circuits and \
+       _parsed_circuits[filename][0] == key:
+        return _parsed_circuits[filename][1]
+    cache = filename + '.cache'
+    try:
+        with open(cache, 'rb') as f:
+            cached_key, res = pickle.load(f)
+        if cached_key == key:
+            _parsed_circuits[filename] = key, res
+            return res
+    except Exception:
+        pass
+
+    with open(filename) as f:
+        lines = iter(f)
+        next_line = lambda: next(lines).split()
+        n_gates, n_wires = (int(x) for x in next_line())
+        input_line = [int(x) for x in next_line()]
+        n_input_wires = input_line[1:]
+        assert(input_line[0] == len(n_input_wires))
+        output_line = [int(x) for x in next_line()]
+        n_output_wires = output_line[1:]
+        assert(output_line[0] == len(n_output_wires))
+        next(lines)
+
+        depth = [0] * n_wires
+        layers = []
+        for i in range(n_gates):
+            line = next_line()
+            t = line[-1]
+            if t in ('XOR', 'AND'):
+                assert line[0] == '2'
+                assert line[1] == '1'
+                assert len(line) == 6
+                gate = tuple(int(x) for x in line[2:5])
+                d = max(depth[gate[0]], depth[gate[1]]) + (t == 'AND')
+            elif t == 'INV':
+                assert line[0] == '1'
+                assert line[1] == '1'
+                assert len(line) == 5
+                gate = tuple(int(x) for x in line[2:4])
+                d = depth[gate[0]]
+            else:
+                continue
+            depth[gate[-1]] = d
+            while len(layers) <= d:
+                layers.append(([], []))
+            # AND gates only depend on lower depths
+            layers[d][t != 'AND'].append(gate)
+
+    res = n_wires, n_input_wires, n_output_wires, layers
+    _parsed_circuits[filename] = key, res
+    try:
+        with open(cache, 'wb') as f:
+            pickle.dump((key, res), f)
+    except Exception:
+        pass
+    return res
 
 class Circuit:
     """
@@ -54,7 +131,6 @@ class Circuit:
             if os.system('make Programs/Circuits'):
                 raise CompilerError('Cannot download circuit descriptions. '
                                     'Make sure make and git are installed.')
-        f = open(self.filename)
         self.functions = {}
 
     def __call__(self, *inputs):
@@ -81,25 +157,14 @@ class Circuit:
         return util.untuplify(res)
 
     def compile(self, *all_inputs):
-        f = open(self.filename)
-        lines = iter(f)
-        next_line = lambda: next(lines).split()
-        n_gates, n_wires = (int(x) for x in next_line())
+        n_wires, n_input_wires, self.n_output_wires, layers = \
+            parse_circuit(self.filename)
         self.n_wires = n_wires
-        input_line = [int(x) for x in next_line()]
-        n_inputs = input_line[0]
-        n_input_wires = input_line[1:]
-        assert(n_inputs == len(n_input_wires))
         inputs = []
         s = 0
         for n in n_input_wires:
             inputs.append(all_inputs[s:s + n])
             s += n
-        output_line = [int(x) for x in next_line()]
-        n_outputs = output_line[0]
-        self.n_output_wires = output_line[1:]
-        assert(n_outputs == len(self.n_output_wires))
-        next(lines)
 
         wires = [None] * n_wires
         self.wires = wires
@@ -110,23 +175,24 @@ class Circuit:
                 wires[i_wire] = reg
                 i_wire += 1
 
-        for i in range(n_gates):
-            line = next_line()
-            t = line[-1]
-            if t in ('XOR', 'AND'):
-                assert line[0] == '2'
-                assert line[1] == '1'
-                assert len(line) == 6
-                ins = [wires[int(line[2 + i])] for i in range(2)]
-                if t == 'XOR':
-                    wires[int(line[4])] = ins[0] ^ ins[1]
+        for ands, others in layers:
+            # one instruction for all AND gates of the same depth
+            args = []
+            for a, b, out in ands:
+                x, y = wires[a], wires[b]
+                if isinstance(x, sbits) and isinstance(y, sbits) and \
+                   x.n == y.n:
+                    wires[out] = x.new(n=x.n)
+                    args += [x.n, wires[out], x, y]
                 else:
-                    wires[int(line[4])] = ins[0] & ins[1]
-            elif t == 'INV':
-                assert line[0] == '1'
-                assert line[1] == '1'
-                assert len(line) == 5
-                wires[int(line[3])] = ~wires[int(line[2])]
+                    wires[out] = x & y
+            if args:
+                inst.ands(*args)
+            for gate in others:
+                if len(gate) == 3:
+                    wires[gate[2]] = wires[gate[0]] ^ wires[gate[1]]
+                else:
+                    wires[gate[1]] = ~wires[gate[0]]
 
         return self.wires[-sum(self.n_output_wires):]
 
@@ -94,6 +94,13 @@ class Compiler:
             dest="debug",
             help="keep track of trace for debugging",
         )
+        parser.add_option(
+            "--source-locations",
+            action="store_true",
+            dest="source_locations",
+            help="store the source line of every instruction "
+            "for profiling with --profile",
+        )
         parser.add_option(
             "-c",
             "--comparison",
@@ -228,6 +235,13 @@ class Compiler:
             "using direct conversion if supported "
             "(number of parties as argument)",
         )
+        parser.add_option(
+            "--native-conversion",
+            action="store_true",
+            dest="native_conversion",
+            help="convert between arithmetic and binary computation "
+            "with one instruction each (with -Y or -X)",
+        )
         parser.add_option(
             "--invperm",
             action="store_true",
@@ -518,6 +518,55 @@ def run_decision_tree(layers, data):
     bits = layers[h][0].equal(index, h)
     return pick(bits, layers[h][1])
 
+def _equal_rows(x, index, bit_length):
+    """ Matrix with entries ``x[j] == index[i]`` """
+    n, m = len(index), len(x)
+    left, right = sint.Matrix(n, m), sint.Matrix(n, m)
+    @for_range_opt(n)
+    def _(i):
+        left[i].assign_vector(x)
+        right[i].assign_vector(index.expand_to_vector(i, m))
+    res = sint.Matrix(n, m)
+    res.assign_vector(left.get_vector().equal(right.get_vector(), bit_length))
+    return res
+
+def _pick_rows(bits, x):
+    """ Dot product of every row with :py:obj:`x` """
+    x = Array.create_from(x)
+    if x.value_type == sint:
+        return bits.dot(x).get_vector()
+    else:
+        return x.value_type._new(bits.dot(Array.create_from(x[:].v))[:])
+
+def run_decision_tree_batch(layers, data):
+    """ Run decision tree against many samples at once. All samples
+    go through a level together using a matrix product for the
+    selection of node information and vectorized comparisons, so the
+    number of rounds only depends on the height.
+
+    :param layers: tree output by :py:class:`TreeTrainer`
+    :param data: sample data with row-wise samples
+      (:py:class:`~Compiler.types.Matrix`)
+    :returns: binary labels (:py:class:`~Compiler.types.Array`)
+
+    """
+    h = len(layers) - 1
+    n, m = data.sizes
+    columns = data.transpose()
+    index = sint.Array(n)
+    index.assign_all(1)
+    for k, layer in enumerate(layers[:-1]):
+        assert len(layer) == 3
+        bits = _equal_rows(layer[0], index, k)
+        threshold = _pick_rows(bits, layer[2])
+        key_index = _pick_rows(bits, layer[1])
+        key_bits = oram.demux_list(key_index.bit_decompose(util.log2(m)))
+        key = sum(columns[j][:] * key_bits[j] for j in range(m))
+        child = 2 * key < threshold
+        index[:] += child * 2 ** k
+    bits = _equal_rows(layers[h][0], index, h)
+    return Array.create_from(_pick_rows(bits, layers[h][1]))
+
 def test_decision_tree(name, layers, y, x, n_threads=None, time=False):
     if time:
         start_timer(100)
@@ -606,11 +655,7 @@ class TreeClassifier:
         :returns: sint array
 
         """
-        res = sint.Array(len(X))
-        @for_range(len(X))
-        def _(i):
-            res[i] = run_decision_tree(self.tree, X[i])
-        return res
+        return run_decision_tree_batch(self.tree, Matrix.create_from(X))
 
     def output(self):
         """ Output decision tree. """
@@ -293,6 +293,20 @@ class movint(base.Instruction):
     code = base.opcodes['MOVINT']
     arg_format = ['ciw','ci']
 
+@base.gf2n
+class memadvises(base.DoNotEliminateInstruction):
+    """ Hint how a secret memory range is going to be accessed. This
+    only has an effect with disk memory (``--disk-memory``).
+
+    :param: memory address base (regint)
+    :param: number of memory cells (regint)
+    :param: pattern (0: normal, 1: sequential, 2: random, 3: prefetch,
+      4: write back) (int)
+    """
+    __slots__ = []
+    code = base.opcodes['MEMADVISES']
+    arg_format = ['ci','ci','int']
+
 @base.vectorize
 class pushint(base.StackInstruction):
     """ Pushes clear integer register to the thread-local stack.
@@ -799,6 +813,11 @@ class mulm(base.MulBase):
     code = base.opcodes['MULM']
     arg_format = ['sw','s','c']
 
+    def __init__(self, *args, **kwargs):
+        super(mulm_class, self).__init__(*args, **kwargs)
+        # function-dependent preprocessing needs the clear value
+        program.mulm_operands.append(args[2])
+
 @base.gf2n
 @base.vectorize
 class divc(base.InvertInstruction):
@@ -1334,6 +1353,47 @@ class sedabit(base.Instruction):
     def add_usage(self, req_node):
         req_node.increment(('sedabit', len(self.args) - 1), self.get_size())
 
+@base.vectorize
+class a2b(base.Instruction):
+    """ Convert secret integers to binary secret sharing using loose
+    edaBits and a ripple-carry adder in the virtual machine (only
+    computation modulo a power of two and up to 64 bits).
+
+    :param: number of arguments to follow / number of bits plus one (int)
+    :param: source (sint)
+    :param: destination bit (sbit)
+    :param: (destination bit)...
+    """
+    __slots__ = []
+    code = base.opcodes['A2B']
+    arg_format = tools.chain(['s'], itertools.repeat('sbw'))
+    field_type = 'modp'
+
+    def add_usage(self, req_node):
+        n_bits = len(self.args) - 1
+        req_node.increment(('edabit', n_bits), self.get_size())
+        req_node.increment(('bit', 'triple'),
+                           self.get_size() * max(0, n_bits - 2))
+
+@base.vectorize
+class b2a(base.Instruction):
+    """ Convert bits in binary secret sharing to secret integers using
+    daBits in the virtual machine. The bits are in little-endian order.
+
+    :param: number of arguments to follow / number of bits plus one (int)
+    :param: destination (sint)
+    :param: bit (sbit)
+    :param: (bit)...
+    """
+    __slots__ = []
+    code = base.opcodes['B2A']
+    arg_format = tools.chain(['sw'], itertools.repeat('sb'))
+    field_type = 'modp'
+
+    def add_usage(self, req_node):
+        req_node.increment(('modp', 'dabit'),
+                           self.get_size() * (len(self.args) - 1))
+
 @base.vectorize
 class randoms(base.Instruction):
     """ Store fresh length-restricted random shares(s) in secret register
@@ -1867,6 +1927,33 @@ class readsocketc(base.IOInstruction):
     def has_var_args(self):
         return True
 
+class readsocketcasync(base.IOInstruction):
+    """ Receive one message of clear values from a client in the
+    background. The values are collected with
+    :py:class:`readsocketcbatch` together with the slot. The socket
+    cannot be used otherwise until then.
+
+    :param: client id (regint)
+    :param: slot (regint)
+    """
+    __slots__ = []
+    code = base.opcodes['READSOCKETCASYNC']
+    arg_format = ['ci','ci']
+
+class readsocketcbatch(base.IOInstruction):
+    """ Wait for the next messages received in the background in order
+    of arrival and store the slots as well as the values. Value
+    :math:`j` of message :math:`i` is stored at :math:`jN+i`.
+
+    :param: slots (regint vector of size :math:`N`)
+    :param: values (cint vector of size :math:`Nm`)
+    :param: number of messages :math:`N` (int)
+    :param: values per message :math:`m` (int)
+    """
+    __slots__ = []
+    code = base.opcodes['READSOCKETCBATCH']
+    arg_format = ['ciw','cw','int','int']
+
 class readsockets(base.IOInstruction):
     """ Read a variable number of secret shares (potentially with MAC)
     from a socket for a client id and store them in registers. If the
@@ -1951,6 +2038,28 @@ class writesocketshare(base.IOInstruction):
     def has_var_args(self):
         return True
 
+class writesocketsharebatch(base.IOInstruction):
+    """ Send a message of shares (without MACs) to each of several
+    clients in the background. Value :math:`j` for client :math:`i`
+    is at :math:`jN+i` in every source, and the message for every
+    client is ordered as for :py:class:`writesocketshare`.
+
+    :param: number of arguments to follow (int)
+    :param: client ids (regint vector of size :math:`N`)
+    :param: message type (must be 0)
+    :param: number of clients :math:`N` (int)
+    :param: values per client :math:`m` (int)
+    :param: source (sint vector of size :math:`Nm`)
+    :param: (repeat source)...
+    """
+    __slots__ = []
+    code = base.opcodes['WRITESOCKETSHAREBATCH']
+    arg_format = tools.chain(['ci', 'int', 'int', 'int'],
+                             itertools.repeat('s'))
+
+    def has_var_args(self):
+        return True
+
 class writesocketint(base.IOInstruction):
     """
     Write a variable number of 32-bit ints from registers into socket
@@ -2043,6 +2152,36 @@ class readsharesfromfile(base.VectorInstruction, base.IOInstruction):
     def has_var_args(self):
         return True
 
+class writecolumn(base.IOInstruction):
+    """ Append shares to the table column in
+    ``Persistence/Columns/<name>-P<playerno>.data``, creating it if
+    needed. The bit length and precision must match an existing column.
+
+    :param: source (sint)
+    :param: number of rows (int)
+    :param: bit length (int)
+    :param: fixed-point precision (int)
+    :param: column name (str)
+    """
+    __slots__ = []
+    code = base.opcodes['WRITECOLUMN']
+    arg_format = ['s','int','int','int','varstr']
+
+class readcolumn(base.IOInstruction):
+    """ Read consecutive rows from the table column in
+    ``Persistence/Columns/<name>-P<playerno>.data``.
+
+    :param: destination (sint)
+    :param: first row (regint)
+    :param: number of rows (int)
+    :param: bit length (int)
+    :param: fixed-point precision (int)
+    :param: column name (str)
+    """
+    __slots__ = []
+    code = base.opcodes['READCOLUMN']
+    arg_format = ['sw','ci','int','int','int','varstr']
+
 @base.gf2n
 @base.vectorize
 class raw_output(base.PublicFileIOInstruction):
@@ -2076,6 +2215,20 @@ class floatoutput(base.PublicFileIOInstruction):
     code = base.opcodes['FLOATOUTPUT']
     arg_format = ['p','c','c','c','c']
 
+@base.vectorize
+class blockoutput(base.PublicFileIOInstruction):
+    """ Binary output of a vector as one block of 64-bit integers in
+    ``Player-Data/Block-Output-P<playerno>-<threadno>``, written in
+    the background.
+
+    :param: player (int, -1 for all)
+    :param: fixed-point precision for the block header (int)
+    :param: source (cint)
+    """
+    __slots__ = []
+    code = base.opcodes['BLOCKOUTPUT']
+    arg_format = ['p','int','c']
+
 @base.vectorize
 class fixinput(base.PublicFileIOInstruction):
     """ Binary fixed-point input.
@@ -2704,6 +2857,36 @@ class conv2ds(base.DataInstruction, base.VarArgsInstruction, base.Mergeable):
             req_node.increment(('modp', 'dot product'),
                                args[14] * args[3] * args[4])
 
+class multruncprs(mul_base):
+    """ Multiplication of secret registers (vectors) followed by
+    probabilistic truncation of the products if supported by the
+    protocol.
+
+    :param: number of arguments to follow (multiple of six)
+    :param: vector size (int)
+    :param: result (sint)
+    :param: factor (sint)
+    :param: factor (sint)
+    :param: bit length of product (int)
+    :param: number of bits to truncate (int)
+    :param: (repeat the last six)...
+    """
+    __slots__ = []
+    code = base.opcodes['MULTRUNCPRS']
+    arg_format = tools.cycle(['int','sw','s','s','int','int'])
+    data_type = 'triple'
+    is_vec = lambda self: True
+
+    def get_repeat(self):
+        return sum(self.args[::6])
+
+    def get_def(self):
+        return sum((arg.get_all() for arg in self.args[1::6]), [])
+
+    def get_used(self):
+        return sum((arg.get_all()
+                    for arg in self.args[2::6] + self.args[3::6]), [])
+
 @base.vectorize
 class trunc_pr(base.VarArgsInstruction):
     """ Probabilistic truncation if supported by the protocol.
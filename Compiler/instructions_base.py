@@ -45,6 +45,7 @@ opcodes = dict(
     PUSHINT = 0xCE,
     POPINT = 0xCF,
     MOVINT = 0xD0,
+    MEMADVISES = 0xD3,
     # Machine
     LDTN = 0x10,
     LDARG = 0x11,
@@ -112,6 +113,7 @@ opcodes = dict(
     MATMULS = 0xAA,
     MATMULSM = 0xAB,
     CONV2DS = 0xAC,
+    MULTRUNCPRS = 0xAE,
     CHECK = 0xAF,
     PRIVATEOUTPUT = 0xAD,
     # Shuffling
@@ -125,6 +127,8 @@ opcodes = dict(
     BIT = 0x51,
     SQUARE = 0x52,
     INV = 0x53,
+    A2B = 0x54,
+    B2A = 0x55,
     GBITTRIPLE = 0x154,
     GBITGF2NTRIPLE = 0x155,
     INPUTMASK = 0x56,
@@ -136,6 +140,7 @@ opcodes = dict(
     RANDOMS = 0x5B,
     RANDOMFULLS = 0x5D,
     UNSPLIT = 0x5E,
+    WRITESOCKETSHAREBATCH = 0x5F,
     # Input
     INPUT = 0x60,
     INPUTFIX = 0xF0,
@@ -151,6 +156,8 @@ opcodes = dict(
     READSOCKETS = 0x64,
     WRITESOCKETC = 0x65,
     WRITESOCKETS = 0x66,
+    READSOCKETCASYNC = 0x67,
+    READSOCKETCBATCH = 0x68,
     READSOCKETINT = 0x69,
     WRITESOCKETINT = 0x6a,
     WRITESOCKETSHARE = 0x6b,
@@ -213,12 +220,15 @@ opcodes = dict(
     PRINTFLOATPLAIN = 0xBC,
     WRITEFILESHARE = 0xBD,     
     READFILESHARE = 0xBE,
+    WRITECOLUMN = 0xEE,
+    READCOLUMN = 0xEF,
     CONDPRINTSTR = 0xBF,
     PRINTFLOATPREC = 0xE0,
     CONDPRINTPLAIN = 0xE1,
     INTOUTPUT = 0xE6,
     FLOATOUTPUT = 0xE7,
     FIXINPUT = 0xE8,
+    BLOCKOUTPUT = 0xF7,
     GBITDEC = 0x18A,
     GBITCOM = 0x18B,
     # Secure socket
@@ -459,6 +469,10 @@ def cisc(function, n_outputs=1):
                     self.params.append(arg)
             self.function = function
             self.caller = None
+            if program.source_locations:
+                self.location = program.get_source_location()
+            else:
+                self.location = None
             program.curr_block.instructions.append(self)
 
         def get_def(self):
@@ -528,8 +542,10 @@ def cisc(function, n_outputs=1):
                 if isinstance(arg, program.curr_tape.Register):
                     subs[arg] = reg
             set_global_vector_size(size)
+            program.location_override = self.location
             for inst in template:
                 inst.copy(size, subs)
+            program.location_override = None
             reset_global_vector_size()
 
         class Arg:
@@ -982,7 +998,7 @@ class Instruction(object):
     Base class for a RISC-type instruction. Has methods for checking arguments,
     getting byte encoding, emulating the instruction, etc.
     """
-    __slots__ = ['args', 'arg_format', 'code', 'caller']
+    __slots__ = ['args', 'arg_format', 'code', 'caller', 'location']
     count = 0
     code_length = 10
 
@@ -997,6 +1013,10 @@ class Instruction(object):
             self.caller = [frame[1:] for frame in inspect.stack()[1:]]
         else:
             self.caller = None
+        if program.source_locations:
+            self.location = program.get_source_location()
+        else:
+            self.location = None
         
         Instruction.count += 1
         if Instruction.count % 100000 == 0:
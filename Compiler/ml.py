@@ -2238,6 +2238,8 @@ class Optimizer:
     output_stats = False
     print_accuracy = True
     time_training = True
+    # prefetch the next training batch for --disk-memory
+    prefetch = False
 
     @staticmethod
     def from_args(program, layers):
@@ -2567,6 +2569,9 @@ class Optimizer:
                     batch.assign(indices.get_vector(j * n, n) +
                                  regint(label * len(self.X_by_label[0]), size=n),
                                  label * n)
+                if self.prefetch:
+                    self._prefetch_batch(indices_by_label,
+                                         (j + 1) % n_per_epoch, n)
                 self.forward(batch=batch, training=True)
                 self.backward(batch=batch)
                 self.update(i, j, batch=batch)
@@ -2619,6 +2624,14 @@ class Optimizer:
             self.stopped_on_low_loss.write(1 - res)
             return res
 
+    def _prefetch_batch(self, indices_by_label, j, n):
+        X = self.layers[0].X
+        for label, indices in enumerate(indices_by_label):
+            offset = label * len(self.X_by_label[0])
+            @for_range(n)
+            def _(k):
+                X[indices[j * n + k] + offset].advise('prefetch')
+
     def reveal_correctness(self, data, truth, batch_size=128, running=False):
         """ Test correctness by revealing results.
 
@@ -2659,9 +2672,12 @@ class Optimizer:
             self.layers[-1].Y.address = truth.address
         N = data.sizes[0]
         batch = regint.Array(batch_size)
+        row_size = data.total_size() // N
         @for_range(N // batch_size)
         def _(i):
             start = i * batch_size
+            data.advise('prefetch', (start + batch_size) * row_size,
+                        batch_size * row_size)
             f(start, batch_size, batch)
         batch_size = N % batch_size
         if batch_size:
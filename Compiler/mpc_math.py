@@ -904,6 +904,47 @@ def tanh(x):
     return s.if_else(-1, t.if_else(1, (y - 1) / (y + 1)))
 
 
+def lookup(x, table):
+    """
+    Secret lookup in a public table with one opening in the online
+    phase. This uses a random one-hot vector that only depends on
+    random bits and can be generated before :py:obj:`x` is known. For
+    example, the following computes a sigmoid on 8-bit integers
+    representing fixed-point numbers with four fractional bits::
+
+      table = [cfix.int_rep(1 / (1 + math.exp(-(i - 128) / 16)), 16)
+               for i in range(256)]
+      y = sfix._new(mpc_math.lookup(x + 128, table))
+
+    :param x: secret integer in :math:`[0, n)` where :math:`n` is
+      the table length (sint, vector supported)
+    :param table: list of integers, padded with zeros to a power of two
+    :return: sint
+    """
+    k = max(1, int(math.ceil(math.log(len(table), 2))))
+    n = 2 ** k
+    table = list(table) + [0] * (n - len(table))
+    size = x.size
+    bits = [types.sint.get_random_bit(size=size) for i in range(k)]
+    from Compiler.oram import demux_list
+    one_hot = demux_list(bits)
+    r = sum(bit << i for i, bit in enumerate(bits))
+    # mask the higher bits to hide the carry
+    if types.program.options.ring:
+        mask = types.sint.get_random(size=size)
+    else:
+        mask = types.sint.get_random_int(types.program.security, size=size)
+    c = (x + r + (mask << k)).reveal() % n
+    stored = types.cint.Array(n)
+    stored.assign(table)
+    res = 0
+    for i in range(n):
+        # x = c - i if the one-hot vector is at i
+        index = types.regint.conv((c + n - i) % n)
+        res += one_hot[i] * stored.get(index)
+    return res
+
+
 # next functions due to https://dl.acm.org/doi/10.1145/3411501.3419427
 
 def Sep(x, sfix=types.sfix):
@@ -0,0 +1,153 @@
+"""
+This module distributes large vectorized operations of one party among
+several nodes (see :ref:`multinode`). The main node of every party
+uses :py:class:`Nodes` instead of computing locally, and every worker
+node runs :py:func:`serve` with matching parameters, for example
+:download:`../Programs/Source/multinode_worker.py`. Communication
+between the nodes uses the client interface.
+
+.. code::
+
+    nodes = multinode.Nodes(4, 10000)
+    c = nodes.mul(a, b)
+    nodes.stop()
+
+"""
+
+from Compiler import library
+from Compiler.types import sint, regint
+from Compiler.exceptions import CompilerError
+
+STOP, MUL, SET_MATRIX, MATMUL = range(4)
+
+class Nodes:
+    """ Worker nodes of this party.
+
+    :param n_nodes: number of worker nodes (int)
+    :param chunk: number of products per request (int), has to match
+      the workers
+    :param port: port to listen to (int)
+    """
+    def __init__(self, n_nodes, chunk, port=15000):
+        self.n_nodes = n_nodes
+        self.chunk = chunk
+        library.listen_for_clients(port)
+        ready = regint.Array(n_nodes)
+        ready.assign_all(0)
+        @library.for_range(n_nodes)
+        def _(i):
+            ready[library.accept_client_connection(port)] = 1
+        library.runtime_error_if(sum(ready) != n_nodes, 'connection problems')
+
+    def _send_op(self, node, op):
+        regint.write_to_socket(regint(node), [regint(op)])
+
+    def _distribute(self, n_chunks, send, receive):
+        # every node gets one chunk before collecting the results
+        def run(base, n):
+            for node in range(n):
+                send(regint(node), base + node)
+            for node in range(n):
+                receive(regint(node), base + node)
+        n_rounds = n_chunks // self.n_nodes
+        if n_rounds:
+            @library.for_range(n_rounds)
+            def _(i):
+                run(i * self.n_nodes, self.n_nodes)
+        if n_chunks % self.n_nodes:
+            run(n_rounds * self.n_nodes, n_chunks % self.n_nodes)
+
+    def mul(self, a, b):
+        """ Element-wise product.
+
+        :param a: :py:class:`~Compiler.types.Array` of sint with a
+          multiple of the chunk size as length
+        :param b: same
+        :returns: :py:class:`~Compiler.types.Array` of sint
+        """
+        c = self.chunk
+        if len(a) != len(b) or len(a) % c:
+            raise CompilerError('length has to be a multiple of %d' % c)
+        res = sint.Array(len(a))
+        def send(node, i):
+            self._send_op(node, MUL)
+            a.get_vector(i * c, c).write_fully_to_socket(node)
+            b.get_vector(i * c, c).write_fully_to_socket(node)
+        def receive(node, i):
+            res.assign_vector(sint.read_from_socket(node, size=c), i * c)
+        self._distribute(len(a) // c, send, receive)
+        return res
+
+    def matmul(self, A, B, n_rows):
+        """ Matrix product with the rows of :py:obj:`A` distributed in
+        blocks.
+
+        :param A: :py:class:`~Compiler.types.Matrix` of sint with a
+          multiple of :py:obj:`n_rows` rows
+        :param B: :py:class:`~Compiler.types.Matrix` of sint
+        :param n_rows: rows per request (int), has to match the workers
+        :returns: :py:class:`~Compiler.types.Matrix` of sint
+        """
+        m, k = A.sizes
+        n = B.sizes[1]
+        if B.sizes[0] != k or m % n_rows:
+            raise CompilerError('dimension mismatch')
+        for node in range(self.n_nodes):
+            self._send_op(node, SET_MATRIX)
+            B.get_vector().write_fully_to_socket(regint(node))
+        res = sint.Matrix(m, n)
+        def send(node, i):
+            self._send_op(node, MATMUL)
+            A.get_vector(i * n_rows * k, n_rows * k).write_fully_to_socket(
+                node)
+        def receive(node, i):
+            res.assign_vector(sint.read_from_socket(node, size=n_rows * n),
+                              i * n_rows * n)
+        self._distribute(m // n_rows, send, receive)
+        return res
+
+    def stop(self):
+        """ Let the workers finish. """
+        for node in range(self.n_nodes):
+            self._send_op(node, STOP)
+
+def serve(node_id, chunk, host='localhost', n_threads=None, matmul=None,
+          port=15000):
+    """ Execute requests from the main node until it calls
+    :py:func:`Nodes.stop`.
+
+    :param node_id: number of this node among the workers (int)
+    :param chunk: number of products per request (int)
+    :param host: main node of this party
+    :param n_threads: threads for the computation (int)
+    :param matmul: dimensions ``(n_rows, k, n)`` to support
+      multiplying an ``n_rows x k`` block with a ``k x n`` matrix
+    """
+    main = library.init_client_connection(host, port, node_id)
+    # one message per vector in both directions
+    a, b = sint.Array(chunk), sint.Array(chunk)
+    if matmul:
+        n_rows, k, n = matmul
+        A, B = sint.Matrix(n_rows, k), sint.Matrix(k, n)
+    @library.do_while
+    def _():
+        op = regint.read_from_socket(main)
+        @library.if_(op == MUL)
+        def _():
+            a.assign_vector(sint.read_from_socket(main, size=chunk))
+            b.assign_vector(sint.read_from_socket(main, size=chunk))
+            @library.multithread(n_threads, chunk)
+            def _(base, size):
+                a.assign_vector(
+                    a.get_vector(base, size) * b.get_vector(base, size), base)
+            sint.write_to_socket(main, [a.get_vector()])
+        if matmul:
+            @library.if_(op == SET_MATRIX)
+            def _():
+                B.assign_vector(sint.read_from_socket(main, size=k * n))
+            @library.if_(op == MATMUL)
+            def _():
+                A.assign_vector(sint.read_from_socket(main, size=n_rows * k))
+                C = A.dot(B, n_threads=n_threads)
+                sint.write_to_socket(main, [C.get_vector()])
+        return op != STOP
@@ -19,9 +19,9 @@ class NonLinear:
         else:
             return self._mod2m(a, k, m, signed)
 
-    def trunc_pr(self, a, k, m, signed=True):
-        if isinstance(a, types.cint):
-            return shift_two(a, m)
+    def use_trunc_pr(self, k, m):
+        """ Whether to use the protocol-specific truncation for
+        :py:obj:`k`-bit values and prepare for it if so. """
         prog = program.Program.prog
         if prog.use_trunc_pr and m and (
                 not prog.options.ring or \
@@ -31,6 +31,13 @@ class NonLinear:
                 comparison.require_ring_size(k, 'truncation')
             else:
                 prog.curr_tape.require_bit_length(k + prog.security)
+            return True
+        return False
+
+    def trunc_pr(self, a, k, m, signed=True):
+        if isinstance(a, types.cint):
+            return shift_two(a, m)
+        if self.use_trunc_pr(k, m):
             if not signed:
                 a -= (1 << (k - 1))
             res = sint()
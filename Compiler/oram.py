@@ -33,6 +33,8 @@ from Compiler import floatingpoint,comparison,permutation
 from Compiler.util import *
 
 print_access = False
+# LinearORAM with sint uses vector instructions on whole arrays
+vectorized_linear_oram = True
 sint_bit_length = 6
 max_demux_bits = 3
 debug = False
@@ -862,6 +864,9 @@ def get_n_threads(n_loops):
 class LinearORAM(TrivialORAM):
     """ Contiguous ORAM that stores entries in order and accesses the
     entire array for reading and writing in order to hide the address.
+    With :py:class:`~Compiler.types.sint`, every access uses a
+    constant number of vector instructions on the whole arrays (dot
+    products for reading) instead of a loop over all entries.
 
     :param size: number of entries
     :param value_type: :py:class:`sint` (default) / :py:class:`sg2fn` /
@@ -876,8 +881,17 @@ class LinearORAM(TrivialORAM):
         TrivialORAM.__init__(self, *args, **kwargs)
         self.index_vector = self.get_array(2 ** self.index_size, \
                                            self.index_type.bit_type)
+        # whole-array instructions instead of a loop over all entries
+        self.vectorized = vectorized_linear_oram and \
+            all(issubclass(t, sint) for t in self.ram.entry_type)
     def read_and_maybe_remove(self, index):
         return self.read(index), 0
+    def _demux_vector(self, index, res=None):
+        res = demux_array(bit_decompose(index, self.index_size), res)
+        return res.get_vector(0, self.size)
+    def _read_vectorized(self, access_here):
+        return [sint.dot_product(access_here, a.get_vector())
+                for a in [self.ram.l[0]] + self.ram.l[2:]]
     def add(self, entry, state=None, evict=None):
         if entry.created_non_empty is True:
             self.write(entry.v, entry.x)
@@ -889,15 +903,20 @@ class LinearORAM(TrivialORAM):
     def _read(self, index):
         maybe_start_timer(6)
         empty_entry = self.empty_entry(False)
-        demux_array(bit_decompose(index, self.index_size), \
-                    self.index_vector)
-        t = self.value_type.get_type(None if None in self.entry_size else max(self.entry_size))
-        @map_sum(get_n_threads(self.size), None, self.size, \
-                     self.value_length + 1, t)
-        def f(i):
-            entry = self.ram[i]
-            access_here = self.index_vector[i]
-            return access_here * ValueTuple((entry.empty(),) + entry.x)
+        if self.vectorized:
+            res = self._read_vectorized(
+                self._demux_vector(index, self.index_vector))
+            f = lambda: res
+        else:
+            demux_array(bit_decompose(index, self.index_size), \
+                        self.index_vector)
+            t = self.value_type.get_type(None if None in self.entry_size else max(self.entry_size))
+            @map_sum(get_n_threads(self.size), None, self.size, \
+                         self.value_length + 1, t)
+            def f(i):
+                entry = self.ram[i]
+                access_here = self.index_vector[i]
+                return access_here * ValueTuple((entry.empty(),) + entry.x)
         not_found = self.value_type.bit_type(f()[0])
         read_value = ValueTuple(self.value_type.get_type(l)(x) for l, x in zip(self.entry_size, f()[1:])) + \
             not_found * empty_entry.x
@@ -907,6 +926,17 @@ class LinearORAM(TrivialORAM):
     def _write(self, index, *new_value):
         maybe_start_timer(7)
         empty_entry = self.empty_entry(False)
+        if self.vectorized:
+            access_here = self._demux_vector(index, self.index_vector)
+            empty = self.ram.l[0]
+            old = empty.get_vector()
+            empty.assign_vector(old - access_here * old)
+            for a, nv in zip(self.ram.l[2:], new_value):
+                old = a.get_vector()
+                nv = sint.conv(nv).expand_to_vector(self.size)
+                a.assign_vector(old + access_here * (nv - old))
+            maybe_stop_timer(7)
+            return
         demux_array(bit_decompose(index, self.index_size), \
                     self.index_vector)
         new_value = make_array(
@@ -925,6 +955,18 @@ class LinearORAM(TrivialORAM):
     @method_block
     def _access(self, index, write, new_empty, *new_value):
         empty_entry = self.empty_entry(False)
+        if self.vectorized:
+            access_here = self._demux_vector(index)
+            res = self._read_vectorized(access_here)
+            write = sint.conv(write).expand_to_vector(self.size)
+            for a, nv in zip([self.ram.l[0]] + self.ram.l[2:],
+                             (new_empty,) + new_value):
+                old = a.get_vector()
+                nv = sint.conv(nv).expand_to_vector(self.size)
+                a.assign_vector(old + write * (access_here * (nv - old)))
+            not_found = res[0]
+            read_value = ValueTuple(res[1:]) + not_found * empty_entry.x
+            return read_value, not_found
         index_vector = \
             demux_array(bit_decompose(index, self.index_size))
         new_value = make_array(
@@ -58,6 +58,7 @@ class defaults:
     mixed = False
     edabit = False
     invperm = False
+    native_conversion = False
     split = None
     cisc = True
     comparison = None
@@ -70,6 +71,7 @@ class defaults:
     stop = False
     insecure = False
     keep_cisc = False
+    source_locations = False
 
 
 class Program(object):
@@ -163,6 +165,10 @@ class Program(object):
         self.tape_counter = 0
         self._curr_tape = None
         self.DEBUG = options.debug
+        self.source_locations = getattr(options, "source_locations", False)
+        # location of instructions generated later, see get_source_location()
+        self.location_override = None
+        self.compiler_files = {}
         self.allocated_mem = RegType.create_dict(lambda: USER_MEM)
         self.free_mem_blocks = defaultdict(al.BlockAllocator)
         self.later_mem_blocks = defaultdict(list)
@@ -195,6 +201,7 @@ class Program(object):
             Compiler.instructions.inputfloat_class,
             Compiler.instructions.inputmixed_class,
             Compiler.instructions.trunc_pr_class,
+            Compiler.instructions.multruncprs,
             Compiler.instructions_base.Mergeable,
         ]
         import Compiler.GC.instructions as gc
@@ -211,6 +218,9 @@ class Program(object):
             gc.inputbvec,
             gc.reveal,
         ]
+        self.to_merge_free = []
+        if options.garbled:
+            self.optimize_for_gc()
         self.use_trunc_pr = False
         """ Setting whether to use special probabilistic truncation. """
         self.use_dabit = options.mixed
@@ -218,6 +228,7 @@ class Program(object):
         self._edabit = options.edabit
         """ Whether to use the low-level INVPERM instruction (only implemented with the assumption of a semi-honest two-party environment)"""
         self._invperm = options.invperm
+        self._native_conversion = options.native_conversion
         self._split = False
         if options.split:
             self.use_split([int(x) for x in options.split.split(",")])
@@ -240,6 +251,7 @@ class Program(object):
         self.use_tape_calls = not options.garbled
         self.force_cisc_tape = False
         self.use_mulm = True
+        self.mulm_operands = []
         self.have_warned_trunc_pr = False
         self.use_unsplit = False
         self.recommended = set()
@@ -264,6 +276,28 @@ class Program(object):
     def get_args(self):
         return self.args
 
+    def get_source_location(self):
+        """Innermost line of the calling code outside the compiler,
+        usually in the high-level program.
+
+        :returns: ``file:line`` or None if the call comes from the
+          compiler only
+        """
+        if self.location_override:
+            return self.location_override
+        compiler_dir = os.path.dirname(os.path.abspath(__file__))
+        frame = sys._getframe(1)
+        while frame:
+            filename = frame.f_code.co_filename
+            if filename not in self.compiler_files:
+                path = os.path.abspath(filename)
+                self.compiler_files[filename] = path.startswith(
+                    compiler_dir + os.sep) or path == os.path.join(
+                        os.path.dirname(compiler_dir), "compile.py")
+            if not self.compiler_files[filename]:
+                return "%s:%d" % (filename, frame.f_lineno)
+            frame = frame.f_back
+
     def max_par_tapes(self):
         """Upper bound on number of tapes that will be run in parallel.
         (Excludes empty tapes)"""
@@ -463,6 +497,10 @@ class Program(object):
         else:
             sch_file.write("lgp:%s" % req)
         sch_file.write("\n")
+        # checked here because registers can be updated later
+        if self.mulm_operands and all(getattr(x, "prep_known", False)
+                                      for x in self.mulm_operands):
+            self.relevant_opts.add("prep_mulm")
         sch_file.write("opts: %s\n" % " ".join(self.relevant_opts))
         sch_file.write("sec:%d\n" % self.used_security)
         req2 = set(x.req_bit_length["2"] for x in self.tapes)
@@ -660,8 +698,11 @@ class Program(object):
         self.set_security(security)
 
     def optimize_for_gc(self):
+        """ Merge XORs in layers between rounds of ANDs. XOR is free
+        in garbled circuits, so this doesn't change the number of
+        rounds but reduces the number of instructions. """
         import Compiler.GC.instructions as gc
-        self.to_merge += [gc.xors]
+        self.to_merge_free += [gc.xors]
 
     def get_tape_counter(self):
         res = self.tape_counter
@@ -713,6 +754,19 @@ class Program(object):
         else:
             self._invperm = change
 
+    def use_native_conversion(self, change=None):
+        """Setting whether to use the A2B and B2A instructions of the
+        virtual machine for conversion between arithmetic and binary
+        secret sharing (default: false). A2B is only used for
+        computation modulo a power of two.
+
+        :param change: change setting if not :py:obj:`None`
+        :returns: setting if :py:obj:`change` is :py:obj:`None`
+        """
+        if change is None:
+            return self._native_conversion
+        else:
+            self._native_conversion = change
 
     def use_edabit_for(self, *args):
         return True
@@ -1137,7 +1191,8 @@ class Tape:
                         )
                     )
                 # the next call is necessary for allocation later even without merging
-                merger = al.Merger(block, options, tuple(self.program.to_merge))
+                merger = al.Merger(block, options, tuple(self.program.to_merge),
+                                   tuple(self.program.to_merge_free))
                 if options.dead_code_elimination:
                     if len(block.instructions) > 1000000:
                         print("Eliminate dead code...")
@@ -1419,6 +1474,30 @@ class Tape:
                 h.update(b)
         f.close()
         self.hash = h.digest()
+        self.write_source_locations(filename[:-3] + ".loc")
+
+    @unpurged
+    def write_source_locations(self, filename):
+        """Write the source line of every instruction if available
+        (``--source-locations``). Every line contains the index of the
+        first instruction and the location, which holds until the next
+        line."""
+        if not self.program.source_locations:
+            # avoid wrong attribution by outdated information
+            if os.path.exists(filename):
+                os.remove(filename)
+            return
+        print("Writing to", filename)
+        with open(filename, "w") as f:
+            last = None
+            n = 0
+            for i in self._get_instructions():
+                if i is not None:
+                    location = getattr(i, "location", None)
+                    if location != last:
+                        f.write("%d %s\n" % (n, location or ""))
+                        last = location
+                    n += 1
 
     def new_reg(self, reg_type, size=None):
         return self.Register(reg_type, self, size=size)
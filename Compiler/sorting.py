@@ -26,14 +26,16 @@ def reveal_sort(k, D, reverse=False):
     assert len(k) == len(D)
     library.break_point()
     shuffle = types.sint.get_secure_shuffle(len(k))
-    k_prime = k.get_vector().secure_permute(shuffle).reveal()
-    idx = types.Array.create_from(k_prime)
+    k_prime = k.get_vector().secure_permute(shuffle)
+    if not reverse:
+        # independent of the revealed key, so merged with the shuffle above
+        D.secure_permute(shuffle)
+    idx = types.Array.create_from(k_prime.reveal())
     if reverse:
         D.assign_vector(D.get_slice_vector(idx))
         library.break_point()
         D.secure_permute(shuffle, reverse=True)
     else:
-        D.secure_permute(shuffle)
         library.break_point()
         v = D.get_vector()
         D.assign_slice_vector(idx, v)
@@ -1065,6 +1065,9 @@ class cint(_clear, _int):
     __slots__ = []
     instruction_type = 'modp'
     reg_type = 'c'
+    # temporary constant that is also known to the preprocessing phase
+    # of Astra and Trio
+    prep_known = False
 
     @vectorized_classmethod
     def read_from_socket(cls, client_id, n=1):
@@ -1141,6 +1144,11 @@ class cint(_clear, _int):
             val = val.v.round(val.k, val.f)
         super(cint, self).load_other(val)
 
+    def link(self, other):
+        # the register might hold either value
+        self.prep_known = other.prep_known = False
+        super(cint, self).link(other)
+
     @vectorize
     def to_regint(self, n_bits=64, dest=None, sync=True):
         """ Convert to regint.
@@ -1368,6 +1376,23 @@ class cint(_clear, _int):
     def output_if(self, cond):
         cond_print_plain(self.conv(cond), self, cint(0, size=self.size))
 
+    def block_output(self, player=None, precision=0):
+        """ Write whole vector as one block of 64-bit signed integers
+        to ``Player-Data/Block-Output-P<playerno>-<threadno>`` in the
+        background. See :ref:`this section <block-output>` for the
+        format.
+
+        :param player: only output on given player (default all)
+        :param precision: fixed-point precision stored in the header
+        """
+        if player == None:
+            player = -1
+        if not util.is_constant(player):
+            raise CompilerError('Player number must be known at compile time')
+        set_global_vector_size(self.size)
+        blockoutput(player, precision, self)
+        reset_global_vector_size()
+
 
 class cgf2n(_clear, _gf2n):
     r"""
@@ -1969,6 +1994,17 @@ class personal(Tape._no_truth):
         supported by underlying type. Player must be known at compile time."""
         self._v.binary_output(self.player)
 
+    def block_output(self):
+        """ Write whole vector as one binary block to
+        ``Player-Data/Block-Output-P<playerno>-<threadno>`` if
+        supported by underlying type. This is faster than
+        :py:func:`binary_output` for large vectors. Player must be
+        known at compile time."""
+        if isinstance(self._v, Array):
+            self._v[:].block_output(self.player)
+        else:
+            self._v.block_output(self.player)
+
     def reveal_to(self, player):
         """ Pass personal value to another player. """
         if isinstance(self._v, Array):
@@ -2288,7 +2324,10 @@ class _secret(_arithmetic_register, _secret_structure):
             tmp = r[0].bit_xor((r[1] ^ val).reveal().to_regint_by_bit())
             program.curr_block.replace_last_reg(self, tmp)
         elif isinstance(val, sbitvec):
-            movs(self, sint.bit_compose(val))
+            if program.use_native_conversion():
+                b2a(self, *val.v)
+            else:
+                movs(self, sint.bit_compose(val))
         else:
             self.load_clear(self.clear_type(val))
 
@@ -2348,10 +2387,12 @@ class _secret(_arithmetic_register, _secret_structure):
             if self.clear_type.in_immediate_range(other):
                 si_inst(res, self, other)
             else:
+                c = res.clear_type(other)
+                c.prep_known = True
                 if reverse:
-                    m_inst(res, res.clear_type(other), self)
+                    m_inst(res, c, self)
                 else:
-                    m_inst(res, self, res.clear_type(other))
+                    m_inst(res, self, c)
         else:
             return NotImplemented
         return res
@@ -2383,7 +2424,11 @@ class _secret(_arithmetic_register, _secret_structure):
         elif program.use_mulm == -1:
             mulm = lambda res, x, y: instructions.mulm(res, x, cint(regint(y)))
         else:
-            mulm = lambda res, x, y: muls(res, x, type(self)(y))
+            def mulm(res, x, y):
+                if getattr(y, 'prep_known', False):
+                    instructions.mulm(res, x, y)
+                else:
+                    muls(res, x, type(self)(y))
         return self.secret_op(other, muls, mulm, mulsi)
 
     def __sub__(self, other):
@@ -2703,6 +2748,97 @@ class sint(_secret, _int):
             y[i] = received[i] - triples[i * 3 if program.active else i]
         return y
 
+    @classmethod
+    def request_from_client(cls, n, client_id, slot, masks,
+                            message_type=ClientMessageType.NoType):
+        """ Send masks for inputs to a client like
+        :py:func:`receive_from_client` but receive the masked inputs in
+        the background. Use :py:func:`receive_client_batch` to obtain
+        the inputs of several clients in the order of arrival.
+
+        :param n: number of inputs (int)
+        :param client_id: regint
+        :param slot: row of :py:obj:`masks` identifying the request
+          (regint/int)
+        :param masks: sint matrix with :py:obj:`n` columns
+
+        """
+        cls._send_input_masks(n, client_id, masks[slot], message_type)
+        readsocketcasync(regint.conv(client_id), regint.conv(slot))
+
+    @staticmethod
+    def _send_input_masks(n, client_id, masks, message_type):
+        program.reading('client inputs', 'DDNNT15')
+        if program.active:
+            triples = list(itertools.chain(
+                *(sint.get_random_triple() for i in range(n))))
+        else:
+            triples = [sint.get_random() for i in range(n)]
+
+        sint.write_shares_to_socket(client_id, triples, message_type)
+
+        for i in range(n):
+            masks[i] = triples[i * 3 if program.active else i]
+
+    @classmethod
+    def stream_from_client(cls, n, client_id, n_batches,
+                           message_type=ClientMessageType.NoType):
+        """ Decorator to securely receive :py:obj:`n_batches` batches
+        of :py:obj:`n` inputs each from a client. The masks for the
+        next batch are sent before waiting for the current batch, so
+        that the client can send continuously. The decorated function
+        is called with the batch number and the list of inputs. The
+        client has to use
+        :py:func:`~ExternalIO.client.Client.send_private_input_stream`
+        or :cpp:func:`Client::send_private_input_stream`::
+
+          total = sint.Array(n)
+          total.assign_all(0)
+          @sint.stream_from_client(n, client_id, n_batches)
+          def _(i, inputs):
+              total[:] += sint(inputs)
+
+        :param n: number of inputs per batch (int)
+        :param client_id: regint
+        :param n_batches: number of batches (int/regint)
+
+        """
+        masks = sint.Matrix(2, n)
+        def decorator(body):
+            cls._send_input_masks(n, client_id, masks[0], message_type)
+            @library.for_range(n_batches)
+            def _(i):
+                @library.if_(i + 1 < n_batches)
+                def _():
+                    cls._send_input_masks(n, client_id, masks[(i + 1) % 2],
+                                          message_type)
+                received = util.tuplify(cint.read_from_socket(client_id, n))
+                current = masks[i % 2]
+                body(i, [received[j] - current[j] for j in range(n)])
+        return decorator
+
+    @classmethod
+    def receive_client_batch(cls, n_clients, masks):
+        """ Wait for the next inputs requested with
+        :py:func:`request_from_client`. This doesn't depend on
+        the order of requests.
+
+        :param n_clients: number of requests to complete (int)
+        :param masks: sint matrix used with :py:func:`request_from_client`
+        :returns: tuple of slots (regint vector) and list of sint vectors
+          with one vector per input
+
+        """
+        n = masks.sizes[1]
+        slots = regint(size=n_clients)
+        received = cint(size=n_clients * n)
+        readsocketcbatch(slots, received, n_clients, n)
+        addresses = regint(masks.address, size=n_clients) + slots * n
+        used = sint.concat(sint.load_mem(addresses + i) for i in range(n))
+        y = received - used
+        return slots, [y.get_vector(i * n_clients, n_clients)
+                       for i in range(n)]
+
     @classmethod
     def reveal_to_clients(cls, clients, values):
         """ Reveal securely to clients.
@@ -2739,6 +2875,35 @@ class sint(_secret, _int):
             sint.write_shares_to_socket(clients[i], to_send)
         reset_global_vector_size()
 
+    @classmethod
+    def reveal_to_clients_batch(cls, clients, values,
+                                message_type=ClientMessageType.NoType):
+        """ Reveal a different set of values to every client. The
+        masks and verification triples for all clients are computed
+        together, and the messages are sent in the background. The
+        clients receive as for :py:func:`reveal_to_clients`.
+
+        :param clients: client ids (regint vector, list, or array)
+        :param values: list of sint vectors with one entry per client
+
+        """
+        if isinstance(clients, Array):
+            clients = clients.get_vector()
+        elif not isinstance(clients, regint):
+            clients = regint(list(clients))
+        n_clients = clients.size
+        for value in values:
+            assert value.size == n_clients
+        value = sint.concat(values)
+        r = sint.get_random(size=value.size)
+        value += r - r.reveal()
+        to_send = [value]
+        if program.active:
+            r = sint.get_random(size=value.size)
+            to_send += [r, value * r]
+        writesocketsharebatch(clients, message_type, n_clients, len(values),
+                              *to_send)
+
     @vectorized_classmethod
     def read_from_socket(cls, client_id, n=1):
         """ Receive secret-shared value(s) from client.
@@ -2787,6 +2952,41 @@ class sint(_secret, _int):
         """
         writesocketshare(client_id, message_type, values[0].size, *values)
 
+    @classmethod
+    def read_from_column(cls, name, start=0, size=1, bit_length=None,
+                         precision=0):
+        """ Read consecutive rows from the column in
+        ``Persistence/Columns/<name>-P<playerno>.data``. See :ref:`this
+        section <columns>` for details.
+
+        :param name: column name (str)
+        :param start: first row (int/regint/cint)
+        :param size: number of rows (int)
+        :param bit_length: bit length stored in the column
+            (default: global bit length)
+        :param precision: fixed-point precision stored in the column
+        :returns: sint vector
+        """
+        res = cls(size=size)
+        readcolumn(res, regint.conv(start), size,
+                   bit_length or program.bit_length, precision, name)
+        return res
+
+    @classmethod
+    def write_to_column(cls, name, values, bit_length=None, precision=0):
+        """ Append rows to the column in
+        ``Persistence/Columns/<name>-P<playerno>.data``, creating it if
+        necessary. See :ref:`this section <columns>` for details.
+
+        :param name: column name (str)
+        :param values: sint vector
+        :param bit_length: bit length to store (default: global bit length)
+        :param precision: fixed-point precision to store
+        """
+        values = cls.conv(values)
+        writecolumn(values, values.size, bit_length or program.bit_length,
+                    precision, name)
+
     @vectorized_classmethod
     def load_mem(cls, address, mem_type=None):
         """ Load from memory by public address. """
@@ -2983,6 +3183,12 @@ class sint(_secret, _int):
                                           maybe_mixed)
 
     def TruncMul(self, other, k, m, nearest=False):
+        if not nearest and isinstance(other, sint) and \
+           self.size == other.size and program.non_linear.use_trunc_pr(k, m):
+            # one instruction for protocols to combine the two
+            res = sint(size=self.size)
+            multruncprs(self.size, res, self, other, k, m)
+            return res
         return (self * other).round(k, m, nearest, signed=True)
 
     def TruncPr(self, k, m, signed=True):
@@ -4404,6 +4610,16 @@ class cfix(_number, _structure):
         floatoutput(player, self.v, cint(-self.f), cint(0), cint(0))
         reset_global_vector_size()
 
+    def block_output(self, player=None):
+        """ Write integer representation of whole vector as one block
+        to ``Player-Data/Block-Output-P<playerno>-<threadno>`` in the
+        background. See :ref:`this section <block-output>` for the
+        format.
+
+        :param player: only output on given player (default all)
+        """
+        self.v.block_output(player, self.f)
+
     def link(self, other):
         self.v.link(other.v)
 
@@ -4564,6 +4780,32 @@ class _single(_number, _secret_structure):
         """
         cls.int_type.write_to_file([x.v for x in shares], position)
 
+    @classmethod
+    def read_from_column(cls, name, start=0, size=1):
+        """ Read consecutive rows from the column in
+        ``Persistence/Columns/<name>-P<playerno>.data``. Bit length and
+        precision must be the same as when storing. See :ref:`this
+        section <columns>` for details.
+
+        :param name: column name (str)
+        :param start: first row (int/regint/cint)
+        :param size: number of rows (int)
+        """
+        return cls._new(cls.int_type.read_from_column(
+            name, start, size, cls.k, cls.f))
+
+    @classmethod
+    def write_to_column(cls, name, values):
+        """ Append rows to the column in
+        ``Persistence/Columns/<name>-P<playerno>.data`` with the current
+        bit length and precision as metadata. See :ref:`this section
+        <columns>` for details.
+
+        :param name: column name (str)
+        :param values: sfix vector
+        """
+        cls.int_type.write_to_column(name, cls.conv(values).v, cls.k, cls.f)
+
     def store_in_mem(self, address):
         """ Store in memory by public address. """
         self.v.store_in_mem(address)
@@ -5074,7 +5316,9 @@ class sfix(_fix):
 
     @staticmethod
     def multipliable(v, k, f, size):
-        return cfix._new(cint.conv(v, size=size), k, f)
+        res = cfix._new(cint.conv(v, size=size), k, f)
+        res.v.prep_known = True
+        return res
 
     def dot(self, other):
         """ Dot product with any vector or iterable. """
@@ -5912,6 +6156,33 @@ class _vectorizable:
         """
         self.value_type.reveal_to_clients(clients, [self.get_vector()])
 
+    access_patterns = {'normal': 0, 'sequential': 1, 'random': 2,
+                       'prefetch': 3, 'done': 4}
+
+    def advise(self, pattern, base=0, size=None):
+        """ Hint to the virtual machine how secret memory is going to be
+        accessed. This helps with ``--disk-memory`` and has no effect
+        otherwise.
+
+        :param pattern: ``'sequential'``, ``'random'``, ``'normal'``,
+          ``'prefetch'`` (load in the background),
+          or ``'done'`` (write back in the background)
+        :param base: first entry (int/regint/cint, default 0)
+        :param size: number of entries (int/regint/cint, default all from base)
+
+        """
+        value_type = getattr(self.value_type, 'int_type', self.value_type)
+        reg_type = getattr(value_type, 'reg_type', None)
+        if reg_type not in ('s', 'sg'):
+            return
+        n_elements = self.value_type.n_elements()
+        if size is None:
+            size = self.total_size() // n_elements - base
+        instruction = memadvises if reg_type == 's' else gmemadvises
+        instruction(regint.conv(self.address + base * n_elements),
+                    regint.conv(size * n_elements),
+                    self.access_patterns[pattern])
+
 class Array(_vectorizable):
     """
     Array accessible by public index. That is, ``a[i]`` works for an
@@ -6345,6 +6616,31 @@ class Array(_vectorizable):
             if position is not None:
                 position.iadd(size)
 
+    def read_from_column(self, name, start=0):
+        """ Read content from ``Persistence/Columns/<name>-P<playerno>.data``.
+        See :ref:`this section <columns>` for details.
+
+        :param name: column name (str)
+        :param start: first row (int/regint/cint)
+        """
+        start = regint(start)
+        @library.multithread(None, len(self), max_size=program.budget)
+        def _(base, size):
+            self.assign(self.value_type.read_from_column(name, start, size),
+                        base=base)
+            start.iadd(size)
+
+    def write_to_column(self, name):
+        """ Append content to ``Persistence/Columns/<name>-P<playerno>.data``.
+        See :ref:`this section <columns>` for details.
+
+        :param name: column name (str)
+        """
+        @library.multithread(None, len(self), max_size=program.budget)
+        def _(base, size):
+            self.value_type.write_to_column(
+                name, self.get_vector(base=base, size=size))
+
     def read_from_socket(self, socket, debug=False):
         """ Read content from socket. """
         if debug:
@@ -6532,6 +6828,13 @@ class Array(_vectorizable):
         """
         self.get_vector().binary_output(player)
 
+    def block_output(self, player=None):
+        """ Binary output as one block if supported by type.
+
+        :param: player (default all)
+        """
+        self.get_vector().block_output(player)
+
     def reveal_to(self, player):
         """ Reveal secret array to :py:obj:`player`.
 
@@ -16,6 +16,8 @@ public:
     bool check_open;
     bool check_beaver_open;
     bool R_after_msg;
+    int pool_threshold;
+    bool persist_presignatures;
 
     EcdsaOptions(ez::ezOptionParser& opt, int argc, const char** argv)
     {
@@ -64,12 +66,30 @@ public:
                 "-R", // Flag token.
                 "--R-after-msg" // Flag token.
         );
+        opt.add(
+                "0", // Default.
+                0, // Required?
+                1, // Number of args expected.
+                0, // Delimiter if expecting multiple args.
+                "Sign from a pool of presignatures that is topped up whenever fewer than this many remain (default: 0, no pool)", // Help description.
+                "--pool" // Flag token.
+        );
+        opt.add(
+                "", // Default.
+                0, // Required?
+                0, // Number of args expected.
+                0, // Delimiter if expecting multiple args.
+                "Store key share and unused presignatures of the pool for the next run (only honest-majority protocols)", // Help description.
+                "--persist-presignatures" // Flag token.
+        );
         opt.parse(argc, argv);
         prep_mul = not opt.isSet("-D");
         fewer_rounds = opt.isSet("-P");
         check_open = not opt.isSet("-C");
         check_beaver_open = not opt.isSet("-B");
         R_after_msg = opt.isSet("-R");
+        opt.get("--pool")->getInt(pool_threshold);
+        persist_presignatures = opt.isSet("--persist-presignatures");
         opt.resetArgs();
     }
 };
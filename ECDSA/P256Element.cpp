@@ -9,11 +9,64 @@
 
 EC_GROUP* P256Element::curve = 0;
 
+namespace
+{
+
+// avoid allocating a context in every operation
+class BnCtx
+{
+public:
+    BN_CTX* ctx;
+
+    BnCtx() : ctx(BN_CTX_new())
+    {
+        assert(ctx);
+    }
+
+    ~BnCtx()
+    {
+        BN_CTX_free(ctx);
+    }
+};
+
+BN_CTX* get_ctx()
+{
+    thread_local BnCtx ctx;
+    return ctx.ctx;
+}
+
+// binary conversion instead of going via decimal strings
+class ScalarBn
+{
+public:
+    BIGNUM* bn;
+
+    ScalarBn(const P256Element::Scalar& x) : bn(BN_new())
+    {
+        unsigned char buffer[P256Element::Scalar::N_BYTES];
+        size_t length;
+        mpz_export(buffer, &length, 1, 1, 1, 0, bigint(x).get_mpz_t());
+        assert(BN_bin2bn(buffer, length, bn));
+    }
+
+    ~ScalarBn()
+    {
+        BN_free(bn);
+    }
+};
+
+}
+
 void P256Element::init(int nid)
 {
     assert(not curve);
     curve = EC_GROUP_new_by_curve_name(nid);
     assert(curve != 0);
+#if OPENSSL_VERSION_MAJOR < 3
+    // fixed-base tables for the generator unless built in
+    if (not EC_GROUP_have_precompute_mult(curve))
+        assert(EC_GROUP_precompute_mult(curve, get_ctx()) != 0);
+#endif
     auto modulus = EC_GROUP_get0_order(curve);
     auto mod = BN_bn2dec(modulus);
     Scalar::get_ZpD() = {};
@@ -39,18 +92,16 @@ P256Element::P256Element()
 P256Element::P256Element(const Scalar& other) :
         P256Element()
 {
-    BIGNUM* exp = BN_new();
-    BN_dec2bn(&exp, bigint(other).get_str().c_str());
-    assert(EC_POINT_mul(curve, point, exp, 0, 0, 0) != 0);
-    BN_free(exp);
+    ScalarBn exp(other);
+    assert(EC_POINT_mul(curve, point, exp.bn, 0, 0, get_ctx()) != 0);
 }
 
 P256Element::P256Element(word other) :
         P256Element()
 {
     BIGNUM* exp = BN_new();
-    BN_dec2bn(&exp, to_string(other).c_str());
-    assert(EC_POINT_mul(curve, point, exp, 0, 0, 0) != 0);
+    assert(BN_set_word(exp, other));
+    assert(EC_POINT_mul(curve, point, exp, 0, 0, get_ctx()) != 0);
     BN_free(exp);
 }
 
@@ -67,72 +118,84 @@ P256Element& P256Element::operator =(const P256Element& other)
 
 void P256Element::check()
 {
-    assert(EC_POINT_is_on_curve(curve, point, 0) == 1);
+    assert(EC_POINT_is_on_curve(curve, point, get_ctx()) == 1);
 }
 
 P256Element::Scalar P256Element::x() const
 {
     BIGNUM* x = BN_new();
 #if OPENSSL_VERSION_MAJOR >= 3
-    assert(EC_POINT_get_affine_coordinates(curve, point, x, 0, 0) != 0);
+    assert(EC_POINT_get_affine_coordinates(curve, point, x, 0, get_ctx()) != 0);
 #else
-    assert(EC_POINT_get_affine_coordinates_GFp(curve, point, x, 0, 0) != 0);
+    assert(EC_POINT_get_affine_coordinates_GFp(curve, point, x, 0, get_ctx()) != 0);
 #endif
-    char* xx = BN_bn2dec(x);
-    Scalar res((bigint(xx)));
-    OPENSSL_free(xx);
+    unsigned char buffer[Scalar::N_BYTES];
+    int length = BN_bn2bin(x, buffer);
+    assert(length >= 0 and size_t(length) <= sizeof(buffer));
+    bigint tmp;
+    mpz_import(tmp.get_mpz_t(), length, 1, 1, 1, 0, buffer);
     BN_free(x);
-    return res;
+    return tmp;
 }
 
 P256Element P256Element::operator +(const P256Element& other) const
 {
     P256Element res;
-    assert(EC_POINT_add(curve, res.point, point, other.point, 0) != 0);
+    assert(EC_POINT_add(curve, res.point, point, other.point, get_ctx()) != 0);
     return res;
 }
 
 P256Element P256Element::operator -(const P256Element& other) const
 {
     P256Element tmp = other;
-    assert(EC_POINT_invert(curve, tmp.point, 0) != 0);
+    assert(EC_POINT_invert(curve, tmp.point, get_ctx()) != 0);
     return *this + tmp;
 }
 
 P256Element P256Element::operator *(const Scalar& other) const
 {
     P256Element res;
-    BIGNUM* exp = BN_new();
-    BN_dec2bn(&exp, bigint(other).get_str().c_str());
-    assert(EC_POINT_mul(curve, res.point, 0, point, exp, 0) != 0);
-    BN_free(exp);
+    ScalarBn exp(other);
+    assert(EC_POINT_mul(curve, res.point, 0, point, exp.bn, get_ctx()) != 0);
+    return res;
+}
+
+P256Element P256Element::mul_add(const Scalar& g_scalar,
+        const P256Element& point, const Scalar& scalar)
+{
+    P256Element res;
+    ScalarBn g_exp(g_scalar), exp(scalar);
+    assert(
+            EC_POINT_mul(curve, res.point, g_exp.bn, point.point, exp.bn,
+                    get_ctx()) != 0);
     return res;
 }
 
 bool P256Element::operator ==(const P256Element& other) const
 {
-    int cmp = EC_POINT_cmp(curve, point, other.point, 0);
+    int cmp = EC_POINT_cmp(curve, point, other.point, get_ctx());
     assert(cmp == 0 or cmp == 1);
     return not cmp;
 }
 
 void P256Element::pack(octetStream& os, int) const
 {
-    octet* buffer;
-    size_t length = EC_POINT_point2buf(curve, point,
-            POINT_CONVERSION_COMPRESSED, &buffer, 0);
+    // decompression on reception is several times slower than
+    // additional communication
+    octet buffer[1 + 2 * Scalar::N_BYTES];
+    size_t length = EC_POINT_point2oct(curve, point,
+            POINT_CONVERSION_UNCOMPRESSED, buffer, sizeof(buffer), get_ctx());
     assert(length != 0);
     os.store_int(length, 8);
     os.append(buffer, length);
-    free(buffer);
 }
 
 void P256Element::unpack(octetStream& os, int)
 {
     size_t length = os.get_int(8);
     assert(
-            EC_POINT_oct2point(curve, point, os.consume(length), length, 0)
-                    != 0);
+            EC_POINT_oct2point(curve, point, os.consume(length), length,
+                    get_ctx()) != 0);
 }
 
 ostream& operator <<(ostream& s, const P256Element& x)
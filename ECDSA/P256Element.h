@@ -52,6 +52,10 @@ public:
     P256Element operator-(const P256Element& other) const;
     P256Element operator*(const Scalar& other) const;
 
+    /// ``g_scalar * G + scalar * point`` in one go
+    static P256Element mul_add(const Scalar& g_scalar,
+            const P256Element& point, const Scalar& scalar);
+
     P256Element& operator+=(const P256Element& other);
     P256Element& operator*=(const Scalar& other);
     P256Element& operator/=(const Scalar& other);
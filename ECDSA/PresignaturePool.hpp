@@ -0,0 +1,250 @@
+/*
+ * PresignaturePool.hpp
+ *
+ */
+
+#ifndef ECDSA_PRESIGNATUREPOOL_HPP_
+#define ECDSA_PRESIGNATUREPOOL_HPP_
+
+#include "preprocessing.hpp"
+#include "sign.hpp"
+#include "Tools/Bundle.h"
+
+#include <deque>
+#include <fstream>
+
+/**
+ * Pool of ECDSA presignatures (preprocessing tuples) that is topped up
+ * with ``preprocessing()`` whenever the depth falls below a threshold,
+ * so that signing only requires the final opening. Refilling happens
+ * between signatures because preprocessing and signing share the same
+ * player. All parties see the same depth, so they refill in lockstep.
+ */
+template<template<class U> class T>
+class PresignaturePool
+{
+    typedef T<P256Element::Scalar> pShare;
+
+    deque<EcTuple<T>> tuples;
+
+    pShare sk;
+    SubProcessor<pShare>& proc;
+    typename pShare::MAC_Check& MCp;
+    typename T<P256Element>::Direct_MC MCc;
+    EcdsaOptions opts;
+
+    size_t threshold, batch_size;
+
+    string filename;
+
+    string get_flags()
+    {
+        return to_string(opts.prep_mul) + to_string(opts.fewer_rounds)
+                + to_string(opts.R_after_msg);
+    }
+
+public:
+    P256Element pk;
+
+    size_t n_produced, n_consumed, n_refills, min_depth;
+    double refill_time;
+
+    PresignaturePool(pShare sk, SubProcessor<pShare>& proc,
+            typename pShare::MAC_Check& MCp, EcdsaOptions opts,
+            size_t threshold, size_t batch_size);
+    ~PresignaturePool();
+
+    size_t depth()
+    {
+        return tuples.size();
+    }
+
+    /// Generate more tuples if below the threshold
+    void refill();
+
+    /// Sign message with one opening (two with ``-R``)
+    EcSignature sign(const unsigned char* message, size_t length);
+
+    /// Store key share and unused tuples in
+    /// ``Player-Data/ECDSA-Presignatures-P<player>``
+    void save();
+    /// Replace key and tuples by stored ones if all parties have them
+    void load();
+
+    void print_stats();
+};
+
+template<template<class U> class T>
+PresignaturePool<T>::PresignaturePool(pShare sk, SubProcessor<pShare>& proc,
+        typename pShare::MAC_Check& MCp, EcdsaOptions opts, size_t threshold,
+        size_t batch_size) :
+        sk(sk), proc(proc), MCp(MCp), MCc(MCp.get_alphai()), opts(opts),
+        threshold(threshold), batch_size(batch_size), n_produced(0),
+        n_consumed(0), n_refills(0), min_depth(0), refill_time(0)
+{
+    assert(batch_size > 0);
+    filename = PREP_DIR "ECDSA-Presignatures-P" + to_string(proc.P.my_num());
+    pk = MCc.open(sk, proc.P);
+    MCc.Check(proc.P);
+}
+
+template<template<class U> class T>
+PresignaturePool<T>::~PresignaturePool()
+{
+    MCc.Check(proc.P);
+}
+
+template<template<class U> class T>
+void PresignaturePool<T>::refill()
+{
+    if (tuples.size() > threshold)
+        return;
+
+    Timer timer;
+    timer.start();
+    vector<EcTuple<T>> new_tuples;
+    preprocessing<T>(new_tuples, batch_size, sk, proc, opts);
+    tuples.insert(tuples.end(), new_tuples.begin(), new_tuples.end());
+    n_produced += new_tuples.size();
+    n_refills++;
+    refill_time += timer.elapsed();
+}
+
+template<template<class U> class T>
+EcSignature PresignaturePool<T>::sign(const unsigned char* message,
+        size_t length)
+{
+    if (tuples.empty())
+        refill();
+
+    auto tuple = tuples.front();
+    tuples.pop_front();
+    n_consumed++;
+    if (n_consumed == 1 or tuples.size() < min_depth)
+        min_depth = tuples.size();
+
+    auto signature = ::sign<T>(message, length, tuple, MCp, MCc, proc.P,
+            opts, pk, sk, opts.prep_mul ? 0 : &proc);
+    if (opts.check_open)
+    {
+        MCp.Check(proc.P);
+        MCc.Check(proc.P);
+    }
+
+    refill();
+    return signature;
+}
+
+template<template<class U> class T>
+void PresignaturePool<T>::save()
+{
+    octetStream os;
+    sk.pack(os);
+    os.store(get_flags());
+    os.store(tuples.size());
+    for (auto& tuple : tuples)
+    {
+        tuple.a.pack(os);
+        tuple.b.pack(os);
+        tuple.c.pack(os);
+        tuple.secret_R.pack(os);
+        tuple.R.pack(os);
+    }
+
+    ofstream out(filename, ios::binary);
+    os.output(out);
+    if (out.fail())
+        throw file_error(filename);
+}
+
+template<template<class U> class T>
+void PresignaturePool<T>::load()
+{
+    vector<EcTuple<T>> loaded;
+    pShare file_sk;
+    ifstream in(filename, ios::binary);
+    if (in.good())
+    {
+        octetStream os;
+        os.input(in);
+        string flags;
+        file_sk.unpack(os);
+        os.get(flags);
+        size_t n = os.get_int(8);
+        if (flags == get_flags())
+        {
+            loaded.resize(n);
+            for (auto& tuple : loaded)
+            {
+                tuple.a.unpack(os);
+                tuple.b.unpack(os);
+                tuple.c.unpack(os);
+                tuple.secret_R.unpack(os);
+                tuple.R.unpack(os);
+            }
+        }
+    }
+
+    // tuples are only usable if all parties have the same ones
+    size_t n_loaded = loaded.size();
+    Bundle<octetStream> bundle(proc.P);
+    bundle.mine.store(n_loaded);
+    proc.P.unchecked_broadcast(bundle);
+    for (auto& os : bundle)
+        if (os.get_int(8) != n_loaded)
+            loaded.clear();
+
+    if (not loaded.empty())
+    {
+        sk = file_sk;
+        pk = MCc.open(sk, proc.P);
+        MCc.Check(proc.P);
+        tuples.clear();
+        tuples.insert(tuples.end(), loaded.begin(), loaded.end());
+    }
+
+    // don't use them twice
+    remove(filename.c_str());
+
+    if (OnlineOptions::singleton.verbose)
+        cerr << "Loaded " << loaded.size() << " presignatures from "
+                << filename << endl;
+}
+
+template<template<class U> class T>
+void PresignaturePool<T>::print_stats()
+{
+    cout << "Presignature pool: depth " << depth() << ", produced "
+            << n_produced << " in " << n_refills << " refills taking "
+            << refill_time << " seconds, consumed " << n_consumed
+            << ", minimum depth " << min_depth << endl;
+}
+
+template<template<class U> class T>
+void pool_benchmark(T<P256Element::Scalar> sk,
+        SubProcessor<T<P256Element::Scalar>>& proc,
+        typename T<P256Element::Scalar>::MAC_Check& MCp, EcdsaOptions& opts,
+        int n_tuples)
+{
+    PresignaturePool<T> pool(sk, proc, MCp, opts, opts.pool_threshold,
+            n_tuples);
+    if (opts.persist_presignatures)
+        pool.load();
+    pool.refill();
+
+    // enough signatures to trigger one top-up
+    unsigned char message[1024];
+    GlobalPRNG(proc.P).get_octets(message, 1024);
+    int n_signatures = max(1, n_tuples - opts.pool_threshold + 1);
+    for (int i = 0; i < n_signatures; i++)
+    {
+        size_t length = 1 << (i % 11);
+        check(pool.sign(message, length), message, length, pool.pk);
+    }
+
+    pool.print_stats();
+    if (opts.persist_presignatures)
+        pool.save();
+}
+
+#endif /* ECDSA_PRESIGNATUREPOOL_HPP_ */
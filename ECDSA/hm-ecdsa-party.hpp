@@ -21,6 +21,7 @@
 
 #include "ECDSA/preprocessing.hpp"
 #include "ECDSA/sign.hpp"
+#include "ECDSA/PresignaturePool.hpp"
 #include "Protocols/MaliciousRepMC.hpp"
 #include "Protocols/Beaver.hpp"
 #include "Protocols/fake-stuff.hpp"
@@ -76,10 +77,15 @@ void run(int argc, const char** argv)
     ArithmeticProcessor _({}, 0);
     SubProcessor<pShare> proc(_, MCp, prep, P);
 
-    bool prep_mul = not opt.isSet("-D");
-    vector<EcTuple<T>> tuples;
-    preprocessing<T>(tuples, n_tuples, sk, proc, opts);
-//    check(tuples, sk, {}, P);
-    sign_benchmark<T>(tuples, sk, MCp, P, opts, prep_mul ? 0 : &proc);
+    if (opts.pool_threshold > 0)
+        pool_benchmark<T>(sk, proc, MCp, opts, n_tuples);
+    else
+    {
+        bool prep_mul = not opt.isSet("-D");
+        vector<EcTuple<T>> tuples;
+        preprocessing<T>(tuples, n_tuples, sk, proc, opts);
+//        check(tuples, sk, {}, P);
+        sign_benchmark<T>(tuples, sk, MCp, P, opts, prep_mul ? 0 : &proc);
+    }
     P256Element::finish();
 }
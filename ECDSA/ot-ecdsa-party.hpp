@@ -13,6 +13,7 @@
 
 #include "ECDSA/preprocessing.hpp"
 #include "ECDSA/sign.hpp"
+#include "ECDSA/PresignaturePool.hpp"
 #include "Protocols/Beaver.hpp"
 #include "Protocols/fake-stuff.hpp"
 #include "Protocols/MascotPrep.hpp"
@@ -135,10 +136,20 @@ void run(int argc, const char** argv)
 
     bool prep_mul = not opt.isSet("-D");
     prep.params.use_extension = not opt.isSet("-S");
-    vector<EcTuple<T>> tuples;
-    preprocessing(tuples, n_tuples, sk, proc, opts);
-    //check(tuples, sk, keyp, P);
-    sign_benchmark(tuples, sk, MCp, P, opts, prep_mul ? 0 : &proc);
+    if (opts.pool_threshold > 0)
+    {
+        // MAC key is not stored
+        if (opts.persist_presignatures)
+            throw runtime_error("persistence not supported with OT-based protocols");
+        pool_benchmark<T>(sk, proc, MCp, opts, n_tuples);
+    }
+    else
+    {
+        vector<EcTuple<T>> tuples;
+        preprocessing(tuples, n_tuples, sk, proc, opts);
+        //check(tuples, sk, keyp, P);
+        sign_benchmark(tuples, sk, MCp, P, opts, prep_mul ? 0 : &proc);
+    }
 
     pShare::MAC_Check::teardown();
     T<P256Element>::MAC_Check::teardown();
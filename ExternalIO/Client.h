@@ -8,6 +8,9 @@
 
 #include "Networking/ssl_sockets.h"
 
+#include <thread>
+#include <exception>
+
 #ifdef NO_CLIENT_TLS
 class client_ctx
 {
@@ -60,6 +63,11 @@ class Client
     client_ctx ctx;
     ssl_service io_service;
 
+    template<class T>
+    vector<T> receive_masks(size_t n);
+    template<class T>
+    void send_masked(const vector<T>& values, const vector<T>& masks);
+
 public:
     /**
      * Sockets for cleartext communication
@@ -87,6 +95,15 @@ public:
     template<class T>
     void send_private_inputs(const vector<T>& values);
 
+    /**
+     * Securely input several batches of private values for
+     * ``sint.stream_from_client``, which sends the masks for the next
+     * batch ahead of time.
+     * @param batches vector of vectors of integer-like values
+     */
+    template<class T>
+    void send_private_input_stream(const vector<vector<T>>& batches);
+
     /**
      * Securely receive output values.
      * @param n number of values
@@ -94,6 +111,16 @@ public:
      */
     template<class T, class U = T>
     vector<U> receive_outputs(int n);
+
+    /**
+     * Securely receive several output messages, for example from
+     * ``sint.reveal_to_clients_batch``, from all parties concurrently.
+     * @param n number of values per message
+     * @param n_messages number of messages
+     * @returns vector of vectors of integer-like values
+     */
+    template<class T, class U = T>
+    vector<vector<U>> receive_outputs(int n, int n_messages);
 };
 
 #endif /* EXTERNALIO_CLIENT_H_ */
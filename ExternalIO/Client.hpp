@@ -43,27 +43,43 @@ Client::~Client()
     }
 }
 
-// Send the private inputs masked with a random value.
 // Receive shares of a preprocessed triple from each SPDZ engine, combine and check the triples are valid.
-// Add the private input value to triple[0] and send to each spdz engine.
+// Returns the first element of every triple for masking.
 template<class T>
-void Client::send_private_inputs(const vector<T>& values)
+vector<T> Client::receive_masks(size_t num_inputs)
 {
-    int num_inputs = values.size();
-    octetStream os;
+    // receive from all parties concurrently
+    vector<octetStream> messages(sockets.size());
+    vector<exception_ptr> errors(sockets.size());
+    vector<thread> threads;
+    for (size_t j = 0; j < sockets.size(); j++)
+        threads.push_back(thread([&, j]()
+        {
+            try
+            {
+#ifdef VERBOSE_COMM
+                cerr << "receiving from " << j << endl << flush;
+#endif
+                messages[j].Receive(sockets[j]);
+            }
+            catch (...)
+            {
+                errors[j] = current_exception();
+            }
+        }));
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& error : errors)
+        if (error)
+            rethrow_exception(error);
+
     vector< vector<T> > triples(num_inputs, vector<T>(3));
     vector<T> triple_shares(3);
     bool active = true;
 
-    // Receive num_inputs triples from SPDZ
     for (size_t j = 0; j < sockets.size(); j++)
     {
-#ifdef VERBOSE_COMM
-        cerr << "receiving from " << j << endl << flush;
-#endif
-
-        os.reset_write_head();
-        os.Receive(sockets[j]);
+        auto& os = messages[j];
 
 #ifdef VERBOSE_COMM
         cerr << "received " << os.get_length() << " from " << j << endl << flush;
@@ -71,33 +87,33 @@ void Client::send_private_inputs(const vector<T>& values)
 
         if (j == 0)
         {
-            if (os.get_length() == 3 * values.size() * T::size())
+            if (os.get_length() == 3 * num_inputs * T::size())
                 active = true;
             else
                 active = false;
         }
 
         int n_expected = active ? 3 : 1;
-        if (os.get_length() != n_expected * T::size() * values.size())
+        if (os.get_length() != n_expected * T::size() * num_inputs)
             throw runtime_error(
                     "unexpected data length in sending, "
                             "server-side code has to have to correct length, "
                             "most likely 'receive_from_client("
-                            + to_string(values.size()) + ", ...)'");
+                            + to_string(num_inputs) + ", ...)'");
 
-        for (int j = 0; j < num_inputs; j++)
+        for (size_t i = 0; i < num_inputs; i++)
         {
             for (int k = 0; k < n_expected; k++)
             {
                 triple_shares[k].unpack(os);
-                triples[j][k] += triple_shares[k];
+                triples[i][k] += triple_shares[k];
             }
         }
     }
 
     if (active)
         // Check triple relations (is a party cheating?)
-        for (int i = 0; i < num_inputs; i++)
+        for (size_t i = 0; i < num_inputs; i++)
         {
             if (T(triples[i][0] * triples[i][1]) != triples[i][2])
             {
@@ -107,11 +123,21 @@ void Client::send_private_inputs(const vector<T>& values)
             }
         }
 
-    // Send inputs + triple[0], so SPDZ can compute shares of each value
-    os.reset_write_head();
-    for (int i = 0; i < num_inputs; i++)
+    vector<T> masks;
+    for (auto& triple : triples)
+        masks.push_back(triple[0]);
+    return masks;
+}
+
+// Send inputs + triple[0], so SPDZ can compute shares of each value
+template<class T>
+void Client::send_masked(const vector<T>& values, const vector<T>& masks)
+{
+    assert(values.size() == masks.size());
+    octetStream os;
+    for (size_t i = 0; i < values.size(); i++)
     {
-        T y = values[i] + triples[i][0];
+        T y = values[i] + masks[i];
         y.pack(os);
     }
 
@@ -119,60 +145,111 @@ void Client::send_private_inputs(const vector<T>& values)
         os.Send(socket);
 }
 
+// Send the private inputs masked with a random value.
+template<class T>
+void Client::send_private_inputs(const vector<T>& values)
+{
+    send_masked(values, receive_masks<T>(values.size()));
+}
+
+// The server sends the masks for the next batch before waiting for
+// the current one, so they are usually available by the time the
+// current batch is sent.
+template<class T>
+void Client::send_private_input_stream(const vector<vector<T>>& batches)
+{
+    if (batches.empty())
+        return;
+
+    auto masks = receive_masks<T>(batches[0].size());
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        send_masked(batches[i], masks);
+        if (i + 1 < batches.size())
+            masks = receive_masks<T>(batches[i + 1].size());
+    }
+}
+
 // Receive shares of the result and sum together.
 // Also receive authenticating values.
 template<class T, class U>
 vector<U> Client::receive_outputs(int n)
 {
-    vector<T> triples(3 * n);
-    octetStream os;
-    bool active = true;
-    for (auto& socket : sockets)
+    return receive_outputs<T, U>(n, 1).at(0);
+}
+
+template<class T, class U>
+vector<vector<U>> Client::receive_outputs(int n, int n_messages)
+{
+    // receive from all parties concurrently
+    vector<vector<octetStream>> messages(sockets.size(),
+            vector<octetStream>(n_messages));
+    vector<exception_ptr> errors(sockets.size());
+    vector<thread> threads;
+    for (size_t j = 0; j < sockets.size(); j++)
+        threads.push_back(thread([&, j]()
+        {
+            try
+            {
+                for (auto& os : messages[j])
+                    os.Receive(sockets[j]);
+            }
+            catch (...)
+            {
+                errors[j] = current_exception();
+            }
+        }));
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& error : errors)
+        if (error)
+            rethrow_exception(error);
+
+    vector<vector<U>> res;
+    for (int k = 0; k < n_messages; k++)
     {
-        os.reset_write_head();
-        os.Receive(socket);
+        vector<T> triples(3 * n);
+        bool active = true;
+        for (size_t j = 0; j < sockets.size(); j++)
+        {
+            auto& os = messages[j][k];
 #ifdef VERBOSE_COMM
-        cout << "received " << os.get_length() << endl << flush;
+            cout << "received " << os.get_length() << endl << flush;
 #endif
 
-        if (socket == sockets[0])
-        {
-            if (os.get_length() == (size_t) 3 * n * T::size())
-                active = true;
-            else
-                active = false;
-        }
+            if (j == 0)
+            {
+                if (os.get_length() == (size_t) 3 * n * T::size())
+                    active = true;
+                else
+                    active = false;
+            }
 
-        int n_expected = n * (active ? 3 : 1);
-        if (os.get_length() != (size_t) n_expected * T::size())
-            throw runtime_error("unexpected data length in receiving");
+            int n_expected = n * (active ? 3 : 1);
+            if (os.get_length() != (size_t) n_expected * T::size())
+                throw runtime_error("unexpected data length in receiving");
 
-        for (int j = 0; j < n_expected; j++)
-        {
-            T value;
-            value.unpack(os);
-            triples[j] += value;
+            for (int i = 0; i < n_expected; i++)
+            {
+                T value;
+                value.unpack(os);
+                triples[i] += value;
+            }
         }
-    }
 
-    if (active)
-    {
         vector<U> output_values;
-        for (int i = 0; i < 3 * n; i += 3)
+        int step = active ? 3 : 1;
+        for (int i = 0; i < step * n; i += step)
         {
-            if (T(triples[i] * triples[i + 1]) != triples[i + 2])
+            if (active and T(triples[i] * triples[i + 1]) != triples[i + 2])
             {
                 cerr << "Unable to authenticate output value as correct, aborting." << endl;
                 throw mac_fail();
             }
             output_values.push_back(triples[i]);
         }
-
-        return output_values;
-    }
-    else
-    {
-        triples.resize(n);
-        return triples;
+        res.push_back(output_values);
     }
+
+    return res;
 }
@@ -119,8 +119,33 @@ class Client:
         :param values: list of input values
 
         """
+        triples = self.receive_triples(self.domain, len(values))
+        self.send_masked(values, triples)
+
+    def send_private_input_stream(self, batches):
+        """ Send batches of inputs privately to
+        :py:func:`~Compiler.types.sint.stream_from_client`, which
+        sends the masks for the next batch before waiting for the
+        current one. This hides the round trip per batch.
+
+        :param batches: iterable of lists of input values
+
+        """
+        T = self.domain
+        batches = iter(batches)
+        batch = next(batches, None)
+        if batch is not None:
+            batch = list(batch)
+            triples = self.receive_triples(T, len(batch))
+        while batch is not None:
+            self.send_masked(batch, triples)
+            batch = next(batches, None)
+            if batch is not None:
+                batch = list(batch)
+                triples = self.receive_triples(T, len(batch))
+
+    def send_masked(self, values, triples):
         T = self.domain
-        triples = self.receive_triples(T, len(values))
         os = octetStream()
         assert len(values) == len(triples)
         for value, triple in zip(values, triples):
@@ -0,0 +1,72 @@
+/*
+ * Client for mpc-service.x, which keeps running and executes exported
+ * functions on 64-bit integers for any number of clients.
+ *
+ * Each request consists of the function name, the sizes of the vector
+ * arguments, and the size of the result. The inputs are masked as in
+ * bankers-bonus-client.cpp, and the parties reveal the result only to
+ * the client.
+ *
+ * To run:
+ *   ./Scripts/setup-clients.sh 1
+ *   ./compile.py -E ring export-service
+ *   make mpc-service.x service-client.x
+ *   for i in 0 1 2; do ./mpc-service.x $i & true; done
+ *
+ *   ./service-client.x 0 inner_product 1 2 3 4 5 6
+ *
+ *   Expect 32 as result, the inner product of (1, 2, 3) and (4, 5, 6).
+ */
+
+#include "Math/Z2k.hpp"
+#include "Tools/int.h"
+
+#include "Client.hpp"
+
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        cout << "Usage is service-client <client identifier> "
+                << "<function> <inputs...>" << endl
+                << "The inputs are split evenly between two vector arguments."
+                << endl;
+        exit(0);
+    }
+
+    int my_client_id = atoi(argv[1]);
+    string function = argv[2];
+    vector<Z2<64>> inputs;
+    for (int i = 3; i < argc; i++)
+        inputs.push_back(atol(argv[i]));
+    if (inputs.size() % 2)
+    {
+        cerr << "need an even number of inputs" << endl;
+        exit(1);
+    }
+
+    bigint::init_thread();
+    Client client(vector<string>(3, "localhost"), 14000, my_client_id);
+
+    int type = client.specification.get<int>();
+    if (type != 'R' or client.specification.get<int>() != 64)
+    {
+        cerr << "service only implemented for 64-bit rings" << endl;
+        exit(1);
+    }
+
+    octetStream os;
+    os.store(function);
+    os.store_int(2, 4);
+    for (int i = 0; i < 2; i++)
+        os.store_int(inputs.size() / 2, 4);
+    os.store_int(1, 4);
+    for (auto& socket : client.sockets)
+        os.Send(socket);
+
+    client.send_private_inputs(inputs);
+    auto result = client.receive_outputs<Z2<64>>(1)[0];
+    cout << "Result: " << result << endl;
+}
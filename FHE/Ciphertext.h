@@ -123,6 +123,18 @@ class Ciphertext
   void unpack(octetStream& o, int = -1)
     { cc0.unpack(o, *params); cc1.unpack(o, *params); o.get(pk_id); }
 
+  // set second component as in FHE_SK::encrypt()
+  void expand_seed(const octet* seed)
+    { PRNG G; G.SetSeed(seed); cc1.randomize(G); }
+
+  /// Append to buffer with seed instead of second component
+  void pack_seeded(octetStream& o, const octet* seed) const
+    { cc0.pack(o); o.append(seed, SEED_SIZE); o.store(pk_id); }
+
+  /// Read from buffer written by pack_seeded()
+  void unpack_seeded(octetStream& o)
+    { cc0.unpack(o, *params); expand_seed(o.consume(SEED_SIZE)); o.get(pk_id); }
+
   void output(ostream& s) const
     { cc0.output(s); cc1.output(s); s.write((char*)&pk_id, sizeof(pk_id)); }
   void input(istream& s)
@@ -0,0 +1,56 @@
+/*
+ * CoefficientPool.cpp
+ *
+ */
+
+#include "CoefficientPool.h"
+
+thread_local CoefficientPool::FreeLists CoefficientPool::free_lists;
+thread_local bool CoefficientPool::finished = false;
+atomic<size_t> CoefficientPool::n_bytes(0), CoefficientPool::peak_bytes(0);
+
+CoefficientPool::FreeLists::~FreeLists()
+{
+  finished = true;
+  CoefficientPool::n_bytes -= n_bytes;
+}
+
+void CoefficientPool::reserve(buffer_type& buffer, size_t size)
+{
+  if (buffer.capacity() >= size)
+    return;
+
+  if (buffer.empty() and not finished)
+    {
+      auto it = free_lists.find(size);
+      if (it != free_lists.end() and not it->second.empty())
+        {
+          buffer.swap(it->second.back());
+          it->second.pop_back();
+          size_t bytes = size * sizeof(modp);
+          free_lists.n_bytes -= bytes;
+          n_bytes -= bytes;
+          return;
+        }
+    }
+
+  buffer.reserve(size);
+}
+
+void CoefficientPool::release(buffer_type& buffer)
+{
+  size_t capacity = buffer.capacity();
+  size_t bytes = capacity * sizeof(modp);
+  if (capacity == 0 or finished or free_lists.n_bytes + bytes > MAX_BYTES)
+    return;
+
+  buffer.clear();
+  free_lists[capacity].push_back({});
+  free_lists[capacity].back().swap(buffer);
+  free_lists.n_bytes += bytes;
+
+  size_t total = n_bytes += bytes;
+  size_t peak = peak_bytes;
+  while (total > peak and not peak_bytes.compare_exchange_weak(peak, total))
+    ;
+}
@@ -0,0 +1,68 @@
+/*
+ * CoefficientPool.h
+ *
+ */
+
+#ifndef FHE_COEFFICIENTPOOL_H_
+#define FHE_COEFFICIENTPOOL_H_
+
+#include "Math/modp.h"
+
+#include <vector>
+#include <map>
+#include <atomic>
+using namespace std;
+
+/*
+ * Per-thread free lists for coefficient buffers of ring elements by
+ * capacity, which is phi(m) or m for a given FFT_Data. Temporaries in
+ * the offline phase thus reuse the memory of earlier ones instead of
+ * allocating.
+ */
+class CoefficientPool
+{
+  typedef vector<modp> buffer_type;
+
+  class FreeLists : public map<size_t, vector<buffer_type>>
+  {
+  public:
+    size_t n_bytes = 0;
+    ~FreeLists();
+  };
+
+  static thread_local FreeLists free_lists;
+  // free lists are unavailable during thread exit
+  static thread_local bool finished;
+
+  static atomic<size_t> n_bytes, peak_bytes;
+
+  // limit per thread
+  static const size_t MAX_BYTES = size_t(1) << 28;
+
+public:
+  // capacity of at least size, reusing a pooled buffer if possible
+  static void reserve(buffer_type& buffer, size_t size);
+  // keep buffer for reuse, leaving it empty
+  static void release(buffer_type& buffer);
+
+  // most memory held in pools across threads
+  static size_t peak() { return peak_bytes; }
+};
+
+// scratch buffer from pool
+class PooledBuffer : public vector<modp>
+{
+public:
+  PooledBuffer(size_t size)
+  {
+    CoefficientPool::reserve(*this, size);
+    resize(size);
+  }
+
+  ~PooledBuffer()
+  {
+    CoefficientPool::release(*this);
+  }
+};
+
+#endif /* FHE_COEFFICIENTPOOL_H_ */
@@ -5,8 +5,25 @@
 
 #include "Diagonalizer.h"
 
+#include <thread>
+
+// run job on ranges of [0, n_items) in up to n_threads threads
+template<class T>
+void run_in_threads(int n_items, int n_threads, const T& job)
+{
+    n_threads = max(1, min(n_threads, n_items));
+    vector<thread> threads;
+    for (int i = 1; i < n_threads; i++)
+        threads.push_back(
+                thread(job, n_items * i / n_threads,
+                        n_items * (i + 1) / n_threads));
+    job(0, n_items / n_threads);
+    for (auto& thread : threads)
+        thread.join();
+}
+
 Diagonalizer::Diagonalizer(const MatrixVector& matrices,
-        const FFT_Data& FTD, const FHE_PK& pk) :
+        const FFT_Data& FTD, const FHE_PK& pk, int n_threads) :
         FTD(FTD)
 {
     CODE_LOCATION
@@ -21,19 +38,23 @@ Diagonalizer::Diagonalizer(const MatrixVector& matrices,
     n_rows = matrices[0].n_rows;
     n_cols = matrices[0].n_cols;
     assert(n_rows * matrices.size() <= size_t(FTD.num_slots()));
-    for (size_t i = 0; i < n_cols; i++)
+    ciphertexts.resize(n_cols, Ciphertext(pk));
+    run_in_threads(n_cols, n_threads, [&](size_t begin, size_t end)
     {
-        Plaintext_<FFT_Data> plaintext(FTD, Evaluation);
-        for (size_t k = 0; k < matrices.size(); k++)
+        for (size_t i = begin; i < end; i++)
         {
-            for (size_t j = 0; j < n_rows; j++)
+            Plaintext_<FFT_Data> plaintext(FTD, Evaluation);
+            for (size_t k = 0; k < matrices.size(); k++)
             {
-                auto entry = matrices.at(k)[{j, (j + i) % n_cols}];
-                plaintext.set_element(k * n_rows + j, entry);
+                for (size_t j = 0; j < n_rows; j++)
+                {
+                    auto entry = matrices.at(k)[{j, (j + i) % n_cols}];
+                    plaintext.set_element(k * n_rows + j, entry);
+                }
             }
+            ciphertexts[i] = pk.encrypt(plaintext);
         }
-        ciphertexts.push_back(pk.encrypt(plaintext));
-    }
+    });
 }
 
 Plaintext_<FFT_Data> Diagonalizer::get_plaintext(
@@ -48,6 +69,27 @@ Plaintext_<FFT_Data> Diagonalizer::get_plaintext(
     return plaintext;
 }
 
+Ciphertext Diagonalizer::multiply(const vector<Ciphertext>& multiplicands,
+        const MatrixVector& matrices, int right_col, const FHE_PK& pk,
+        int n_threads)
+{
+    int n_inner = multiplicands.size();
+    n_threads = max(1, min(n_threads, n_inner));
+    vector<Ciphertext> sums(n_threads, Ciphertext(pk));
+    // one partial sum per thread
+    run_in_threads(n_threads, n_threads, [&](int i_thread, int)
+    {
+        // conversion to evaluation representation happens here as well
+        for (int i = n_inner * i_thread / n_threads;
+                i < n_inner * (i_thread + 1) / n_threads; i++)
+            sums[i_thread] += multiplicands.at(i)
+                    * get_plaintext(matrices, i, right_col);
+    });
+    for (int i = 1; i < n_threads; i++)
+        sums[0] += sums[i];
+    return sums[0];
+}
+
 Diagonalizer::MatrixVector Diagonalizer::decrypt(
         const vector<Ciphertext>& products, int n_matrices, FHE_SK& sk)
 {
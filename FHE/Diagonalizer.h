@@ -22,11 +22,16 @@ public:
     vector<Ciphertext> ciphertexts;
 
     Diagonalizer(const MatrixVector& matrices,
-            const FFT_Data& FTD, const FHE_PK& pk);
+            const FFT_Data& FTD, const FHE_PK& pk, int n_threads = 1);
 
     Plaintext_<FFT_Data> get_plaintext(const MatrixVector& matrices,
             int left_col, int right_col);
 
+    // sum of products with the diagonals of column right_col
+    Ciphertext multiply(const vector<Ciphertext>& multiplicands,
+            const MatrixVector& matrices, int right_col, const FHE_PK& pk,
+            int n_threads = 1);
+
     MatrixVector decrypt(const vector<Ciphertext>&, int n_matrices, FHE_SK& sk);
 
     MatrixVector dediag(const vector<Plaintext_<FFT_Data>>& plaintexts,
@@ -1,5 +1,6 @@
 
 #include "FHE/FFT.h"
+#include "FHE/CoefficientPool.h"
 #include "Math/Zp_Data.h"
 #include "Processor/BaseMachine.h"
 #include "Tools/CodeLocations.h"
@@ -131,7 +132,7 @@ void FFT_Iter2(vector<modp>& ioput, int n, const vector<modp>& roots,
 void FFT_Iter(vector<modp>& ioput, int n, const modp& root, const Zp_Data& PrD,
         bool start_with_one)
 {
-    vector<modp> roots(n + 1);
+    PooledBuffer roots(n + 1);
     assignOne(roots[0], PrD);
     for (int i = 1; i < n + 1; i++)
         Mul(roots[i], roots[i - 1], root, PrD);
@@ -165,8 +166,7 @@ void FFT_Iter(vector<modp>& ioput, int n, const vector<modp>& roots,
     }
     m = 0; j = 0; i = 0;
     // Do the transform
-    vector<modp> alpha2;
-    alpha2.reserve(n / 2);
+    PooledBuffer alpha2(n / 2);
     for (int s = 1; s < n; s = 2*s)
     {
         m = 2*s;
@@ -232,7 +232,7 @@ void FFT2(vector<modp>& a, int N, const modp& alpha, const Zp_Data& PrD)
 
 void FFT_non_power_of_two(vector<modp>& res, const vector<modp>& input, const FFT_Data& FFTD)
 {
-    vector<modp> tmp(FFTD.m());
+    PooledBuffer tmp(FFTD.m());
     BFFT(tmp, input, FFTD);
     for (int i = 0; i < (FFTD).phi_m(); i++)
         res[i] = tmp[(FFTD).p(i)];
@@ -246,7 +246,7 @@ void BFFT(vector<modp>& ans,const vector<modp>& a,const FFT_Data& FFTD,bool forw
   if (forward==false) { r=1; }
 
   if (FFTD.twop>0)
-     { vector<modp> x(k2);
+     { PooledBuffer x(k2);
        for (unsigned int i=0; i<a.size(); i++)
          { Mul(x[i],FFTD.powers[r][i],a[i],FFTD.get_prD()); }
        for (int i=a.size(); i<k2; i++)
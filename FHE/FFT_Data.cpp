@@ -37,6 +37,7 @@ void FFT_Data::init(const Ring& Rg,const Zp_Data& PrD)
           to_modp(iphi,Rg.phi_m(),PrD);
           Inv(iphi,iphi,PrD);
           compute_roots(Rg.m());
+          init_ntt();
         }
     }
   else 
@@ -97,6 +98,28 @@ void FFT_Data::compute_roots(int n)
 }
 
 
+void FFT_Data::init_ntt()
+{
+  ntt = {};
+  if (twop != 0 or not NTT64::suitable(prData))
+    return;
+  bigint x[3];
+  to_bigint(x[0], root[0], prData);
+  to_bigint(x[1], root[1], prData);
+  to_bigint(x[2], iphi, prData);
+  // products of Montgomery representations have an extra factor
+  bigint product_scale = 1;
+  if (prData.get_mont())
+    {
+      bigint R = bigint(1) << 64;
+      mpz_invert(product_scale.get_mpz_t(), R.get_mpz_t(),
+          prData.pr.get_mpz_t());
+    }
+  ntt.init(prData.pr.get_ui(), phi_m(), x[0].get_ui(), x[1].get_ui(),
+      x[2].get_ui(), product_scale.get_ui());
+}
+
+
 void FFT_Data::hash(octetStream& o) const
 {
   octetStream tmp;
@@ -132,6 +155,8 @@ void FFT_Data::unpack(octetStream& o)
   iphi.unpack(o);
   o.get(powers);
   o.get(powers_i);
+  if (twop == 0 and root.size() == 2)
+    init_ntt();
 }
 
 bool FFT_Data::operator!=(const FFT_Data& other) const
@@ -6,6 +6,7 @@
 #include "Math/gfpvar.h"
 #include "Math/fixint.h"
 #include "FHE/Ring.h"
+#include "FHE/NTT64.h"
 
 /* Class for holding modular arithmetic data wrt the ring 
  *
@@ -35,7 +36,11 @@ class FFT_Data
   modp iphi;    // 1/phi_m mod pr
   vector< vector<modp> > powers,powers_i;
 
+  // faster transform for small primes, derived from the above
+  NTT64 ntt;
+
   void compute_roots(int n);
+  void init_ntt();
 
   public:
   typedef gfp T;
@@ -68,6 +73,7 @@ class FFT_Data
   modp get_root(int i) const     { return root[i];    }
   modp get_iphi() const          { return iphi;       }
   const vector<modp>& get_roots() const { return roots; }
+  const NTT64& get_ntt() const   { return ntt; }
 
   const Ring& get_R() const      { return R; }
 
@@ -227,6 +227,30 @@ Rq_Element FHE_SK::quasi_decrypt(const Ciphertext& c) const
 
 
 
+template<class FD>
+Ciphertext FHE_SK::encrypt(const Plaintext_<FD>& mess, const FHE_PK& pk,
+    const octet* seed) const
+{
+  CODE_LOCATION
+
+  Ciphertext res(pk);
+  res.expand_seed(seed);
+
+  // c0 = c1 * s + p * e + mess
+  SeededPRNG G;
+  Rq_Element e(params->FFTD(), polynomial, polynomial);
+  e.from(GaussianGenerator<bigint>(params->get_DG(), G));
+  Rq_Element mm(params->FFTD(), polynomial, polynomial);
+  mm.from(mess.get_iterator());
+  auto edd = e * pr + mm;
+  edd.change_rep(evaluation);
+  auto c0 = res.c1() * sk;
+  add(c0, c0, edd);
+
+  res.set(c0, res.c1(), pk);
+  return res;
+}
+
 Plaintext_<FFT_Data> FHE_SK::decrypt(const Ciphertext& c)
 {
   return decrypt(c, params->get_plaintext_field_data<FFT_Data>());
@@ -413,6 +437,8 @@ bigint FHE_SK::get_noise(const Ciphertext& c)
 		const Ciphertext& c) const; \
         template void FHE_SK::decrypt_any(Plaintext_<FD>& res, \
 		const Ciphertext& c); \
+        template Ciphertext FHE_SK::encrypt(const Plaintext_<FD>& mess, \
+                const FHE_PK& pk, const octet* seed) const; \
         template void FHE_SK::check(const FHE_PK& pk, const FD&);
 
 X(FFT_Data)
@@ -68,6 +68,13 @@ class FHE_SK
 
   Rq_Element quasi_decrypt(const Ciphertext& c) const;
 
+  // Symmetric encryption with the second component derived from seed
+  // for compact transmission, see Ciphertext::pack_seeded().
+  // Only for parameters without multiplication (a single level)
+  template <class FD>
+  Ciphertext encrypt(const Plaintext_<FD>& mess, const FHE_PK& pk,
+      const octet* seed) const;
+
   // Three stage procedure for Distributed Decryption
   //  - First stage produces my shares
   //  - Second stage adds in another players shares, do this once for each other player
@@ -43,6 +43,32 @@ void generate_setup(int n, int lgp, int lg2, int sec, bool skip_2,
 }
 
 
+static string tuned_filename(int plaintext_length, int n_mults)
+{
+  return PREP_DIR "HE-Params-" + to_string(plaintext_length) + "-"
+      + to_string(n_mults);
+}
+
+int tuned_cyclotomic_index(int plaintext_length, int n_mults)
+{
+  int m = 0;
+  ifstream file(tuned_filename(plaintext_length, n_mults));
+  file >> m;
+  if (m and OnlineOptions::singleton.verbose)
+    cerr << "Using cyclotomic index of at least " << m << " from "
+        << tuned_filename(plaintext_length, n_mults) << endl;
+  return m;
+}
+
+void store_tuned_cyclotomic_index(int plaintext_length, int n_mults, int m)
+{
+  mkdir_p(PREP_DIR);
+  ofstream file(tuned_filename(plaintext_length, n_mults));
+  file << m << endl;
+  if (not file.good())
+    throw file_error(tuned_filename(plaintext_length, n_mults));
+}
+
 bool same_word_length(int l1, int l2)
 {
   return l1 / 64 == l2 / 64;
@@ -50,10 +76,12 @@ bool same_word_length(int l1, int l2)
 
 template <>
 int generate_semi_setup(int plaintext_length, int sec,
-    FHE_Params& params, FFT_Data& FTD, bool round_up, int n)
+    FHE_Params& params, FFT_Data& FTD, bool round_up, int n, int min_m)
 {
   CODE_LOCATION
-  int m = 1024;
+  if (min_m < 0)
+    min_m = tuned_cyclotomic_index(plaintext_length, params.n_mults());
+  int m = max(1024, min_m);
   int lgp = plaintext_length;
   bigint p;
   generate_prime(p, lgp, m);
@@ -93,7 +121,7 @@ int generate_semi_setup(int plaintext_length, int sec,
 
 template <>
 int generate_semi_setup(int plaintext_length, int sec,
-    FHE_Params& params, P2Data& P2D, bool round_up, int n)
+    FHE_Params& params, P2Data& P2D, bool round_up, int n, int)
 {
   CODE_LOCATION
 
@@ -229,6 +257,14 @@ int Parameters::SPDZ_Data_Setup_Char_p_Sub(int idx, int& m, bigint& p,
   else if (sec == -1)
     throw runtime_error("no precomputed parameters available");
 
+  if (min_m < 0)
+    min_m = tuned_cyclotomic_index(plaintext_length, params.n_mults());
+  if (sec != -1 and min_m > m)
+    {
+      m = min_m;
+      generate_prime(p, numBits(p), m);
+    }
+
   while (sec != -1)
     {
       double phi_m_bound =
@@ -22,10 +22,13 @@ public:
   Ring R;
   bigint pr0, pr1;
 
+  // lower bound on cyclotomic index, -1 for tuned_cyclotomic_index()
+  int min_m;
+
   Parameters(int n_parties, int plaintext_length, int sec, int slack = 0,
       bool round_up = false) :
       n_parties(n_parties), plaintext_length(plaintext_length), sec(sec), slack(
-          slack), round_up(round_up)
+          slack), round_up(round_up), min_m(-1)
   {
   }
 
@@ -48,10 +51,15 @@ public:
 void generate_setup(int nparties, int lgp, int lg2,
     int sec, bool skip_2 = false, int slack = 0, bool round_up = false);
 
-// semi-homomorphic, includes slack
+// semi-homomorphic, includes slack,
+// min_m is a lower bound on the cyclotomic index as in Parameters
 template <class FD>
 int generate_semi_setup(int plaintext_length, int sec,
-    FHE_Params& params, FD& FieldD, bool round_up, int n = 1);
+    FHE_Params& params, FD& FieldD, bool round_up, int n = 1, int min_m = -1);
+
+// cyclotomic index chosen by he-params.x or zero
+int tuned_cyclotomic_index(int plaintext_length, int n_mults);
+void store_tuned_cyclotomic_index(int plaintext_length, int n_mults, int m);
 
 // field-independent semi-homomorphic setup
 int common_semi_setup(FHE_Params& params, int m, bigint p, int& lgp0, int lgp1,
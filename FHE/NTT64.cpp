@@ -0,0 +1,329 @@
+/*
+ * NTT64.cpp
+ *
+ */
+
+#include "FHE/NTT64.h"
+#include "Tools/CodeLocations.h"
+
+#include "Math/modp.hpp"
+
+#include <immintrin.h>
+
+#ifdef USE_HEXL
+#include "hexl/hexl.hpp"
+#include "Tools/random.h"
+#include <map>
+#endif
+
+bool NTT64::suitable(const Zp_Data& PrD)
+{
+  return PrD.get_t() == 1 and PrD.pr_bit_length <= 62;
+}
+
+inline word mul_mod(word x, word y, word p)
+{
+  return (__uint128_t(x) * y) % p;
+}
+
+inline word shoup_quotient(word w, word p, int shift = 64)
+{
+  return (__uint128_t(w) << shift) / p;
+}
+
+// in [0, 2p) for any y
+inline word shoup_mul(word y, word w, word quotient, word p)
+{
+  word q = (__uint128_t(quotient) * y) >> 64;
+  return w * y - q * p;
+}
+
+void NTT64::init(word p, int n, word root, word inverse_root, word inverse_n,
+    word product_scale)
+{
+  assert((n & (n - 1)) == 0);
+  this->p = p;
+  this->n = n;
+  this->product_scale = product_scale;
+
+  vector<word> powers[2];
+  word bases[] = {root, inverse_root};
+  for (int r = 0; r < 2; r++)
+    {
+      powers[r].resize(2 * n);
+      powers[r][0] = 1;
+      for (int i = 1; i < 2 * n; i++)
+        powers[r][i] = mul_mod(powers[r][i - 1], bases[r], p);
+    }
+
+  // same twiddles as FFT_Iter2() and FFT_Iter() with the square
+  for (int r = 0; r < 2; r++)
+    {
+      roots[r].resize(n - 1);
+      for (int h = 1; h < n; h *= 2)
+        for (int j = 0; j < h; j++)
+          roots[r][h - 1 + j] =
+              r ? powers[1][j * n / h] : powers[0][(2 * j + 1) * n / (2 * h)];
+    }
+
+  scale.resize(n);
+  for (int i = 0; i < n; i++)
+    scale[i] = mul_mod(inverse_n, powers[1][i], p);
+
+  scale_quotients.resize(n);
+  for (int i = 0; i < n; i++)
+    scale_quotients[i] = shoup_quotient(scale[i], p);
+
+  for (int r = 0; r < 2; r++)
+    {
+      quotients[r].resize(n - 1);
+      for (int i = 0; i < n - 1; i++)
+        quotients[r][i] = shoup_quotient(roots[r][i], p);
+
+#if defined(__AVX512IFMA__) && defined(__AVX512F__)
+      if (p < (1ul << 50))
+        {
+          ifma_quotients[r].resize(n - 1);
+          for (int i = 0; i < n - 1; i++)
+            ifma_quotients[r][i] = shoup_quotient(roots[r][i], p, 52);
+        }
+#endif
+    }
+
+#ifdef USE_HEXL
+  init_hexl(root);
+#endif
+}
+
+#ifdef USE_HEXL
+void NTT64::init_hexl(word root)
+{
+  hexl = {};
+  if (n < 16)
+    return;
+
+  auto ntt = make_shared<intel::hexl::NTT>(n, p, root);
+
+  // match outputs by evaluation point, which is the transform of X
+  vector<word> x(n);
+  x[1] = 1;
+  auto y = x;
+  forward(y);
+  map<word, int> positions;
+  for (int i = 0; i < n; i++)
+    positions[y[i]] = i;
+  ntt->ComputeForward(x.data(), x.data(), 1, 1);
+  hexl_order.resize(n);
+  for (int i = 0; i < n; i++)
+    {
+      auto it = positions.find(x[i]);
+      if (it == positions.end())
+        {
+          cerr << "HEXL transform mismatch, using native NTT" << endl;
+          return;
+        }
+      hexl_order[i] = it->second;
+    }
+
+  // compare with native implementation
+  SeededPRNG G;
+  vector<word> input(n);
+  for (auto& value : input)
+    value = G.get_word() % p;
+  vector<word> results[2][2];
+  for (int i = 0; i < 2; i++)
+    {
+      hexl = i ? ntt : nullptr;
+      results[i][0] = results[i][1] = input;
+      forward(results[i][0]);
+      inverse(results[i][1]);
+    }
+  if (results[0][0] != results[1][0] or results[0][1] != results[1][1])
+    {
+      cerr << "HEXL transform mismatch, using native NTT" << endl;
+      hexl = {};
+    }
+}
+#endif
+
+bool NTT64::fast_mul() const
+{
+#ifdef USE_HEXL
+  return bool(hexl);
+#else
+  return false;
+#endif
+}
+
+void NTT64::transform(vector<word>& a, int inverse) const
+{
+  assert(a.size() == size_t(n));
+
+  // bit reversal as in FFT_Iter()
+  for (int i = 0, j = 0; i < n; ++i)
+    {
+      if (j >= i)
+        swap(a[i], a[j]);
+      int m = n / 2;
+      while ((m >= 1) && (j >= m))
+        {
+          j -= m;
+          m /= 2;
+        }
+      j += m;
+    }
+
+  // values in [0, 4p) between layers
+  word two_p = 2 * p;
+  for (int h = 1; h < n; h *= 2)
+    {
+      const word* w = &roots[inverse][h - 1];
+      const word* wq = &quotients[inverse][h - 1];
+
+#if defined(__AVX512IFMA__) && defined(__AVX512F__)
+      if (h >= 8 and not ifma_quotients[inverse].empty())
+        {
+          const word* wq52 = &ifma_quotients[inverse][h - 1];
+          __m512i vp = _mm512_set1_epi64(p);
+          __m512i v2p = _mm512_set1_epi64(two_p);
+          __m512i mask = _mm512_set1_epi64((1ul << 52) - 1);
+          __m512i zero = _mm512_setzero_si512();
+          for (int k = 0; k < n; k += 2 * h)
+            for (int j = 0; j < h; j += 8)
+              {
+                word* x = &a[k + j];
+                word* y = x + h;
+                __m512i u = _mm512_loadu_si512(x);
+                __m512i v = _mm512_loadu_si512(y);
+                u = _mm512_min_epu64(u, _mm512_sub_epi64(u, v2p));
+                __m512i q = _mm512_madd52hi_epu64(zero, v,
+                    _mm512_loadu_si512(wq52 + j));
+                __m512i t = _mm512_sub_epi64(
+                    _mm512_madd52lo_epu64(zero, v, _mm512_loadu_si512(w + j)),
+                    _mm512_madd52lo_epu64(zero, q, vp));
+                t = _mm512_and_si512(t, mask);
+                _mm512_storeu_si512(x, _mm512_add_epi64(u, t));
+                _mm512_storeu_si512(y,
+                    _mm512_add_epi64(_mm512_sub_epi64(u, t), v2p));
+              }
+          continue;
+        }
+#endif
+
+      for (int k = 0; k < n; k += 2 * h)
+        for (int j = 0; j < h; j++)
+          {
+            word& x = a[k + j];
+            word& y = a[k + j + h];
+            word u = x >= two_p ? x - two_p : x;
+            word t = shoup_mul(y, w[j], wq[j], p);
+            x = u + t;
+            y = u - t + two_p;
+          }
+    }
+}
+
+void NTT64::forward(vector<word>& a) const
+{
+#ifdef USE_HEXL
+  if (hexl)
+    {
+      static thread_local vector<word> b;
+      b.resize(n);
+      hexl->ComputeForward(b.data(), a.data(), 1, 1);
+      for (int i = 0; i < n; i++)
+        a[hexl_order[i]] = b[i];
+      return;
+    }
+#endif
+
+  transform(a, 0);
+  for (auto& x : a)
+    {
+      x = x >= 2 * p ? x - 2 * p : x;
+      x = x >= p ? x - p : x;
+    }
+}
+
+void NTT64::inverse(vector<word>& a) const
+{
+#ifdef USE_HEXL
+  if (hexl)
+    {
+      static thread_local vector<word> b;
+      b.resize(n);
+      for (int i = 0; i < n; i++)
+        b[i] = a[hexl_order[i]];
+      hexl->ComputeInverse(a.data(), b.data(), 1, 1);
+      return;
+    }
+#endif
+
+  transform(a, 1);
+  for (int i = 0; i < n; i++)
+    {
+      word x = shoup_mul(a[i], scale[i], scale_quotients[i], p);
+      a[i] = x >= p ? x - p : x;
+    }
+}
+
+void NTT64::forward(vector<modp>& a) const
+{
+  CODE_LOCATION
+  assert(a.size() == size_t(n));
+  // scratch per thread
+  static thread_local vector<word> b;
+  b.resize(n);
+  for (int i = 0; i < n; i++)
+    b[i] = a[i].get_limb(0);
+  forward(b);
+  for (int i = 0; i < n; i++)
+    a[i].assign(&b[i], 1);
+}
+
+void NTT64::inverse(vector<modp>& a) const
+{
+  CODE_LOCATION
+  assert(a.size() == size_t(n));
+  // scratch per thread
+  static thread_local vector<word> b;
+  b.resize(n);
+  for (int i = 0; i < n; i++)
+    b[i] = a[i].get_limb(0);
+  inverse(b);
+  for (int i = 0; i < n; i++)
+    a[i].assign(&b[i], 1);
+}
+
+void NTT64::mul(vector<modp>& res, const vector<modp>& a,
+    const vector<modp>& b) const
+{
+  assert(a.size() == size_t(n));
+  assert(b.size() == size_t(n));
+  // scratch per thread
+  static thread_local vector<word> x, y;
+  x.resize(n);
+  y.resize(n);
+  for (int i = 0; i < n; i++)
+    {
+      x[i] = a[i].get_limb(0);
+      y[i] = b[i].get_limb(0);
+    }
+
+#ifdef USE_HEXL
+  if (hexl)
+    {
+      intel::hexl::EltwiseMultMod(x.data(), x.data(), y.data(), n, p, 1);
+      if (product_scale != 1)
+        intel::hexl::EltwiseFMAMod(x.data(), x.data(), product_scale,
+            nullptr, n, p, 1);
+    }
+  else
+#endif
+    for (int i = 0; i < n; i++)
+      x[i] = mul_mod(mul_mod(x[i], y[i], p), product_scale, p);
+
+  res.resize(n);
+  for (int i = 0; i < n; i++)
+    res[i].assign(&x[i], 1);
+}
@@ -0,0 +1,80 @@
+/*
+ * NTT64.h
+ *
+ */
+
+#ifndef FHE_NTT64_H_
+#define FHE_NTT64_H_
+
+#include <vector>
+using namespace std;
+
+#include "Math/modp.h"
+
+#ifdef USE_HEXL
+#include <memory>
+namespace intel { namespace hexl { class NTT; } }
+#endif
+
+/*
+ * Negacyclic transform for single-limb primes below 2^62 using
+ * precomputed Shoup quotients and lazy reduction (Harvey). The output
+ * is the same as FFT_Iter2() and the inverse in Ring_Element::change_rep(),
+ * also on Montgomery representations because the transform is linear.
+ * With USE_HEXL, the transforms and products use Intel HEXL after
+ * checking that it produces the same output.
+ */
+class NTT64
+{
+  word p;
+  int n;
+
+  // twiddles for half size h at offset h - 1 and Shoup quotients
+  vector<word> roots[2], quotients[2];
+  // inverse of n times powers of inverse root
+  vector<word> scale, scale_quotients;
+
+  // quotients for 52-bit multiplication (primes below 2^50)
+  vector<word> ifma_quotients[2];
+
+  // inverse of Montgomery factor or one
+  word product_scale;
+
+#ifdef USE_HEXL
+  // HEXL transform and position of its outputs in our order
+  shared_ptr<intel::hexl::NTT> hexl;
+  vector<int> hexl_order;
+
+  void init_hexl(word root);
+#endif
+
+  void transform(vector<word>& a, int inverse) const;
+
+  // fully reduced
+  void forward(vector<word>& a) const;
+  void inverse(vector<word>& a) const;
+
+  public:
+  static bool suitable(const Zp_Data& PrD);
+
+  NTT64() : p(0), n(0), product_scale(1) {}
+
+  // root is a primitive 2n-th root of unity, all in normal representation,
+  // and product_scale corrects products (inverse of R for Montgomery)
+  void init(word p, int n, word root, word inverse_root, word inverse_n,
+      word product_scale = 1);
+
+  bool active() const { return n > 0; }
+
+  // whether mul() is faster than modp arithmetic
+  bool fast_mul() const;
+
+  void forward(vector<modp>& a) const;
+  void inverse(vector<modp>& a) const;
+
+  // entry-wise product in evaluation representation
+  void mul(vector<modp>& res, const vector<modp>& a,
+      const vector<modp>& b) const;
+};
+
+#endif /* FHE_NTT64_H_ */
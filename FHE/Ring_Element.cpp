@@ -46,17 +46,44 @@ void Ring_Element::prepare_push()
 {
   element.clear();
   assert(FFTD);
-  element.reserve(FFTD->phi_m());
+  CoefficientPool::reserve(element, FFTD->phi_m());
 }
 
 
 void Ring_Element::allocate()
 {
   assert(FFTD);
+  CoefficientPool::reserve(element, FFTD->phi_m());
   element.resize(FFTD->phi_m());
 }
 
 
+Ring_Element& Ring_Element::operator=(const Ring_Element& other)
+{
+  if (this != &other)
+    {
+      rep = other.rep;
+      FFTD = other.FFTD;
+      CoefficientPool::reserve(element, other.element.size());
+      element = other.element;
+    }
+  return *this;
+}
+
+
+Ring_Element& Ring_Element::operator=(Ring_Element&& other)
+{
+  if (this != &other)
+    {
+      rep = other.rep;
+      FFTD = other.FFTD;
+      CoefficientPool::release(element);
+      element = move(other.element);
+    }
+  return *this;
+}
+
+
 void Ring_Element::assign_zero()
 {
   element.clear();
@@ -177,6 +204,12 @@ void mul(Ring_Element& ans,const Ring_Element& a,const Ring_Element& b)
           ans *= a;
           return;
         }
+      if (a.FFTD->get_ntt().fast_mul())
+        {
+          ans.partial_assign(a);
+          a.FFTD->get_ntt().mul(ans.element, a.element, b.element);
+          return;
+        }
       ans.prepare(a);
       for (int i=0; i<(*ans.FFTD).phi_m(); i++)
         ans.element.push_back(a.element[i].mul(b.element[i], a.FFTD->get_prD()));
@@ -208,26 +241,12 @@ void mul(Ring_Element& ans,const Ring_Element& a,const Ring_Element& b)
        { ans.element[i]=aa[i]; }
     }
   else if ((*a.FFTD).get_twop()==0)
-    { // m a power of two case
-      Ring_Element aa(*ans.FFTD,ans.rep);
-      aa.partial_assign(a);
-      modp temp;
-      cerr << "slow polynomial multiplication "
-              "(change representation to change this)..." << endl;
-      for (int i=0; i<(*ans.FFTD).phi_m(); i++)
-        { for (int j=0; j<(*ans.FFTD).phi_m(); j++)
-            { Mul(temp,a.element[i],b.element[j],(*a.FFTD).get_prD());
-              int k=i+j;
-              if (k>=(*ans.FFTD).phi_m())
-                 { k-=(*ans.FFTD).phi_m();
-                   Negate(temp,temp,(*a.FFTD).get_prD());
-                 }
-              Add(aa.element[k],aa.element[k],temp,(*a.FFTD).get_prD());
-            }
-          cerr << "\r" << i << "/" << ans.FFTD->phi_m();
-        }
-      cerr << endl;
-      ans=aa;
+    { // m a power of two case, negacyclic convolution via evaluation
+      Ring_Element aa = a, bb = b;
+      aa.change_rep(evaluation);
+      bb.change_rep(evaluation);
+      mul(ans, aa, bb);
+      ans.change_rep(polynomial);
     }
   else
     { throw not_implemented(); }
@@ -282,8 +301,11 @@ Ring_Element& Ring_Element::operator *=(const Ring_Element& other)
   assert(FFTD == other.FFTD);
   assert(rep == other.rep);
   assert(rep == evaluation);
-  for (size_t i = 0; i < element.size(); i++)
-    element[i] = element[i].mul(other.element[i], FFTD->get_prD());
+  if (FFTD->get_ntt().fast_mul())
+    FFTD->get_ntt().mul(element, element, other.element);
+  else
+    for (size_t i = 0; i < element.size(); i++)
+      element[i] = element[i].mul(other.element[i], FFTD->get_prD());
   return *this;
 }
 
@@ -385,7 +407,10 @@ void Ring_Element::change_rep(RepType r)
     { rep=evaluation;
       if ((*FFTD).get_twop()==0)
         { // m a power of two variant
-          FFT_Iter2(element,(*FFTD).phi_m(),(*FFTD).get_roots(),(*FFTD).get_prD());
+          if ((*FFTD).get_ntt().active())
+            (*FFTD).get_ntt().forward(element);
+          else
+            FFT_Iter2(element,(*FFTD).phi_m(),(*FFTD).get_roots(),(*FFTD).get_prD());
 	}
       else
         { // Non m power of two variant and FFT enabled
@@ -396,6 +421,11 @@ void Ring_Element::change_rep(RepType r)
     { rep=polynomial;
       if ((*FFTD).get_twop()==0)
 	{ // m a power of two variant
+          if ((*FFTD).get_ntt().active())
+            {
+              (*FFTD).get_ntt().inverse(element);
+              return;
+            }
           modp root2;
           Sqr(root2,(*FFTD).get_root(1),(*FFTD).get_prD());
           FFT_Iter(element, (*FFTD).phi_m(),root2,(*FFTD).get_prD());
@@ -408,7 +438,7 @@ void Ring_Element::change_rep(RepType r)
         }
       else
         { // Non power of 2 m variant and FFT enabled
-          vector<modp> fft((*FFTD).m());
+          PooledBuffer fft((*FFTD).m());
           for (int i=0; i<(*FFTD).m(); i++) 
             { assignZero(fft[i],(*FFTD).get_prD()); }
           for (int i=0; i<(*FFTD).phi_m(); i++) 
@@ -15,6 +15,7 @@
 enum RepType { polynomial, evaluation };
 
 #include "FHE/FFT_Data.h"
+#include "FHE/CoefficientPool.h"
 #include "Tools/octetStream.h"
 #include "Tools/random.h"
 #include <FHE/Generator.h>
@@ -39,6 +40,7 @@ class Ring_Element
 
   /* In either representation we hold the element as an array of
    * modp's of length Ring.phi_m()
+   *   - The storage is returned to CoefficientPool on destruction
    */
 
   vector<modp> element; 
@@ -53,7 +55,7 @@ class Ring_Element
   void partial_assign(const Ring_Element& e)
     { rep=e.rep; FFTD=e.FFTD; 
       if (FFTD)
-        element.resize((*FFTD).phi_m());
+        allocate();
     }
 
   void prepare(const Ring_Element& e);
@@ -70,12 +72,21 @@ class Ring_Element
 
   Ring_Element(const FFT_Data& prd,RepType r=polynomial);
 
+  Ring_Element(const Ring_Element& other) : rep(other.rep), FFTD(other.FFTD)
+    { *this = other; }
+  Ring_Element(Ring_Element&& other) = default;
+  ~Ring_Element() { CoefficientPool::release(element); }
+
+  Ring_Element& operator=(const Ring_Element& other);
+  Ring_Element& operator=(Ring_Element&& other);
+
   template<class T>
   Ring_Element(const FFT_Data& prd, RepType r, const vector<T>& other)
     {
       assert(size_t(prd.num_slots()) == other.size());
       FFTD = &prd;
       rep = r;
+      CoefficientPool::reserve(element, other.size());
       for (auto& x : other)
         element.push_back({x, FFTD->get_prD()});
     }
@@ -214,7 +214,7 @@ void Rq_Element::Scale(const bigint& p)
 	  //for some reason we scale but we have just one level
 	  throw level_mismatch();
   }
-  bigint p0=a[0].get_prime(),p1=a[1].get_prime(),p1i,lambda,n=p1*p;
+  bigint p1=a[1].get_prime(),p1i,n=p1*p;
   invMod(p1i,p1%p,p);
 
   // First multiply input by [p1]_p
@@ -226,37 +226,76 @@ void Rq_Element::Scale(const bigint& p)
   to_modp(tep,te,a[1].get_prD());
   mul(a[1],a[1],tep);
 
-  // Now compute delta
-  Ring_Element b0(a[0].get_FFTD(),evaluation);
-  Ring_Element b1(a[1].get_FFTD(),evaluation);
-  // scope to ensure deconstruction of write iterators
+  // Now compute delta modulo p0 (a[1] is dropped anyway)
+  // with limbs instead of bigint per coefficient
+  const Zp_Data& prD0 = a[0].get_prD();
+  int t0 = prD0.get_t(), t1 = a[1].get_prD().get_t();
+  int tp = mpz_size(p.get_mpz_t());
+  assert(tp <= t0 and t1 <= MAX_MOD_SZ);
+  vector<mp_limb_t> p_limbs(tp), p1i_limbs(tp), p1_limbs(t1), half_n(tp + t1);
+  mpz_export(p_limbs.data(), 0, -1, sizeof(mp_limb_t), 0, 0, p.get_mpz_t());
+  mpz_export(p1i_limbs.data(), 0, -1, sizeof(mp_limb_t), 0, 0, p1i.get_mpz_t());
+  mpz_export(p1_limbs.data(), 0, -1, sizeof(mp_limb_t), 0, 0, p1.get_mpz_t());
+  bigint hn = n / 2;
+  mpz_export(half_n.data(), 0, -1, sizeof(mp_limb_t), 0, 0, hn.get_mpz_t());
+  modp p1_0, n_0;
+  to_modp(p1_0, p1, prD0);
+  to_modp(n_0, n, prD0);
+
+  Ring_Element b0(a[0].get_FFTD(),polynomial);
+  b0.allocate();
   {
     auto poly_a1 = a[1];
     poly_a1.change_rep(polynomial);
-    auto it = poly_a1.get_iterator();
-    auto it0 = b0.get_write_iterator();
-    auto it1 = b1.get_write_iterator();
-    bigint half_n = n / 2;
-    bigint delta;
+    bigint delta_big;
+    mp_limb_t delta[MAX_MOD_SZ], r[MAX_MOD_SZ], k[MAX_MOD_SZ],
+        q[2 * MAX_MOD_SZ + 1], prod[2 * MAX_MOD_SZ + 1];
     for (int i=0; i < a[1].get_FFTD().phi_m(); i++)
       {
-        it.get(delta);
-        lambda = delta;
-        lambda *= p1i;
-        lambda %= p;
-        lambda *= p1;
-        lambda -= delta;
-        lambda %= n;
-        if (lambda > half_n)
-          lambda -= n;
-        it0.get(lambda);
-        it1.get(lambda);
+        to_bigint(delta_big, poly_a1.element[i], poly_a1.get_prD(), false);
+        inline_mpn_copyi(delta, delta_big.get_mpz_t()->_mp_d, t1);
+
+        // k = delta * p1^-1 mod p
+        if (t1 >= tp)
+          mpn_tdiv_qr(q, r, 0, delta, t1, p_limbs.data(), tp);
+        else
+          {
+            inline_mpn_zero(r, tp);
+            inline_mpn_copyi(r, delta, t1);
+          }
+        mpn_mul_n(prod, r, p1i_limbs.data(), tp);
+        mpn_tdiv_qr(q, k, 0, prod, 2 * tp, p_limbs.data(), tp);
+
+        // lambda = k * p1 - delta, centered if above n/2
+        if (t1 >= tp)
+          mpn_mul(prod, p1_limbs.data(), t1, k, tp);
+        else
+          mpn_mul(prod, k, tp, p1_limbs.data(), t1);
+        bool centered = false;
+        if (mpn_sub(prod, prod, tp + t1, delta, t1) == 0)
+          centered = mpn_cmp(prod, half_n.data(), tp + t1) > 0;
+
+        // lambda mod p0
+        modp& res = b0.element[i];
+        modp tmp;
+        res.convert(k, tp, prD0);
+        Mul(res, res, p1_0, prD0);
+        if (t1 > t0)
+          {
+            mpn_tdiv_qr(q, r, 0, delta, t1, prD0.get_prA(), t0);
+            tmp.convert(r, t0, prD0);
+          }
+        else
+          tmp.convert(delta, t1, prD0);
+        Sub(res, res, tmp, prD0);
+        if (centered)
+          Sub(res, res, n_0, prD0);
       }
   }
 
   // Now add delta back onto a0
-  Rq_Element bb(b0,b1);
-  ::add(*this,*this,bb);
+  b0.change_rep(a[0].rep);
+  add(a[0], a[0], b0);
 
   // Now divide by p1 mod p0
   modp p1_inv,pp;
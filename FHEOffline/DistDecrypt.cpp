@@ -36,6 +36,22 @@ public:
 
 template<class FD>
 Plaintext_<FD>& DistDecrypt<FD>::run(const Ciphertext& ctx, bool NewCiphertext)
+{
+  assert(pending.empty());
+  start(ctx, NewCiphertext);
+  return finish();
+}
+
+template<class FD>
+bool DistDecrypt<FD>::pipelined() const
+{
+  // same communication as without pipelining
+  return P.is_full_duplex()
+      and (OnlineOptions::singleton.direct or P.num_players() == 2);
+}
+
+template<class FD>
+void DistDecrypt<FD>::start(const Ciphertext& ctx, bool NewCiphertext)
 {
   CODE_LOCATION
   const FHE_Params& params=ctx.get_params();
@@ -48,7 +64,53 @@ Plaintext_<FD>& DistDecrypt<FD>::run(const Ciphertext& ctx, bool NewCiphertext)
   if ((int)vv.size() != params.phi_m())
     throw length_error("wrong length of ring element");
 
-  if (OnlineOptions::singleton.direct)
+  // reuse buffers of finished exchanges
+  if (spare.empty())
+    spare.push_back({});
+  pending.splice(pending.end(), spare, spare.begin());
+  auto& exchange = pending.back();
+  swap(exchange.shares, vv);
+
+  if (pipelined())
+    {
+      exchange.to_send.reset_write_head();
+      for (auto& x : exchange.shares)
+        exchange.to_send.store(x);
+      exchange.received.resize(P.num_players());
+      for (int i = 0; i < P.num_players(); i++)
+        if (i != P.my_num())
+          {
+            P.request_send(i, exchange.to_send);
+            P.request_receive(i, exchange.received[i]);
+          }
+    }
+}
+
+template<class FD>
+Plaintext_<FD>& DistDecrypt<FD>::finish()
+{
+  CODE_LOCATION
+  assert(not pending.empty());
+  const FHE_Params& params = pk.get_params();
+  auto& exchange = pending.front();
+  auto& vv = exchange.shares;
+
+  if (pipelined())
+    {
+      vv1.resize(params.phi_m());
+      for (int i = 0; i < P.num_players(); i++)
+        if (i != P.my_num())
+          {
+            P.wait_receive(i, exchange.received[i]);
+            for (int j = 0; j < params.phi_m(); j++)
+              exchange.received[i].get(vv1[j]);
+            share.dist_decrypt_2(vv, vv1);
+          }
+      for (int i = 0; i < P.num_players(); i++)
+        if (i != P.my_num())
+          P.wait_send(i, exchange.to_send);
+    }
+  else if (OnlineOptions::singleton.direct)
     {
       // Now pack into an octetStream for broadcasting
       vector<octetStream> os(P.num_players());
@@ -81,6 +143,7 @@ Plaintext_<FD>& DistDecrypt<FD>::run(const Ciphertext& ctx, bool NewCiphertext)
   // Now get the final message
   bigint mod=params.p0();
   mf.set_poly_mod(vv,mod);
+  spare.splice(spare.end(), pending, pending.begin());
   return mf;
 }
 
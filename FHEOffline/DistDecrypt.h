@@ -10,9 +10,22 @@
 #include "Networking/Player.h"
 #include "FHEOffline/Reshare.h"
 
+#include <list>
+
 template<class FD>
 class DistDecrypt
 {
+  // shares of a decryption in flight
+  class Exchange
+  {
+  public:
+    AddableVector<bigint> shares;
+    octetStream to_send;
+    vector<octetStream> received;
+  };
+
+  list<Exchange> pending, spare;
+
 protected:
   const Player& P;
   const FHE_SK& share;
@@ -29,11 +42,28 @@ public:
   Plaintext_<FD>& run(const Ciphertext& ctx, bool NewCiphertext = false);
   virtual void intermediate_step() {}
 
+  // whether the shares are exchanged in the background after start()
+  bool pipelined() const;
+
+  // split run() for overlapping, finish() completes the oldest start()
+  void start(const Ciphertext& ctx, bool NewCiphertext = false);
+  Plaintext_<FD>& finish();
+
   virtual void reshare(Plaintext<typename FD::T, FD, typename FD::S>& m,
       const Ciphertext& cm,
       EncCommitBase<typename FD::T, FD, typename FD::S>& EC)
   { Ciphertext dummy(pk.get_params()); Reshare(m, dummy, cm, false, P, EC, pk, *this); }
 
+  // several at once, which allows pipelining
+  virtual void reshare(const vector<Plaintext_<FD>*>& ms,
+      const vector<const Ciphertext*>& cms,
+      EncCommitBase<typename FD::T, FD, typename FD::S>& EC)
+  {
+    assert(ms.size() == cms.size());
+    for (size_t i = 0; i < ms.size(); i++)
+      reshare(*ms[i], *cms[i], EC);
+  }
+
   size_t report_size(ReportType type)
   { return vv.report_size(type) + vv1.report_size(type) + mf.report_size(type) + f.report_size(type); }
 };
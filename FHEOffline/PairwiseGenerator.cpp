@@ -192,6 +192,7 @@ void PairwiseGenerator<FD>::report_size(ReportType type, MemoryUsage& res)
     res.add("serialized cleartexts", cleartexts.get_max_length());
     res.add("generator volatile", volatile_memory);
     res.add("b mod p", b_mod_q.report_size(type));
+    res.update("ring element pool", CoefficientPool::peak());
     res += EC.memory_usage;
 }
 
@@ -12,9 +12,40 @@
 #include "SimpleEncCommit.h"
 #include "SimpleMachine.h"
 #include "Tools/mkpath.h"
+#include "Processor/OnlineOptions.h"
+#include "Processor/PrepBase.h"
 
 #include "Protocols/Share.hpp"
 
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+
+map<string, int> PrepPipe::fds;
+mutex PrepPipe::lock;
+
+bool PrepPipe::active()
+{
+    return OnlineOptions::singleton.file_prep_per_thread;
+}
+
+void PrepPipe::hold(const string& filename)
+{
+    lock_guard<mutex> guard(lock);
+    if (fds.count(filename))
+        return;
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) == 0 and not S_ISFIFO(buf.st_mode))
+        remove(filename.c_str());
+    if (mkfifo(filename.c_str(), 0600) != 0 and errno != EEXIST)
+        throw file_error("cannot create named pipe " + filename);
+    // does not block until the consumer opens the pipe
+    int fd = open(filename.c_str(), O_RDWR);
+    if (fd < 0)
+        throw file_error(filename);
+    fds[filename] = fd;
+}
+
 template<class FD>
 Producer<FD>::Producer(int output_thread, bool write_output) :
     n_slots(0), output_thread(output_thread), write_output(write_output),
@@ -139,9 +170,7 @@ void TripleProducer<T, FD, S>::run(const Player& P, const FHE_PK& pk,
 
   // Step h
   timers["Decrypting"].start();
-  dd.reshare(gam_ai,cgam_a,EC);
-  dd.reshare(gam_bi,cgam_b,EC);
-  dd.reshare(gam_ci,cgam_c,EC);
+  dd.reshare({&gam_ai, &gam_bi, &gam_ci}, {&cgam_a, &cgam_b, &cgam_c}, EC);
   timers["Decrypting"].stop();
 
   reset();
@@ -156,7 +185,9 @@ string prep_filename(string data_type, int my_num, int thread_num,
     if (initial)
         file << "Initial-";
     file << data_type << "-" << file_completion<T>() << "-P" << my_num;
-    if (thread_num)
+    if (PrepPipe::active())
+        file << PrepBase::get_suffix(thread_num);
+    else if (thread_num)
         file << "-" << thread_num;
     return file.str();
 }
@@ -168,6 +199,8 @@ string open_prep_file(ofstream& outf, string data_type, int my_num, int thread_n
     if (mkdir_p(dir.c_str()) == -1)
         throw runtime_error("cannot create directory " + dir);
     string file = prep_filename<T>(data_type, my_num, thread_num, initial, dir);
+    if (PrepPipe::active())
+        PrepPipe::hold(file);
     outf.open(file.c_str(),ios::out | ios::binary | (clear ? ios::trunc : ios::app));
     if (clear)
         file_signature<Share<T>>().output(outf);
@@ -175,6 +208,22 @@ string open_prep_file(ofstream& outf, string data_type, int my_num, int thread_n
     return file;
 }
 
+template <class T>
+void write_prep_file(stringstream& data, string data_type, const Player& P,
+    MAC_Check<T>& MC, int thread_num, bool clear, string dir)
+{
+    // consumer could use data before the check otherwise
+    if (PrepPipe::active())
+        MC.Check(P);
+    ofstream outf;
+    string file = open_prep_file<T>(outf, data_type, P.my_num(), thread_num,
+        false, clear, dir);
+    auto buffer = data.str();
+    outf.write(buffer.data(), buffer.size());
+    outf.close();
+    if (outf.fail()) { throw file_error(file); }
+}
+
 template<class FD>
 string Producer<FD>::open_file(ofstream& outf, int my_num, int thread_num,
     bool initial, bool clear)
@@ -339,9 +388,7 @@ void TupleProducer<FD>::compute_macs(const FHE_PK& pk, const Ciphertext& calpha,
     mul(cgam_b,calpha,cb,pk);
 
     // Step h
-    Ciphertext dummy(params);
-    dd.reshare(macs[0], cgam_a, EC);
-    dd.reshare(macs[1], cgam_b, EC);
+    dd.reshare({&macs[0], &macs[1]}, {&cgam_a, &cgam_b}, EC);
 
     i = 0;
 }
@@ -407,9 +454,7 @@ void gfpBitProducer::run(const Player& P, const FHE_PK& pk,
     mul(cgam_v, calpha, cv, pk);
 
     // Step i
-    Ciphertext dummy(params);
-    dd.reshare(vi, cv, EC);
-    dd.reshare(gam_vi, cgam_v, EC);
+    dd.reshare({&vi, &gam_vi}, {&cv, &cgam_v}, EC);
 
     // Step j and k
     Share<gfp> a;
@@ -517,7 +562,12 @@ InputProducer<FD>::InputProducer(const Player& P, int thread_num,
             stringstream file;
             file << dir << "Inputs-" << file_completion<T>() << "-P"
                     << P.my_num() << "-" << j;
-            if (thread_num)
+            if (PrepPipe::active())
+            {
+                file << PrepBase::get_suffix(thread_num);
+                PrepPipe::hold(file.str());
+            }
+            else if (thread_num)
                 file << "-" << thread_num;
             outf[j].open(file.str().c_str(), ios::out | ios::binary);
             file_signature<Share<T>>().output(outf[j]);
@@ -605,14 +655,11 @@ void InputProducer<FD>::run(const Player& P, const FHE_PK& pk,
             auto& ca = C.at(i);
             auto& a = m.at(i);
 
-            // Reshare the aj values
-            dd.reshare(ai, ca, EC);
-
             // Generate encrypted MAC values
             mul(gama, calpha, ca, pk);
 
-            // Get shares on the MACs
-            dd.reshare(gai, gama, EC);
+            // Reshare the aj values and the MACs
+            dd.reshare({&ai, &gai}, {&ca, &gama}, EC);
 
             for (unsigned int i = 0; i < ai.num_slots(); i++)
             {
@@ -693,3 +740,10 @@ template string open_prep_file<gfp>(ofstream& outf, string data_type,
         int my_num, int thread_num, bool initial, bool clear, string dir);
 template string open_prep_file<gf2n_short>(ofstream& outf, string data_type,
         int my_num, int thread_num, bool initial, bool clear, string dir);
+
+template void write_prep_file<gfp>(stringstream& data, string data_type,
+        const Player& P, MAC_Check<gfp>& MC, int thread_num, bool clear,
+        string dir);
+template void write_prep_file<gf2n_short>(stringstream& data,
+        string data_type, const Player& P, MAC_Check<gf2n_short>& MC,
+        int thread_num, bool clear, string dir);
@@ -14,12 +14,33 @@
 #include "Protocols/Share.h"
 #include "Math/Setup.h"
 
+#include <mutex>
+
 template <class T>
 string prep_filename(string type, int my_num, int thread_num,
     bool initial, string dir = PREP_DIR);
 template <class T>
 string open_prep_file(ofstream& outf, string type, int my_num, int thread_num,
     bool initial, bool clear, string dir = PREP_DIR);
+// append checked data, after the MAC check when streaming
+template <class T>
+void write_prep_file(stringstream& data, string type, const Player& P,
+    MAC_Check<T>& MC, int thread_num, bool clear, string dir = PREP_DIR);
+
+/*
+ * Named pipes for streaming to virtual machines run with -f.
+ * They stay open for reading and writing, so closing a file after
+ * every batch does not end the stream at the consumer.
+ */
+class PrepPipe
+{
+  static map<string, int> fds;
+  static mutex lock;
+
+public:
+  static bool active();
+  static void hold(const string& filename);
+};
 
 template <class FD>
 class Producer
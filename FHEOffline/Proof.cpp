@@ -7,6 +7,7 @@
 #include "FHE/P2Data.h"
 #include "FHEOffline/EncCommit.h"
 #include "Math/Z2k.hpp"
+#include "Processor/OnlineOptions.h"
 
 double Proof::dist = 0;
 
@@ -33,6 +34,12 @@ bigint Proof::slack(int slack, int sec, int phim)
   }
 }
 
+int Proof::get_n_threads()
+{
+  return max(1,
+      stoi(OnlineOptions::singleton.option_value("proof_threads", "1")));
+}
+
 void Proof::set_challenge(const octetStream& ciphertexts)
 {
   octetStream hash = ciphertexts.hash();
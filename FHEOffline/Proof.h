@@ -3,6 +3,7 @@
 
 #include <math.h>
 #include <vector>
+#include <thread>
 using namespace std;
 
 #include "Math/bigint.h"
@@ -69,6 +70,9 @@ class Proof
   vector<vector<int>> W;
   bool top_gear;
 
+  // commitments processed in parallel (-o proof_threads)
+  int n_threads;
+
   static double dist;
 
   protected:
@@ -78,7 +82,8 @@ class Proof
     Proof(int sc, const bigint& Tau, const bigint& Rho, const FHE_PK& pk,
             int n_proofs = 1, bool diagonal = false) :
               diagonal(diagonal),
-              B_plain_length(0), B_rand_length(0), pk(&pk), n_proofs(n_proofs)
+              B_plain_length(0), B_rand_length(0), pk(&pk), n_proofs(n_proofs),
+              n_threads(get_n_threads())
     { sec=sc;
       assert(sec > 0);
       tau=Tau; rho=Rho;
@@ -111,6 +116,8 @@ class Proof
   public:
   static bigint slack(int slack, int sec, int phim);
 
+  static int get_n_threads();
+
   bool use_top_gear(const FHE_PK& pk)
   {
     return CowGearOptions::singleton.top_gear() and pk.p() > 2 and
@@ -134,6 +141,20 @@ class Proof
 
   bool check_bounds(T& z, X& t, int i) const;
 
+  // run job(i, slot) for i in [begin, min(begin + n_threads, end))
+  template<class T>
+  int run_batch(int begin, int end, const T& job) const
+  {
+    int n = min(n_threads, end - begin);
+    vector<thread> threads;
+    for (int i = 1; i < n; i++)
+      threads.push_back(thread(job, begin + i, i));
+    job(begin, 0);
+    for (auto& thread : threads)
+      thread.join();
+    return n;
+  }
+
   template<class T, class U>
   void apply_challenge(int i, T& output, const U& input, const FHE_PK& pk) const
   {
@@ -42,24 +42,32 @@ void Prover<FD,U>::Stage_1(const Proof& P, octetStream& ciphertexts,
 //  ZZX rd;
 //  ZZ pr=(*AE.A).prime();
 //  ZZ bd=B_plain/(pr+1);
-  PRNG G;
-  G.ReSeed();
-  Random_Coins rc(pk.get_params());
-  Ciphertext ciphertext(pk.get_params());
+  // one generator, coins, and commitment per thread
+  vector<PRNG> G(P.n_threads);
+  for (auto& prng : G)
+    prng.ReSeed();
+  vector<Random_Coins> rc(P.n_threads, pk.get_params());
+  vector<Ciphertext> ciphertext(P.n_threads, pk.get_params());
   ciphertexts.store(V);
-  for (int i=0; i<V; i++)
+  for (int start=0; start<V; )
     {
+      int n = P.run_batch(start, V, [&](int i, int j)
+        {
 //      AE.randomize(Diag,binary);
 //      rd=RandPoly(phim,bd<<1);
 //      y[i]=AE.plaintext()+pr*rd;
-      y[i].randomize(G, P.B_plain_length, P.get_diagonal());
-      if (P.get_diagonal())
-        assert(y[i].is_diagonal());
-      s[i].resize(3, P.phim);
-      s[i].generateUniform(G, P.B_rand_length);
-      rc.assign(s[i][0], s[i][1], s[i][2]);
-      pk.encrypt(ciphertext,y[i],rc);
-      ciphertext.pack(ciphertexts);
+          y[i].randomize(G[j], P.B_plain_length, P.get_diagonal());
+          if (P.get_diagonal())
+            assert(y[i].is_diagonal());
+          s[i].resize(3, P.phim);
+          s[i].generateUniform(G[j], P.B_rand_length);
+          rc[j].assign(s[i][0], s[i][1], s[i][2]);
+          pk.encrypt(ciphertext[j],y[i],rc[j]);
+        });
+      // keep order in stream
+      for (int j = 0; j < n; j++)
+        ciphertext[j].pack(ciphertexts);
+      start += n;
     }
 }
 
@@ -75,29 +83,50 @@ bool Prover<FD,U>::Stage_2(Proof& P, octetStream& cleartexts,
   cleartexts.resize_precise(allocate);
   cleartexts.reset_write_head();
 
-  unsigned int i;
-#ifndef LESS_ALLOC_MORE_MEM
-  AddableVector<fixint<gfp::N_LIMBS>> z;
-  AddableMatrix<fixint<gfp::N_LIMBS>> t;
+  // responses per thread
+#ifdef LESS_ALLOC_MORE_MEM
+  vector<AddableVector<typename Proof::bound_type>> zs(P.n_threads, z);
+  vector<AddableMatrix<Int_Random_Coins::value_type::value_type>> ts(
+      P.n_threads, t);
+#else
+  vector<AddableVector<fixint<gfp::N_LIMBS>>> zs(P.n_threads);
+  vector<AddableMatrix<fixint<gfp::N_LIMBS>>> ts(P.n_threads);
 #endif
+  vector<char> in_bounds(P.n_threads);
   cleartexts.reset_write_head();
   cleartexts.store(P.V);
   if (P.get_diagonal())
     for (auto& xx : x)
       assert(xx.is_diagonal());
-  for (i=0; i<P.V; i++)
-    { z=y[i];
-      t=s[i];
-      P.apply_challenge(i, z, x, pk);
-      Check_Decoding(z, P.get_diagonal(), x[0].get_field());
-      P.apply_challenge(i, t, r, pk);
-      if (not P.check_bounds(z, t, i))
-          return false;
-      z.pack(cleartexts);
-      t.pack(cleartexts);
+  // conversion before concurrent access
+  for (auto& xx : x)
+    xx.get_poly();
+  for (unsigned start=0; start<P.V; )
+    {
+      int n = P.run_batch(start, P.V, [&](int i, int j)
+        {
+          auto& z = zs[j];
+          auto& t = ts[j];
+          z=y[i];
+          t=s[i];
+          P.apply_challenge(i, z, x, pk);
+          Check_Decoding(z, P.get_diagonal(), x[0].get_field());
+          P.apply_challenge(i, t, r, pk);
+          in_bounds[j] = P.check_bounds(z, t, i);
+        });
+      for (int j = 0; j < n; j++)
+        {
+          if (not in_bounds[j])
+            return false;
+          zs[j].pack(cleartexts);
+          ts[j].pack(cleartexts);
+        }
+      start += n;
    }
 #ifndef LESS_ALLOC_MORE_MEM
-  volatile_memory = t.report_size(CAPACITY) + z.report_size(CAPACITY);
+  volatile_memory = 0;
+  for (int j = 0; j < P.n_threads; j++)
+    volatile_memory += ts[j].report_size(CAPACITY) + zs[j].report_size(CAPACITY);
 #endif
 #ifdef PRINT_MIN_DIST
   cout << "Minimal distance (log) " << log2(P.dist) << ", compare to " <<
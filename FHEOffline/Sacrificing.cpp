@@ -24,10 +24,7 @@ void Triple_Checking(const Player& P, MAC_Check<T>& MC, int nm,
   CODE_LOCATION
   check_field_size<T>();
 
-  ofstream outf;
-  if (write_output)
-    open_prep_file<T>(outf, "Triples", P.my_num(), output_thread, false,
-        clear, dir);
+  stringstream outf;
 
   T te,t;
   Create_Random(t,P);
@@ -100,7 +97,7 @@ void Triple_Checking(const Player& P, MAC_Check<T>& MC, int nm,
     }
 
   if (write_output)
-    outf.close();
+    write_prep_file<T>(outf, "Triples", P, MC, output_thread, clear, dir);
 }
 
 
@@ -111,10 +108,7 @@ void Inverse_Checking(const Player& P, MAC_Check<T>& MC, int nr,
     bool clear, string dir)
 {
   CODE_LOCATION
-  ofstream outf_inv;
-  if (write_output)
-    open_prep_file<T>(outf_inv, "Inverses", P.my_num(), output_thread, false,
-        clear, dir);
+  stringstream outf_inv;
 
   T te,t;
   Create_Random(t,P);
@@ -174,9 +168,8 @@ void Inverse_Checking(const Player& P, MAC_Check<T>& MC, int nr,
     }
 
   if (write_output)
-    {
-      outf_inv.close();
-    }
+    write_prep_file<T>(outf_inv, "Inverses", P, MC, output_thread, clear,
+        dir);
 }
 
 
@@ -186,11 +179,7 @@ void Square_Checking(const Player& P, MAC_Check<T>& MC, int ns,
         bool write_output, bool clear, string dir)
 {
   CODE_LOCATION
-  ofstream outf_s, outf_b;
-  if (write_output)
-  {
-    open_prep_file<T>(outf_s, "Squares", P.my_num(), output_thread, false, clear, dir);
-  }
+  stringstream outf_s;
 
   T te,t,t2;
   Create_Random(t,P);
@@ -245,7 +234,8 @@ void Square_Checking(const Player& P, MAC_Check<T>& MC, int ns,
         }
       left_todo-=this_loop;
     }
-  outf_s.close(); 
+  if (write_output)
+    write_prep_file<T>(outf_s, "Squares", P, MC, output_thread, clear, dir);
 }
 
 void Bit_Checking(const Player& P, MAC_Check<gfp>& MC, int nb,
@@ -255,10 +245,7 @@ void Bit_Checking(const Player& P, MAC_Check<gfp>& MC, int nb,
 {
   CODE_LOCATION
   gfp dummy;
-  ofstream outf_b;
-  if (write_output)
-    open_prep_file<gfp>(outf_b, "Bits", P.my_num(), output_thread, false, clear,
-        dir);
+  stringstream outf_b;
 
   gfp te,t,t2;
   Create_Random(t,P);
@@ -311,7 +298,8 @@ void Bit_Checking(const Player& P, MAC_Check<gfp>& MC, int nb,
 
       left_todo-=this_loop;
     }
-  outf_b.close();
+  if (write_output)
+    write_prep_file<gfp>(outf_b, "Bits", P, MC, output_thread, clear, dir);
 }
 
 
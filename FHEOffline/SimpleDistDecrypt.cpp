@@ -41,6 +41,36 @@ Plaintext_<FD> SimpleDistDecrypt<FD>::reshare(const Ciphertext& cm)
     return m;
 }
 
+template <class FD>
+void SimpleDistDecrypt<FD>::reshare(const vector<Plaintext_<FD>*>& ms,
+        const vector<const Ciphertext*>& cms,
+        EncCommitBase<typename FD::T, FD, typename FD::S>&)
+{
+    assert(ms.size() == cms.size());
+    PRNG G;
+    G.ReSeed();
+
+    // compute the share of the next while the previous is in flight
+    for (size_t i = 0; i <= ms.size(); i++)
+    {
+        if (i < ms.size())
+        {
+            auto& m = *ms[i];
+            m.randomize(G, Full);
+            this->f = m;
+            this->start(*cms[i]);
+        }
+
+        if (i > 0)
+        {
+            auto& m = *ms[i - 1];
+            auto& mf = this->finish();
+            m.negate();
+            if (this->P.my_num() == 0)
+                add(m, m, mf);
+        }
+    }
+}
 
 template class SimpleDistDecrypt<FFT_Data>;
 template class SimpleDistDecrypt<P2Data>;
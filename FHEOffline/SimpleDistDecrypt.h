@@ -21,6 +21,9 @@ public:
         const Ciphertext& cm,
         EncCommitBase<typename FD::T, FD, typename FD::S>& EC);
     Plaintext_<FD> reshare(const Ciphertext& cm);
+    void reshare(const vector<Plaintext_<FD>*>& ms,
+            const vector<const Ciphertext*>& cms,
+            EncCommitBase<typename FD::T, FD, typename FD::S>& EC);
 };
 
 #endif /* FHEOFFLINE_SIMPLEDISTDECRYPT_H_ */
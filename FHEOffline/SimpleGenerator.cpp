@@ -90,6 +90,7 @@ void SimpleGenerator<T,FD>::report_size(ReportType type, MemoryUsage& res)
     res.add("producer", producer->report_size(type));
     res.add("generator volatile", volatile_memory);
     res.add("distributed decryption", dd.report_size(type));
+    res.update("ring element pool", CoefficientPool::peak());
 }
 
 template class SimpleGenerator<SimpleEncCommit_, FFT_Data>;
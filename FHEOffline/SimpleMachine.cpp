@@ -12,6 +12,7 @@
 #include "Tools/ezOptionParser.h"
 #include "Protocols/MAC_Check.h"
 #include "Protocols/fake-stuff.h"
+#include "Processor/OnlineOptions.h"
 
 #include "Protocols/fake-stuff.hpp"
 #include "Protocols/mac_key.hpp"
@@ -87,6 +88,16 @@ void MachineBase::parse_options(int argc, const char** argv)
           "-2", // Flag token.
           "--gf2n" // Flag token.
     );
+    opt.add(
+          "", // Default.
+          0, // Required?
+          0, // Number of args expected.
+          0, // Delimiter if expecting multiple args.
+          "Stream results through named pipes to virtual machines run with -f "
+          "(implies -o)", // Help description.
+          "-st", // Flag token.
+          "--stream" // Flag token.
+    );
 
     OfflineMachineBase::parse_options(argc, argv);
     opt.get("-h")->getString(hostname);
@@ -94,6 +105,11 @@ void MachineBase::parse_options(int argc, const char** argv)
     opt.get("-s")->getInt(sec);
     opt.get("-f")->getInt(field_size);
     use_gf2n = opt.isSet("-2");
+    if (opt.isSet("-st"))
+    {
+        output = true;
+        OnlineOptions::singleton.file_prep_per_thread = true;
+    }
     if (use_gf2n)
     {
         cout << "Using GF(2^40)" << endl;
@@ -67,45 +67,83 @@ void Verifier<FD>::Stage_2(
                           octetStream& cleartexts,
                           const FHE_PK& pk)
 {
-  unsigned int i, V;
+  unsigned int V;
 
   c.unpack(ciphertexts, pk);
   if (c.size() != P.U)
     throw length_error("number of received ciphertexts incorrect");
 
   // Now check the encryptions are correct
-  Ciphertext d1(pk.get_params()), d2(pk.get_params());
-  Random_Coins rc(pk.get_params());
   ciphertexts.get(V);
   if (V != P.V)
     throw length_error("number of received commitments incorrect");
   cleartexts.get(V);
   if (V != P.V)
     throw length_error("number of received cleartexts incorrect");
-  for (i=0; i<V; i++)
+
+  // a batch of responses and commitments per thread
+  int n_threads = P.n_threads;
+  vector<Ciphertext> d1(n_threads, pk.get_params()),
+      d2(n_threads, pk.get_params());
+  vector<Random_Coins> rc(n_threads, pk.get_params());
+  vector<int> failure(n_threads);
+  zs.resize(n_threads - 1, z);
+  ts.resize(n_threads - 1, t);
+
+  for (unsigned start = 0; start < V; )
     {
-      z.unpack(cleartexts);
-      t.unpack(cleartexts);
-      if (!P.check_bounds(z, t, i))
-        throw runtime_error("preimage out of bounds");
-      d1.unpack(ciphertexts);
-      P.apply_challenge(i, d1, c, pk);
-      rc.assign(t[0], t[1], t[2]);
-      pk.encrypt(d2,z,rc);
-      if (!(d1 == d2))
+      int n = min(n_threads, int(V - start));
+      for (int j = 0; j < n; j++)
+        {
+          auto& z = j ? zs[j - 1] : this->z;
+          auto& t = j ? ts[j - 1] : this->t;
+          z.unpack(cleartexts);
+          t.unpack(cleartexts);
+          d1[j].unpack(ciphertexts);
+        }
+
+      P.run_batch(start, V, [&](int i, int j)
         {
+          auto& z = j ? zs[j - 1] : this->z;
+          auto& t = j ? ts[j - 1] : this->t;
+          failure[j] = 0;
+          if (!P.check_bounds(z, t, i))
+            {
+              failure[j] = 1;
+              return;
+            }
+          P.apply_challenge(i, d1[j], c, pk);
+          rc[j].assign(t[0], t[1], t[2]);
+          pk.encrypt(d2[j],z,rc[j]);
+          if (!(d1[j] == d2[j]))
+            {
 #ifdef VERBOSE
-          cout << "Fail Check 6 " << i << endl;
+              cout << "Fail Check 6 " << i << endl;
 #endif
-          throw runtime_error("ciphertexts don't match");
-        }
-      if (!Check_Decoding(z,P.get_diagonal(),FieldD))
-         {
+              failure[j] = 2;
+            }
+          else if (!Check_Decoding(z,P.get_diagonal(),FieldD))
+            {
 #ifdef VERBOSE
-          cout << "\tCheck : " << i << endl;
+              cout << "\tCheck : " << i << endl;
 #endif
-           throw runtime_error("cleartext isn't diagonal");
-         }
+              failure[j] = 3;
+            }
+        });
+
+      // report the first failure
+      for (int j = 0; j < n; j++)
+        switch (failure[j])
+        {
+        case 1:
+          throw runtime_error("preimage out of bounds");
+        case 2:
+          throw runtime_error("ciphertexts don't match");
+        case 3:
+          throw runtime_error("cleartext isn't diagonal");
+        }
+
+      start += n;
     }
 }
 
@@ -130,5 +168,15 @@ void Verifier<FD>::NIZKPoK(AddableVector<Ciphertext>& c,
 }
 
 
+template<class FD>
+size_t Verifier<FD>::report_size(ReportType type)
+{
+  size_t res = z.report_size(type) + t.report_size(type);
+  for (size_t i = 0; i < zs.size(); i++)
+    res += zs[i].report_size(type) + ts[i].report_size(type);
+  return res;
+}
+
+
 template class Verifier<FFT_Data>;
 template class Verifier<P2Data>;
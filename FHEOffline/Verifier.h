@@ -13,6 +13,10 @@ class Verifier
   AddableVector<typename Proof::bound_type> z;
   AddableMatrix<Int_Random_Coins::value_type::value_type> t;
 
+  // further responses for parallel verification
+  vector<AddableVector<typename Proof::bound_type>> zs;
+  vector<AddableMatrix<Int_Random_Coins::value_type::value_type>> ts;
+
   Proof& P;
   const FD& FieldD;
 
@@ -30,7 +34,7 @@ public:
   void NIZKPoK(AddableVector<Ciphertext>& c,octetStream& ciphertexts,octetStream& cleartexts,
                const FHE_PK& pk);
 
-  size_t report_size(ReportType type) { return z.report_size(type) + t.report_size(type); }
+  size_t report_size(ReportType type);
 };
 
 #endif
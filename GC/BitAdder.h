@@ -9,9 +9,28 @@
 #include <vector>
 using namespace std;
 
+/**
+ * Binary addition of many numbers in parallel, either with ripple
+ * carry (one round per bit) or with a Sklansky parallel-prefix adder
+ * (logarithmic number of rounds but more ANDs), the latter selected
+ * by ``-o bit_adder=prefix``.
+ */
 class BitAdder
 {
+    bool prefix;
+
+    template<class T>
+    void prefix_add(vector<vector<T>>& res,
+            const vector<vector<vector<T>>>& summands, size_t begin,
+            size_t end, SubProcessor<T>& proc, int length, int input_begin);
+
 public:
+    BitAdder();
+    BitAdder(bool prefix);
+
+    // number of ANDs per addition of two numbers
+    int n_ands(int n_bits);
+
     template<class T>
     void add(vector<vector<T>>& res, const vector<vector<vector<T>>>& summands,
             SubProcessor<T>& proc, int length, ThreadQueues* queues = 0,
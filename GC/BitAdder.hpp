@@ -9,9 +9,34 @@
 #include "BitAdder.h"
 
 #include "Protocols/BufferScope.h"
+#include "Processor/OnlineOptions.h"
 
 #include <assert.h>
 
+inline BitAdder::BitAdder()
+{
+    prefix = OnlineOptions::singleton.option_value("bit_adder", "ripple")
+            == "prefix";
+}
+
+inline BitAdder::BitAdder(bool prefix) :
+        prefix(prefix)
+{
+}
+
+inline int BitAdder::n_ands(int n_bits)
+{
+    if (not prefix)
+        return n_bits;
+
+    int res = n_bits;
+    for (int l = 0; (1 << l) < n_bits; l++)
+        for (int i = 0; i < n_bits; i++)
+            if ((i >> l) & 1)
+                res += 1 + ((i >> (l + 1)) > 0);
+    return res;
+}
+
 template<class T>
 void BitAdder::add(vector<vector<T>>& res, const vector<vector<vector<T>>>& summands,
         SubProcessor<T>& proc, int length, ThreadQueues* queues, int player)
@@ -33,7 +58,8 @@ void BitAdder::add(vector<vector<T>>& res, const vector<vector<vector<T>>>& summ
             if (T::expensive_triples)
             {
                 supplies[i] = &triples[i];
-                for (size_t j = 0; j < n_per_thread * summands.size(); j++)
+                for (int j = 0;
+                        j < n_per_thread * n_ands(summands.size()); j++)
                     triples[i].push_back(proc.DataF.get_triple(T::default_length));
 #ifdef VERBOSE_EDA
                 cerr << "supplied " << triples[i].size() << endl;
@@ -79,13 +105,17 @@ void BitAdder::add(vector<vector<T> >& res,
         fprintf(stderr, "got supply\n");
 #endif
         auto& s = *(vector<array<T, 3>>*) supply;
-        assert(s.size() == n_items * n_bits);
+        assert(s.size() == n_items * n_ands(n_bits));
         proc.DataF.push_triples(s);
     }
 
     if (summands[0].size() > 2)
         return multi_add(res, summands, begin, end, proc, length, input_begin);
 
+    if (prefix)
+        return prefix_add(res, summands, begin, end, proc, length,
+                input_begin);
+
     vector<T> carries(n_items);
     vector<T> a(n_items), b(n_items);
     auto& protocol = proc.protocol;
@@ -118,6 +148,77 @@ void BitAdder::add(vector<vector<T> >& res,
         res[begin + j][n_bits] = carries[j];
 }
 
+template<class T>
+void BitAdder::prefix_add(vector<vector<T> >& res,
+        const vector<vector<vector<T> > >& summands, size_t begin, size_t end,
+        SubProcessor<T>& proc, int length, int input_begin)
+{
+    int n_bits = summands.size();
+    size_t n_items = end - begin;
+
+    // generate and propagate bits of groups ending at every position
+    vector<vector<T>> G(n_bits, vector<T>(n_items)),
+            P(n_bits, vector<T>(n_items));
+    auto& protocol = proc.protocol;
+    BufferScope scope(proc.DataF, n_items * length * n_ands(n_bits));
+    protocol.init_mul();
+    for (int i = 0; i < n_bits; i++)
+    {
+        assert(summands[i].size() == 2);
+        assert(summands[i][0].size() >= input_begin + n_items);
+        assert(summands[i][1].size() >= input_begin + n_items);
+
+        for (size_t j = 0; j < n_items; j++)
+        {
+            auto& a = summands[i][0][input_begin + j];
+            auto& b = summands[i][1][input_begin + j];
+            P[i][j] = a + b;
+            res[begin + j][i] = P[i][j];
+            protocol.prepare_mul(a, b, length);
+        }
+    }
+    protocol.exchange();
+    for (int i = 0; i < n_bits; i++)
+        for (size_t j = 0; j < n_items; j++)
+            G[i][j] = protocol.finalize_mul(length);
+
+    // Sklansky: the upper half of every block of size 2^(l+1) combines
+    // with the last position of the lower half, which stays unchanged
+    for (int l = 0; (1 << l) < n_bits; l++)
+    {
+        protocol.init_mul();
+        for (int i = 0; i < n_bits; i++)
+            if ((i >> l) & 1)
+            {
+                int k = ((i >> l) << l) - 1;
+                for (size_t j = 0; j < n_items; j++)
+                {
+                    protocol.prepare_mul(P[i][j], G[k][j], length);
+                    // propagate only needed if the group doesn't start at 0
+                    if (i >> (l + 1))
+                        protocol.prepare_mul(P[i][j], P[k][j], length);
+                }
+            }
+        protocol.exchange();
+        for (int i = 0; i < n_bits; i++)
+            if ((i >> l) & 1)
+                for (size_t j = 0; j < n_items; j++)
+                {
+                    // generate and propagate are exclusive
+                    G[i][j] += protocol.finalize_mul(length);
+                    if (i >> (l + 1))
+                        P[i][j] = protocol.finalize_mul(length);
+                }
+    }
+
+    for (size_t j = 0; j < n_items; j++)
+    {
+        for (int i = 1; i < n_bits; i++)
+            res[begin + j][i] += G[i - 1][j];
+        res[begin + j][n_bits] = G[n_bits - 1][j];
+    }
+}
+
 template<class T>
 void BitAdder::multi_add(vector<vector<T> >& res,
         const vector<vector<vector<T> > >& summands, size_t begin, size_t end,
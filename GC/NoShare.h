@@ -210,6 +210,7 @@ public:
     void output(ostream&, bool) { fail(); }
 
     void pack(octetStream&) const { fail(); }
+    void unpack(octetStream&) { fail(); }
 };
 
 inline ostream& operator<<(ostream& o, NoShare)
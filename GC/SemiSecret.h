@@ -39,6 +39,7 @@ public:
     static const int default_length = sizeof(BitVec) * 8;
 
     static const bool symmetric = V::symmetric;
+    static const bool bitwise_xor = true;
 
     static bool real_shares(const Player& P)
     {
@@ -141,6 +141,7 @@ public:
     static const bool has_mac = false;
     static const bool randoms_for_opens = false;
     static const bool function_dependent = false;
+    static const bool bitwise_xor = true;
 
     static string type_string() { return "replicated secret"; }
     static string phase_name() { return "Replicated computation"; }
@@ -11,12 +11,25 @@
 #include "BitPrepFiles.h"
 #include "Math/Setup.h"
 #include "Tools/DoubleRange.h"
+#include "Tools/avx_memcpy.h"
 
 #include "Processor/Data_Files.hpp"
 
 namespace GC
 {
 
+// whether XOR of shares is XOR of their memory
+template<class T, class = void>
+struct has_bitwise_xor : false_type
+{
+};
+
+template<class T>
+struct has_bitwise_xor<T, decltype(void(T::bitwise_xor))> :
+        integral_constant<bool, T::bitwise_xor>
+{
+};
+
 template<class T>
 StandaloneShareThread<T>::StandaloneShareThread(int i, ThreadMaster<T>& master) :
         ShareThread<T>(*Preprocessing<T>::get_new(master.opts.live_prep,
@@ -315,8 +328,17 @@ void ShareThread<T>::xors(Processor<T>& processor, const vector<int>& args)
             auto out = processor.S.iterator_for_size(*it++, size);
             auto left = processor.S.iterator_for_size(*it++, size);
             auto right = processor.S.iterator_for_size(*it++, size);
-            for (int j = 0; j < size - 1; j++)
-                (*out++).xor_(T::default_length, *left++, *right++);
+            if (has_bitwise_xor<T>::value)
+            {
+                // full registers as one block of memory
+                avx_xor(&*out, &*left, &*right, (size - 1) * sizeof(T));
+                out += size - 1;
+                left += size - 1;
+                right += size - 1;
+            }
+            else
+                for (int j = 0; j < size - 1; j++)
+                    (*out++).xor_(T::default_length, *left++, *right++);
             int n_bits_left = n_bits - (size - 1) * T::default_length;
             (*out++).xor_(n_bits_left, *left++, *right++);
         }
@@ -11,6 +11,7 @@
 
 #include "Networking/CryptoPlayer.h"
 #include "Processor/Processor.h"
+#include "Tools/CpuAffinity.h"
 
 #include "Processor.hpp"
 
@@ -55,6 +56,7 @@ void Thread<T>::run()
          throw runtime_error("there can only be one");
     singleton = this;
     BaseMachine::s().thread_num = thread_num;
+    CpuAffinity::pin_compute(thread_num);
     secure_prng.ReSeed();
     string id = "T" + to_string(thread_num);
     if (machine.use_encryption)
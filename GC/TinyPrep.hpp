@@ -48,26 +48,33 @@ void TinierSharePrep<T>::buffer_secret_triples()
                     triple_generator->plainTriples[i][2]);
         triple_generator->run_multipliers({});
         assert(triple_generator->plainTriples.size() != 0);
-        for (size_t i = 0; i < triple_generator->plainTriples.size(); i++)
+        int dl = secret_type::default_length;
+        size_t base = triples.size();
+        triples.resize(base + triple_generator->plainTriples.size() * dl);
+        auto alphai = thread.MC->get_alphai();
+        sacrifice.run_parallel(triple_generator->plainTriples.size(),
+                [&](size_t begin, size_t end)
         {
-            int dl = secret_type::default_length;
-            for (int j = 0; j < dl; j++)
+            for (size_t i = begin; i < end; i++)
             {
-                triples.push_back({});
-                for (int k = 0; k < 3; k++)
+                for (int j = 0; j < dl; j++)
                 {
-                    auto& share = triples.back()[k];
-                    share.set_share(
-                            triple_generator->plainTriples.at(i).at(k).get_bit(
-                                    j));
-                    typename T::mac_type mac;
-                    mac = thread.MC->get_alphai() * share.get_share();
-                    for (auto& multiplier : triple_generator->ot_multipliers)
-                        mac += multiplier->macs.at(k).at(i * dl + j);
-                    share.set_mac(mac);
+                    auto& triple = triples[base + i * dl + j];
+                    for (int k = 0; k < 3; k++)
+                    {
+                        auto& share = triple[k];
+                        share.set_share(
+                                triple_generator->plainTriples.at(i).at(k).get_bit(
+                                        j));
+                        typename T::mac_type mac;
+                        mac = alphai * share.get_share();
+                        for (auto& multiplier : triple_generator->ot_multipliers)
+                            mac += multiplier->macs.at(k).at(i * dl + j);
+                        share.set_mac(mac);
+                    }
                 }
             }
-        }
+        }, 64);
     }
     sacrifice.triple_sacrifice(triples, triples,
             *thread.P, thread.MC->get_part_MC());
@@ -87,6 +87,8 @@
     X(DABIT, Proc.dabit(INST)) \
     X(EDABIT, Proc.edabit(INST)) \
     X(SEDABIT, Proc.edabit(INST, true)) \
+    X(A2B, Proc.a2b(INST)) \
+    X(B2A, Proc.b2a(INST)) \
     X(SPLIT, Proc.split(INST)) \
     X(UNSPLIT, Proc.unsplit(INST)) \
     X(CALL_ARG, ) \
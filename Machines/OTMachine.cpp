@@ -75,9 +75,9 @@ OTMachine::OTMachine(int argc, const char** argv)
     opt.add(
         "1024",
         0,
-        1,
-        0,
-        "Number of extended OTs to run (default: 1024).",
+        -1,
+        ',',
+        "Number of extended OTs to run (default: 1024). Separate by comma for several runs.",
         "-n",
         "--nOTs"
     );
@@ -104,9 +104,9 @@ OTMachine::OTMachine(int argc, const char** argv)
     opt.add(
         "1",
         0,
-        1,
-        0,
-        "Number of threads (default: 1).",
+        -1,
+        ',',
+        "Number of threads (default: 1). Separate by comma for several runs.",
         "-x",
         "--nthreads"
     );
@@ -141,6 +141,36 @@ OTMachine::OTMachine(int argc, const char** argv)
         "--passive" // Flag token.
     );
 
+    opt.add(
+        "", // Default.
+        0, // Required?
+        -1, // Number of args expected.
+        ',', // Delimiter if expecting multiple args.
+        "Security for several runs, a (active) or p (passive) separated by comma (default: a or p with -pas).", // Help description.
+        "-sec", // Flag token.
+        "--security" // Flag token.
+    );
+
+    opt.add(
+        "2", // Default.
+        0, // Required?
+        -1, // Number of args expected.
+        ',', // Delimiter if expecting multiple args.
+        "SoftSpokenOT parameter (default: 2). Separate by comma for several runs.", // Help description.
+        "-k", // Flag token.
+        "--softspoken" // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Append one line of CSV per run to file.", // Help description.
+        "-csv", // Flag token.
+        "--csv" // Flag token.
+    );
+
     opt.add(
         "", // Default.
         0, // Required?
@@ -164,18 +194,33 @@ OTMachine::OTMachine(int argc, const char** argv)
     opt.parse(argc, argv);
 
     string hostname, ot_mode, usage;
-    passive = false;
     opt.get("-p")->getInt(my_num);
     opt.get("-pn")->getInt(portnum_base);
     opt.get("-h")->getString(hostname);
-    opt.get("-n")->getLong(nOTs);
+    opt.get("-n")->getLongs(nOTs);
     opt.get("-m")->getString(ot_mode);
-    opt.get("--nthreads")->getInt(nthreads);
+    opt.get("--nthreads")->getInts(nthreads);
     opt.get("--nloops")->getInt(nloops);
     opt.get("--nsubloops")->getInt(nsubloops);
     opt.get("--nbase")->getInt(nbase);
-    if (opt.isSet("-pas"))
-        passive = true;
+    opt.get("--softspoken")->getInts(softspoken_k);
+    opt.get("--csv")->getString(csv_file);
+
+    if (opt.isSet("--security"))
+    {
+        vector<string> security;
+        opt.get("--security")->getStrings(security);
+        for (auto& x : security)
+            if (x == "a" or x == "p")
+                passive.push_back(x == "p");
+            else
+            {
+                cerr << "Invalid security argument: " << x << endl;
+                exit(1);
+            }
+    }
+    else
+        passive.push_back(opt.isSet("-pas"));
 
     if (!opt.isSet("-p"))
     {
@@ -185,12 +230,8 @@ OTMachine::OTMachine(int argc, const char** argv)
     }
 
     cout << "Player 0 host name = " << hostname << endl;
-    cout << "Creating " << nOTs << " extended OTs in " << nthreads << " threads\n";
     cout << "Running in mode " << ot_mode << endl;
 
-    if (passive)
-        cout << "Running with PASSIVE security only\n";
-
     if (nbase < 128)
         cout << "WARNING: only using " << nbase << " seed OTs, using these for OT extensions is insecure.\n";
 
@@ -271,15 +312,64 @@ OTMachine::OTMachine(int argc, const char** argv)
 
 OTMachine::~OTMachine()
 {
+    for (auto player : players)
+        delete player;
     for (auto names : N)
         delete names;
     delete bot_;
     delete P;
 }
 
-
 void OTMachine::run()
 {
+    ofstream csv;
+    if (not csv_file.empty())
+    {
+        ifstream existing(csv_file);
+        bool header = existing.peek() == ifstream::traits_type::eof();
+        csv.open(csv_file, ios::app);
+        if (header)
+            csv << "role,security,softspoken,threads,OTs,seconds,"
+                    << "OTs per second,bytes per OT,CPU ns per OT" << endl;
+    }
+
+    // all combinations in the same order at both parties
+    for (bool pas : passive)
+        for (int k : softspoken_k)
+            for (int n_threads : nthreads)
+                for (long n : nOTs)
+                {
+                    size_t sent = 0;
+                    for (auto player : players)
+                        sent -= player->total_sent();
+                    Timer timer, cpu_timer(CLOCK_PROCESS_CPUTIME_ID);
+                    timer.start();
+                    cpu_timer.start();
+                    long total = run(n, n_threads, k, pas);
+                    double time = timer.elapsed(), cpu = cpu_timer.elapsed();
+                    for (auto player : players)
+                        sent += player->total_sent();
+
+                    cout << "OT extension with " << total << " OTs in "
+                            << n_threads << " threads: " << total / time
+                            << " OTs per second, " << double(sent) / total
+                            << " bytes per OT" << endl;
+                    if (csv.is_open())
+                        csv << role_to_str(ot_role) << ","
+                                << (pas ? "passive" : "active") << "," << k
+                                << "," << n_threads << "," << total << ","
+                                << time << "," << total / time << ","
+                                << double(sent) / total << ","
+                                << cpu * 1e9 / total << endl;
+                }
+}
+
+long OTMachine::run(long nOTs, int nthreads, int softspoken_k, bool passive)
+{
+    cout << "Creating " << nOTs << " extended OTs in " << nthreads << " threads\n";
+    if (passive)
+        cout << "Running with PASSIVE security only\n";
+
     // divide nOTs between threads and loops
     nOTs = DIV_CEIL(nOTs, nthreads * nloops);
     // round up to multiple of base OTs and subloops
@@ -304,7 +394,6 @@ void OTMachine::run()
     vector<BitVector> base_receiver_input_copy(nthreads);
     vector<vector< array<BitVector, 2> > > base_sender_inputs_copy(nthreads, vector<array<BitVector, 2> >(nbase));
     vector< vector<BitVector> > base_receiver_outputs_copy(nthreads, vector<BitVector>(nbase));
-    vector<TwoPartyPlayer*> players(nthreads);
 
     for (int i = 0; i < nthreads; i++)
     {
@@ -317,10 +406,12 @@ void OTMachine::run()
             base_sender_inputs_copy[i][j][1].assign(bot.sender_inputs[j][1]);
             base_receiver_outputs_copy[i][j].assign(bot.receiver_outputs[j]);
         }
-        // now setup resources for each thread
+        // now setup resources for each thread, reused in later runs
         // round robin with the names
-        players[i] = new RealTwoPartyPlayer(*N[i % N.size()], 1 - my_num,
-                "thread" + to_string(i));
+        if (players.size() <= size_t(i))
+            players.push_back(
+                    new RealTwoPartyPlayer(*N[i % N.size()], 1 - my_num,
+                            "thread" + to_string(i)));
         tinfos[i].thread_num = i+1;
         tinfos[i].other_player_num = 1 - my_num;
         tinfos[i].nOTs = nOTs;
@@ -329,6 +420,7 @@ void OTMachine::run()
                 ot_role,
                 passive,
                 nsubloops);
+        tinfos[i].ot_ext->set_softspoken(softspoken_k);
         tinfos[i].ot_ext->init(base_receiver_input_copy[i],
                 base_sender_inputs_copy[i], base_receiver_outputs_copy[i]);
         tinfos[i].nloops = nloops;
@@ -392,8 +484,7 @@ void OTMachine::run()
     }
 
     for (int i = 0; i < nthreads; i++)
-    {
-        delete players[i];
         delete tinfos[i].ot_ext;
-    }
+
+    return nOTs * nthreads * nloops;
 }
@@ -8,6 +8,7 @@
 
 #include "OT/OTExtension.h"
 #include "Tools/ezOptionParser.h"
+#include "Networking/Player.h"
 
 class OTMachine
 {
@@ -15,17 +16,23 @@ class OTMachine
     OT_ROLE ot_role;
 
 public:
-    int my_num, portnum_base, nthreads, nloops, nsubloops, nbase;
-    long nOTs;
-    bool passive;
+    int my_num, portnum_base, nloops, nsubloops, nbase;
+    // parameters to sweep, same order at both parties
+    vector<long> nOTs;
+    vector<int> nthreads, softspoken_k;
+    vector<bool> passive;
+    string csv_file;
     TwoPartyPlayer* P;
     BitVector baseReceiverInput;
     BaseOT* bot_;
     vector<Names*> N;
+    vector<VirtualTwoPartyPlayer*> players;
 
     OTMachine(int argc, const char** argv);
     ~OTMachine();
     void run();
+    // returns number of OTs generated
+    long run(long nOTs, int nthreads, int softspoken_k, bool passive);
 };
 
 #endif /* OT_OTMACHINE_H_ */
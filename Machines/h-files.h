@@ -374,4 +374,5 @@
 #include "Yao/YaoGate.h"
 #include "Yao/YaoHalfGate.h"
 #include "Yao/YaoPlayer.h"
+#include "Yao/YaoThreeHalvesGate.h"
 #include "Yao/YaoWire.h"
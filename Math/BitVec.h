@@ -82,8 +82,8 @@ public:
     {
         if (n == -1)
             pack(os);
-        else if (n < 8)
-            os.store_bits(this->a, n);
+        else if (n % 8)
+            os.store_packed_bits(this->a, n);
         else
             os.store_int(super::mask(n).get(), DIV_CEIL(n, 8));
     }
@@ -92,8 +92,8 @@ public:
     {
         if (n == -1)
             unpack(os);
-        else if (n < 8)
-            this->a = os.get_bits(n);
+        else if (n % 8)
+            this->a = os.get_packed_bits(n);
         else
             this->a = os.get_int(DIV_CEIL(n, 8));
     }
@@ -108,6 +108,12 @@ public:
 
 typedef BitVec_<long> BitVec;
 
+// for PRNG::fill()
+constexpr bool flat_random(const BitVec_<long>*)
+{
+    return true;
+}
+
 template<class T>
 const false_type BitVec_<T>::invertible;
 template<class T>
@@ -6,6 +6,7 @@
 #include "Tools/mkpath.h"
 
 #include <fstream>
+#include <unistd.h>
 
 #include "Math/gfp.hpp"
 
@@ -78,6 +79,49 @@ bigint generate_prime(int lgp, int m, bool force_degree)
   return p;
 }
 
+static string prime_cache_filename(int lgp, int m)
+{
+  return PREP_DIR "Prime-" + to_string(lgp) + "-" + to_string(m);
+}
+
+/*
+ * The search is deterministic for given length and degree,
+ * so the result can be reused by later runs after a sanity check.
+ */
+static bool read_cached_prime(bigint& p, int lgp, int m)
+{
+  ifstream file(prime_cache_filename(lgp, m));
+  file >> p;
+  if (file.fail())
+    return false;
+  if (numBits(p) < lgp or p % m != 1 or not probPrime(p))
+    {
+      cerr << "Ignoring invalid prime in " << prime_cache_filename(lgp, m)
+          << endl;
+      return false;
+    }
+#ifdef VERBOSE
+  cerr << "Using prime from " << prime_cache_filename(lgp, m) << endl;
+#endif
+  return true;
+}
+
+static void write_cached_prime(const bigint& p, int lgp, int m)
+{
+  // best effort, failing only means searching again next time
+  if (mkdir_p(PREP_DIR) < 0)
+    return;
+  string filename = prime_cache_filename(lgp, m);
+  string tmp = filename + "." + to_string(getpid());
+  ofstream file(tmp);
+  file << p << endl;
+  file.close();
+  if (file.good())
+    rename(tmp.c_str(), filename.c_str());
+  else
+    remove(tmp.c_str());
+}
+
 void generate_prime(bigint& p, int lgp, int m, bool force_degree)
 {
   if (OnlineOptions::singleton.prime > 0)
@@ -103,6 +147,9 @@ void generate_prime(bigint& p, int lgp, int m, bool force_degree)
   if (not force_degree)
     m = max(m, default_m(lgp, idx));
 
+  if (read_cached_prime(p, lgp, m))
+    return;
+
   bigint u;
   int ex;
   ex = lgp - numBits(m);
@@ -122,6 +169,32 @@ void generate_prime(bigint& p, int lgp, int m, bool force_degree)
   cerr << "\t p = " << p << "  u = " << u << "  :   ";
   cerr << lgp << " <= " << numBits(p) << endl;
 #endif
+
+  write_cached_prime(p, lgp, m);
+}
+
+
+bigint generate_special_prime(int lgp, int m)
+{
+  if (lgp % 64 != 0)
+    throw runtime_error("special primes need a multiple of 64 bits");
+  if (m < 1)
+    throw runtime_error("invalid modulus for special prime");
+
+  // 2^lgp - c = 1 mod m
+  bigint top = bigint(1) << lgp;
+  bigint c = (top - 1) % m;
+  if (c == 0)
+    c = m;
+  while (c < (1u << 31))
+    {
+      bigint p = top - c;
+      if (probPrime(p))
+        return p;
+      c += m;
+    }
+
+  throw runtime_error("no special prime found");
 }
 
 
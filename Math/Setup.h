@@ -35,6 +35,8 @@ bigint SPDZ_Data_Setup_Primes(int lgp);
 void SPDZ_Data_Setup_Primes(bigint& p,int lgp,int& idx,int& m);
 void generate_prime(bigint& p, int lgp, int m, bool force_degree = false);
 bigint generate_prime(int lgp, int m, bool force_degree = false);
+// 2^lgp - c for small c with lgp a multiple of 64 and p = 1 mod m
+bigint generate_special_prime(int lgp, int m = 1);
 int default_m(int& lgp, int& idx);
 
 string get_prep_sub_dir(const string& prep_dir, int nparties, int log2mod,
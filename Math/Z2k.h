@@ -135,7 +135,7 @@ public:
 	template <int L>
 	Z2<(K > L) ? K : L> operator*(const Z2<L>& other) const;
 
-	Z2<K> operator*(bool other) const { return other ? *this : Z2<K>(); }
+	Z2<K> operator*(bool other) const;
 	Z2<K> operator*(int other) const { return *this * Z2<K>(other); }
 
 	Z2<K> operator/(const Z2& other) const { (void) other; throw division_by_zero(); }
@@ -214,6 +214,20 @@ public:
 	friend ostream& operator<<(ostream& o, const Z2<J>& x);
 };
 
+// for octetStream::store_range()
+template<int K>
+constexpr bool flat_packing(const Z2<K>*)
+{
+	return true;
+}
+
+// for PRNG::fill()
+template<int K>
+constexpr bool flat_random(const Z2<K>*)
+{
+	return K % 64 == 0;
+}
+
 /**
  * Type for values in the ring defined by the integers modulo ``2^K``
  * representing `[-2^(K-1), 2^(K-1)-1]`.
@@ -346,6 +360,17 @@ Z2<K> Z2<K>::operator-(const Z2<K>& other) const
 	return res;
 }
 
+template <int K>
+inline Z2<K> Z2<K>::operator*(bool other) const
+{
+	// no branch on secret bits
+	Z2<K> res;
+	mp_limb_t mask = -mp_limb_t(other);
+	for (int i = 0; i < N_WORDS; i++)
+		res.a[i] = a[i] & mask;
+	return res;
+}
+
 template <int K>
 inline Z2<K>& Z2<K>::operator+=(const Z2<K>& other)
 {
@@ -394,7 +419,19 @@ template <int L, int M, bool LAZY>
 inline Z2<K> Z2<K>::Mul(const Z2<L>& x, const Z2<M>& y)
 {
 	Z2<K> res;
-	mpn_mul_fixed_<N_WORDS, Z2<L>::N_WORDS, Z2<M>::N_WORDS>(res.a, x.a, y.a);
+	if constexpr (N_WORDS == 2)
+	{
+		// lower two words suffice
+		__uint128_t xx = x.a[0], yy = y.a[0];
+		if constexpr (Z2<L>::N_WORDS > 1)
+			memcpy(&xx, x.a, sizeof(xx));
+		if constexpr (Z2<M>::N_WORDS > 1)
+			memcpy(&yy, y.a, sizeof(yy));
+		xx *= yy;
+		memcpy(res.a, &xx, sizeof(xx));
+	}
+	else
+		mpn_mul_fixed_<N_WORDS, Z2<L>::N_WORDS, Z2<M>::N_WORDS>(res.a, x.a, y.a);
 	if (not LAZY)
 		res.normalize();
 	return res;
@@ -16,7 +16,7 @@ void Zp_Data::init(const bigint& p,bool mont)
       if (mont != montgomery)
         cerr << "Changing Montgomery" << endl;
 #endif
-      if (pr != p or mont != montgomery)
+      if (pr != p or (mont != montgomery and special == 0))
         throw runtime_error("Zp_Data instance already initialized");
     }
 
@@ -31,10 +31,18 @@ void Zp_Data::init(const bigint& p,bool mont)
   int k = pr_bit_length;
   overhang = (uint64_t(-1LL) >> (63 - (k - 1) % 64));
 
-  montgomery=mont;
   t=mpz_size(pr.get_mpz_t());
   if (t>MAX_MOD_SZ)
     throw max_mod_sz_too_small(t);
+
+  // faster reduction without Montgomery representation
+  bigint c = (bigint(1) << (64 * t)) - pr;
+  if (c < (1u << 31))
+    special = c.get_ui();
+  else
+    special = 0;
+
+  montgomery = mont and special == 0;
   if (montgomery)
     { inline_mpn_zero(R,MAX_MOD_SZ);
       inline_mpn_zero(R2,MAX_MOD_SZ);
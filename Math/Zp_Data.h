@@ -37,6 +37,8 @@ class Zp_Data
   mp_limb_t   prA[MAX_MOD_SZ+1];
   int         t;           // More Montgomery data
   mp_limb_t   overhang;
+  // c if pr = 2^(64t) - c with small c, zero otherwise
+  mp_limb_t   special;
   Lock        lock;
   mutable bigint shanks_y, shanks_q_half;
   mutable int    shanks_r;
@@ -51,6 +53,13 @@ class Zp_Data
   void Mont_Mult_max(mp_limb_t* z, const mp_limb_t* x, const mp_limb_t* y,
       int max_t) const;
 
+  template <int T>
+  void Special_Mult_(mp_limb_t* z,const mp_limb_t* x,const mp_limb_t* y) const;
+  template <int L>
+  void Special_Mult_max(mp_limb_t* z,const mp_limb_t* x,const mp_limb_t* y) const;
+  void Special_Mult(mp_limb_t* z,const mp_limb_t* x,const mp_limb_t* y, int t) const;
+  void Special_Reduce(mp_limb_t* z,mp_limb_t* aa,int t) const;
+
   public:
 
   bigint       pr;
@@ -64,6 +73,7 @@ class Zp_Data
   int get_t() const { assert(t > 0); return t; }
   const mp_limb_t* get_prA() const { return prA; }
   bool get_mont() const { return montgomery; }
+  bool is_special() const { return special != 0; }
   mp_limb_t overhang_mask() const;
 
   void pack(octetStream& o) const;
@@ -75,6 +85,7 @@ class Zp_Data
   {
     t = -1;
     overhang = 0;
+    special = 0;
     shanks_r = 0;
   }
 
@@ -264,4 +275,64 @@ inline void Zp_Data::Mont_Mult_max(mp_limb_t* z, const mp_limb_t* x,
   Mont_Mult(z, x, y);
 }
 
+// 2t-limb aa to z, using 2^(64t) = c mod pr
+inline void Zp_Data::Special_Reduce(mp_limb_t* z,mp_limb_t* aa,int t) const
+{
+  // c is below 2^31, so the carry is at most 2^31
+  mp_limb_t carry = 0;
+  for (int i=0; i<t; i++)
+    { __uint128_t s = (__uint128_t) aa[t+i] * special + aa[i] + carry;
+      aa[i] = s;
+      carry = s >> 64;
+    }
+  __uint128_t s = (__uint128_t) carry * special;
+  for (int i=0; i<t; i++)
+    { s += aa[i];
+      aa[i] = s;
+      s >>= 64;
+    }
+  // after wrapping around, the value is below 2^63
+  if (s)
+    aa[0] += special;
+  // below 2^(64t) < 2*pr
+  if (mpn_cmp(aa,prA,t)>=0)
+    mpn_sub_n(z,aa,prA,t);
+  else
+    inline_mpn_copyi(z,aa,t);
+}
+
+inline void Zp_Data::Special_Mult(mp_limb_t* z,const mp_limb_t* x,const mp_limb_t* y, int t) const
+{
+  mp_limb_t aa[2*MAX_MOD_SZ];
+  for (int i=0; i<t; i++)
+    { mp_limb_t carry = 0;
+      for (int j=0; j<t; j++)
+        { __uint128_t s = (__uint128_t) x[i] * y[j] + carry;
+          if (i > 0)
+            s += aa[i+j];
+          aa[i+j] = s;
+          carry = s >> 64;
+        }
+      aa[i+t] = carry;
+    }
+  Special_Reduce(z, aa, t);
+}
+
+// constant size for unrolling
+template <int T>
+inline void Zp_Data::Special_Mult_(mp_limb_t* z,const mp_limb_t* x,const mp_limb_t* y) const
+{
+  Special_Mult(z, x, y, T);
+}
+
+template <int L>
+inline void Zp_Data::Special_Mult_max(mp_limb_t* z,const mp_limb_t* x,const mp_limb_t* y) const
+{
+  assert(t <= L);
+  if (t == L)
+    Special_Mult_<L>(z, x, y);
+  else
+    Special_Mult(z, x, y, t);
+}
+
 #endif
@@ -2,6 +2,7 @@
 #include "Math/gf2n.h"
 #include "Math/Bit.h"
 
+#include "Math/gf2n_vectors.h"
 #include "Tools/intrinsics.h"
 #include "Tools/Exceptions.h"
 
@@ -15,6 +16,8 @@ template<class U>
 int gf2n_<U>::l[4];
 template<class U>
 bool gf2n_<U>::useC;
+template<class U>
+bool gf2n_<U>::vectorized;
 
 word gf2n_short_table[256][256];
 
@@ -152,6 +155,11 @@ void gf2n_<U>::init_field(int nn)
 #else
   useC = true;
 #endif
+
+  // two folds suffice for the reduction
+  vectorized = not useC and gf2n_vectors::available()
+      and ((MAX_N_BITS == 64 and n > 8 and 2 * t[1] <= n)
+          or (MAX_N_BITS == 128 and n == 128));
 }
 
 
@@ -357,6 +365,48 @@ gf2n_<U>& gf2n_<U>::mul(const gf2n_& x,const gf2n_& y)
   return *this;
 }
 
+template<class U>
+void gf2n_<U>::mul(gf2n_* z, const gf2n_* x, const gf2n_* y, size_t n_elements)
+{
+  if (vectorized and n_elements >= 8)
+    {
+      // modulus without leading term
+      word r = 1;
+      for (int i = 1; i < nterms + 1; i++)
+        r ^= word(1) << t[i];
+      if (MAX_N_BITS == 64)
+        gf2n_vectors::mul64((uint64_t*) z, (const uint64_t*) x,
+            (const uint64_t*) y, n_elements, false, n, r);
+      else
+        gf2n_vectors::mul128((uint64_t*) z, (const uint64_t*) x,
+            (const uint64_t*) y, n_elements, false, r);
+    }
+  else
+    for (size_t i = 0; i < n_elements; i++)
+      z[i].mul(x[i], y[i]);
+}
+
+template<class U>
+void gf2n_<U>::mul(gf2n_* z, const gf2n_* x, const gf2n_& y, size_t n_elements)
+{
+  gf2n_ factor = y;
+  if (vectorized and n_elements >= 8)
+    {
+      word r = 1;
+      for (int i = 1; i < nterms + 1; i++)
+        r ^= word(1) << t[i];
+      if (MAX_N_BITS == 64)
+        gf2n_vectors::mul64((uint64_t*) z, (const uint64_t*) x,
+            (const uint64_t*) &factor, n_elements, true, n, r);
+      else
+        gf2n_vectors::mul128((uint64_t*) z, (const uint64_t*) x,
+            (const uint64_t*) &factor, n_elements, true, r);
+    }
+  else
+    for (size_t i = 0; i < n_elements; i++)
+      z[i].mul(x[i], factor);
+}
+
 template<class U>
 gf2n_<U> gf2n_<U>::operator*(const Bit& x) const
 {
@@ -47,6 +47,8 @@ protected:
   static U mask;
   static U uppermask, lowermask;
   static bool useC;
+  // batched multiplication with VPCLMULQDQ
+  static bool vectorized;
 
   static octet mult_table[256][256];
 
@@ -143,6 +145,10 @@ protected:
   // = x * y
   gf2n_& mul(const gf2n_& x,const gf2n_& y);
 
+  // element-wise products of arrays
+  static void mul(gf2n_* z, const gf2n_* x, const gf2n_* y, size_t n_elements);
+  static void mul(gf2n_* z, const gf2n_* x, const gf2n_& y, size_t n_elements);
+
   gf2n_ lazy_add(const gf2n_& x) const { return *this + x; }
   gf2n_ lazy_mul(const gf2n_& x) const { return *this * x; }
 
@@ -265,6 +271,32 @@ U gf2n_<U>::lowermask;
 template<class U>
 octet gf2n_<U>::mult_table[256][256];
 
+// for octetStream::store_range()
+template<class U>
+constexpr bool flat_packing(const gf2n_<U>*)
+{
+  return true;
+}
+
+// for vector_mul() in Math/ring_vectors.h
+template<class U>
+constexpr int flat_field_limbs(const gf2n_<U>*)
+{
+  return sizeof(U) / sizeof(uint64_t);
+}
+
+template<class U>
+void field_mul(gf2n_<U>* z, const gf2n_<U>* x, const gf2n_<U>* y, int n)
+{
+  gf2n_<U>::mul(z, x, y, n);
+}
+
+template<class U>
+void field_scale(gf2n_<U>* z, const gf2n_<U>* x, const gf2n_<U>& y, int n)
+{
+  gf2n_<U>::mul(z, x, y, n);
+}
+
 template<>
 inline gf2n_<octet>& gf2n_<octet>::mul(const gf2n_<octet>& x, const gf2n_<octet>& y)
 {
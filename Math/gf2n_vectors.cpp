@@ -0,0 +1,110 @@
+/*
+ * gf2n_vectors.cpp
+ *
+ */
+
+#include "gf2n_vectors.h"
+#include "Tools/cpu_support.h"
+
+#include <immintrin.h>
+#include <stdexcept>
+using namespace std;
+
+namespace gf2n_vectors
+{
+
+bool available()
+{
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+    return cpu_has_vpclmul() and cpu_has_avx512();
+#else
+    return false;
+#endif
+}
+
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+// masked variants avoid spurious warnings about undefined source
+
+// lower and upper halves of the products of all words
+inline void clmul_words(__m512i& lo, __m512i& hi, __m512i a, __m512i b)
+{
+    __m512i even = _mm512_clmulepi64_epi128(a, b, 0x00);
+    __m512i odd = _mm512_clmulepi64_epi128(a, b, 0x11);
+    lo = _mm512_maskz_unpacklo_epi64(-1, even, odd);
+    hi = _mm512_maskz_unpackhi_epi64(-1, even, odd);
+}
+#endif
+
+void mul64(uint64_t* z, const uint64_t* x, const uint64_t* y,
+        size_t n_elements, bool same_y, int n, uint64_t r)
+{
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+    const __m512i vr = _mm512_set1_epi64(r);
+    const __m512i mask = _mm512_set1_epi64(
+            n == 64 ? -1 : (uint64_t(1) << n) - 1);
+    const __m128i right = _mm_cvtsi32_si128(n), left = _mm_cvtsi32_si128(
+            64 - n);
+    __m512i factor = _mm512_set1_epi64(y[0]);
+
+    for (size_t i = 0; i < n_elements; i += 8)
+    {
+        __mmask8 m = n_elements - i >= 8 ? 0xff : (1 << (n_elements - i)) - 1;
+        __m512i a = _mm512_maskz_loadu_epi64(m, x + i);
+        __m512i b = same_y ? factor : _mm512_maskz_loadu_epi64(m, y + i);
+        __m512i lo, hi;
+        clmul_words(lo, hi, a, b);
+        __m512i res = _mm512_and_si512(lo, mask);
+        // x^n = r
+        for (int j = 0; j < 2; j++)
+        {
+            __m512i above = _mm512_or_si512(_mm512_maskz_srl_epi64(-1, lo, right),
+                    _mm512_maskz_sll_epi64(-1, hi, left));
+            clmul_words(lo, hi, above, vr);
+            res = _mm512_xor_si512(res, _mm512_and_si512(lo, mask));
+        }
+        _mm512_mask_storeu_epi64(z + i, m, res);
+    }
+#else
+    (void) z, (void) x, (void) y, (void) n_elements, (void) same_y, (void) n;
+    (void) r;
+    throw runtime_error("no VPCLMULQDQ support");
+#endif
+}
+
+void mul128(uint64_t* z, const uint64_t* x, const uint64_t* y,
+        size_t n_elements, bool same_y, uint64_t r)
+{
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+    const __m512i vr = _mm512_set1_epi64(r);
+    __m512i factor = _mm512_maskz_broadcast_i32x4(-1,
+            _mm_loadu_si128((__m128i*) y));
+
+    for (size_t i = 0; i < n_elements; i += 4)
+    {
+        __mmask8 m = n_elements - i >= 4 ? 0xff :
+                (1 << (2 * (n_elements - i))) - 1;
+        __m512i a = _mm512_maskz_loadu_epi64(m, x + 2 * i);
+        __m512i b = same_y ? factor : _mm512_maskz_loadu_epi64(m, y + 2 * i);
+        __m512i lo = _mm512_clmulepi64_epi128(a, b, 0x00);
+        __m512i hi = _mm512_clmulepi64_epi128(a, b, 0x11);
+        __m512i mid = _mm512_xor_si512(_mm512_clmulepi64_epi128(a, b, 0x01),
+                _mm512_clmulepi64_epi128(a, b, 0x10));
+        lo = _mm512_xor_si512(lo, _mm512_bslli_epi128(mid, 8));
+        hi = _mm512_xor_si512(hi, _mm512_bsrli_epi128(mid, 8));
+        // x^128 = r
+        __m512i lower = _mm512_clmulepi64_epi128(hi, vr, 0x00);
+        __m512i upper = _mm512_clmulepi64_epi128(hi, vr, 0x01);
+        lo = _mm512_xor_si512(lo,
+                _mm512_xor_si512(lower, _mm512_bslli_epi128(upper, 8)));
+        lo = _mm512_xor_si512(lo,
+                _mm512_clmulepi64_epi128(_mm512_bsrli_epi128(upper, 8), vr,
+                        0x00));
+        _mm512_mask_storeu_epi64(z + 2 * i, m, lo);
+    }
+#else
+    (void) z, (void) x, (void) y, (void) n_elements, (void) same_y, (void) r;
+    throw runtime_error("no VPCLMULQDQ support");
+#endif
+}
+
+}
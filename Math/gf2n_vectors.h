@@ -0,0 +1,45 @@
+/*
+ * gf2n_vectors.h
+ *
+ */
+
+#ifndef MATH_GF2N_VECTORS_H_
+#define MATH_GF2N_VECTORS_H_
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Element-wise multiplication of arrays in GF(2^n). With VPCLMULQDQ,
+ * the carryless products and the reduction are computed for one vector
+ * of elements at a time. The reduction folds the part above the degree
+ * twice, which requires the other terms of the modulus to be of degree
+ * at most n/2.
+ */
+namespace gf2n_vectors
+{
+
+bool available();
+
+/**
+ * Products for n up to 64 with one word per element
+ * @param z destination (``n_elements`` words)
+ * @param x first factors (``n_elements`` words)
+ * @param y second factors (``n_elements`` words or one)
+ * @param same_y use the first element of ``y`` for all products
+ * @param n degree
+ * @param r modulus without the leading term
+ */
+void mul64(uint64_t* z, const uint64_t* x, const uint64_t* y,
+        size_t n_elements, bool same_y, int n, uint64_t r);
+
+/**
+ * Products for degree 128 with two words per element
+ * @param r modulus without the leading term
+ */
+void mul128(uint64_t* z, const uint64_t* x, const uint64_t* y,
+        size_t n_elements, bool same_y, uint64_t r);
+
+}
+
+#endif /* MATH_GF2N_VECTORS_H_ */
@@ -249,6 +249,42 @@ inline void mul128(__m128i a, __m128i b, __m128i *res1, __m128i *res2)
     *res2 = tmp6;
 }
 
+/// Sum of products without reduction, four at a time with VPCLMULQDQ
+inline void add_mul128(__m128i res[2], const __m128i* a, const __m128i* b,
+        size_t n)
+{
+    size_t i = 0;
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__)
+    if (cpu_has_vpclmul() and n >= 4)
+    {
+        __m512i lo = _mm512_setzero_si512(), hi = lo, mid = lo;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m512i x = _mm512_loadu_si512(a + i);
+            __m512i y = _mm512_loadu_si512(b + i);
+            lo ^= _mm512_clmulepi64_epi128(x, y, 0x00);
+            hi ^= _mm512_clmulepi64_epi128(x, y, 0x11);
+            mid ^= _mm512_clmulepi64_epi128(x, y, 0x01)
+                    ^ _mm512_clmulepi64_epi128(x, y, 0x10);
+        }
+        __m128i sums[3] = {};
+        __m512i* parts[3] = {&lo, &mid, &hi};
+        for (int j = 0; j < 3; j++)
+            for (int k = 0; k < 4; k++)
+                sums[j] ^= ((__m128i*) parts[j])[k];
+        res[0] ^= sums[0] ^ _mm_slli_si128(sums[1], 8);
+        res[1] ^= sums[2] ^ _mm_srli_si128(sums[1], 8);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        __m128i lo, hi;
+        mul128(a[i], b[i], &lo, &hi);
+        res[0] ^= lo;
+        res[1] ^= hi;
+    }
+}
+
 inline void mul(int128 a, int128 b, int128& lo, int128& hi)
 {
     mul128(a.a, b.a, &lo.a, &hi.a);
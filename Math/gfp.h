@@ -10,6 +10,7 @@ using namespace std;
 #include "Math/field_types.h"
 #include "Math/Bit.h"
 #include "Math/Setup.h"
+#include "Math/modp_vectors.h"
 #include "Tools/random.h"
 #include "Processor/OnlineOptions.h"
 
@@ -58,6 +59,7 @@ class gfp_ : public ValueInterface
 
   modp_type a;
   static Zp_Data ZpD;
+  static MontgomeryVectors vectors;
 
   static thread_local vector<gfp_> powers;
 
@@ -139,6 +141,11 @@ class gfp_ : public ValueInterface
 
   static gfp_ Mul(gfp_ a, gfp_ b) { return a * b; }
 
+  /// Element-wise products ``z[i] = x[i] * y[i]``
+  static void mul(gfp_* z, const gfp_* x, const gfp_* y, size_t n);
+  /// Products with the same factor ``z[i] = x[i] * y``
+  static void mul(gfp_* z, const gfp_* x, const gfp_& y, size_t n);
+
   static gfp_ power_of_two(bool bit, int exp);
 
   void assign_zero()        { assignZero(a,ZpD); }
@@ -165,7 +172,7 @@ class gfp_ : public ValueInterface
   gfp_(int x) : gfp_(long(x)) {}
   gfp_(long x);
   gfp_(long long x) : gfp_(long(x)) {}
-  gfp_(word x) : gfp_(bigint::tmp = x) {}
+  gfp_(word x) { a.convert(x, ZpD); }
   template<class T>
   gfp_(IntBase<T> x) : gfp_(x.get()) {}
   /**
@@ -175,6 +182,8 @@ class gfp_ : public ValueInterface
   gfp_(const gfp_<Y, L>& x);
   gfp_(const gfpvar& other);
   template<int K>
+  gfp_(const Z2<K>& other);
+  template<int K>
   gfp_(const SignedZ2<K>& other);
 
   gfp_(PRNG& G);
@@ -319,6 +328,8 @@ typedef gfp_<1, GFP_MOD_SZ> gfp1;
 template<int X, int L>
 Zp_Data gfp_<X, L>::ZpD;
 template<int X, int L>
+MontgomeryVectors gfp_<X, L>::vectors;
+template<int X, int L>
 gfp_<X, L> gfp_<X, L>::two;
 
 template<int X, int L>
@@ -337,7 +348,7 @@ gfp_<X, L>::gfp_(long x)
   else if (x == 2)
     *this = two;
   else
-    *this = bigint::tmp = x;
+    a.convert(x < 0 ? -mp_limb_t(x) : mp_limb_t(x), ZpD, x < 0);
 }
 
 template<int X, int L>
@@ -348,6 +359,23 @@ gfp_<X, L>::gfp_(const gfp_<Y, L>& x)
   *this = bigint::tmp;
 }
 
+template<int X, int L>
+template<int K>
+gfp_<X, L>::gfp_(const Z2<K>& other)
+{
+  // avoid bigint unless reduction is needed on several limbs
+  auto limbs = other.get();
+  int n = other.size_in_limbs(), t = ZpD.get_t();
+  while (n > 0 and limbs[n - 1] == 0)
+    n--;
+  if (n == 1)
+    a.convert(limbs[0], ZpD);
+  else if (n < t or (n == t and mpn_cmp(limbs, ZpD.get_prA(), t) < 0))
+    a.convert(limbs, n, ZpD);
+  else
+    *this = bigint::tmp = other;
+}
+
 template<int X, int L>
 template<int K>
 gfp_<X, L>::gfp_(const SignedZ2<K>& other)
@@ -370,6 +398,57 @@ inline void gfp_<X, L>::zero_overhang()
   a.x[t() - 1] &= ZpD.overhang_mask();
 }
 
+template<int X, int L>
+void gfp_<X, L>::mul(gfp_* z, const gfp_* x, const gfp_* y, size_t n)
+{
+  static_assert(sizeof(gfp_) == sizeof(mp_limb_t) * L, "wrong size");
+  if (vectors.active() and n >= MontgomeryVectors::MIN_BATCH)
+    vectors.mul((uint64_t*) z, (const uint64_t*) x, (const uint64_t*) y, n);
+  else
+    for (size_t i = 0; i < n; i++)
+      z[i].mul(x[i], y[i]);
+}
+
+template<int X, int L>
+void gfp_<X, L>::mul(gfp_* z, const gfp_* x, const gfp_& y, size_t n)
+{
+  gfp_ factor = y;
+  if (vectors.active() and n >= MontgomeryVectors::MIN_BATCH)
+    vectors.mul((uint64_t*) z, (const uint64_t*) x,
+        (const uint64_t*) &factor, n, true);
+  else
+    for (size_t i = 0; i < n; i++)
+      z[i].mul(x[i], factor);
+}
+
+// for octetStream::store_range()
+template<int X, int L>
+constexpr bool flat_packing(const gfp_<X, L>*)
+{
+  return true;
+}
+
+// for vector_mul() in Math/ring_vectors.h
+template<int X, int L>
+constexpr int flat_field_limbs(const gfp_<X, L>*)
+{
+  return L;
+}
+
+template<int X, int L>
+void field_mul(gfp_<X, L>* z, const gfp_<X, L>* x, const gfp_<X, L>* y,
+    int n)
+{
+  gfp_<X, L>::mul(z, x, y, n);
+}
+
+template<int X, int L>
+void field_scale(gfp_<X, L>* z, const gfp_<X, L>* x, const gfp_<X, L>& y,
+    int n)
+{
+  gfp_<X, L>::mul(z, x, y, n);
+}
+
 template<class T>
 void to_signed_bigint(bigint& ans, const T& x)
 {
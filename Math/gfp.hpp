@@ -58,6 +58,7 @@ void gfp_<X, L>::init_field(const bigint& p, bool mont)
         cerr << name << " larger than necessary for modulus " << p << endl;
     }
   two = bigint::tmp = 2;
+  vectors.init(ZpD);
 }
 
 template <int X, int L>
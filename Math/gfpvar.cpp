@@ -207,30 +207,6 @@ void gfpvar_<X, L>::check()
     assert(mpn_cmp(a.get(), ZpD.get_prA(), ZpD.get_t()) < 0);
 }
 
-template<int X, int L>
-gfpvar_<X, L> gfpvar_<X, L>::operator +(const gfpvar_<X, L>& other) const
-{
-    gfpvar_<X, L> res;
-    Add(res.a, a, other.a, ZpD);
-    return res;
-}
-
-template<int X, int L>
-gfpvar_<X, L> gfpvar_<X, L>::operator -(const gfpvar_<X, L>& other) const
-{
-    gfpvar_<X, L> res;
-    Sub(res.a, a, other.a, ZpD);
-    return res;
-}
-
-template<int X, int L>
-gfpvar_<X, L> gfpvar_<X, L>::operator *(const gfpvar_<X, L>& other) const
-{
-    gfpvar_<X, L> res;
-    Mul(res.a, a, other.a, ZpD);
-    return res;
-}
-
 template<int X, int L>
 gfpvar_<X, L> gfpvar_<X, L>::operator /(const gfpvar_<X, L>& other) const
 {
@@ -249,27 +225,6 @@ gfpvar_<X, L> gfpvar_<X, L>::operator >>(int other) const
     return bigint::tmp = (bigint::tmp = *this) >> other;
 }
 
-template<int X, int L>
-gfpvar_<X, L>& gfpvar_<X, L>::operator +=(const gfpvar_<X, L>& other)
-{
-    Add(a, a, other.a, ZpD);
-    return *this;
-}
-
-template<int X, int L>
-gfpvar_<X, L>& gfpvar_<X, L>::operator -=(const gfpvar_<X, L>& other)
-{
-    Sub(a, a, other.a, ZpD);
-    return *this;
-}
-
-template<int X, int L>
-gfpvar_<X, L>& gfpvar_<X, L>::operator *=(const gfpvar_<X, L>& other)
-{
-    Mul(a, a, other.a, ZpD);
-    return *this;
-}
-
 template<int X, int L>
 gfpvar_<X, L>& gfpvar_<X, L>::operator &=(const gfpvar_<X, L>& other)
 {
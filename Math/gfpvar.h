@@ -31,6 +31,9 @@ class gfpvar_ : public ValueInterface
 
     modp_type a;
 
+    // fixed number of limbs as in gfp_ after dispatch
+    static void mul(modp_type& res, const modp_type& x, const modp_type& y);
+
 public:
     typedef gfpvar_ Scalar;
     typedef FFT_Data FD;
@@ -178,6 +181,68 @@ const true_type gfpvar_<X, L>::prime_field;
 template<int X, int L>
 const false_type gfpvar_<X, L>::characteristic_two;
 
+template<int X, int L>
+inline void gfpvar_<X, L>::mul(modp_type& res, const modp_type& x,
+        const modp_type& y)
+{
+    switch (ZpD.get_t())
+    {
+#define CASE(N) \
+    case N: \
+        res.template mul<(N < L ? N : L)>(x, y, ZpD); \
+        break;
+    CASE(1) CASE(2) CASE(3) CASE(4) CASE(5)
+#undef CASE
+    default:
+        Mul(res, x, y, ZpD);
+    }
+}
+
+template<int X, int L>
+inline gfpvar_<X, L> gfpvar_<X, L>::operator+(const gfpvar_& other) const
+{
+    gfpvar_ res;
+    Add(res.a, a, other.a, ZpD);
+    return res;
+}
+
+template<int X, int L>
+inline gfpvar_<X, L> gfpvar_<X, L>::operator-(const gfpvar_& other) const
+{
+    gfpvar_ res;
+    Sub(res.a, a, other.a, ZpD);
+    return res;
+}
+
+template<int X, int L>
+inline gfpvar_<X, L> gfpvar_<X, L>::operator*(const gfpvar_& other) const
+{
+    gfpvar_ res;
+    mul(res.a, a, other.a);
+    return res;
+}
+
+template<int X, int L>
+inline gfpvar_<X, L>& gfpvar_<X, L>::operator+=(const gfpvar_& other)
+{
+    Add(a, a, other.a, ZpD);
+    return *this;
+}
+
+template<int X, int L>
+inline gfpvar_<X, L>& gfpvar_<X, L>::operator-=(const gfpvar_& other)
+{
+    Sub(a, a, other.a, ZpD);
+    return *this;
+}
+
+template<int X, int L>
+inline gfpvar_<X, L>& gfpvar_<X, L>::operator*=(const gfpvar_& other)
+{
+    mul(a, a, other.a);
+    return *this;
+}
+
 template<int X, int L>
 template<class T>
 void gfpvar_<X, L>::generate_setup(string prep_data_prefix,
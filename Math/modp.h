@@ -70,6 +70,8 @@ class modp_
 
   void convert(const mp_limb_t* source, mp_size_t size, const Zp_Data& ZpD,
       bool negative = false);
+  // single limb of any size relative to the prime, without allocation
+  void convert(mp_limb_t source, const Zp_Data& ZpD, bool negative = false);
   void convert_destroy(bigint& source, const Zp_Data& ZpD);
   void convert_destroy(int source, const Zp_Data& ZpD) { to_modp(*this, source, ZpD); }
   template<int M>
@@ -169,6 +171,8 @@ inline void Mul(modp_<L>& ans,const modp_<L>& x,const modp_<L>& y,const Zp_Data&
 {
   if (ZpD.montgomery)
     { ZpD.Mont_Mult_max(ans.x,x.x,y.x,L); }
+  else if (ZpD.special)
+    { ZpD.Special_Mult_max<L>(ans.x,x.x,y.x); }
   else
     { //ans.x=(x.x*y.x)%ZpD.pr;
       mp_limb_t aa[2*L],q[2*L];
@@ -183,6 +187,8 @@ inline void modp_<L>::mul(const modp_<L>& x, const modp_<L>& y, const Zp_Data& Z
 {
   if (ZpD.montgomery)
     ZpD.Mont_Mult_<T>(this->x, x.x, y.x);
+  else if (ZpD.special)
+    ZpD.Special_Mult_max<T>(this->x, x.x, y.x);
   else
     Mul<L>(*this, x, y, ZpD);
 }
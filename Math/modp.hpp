@@ -177,22 +177,7 @@ void modp_<L>::to_bigint(bigint& ans,const Zp_Data& ZpD,bool reduce) const
 template<int L>
 void to_modp(modp_<L>& ans,int x,const Zp_Data& ZpD)
 {
-  inline_mpn_zero(ans.x,ZpD.get_t());
-  if (x>=0)
-    { ans.x[0]=x;
-      if (ZpD.t==1) { ans.x[0]=ans.x[0]%ZpD.prA[0]; }
-    }
-  else
-    { if (ZpD.t==1)
-	{ ans.x[0]=(ZpD.prA[0]+x)%ZpD.prA[0]; }
-      else
-        { bigint& xx = bigint::tmp = ZpD.pr+x;
-          to_modp(ans,xx,ZpD);
-          return;
-        }
-    }
-  if (ZpD.montgomery)
-    { ZpD.Mont_Mult(ans.x,ans.x,ZpD.R2); }
+  ans.convert(x < 0 ? -mp_limb_t(long(x)) : mp_limb_t(x), ZpD, x < 0);
 }
 
 
@@ -250,6 +235,14 @@ void modp_<L>::convert(const mp_limb_t* source, mp_size_t size, const Zp_Data& Z
     ZpD.Mont_Mult(x, x, ZpD.R2);
 }
 
+template<int L>
+void modp_<L>::convert(mp_limb_t source, const Zp_Data& ZpD, bool negative)
+{
+  if (ZpD.t == 1)
+    source %= ZpD.prA[0];
+  convert(&source, 1, ZpD, negative and source != 0);
+}
+
 template<int L>
 void modp_<L>::zero_overhang(const Zp_Data& ZpD)
 {
@@ -263,6 +256,8 @@ void Sqr(modp_<L>& ans,const modp_<L>& x,const Zp_Data& ZpD)
 { 
   if (ZpD.montgomery)
     { ZpD.Mont_Mult(ans.x,x.x,x.x); }
+  else if (ZpD.special)
+    { ZpD.Special_Mult_max<L>(ans.x,x.x,x.x); }
   else
     { //ans.x=(x.x*x.x)%ZpD.pr;
       mp_limb_t aa[2*L],q[2*L];
@@ -0,0 +1,232 @@
+/*
+ * modp_vectors.cpp
+ *
+ */
+
+#include "modp_vectors.h"
+#include "Zp_Data.h"
+#include "Tools/cpu_support.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+const uint64_t DIGIT_MASK = (1ull << 52) - 1;
+
+// digit k of number with n_limbs limbs
+inline uint64_t get_digit(const uint64_t* limbs, int n_limbs, int k)
+{
+    int w = 52 * k / 64, s = 52 * k % 64;
+    if (w >= n_limbs)
+        return 0;
+    uint64_t res = limbs[w] >> s;
+    if (s > 12 and w + 1 < n_limbs)
+        res |= limbs[w + 1] << (64 - s);
+    return res & DIGIT_MASK;
+}
+
+bool MontgomeryVectors::available()
+{
+#if defined(__AVX512IFMA__) && defined(__AVX512F__)
+    return cpu_has_avx512ifma();
+#else
+    return false;
+#endif
+}
+
+void MontgomeryVectors::init(const Zp_Data& ZpD)
+{
+    n_digits = 0;
+    if (not ZpD.get_mont() or not available())
+        return;
+
+    const bigint& pr = ZpD.pr;
+    int k = DIV_CEIL(ZpD.pr_bit_length + 1, 52);
+    if (k > MAX_DIGITS)
+        return;
+
+    n_limbs = ZpD.get_t();
+    bigint tmp;
+    for (int i = 0; i < k; i++)
+    {
+        tmp = (pr >> (52 * i)) & bigint(DIGIT_MASK);
+        p[i] = tmp.get_ui();
+    }
+
+    // from 2^(-52k) to 2^(-64 * n_limbs)
+    tmp = (bigint(1) << (104 * k - 64 * n_limbs)) % pr;
+    for (int i = 0; i < k; i++)
+        correction[i] = bigint((tmp >> (52 * i)) & bigint(DIGIT_MASK)).get_ui();
+
+    bigint two_52 = bigint(1) << 52;
+    mpz_invert(tmp.get_mpz_t(), pr.get_mpz_t(), two_52.get_mpz_t());
+    tmp = two_52 - tmp;
+    p_inv = tmp.get_ui();
+
+    n_digits = k;
+}
+
+#if defined(__AVX512IFMA__) && defined(__AVX512F__)
+// avoid spurious warnings about undefined source
+inline __m512i srli(__m512i x, int n)
+{
+    return _mm512_maskz_srli_epi64(-1, x, n);
+}
+
+inline __m512i slli(__m512i x, int n)
+{
+    return _mm512_maskz_slli_epi64(-1, x, n);
+}
+
+// Montgomery product modulo 2^(52K) of fully reduced values
+template<int K>
+inline void mont_ifma(__m512i* res, const __m512i* x, const __m512i* y,
+        const __m512i* p, __m512i p_inv)
+{
+    const __m512i mask = _mm512_set1_epi64(DIGIT_MASK);
+    const __m512i zero = _mm512_setzero_si512();
+
+    // digits are not normalized until the end
+    __m512i a[K + 1];
+    for (int j = 0; j <= K; j++)
+        a[j] = zero;
+    for (int i = 0; i < K; i++)
+    {
+        for (int j = 0; j < K; j++)
+        {
+            a[j] = _mm512_madd52lo_epu64(a[j], x[i], y[j]);
+            a[j + 1] = _mm512_madd52hi_epu64(a[j + 1], x[i], y[j]);
+        }
+        __m512i q = _mm512_madd52lo_epu64(zero, a[0], p_inv);
+        for (int j = 0; j < K; j++)
+        {
+            a[j] = _mm512_madd52lo_epu64(a[j], q, p[j]);
+            a[j + 1] = _mm512_madd52hi_epu64(a[j + 1], q, p[j]);
+        }
+        a[1] = _mm512_add_epi64(a[1], srli(a[0], 52));
+        for (int j = 0; j < K; j++)
+            a[j] = a[j + 1];
+        a[K] = zero;
+    }
+
+    for (int j = 0; j < K - 1; j++)
+    {
+        a[j + 1] = _mm512_add_epi64(a[j + 1], srli(a[j], 52));
+        a[j] = _mm512_and_si512(a[j], mask);
+    }
+
+    // result is below 2p
+    __m512i borrow = zero, d[K];
+    for (int j = 0; j < K; j++)
+    {
+        __m512i t = _mm512_sub_epi64(_mm512_sub_epi64(a[j], p[j]), borrow);
+        borrow = srli(t, 63);
+        d[j] = _mm512_and_si512(t, mask);
+    }
+    __mmask8 smaller = _mm512_cmpneq_epi64_mask(borrow, zero);
+    for (int j = 0; j < K; j++)
+        res[j] = _mm512_mask_blend_epi64(smaller, d[j], a[j]);
+}
+#endif
+
+#if defined(__AVX512IFMA__) && defined(__AVX512F__)
+// digits of eight numbers with n_limbs limbs each
+template<int K>
+inline void load_digits(__m512i* digits, const uint64_t* limbs, int n_limbs,
+        __mmask8 mask)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i index = _mm512_mullo_epi64(_mm512_set1_epi64(n_limbs),
+            _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0));
+    for (int k = 0; k < K; k++)
+    {
+        int w = 52 * k / 64, s = 52 * k % 64;
+        __m512i res = zero;
+        if (w < n_limbs)
+            res = srli(_mm512_mask_i64gather_epi64(zero, mask,
+                    index, limbs + w, 8), s);
+        if (s > 12 and w + 1 < n_limbs)
+            res = _mm512_or_si512(res,
+                    slli(_mm512_mask_i64gather_epi64(zero, mask,
+                            index, limbs + w + 1, 8), 64 - s));
+        digits[k] = _mm512_and_si512(res, _mm512_set1_epi64(DIGIT_MASK));
+    }
+}
+
+template<int K>
+inline void store_digits(uint64_t* limbs, const __m512i* digits, int n_limbs,
+        __mmask8 mask)
+{
+    __m512i index = _mm512_mullo_epi64(_mm512_set1_epi64(n_limbs),
+            _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0));
+    for (int w = 0; w < n_limbs; w++)
+    {
+        __m512i res = _mm512_setzero_si512();
+        for (int k = 0; k < K; k++)
+        {
+            int s = 52 * k - 64 * w;
+            if (s >= 0 and s < 64)
+                res = _mm512_or_si512(res, slli(digits[k], s));
+            else if (s < 0 and s > -52)
+                res = _mm512_or_si512(res, srli(digits[k], -s));
+        }
+        _mm512_mask_i64scatter_epi64(limbs + w, mask, index, res, 8);
+    }
+}
+#endif
+
+template<int K>
+void MontgomeryVectors::ifma_mul(uint64_t* z, const uint64_t* x,
+        const uint64_t* y, size_t n, bool same_y) const
+{
+#if defined(__AVX512IFMA__) && defined(__AVX512F__)
+    const int L = n_limbs;
+    __m512i vp[K], vc[K], vx[K], vy[K] = {}, vz[K];
+    for (int j = 0; j < K; j++)
+    {
+        vp[j] = _mm512_set1_epi64(p[j]);
+        vc[j] = _mm512_set1_epi64(correction[j]);
+    }
+    __m512i v_inv = _mm512_set1_epi64(p_inv);
+
+    if (same_y)
+    {
+        // include correction in factor
+        for (int j = 0; j < K; j++)
+            vy[j] = _mm512_set1_epi64(get_digit(y, L, j));
+        mont_ifma<K>(vy, vy, vc, vp, v_inv);
+    }
+
+    for (size_t i = 0; i < n; i += 8)
+    {
+        __mmask8 mask = n - i >= 8 ? 0xff : (1 << (n - i)) - 1;
+        load_digits<K>(vx, x + L * i, L, mask);
+        if (same_y)
+            mont_ifma<K>(vz, vx, vy, vp, v_inv);
+        else
+        {
+            load_digits<K>(vy, y + L * i, L, mask);
+            mont_ifma<K>(vz, vx, vy, vp, v_inv);
+            mont_ifma<K>(vz, vz, vc, vp, v_inv);
+        }
+        store_digits<K>(z + L * i, vz, L, mask);
+    }
+#else
+    (void) z, (void) x, (void) y, (void) n, (void) same_y;
+    throw runtime_error("no IFMA support");
+#endif
+}
+
+void MontgomeryVectors::mul(uint64_t* z, const uint64_t* x,
+        const uint64_t* y, size_t n, bool same_y) const
+{
+    switch (n_digits)
+    {
+#define X(K) case K: return ifma_mul<K>(z, x, y, n, same_y);
+    X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8)
+#undef X
+    default:
+        throw runtime_error("invalid number of digits");
+    }
+}
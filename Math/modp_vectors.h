@@ -0,0 +1,61 @@
+/*
+ * modp_vectors.h
+ *
+ */
+
+#ifndef MATH_MODP_VECTORS_H_
+#define MATH_MODP_VECTORS_H_
+
+#include "Math/bigint.h"
+
+#include <cstdint>
+#include <cstddef>
+
+class Zp_Data;
+
+/**
+ * Element-wise Montgomery multiplication of arrays of elements modulo a
+ * prime. With AVX-512 IFMA, eight products are computed at once on 52-bit
+ * digits, followed by a multiplication with a constant that corrects for
+ * the different Montgomery factor.
+ */
+class MontgomeryVectors
+{
+    static const int MAX_DIGITS = 8;
+
+    // number of 52-bit digits, zero if not applicable
+    int n_digits;
+    int n_limbs;
+    uint64_t p[MAX_DIGITS], correction[MAX_DIGITS];
+    // -1/p modulo 2^52
+    uint64_t p_inv;
+
+    template<int K>
+    void ifma_mul(uint64_t* z, const uint64_t* x, const uint64_t* y,
+            size_t n, bool same_y) const;
+
+public:
+    // smaller batches use scalar multiplication
+    static const size_t MIN_BATCH = 8;
+
+    static bool available();
+
+    MontgomeryVectors() : n_digits(0), n_limbs(0), p_inv(0) {}
+
+    void init(const Zp_Data& ZpD);
+
+    bool active() const { return n_digits > 0; }
+
+    /**
+     * Products of Montgomery representations of ``n_limbs`` limbs each
+     * @param z destination (``n_limbs * n`` limbs)
+     * @param x first factors (``n_limbs * n`` limbs)
+     * @param y second factors (``n_limbs * n`` limbs or one element)
+     * @param n number of products
+     * @param same_y use the first element of ``y`` for all products
+     */
+    void mul(uint64_t* z, const uint64_t* x, const uint64_t* y, size_t n,
+            bool same_y = false) const;
+};
+
+#endif /* MATH_MODP_VECTORS_H_ */
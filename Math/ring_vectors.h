@@ -0,0 +1,559 @@
+/*
+ * ring_vectors.h
+ *
+ */
+
+#ifndef MATH_RING_VECTORS_H_
+#define MATH_RING_VECTORS_H_
+
+#include "Z2k.h"
+#include "FixedVec.h"
+#include "Tools/cpu_support.h"
+#include "Tools/intrinsics.h"
+
+#include <cstdint>
+
+// number of 64-bit words of types that are plain arrays modulo 2^64
+constexpr int flat_ring_words(const void*)
+{
+    return 0;
+}
+
+constexpr int flat_ring_words(const Z2<64>*)
+{
+    return 1;
+}
+
+template<int L>
+constexpr int flat_ring_words(const FixedVec<Z2<64>, L>*)
+{
+    return L;
+}
+
+/**
+ * Number of 64-bit words if ``T`` is arithmetic modulo 2^64 on each word
+ * (e.g., ``Z2<64>`` and replicated shares thereof), zero otherwise
+ */
+template<class T>
+constexpr int ring_words()
+{
+    constexpr int n_words = flat_ring_words(static_cast<const T*>(nullptr));
+    return sizeof(T) == n_words * sizeof(uint64_t) ? n_words : 0;
+}
+
+// bit length of types consisting of Z2<K> with at most two words
+constexpr int flat_z2k_bits(const void*)
+{
+    return 0;
+}
+
+template<int K>
+constexpr int flat_z2k_bits(const Z2<K>*)
+{
+    return K <= 128 ? K : 0;
+}
+
+template<int K, int L>
+constexpr int flat_z2k_bits(const FixedVec<Z2<K>, L>*)
+{
+    return K <= 128 ? K : 0;
+}
+
+/**
+ * Bit length if ``T`` consists of one or more ``Z2<K>`` for ``K <= 128``
+ * (e.g., ``Z2<72>`` and shares thereof), zero otherwise
+ */
+template<class T>
+constexpr int z2k_bits()
+{
+    constexpr int K = flat_z2k_bits(static_cast<const T*>(nullptr));
+    if constexpr (K > 0)
+        return sizeof(T) % sizeof(Z2<K>) == 0 ? K : 0;
+    else
+        return 0;
+}
+
+// number of limbs of prime field types with batched multiplication,
+// overloaded in Math/gfp.h
+constexpr int flat_field_limbs(const void*)
+{
+    return 0;
+}
+
+template<class T>
+constexpr int field_limbs()
+{
+    constexpr int n_limbs = flat_field_limbs(static_cast<const T*>(nullptr));
+    return sizeof(T) == n_limbs * sizeof(uint64_t) ? n_limbs : 0;
+}
+
+#if defined(__AVX2__) and defined(__x86_64__)
+// lower half of 64x64-bit products
+inline __m256i mullo_epi64(__m256i a, __m256i b)
+{
+    __m256i cross = _mm256_add_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+            _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b),
+            _mm256_slli_epi64(cross, 32));
+}
+#endif
+
+inline void ring_add(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+        size_t n_words)
+{
+    size_t i = 0;
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+    if (cpu_has_avx512())
+        for (; i + 8 <= n_words; i += 8)
+            _mm512_storeu_si512(dest + i,
+                    _mm512_add_epi64(_mm512_loadu_si512(x + i),
+                            _mm512_loadu_si512(y + i)));
+#endif
+#if defined(__AVX2__) and defined(__x86_64__)
+    if (cpu_has_avx2())
+        for (; i + 4 <= n_words; i += 4)
+            _mm256_storeu_si256((__m256i*) (dest + i),
+                    _mm256_add_epi64(_mm256_loadu_si256((__m256i*) (x + i)),
+                            _mm256_loadu_si256((__m256i*) (y + i))));
+#endif
+    for (; i < n_words; i++)
+        dest[i] = x[i] + y[i];
+}
+
+inline void ring_sub(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+        size_t n_words)
+{
+    size_t i = 0;
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+    if (cpu_has_avx512())
+        for (; i + 8 <= n_words; i += 8)
+            _mm512_storeu_si512(dest + i,
+                    _mm512_sub_epi64(_mm512_loadu_si512(x + i),
+                            _mm512_loadu_si512(y + i)));
+#endif
+#if defined(__AVX2__) and defined(__x86_64__)
+    if (cpu_has_avx2())
+        for (; i + 4 <= n_words; i += 4)
+            _mm256_storeu_si256((__m256i*) (dest + i),
+                    _mm256_sub_epi64(_mm256_loadu_si256((__m256i*) (x + i)),
+                            _mm256_loadu_si256((__m256i*) (y + i))));
+#endif
+    for (; i < n_words; i++)
+        dest[i] = x[i] - y[i];
+}
+
+/**
+ * Multiply elements of ``L`` words by one word each
+ * @param dest destination (``L * n_elements`` words)
+ * @param x elements (``L * n_elements`` words)
+ * @param y factors (``n_elements`` words)
+ */
+template<int L>
+void ring_mul(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+        size_t n_elements)
+{
+    size_t i = 0;
+    if (L == 1 or L == 2)
+    {
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+        if (cpu_has_avx512())
+        {
+            // factor for every word
+            const __m512i spread = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+            const size_t n_per_vector = 8 / (L == 2 ? 2 : 1);
+            for (; i + n_per_vector <= n_elements; i += n_per_vector)
+            {
+                __m512i factors;
+                if (L == 1)
+                    factors = _mm512_loadu_si512(y + i);
+                else
+                    factors = _mm512_maskz_permutexvar_epi64(-1, spread,
+                            _mm512_maskz_loadu_epi64(0xf, y + i));
+                _mm512_storeu_si512(dest + L * i,
+                        _mm512_mullo_epi64(_mm512_loadu_si512(x + L * i),
+                                factors));
+            }
+        }
+#endif
+#if defined(__AVX2__) and defined(__x86_64__)
+        if (cpu_has_avx2())
+        {
+            const size_t n_per_vector = 4 / (L == 2 ? 2 : 1);
+            for (; i + n_per_vector <= n_elements; i += n_per_vector)
+            {
+                __m256i factors;
+                if (L == 1)
+                    factors = _mm256_loadu_si256((__m256i*) (y + i));
+                else
+                    factors = _mm256_permute4x64_epi64(
+                            _mm256_castsi128_si256(
+                                    _mm_loadu_si128((__m128i*) (y + i))),
+                            0x50);
+                _mm256_storeu_si256((__m256i*) (dest + L * i),
+                        mullo_epi64(
+                                _mm256_loadu_si256((__m256i*) (x + L * i)),
+                                factors));
+            }
+        }
+#endif
+    }
+    for (; i < n_elements; i++)
+        for (int j = 0; j < L; j++)
+            dest[L * i + j] = x[L * i + j] * y[i];
+}
+
+inline void ring_scale(uint64_t* dest, const uint64_t* x, uint64_t y,
+        size_t n_words)
+{
+    size_t i = 0;
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+    if (cpu_has_avx512())
+    {
+        __m512i factor = _mm512_set1_epi64(y);
+        for (; i + 8 <= n_words; i += 8)
+            _mm512_storeu_si512(dest + i,
+                    _mm512_mullo_epi64(_mm512_loadu_si512(x + i), factor));
+    }
+#endif
+#if defined(__AVX2__) and defined(__x86_64__)
+    if (cpu_has_avx2())
+    {
+        __m256i factor = _mm256_set1_epi64x(y);
+        for (; i + 4 <= n_words; i += 4)
+            _mm256_storeu_si256((__m256i*) (dest + i),
+                    mullo_epi64(_mm256_loadu_si256((__m256i*) (x + i)),
+                            factor));
+    }
+#endif
+    for (; i < n_words; i++)
+        dest[i] = x[i] * y;
+}
+
+// dest += x * y
+inline void ring_axpy(uint64_t* dest, const uint64_t* x, uint64_t y,
+        size_t n_words)
+{
+    size_t i = 0;
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+    if (cpu_has_avx512())
+    {
+        __m512i factor = _mm512_set1_epi64(y);
+        for (; i + 8 <= n_words; i += 8)
+            _mm512_storeu_si512(dest + i,
+                    _mm512_add_epi64(_mm512_loadu_si512(dest + i),
+                            _mm512_mullo_epi64(_mm512_loadu_si512(x + i),
+                                    factor)));
+    }
+#endif
+#if defined(__AVX2__) and defined(__x86_64__)
+    if (cpu_has_avx2())
+    {
+        __m256i factor = _mm256_set1_epi64x(y);
+        for (; i + 4 <= n_words; i += 4)
+            _mm256_storeu_si256((__m256i*) (dest + i),
+                    _mm256_add_epi64(
+                            _mm256_loadu_si256((__m256i*) (dest + i)),
+                            mullo_epi64(
+                                    _mm256_loadu_si256((__m256i*) (x + i)),
+                                    factor)));
+    }
+#endif
+    for (; i < n_words; i++)
+        dest[i] += x[i] * y;
+}
+
+/**
+ * Add product of row-major matrices modulo 2^64, blocked such that
+ * a panel of ``B`` stays in cache across the rows of ``A``
+ * @param C result (``n_rows * n_cols`` words)
+ * @param A left factor (``n_rows * n_inner`` words)
+ * @param B right factor (``n_inner * n_cols`` words)
+ */
+inline void ring_gemm(uint64_t* C, const uint64_t* A, const uint64_t* B,
+        size_t n_rows, size_t n_inner, size_t n_cols)
+{
+    const size_t K_BLOCK = 128, J_BLOCK = 256;
+    for (size_t jj = 0; jj < n_cols; jj += J_BLOCK)
+    {
+        size_t n_j = min(J_BLOCK, n_cols - jj);
+        for (size_t kk = 0; kk < n_inner; kk += K_BLOCK)
+        {
+            size_t k_end = min(kk + K_BLOCK, n_inner);
+            for (size_t i = 0; i < n_rows; i++)
+                for (size_t k = kk; k < k_end; k++)
+                    ring_axpy(C + i * n_cols + jj, B + k * n_cols + jj,
+                            A[i * n_inner + k], n_j);
+        }
+    }
+}
+
+// same as Z2<64>::signed_rshift()
+inline uint64_t ring_signed_rshift(uint64_t x, int m)
+{
+    uint64_t sign = -(x >> 63);
+    return (((x ^ sign) >> m) ^ sign) - sign;
+}
+
+/**
+ * Local parts of probabilistic truncation with a big gap
+ * (https://eprint.iacr.org/2018/403) on replicated shares modulo 2^64,
+ * stored as two words per share
+ */
+
+// ``dest[i] = (x[i][0] + x[i][1]) >> m - r[i]``
+inline void ring_trunc_pr_sum(uint64_t* dest, const uint64_t* x,
+        const uint64_t* r, int m, size_t n_elements)
+{
+    for (size_t i = 0; i < n_elements; i++)
+        dest[i] = ring_signed_rshift(x[2 * i] + x[2 * i + 1], m) - r[i];
+}
+
+// ``dest[i][I] = x[i][I] >> m`` and ``dest[i][1 - I] = y[i]``
+template<int I>
+void ring_trunc_pr_share(uint64_t* dest, const uint64_t* x,
+        const uint64_t* y, int m, size_t n_elements)
+{
+    for (size_t i = 0; i < n_elements; i++)
+    {
+        uint64_t tmp = ring_signed_rshift(x[2 * i + I], m);
+        dest[2 * i + 1 - I] = y[i];
+        dest[2 * i + I] = tmp;
+    }
+}
+
+// Z2<K> arithmetic on 128-bit integers
+template<int K>
+inline __uint128_t z2k_load(const uint64_t* x)
+{
+    if (K <= 64)
+        return x[0];
+    __uint128_t res;
+    memcpy(&res, x, sizeof(res));
+    return res;
+}
+
+template<int K>
+inline void z2k_store(uint64_t* dest, __uint128_t x)
+{
+    if (K <= 64)
+        dest[0] = uint64_t(x) & Z2<K>::UPPER_MASK;
+    else
+    {
+        if (K < 128)
+            x &= (__uint128_t(1) << (K % 128)) - 1;
+        memcpy(dest, &x, sizeof(x));
+    }
+}
+
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+// carry or borrow of even lanes into odd lanes of ``res``
+template<int K, bool ADD>
+inline __m512i z2k_carry(__m512i res, __m512i x, __m512i y)
+{
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i mask = _mm512_set_epi64(Z2<K>::UPPER_MASK, -1,
+            Z2<K>::UPPER_MASK, -1, Z2<K>::UPPER_MASK, -1,
+            Z2<K>::UPPER_MASK, -1);
+    __mmask8 carry = ADD ? _mm512_cmplt_epu64_mask(res, x) :
+            _mm512_cmplt_epu64_mask(x, y);
+    carry = (carry & 0x55) << 1;
+    res = ADD ? _mm512_mask_add_epi64(res, carry, res, one) :
+            _mm512_mask_sub_epi64(res, carry, res, one);
+    return _mm512_and_si512(res, mask);
+}
+#endif
+
+/**
+ * Element-wise addition or subtraction of ``Z2<K>`` with two words
+ * @param n number of elements
+ */
+template<int K, bool ADD>
+void z2k_add(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+        size_t n)
+{
+    static_assert(K > 64 and K <= 128, "only for two words");
+    size_t i = 0;
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+    if (cpu_has_avx512())
+        for (; i + 4 <= n; i += 4)
+        {
+            __m512i a = _mm512_loadu_si512(x + 2 * i);
+            __m512i b = _mm512_loadu_si512(y + 2 * i);
+            __m512i res = ADD ? _mm512_add_epi64(a, b) :
+                    _mm512_sub_epi64(a, b);
+            _mm512_storeu_si512(dest + 2 * i, z2k_carry<K, ADD>(res, a, b));
+        }
+#endif
+    for (; i < n; i++)
+    {
+        auto a = z2k_load<K>(x + 2 * i), b = z2k_load<K>(y + 2 * i);
+        z2k_store<K>(dest + 2 * i, ADD ? a + b : a - b);
+    }
+}
+
+/**
+ * Multiply elements of ``L`` times ``Z2<K>`` by one ``Z2<M>`` each
+ * @param dest destination (``L * n_elements`` values)
+ * @param x elements (``L * n_elements`` values)
+ * @param y factors (``n_elements`` values)
+ */
+template<int K, int L, int M>
+void z2k_mul(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+        size_t n_elements)
+{
+    const int W = Z2<K>::size_in_limbs(), V = Z2<M>::size_in_limbs();
+    for (size_t i = 0; i < n_elements; i++)
+    {
+        auto factor = z2k_load<M>(y + V * i);
+        for (int j = 0; j < L; j++)
+            z2k_store<K>(dest + W * (L * i + j),
+                    z2k_load<K>(x + W * (L * i + j)) * factor);
+    }
+}
+
+/**
+ * Inner product of ``Z2<K>`` and ``Z2<L>`` vectors in ``Z2<K>``
+ * without reduction of intermediate results
+ */
+template<int K, int L>
+Z2<K> z2k_dot(const Z2<K>* x, const Z2<L>* y, size_t n)
+{
+    static_assert(K <= 128 and L <= 128, "only up to two words");
+    const int W = Z2<K>::size_in_limbs(), V = Z2<L>::size_in_limbs();
+    auto xx = (const uint64_t*) x, yy = (const uint64_t*) y;
+    size_t i = 0;
+    if (W == 1 and V == 1)
+    {
+        uint64_t sum = 0;
+#if defined(__AVX512F__) and defined(__AVX512DQ__)
+        if (cpu_has_avx512())
+        {
+            __m512i acc = _mm512_setzero_si512();
+            for (; i + 8 <= n; i += 8)
+                acc = _mm512_add_epi64(acc,
+                        _mm512_mullo_epi64(_mm512_loadu_si512(xx + i),
+                                _mm512_loadu_si512(yy + i)));
+            uint64_t lanes[8];
+            _mm512_storeu_si512(lanes, acc);
+            for (auto lane : lanes)
+                sum += lane;
+        }
+#endif
+        for (; i < n; i++)
+            sum += xx[i] * yy[i];
+        return Z2<K>((const void*) &sum);
+    }
+    else
+    {
+        __uint128_t sum = 0;
+        for (; i < n; i++)
+            sum += z2k_load<K>(xx + W * i) * z2k_load<L>(yy + V * i);
+        return Z2<K>((const void*) &sum);
+    }
+}
+
+/// Inner product of ``x`` and ``y``
+template<class T, class U>
+T vector_dot(const T* x, const U* y, size_t n)
+{
+    constexpr int K = z2k_bits<T>(), L = z2k_bits<U>();
+    if constexpr (K > 0 and L > 0)
+        if (sizeof(T) == sizeof(Z2<K>) and sizeof(U) == sizeof(Z2<L>))
+            return z2k_dot((const Z2<K>*) x, (const Z2<L>*) y, n);
+    T res;
+    for (size_t i = 0; i < n; i++)
+        res += x[i] * y[i];
+    return res;
+}
+
+// reading ahead is only a problem when writing ahead
+template<class T>
+inline bool simd_safe(const T* dest, const T* source, int size)
+{
+    return dest <= source or dest >= source + size;
+}
+
+template<class T, class U>
+inline bool simd_safe(const T* dest, const U* source, int size)
+{
+    return (void*) (dest + size) <= (void*) source
+            or (void*) dest >= (void*) (source + size);
+}
+
+/// Element-wise addition of register ranges
+template<class T>
+void vector_add(T* dest, const T* x, const T* y, int size)
+{
+    const int L = ring_words<T>();
+    constexpr int K = z2k_bits<T>();
+    if (L and simd_safe(dest, x, size) and simd_safe(dest, y, size))
+        ring_add((uint64_t*) dest, (const uint64_t*) x, (const uint64_t*) y,
+                L * size);
+    else if (K > 64 and simd_safe(dest, x, size) and simd_safe(dest, y, size))
+        z2k_add<max(K, 65), true>((uint64_t*) dest, (const uint64_t*) x,
+                (const uint64_t*) y, size * sizeof(T) / 16);
+    else
+        for (int i = 0; i < size; i++)
+            dest[i] = x[i] + y[i];
+}
+
+/// Element-wise subtraction of register ranges
+template<class T>
+void vector_sub(T* dest, const T* x, const T* y, int size)
+{
+    const int L = ring_words<T>();
+    constexpr int K = z2k_bits<T>();
+    if (L and simd_safe(dest, x, size) and simd_safe(dest, y, size))
+        ring_sub((uint64_t*) dest, (const uint64_t*) x, (const uint64_t*) y,
+                L * size);
+    else if (K > 64 and simd_safe(dest, x, size) and simd_safe(dest, y, size))
+        z2k_add<max(K, 65), false>((uint64_t*) dest, (const uint64_t*) x,
+                (const uint64_t*) y, size * sizeof(T) / 16);
+    else
+        for (int i = 0; i < size; i++)
+            dest[i] = x[i] - y[i];
+}
+
+/// Element-wise multiplication of shares by clear values
+template<class T, class U>
+void vector_mul(T* dest, const T* x, const U* y, int size)
+{
+    constexpr int L = ring_words<T>();
+    constexpr int F = field_limbs<T>();
+    constexpr int K = z2k_bits<T>(), M = z2k_bits<U>();
+    if constexpr (F > 0 and field_limbs<U>() == F)
+        if (simd_safe(dest, x, size) and simd_safe(dest, y, size))
+            return field_mul(dest, x, y, size);
+    if constexpr (L == 0 and K > 0 and M > 0)
+        if (sizeof(U) == sizeof(Z2<M>) and simd_safe(dest, x, size)
+                and simd_safe(dest, y, size))
+            return z2k_mul<K, sizeof(T) / sizeof(Z2<K>), M>((uint64_t*) dest,
+                    (const uint64_t*) x, (const uint64_t*) y, size);
+    if (L and ring_words<U>() == 1 and simd_safe(dest, x, size)
+            and simd_safe(dest, y, size))
+        ring_mul<L>((uint64_t*) dest, (const uint64_t*) x,
+                (const uint64_t*) y, size);
+    else
+        for (int i = 0; i < size; i++)
+            dest[i] = x[i] * y[i];
+}
+
+/// Multiplication of shares by the same clear value
+template<class T, class U>
+void vector_scale(T* dest, const T* x, const U& y, int size)
+{
+    const int L = ring_words<T>();
+    constexpr int F = field_limbs<T>();
+    if constexpr (F > 0 and is_same<T, U>::value)
+        if (simd_safe(dest, x, size))
+            return field_scale(dest, x, y, size);
+    if (L and ring_words<U>() == 1 and simd_safe(dest, x, size))
+        ring_scale((uint64_t*) dest, (const uint64_t*) x, *(const uint64_t*) &y,
+                L * size);
+    else
+        for (int i = 0; i < size; i++)
+            dest[i] = x[i] * y;
+}
+
+#endif /* MATH_RING_VECTORS_H_ */
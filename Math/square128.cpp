@@ -9,6 +9,7 @@
 #include "Tools/random.h"
 #include "Tools/BitVector.h"
 #include "Tools/intrinsics.h"
+#include "Tools/cpu_support.h"
 #include "Math/Square.h"
 
 union matrix16x8
@@ -139,6 +140,108 @@ inline void square32::transpose(square128& output, int x, int y)
 }
 #endif
 
+#if defined(__AVX512VBMI__) && defined(__GFNI__)
+/*
+ * Transposition of 8x8 bit blocks using GFNI with byte permutations
+ * to bring the blocks together and apart again
+ */
+class wide_transpose
+{
+    // gathering the bytes of one block in reverse order and scattering
+    __m512i gather[2], scatter[2];
+    // rows of identity matrix for affine transformation
+    __m512i identity;
+    // butterfly steps for transposition of 64-bit entries
+    __m512i butterfly[3][2];
+
+    wide_transpose()
+    {
+        octet indices[2][2][64];
+        for (int h = 0; h < 2; h++)
+            for (int r = 0; r < 8; r++)
+                for (int q = 0; q < 8; q++)
+                {
+                    // row r of block q from four rows per register
+                    indices[0][h][8 * q + 7 - r] = (r / 4) * 64 + (r % 4) * 16
+                            + 8 * h + q;
+                    // byte 8 * g + p of row 4 * h + c
+                    for (int g = 0; g < 2; g++)
+                        indices[1][h][16 * (r % 4) + 8 * g + q] = 64 * g
+                                + 8 * q + 4 * h + r % 4;
+                }
+        for (int h = 0; h < 2; h++)
+        {
+            gather[h] = _mm512_loadu_si512(indices[0][h]);
+            scatter[h] = _mm512_loadu_si512(indices[1][h]);
+        }
+        identity = _mm512_set1_epi64(0x8040201008040201);
+
+        for (int k = 0; k < 3; k++)
+        {
+            int d = 1 << k;
+            long long indices[2][8];
+            for (int j = 0; j < 8; j++)
+            {
+                indices[0][j] = (j & d) ? 8 + j - d : j;
+                indices[1][j] = (j & d) ? 8 + j : j + d;
+            }
+            for (int i = 0; i < 2; i++)
+                butterfly[k][i] = _mm512_loadu_si512(indices[i]);
+        }
+    }
+
+    // 8x8 transpose of 64-bit entries in eight registers
+    UNROLL_LOOPS
+    void transpose_words(__m512i* rows, int stride) const
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            int d = 1 << k;
+            for (int i = 0; i < 8; i++)
+                if (not (i & d))
+                {
+                    auto& a = rows[i * stride];
+                    auto& b = rows[(i + d) * stride];
+                    __m512i tmp = _mm512_permutex2var_epi64(a,
+                            butterfly[k][0], b);
+                    b = _mm512_permutex2var_epi64(a, butterfly[k][1], b);
+                    a = tmp;
+                }
+        }
+    }
+
+public:
+    UNROLL_LOOPS
+    static void apply(square128& square)
+    {
+        static wide_transpose constants;
+        auto& c = constants;
+        auto rows = (__m512i*) square.rows;
+        // blocks[R][h] contains blocks (R, 8h) to (R, 8h+7)
+        __m512i blocks[16][2];
+        for (int R = 0; R < 16; R++)
+        {
+            __m512i a = _mm512_loadu_si512(rows + 2 * R);
+            __m512i b = _mm512_loadu_si512(rows + 2 * R + 1);
+            for (int h = 0; h < 2; h++)
+                blocks[R][h] = _mm512_gf2p8affine_epi64_epi8(c.identity,
+                        _mm512_permutex2var_epi8(a, c.gather[h], b), 0);
+        }
+        // now blocks[C][g] contains blocks (8g, C) to (8g+7, C)
+        for (int g = 0; g < 2; g++)
+            for (int h = 0; h < 2; h++)
+                c.transpose_words(&blocks[8 * g][h], 2);
+        for (int i = 0; i < 8; i++)
+            swap(blocks[i][1], blocks[8 + i][0]);
+        for (int C = 0; C < 16; C++)
+            for (int h = 0; h < 2; h++)
+                _mm512_storeu_si512(rows + 2 * C + h,
+                        _mm512_permutex2var_epi8(blocks[C][0], c.scatter[h],
+                                blocks[C][1]));
+    }
+};
+#endif
+
 #ifdef __AVX2__
 typedef square32 subsquare;
 #define N_SUBSQUARES 4
@@ -154,9 +257,24 @@ const int perm[] = { 0, 8, 4, 0xc, 2, 0xa, 6, 0xe, 1, 9, 5, 0xd, 3, 0xb, 7, 0xf
 const int perm2[] = { 0, 4, 2, 6, 1, 5, 3, 7, 8, 0xc, 0xa, 0xe, 9, 0xd, 0xb, 0xf };
 #endif
 
-UNROLL_LOOPS
 void square128::transpose()
 {
+    transpose(cpu_has_avx512vbmi() and cpu_has_gfni());
+}
+
+UNROLL_LOOPS
+void square128::transpose(bool wide)
+{
+#if defined(__AVX512VBMI__) && defined(__GFNI__)
+    if (wide)
+    {
+        wide_transpose::apply(*this);
+        return;
+    }
+#else
+    (void) wide;
+#endif
+
 #ifdef USE_SUBSQUARES
     for (int j = 0; j < N_SUBSQUARES; j++)
         for (int k = 0; k < j; k++)
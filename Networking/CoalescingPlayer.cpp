@@ -0,0 +1,275 @@
+/*
+ * CoalescingPlayer.cpp
+ *
+ */
+
+#include "CoalescingPlayer.h"
+#include "Processor/OnlineOptions.h"
+
+CoalescingPlayer::CoalescingPlayer(const Names& Nms, const string& id,
+        long budget) :
+        PlainPlayer(Nms, id), budget(budget), have_deadline(false),
+        running(true)
+{
+    pending.resize(num_players());
+    n_pending.resize(num_players());
+    histogram.resize(num_players());
+
+    pthread_mutex_init(&lock, 0);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_create(&flusher, 0, run_flusher, this);
+}
+
+CoalescingPlayer::~CoalescingPlayer()
+{
+    pthread_mutex_lock(&lock);
+    flush_all();
+    running = false;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+    pthread_join(flusher, 0);
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+
+    if (OnlineOptions::singleton.verbose)
+        print_histogram();
+}
+
+void* CoalescingPlayer::run_flusher(void* player)
+{
+    ((CoalescingPlayer*) player)->flush_in_background();
+    return 0;
+}
+
+void CoalescingPlayer::flush_in_background()
+{
+    pthread_mutex_lock(&lock);
+    while (running)
+    {
+        if (not have_deadline)
+            pthread_cond_wait(&cond, &lock);
+        else if (pthread_cond_timedwait(&cond, &lock, &deadline) == ETIMEDOUT)
+            flush_all();
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+bool CoalescingPlayer::fits(int player, const octetStream& o) const
+{
+    return budget > 0
+            and pending[player].get_length() + LENGTH_SIZE + o.get_length()
+                    <= SIZE_LIMIT;
+}
+
+void CoalescingPlayer::add(int player, const octetStream& o) const
+{
+    auto& buffer = pending[player];
+    encode_length(buffer.append(LENGTH_SIZE), o.get_length(), LENGTH_SIZE);
+    buffer.append(o.get_data(), o.get_length());
+    n_pending[player]++;
+
+    if (not have_deadline)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += budget * 1000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+        have_deadline = true;
+        pthread_cond_signal(&cond);
+    }
+}
+
+void CoalescingPlayer::flush(int player, const octetStream* last) const
+{
+    auto& buffer = pending[player];
+    size_t n_messages = n_pending[player];
+    octet header[LENGTH_SIZE];
+    struct iovec iov[3] = {{buffer.get_data(), buffer.get_length()}};
+    int n_iov = 1;
+    if (last)
+    {
+        encode_length(header, last->get_length(), LENGTH_SIZE);
+        iov[n_iov++] = {header, LENGTH_SIZE};
+        iov[n_iov++] = {last->get_data(), last->get_length()};
+        n_messages++;
+    }
+
+    size_t length = 0;
+    for (int i = 0; i < n_iov; i++)
+        length += iov[i].iov_len;
+    if (length == 0)
+        return;
+
+    int socket = sockets[player];
+    send(socket, iov, n_iov);
+
+    size_t size_class = 0;
+    while ((1ul << size_class) < length)
+        size_class++;
+    auto& counts = histogram[player];
+    if (counts.size() <= size_class)
+        counts.resize(size_class + 1);
+    counts[size_class].first++;
+    counts[size_class].second += n_messages;
+
+    buffer.reset_write_head();
+    n_pending[player] = 0;
+}
+
+void CoalescingPlayer::flush_all() const
+{
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+            flush(i);
+    have_deadline = false;
+}
+
+void CoalescingPlayer::print_histogram() const
+{
+    for (int i = 0; i < num_players(); i++)
+    {
+        if (histogram[i].empty())
+            continue;
+        cerr << "Sending to party " << i << " in rounds of up to:" << endl;
+        for (size_t j = 0; j < histogram[i].size(); j++)
+        {
+            auto& count = histogram[i][j];
+            if (count.first)
+                cerr << "  " << (1ul << j) << " bytes: " << count.first
+                        << " times, " << double(count.second) / count.first
+                        << " messages on average" << endl;
+        }
+    }
+}
+
+void CoalescingPlayer::send_to_no_stats(int player, const octetStream& o) const
+{
+    if (player == my_num())
+        return PlainPlayer::send_to_no_stats(player, o);
+
+    pthread_mutex_lock(&lock);
+    if (fits(player, o))
+        add(player, o);
+    else
+        flush(player, &o);
+    pthread_mutex_unlock(&lock);
+}
+
+void CoalescingPlayer::receive_player_no_stats(int i, octetStream& o) const
+{
+    // the other side might wait for pending messages
+    pthread_mutex_lock(&lock);
+    flush_all();
+    pthread_mutex_unlock(&lock);
+    PlainPlayer::receive_player_no_stats(i, o);
+}
+
+size_t CoalescingPlayer::send_no_stats(int player, const PlayerBuffer& buffer,
+        bool block) const
+{
+    pthread_mutex_lock(&lock);
+    flush_all();
+    pthread_mutex_unlock(&lock);
+    return PlainPlayer::send_no_stats(player, buffer, block);
+}
+
+size_t CoalescingPlayer::recv_no_stats(int player, const PlayerBuffer& buffer,
+        bool block) const
+{
+    pthread_mutex_lock(&lock);
+    flush_all();
+    pthread_mutex_unlock(&lock);
+    return PlainPlayer::recv_no_stats(player, buffer, block);
+}
+
+void CoalescingPlayer::exchange_no_stats(int other,
+        const octetStream& to_send, octetStream& to_receive) const
+{
+    // blocking on sending is only safe for small amounts
+    pthread_mutex_lock(&lock);
+    bool small = &to_send != &to_receive and fits(other, to_send);
+    if (small)
+        add(other, to_send);
+    flush_all();
+    pthread_mutex_unlock(&lock);
+
+    if (small)
+        PlainPlayer::receive_player_no_stats(other, to_receive);
+    else
+        PlainPlayer::exchange_no_stats(other, to_send, to_receive);
+}
+
+void CoalescingPlayer::pass_around_no_stats(const octetStream& to_send,
+        octetStream& to_receive, int offset) const
+{
+    pthread_mutex_lock(&lock);
+    bool small = &to_send != &to_receive
+            and fits(get_player(offset), to_send);
+    if (small)
+        add(get_player(offset), to_send);
+    flush_all();
+    pthread_mutex_unlock(&lock);
+
+    if (small)
+        PlainPlayer::receive_player_no_stats(get_player(-offset), to_receive);
+    else
+        PlainPlayer::pass_around_no_stats(to_send, to_receive, offset);
+}
+
+void CoalescingPlayer::Broadcast_Receive_no_stats(vector<octetStream>& o) const
+{
+    if (o.size() != size_t(num_players()))
+        throw runtime_error("player numbers don't match");
+
+    pthread_mutex_lock(&lock);
+    bool small = true;
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+            small &= fits(i, o[my_num()]);
+    if (small)
+        for (int i = 0; i < num_players(); i++)
+            if (i != my_num())
+                add(i, o[my_num()]);
+    flush_all();
+    pthread_mutex_unlock(&lock);
+
+    if (small)
+    {
+        for (int i = 0; i < num_players(); i++)
+            if (i != my_num())
+                PlainPlayer::receive_player_no_stats(i, o[i]);
+    }
+    else
+        PlainPlayer::Broadcast_Receive_no_stats(o);
+}
+
+void CoalescingPlayer::send_receive_all_no_stats(
+        const vector<vector<bool>>& channels, const vector<octetStream>& to_send,
+        vector<octetStream>& to_receive) const
+{
+    pthread_mutex_lock(&lock);
+    bool small = true;
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num() and channels[my_num()][i])
+            small &= fits(i, to_send[i]);
+    if (small)
+        for (int i = 0; i < num_players(); i++)
+            if (i != my_num() and channels[my_num()][i])
+                add(i, to_send[i]);
+    flush_all();
+    pthread_mutex_unlock(&lock);
+
+    if (small)
+    {
+        to_receive.resize(num_players());
+        for (int i = 0; i < num_players(); i++)
+            if (i != my_num() and channels[i][my_num()])
+                PlainPlayer::receive_player_no_stats(i, to_receive[i]);
+    }
+    else
+        PlainPlayer::send_receive_all_no_stats(channels, to_send, to_receive);
+}
@@ -0,0 +1,83 @@
+/*
+ * CoalescingPlayer.h
+ *
+ */
+
+#ifndef NETWORKING_COALESCINGPLAYER_H_
+#define NETWORKING_COALESCINGPLAYER_H_
+
+#include "Player.h"
+
+#include <pthread.h>
+
+/**
+ * Plaintext multi-player communication that buffers small outgoing
+ * messages for a limited time and sends them together.
+ * The buffers are flushed before receiving anything, after the time
+ * budget, or when exceeding a size limit, so the behaviour stays the
+ * same as with :cpp:class:`PlainPlayer` apart from timing.
+ */
+class CoalescingPlayer : public PlainPlayer
+{
+    // small enough to fit into socket buffers on both sides
+    static const size_t SIZE_LIMIT = 1 << 14;
+
+    long budget;
+
+    mutable vector<octetStream> pending;
+    mutable vector<int> n_pending;
+
+    // flushes by size class (log2 of bytes) and number of messages
+    mutable vector<vector<pair<size_t, size_t>>> histogram;
+
+    mutable pthread_mutex_t lock;
+    mutable pthread_cond_t cond;
+    mutable timespec deadline;
+    mutable bool have_deadline;
+    bool running;
+    pthread_t flusher;
+
+    static void* run_flusher(void* player);
+    void flush_in_background();
+
+    void flush(int player, const octetStream* last = 0) const;
+    void flush_all() const;
+    bool fits(int player, const octetStream& o) const;
+    void add(int player, const octetStream& o) const;
+
+public:
+    /// Microseconds to wait for more messages by default
+    static const long DEFAULT_BUDGET = 50;
+
+    /**
+     * Start a new set of unencrypted connections.
+     * @param Nms network setup
+     * @param id unique identifier
+     * @param budget microseconds a message may be held back
+     */
+    CoalescingPlayer(const Names& Nms, const string& id,
+            long budget = DEFAULT_BUDGET);
+    ~CoalescingPlayer();
+
+    /// Output the amounts sent together per other party
+    void print_histogram() const;
+
+    void send_to_no_stats(int player, const octetStream& o) const;
+    void receive_player_no_stats(int i, octetStream& o) const;
+
+    size_t send_no_stats(int player, const PlayerBuffer& buffer,
+            bool block) const;
+    size_t recv_no_stats(int player, const PlayerBuffer& buffer,
+            bool block) const;
+
+    void exchange_no_stats(int other, const octetStream& to_send,
+            octetStream& to_receive) const;
+    void pass_around_no_stats(const octetStream& to_send,
+            octetStream& to_receive, int offset) const;
+    void Broadcast_Receive_no_stats(vector<octetStream>& o) const;
+    void send_receive_all_no_stats(const vector<vector<bool>>& channels,
+            const vector<octetStream>& to_send,
+            vector<octetStream>& to_receive) const;
+};
+
+#endif /* NETWORKING_COALESCINGPLAYER_H_ */
@@ -6,6 +6,9 @@
 #include "CryptoPlayer.h"
 #include "Math/Setup.h"
 #include "Tools/Bundle.h"
+#include "Processor/OnlineOptions.h"
+
+#include <thread>
 
 void check_ssl_file(string filename)
 {
@@ -63,13 +66,31 @@ CryptoPlayer::CryptoPlayer(const Names& Nms, const string& id_base) :
 
     vector<int> plaintext_sockets[2];
 
-    for (int i = 0; i < 2; i++)
-    {
+    // both directions at once to save a round of connection setup
+    auto connect_plain = [&](int i) {
         PlainPlayer player(Nms, id_base + (i ? "recv" : ""));
         plaintext_sockets[i] = player.sockets;
         close_client_socket(player.socket(my_num()));
         player.sockets.clear();
-    }
+    };
+
+    exception_ptr errors[2];
+    auto try_connect = [&](int i) {
+        try
+        {
+            connect_plain(i);
+        }
+        catch (...)
+        {
+            errors[i] = current_exception();
+        }
+    };
+    thread recv_thread(try_connect, 1);
+    try_connect(0);
+    recv_thread.join();
+    for (auto& e : errors)
+        if (e)
+            rethrow_exception(e);
 
     for (int offset = 1; offset <= num_players() / 2; offset++)
     {
@@ -100,6 +121,24 @@ CryptoPlayer::CryptoPlayer(const Names& Nms, const string& id_base) :
         receivers[i] = new Receiver<ssl_socket*>(
                 i < my_num() ? other_sockets[i] : sockets[i], i);
     }
+
+    if (OnlineOptions::singleton.has_option("ktls"))
+    {
+        int n_offloaded = 0;
+        for (int i = 0; i < num_players(); i++)
+            if (i != my_num())
+                n_offloaded += senders[i]->get_socket()->offloaded_send()
+                        + receivers[i]->get_socket()->offloaded_receive();
+
+        static bool warned = false;
+        if (n_offloaded < 2 * (num_players() - 1) and not warned)
+        {
+            cerr << "Kernel TLS not available for all connections, "
+                    "falling back to OpenSSL. Make sure that the tls "
+                    "module is loaded ('modprobe tls')." << endl;
+            warned = true;
+        }
+    }
 }
 
 void CryptoPlayer::connect(int i, vector<int>* plaintext_sockets)
@@ -109,6 +148,29 @@ void CryptoPlayer::connect(int i, vector<int>* plaintext_sockets)
     other_sockets[i] = new ssl_socket(io_service, ctx, plaintext_sockets[1][i],
             "P" + to_string(i), "P" + to_string(my_num()), i < my_num());
 
+    if (OnlineOptions::singleton.has_option("ktls"))
+    {
+        // both sides use the opposite directions in the same order
+        offload(sockets[i], i < my_num());
+        offload(other_sockets[i], i > my_num());
+    }
+}
+
+void CryptoPlayer::offload(ssl_socket* socket, bool sending)
+{
+    // OpenSSL must not read any data meant for the kernel,
+    // so the receiver signals that it's ready
+    octet ready = 0;
+    if (sending)
+    {
+        boost::asio::read(*socket, boost::asio::buffer(&ready, 1));
+        socket->offload(true);
+    }
+    else
+    {
+        socket->offload(false);
+        boost::asio::write(*socket, boost::asio::buffer(&ready, 1));
+    }
 }
 
 CryptoPlayer::CryptoPlayer(const Names& Nms, int id_base) :
@@ -134,6 +196,32 @@ void CryptoPlayer::send_to_no_stats(int other, const octetStream& o) const
     senders[other]->wait(o);
 }
 
+void CryptoPlayer::request_send(int other, const octetStream& o) const
+{
+    assert(other != my_num());
+    comm_stats["Sending directly"].add(o);
+    sent += o.get_length();
+    senders[other]->request(o);
+}
+
+void CryptoPlayer::wait_send(int other, const octetStream& o) const
+{
+    senders[other]->wait(o);
+}
+
+void CryptoPlayer::request_receive(int other, octetStream& o) const
+{
+    assert(other != my_num());
+    receivers[other]->request(o);
+}
+
+void CryptoPlayer::wait_receive(int other, octetStream& o) const
+{
+    TimeScope ts(timer);
+    receivers[other]->wait(o);
+    comm_stats["Receiving directly"].add(o, ts);
+}
+
 void CryptoPlayer::receive_player_no_stats(int other, octetStream& o) const
 {
     assert(other != my_num());
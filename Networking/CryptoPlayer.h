@@ -17,6 +17,8 @@
  * Uses OpenSSL and certificates issued to "P<player_no>".
  * Sending and receiving is done in separate threads to allow
  * for bidirectional communication.
+ * With ``-o ktls``, encryption is offloaded to the kernel
+ * where possible (Linux with TLS module).
  */
 class CryptoPlayer : public MultiPlayer<ssl_socket*>
 {
@@ -29,6 +31,7 @@ class CryptoPlayer : public MultiPlayer<ssl_socket*>
     vector<Receiver<ssl_socket*>*> receivers;
 
     void connect(int other, vector<int>* plaintext_sockets);
+    void offload(ssl_socket* socket, bool sending);
 
 public:
     /**
@@ -42,6 +45,12 @@ public:
     ~CryptoPlayer();
 
     bool is_encrypted() { return true; }
+    bool is_full_duplex() const { return true; }
+
+    void request_send(int other, const octetStream& o) const;
+    void wait_send(int other, const octetStream& o) const;
+    void request_receive(int other, octetStream& o) const;
+    void wait_receive(int other, octetStream& o) const;
 
     void send_to_no_stats(int other, const octetStream& o) const;
     void receive_player_no_stats(int other, octetStream& o) const;
@@ -25,9 +25,18 @@ class Exchanger
     size_t len;
     octet* data;
 
+    // length header to be sent together with the data
+    octet header[LENGTH_SIZE];
+    size_t header_sent;
+
     Timer recv_timer;
     Timer send_timer;
 
+    bool sending()
+    {
+        return header_sent < LENGTH_SIZE or sent < len;
+    }
+
 public:
     Exchanger(T send_socket, const octetStream& send_stream, T receive_socket,
             octetStream& receive_stream) :
@@ -36,7 +45,8 @@ public:
     {
         len = send_stream.get_length();
         data = send_stream.get_data();
-        send(send_socket, len, LENGTH_SIZE);
+        encode_length(header, len, LENGTH_SIZE);
+        header_sent = 0;
         sent = 0;
         received = 0;
         length_received = false;
@@ -60,22 +70,24 @@ public:
     bool round(bool block = true)
     {
         n_iter++;
-        if (sent < len)
+        if (sending())
         {
 #ifdef TIME_ROUNDS
                 TimeScope ts(send_timer);
       #endif
             n_send++;
-            size_t to_send = len - sent;
-#ifdef __APPLE__
-            to_send = min(to_send, 1ul << 16);
-#endif
-            size_t newly_sent = send_non_blocking(send_socket, data + sent,
-                    to_send);
+            struct iovec iov[2];
+            int n_iov = 0;
+            if (header_sent < LENGTH_SIZE)
+                iov[n_iov++] = {header + header_sent, LENGTH_SIZE - header_sent};
+            iov[n_iov++] = {data + sent, len - sent};
+            size_t newly_sent = send_non_blocking(send_socket, iov, n_iov);
 #ifdef TIME_ROUNDS
-                cout << "sent " << newly_sent << "/" << to_send << endl;
+                cout << "sent " << newly_sent << "/" << len - sent << endl;
       #endif
-            sent += newly_sent;
+            size_t header_part = min(newly_sent, LENGTH_SIZE - header_sent);
+            header_sent += header_part;
+            sent += newly_sent - header_part;
         }
 
         // avoid extra branching, false before length received
@@ -94,7 +106,7 @@ public:
 #ifdef TIME_ROUNDS
                     TimeScope ts(recv_timer);
       #endif
-                if (sent < len or not block)
+                if (sending() or not block)
                 {
                     size_t newly_received = receive_non_blocking(receive_socket,
                             receive_stream.data + received, to_receive);
@@ -118,7 +130,7 @@ public:
       #endif
             octet blen[LENGTH_SIZE];
             size_t tmp = LENGTH_SIZE;
-            if (sent < len or not block)
+            if (sending() or not block)
                 tmp = receive_all_or_nothing(receive_socket, blen, LENGTH_SIZE);
             else
                 receive(receive_socket, blen, LENGTH_SIZE);
@@ -130,7 +142,7 @@ public:
             }
         }
 
-        return (received < new_len or sent < len or not length_received);
+        return (received < new_len or sending() or not length_received);
     }
 };
 
@@ -0,0 +1,321 @@
+/*
+ * IoUringPlayer.cpp
+ *
+ */
+
+#include "IoUringPlayer.h"
+#include "Tools/Exceptions.h"
+
+#ifdef USE_IO_URING
+#include <liburing.h>
+
+class IoUringPlayer::Batch
+{
+    struct Operation
+    {
+        int socket;
+        const octetStream* to_send;
+        octetStream* to_receive;
+        octet header[LENGTH_SIZE];
+        size_t header_done, length, done;
+        octet* data;
+        bool in_flight;
+        struct iovec iov[2];
+        struct msghdr msg;
+
+        bool finished()
+        {
+            return header_done == LENGTH_SIZE and done == length;
+        }
+    };
+
+    io_uring ring;
+    vector<Operation> operations;
+    size_t n_in_flight;
+
+    io_uring_sqe* get_sqe();
+    void submit(Operation& op);
+    void advance(Operation& op, size_t n);
+    void process();
+    void cancel();
+
+public:
+    Batch(int depth) :
+            n_in_flight(0)
+    {
+        int res = io_uring_queue_init(depth, &ring, 0);
+        if (res < 0)
+            throw runtime_error(
+                    string("cannot set up io_uring: ") + strerror(-res));
+    }
+
+    ~Batch()
+    {
+        io_uring_queue_exit(&ring);
+    }
+
+    void add_send(int socket, const octetStream& os)
+    {
+        operations.push_back({});
+        auto& op = operations.back();
+        op.socket = socket;
+        op.to_send = &os;
+        op.length = os.get_length();
+        op.data = os.get_data();
+        encode_length(op.header, op.length, LENGTH_SIZE);
+    }
+
+    void add_receive(int socket, octetStream& os)
+    {
+        operations.push_back({});
+        auto& op = operations.back();
+        op.socket = socket;
+        op.to_receive = &os;
+    }
+
+    void run();
+};
+
+io_uring_sqe* IoUringPlayer::Batch::get_sqe()
+{
+    auto sqe = io_uring_get_sqe(&ring);
+    if (not sqe)
+    {
+        io_uring_submit(&ring);
+        sqe = io_uring_get_sqe(&ring);
+        assert(sqe);
+    }
+    return sqe;
+}
+
+void IoUringPlayer::Batch::submit(Operation& op)
+{
+    auto sqe = get_sqe();
+
+    // the header has to be received first to know the length
+    int n_iov = 0;
+    if (op.header_done < LENGTH_SIZE)
+        op.iov[n_iov++] = {op.header + op.header_done,
+                LENGTH_SIZE - op.header_done};
+    if (op.to_send or op.header_done == LENGTH_SIZE)
+        op.iov[n_iov++] = {op.data + op.done, op.length - op.done};
+
+    memset(&op.msg, 0, sizeof(op.msg));
+    op.msg.msg_iov = op.iov;
+    op.msg.msg_iovlen = n_iov;
+    if (op.to_send)
+        io_uring_prep_sendmsg(sqe, op.socket, &op.msg, 0);
+    else
+        io_uring_prep_recvmsg(sqe, op.socket, &op.msg, 0);
+    io_uring_sqe_set_data(sqe, &op);
+    op.in_flight = true;
+    n_in_flight++;
+}
+
+void IoUringPlayer::Batch::advance(Operation& op, size_t n)
+{
+    size_t header_part = min(n, LENGTH_SIZE - op.header_done);
+    op.header_done += header_part;
+    op.done += n - header_part;
+    if (op.to_receive and header_part
+            and op.header_done == LENGTH_SIZE)
+    {
+        op.length = decode_length(op.header, LENGTH_SIZE);
+        op.to_receive->reset_write_head();
+        op.data = op.to_receive->append(op.length);
+    }
+}
+
+void IoUringPlayer::Batch::run()
+{
+    try
+    {
+        process();
+    }
+    catch (...)
+    {
+        // the kernel might still access the operations
+        cancel();
+        operations.clear();
+        throw;
+    }
+
+    for (auto& op : operations)
+        if (op.to_receive)
+            op.to_receive->reset_read_head();
+    operations.clear();
+}
+
+void IoUringPlayer::Batch::process()
+{
+    for (auto& op : operations)
+        submit(op);
+    io_uring_submit(&ring);
+
+    size_t n_outstanding = operations.size();
+    while (n_outstanding)
+    {
+        io_uring_cqe* cqe;
+        int res = io_uring_wait_cqe(&ring, &cqe);
+        if (res == -EINTR)
+            continue;
+        if (res < 0)
+            throw runtime_error(string("io_uring: ") + strerror(-res));
+        auto op_ptr = (Operation*) io_uring_cqe_get_data(cqe);
+        res = cqe->res;
+        io_uring_cqe_seen(&ring, cqe);
+
+        // cancellations don't refer to an operation
+        if (not op_ptr)
+            continue;
+        auto& op = *op_ptr;
+        op.in_flight = false;
+        n_in_flight--;
+
+        if (res < 0)
+        {
+            if (res != -EINTR and res != -EAGAIN)
+            {
+                errno = -res;
+                error(op.to_send ? "Sending error" : "Receiving error", true);
+            }
+        }
+        else if (res == 0 and op.to_receive)
+            throw closed_connection();
+        else
+            advance(op, res);
+
+        if (op.finished())
+            n_outstanding--;
+        else
+        {
+            submit(op);
+            io_uring_submit(&ring);
+        }
+    }
+}
+
+void IoUringPlayer::Batch::cancel()
+{
+    for (auto& op : operations)
+        if (op.in_flight)
+        {
+            auto sqe = get_sqe();
+            io_uring_prep_cancel(sqe, &op, 0);
+            io_uring_sqe_set_data(sqe, 0);
+        }
+    io_uring_submit(&ring);
+
+    // wait for all completions, cancelled or not, so that they
+    // don't show up in the next batch
+    while (n_in_flight)
+    {
+        io_uring_cqe* cqe;
+        int res = io_uring_wait_cqe(&ring, &cqe);
+        if (res == -EINTR)
+            continue;
+        if (res < 0)
+            break;
+        auto op = (Operation*) io_uring_cqe_get_data(cqe);
+        if (op)
+        {
+            op->in_flight = false;
+            n_in_flight--;
+        }
+        io_uring_cqe_seen(&ring, cqe);
+    }
+
+    // cancellation results
+    io_uring_cqe* cqe;
+    while (io_uring_peek_cqe(&ring, &cqe) == 0)
+        io_uring_cqe_seen(&ring, cqe);
+}
+
+bool IoUringPlayer::available()
+{
+    return true;
+}
+
+#else
+
+class IoUringPlayer::Batch
+{
+public:
+    Batch(int)
+    {
+        throw runtime_error("compile with USE_IO_URING for io_uring");
+    }
+
+    void add_send(int, const octetStream&) {}
+    void add_receive(int, octetStream&) {}
+    void run() {}
+};
+
+bool IoUringPlayer::available()
+{
+    return false;
+}
+
+#endif
+
+IoUringPlayer::IoUringPlayer(const Names& Nms, const string& id) :
+        PlainPlayer(Nms, id), batch(0)
+{
+    batch = new Batch(4 * num_players());
+}
+
+IoUringPlayer::~IoUringPlayer()
+{
+    delete batch;
+}
+
+void IoUringPlayer::exchange_no_stats(int other, const octetStream& to_send,
+        octetStream& to_receive) const
+{
+    // sending has to finish before overwriting
+    if (&to_send == &to_receive)
+        return PlainPlayer::exchange_no_stats(other, to_send, to_receive);
+    batch->add_send(sockets[other], to_send);
+    batch->add_receive(sockets[other], to_receive);
+    batch->run();
+}
+
+void IoUringPlayer::pass_around_no_stats(const octetStream& to_send,
+        octetStream& to_receive, int offset) const
+{
+    if (&to_send == &to_receive)
+        return PlainPlayer::pass_around_no_stats(to_send, to_receive, offset);
+    batch->add_send(sockets.at(get_player(offset)), to_send);
+    batch->add_receive(sockets.at(get_player(-offset)), to_receive);
+    batch->run();
+}
+
+void IoUringPlayer::Broadcast_Receive_no_stats(vector<octetStream>& o) const
+{
+    if (o.size() != sockets.size())
+        throw runtime_error("player numbers don't match");
+
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+        {
+            batch->add_send(sockets[i], o[my_num()]);
+            batch->add_receive(sockets[i], o[i]);
+        }
+    batch->run();
+}
+
+void IoUringPlayer::send_receive_all_no_stats(
+        const vector<vector<bool>>& channels, const vector<octetStream>& to_send,
+        vector<octetStream>& to_receive) const
+{
+    to_receive.resize(num_players());
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+        {
+            if (channels[my_num()][i])
+                batch->add_send(sockets[i], to_send[i]);
+            if (channels[i][my_num()])
+                batch->add_receive(sockets[i], to_receive[i]);
+        }
+    batch->run();
+}
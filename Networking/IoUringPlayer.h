@@ -0,0 +1,43 @@
+/*
+ * IoUringPlayer.h
+ *
+ */
+
+#ifndef NETWORKING_IOURINGPLAYER_H_
+#define NETWORKING_IOURINGPLAYER_H_
+
+#include "Player.h"
+
+/**
+ * Plaintext multi-player communication using io_uring (Linux only,
+ * compile with ``USE_IO_URING``). Rounds involving several other
+ * parties are submitted as one batch, and completions are collected
+ * with a single system call where possible.
+ */
+class IoUringPlayer : public PlainPlayer
+{
+    class Batch;
+
+    Batch* batch;
+
+    // prevent copying
+    IoUringPlayer(const IoUringPlayer& other);
+
+public:
+    /// Whether support has been compiled in
+    static bool available();
+
+    IoUringPlayer(const Names& Nms, const string& id);
+    ~IoUringPlayer();
+
+    void exchange_no_stats(int other, const octetStream& to_send,
+            octetStream& to_receive) const;
+    void pass_around_no_stats(const octetStream& to_send,
+            octetStream& to_receive, int offset) const;
+    void Broadcast_Receive_no_stats(vector<octetStream>& o) const;
+    void send_receive_all_no_stats(const vector<vector<bool>>& channels,
+            const vector<octetStream>& to_send,
+            vector<octetStream>& to_receive) const;
+};
+
+#endif /* NETWORKING_IOURINGPLAYER_H_ */
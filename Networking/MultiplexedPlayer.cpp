@@ -0,0 +1,223 @@
+/*
+ * MultiplexedPlayer.cpp
+ *
+ */
+
+#include "MultiplexedPlayer.h"
+#include "Tools/Exceptions.h"
+#include "Processor/OnlineOptions.h"
+
+// channel identifier and length
+const int FRAME_HEADER_SIZE = 8 + LENGTH_SIZE;
+
+Multiplexer& Multiplexer::get(const Names& Nms)
+{
+    ScopeLock guard(Nms.multiplexer_lock);
+    if (not Nms.multiplexer)
+        Nms.multiplexer = new Multiplexer(Nms);
+    return *Nms.multiplexer;
+}
+
+uint64_t Multiplexer::channel_id(const string& id)
+{
+    // FNV-1a, independent of the platform
+    uint64_t res = 0xcbf29ce484222325;
+    for (unsigned char c : id)
+    {
+        res ^= c;
+        res *= 0x100000001b3;
+    }
+    return res;
+}
+
+void* Multiplexer::run_thread(void* peer)
+{
+    auto& p = *(Peer*) peer;
+    p.multiplexer->run(p.player);
+    return 0;
+}
+
+Multiplexer::Multiplexer(const Names& Nms) :
+        PlainPlayer(Nms, "multiplex"), stopping(false)
+{
+    max_bytes = stoull(
+            OnlineOptions::singleton.option_value("multiplex_buffer", "256"))
+            << 20;
+    peers.resize(num_players());
+    for (int i = 0; i < num_players(); i++)
+    {
+        if (i == my_num())
+            continue;
+        // idle channels are normal
+        struct timeval tv = {0, 0};
+        if (setsockopt(sockets[i], SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)))
+            error("Multiplexer:setsockopt");
+        peers[i].reset(new Peer);
+        peers[i]->multiplexer = this;
+        peers[i]->player = i;
+        pthread_create(&peers[i]->thread, 0, run_thread, peers[i].get());
+    }
+}
+
+Multiplexer::~Multiplexer()
+{
+    {
+        lock_guard<mutex> guard(channels_lock);
+        stopping = true;
+    }
+    space.notify_all();
+    for (auto& peer : peers)
+        if (peer)
+        {
+            shutdown(sockets[peer->player], SHUT_RDWR);
+            pthread_join(peer->thread, 0);
+        }
+    for (auto& channel : channels)
+    {
+        channel.second->queue.stop();
+        octetStream* os;
+        while (channel.second->queue.pop_dont_stop(os))
+            delete os;
+    }
+}
+
+Multiplexer::Channel& Multiplexer::get_channel(int player, uint64_t channel)
+{
+    lock_guard<mutex> guard(channels_lock);
+    auto& res = channels[{player, channel}];
+    if (not res)
+    {
+        res.reset(new Channel);
+        if (closed.count(player))
+            res->queue.stop();
+    }
+    return *res;
+}
+
+void Multiplexer::run(int player)
+{
+    int socket = sockets[player];
+    try
+    {
+        while (true)
+        {
+            octet header[FRAME_HEADER_SIZE];
+            ::receive(socket, header, FRAME_HEADER_SIZE);
+            uint64_t channel = decode_length(header, 8);
+            size_t length = decode_length(header + 8, LENGTH_SIZE);
+            auto os = new octetStream;
+            ::receive(socket, os->append(length), length);
+            auto& queue = get_channel(player, channel);
+            {
+                // stall this connection instead of buffering without limit
+                unique_lock<mutex> lock(channels_lock);
+                space.wait(lock, [&]() {
+                    return queue.n_bytes < max_bytes or stopping; });
+                queue.n_bytes += length;
+            }
+            queue.queue.push(os);
+        }
+    }
+    catch (closed_connection&)
+    {
+        if (OnlineOptions::singleton.has_option("debug_networking"))
+            cerr << "multiplexed connection to " << player << " closed" << endl;
+    }
+
+    // let waiting receivers fail
+    lock_guard<mutex> guard(channels_lock);
+    closed.insert(player);
+    for (auto& channel : channels)
+        if (channel.first.first == player)
+            channel.second->queue.stop();
+}
+
+void Multiplexer::send(int player, uint64_t channel, const octetStream& os)
+{
+    if (player == my_num())
+    {
+        get_channel(player, channel).queue.push(new octetStream(os));
+        return;
+    }
+
+    octet header[FRAME_HEADER_SIZE];
+    encode_length(header, channel, 8);
+    encode_length(header + 8, os.get_length(), LENGTH_SIZE);
+    struct iovec iov[] = {{header, FRAME_HEADER_SIZE},
+            {os.get_data(), os.get_length()}};
+    int socket = sockets[player];
+    lock_guard<mutex> guard(peers[player]->send_lock);
+    ::send(socket, iov, 2);
+}
+
+void Multiplexer::receive(int player, uint64_t channel, octetStream& os)
+{
+    octetStream* received;
+    auto& queue = get_channel(player, channel);
+    if (not queue.queue.pop_dont_stop(received))
+        throw closed_connection();
+    unique_ptr<octetStream> owned(received);
+    if (player != my_num())
+    {
+        lock_guard<mutex> guard(channels_lock);
+        queue.n_bytes -= owned->get_length();
+        space.notify_all();
+    }
+    os.swap(*owned);
+}
+
+MultiplexedPlayer::MultiplexedPlayer(const Names& Nms, const string& id) :
+        Player(Nms), id(id), channel(Multiplexer::channel_id(id)),
+        multiplexer(Multiplexer::get(Nms))
+{
+}
+
+void MultiplexedPlayer::send_to_no_stats(int player, const octetStream& o) const
+{
+    multiplexer.send(player, channel, o);
+}
+
+void MultiplexedPlayer::receive_player_no_stats(int i, octetStream& o) const
+{
+    multiplexer.receive(i, channel, o);
+}
+
+void MultiplexedPlayer::exchange_no_stats(int other, const octetStream& to_send,
+        octetStream& to_receive) const
+{
+    // sending cannot block because receiving happens in the background
+    send_to_no_stats(other, to_send);
+    receive_player_no_stats(other, to_receive);
+}
+
+void MultiplexedPlayer::pass_around_no_stats(const octetStream& to_send,
+        octetStream& to_receive, int offset) const
+{
+    send_to_no_stats(get_player(offset), to_send);
+    receive_player_no_stats(get_player(-offset), to_receive);
+}
+
+void MultiplexedPlayer::Broadcast_Receive_no_stats(vector<octetStream>& o) const
+{
+    if (o.size() != size_t(num_players()))
+        throw runtime_error("player numbers don't match");
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+            send_to_no_stats(i, o[my_num()]);
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+            receive_player_no_stats(i, o[i]);
+}
+
+void MultiplexedPlayer::send_receive_all_no_stats(
+        const vector<vector<bool>>& channels, const vector<octetStream>& to_send,
+        vector<octetStream>& to_receive) const
+{
+    to_receive.resize(num_players());
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num() and channels[my_num()][i])
+            send_to_no_stats(i, to_send[i]);
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num() and channels[i][my_num()])
+            receive_player_no_stats(i, to_receive[i]);
+}
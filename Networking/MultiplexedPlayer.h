@@ -0,0 +1,99 @@
+/*
+ * MultiplexedPlayer.h
+ *
+ */
+
+#ifndef NETWORKING_MULTIPLEXEDPLAYER_H_
+#define NETWORKING_MULTIPLEXEDPLAYER_H_
+
+#include "Player.h"
+#include "Tools/WaitQueue.h"
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+/**
+ * One connection per pair of parties shared by all threads.
+ * Messages are framed with a channel identifier, and a thread per
+ * other party distributes incoming messages to the channels.
+ */
+class Multiplexer : public PlainPlayer
+{
+    struct Peer
+    {
+        Multiplexer* multiplexer;
+        int player;
+        mutex send_lock;
+        pthread_t thread;
+    };
+
+    struct Channel
+    {
+        WaitQueue<octetStream*> queue;
+        // received but not consumed yet
+        size_t n_bytes = 0;
+    };
+
+    vector<unique_ptr<Peer>> peers;
+
+    mutex channels_lock;
+    map<pair<int, uint64_t>, unique_ptr<Channel>> channels;
+    set<int> closed;
+
+    // receiving threads wait for channels above the bound
+    condition_variable space;
+    size_t max_bytes;
+    bool stopping;
+
+    static void* run_thread(void* peer);
+
+    void run(int player);
+    Channel& get_channel(int player, uint64_t channel);
+
+public:
+    /// Shared instance for network setup, destroyed with the latter
+    static Multiplexer& get(const Names& Nms);
+
+    static uint64_t channel_id(const string& id);
+
+    Multiplexer(const Names& Nms);
+    ~Multiplexer();
+
+    void send(int player, uint64_t channel, const octetStream& os);
+    void receive(int player, uint64_t channel, octetStream& os);
+};
+
+/**
+ * Plaintext multi-player communication via a logical channel
+ * of the shared connections in :cpp:class:`Multiplexer`.
+ * Receiving happens in the background, so sending never blocks
+ * on the other side.
+ */
+class MultiplexedPlayer : public Player
+{
+    string id;
+    uint64_t channel;
+    Multiplexer& multiplexer;
+
+public:
+    MultiplexedPlayer(const Names& Nms, const string& id);
+
+    string get_id() const { return id; }
+
+    void send_to_no_stats(int player, const octetStream& o) const;
+    void receive_player_no_stats(int i, octetStream& o) const;
+
+    void exchange_no_stats(int other, const octetStream& to_send,
+            octetStream& to_receive) const;
+    void pass_around_no_stats(const octetStream& to_send,
+            octetStream& to_receive, int offset) const;
+    void Broadcast_Receive_no_stats(vector<octetStream>& o) const;
+    void send_receive_all_no_stats(const vector<vector<bool>>& channels,
+            const vector<octetStream>& to_send,
+            vector<octetStream>& to_receive) const;
+};
+
+#endif /* NETWORKING_MULTIPLEXEDPLAYER_H_ */
@@ -0,0 +1,79 @@
+/*
+ * NetworkProbe.cpp
+ *
+ */
+
+#include "NetworkProbe.h"
+
+#include <string.h>
+
+void NetworkProbe::run(const Player& P, int n_pings, size_t n_bytes)
+{
+    int n = P.num_players();
+    rtt.clear();
+    bandwidth.clear();
+    rtt.resize(n);
+    bandwidth.resize(n);
+
+    octetStream small, large, received;
+    small.store(0);
+    memset(large.append(n_bytes), 0, n_bytes);
+
+    // same order of pairs everywhere to avoid deadlocks
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+        {
+            int other;
+            if (i == P.my_num())
+                other = j;
+            else if (j == P.my_num())
+                other = i;
+            else
+                continue;
+
+            Timer timer;
+            timer.start();
+            for (int k = 0; k < n_pings; k++)
+                P.exchange_no_stats(other, small, received);
+            rtt[other] = timer.elapsed() / n_pings;
+
+            Timer bulk_timer;
+            bulk_timer.start();
+            P.exchange_no_stats(other, large, received);
+            bandwidth[other] = n_bytes
+                    / max(bulk_timer.elapsed() - rtt[other], 1e-9);
+        }
+
+    max_rtt = 0;
+    min_bandwidth = 0;
+    for (int i = 0; i < n; i++)
+        if (i != P.my_num())
+        {
+            max_rtt = max(max_rtt, rtt[i]);
+            if (min_bandwidth == 0 or bandwidth[i] < min_bandwidth)
+                min_bandwidth = bandwidth[i];
+        }
+
+    // nanoseconds and bytes per second are precise enough
+    vector<octetStream> os(n);
+    os[P.my_num()].store(size_t(max_rtt * 1e9));
+    os[P.my_num()].store(size_t(min_bandwidth));
+    P.Broadcast_Receive_no_stats(os);
+    for (int i = 0; i < n; i++)
+        if (i != P.my_num())
+        {
+            max_rtt = max(max_rtt, os[i].get_int(8) * 1e-9);
+            min_bandwidth = min(min_bandwidth, double(os[i].get_int(8)));
+        }
+}
+
+void NetworkProbe::print(const Player& P) const
+{
+    for (int i = 0; i < P.num_players(); i++)
+        if (i != P.my_num())
+            cerr << "Link to party " << i << ": " << rtt[i] * 1e3
+                    << " ms round trip, " << bandwidth[i] * 8e-6 << " Mbit/s"
+                    << endl;
+    cerr << "Slowest link overall: " << max_rtt * 1e3 << " ms round trip, "
+            << min_bandwidth * 8e-6 << " Mbit/s" << endl;
+}
@@ -0,0 +1,47 @@
+/*
+ * NetworkProbe.h
+ *
+ */
+
+#ifndef NETWORKING_NETWORKPROBE_H_
+#define NETWORKING_NETWORKPROBE_H_
+
+#include "Player.h"
+
+/**
+ * Round-trip time and bandwidth to every other party.
+ * The parties measure pairwise in the same order and then agree on the
+ * worst values, so that anything derived from the latter is consistent.
+ */
+class NetworkProbe
+{
+public:
+    /// Seconds per round trip and bytes per second by party
+    vector<double> rtt, bandwidth;
+
+    /// Worst values among all links, the same on all parties
+    double max_rtt, min_bandwidth;
+
+    NetworkProbe() :
+            max_rtt(0), min_bandwidth(0)
+    {
+    }
+
+    /**
+     * Measure links to all other parties
+     * @param P communication without statistics
+     * @param n_pings round trips per party
+     * @param n_bytes bytes to exchange for the bandwidth
+     */
+    void run(const Player& P, int n_pings = 10, size_t n_bytes = 1 << 22);
+
+    /// Bytes in flight on the slowest link
+    double bandwidth_delay_product() const
+    {
+        return max_rtt * min_bandwidth;
+    }
+
+    void print(const Player& P) const;
+};
+
+#endif /* NETWORKING_NETWORKPROBE_H_ */
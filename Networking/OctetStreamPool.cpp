@@ -0,0 +1,43 @@
+/*
+ * OctetStreamPool.cpp
+ *
+ */
+
+#include "OctetStreamPool.h"
+
+atomic<size_t> OctetStreamPool::total_hits, OctetStreamPool::total_misses;
+
+void OctetStreamPool::take(octetStream& os)
+{
+    if (free.empty())
+    {
+        misses++;
+        total_misses.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    hits++;
+    total_hits.fetch_add(1, memory_order_relaxed);
+    os.swap(free.back());
+    free.pop_back();
+}
+
+void OctetStreamPool::give(octetStream& os)
+{
+    if (os.get_max_length() == 0 or free.size() >= MAX_FREE)
+        return;
+
+    if (free.capacity() == 0)
+        free.reserve(MAX_FREE);
+    os.reset_write_head();
+    free.emplace_back();
+    free.back().swap(os);
+}
+
+void OctetStreamPool::print_stats(ostream& out)
+{
+    size_t hits = total_hits, all = hits + total_misses;
+    if (all)
+        out << "Stream pool hit rate: " << 100. * hits / all << "% (" << hits
+                << " of " << all << ")" << endl;
+}
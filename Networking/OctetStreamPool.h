@@ -0,0 +1,67 @@
+/*
+ * OctetStreamPool.h
+ *
+ */
+
+#ifndef NETWORKING_OCTETSTREAMPOOL_H_
+#define NETWORKING_OCTETSTREAMPOOL_H_
+
+#include "Tools/octetStream.h"
+
+#include <vector>
+#include <atomic>
+#include <iostream>
+using namespace std;
+
+/**
+ * Buffers kept for reuse in communication rounds,
+ * one pool per player object
+ */
+class OctetStreamPool
+{
+    static atomic<size_t> total_hits, total_misses;
+
+    vector<octetStream> free;
+
+    size_t hits, misses;
+
+public:
+    static const size_t MAX_FREE = 256;
+
+    static void print_stats(ostream& out);
+
+    OctetStreamPool() : hits(0), misses(0) {}
+
+    /// Move pooled buffer into empty ``os``
+    void take(octetStream& os);
+    /// Return buffer of ``os`` to pool, leaving ``os`` empty
+    void give(octetStream& os);
+
+    size_t n_hits() const { return hits; }
+    size_t n_misses() const { return misses; }
+};
+
+/**
+ * Stream with buffer leased from a pool until destruction
+ */
+class PooledOctetStream : public octetStream
+{
+    OctetStreamPool& pool;
+
+public:
+    PooledOctetStream(OctetStreamPool& pool) :
+            pool(pool)
+    {
+        pool.take(*this);
+    }
+
+    ~PooledOctetStream()
+    {
+        pool.give(*this);
+    }
+
+    PooledOctetStream(const PooledOctetStream&) = delete;
+    PooledOctetStream& operator=(const PooledOctetStream&) = delete;
+};
+
+#endif /* NETWORKING_OCTETSTREAMPOOL_H_ */
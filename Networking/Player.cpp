@@ -7,10 +7,14 @@
 #include "Networking/Server.h"
 #include "Networking/ServerSocket.h"
 #include "Networking/Exchanger.h"
+#include "Networking/MultiplexedPlayer.h"
 #include "Processor/OnlineOptions.h"
+#include "Processor/Metrics.h"
+#include "Processor/Trace.h"
 
 #include <sys/select.h>
 #include <utility>
+#include <thread>
 #include <assert.h>
 
 using namespace std;
@@ -210,15 +214,19 @@ Names::Names(const Names& other)
   names = other.names;
   ports = other.ports;
   server = 0;
+  multiplexer = 0;
 }
 
 Names::Names(int my_num, int num_players) :
-    nplayers(num_players), portnum_base(-1), player_no(my_num), server(0)
+    nplayers(num_players), portnum_base(-1), player_no(my_num), server(0),
+    multiplexer(0)
 {
 }
 
 Names::~Names()
 {
+  if (multiplexer != 0)
+    delete multiplexer;
   if (server != 0)
     delete server;
 }
@@ -246,6 +254,17 @@ PlainPlayer::PlainPlayer(const Names& Nms, const string& id) :
 {
   if (Nms.num_players() > 1)
     setup_sockets(Nms.names, Nms.ports, id, *Nms.server);
+
+  // trade latency for fewer packets
+  if (OnlineOptions::singleton.has_option("nagle"))
+    for (int i = 0; i < num_players(); i++)
+      if (i != my_num())
+        {
+          int zero = 0;
+          if (setsockopt(sockets[i], IPPROTO_TCP, TCP_NODELAY, &zero,
+              sizeof(zero)))
+            error("PlainPlayer:setsockopt");
+        }
 }
 
 
@@ -296,8 +315,9 @@ void PlainPlayer::setup_sockets(const vector<string>& names,
         const vector<int>& ports, const string& id_base, ServerSocket& server)
 {
     sockets.resize(nplayers);
-    // Set up the client side
-    for (int i=0; i<=player_no; i++) {
+    // Set up the client side, connecting to all lower players at once
+    // because every connection might have to wait for the other side
+    auto connect_to = [&](int i) {
         auto pn=id_base+"P"+to_string(player_no);
         if (i==player_no) {
           const char* localhost = "127.0.0.1";
@@ -323,7 +343,27 @@ void PlainPlayer::setup_sockets(const vector<string>& names,
           set_up_client_socket(sockets[i],names[i].c_str(),ports[i]);
         }
         octetStream(pn).Send(sockets[i]);
-    }
+    };
+    vector<exception_ptr> errors(player_no + 1);
+    auto try_connect = [&](int i) {
+        try
+        {
+            connect_to(i);
+        }
+        catch (...)
+        {
+            errors[i] = current_exception();
+        }
+    };
+    vector<thread> threads;
+    for (int i = 0; i < player_no; i++)
+        threads.push_back(thread(try_connect, i));
+    try_connect(player_no);
+    for (auto& t : threads)
+        t.join();
+    for (auto& e : errors)
+        if (e)
+            rethrow_exception(e);
     send_to_self_socket = sockets[player_no];
     // Setting up the server side
     for (int i=player_no; i<nplayers; i++) {
@@ -370,6 +410,7 @@ void Player::send_to(int player,const octetStream& o) const
 #ifdef VERBOSE_COMM
   cerr << "sending to " << player << endl;
 #endif
+  Trace::Span span("Sending directly", Trace::COMM);
   TimeScope ts(comm_stats["Sending directly"].add(o));
   send_to_no_stats(player, o);
   sent += o.get_length();
@@ -385,6 +426,7 @@ void MultiPlayer<T>::send_to_no_stats(int player,const octetStream& o) const
 
 void Player::send_all(const octetStream& o) const
 {
+  Trace::Span span("Sending to all", Trace::COMM);
   TimeScope ts(comm_stats["Sending to all"].add(o));
   for (int i=0; i<nplayers; i++)
      { if (i!=player_no)
@@ -408,6 +450,7 @@ void Player::receive_player(int i,octetStream& o) const
 #ifdef VERBOSE_COMM
   cerr << "receiving from " << i << endl;
 #endif
+  Trace::Span span("Receiving directly", Trace::COMM);
   TimeScope ts(timer);
   receive_player_no_stats(i, o);
   comm_stats["Receiving directly"].add(o, ts);
@@ -487,6 +530,7 @@ void Player::exchange(int other, const octetStream& o, octetStream& to_receive)
 #ifdef VERBOSE_COMM
   cerr << "Exchanging with " << other << endl;
 #endif
+  Trace::Span span("Exchanging", Trace::COMM);
   TimeScope ts(comm_stats["Exchanging"].add(o));
   exchange_no_stats(other, o, to_receive);
   sent += o.get_length();
@@ -512,6 +556,7 @@ void MultiPlayer<T>::pass_around_no_stats(const octetStream& o, octetStream& to_
 
 void Player::pass_around(octetStream& o, octetStream& to_receive, int offset) const
 {
+  Trace::Span span("Passing around", Trace::COMM);
   TimeScope ts(comm_stats["Passing around"].add(o));
   pass_around_no_stats(o, to_receive, offset);
   sent += o.get_length();
@@ -546,6 +591,7 @@ void MultiPlayer<T>::Broadcast_Receive_no_stats(vector<octetStream>& o) const
 
 void Player::unchecked_broadcast(vector<octetStream>& o) const
 {
+  Trace::Span span("Broadcasting", Trace::COMM);
   TimeScope ts(comm_stats["Broadcasting"].add(o[player_no]));
   Broadcast_Receive_no_stats(o);
   sent += o[player_no].get_length() * (num_players() - 1);
@@ -554,9 +600,11 @@ void Player::unchecked_broadcast(vector<octetStream>& o) const
 void Player::Broadcast_Receive(vector<octetStream>& o) const
 {
   unchecked_broadcast(o);
-    { for (int i=0; i<nplayers; i++)
-        { hash_update(&ctx,o[i].get_data(),o[i].get_length()); }
-    }
+  // large messages are hashed in chunks (-o hash_threads)
+  static int n_threads = max(1,
+      stoi(OnlineOptions::singleton.option_value("hash_threads", "1")));
+  for (int i=0; i<nplayers; i++)
+    ctx.update_chunked(o[i], n_threads);
 }
 
 
@@ -607,6 +655,7 @@ void Player::send_receive_all(const vector<vector<bool>>& channels,
         cerr << "Send " << to_send.at(i).get_length() << " to " << i << endl;
 #endif
       }
+  Trace::Span span("Sending/receiving", Trace::COMM);
   TimeScope ts(comm_stats["Sending/receiving"].add(data));
   sent += data;
   send_receive_all_no_stats(channels, to_send, to_receive);
@@ -669,6 +718,18 @@ ThreadPlayer::~ThreadPlayer()
     }
 }
 
+void ThreadPlayer::request_send(int i, const octetStream& o) const
+{
+  comm_stats["Sending directly"].add(o);
+  sent += o.get_length();
+  senders[i]->request(o);
+}
+
+void ThreadPlayer::wait_send(int i, const octetStream& o) const
+{
+  senders[i]->wait(o);
+}
+
 void ThreadPlayer::request_receive(int i, octetStream& o) const
 {
   receivers[i]->request(o);
@@ -676,13 +737,51 @@ void ThreadPlayer::request_receive(int i, octetStream& o) const
 
 void ThreadPlayer::wait_receive(int i, octetStream& o) const
 {
+  TimeScope ts(timer);
   receivers[i]->wait(o);
+  comm_stats["Receiving directly"].add(o, ts);
+}
+
+void ThreadPlayer::send_to_no_stats(int i, const octetStream& o) const
+{
+  senders[i]->request(o);
+  senders[i]->wait(o);
 }
 
 void ThreadPlayer::receive_player_no_stats(int i, octetStream& o) const
 {
-  request_receive(i, o);
-  wait_receive(i, o);
+  receivers[i]->request(o);
+  receivers[i]->wait(o);
+}
+
+void ThreadPlayer::exchange_no_stats(int other, const octetStream& to_send,
+    octetStream& to_receive) const
+{
+  if (&to_send == &to_receive)
+    PlainPlayer::exchange_no_stats(other, to_send, to_receive);
+  else
+    {
+      senders[other]->request(to_send);
+      receivers[other]->request(to_receive);
+      senders[other]->wait(to_send);
+      receivers[other]->wait(to_receive);
+    }
+}
+
+void ThreadPlayer::pass_around_no_stats(const octetStream& to_send,
+    octetStream& to_receive, int offset) const
+{
+  if (&to_send == &to_receive)
+    PlainPlayer::pass_around_no_stats(to_send, to_receive, offset);
+  else
+    {
+      int send_to = get_player(offset);
+      int receive_from = get_player(-offset);
+      senders[send_to]->request(to_send);
+      receivers[receive_from]->request(to_receive);
+      senders[send_to]->wait(to_send);
+      receivers[receive_from]->wait(to_receive);
+    }
 }
 
 void ThreadPlayer::send_all(const octetStream& o) const
@@ -840,6 +939,8 @@ void NamedCommStats::print(bool newline, const NamedCommStats& max)
         auto time = it->second.timer.elapsed();
         cerr << it->first << " " << 1e-6 * it->second.data << " MB in "
             << it->second.rounds << " rounds, taking " << time << " seconds";
+        if (time > 0)
+          cerr << " (" << 1e-6 * it->second.data / time << " MB/s)";
         try
         {
           auto max_time = max.at(it->first).timer.elapsed();
@@ -855,6 +956,23 @@ void NamedCommStats::print(bool newline, const NamedCommStats& max)
     cerr << endl;
 }
 
+void NamedCommStats::print_json(ostream& os) const
+{
+  os << "{";
+  bool first = true;
+  for (auto& x : *this)
+    if (x.second.data or x.second.rounds)
+      {
+        if (not first)
+          os << ", ";
+        first = false;
+        os << "\"" << x.first << "\": {\"bytes\": " << x.second.data
+            << ", \"rounds\": " << x.second.rounds << ", \"seconds\": "
+            << x.second.timer.elapsed() << "}";
+      }
+  os << "}";
+}
+
 void NamedCommStats::reset()
 {
   clear();
@@ -876,6 +994,7 @@ Timer& CommStatsWithName::add_length_only(size_t length)
 {
   if (OnlineOptions::singleton.has_option("verbose_comm"))
     fprintf(stderr, "%s %zu bytes in same round\n", name.c_str(), length);
+  Metrics::count_comm(length, false);
   return stats.add_length_only(length);
 }
 
@@ -888,6 +1007,7 @@ Timer& CommStatsWithName::add(size_t length)
 {
   if (OnlineOptions::singleton.has_option("verbose_comm"))
     fprintf(stderr, "%s %zu bytes\n", name.c_str(), length);
+  Metrics::count_comm(length, true);
   return stats.add(length);
 }
 
@@ -906,5 +1026,19 @@ NamedCommStats Player::total_comm() const
   return res;
 }
 
+pair<size_t, size_t> Player::total_sent_and_rounds() const
+{
+  pair<size_t, size_t> res = {comm_stats.sent, 0};
+  for (auto& x : comm_stats)
+    res.second += x.second.rounds;
+  for (auto& stats : thread_stats)
+    {
+      res.first += stats.sent;
+      for (auto& x : stats)
+        res.second += x.second.rounds;
+    }
+  return res;
+}
+
 template class MultiPlayer<int>;
 template class MultiPlayer<ssl_socket*> ;
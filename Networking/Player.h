@@ -23,11 +23,13 @@ using namespace std;
 #include "Networking/Sender.h"
 #include "Tools/ezOptionParser.h"
 #include "Networking/PlayerBuffer.h"
+#include "Networking/OctetStreamPool.h"
 #include "Tools/Lock.h"
 
 template<class T> class MultiPlayer;
 class Server;
 class ServerSocket;
+class Multiplexer;
 
 /**
  * Network setup (hostnames and port numbers)
@@ -38,6 +40,7 @@ class Names
   friend class PlainPlayer;
   friend class RealTwoPartyPlayer;
   friend class Server;
+  friend class Multiplexer;
 
   vector<string> names;
   vector<int> ports;
@@ -47,6 +50,10 @@ class Names
 
   ServerSocket* server;
 
+  // connections shared by threads, see -o multiplex
+  mutable Multiplexer* multiplexer;
+  mutable Lock multiplexer_lock;
+
   int default_port(int playerno) { return portnum_base + playerno; }
   void setup_ports();
 
@@ -180,6 +187,7 @@ public:
   NamedCommStats operator-(const NamedCommStats& other) const;
   NamedCommStats& imax(const NamedCommStats& other);
   void print(bool newline = false, const NamedCommStats& max = {});
+  void print_json(ostream& os) const;
   void reset();
   Timer& add_to_last_round(const string& name, size_t length);
   CommStatsWithName operator[](const string& name)
@@ -203,6 +211,9 @@ protected:
 public:
   mutable Timer timer;
 
+  /// buffers for reuse across rounds
+  mutable OctetStreamPool stream_pool;
+
   PlayerBase(int player_no) : player_no(player_no), sent(comm_stats.sent) {}
   virtual ~PlayerBase();
 
@@ -398,12 +409,33 @@ public:
       const vector<bool>& receivers,
       vector<octetStream>& os) const;
 
-  // dummy functions for compatibility
+  /**
+   * Whether sending and receiving happens in separate threads,
+   * in which case the following functions return immediately
+   */
+  virtual bool is_full_duplex() const { return false; }
+
+  /**
+   * Start sending to a specific player,
+   * ``o`` must not be changed before calling ``wait_send()``
+   */
+  virtual void request_send(int i, const octetStream& o) const
+  { send_to(i, o); }
+  /**
+   * Finish sending started with ``request_send()``
+   */
+  virtual void wait_send(int i, const octetStream& o) const { (void)i; (void)o; }
+  /**
+   * Start receiving from a specific player,
+   * finish with ``wait_receive()``
+   */
   virtual void request_receive(int i, octetStream& o) const { (void)i; (void)o; }
   virtual void wait_receive(int i, octetStream& o) const
   { receive_player(i, o); }
 
   NamedCommStats total_comm() const;
+  /// Bytes sent and rounds in all threads without copying statistics
+  pair<size_t, size_t> total_sent_and_rounds() const;
   void reset_stats();
 };
 
@@ -461,7 +493,10 @@ public:
 };
 
 /**
- * Plaintext multi-player communication
+ * Plaintext multi-player communication.
+ * Sending and receiving happen in the calling thread, so
+ * ``request_send()`` and ``request_receive()`` don't overlap
+ * with local computation (see :cpp:class:`ThreadPlayer` for that).
  */
 class PlainPlayer : public MultiPlayer<int>
 {
@@ -483,7 +518,10 @@ public:
   size_t recv_no_stats(int player, const PlayerBuffer& buffer, bool block) const;
 };
 
-
+/**
+ * Plaintext multi-player communication with
+ * sending and receiving in separate threads for every other player
+ */
 class ThreadPlayer : public PlainPlayer
 {
 public:
@@ -493,10 +531,21 @@ public:
   ThreadPlayer(const Names& Nms, const string& id_base);
   virtual ~ThreadPlayer();
 
+  bool is_full_duplex() const { return true; }
+
+  void request_send(int i, const octetStream& o) const;
+  void wait_send(int i, const octetStream& o) const;
   void request_receive(int i, octetStream& o) const;
   void wait_receive(int i, octetStream& o) const;
+
+  void send_to_no_stats(int player, const octetStream& o) const;
   void receive_player_no_stats(int i,octetStream& o) const;
 
+  void exchange_no_stats(int other, const octetStream& to_send,
+      octetStream& to_receive) const;
+  void pass_around_no_stats(const octetStream& to_send,
+      octetStream& to_receive, int offset) const;
+
   void send_all(const octetStream& o) const;
 };
 
@@ -546,6 +595,8 @@ public:
 
   size_t send(const PlayerBuffer& buffer, bool block) const;
   size_t recv(const PlayerBuffer& buffer, bool block) const;
+
+  size_t total_sent() const { return comm_stats.sent; }
 };
 
 class RealTwoPartyPlayer : public VirtualTwoPartyPlayer
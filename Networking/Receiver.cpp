@@ -6,6 +6,7 @@
 #include "Receiver.h"
 #include "ssl_sockets.h"
 #include "Processor/OnlineOptions.h"
+#include "Tools/CpuAffinity.h"
 
 #include <iostream>
 using namespace std;
@@ -53,6 +54,7 @@ void Receiver<T>::stop()
 
 void CommunicationThread::run()
 {
+    CpuAffinity::pin_helper();
     if (OnlineOptions::singleton.has_option("throw_exceptions"))
         run_with_error();
     else
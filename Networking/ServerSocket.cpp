@@ -235,13 +235,19 @@ void AnonymousServerSocket::process_client(const string& client_id)
   client_connection_queue.push(client_id);
 }
 
-int AnonymousServerSocket::get_connection_socket(string& client_id)
+int AnonymousServerSocket::get_connection_socket(string& client_id,
+    int timeout)
 {
   data_signal.lock();
 
   while (client_connection_queue.empty())
   {
-      int res = data_signal.wait(CONNECTION_TIMEOUT);
+      if (timeout == 0)
+        {
+          data_signal.wait();
+          continue;
+        }
+      int res = data_signal.wait(timeout);
       if (res == ETIMEDOUT)
           exit_error("timed out while waiting for client");
       else if (res)
@@ -17,6 +17,7 @@ using namespace std;
 
 #include "Tools/WaitQueue.h"
 #include "Tools/Signal.h"
+#include "sockets.h"
 
 class ServerJob;
 
@@ -69,8 +70,10 @@ public:
         ServerSocket(Portnum) { };
     void init();
 
-    // Get socket and id for the last client who connected
-    int get_connection_socket(string& client_id);
+    // Get socket and id for the last client who connected,
+    // waiting indefinitely if timeout is zero
+    int get_connection_socket(string& client_id,
+            int timeout = CONNECTION_TIMEOUT);
 
     void remove_client(const string& client_id);
 };
@@ -0,0 +1,217 @@
+/*
+ * ShapedPlayer.cpp
+ *
+ */
+
+#include "ShapedPlayer.h"
+#include "Processor/OnlineOptions.h"
+
+bool ShapedPlayer::enabled()
+{
+    auto& opts = OnlineOptions::singleton;
+    for (auto name : {"netem_latency", "netem_jitter", "netem_bandwidth"})
+        if (not opts.option_value(name).empty())
+            return true;
+    return false;
+}
+
+double ShapedPlayer::get_value(const string& name, int other, double factor)
+{
+    // single value or one per party separated by colons
+    string value = OnlineOptions::singleton.option_value(name, "0");
+    vector<double> values;
+    stringstream ss(value);
+    string item;
+    while (getline(ss, item, ':'))
+        values.push_back(stod(item));
+    if (values.empty())
+        return 0;
+    if (values.size() == 1)
+        return values[0] * factor;
+    return values.at(other) * factor;
+}
+
+long long ShapedPlayer::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+ShapedPlayer::Link::Link(ShapedPlayer* player, int other) :
+        player(player), other(other),
+        latency(get_value("netem_latency", other, 1e-3)),
+        jitter(get_value("netem_jitter", other, 1e-3)),
+        bandwidth(get_value("netem_bandwidth", other, 1e6 / 8)),
+        // same delays in every run
+        prng(player->my_num() * player->num_players() + other),
+        free_ns(0), last_due_ns(0)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+ShapedPlayer::ShapedPlayer(const Names& Nms, const string& id) :
+        PlainPlayer(Nms, id), running(true)
+{
+    pthread_mutex_init(&lock, 0);
+    links.resize(num_players());
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+        {
+            links[i] = make_unique<Link>(this, i);
+            pthread_create(&links[i]->thread, 0, run_link, links[i].get());
+        }
+}
+
+ShapedPlayer::~ShapedPlayer()
+{
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+            drain(i);
+
+    pthread_mutex_lock(&lock);
+    running = false;
+    for (auto& link : links)
+        if (link)
+            pthread_cond_broadcast(&link->cond);
+    pthread_mutex_unlock(&lock);
+
+    for (auto& link : links)
+        if (link)
+        {
+            pthread_join(link->thread, 0);
+            pthread_cond_destroy(&link->cond);
+        }
+    pthread_mutex_destroy(&lock);
+}
+
+void* ShapedPlayer::run_link(void* link)
+{
+    auto& l = *(Link*) link;
+    l.player->send_in_background(l);
+    return 0;
+}
+
+void ShapedPlayer::send_in_background(Link& link)
+{
+    pthread_mutex_lock(&lock);
+    while (running or not link.queue.empty())
+    {
+        if (link.queue.empty())
+        {
+            pthread_cond_wait(&link.cond, &lock);
+            continue;
+        }
+
+        long long due = link.queue.front().first;
+        if (now() < due)
+        {
+            timespec deadline;
+            deadline.tv_sec = due / 1000000000;
+            deadline.tv_nsec = due % 1000000000;
+            pthread_cond_timedwait(&link.cond, &lock, &deadline);
+            continue;
+        }
+
+        // send without holding the lock, the queue only grows at the end
+        auto& message = link.queue.front().second;
+        pthread_mutex_unlock(&lock);
+        message.Send(sockets[link.other]);
+        pthread_mutex_lock(&lock);
+        link.queue.pop_front();
+        // wake up draining
+        pthread_cond_broadcast(&link.cond);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void ShapedPlayer::add(int player, const octetStream& o) const
+{
+    auto& link = *links.at(player);
+    long long start = now();
+
+    pthread_mutex_lock(&lock);
+    // serialization at the given bandwidth, then propagation
+    link.free_ns = max(link.free_ns, start);
+    if (link.bandwidth > 0)
+        link.free_ns += (o.get_length() + LENGTH_SIZE) / link.bandwidth * 1e9;
+    double delay = link.latency;
+    if (link.jitter > 0)
+        delay += uniform_real_distribution<double>(0, link.jitter)(link.prng);
+    // no reordering as with TCP
+    long long due = max(link.free_ns + (long long) (delay * 1e9),
+            link.last_due_ns);
+    link.last_due_ns = due;
+    link.queue.push_back({due, o});
+    pthread_cond_broadcast(&link.cond);
+    pthread_mutex_unlock(&lock);
+}
+
+void ShapedPlayer::drain(int player) const
+{
+    auto& link = *links.at(player);
+    pthread_mutex_lock(&lock);
+    while (not link.queue.empty())
+        pthread_cond_wait(&link.cond, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+void ShapedPlayer::send_to_no_stats(int player, const octetStream& o) const
+{
+    if (player == my_num())
+        return PlainPlayer::send_to_no_stats(player, o);
+    add(player, o);
+}
+
+size_t ShapedPlayer::send_no_stats(int player, const PlayerBuffer& buffer,
+        bool block) const
+{
+    // raw data is sent directly after any queued messages
+    drain(player);
+    return PlainPlayer::send_no_stats(player, buffer, block);
+}
+
+void ShapedPlayer::exchange_no_stats(int other, const octetStream& to_send,
+        octetStream& to_receive) const
+{
+    // copying makes sending and receiving the same buffer safe
+    add(other, to_send);
+    receive_player_no_stats(other, to_receive);
+}
+
+void ShapedPlayer::pass_around_no_stats(const octetStream& to_send,
+        octetStream& to_receive, int offset) const
+{
+    add(get_player(offset), to_send);
+    receive_player_no_stats(get_player(-offset), to_receive);
+}
+
+void ShapedPlayer::Broadcast_Receive_no_stats(vector<octetStream>& o) const
+{
+    if (o.size() != size_t(num_players()))
+        throw runtime_error("player numbers don't match");
+
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+            add(i, o[my_num()]);
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num())
+            receive_player_no_stats(i, o[i]);
+}
+
+void ShapedPlayer::send_receive_all_no_stats(
+        const vector<vector<bool>>& channels, const vector<octetStream>& to_send,
+        vector<octetStream>& to_receive) const
+{
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num() and channels[my_num()][i])
+            add(i, to_send[i]);
+    to_receive.resize(num_players());
+    for (int i = 0; i < num_players(); i++)
+        if (i != my_num() and channels[i][my_num()])
+            receive_player_no_stats(i, to_receive[i]);
+}
@@ -0,0 +1,79 @@
+/*
+ * ShapedPlayer.h
+ *
+ */
+
+#ifndef NETWORKING_SHAPEDPLAYER_H_
+#define NETWORKING_SHAPEDPLAYER_H_
+
+#include "Player.h"
+
+#include <pthread.h>
+#include <deque>
+#include <memory>
+#include <random>
+
+/**
+ * Plaintext multi-player communication that emulates a slower network
+ * similar to ``tc netem``. Outgoing messages are copied and sent by a
+ * background thread per party once they would have arrived with the
+ * given latency, jitter, and bandwidth, so the caller continues
+ * immediately as with a real network.
+ */
+class ShapedPlayer : public PlainPlayer
+{
+    struct Link
+    {
+        ShapedPlayer* player;
+        int other;
+
+        // seconds and bytes per second
+        double latency, jitter, bandwidth;
+        mt19937 prng;
+
+        // messages with due time in nanoseconds
+        deque<pair<long long, octetStream>> queue;
+        long long free_ns, last_due_ns;
+
+        pthread_cond_t cond;
+        pthread_t thread;
+
+        Link(ShapedPlayer* player, int other);
+    };
+
+    mutable vector<unique_ptr<Link>> links;
+    mutable pthread_mutex_t lock;
+    bool running;
+
+    static long long now();
+    static double get_value(const string& name, int other, double factor);
+
+    static void* run_link(void* link);
+    void send_in_background(Link& link);
+
+    void add(int player, const octetStream& o) const;
+    void drain(int player) const;
+
+public:
+    /// Whether any shaping option is given
+    static bool enabled();
+
+    ShapedPlayer(const Names& Nms, const string& id);
+    ~ShapedPlayer();
+
+    void send_to_no_stats(int player, const octetStream& o) const;
+
+    size_t send_no_stats(int player, const PlayerBuffer& buffer,
+            bool block) const;
+
+    void exchange_no_stats(int other, const octetStream& to_send,
+            octetStream& to_receive) const;
+    void pass_around_no_stats(const octetStream& to_send,
+            octetStream& to_receive, int offset) const;
+    void Broadcast_Receive_no_stats(vector<octetStream>& o) const;
+    void send_receive_all_no_stats(const vector<vector<bool>>& channels,
+            const vector<octetStream>& to_send,
+            vector<octetStream>& to_receive) const;
+};
+
+#endif /* NETWORKING_SHAPEDPLAYER_H_ */
@@ -0,0 +1,212 @@
+/*
+ * StreamChannel.cpp
+ *
+ */
+
+#include "StreamChannel.h"
+#include "ServerSocket.h"
+#include "Tools/Exceptions.h"
+#include "Processor/OnlineOptions.h"
+
+#include <sys/socket.h>
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+namespace
+{
+
+// listening sockets are shared by all threads
+ServerSocket& get_server(int port)
+{
+    static mutex lock;
+    static map<int, ServerSocket*> servers;
+    lock_guard<mutex> guard(lock);
+    auto& server = servers[port];
+    if (not server)
+    {
+        server = new ServerSocket(port);
+        server->init();
+    }
+    return *server;
+}
+
+}
+
+void* StreamChannel::run_thread(void* channel)
+{
+    ((StreamChannel*) channel)->run();
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    OPENSSL_thread_stop();
+#endif
+    return 0;
+}
+
+void StreamChannel::parse_address(const string& address, string& hostname,
+        int& port)
+{
+    auto pos = address.rfind(':');
+    if (pos == string::npos)
+        throw runtime_error("address must be host:port: " + address);
+    hostname = address.substr(0, pos);
+    port = stoi(address.substr(pos + 1));
+}
+
+StreamChannel::StreamChannel() :
+        plaintext_socket(-1), io_service(0), ctx(0), tls_socket(0),
+        sender(false), thread(0), prefetching(false), finished(false),
+        failed(false)
+{
+}
+
+StreamChannel::~StreamChannel()
+{
+    close();
+}
+
+void StreamChannel::setup_tls(const string& me, const string& other,
+        bool client)
+{
+    if (me.empty())
+        return;
+    io_service = new ssl_service;
+    ctx = new ssl_ctx(me);
+    tls_socket = new ssl_socket(*io_service, *ctx, plaintext_socket, other, me,
+            client);
+}
+
+void StreamChannel::connect(const string& hostname, int port, const string& id,
+        bool sender, const string& me, const string& other)
+{
+    assert(not is_open());
+    this->sender = sender;
+    set_up_client_socket(plaintext_socket, hostname.c_str(), port);
+    // stalling is normal when the other side is slower
+    struct timeval tv = {0, 0};
+    if (setsockopt(plaintext_socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)))
+        ::error("StreamChannel:setsockopt");
+    octetStream(id).Send(plaintext_socket);
+    setup_tls(me, other, true);
+    if (OnlineOptions::singleton.has_option("debug_networking"))
+        cerr << "stream " << id << " connected to " << hostname << ":" << port
+                << endl;
+}
+
+void StreamChannel::accept(int port, const string& id, bool sender,
+        const string& me, const string& other)
+{
+    assert(not is_open());
+    this->sender = sender;
+    plaintext_socket = get_server(port).get_connection_socket(id);
+    setup_tls(me, other, false);
+    if (OnlineOptions::singleton.has_option("debug_networking"))
+        cerr << "stream " << id << " accepted on port " << port << endl;
+}
+
+void StreamChannel::start_prefetch(int window)
+{
+    assert(is_open() and not sender and not prefetching);
+    buffers.resize(max(window, 1));
+    pthread_create(&thread, 0, run_thread, this);
+    prefetching = true;
+    for (auto& buffer : buffers)
+        in.push(&buffer);
+}
+
+void StreamChannel::receive(octetStream& os)
+{
+    if (tls_socket)
+        os.Receive(tls_socket);
+    else
+        os.Receive(plaintext_socket);
+}
+
+void StreamChannel::run()
+{
+    octetStream* buffer = 0;
+    while (in.pop(buffer))
+    {
+        if (not finished)
+        {
+            try
+            {
+                receive(*buffer);
+            }
+            catch (closed_connection&)
+            {
+                finished = true;
+            }
+            catch (boost::system::system_error& e)
+            {
+                finished = true;
+                if (e.code() != boost::asio::error::eof
+                        and e.code() != boost::asio::ssl::error::stream_truncated)
+                {
+                    error = e.what();
+                    failed = true;
+                }
+            }
+            catch (exception& e)
+            {
+                error = e.what();
+                failed = finished = true;
+            }
+            // null signals the end
+            out.push(finished ? 0 : buffer);
+        }
+    }
+}
+
+void StreamChannel::write(const octetStream& os)
+{
+    assert(sender);
+    if (tls_socket)
+        os.Send(tls_socket);
+    else
+        os.Send(plaintext_socket);
+}
+
+void StreamChannel::read(octetStream& os)
+{
+    assert(not sender);
+    if (not prefetching)
+        start_prefetch();
+    auto buffer = out.pop();
+    if (buffer == 0)
+    {
+        out.push(0);
+        if (failed)
+            throw runtime_error("error in stream reception: " + error);
+        else
+            throw IO_Error("not enough data");
+    }
+    os = *buffer;
+    in.push(buffer);
+}
+
+void StreamChannel::close()
+{
+    if (not is_open())
+        return;
+    // unblock the prefetching thread
+    shutdown(plaintext_socket, sender ? SHUT_WR : SHUT_RDWR);
+    if (prefetching)
+    {
+        in.stop();
+        pthread_join(thread, 0);
+        prefetching = false;
+    }
+    if (tls_socket)
+    {
+        delete tls_socket;
+        delete ctx;
+        delete io_service;
+        tls_socket = 0;
+        ctx = 0;
+        io_service = 0;
+    }
+    else
+        close_client_socket(plaintext_socket);
+    plaintext_socket = -1;
+}
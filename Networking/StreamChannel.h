@@ -0,0 +1,83 @@
+/*
+ * StreamChannel.h
+ *
+ */
+
+#ifndef NETWORKING_STREAMCHANNEL_H_
+#define NETWORKING_STREAMCHANNEL_H_
+
+#include <pthread.h>
+#include <vector>
+#include <string>
+
+#include "Networking/ssl_sockets.h"
+#include "Tools/octetStream.h"
+#include "Tools/WaitQueue.h"
+
+#ifndef STREAM_CHANNEL_WINDOW
+#define STREAM_CHANNEL_WINDOW 8
+#endif
+
+/**
+ * Unidirectional stream of octetStreams over TCP, optionally with TLS.
+ * The receiving side prefetches up to a fixed number of messages in
+ * a background thread. Beyond that, the sender is blocked by TCP flow
+ * control, which limits memory usage if the receiver falls behind.
+ * Connections are identified by a string so that several channels
+ * can share a listening port.
+ */
+class StreamChannel
+{
+    int plaintext_socket;
+    ssl_service* io_service;
+    ssl_ctx* ctx;
+    ssl_socket* tls_socket;
+    bool sender;
+
+    std::vector<octetStream> buffers;
+    WaitQueue<octetStream*> in, out;
+    pthread_t thread;
+    bool prefetching, finished, failed;
+    std::string error;
+
+    static void* run_thread(void* channel);
+
+    // prevent copying
+    StreamChannel(const StreamChannel& other);
+
+    void setup_tls(const std::string& me, const std::string& other,
+            bool client);
+    void run();
+    void receive(octetStream& os);
+
+public:
+    /// Split ``host:port``
+    static void parse_address(const std::string& address,
+            std::string& hostname, int& port);
+
+    StreamChannel();
+    ~StreamChannel();
+
+    bool is_open() const { return plaintext_socket >= 0; }
+
+    /// Connect to listening party with connection identifier ``id``.
+    /// ``me`` and ``other`` are certificate names for TLS (empty for none).
+    void connect(const std::string& hostname, int port, const std::string& id,
+            bool sender, const std::string& me = "",
+            const std::string& other = "");
+    /// Wait for connection with identifier ``id`` on ``port``
+    void accept(int port, const std::string& id, bool sender,
+            const std::string& me = "", const std::string& other = "");
+
+    /// Start prefetching on receiving side
+    void start_prefetch(int window = STREAM_CHANNEL_WINDOW);
+
+    /// Send message, blocking if the receiver is too far behind
+    void write(const octetStream& os);
+    /// Receive next message
+    void read(octetStream& os);
+
+    void close();
+};
+
+#endif /* NETWORKING_STREAMCHANNEL_H_ */
@@ -17,6 +17,7 @@
 #include <arpa/inet.h>
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/types.h>
 #include <sys/wait.h>   /* Wait for Process Termination */
 
@@ -76,6 +77,79 @@ inline void send(int socket,octet *msg,size_t len)
     }
 }
 
+// scatter/gather sending to save system calls on small messages
+inline size_t send_non_blocking(int socket, struct iovec* iov, int n_iov)
+{
+#ifdef __APPLE__
+  // keep the limit above
+  for (int i = 0; i < n_iov; i++)
+    if (iov[i].iov_len)
+      return send_non_blocking(socket, (octet*) iov[i].iov_base,
+          iov[i].iov_len);
+  return 0;
+#endif
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = n_iov;
+  ssize_t j = sendmsg(socket, &msg, MSG_DONTWAIT);
+  if (j < 0)
+    {
+      if (errno != EINTR and errno != EAGAIN and errno != EWOULDBLOCK and
+	  errno != ENOBUFS)
+        { error("Sending error", true);  }
+      else
+        return 0;
+    }
+  return j;
+}
+
+// fallback for sockets without gather support
+template<class T>
+inline size_t send_non_blocking(T& socket, struct iovec* iov, int n_iov)
+{
+  for (int i = 0; i < n_iov; i++)
+    if (iov[i].iov_len)
+      return send_non_blocking(socket, (octet*) iov[i].iov_base,
+          iov[i].iov_len);
+  return 0;
+}
+
+// skip sent data, returns number of remaining parts
+inline int consume_iovec(struct iovec*& iov, int n_iov, size_t len)
+{
+  while (n_iov > 0 and len >= iov->iov_len)
+    {
+      len -= iov->iov_len;
+      iov++;
+      n_iov--;
+    }
+  if (n_iov > 0)
+    {
+      iov->iov_base = (octet*) iov->iov_base + len;
+      iov->iov_len -= len;
+    }
+  return n_iov;
+}
+
+template<class T>
+inline void send(T& socket, struct iovec* iov, int n_iov)
+{
+  long wait = 1;
+  while (n_iov > 0)
+    {
+      size_t j = send_non_blocking(socket, iov, n_iov);
+      n_iov = consume_iovec(iov, n_iov, j);
+      if (j > 0)
+        wait = 1;
+      else
+        {
+          usleep(wait);
+          wait = min(2 * wait, 1000l);
+        }
+    }
+}
+
 template<class T>
 inline void send(T& socket, size_t a, size_t len)
 {
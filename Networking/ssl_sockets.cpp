@@ -0,0 +1,131 @@
+/*
+ * ssl_sockets.cpp
+ *
+ */
+
+#include "ssl_sockets.h"
+
+#include <openssl/kdf.h>
+#include <openssl/evp.h>
+
+#ifdef __linux__
+#include <netinet/tcp.h>
+#include <linux/tls.h>
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+bool ssl_socket::offload(bool sending)
+{
+    if (offloaded[sending])
+        return true;
+    offloaded[sending] = set_kernel_keys(sending);
+    return offloaded[sending];
+}
+
+bool ssl_socket::set_kernel_keys(bool sending)
+{
+#ifdef __linux__
+    SSL* ssl = native_handle();
+    auto cipher = SSL_get_current_cipher(ssl);
+    if (not cipher or SSL_version(ssl) != TLS1_2_VERSION)
+        return false;
+
+    size_t key_size;
+    switch (SSL_CIPHER_get_cipher_nid(cipher))
+    {
+    case NID_aes_128_gcm:
+        key_size = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+        break;
+    case NID_aes_256_gcm:
+        key_size = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+        break;
+    default:
+        return false;
+    }
+
+    // key block as in RFC 5246, Section 6.3, without MAC keys for AEAD
+    const int salt_size = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+    octet master[SSL_MAX_MASTER_KEY_LENGTH];
+    size_t master_size = SSL_SESSION_get_master_key(SSL_get_session(ssl),
+            master, sizeof(master));
+    octet seed[2 * SSL3_RANDOM_SIZE];
+    SSL_get_server_random(ssl, seed, SSL3_RANDOM_SIZE);
+    SSL_get_client_random(ssl, seed + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+    string label = "key expansion";
+
+    octet key_block[2 * (TLS_CIPHER_AES_GCM_256_KEY_SIZE + salt_size)];
+    size_t block_size = 2 * (key_size + salt_size);
+    auto ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, 0);
+    bool derived = ctx and EVP_PKEY_derive_init(ctx) > 0
+            and EVP_PKEY_CTX_set_tls1_prf_md(ctx,
+                    SSL_CIPHER_get_handshake_digest(cipher)) > 0
+            and EVP_PKEY_CTX_set1_tls1_prf_secret(ctx, master, master_size) > 0
+            and EVP_PKEY_CTX_add1_tls1_prf_seed(ctx, (octet*) label.data(),
+                    label.size()) > 0
+            and EVP_PKEY_CTX_add1_tls1_prf_seed(ctx, seed, sizeof(seed)) > 0
+            and EVP_PKEY_derive(ctx, key_block, &block_size) > 0;
+    EVP_PKEY_CTX_free(ctx);
+    OPENSSL_cleanse(master, sizeof(master));
+    if (not derived)
+        return false;
+
+    // the client writes with the first key
+    bool client_keys = sending != bool(SSL_is_server(ssl));
+    octet* key = key_block + (client_keys ? 0 : key_size);
+    octet* salt = key_block + 2 * key_size + (client_keys ? 0 : salt_size);
+
+    // the finished message has sequence number 0
+    octet sequence[TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE] = {};
+    sequence[sizeof(sequence) - 1] = 1;
+
+    union
+    {
+        tls12_crypto_info_aes_gcm_128 aes128;
+        tls12_crypto_info_aes_gcm_256 aes256;
+    } info;
+    memset(&info, 0, sizeof(info));
+    size_t info_size;
+    if (key_size == TLS_CIPHER_AES_GCM_128_KEY_SIZE)
+    {
+        auto& x = info.aes128;
+        x.info.version = TLS_1_2_VERSION;
+        x.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        memcpy(x.key, key, key_size);
+        memcpy(x.salt, salt, salt_size);
+        memcpy(x.iv, sequence, sizeof(sequence));
+        memcpy(x.rec_seq, sequence, sizeof(sequence));
+        info_size = sizeof(x);
+    }
+    else
+    {
+        auto& x = info.aes256;
+        x.info.version = TLS_1_2_VERSION;
+        x.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        memcpy(x.key, key, key_size);
+        memcpy(x.salt, salt, salt_size);
+        memcpy(x.iv, sequence, sizeof(sequence));
+        memcpy(x.rec_seq, sequence, sizeof(sequence));
+        info_size = sizeof(x);
+    }
+    OPENSSL_cleanse(key_block, sizeof(key_block));
+
+    // fails if the kernel lacks the TLS module
+    int res = setsockopt(fd(), SOL_TCP, TCP_ULP, "tls", sizeof("tls"));
+    if (res and errno != EEXIST)
+        res = -1;
+    else
+        res = setsockopt(fd(), SOL_TLS, sending ? TLS_TX : TLS_RX, &info,
+                info_size);
+    OPENSSL_cleanse(&info, sizeof(info));
+    return res == 0;
+#else
+    (void) sending;
+    return false;
+#endif
+}
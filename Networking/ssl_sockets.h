@@ -45,7 +45,12 @@ class ssl_socket : public boost::asio::ssl::stream<boost::asio::ip::tcp::socket>
 {
     typedef boost::asio::ssl::stream<boost::asio::ip::tcp::socket> parent;
 
+    bool set_kernel_keys(bool sending);
+
 public:
+    /// Whether the kernel encrypts respectively decrypts (kTLS)
+    bool offloaded[2] = {false, false};
+
     ssl_socket(ssl_service& io_service,
             boost::asio::ssl::context& ctx, int plaintext_socket, string other,
             string me, bool client) :
@@ -80,15 +85,58 @@ public:
 
         }
     }
+
+    int fd()
+    {
+        return lowest_layer().native_handle();
+    }
+
+    bool offloaded_send()
+    {
+        return offloaded[1];
+    }
+
+    bool offloaded_receive()
+    {
+        return offloaded[0];
+    }
+
+    /**
+     * Hand the keys of one direction to the kernel (Linux only).
+     * This must happen before any application data is sent in that
+     * direction, and the data must not have been read by OpenSSL.
+     * Falls back to OpenSSL if not possible.
+     * @param sending whether to offload the sending direction
+     * @returns success
+     */
+    bool offload(bool sending);
 };
 
 inline size_t send_non_blocking(ssl_socket* socket, octet* data, size_t length)
 {
+    if (socket->offloaded_send())
+        return send_non_blocking(socket->fd(), data, length);
     return socket->write_some(boost::asio::buffer(data, length));
 }
 
+inline size_t send_non_blocking(ssl_socket* socket, struct iovec* iov,
+        int n_iov)
+{
+    // the kernel encrypts, so gathering works like for plain sockets
+    if (socket->offloaded_send())
+        return send_non_blocking(socket->fd(), iov, n_iov);
+    for (int i = 0; i < n_iov; i++)
+        if (iov[i].iov_len)
+            return send_non_blocking(socket, (octet*) iov[i].iov_base,
+                    iov[i].iov_len);
+    return 0;
+}
+
 inline void send(ssl_socket* socket, octet* data, size_t length)
 {
+    if (socket->offloaded_send())
+        return send(socket->fd(), data, length);
+
     size_t sent = 0;
 #ifdef VERBOSE_SSL
     RunningTimer timer;
@@ -104,6 +152,9 @@ inline void send(ssl_socket* socket, octet* data, size_t length)
 
 inline void receive(ssl_socket* socket, octet* data, size_t length)
 {
+    if (socket->offloaded_receive())
+        return receive(socket->fd(), data, length);
+
     size_t received = 0;
     while (received < length)
         received += socket->read_some(boost::asio::buffer(data + received, length - received));
@@ -111,6 +162,8 @@ inline void receive(ssl_socket* socket, octet* data, size_t length)
 
 inline size_t receive_non_blocking(ssl_socket* socket, octet* data, size_t length)
 {
+    if (socket->offloaded_receive())
+        return receive_non_blocking(socket->fd(), data, length);
     return socket->read_some(boost::asio::buffer(data, length));
 }
 
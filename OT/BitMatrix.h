@@ -65,6 +65,8 @@ union square128 {
     void randomize(int row, PRNG& G);
     void conditional_add(BitVector& conditions, square128& other, int offset);
     void transpose();
+    /// Use AVX-512 if compiled in and ``wide``
+    void transpose(bool wide);
     template <class T>
     void to(T& result);
 
@@ -179,6 +181,9 @@ public:
     Slice<U>& sub(BitVector& other, int repeat = 1);
 
     void randomize(int row, PRNG& G);
+    /// Randomize all rows square by square with ``prngs(row)``
+    template <class T>
+    void randomize(int n_rows, T prngs);
     void conditional_add(BitVector& conditions, U& other, bool useOffset = false);
     void transpose();
 
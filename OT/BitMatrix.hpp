@@ -138,6 +138,16 @@ void Slice<U>::randomize(int row, PRNG& G)
         bm.squares[i].randomize(row, G);
 }
 
+template <class U>
+template <class T>
+void Slice<U>::randomize(int n_rows, T prngs)
+{
+    // same order per PRNG as row by row but with locality
+    for (size_t i = start; i < end; i++)
+        for (int j = 0; j < n_rows; j++)
+            bm.squares[i].randomize(j, prngs(j));
+}
+
 template <class U>
 void Slice<U>::conditional_add(BitVector& conditions, U& other, bool useOffset)
 {
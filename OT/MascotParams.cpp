@@ -4,6 +4,7 @@
  */
 
 #include "MascotParams.h"
+#include "Processor/OnlineOptions.h"
 
 MascotParams::MascotParams()
 {
@@ -15,6 +16,8 @@ MascotParams::MascotParams()
     use_extension = true;
     fewer_rounds = false;
     fiat_shamir = false;
+    ot_memory = stoll(OnlineOptions::singleton.option_value("ot_memory", "512"))
+            << 20;
     timerclear(&start);
 }
 
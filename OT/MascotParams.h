@@ -20,6 +20,7 @@ public:
     bool use_extension;
     bool fewer_rounds;
     bool fiat_shamir;
+    size_t ot_memory;
     struct timeval start, stop;
 
     MascotParams();
@@ -87,12 +87,15 @@ Spdz2kTripleGenerator<T>::Spdz2kTripleGenerator(const OTTripleSetup& setup,
 template<class T>
 void OTTripleGenerator<T>::set_batch_size(int batch_size)
 {
-    // limit to ~1 GB
-    batch_size = min(batch_size, int(1e7 / sizeof(T) / sizeof(T)));
+    // limit the OT matrices per loop (about eight per triple and
+    // other party), callers repeat for more
+    size_t per_triple = 8 * nAmplify * max(1, nparties - 1)
+            * sizeof(typename T::Rectangle);
+    int max_per_loop = max(size_t(1), machine.ot_memory / per_triple);
     if (OnlineOptions::singleton.has_option("verbose_ot"))
-        fprintf(stderr, "OT batch size %d (share size %d)\n", batch_size,
-                int(sizeof(T)));
-    nTriplesPerLoop = DIV_CEIL(batch_size, nloops);
+        fprintf(stderr, "OT batch size %d (share size %d, limit %d per loop)\n",
+                batch_size, int(sizeof(T)), max_per_loop);
+    nTriplesPerLoop = min(int(DIV_CEIL(batch_size, nloops)), max_per_loop);
     nTriples = nTriplesPerLoop * nloops;
     nPreampTriplesPerLoop = nTriplesPerLoop * nAmplify;
 }
@@ -37,18 +37,17 @@ void OTCorrelator<U>::expand(int start, int slice)
     // expand with PRG
     if (ot_role & RECEIVER)
     {
-        for (int i = 0; i < nbaseOTs; i++)
-        {
-            receiverOutputSlice.randomize(i, G_sender[i][0]);
-            t1Slice.randomize(i, G_sender[i][1]);
-        }
+        receiverOutputSlice.randomize(nbaseOTs,
+                [&](int i) -> PRNG& { return G_sender[i][0]; });
+        t1Slice.randomize(nbaseOTs,
+                [&](int i) -> PRNG& { return G_sender[i][1]; });
     }
 
     if (ot_role & SENDER)
     {
-        for (int i = 0; i < nbaseOTs; i++)
-            // randomize base receiver output
-            senderOutputSlices[0].randomize(i, G_receiver[i]);
+        // randomize base receiver output
+        senderOutputSlices[0].randomize(nbaseOTs,
+                [&](int i) -> PRNG& { return G_receiver[i]; });
     }
 }
 
@@ -135,7 +134,6 @@ void OTExtensionWithMatrix::hash_outputs(int nOTs, vector<V>& senderOutput,
         V& receiverOutput, bool correlated)
 {
     //cout << "Hashing... " << flush;
-    MMO mmo;
 #ifdef OTEXT_TIMER
     timeval startv, endv;
     gettimeofday(&startv, NULL);
@@ -150,7 +148,42 @@ void OTExtensionWithMatrix::hash_outputs(int nOTs, vector<V>& senderOutput,
     if (nOTs % 8 != 0)
         throw runtime_error("number of OTs must be divisible by 8");
 
-    for (int i = 0; i < nOTs; i += 8)
+    // split at square boundaries among threads
+    int n_jobs = max(1, min(n_threads, int(DIV_CEIL(nOTs, 128))));
+    vector<OTExtensionJob> jobs(n_jobs);
+    int chunk = DIV_CEIL(nOTs, 128 * n_jobs) * 128;
+    auto range = [&](int i) { return min(nOTs, chunk * i); };
+    for (int i = 1; i < n_jobs; i++)
+    {
+        int begin = range(i), end = range(i + 1);
+        jobs[i].task = [&, begin, end]()
+        {
+            hash_output_range(begin, end, senderOutput, receiverOutput,
+                    correlated);
+        };
+        get_worker(i - 1).request(jobs[i]);
+    }
+    hash_output_range(0, range(1), senderOutput, receiverOutput, correlated);
+    for (int i = 1; i < n_jobs; i++)
+        get_worker(i - 1).done();
+
+    //cout << "done.\n";
+#ifdef OTEXT_TIMER
+    gettimeofday(&endv, NULL);
+    double elapsed = timeval_diff(&startv, &endv);
+    cout << "\t\tOT ext hashing took time " << elapsed/1000000 << endl << flush;
+    times["Hashing"] += timeval_diff(&startv, &endv);
+#endif
+}
+
+template <class V>
+void OTExtensionWithMatrix::hash_output_range(int begin, int end,
+        vector<V>& senderOutput, V& receiverOutput, bool correlated)
+{
+    MMO mmo;
+    int n_rows = V::PartType::n_rows_allocated();
+
+    for (int i = begin; i < end; i += 8)
     {
         int i_outer_input = i / 128;
         int i_inner_input = i % 128;
@@ -180,13 +213,6 @@ void OTExtensionWithMatrix::hash_outputs(int nOTs, vector<V>& senderOutput,
                     &receiverOutputMatrix.squares[i_outer_input].rows[i_inner_input]);
         }
     }
-    //cout << "done.\n";
-#ifdef OTEXT_TIMER
-    gettimeofday(&endv, NULL);
-    double elapsed = timeval_diff(&startv, &endv);
-    cout << "\t\tOT ext hashing took time " << elapsed/1000000 << endl << flush;
-    times["Hashing"] += timeval_diff(&startv, &endv);
-#endif
 }
 
 template <class U>
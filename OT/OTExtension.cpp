@@ -28,6 +28,7 @@ int eq_m128i(__m128i a, __m128i b)
 
 
 bool OTExtensionWithMatrix::warned = false;
+bool OTExtensionWithMatrix::warned_silent = false;
 
 void OTExtensionWithMatrix::check_correlation(int nOTs,
     const BitVector& receiverInput)
@@ -63,49 +64,47 @@ void OTExtensionWithMatrix::check_correlation(int nOTs,
 
     BitVector chi(nbaseOTs);
     BitVector x(nbaseOTs);
-    __m128i t = _mm_setzero_si128();
-    __m128i q = _mm_setzero_si128();
-    __m128i t2 = _mm_setzero_si128();
-    __m128i q2 = _mm_setzero_si128();
-    __m128i chii, ti, qi, ti2, qi2;
+    __m128i t[2] = {}, q[2] = {};
     x128i = _mm_setzero_si128();
 
-    for (int i = 0; i < nOTs; i++)
-    {
-//        chi.randomize(G);
-//        chii = _mm_load_si128((__m128i*)&(chi.get_ptr()[0]));
-        chii = G.get_doubleword();
+    // batches for vectorized multiplication
+    const int batch = 64;
+    __m128i chis[batch], ts[batch], qs[batch];
 
-        if (ot_role & RECEIVER)
+    for (int i = 0; i < nOTs; i += batch)
+    {
+        int n = min(batch, nOTs - i);
+        for (int j = 0; j < n; j++)
         {
-            if (receiverInput.get_bit(i) == 1)
+            chis[j] = G.get_doubleword();
+
+            if (ot_role & RECEIVER)
             {
-                x128i = _mm_xor_si128(x128i, chii);
+                if (receiverInput.get_bit(i + j) == 1)
+                {
+                    x128i = _mm_xor_si128(x128i, chis[j]);
+                }
+                ts[j] = _mm_loadu_si128((__m128i*)get_receiver_output(i + j));
             }
-            ti = _mm_loadu_si128((__m128i*)get_receiver_output(i));
-            // multiply over polynomial ring to avoid reduction
-            mul128(ti, chii, &ti, &ti2);
-            t = _mm_xor_si128(t, ti);
-            t2 = _mm_xor_si128(t2, ti2);
+            if (ot_role & SENDER)
+                qs[j] = _mm_loadu_si128((__m128i*)(get_sender_output(0, i + j)));
         }
+        // multiply over polynomial ring to avoid reduction
+        if (ot_role & RECEIVER)
+            add_mul128(t, ts, chis, n);
         if (ot_role & SENDER)
-        {
-            qi = _mm_loadu_si128((__m128i*)(get_sender_output(0, i)));
-            mul128(qi, chii, &qi, &qi2);
-            q = _mm_xor_si128(q, qi);
-            q2 = _mm_xor_si128(q2, qi2);
-        }
+            add_mul128(q, qs, chis, n);
     }
 #ifdef OTEXT_DEBUG
     if (ot_role & RECEIVER)
     {
         cout << "\tSending x,t\n";
         cout << "\tsend x = " << __m128i_toString<octet>(x128i) << endl;
-        cout << "\tsend t = " << __m128i_toString<octet>(t) << endl;
-        cout << "\tsend t2 = " << __m128i_toString<octet>(t2) << endl;
+        cout << "\tsend t = " << __m128i_toString<octet>(t[0]) << endl;
+        cout << "\tsend t2 = " << __m128i_toString<octet>(t[1]) << endl;
     }
 #endif
-    check_iteration(Delta, q, q2, t, t2, x128i);
+    check_iteration(Delta, q[0], q[1], t[0], t[1], x128i);
 #ifdef OTEXT_TIMER
     gettimeofday(&endv, NULL);
     elapsed = timeval_diff(&startv, &endv);
@@ -44,6 +44,24 @@ void OTExtensionWithMatrix::init_me()
     channel = 0;
 #endif
     softspoken_k = 2;
+
+    n_threads = max(1,
+            stoi(OnlineOptions::singleton.option_value("ot_threads", "1")));
+    // enough slices to keep the other threads busy
+    if (n_threads > 1)
+        nsubloops = 4 * n_threads;
+
+    if (OnlineOptions::singleton.has_option("silent_ot"))
+    {
+        if (passive_only)
+            silent.reset(new SilentOT);
+        else if (not warned_silent)
+        {
+            cerr << "Silent OT is only implemented for semi-honest security, "
+                    << "using OT extension" << endl;
+            warned_silent = true;
+        }
+    }
 }
 
 OTExtensionWithMatrix::~OTExtensionWithMatrix()
@@ -54,6 +72,13 @@ OTExtensionWithMatrix::~OTExtensionWithMatrix()
 #endif
 }
 
+Worker<OTExtensionJob>& OTExtensionWithMatrix::get_worker(int i)
+{
+    while (workers.size() <= size_t(i))
+        workers.push_back(make_unique<Worker<OTExtensionJob>>());
+    return *workers[i];
+}
+
 bool OTExtensionWithMatrix::use_kos()
 {
 #ifdef USE_KOS
@@ -63,6 +88,12 @@ bool OTExtensionWithMatrix::use_kos()
 #endif
 }
 
+bool OTExtensionWithMatrix::use_silent()
+{
+    // base OTs for silent OT use the usual extension
+    return silent and silent->active();
+}
+
 void OTExtensionWithMatrix::protocol_agreement()
 {
     if (agreed)
@@ -78,6 +109,7 @@ void OTExtensionWithMatrix::protocol_agreement()
         softspoken_k = 8;
 
     bundle.mine.store(softspoken_k);
+    bundle.mine.store(int(bool(silent)));
 
     player->unchecked_broadcast(bundle);
 
@@ -91,6 +123,7 @@ void OTExtensionWithMatrix::protocol_agreement()
         cerr << "Parties compiled with different OT extensions" << endl;
         cerr << "Set \"USE_KOS\" to the same value on all parties" << endl;
         cerr << "and make sure that the SoftSpokenOT parameter is the same" << endl;
+        cerr << "and that silent OT is used by all parties or none" << endl;
         exit(1);
     }
 }
@@ -133,10 +166,11 @@ void OTExtensionWithMatrix::extend(int nOTs_requested,
     CODE_LOCATION
     protocol_agreement();
 
-    if (use_kos())
+    if (use_kos() or use_silent())
     {
         extend_correlated(nOTs_requested, newReceiverInput);
-        if (hash)
+        // silent OT replaces SoftSpokenOT, which outputs random OTs
+        if (hash or not use_kos())
             hash_outputs(nOTs_requested);
         return;
     }
@@ -256,6 +290,14 @@ void OTExtensionWithMatrix::extend_correlated(int nOTs_requested, const BitVecto
 //        throw invalid_length(); //"nOTs must be a multiple of nbaseOTs\n");
     if (nOTs_requested == 0)
         return;
+
+    if (use_silent())
+    {
+        protocol_agreement();
+        silent->extend(*this, nOTs_requested, newReceiverBits);
+        return;
+    }
+
     // local copy
     auto newReceiverInput = newReceiverBits;
     if ((ot_role & RECEIVER) and (size_t)nOTs_requested != newReceiverInput.size())
@@ -264,8 +306,9 @@ void OTExtensionWithMatrix::extend_correlated(int nOTs_requested, const BitVecto
     // add k + s to account for discarding k OTs
     int nOTs = nOTs_requested_rounded + 2 * 128;
 
-    int slice = nOTs / nsubloops / 128;
-    nOTs = slice * nsubloops * 128;
+    int n_slices = min(nsubloops, nOTs / 128);
+    int slice = DIV_CEIL(nOTs / 128, n_slices);
+    nOTs = slice * n_slices * 128;
     resize(nOTs);
     newReceiverInput.resize_zero(nOTs);
 
@@ -273,14 +316,27 @@ void OTExtensionWithMatrix::extend_correlated(int nOTs_requested, const BitVecto
     for (int i = 0; i < 4; i++)
         newReceiverInput.set_word(nOTs/64 - i - 1, G.get_word());
 
-    // subloop for first part to interleave communication with computation
-    for (int start = 0; start < nOTs / 128; start += slice)
+    // subloop for first part to interleave communication with computation,
+    // other threads transpose while expanding and correlating the next slice
+    vector<OTExtensionJob> jobs(n_slices);
+    for (int i = 0; i < n_slices; i++)
     {
+        int start = i * slice;
         expand(start, slice);
         this->correlate(start, slice, newReceiverInput, true);
-        transpose(start, slice);
+        if (n_threads > 1)
+        {
+            jobs[i].task = [this, start, slice]() { transpose(start, slice); };
+            get_worker(i % (n_threads - 1)).request(jobs[i]);
+        }
+        else
+            transpose(start, slice);
     }
 
+    if (n_threads > 1)
+        for (int i = 0; i < n_slices; i++)
+            get_worker(i % (n_threads - 1)).done();
+
 #ifdef OTEXT_TIMER
     double elapsed;
 #endif
@@ -362,6 +418,38 @@ void OTExtensionWithMatrix::hash_outputs(int nOTs)
     hash_outputs(nOTs, senderOutputMatrices, receiverOutputMatrix);
 }
 
+/*
+ * Hash the whole range at once because the rows are contiguous
+ */
+void OTExtensionWithMatrix::hash_output_range(int begin, int end,
+        vector<BitMatrix>& senderOutput, BitMatrix& receiverOutput,
+        bool correlated)
+{
+    MMO mmo;
+    size_t n = end - begin;
+    auto rows = [begin](BitMatrix& matrix)
+    {
+        return &matrix.squares[begin / 128].rows[begin % 128];
+    };
+
+    if (ot_role & SENDER)
+    {
+        // second output first in case of hashing in place
+        if (correlated)
+            mmo.hashBlocks(rows(senderOutput[1]),
+                    rows(senderOutputMatrices[0]), n,
+                    baseReceiverInput.get_int128(0).a);
+        else
+            mmo.hashBlocks(rows(senderOutput[1]),
+                    rows(senderOutputMatrices[1]), n);
+        mmo.hashBlocks(rows(senderOutput[0]), rows(senderOutputMatrices[0]),
+                n);
+    }
+
+    if (ot_role & RECEIVER)
+        mmo.hashBlocks(rows(receiverOutput), rows(receiverOutputMatrix), n);
+}
+
 octet* OTExtensionWithMatrix::get_receiver_output(int i)
 {
     return (octet*)&receiverOutputMatrix.squares[i/128].rows[i%128];
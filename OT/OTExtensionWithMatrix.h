@@ -8,7 +8,12 @@
 
 #include "OTExtension.h"
 #include "BitMatrix.h"
+#include "SilentOT.h"
 #include "Math/gf2n.h"
+#include "Tools/Worker.h"
+
+#include <memory>
+#include <functional>
 
 #ifndef USE_KOS
 namespace osuCrypto {
@@ -51,9 +56,24 @@ public:
     void common_seed(PRNG& G);
 };
 
+/// Part of OT extension run by a worker thread
+class OTExtensionJob
+{
+public:
+    function<void()> task;
+
+    int run()
+    {
+        task();
+        return 0;
+    }
+};
+
 class OTExtensionWithMatrix : public OTCorrelator<BitMatrix>
 {
-    static bool warned;
+    friend class SilentOT;
+
+    static bool warned, warned_silent;
 
     int nsubloops;
 
@@ -65,8 +85,23 @@ class OTExtensionWithMatrix : public OTCorrelator<BitMatrix>
 
     int softspoken_k;
 
+    unique_ptr<SilentOT> silent;
+
+    // threads for transposition and hashing (-o ot_threads)
+    int n_threads;
+    vector<unique_ptr<Worker<OTExtensionJob>>> workers;
+
     void init_me();
 
+    Worker<OTExtensionJob>& get_worker(int i);
+
+    template <class V>
+    void hash_output_range(int begin, int end, vector<V>& senderOutput,
+            V& receiverOutput, bool correlated);
+    void hash_output_range(int begin, int end,
+            vector<BitMatrix>& senderOutput, BitMatrix& receiverOutput,
+            bool correlated);
+
 public:
     PRNG G;
 
@@ -88,8 +123,12 @@ public:
     ~OTExtensionWithMatrix();
 
     bool use_kos();
+    bool use_silent();
     void protocol_agreement();
 
+    // before the first extension, ignored with KOS15
+    void set_softspoken(int k) { softspoken_k = k; }
+
     void transfer(int nOTs, const BitVector& receiverInput, int nloops);
     void extend(int nOTs, const BitVector& newReceiverInput, bool hash = true);
     void extend_correlated(const BitVector& newReceiverInput);
@@ -1,4 +1,9 @@
 #include "OTTripleSetup.h"
+#include "Processor/BaseMachine.h"
+#include "Tools/Hash.h"
+
+#include <fstream>
+#include <unistd.h>
 
 void* run_ot(void* job)
 {
@@ -18,6 +23,9 @@ void OTTripleSetup::setup()
     }
     //baseReceiverInput.randomize(G);
 
+    if (use_cache)
+        load_cache();
+
     vector<SetupJob> threads;
     for (int i = 0; i < nparties - 1; i++)
         threads.push_back({*this, i});
@@ -31,6 +39,9 @@ void OTTripleSetup::setup()
     cout << "\t\tBaseTime: " << basetime/1000000 << endl << flush;
 #endif
 
+    if (use_cache)
+        store_cache();
+
     for (size_t i = 0; i < baseOTs.size(); i++)
     {
         delete baseOTs[i];
@@ -40,12 +51,144 @@ void OTTripleSetup::setup()
     // (since Sender finishes baseOTs before Receiver)
 }
 
+// derive independent strings per session and purpose
+void derive(BitVector& bits, const octetStream& session, int purpose)
+{
+    Hash hash;
+    hash.update(session);
+    hash.update(&purpose, sizeof(purpose));
+    hash.update(bits.get_ptr(), bits.size_bytes());
+    hash.final(bits.get_ptr(), bits.size_bytes());
+}
+
 void OTTripleSetup::run(int i)
 {
-    baseOTs[i]->set_receiver_inputs(base_receiver_inputs);
-    baseOTs[i]->exec_base(false);
-    baseSenderInputs[i] = baseOTs[i]->sender_inputs;
-    baseReceiverOutputs[i] = baseOTs[i]->receiver_outputs;
+    bool cached = false;
+    octetStream session;
+
+    if (use_cache)
+    {
+        // both must have stored the same run, fresh seeds for this run
+        vector<octetStream> os(2);
+        os[0].store(cache_ids[i].get_length());
+        os[0].concat(cache_ids[i]);
+        octetStream seed;
+        seed.append_random(SEED_SIZE);
+        os[0].concat(seed);
+        players[i]->send_receive_player(os);
+        octetStream other_id, other_seed;
+        os[1].consume(other_id, os[1].get_int(8));
+        os[1].consume(other_seed, SEED_SIZE);
+        cached = cache_ids[i].get_length() and other_id == cache_ids[i];
+        if (players[i]->my_num() < players[i]->other_player_num())
+            swap(seed, other_seed);
+        other_seed.concat(seed);
+        session = other_seed.hash();
+    }
+
+    if (cached)
+    {
+        baseSenderInputs[i] = cachedSenderInputs[i];
+        baseReceiverOutputs[i] = cachedReceiverOutputs[i];
+    }
+    else
+    {
+        baseOTs[i]->set_receiver_inputs(base_receiver_inputs);
+        baseOTs[i]->exec_base(false);
+        baseSenderInputs[i] = baseOTs[i]->sender_inputs;
+        baseReceiverOutputs[i] = baseOTs[i]->receiver_outputs;
+    }
+
+    if (use_cache)
+    {
+        // use one derivation now and store another for the next run
+        cachedSenderInputs[i] = baseSenderInputs[i];
+        cachedReceiverOutputs[i] = baseReceiverOutputs[i];
+        for (int j = 0; j < nbase; j++)
+        {
+            for (int k = 0; k < 2; k++)
+            {
+                derive(baseSenderInputs[i][j][k], session, 0);
+                derive(cachedSenderInputs[i][j][k], session, 1);
+            }
+            derive(baseReceiverOutputs[i][j], session, 0);
+            derive(cachedReceiverOutputs[i][j], session, 1);
+        }
+        cache_ids[i] = session;
+    }
+}
+
+string OTTripleSetup::get_cache_filename()
+{
+    return PREP_DIR "/BaseOTs-P" + to_string(my_num) + "-T"
+            + to_string(BaseMachine::thread_num);
+}
+
+void OTTripleSetup::load_cache()
+{
+    cache_ids.clear();
+    cache_ids.resize(nparties - 1);
+    cachedSenderInputs.resize(nparties - 1);
+    cachedReceiverOutputs.resize(nparties - 1);
+
+    ifstream in(get_cache_filename(), ios::binary);
+    if (not in.good())
+        return;
+
+    try
+    {
+        octetStream os;
+        os.input(in);
+        if (os.get_int(4) != size_t(nparties))
+            return;
+        BitVector choices;
+        choices.unpack(os);
+        if (choices.size() != size_t(nbase))
+            return;
+        base_receiver_inputs = choices;
+        for (int i = 0; i < nparties - 1; i++)
+        {
+            os.consume(cache_ids[i], os.get_int(8));
+            os.get(cachedSenderInputs[i]);
+            os.get(cachedReceiverOutputs[i]);
+            if (cachedSenderInputs[i].size() != size_t(nbase)
+                    or cachedReceiverOutputs[i].size() != size_t(nbase))
+                throw runtime_error("wrong number of base OTs");
+        }
+    }
+    catch (exception&)
+    {
+        cerr << "Ignoring invalid " << get_cache_filename() << endl;
+        cache_ids.clear();
+        cache_ids.resize(nparties - 1);
+    }
+}
+
+void OTTripleSetup::store_cache()
+{
+    octetStream os;
+    os.store_int(nparties, 4);
+    base_receiver_inputs.pack(os);
+    for (int i = 0; i < nparties - 1; i++)
+    {
+        os.store(cache_ids[i].get_length());
+        os.concat(cache_ids[i]);
+        os.store(cachedSenderInputs[i]);
+        os.store(cachedReceiverOutputs[i]);
+    }
+
+    // replace atomically in case of several setups at the same time
+    string filename = get_cache_filename();
+    string tmp = filename + "-" + to_string(getpid()) + "-"
+            + to_string(G.get_uint());
+    ofstream out(tmp, ios::binary);
+    os.output(out);
+    out.close();
+    if (not out.good() or rename(tmp.c_str(), filename.c_str()))
+    {
+        remove(tmp.c_str());
+        throw file_error(filename);
+    }
 }
 
 void OTTripleSetup::close_connections()
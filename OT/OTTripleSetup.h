@@ -5,6 +5,7 @@
 #include "OT/BaseOT.h"
 #include "Tools/random.h"
 #include "Tools/time-func.h"
+#include "Processor/OnlineOptions.h"
 
 #include <map>
 
@@ -23,6 +24,16 @@ class OTTripleSetup
     int my_num;
     int nbase;
 
+    // base OTs from previous runs (-o base_ot_cache)
+    bool use_cache;
+    vector<octetStream> cache_ids;
+    vector< vector< array<BitVector, 2> > > cachedSenderInputs;
+    vector< vector<BitVector> > cachedReceiverOutputs;
+
+    string get_cache_filename();
+    void load_cache();
+    void store_cache();
+
 public:
     class SetupJob
     {
@@ -54,7 +65,8 @@ public:
     int get_base_receiver_input(int i) const { return base_receiver_inputs[i]; }
 
     OTTripleSetup(Player& N, bool real_OTs = true)
-        : nparties(N.num_players()), my_num(N.my_num()), nbase(128)
+        : nparties(N.num_players()), my_num(N.my_num()), nbase(128),
+          use_cache(real_OTs and OnlineOptions::singleton.has_option("base_ot_cache"))
     {
         base_receiver_inputs.resize(nbase);
         baseOTs.resize(nparties - 1);
@@ -63,8 +63,6 @@ public:
 	    void hash_row(octet* hash, const U& row, const __m128i* coefficients);
 	    template<class U>
 	    void hash_row(__m128i res[2], const U& row, const __m128i* coefficients);
-
-	    static void add_mul(__m128i res[2], __m128i a, __m128i b);
 };
 
 template <class T>
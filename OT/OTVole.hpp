@@ -119,38 +119,33 @@ void OTVoleBase<T>::hash_row(__m128i res[2], const U& row,
 	{
 		for (int j = 0; j < 16; j++)
 			memcpy((char*) buffer + j * T::size(), row[next++].get_ptr(), T::size());
-		for (int j = 0; j < T::size(); j++)
-			add_mul(res, buffer[j], *coefficients++);
+		add_mul128(res, buffer, coefficients, T::size());
+		coefficients += T::size();
 	}
 	for (int j = 0; j < 16; j++)
 		if (next < row.size())
 			memcpy((char*) buffer + j * T::size(), row[next++].get_ptr(), T::size());
 		else
 		    memset((char*) buffer + j * T::size(), 0, T::size());
-	for (int j = 0; j < num_blocks % T::size(); j++)
-		add_mul(res, buffer[j], *coefficients++);
+	add_mul128(res, buffer, coefficients, num_blocks % T::size());
+	coefficients += num_blocks % T::size();
 	assert(coefficients == coeff_base + num_blocks);
 }
 
-template <class T>
-void OTVoleBase<T>::add_mul(__m128i res[2], __m128i a, __m128i b)
-{
-	__m128i prods[2];
-	mul128(a, b, &prods[0], &prods[1]);
-	res[0] ^= prods[0];
-	res[1] ^= prods[1];
-}
-
 template <>
 template <class U>
 inline
 void OTVoleBase<Z2<128>>::hash_row(__m128i res[2],
 		const U& row, const __m128i* coefficients)
 {
-	for (size_t i = 0; i < row.size(); i++)
+	// batches for vectorized multiplication
+	__m128i blocks[48];
+	for (size_t i = 0; i < row.size(); i += 48)
 	{
-		__m128i block = int128(row[i].get_limb(1), row[i].get_limb(0)).a;
-		add_mul(res, block, coefficients[i]);
+		size_t n = min(row.size() - i, size_t(48));
+		for (size_t j = 0; j < n; j++)
+			blocks[j] = int128(row[i + j].get_limb(1), row[i + j].get_limb(0)).a;
+		add_mul128(res, blocks, coefficients + i, n);
 	}
 }
 
@@ -160,27 +155,29 @@ inline
 void OTVoleBase<Z2<192>>::hash_row(__m128i res[2], const U& row,
 		const __m128i* coefficients)
 {
-	__m128i block;
-	size_t j;
-	for (j = 0; j < row.size() - 1; j += 2)
+	__m128i blocks[48];
+	size_t j, n = 0;
+	for (j = 0; j + 1 < row.size(); j += 2)
 	{
 		auto x = row[j];
 		auto y = row[j + 1];
-		block = int128(x.get_limb(1), x.get_limb(0)).a;
-		add_mul(res, block, *coefficients++);
-		block = int128(y.get_limb(0), x.get_limb(2)).a;
-		add_mul(res, block, *coefficients++);
-		block = int128(y.get_limb(2), y.get_limb(1)).a;
-		add_mul(res, block, *coefficients++);
+		blocks[n++] = int128(x.get_limb(1), x.get_limb(0)).a;
+		blocks[n++] = int128(y.get_limb(0), x.get_limb(2)).a;
+		blocks[n++] = int128(y.get_limb(2), y.get_limb(1)).a;
+		if (n == 48)
+		{
+			add_mul128(res, blocks, coefficients, n);
+			coefficients += n;
+			n = 0;
+		}
 	}
 	if (j < row.size())
 	{
 		auto x = row[j];
-		block = int128(x.get_limb(1), x.get_limb(0)).a;
-		add_mul(res, block, *coefficients++);
-		block = int128(x.get_limb(2)).a;
-		add_mul(res, block, *coefficients++);
+		blocks[n++] = int128(x.get_limb(1), x.get_limb(0)).a;
+		blocks[n++] = int128(x.get_limb(2)).a;
 	}
+	add_mul128(res, blocks, coefficients, n);
 }
 
 template <class T>
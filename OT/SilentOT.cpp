@@ -0,0 +1,291 @@
+/*
+ * SilentOT.cpp
+ *
+ */
+
+#include "SilentOT.h"
+#include "OTExtensionWithMatrix.h"
+#include "Tools/aes.h"
+#include "Processor/OnlineOptions.h"
+
+const octet* SilentOT::ggm_key(int i)
+{
+    // fixed keys for correlation-robust doubling
+    static struct Keys
+    {
+        octet keys[2][176] __attribute__((aligned (16)));
+
+        Keys()
+        {
+            for (int j = 0; j < 2; j++)
+            {
+                octet key[AES_BLK_SIZE] = {};
+                key[0] = j + 1;
+                aes_128_schedule(keys[j], key);
+            }
+        }
+    } keys;
+    return keys.keys[i];
+}
+
+void SilentOT::expand(const int128& node, int128& left, int128& right)
+{
+    int128 tmp = node;
+    left = aes_128_encrypt(tmp.a, ggm_key(0)) ^ tmp.a;
+    right = aes_128_encrypt(tmp.a, ggm_key(1)) ^ tmp.a;
+}
+
+void SilentOT::expand_tree(int128 seed, int128* nodes, int128 sums[][2])
+{
+    nodes[0] = seed;
+    for (int l = 0; l < DEPTH; l++)
+    {
+        // in place from the back
+        for (int i = (1 << l) - 1; i >= 0; i--)
+            expand(nodes[i], nodes[2 * i], nodes[2 * i + 1]);
+        sums[l][0] = sums[l][1] = 0;
+        for (int i = 0; i < (2 << l); i++)
+            sums[l][i % 2] ^= nodes[i];
+    }
+}
+
+void SilentOT::puncture_tree(int alpha, const int128* sums, int128* nodes)
+{
+    int path = 0;
+    for (int l = 0; l < DEPTH; l++)
+    {
+        for (int i = (1 << l) - 1; i >= 0; i--)
+            if (i == path)
+                nodes[2 * i] = nodes[2 * i + 1] = 0;
+            else
+                expand(nodes[i], nodes[2 * i], nodes[2 * i + 1]);
+
+        // sibling of the path from the sum of the other side
+        int bit = (alpha >> (DEPTH - 1 - l)) & 1;
+        int128 sibling = sums[l];
+        for (int i = 0; i < (1 << l); i++)
+            if (i != path)
+                sibling ^= nodes[2 * i + 1 - bit];
+        nodes[2 * path + 1 - bit] = sibling;
+        path = 2 * path + bit;
+    }
+    assert(path == alpha);
+}
+
+void SilentOT::compress(vector<int128>& output, vector<int128>& input)
+{
+    assert(input.size() == N_LEAVES);
+    for (size_t i = 1; i < N_LEAVES; i++)
+        input[i] ^= input[i - 1];
+
+    // public code
+    PRNG G;
+    octet seed[SEED_SIZE] = {};
+    G.SetSeed(seed);
+    output.resize(N_OUTPUTS);
+    for (auto& x : output)
+    {
+        x = 0;
+        for (int j = 0; j < ROW_WEIGHT; j++)
+            x ^= input[G.get_uint() % N_LEAVES];
+    }
+}
+
+void SilentOT::compress(BitVector& output, const vector<int>& noise)
+{
+    // accumulated noise vector has runs between noise positions
+    BitVector accumulated(N_LEAVES);
+    for (size_t i = 0; i + 1 < noise.size(); i += 2)
+        for (int j = noise[i]; j < noise[i + 1]; j++)
+            accumulated.set_bit(j, 1);
+    if (noise.size() % 2)
+        for (size_t j = noise.back(); j < N_LEAVES; j++)
+            accumulated.set_bit(j, 1);
+
+    PRNG G;
+    octet seed[SEED_SIZE] = {};
+    G.SetSeed(seed);
+    output.resize(N_OUTPUTS);
+    for (size_t i = 0; i < N_OUTPUTS; i++)
+    {
+        bool x = 0;
+        for (int j = 0; j < ROW_WEIGHT; j++)
+            x ^= accumulated.get_bit(G.get_uint() % N_LEAVES);
+        output.set_bit(i, x);
+    }
+}
+
+SilentOT::SilentOT() :
+        sender_pos(0), receiver_pos(0), generating(false)
+{
+}
+
+void SilentOT::append(vector<int128>& pool, size_t& pos,
+        vector<int128>& leaves)
+{
+    vector<int128> outputs;
+    compress(outputs, leaves);
+    pool.erase(pool.begin(), pool.begin() + pos);
+    pos = 0;
+    pool.insert(pool.end(), outputs.begin(), outputs.end());
+}
+
+void SilentOT::generate(OTExtensionWithMatrix& ext, OT_ROLE role)
+{
+    if (OnlineOptions::singleton.has_option("verbose_ot"))
+        fprintf(stderr, "silent OT batch of %zu as %s\n", N_OUTPUTS,
+                role_to_str(role));
+
+    generating = true;
+    auto old_role = ext.ot_role;
+
+    // random punctured positions
+    int n_base = N_TREES * DEPTH;
+    BitVector choices(n_base);
+    vector<int> alphas(N_TREES);
+    if (role & RECEIVER)
+        for (int j = 0; j < N_TREES; j++)
+        {
+            alphas[j] = ext.G.get_uint(1 << DEPTH);
+            for (int l = 0; l < DEPTH; l++)
+                choices.set_bit(j * DEPTH + l,
+                        not ((alphas[j] >> (DEPTH - 1 - l)) & 1));
+        }
+
+    ext.set_role(role);
+    ext.extend(n_base, choices);
+
+    vector<octetStream> os(2);
+    vector<int128> leaves;
+
+    if (role & SENDER)
+    {
+        int128 delta = ext.baseReceiverInput.get_int128(0);
+        leaves.resize(N_LEAVES);
+        for (int j = 0; j < N_TREES; j++)
+        {
+            int128 sums[DEPTH][2];
+            auto tree = &leaves[j << DEPTH];
+            expand_tree(ext.G.get_doubleword(), tree, sums);
+            for (int l = 0; l < DEPTH; l++)
+                for (int b = 0; b < 2; b++)
+                {
+                    int128 pad = _mm_loadu_si128(
+                            (__m128i*) ext.get_sender_output(b, j * DEPTH + l));
+                    int128 message = sums[l][b] ^ pad;
+                    os[0].append((octet*) &message, sizeof(message));
+                }
+            int128 total = delta ^ sums[DEPTH - 1][0] ^ sums[DEPTH - 1][1];
+            os[0].append((octet*) &total, sizeof(total));
+        }
+    }
+
+    send_if_ot_sender(ext.player, os, role);
+
+    if (role & SENDER)
+    {
+        append(sender_pool, sender_pos, leaves);
+    }
+
+    if (role & RECEIVER)
+    {
+        leaves.resize(N_LEAVES);
+        vector<int> noise;
+        for (int j = 0; j < N_TREES; j++)
+        {
+            int128 sums[DEPTH];
+            for (int l = 0; l < DEPTH; l++)
+            {
+                int128 messages[2];
+                os[1].consume((octet*) messages, sizeof(messages));
+                int128 pad = _mm_loadu_si128(
+                        (__m128i*) ext.get_receiver_output(j * DEPTH + l));
+                sums[l] = messages[choices.get_bit(j * DEPTH + l)] ^ pad;
+            }
+            int128 total;
+            os[1].consume((octet*) &total, sizeof(total));
+
+            auto tree = &leaves[j << DEPTH];
+            puncture_tree(alphas[j], sums, tree);
+            for (int i = 0; i < (1 << DEPTH); i++)
+                total ^= tree[i];
+            tree[alphas[j]] = total;
+            noise.push_back((j << DEPTH) + alphas[j]);
+        }
+
+        BitVector new_choices;
+        compress(new_choices, noise);
+        size_t n_left = receiver_choices.size() - receiver_pos;
+        BitVector all_choices(n_left + N_OUTPUTS);
+        for (size_t i = 0; i < n_left; i++)
+            all_choices.set_bit(i, receiver_choices.get_bit(receiver_pos + i));
+        for (size_t i = 0; i < N_OUTPUTS; i++)
+            all_choices.set_bit(n_left + i, new_choices.get_bit(i));
+        receiver_choices = all_choices;
+        append(receiver_pool, receiver_pos, leaves);
+        assert(receiver_pool.size() == receiver_choices.size());
+    }
+
+    ext.set_role(old_role);
+    generating = false;
+}
+
+void SilentOT::extend(OTExtensionWithMatrix& ext, int n_OTs,
+        const BitVector& choices)
+{
+    auto role = ext.ot_role;
+    size_t n = DIV_CEIL(n_OTs, 128) * 128;
+
+    // the other party needs the same in the opposite role
+    while (true)
+    {
+        int needed = 0;
+        if ((role & SENDER) and sender_pool.size() - sender_pos < n)
+            needed |= SENDER;
+        if ((role & RECEIVER) and receiver_pool.size() - receiver_pos < n)
+            needed |= RECEIVER;
+        if (needed)
+            generate(ext, OT_ROLE(needed));
+        else
+            break;
+    }
+
+    ext.resize(n);
+    vector<octetStream> os(2);
+
+    if (role & RECEIVER)
+    {
+        if (choices.size() != size_t(n_OTs))
+            throw runtime_error("wrong number of choice bits");
+        // correct random choices to the desired
+        BitVector correction(n);
+        for (int i = 0; i < n_OTs; i++)
+            correction.set_bit(i,
+                    choices.get_bit(i)
+                            ^ receiver_choices.get_bit(receiver_pos + i));
+        correction.pack(os[0]);
+        for (size_t i = 0; i < n; i++)
+            ext.receiverOutputMatrix[i] = receiver_pool[receiver_pos + i].a;
+        receiver_pos += n;
+    }
+
+    send_if_ot_receiver(ext.player, os, role);
+
+    if (role & SENDER)
+    {
+        int128 delta = ext.baseReceiverInput.get_int128(0);
+        BitVector correction;
+        correction.unpack(os[1]);
+        if (correction.size() != n)
+            throw runtime_error("wrong number of choice corrections");
+        for (size_t i = 0; i < n; i++)
+        {
+            int128 q = sender_pool[sender_pos + i];
+            if (correction.get_bit(i))
+                q ^= delta;
+            ext.senderOutputMatrices[0][i] = q.a;
+            ext.senderOutputMatrices[1][i] = (q ^ delta).a;
+        }
+        sender_pos += n;
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * SilentOT.h
+ *
+ */
+
+#ifndef OT_SILENTOT_H_
+#define OT_SILENTOT_H_
+
+#include "Math/gf2nlong.h"
+#include "Tools/BitVector.h"
+#include "Tools/random.h"
+#include "OT/BaseOT.h"
+
+#include <vector>
+using namespace std;
+
+class OTExtensionWithMatrix;
+
+/**
+ * Correlated OT with communication sublinear in the number of OTs
+ * (``-o silent_ot``). Every batch uses a few thousand OTs from the
+ * usual extension to obtain a sparse correlation via GGM trees, one
+ * for each noise position, which is compressed using an
+ * expand-accumulate code (dual LPN). The parties then exchange one
+ * bit per OT to use the receiver's choice bits.
+ */
+class SilentOT
+{
+    // leaves per tree and noise weight
+    static const int DEPTH = 11;
+    static const int N_TREES = 512;
+    static const size_t N_LEAVES = N_TREES << DEPTH;
+    // number of correlations per batch
+    static const size_t N_OUTPUTS = N_LEAVES / 2;
+    // non-zero entries per row of the expanding matrix
+    static const int ROW_WEIGHT = 7;
+
+    // random correlated OTs not used yet
+    vector<int128> sender_pool, receiver_pool;
+    BitVector receiver_choices;
+    size_t sender_pos, receiver_pos;
+
+    bool generating;
+
+    static const octet* ggm_key(int i);
+
+    void generate(OTExtensionWithMatrix& ext, OT_ROLE role);
+    void append(vector<int128>& pool, size_t& pos, vector<int128>& leaves);
+
+public:
+    /// Children of GGM tree node
+    static void expand(const int128& node, int128& left, int128& right);
+    /// Expand GGM tree, store leaves and XOR of left and right nodes per level
+    static void expand_tree(int128 seed, int128* leaves, int128 sums[][2]);
+    /// Reconstruct all leaves but one from the XOR sums on the other side
+    static void puncture_tree(int alpha, const int128* sums, int128* leaves);
+    /// Apply compressing matrix (transpose of expand-accumulate)
+    static void compress(vector<int128>& output, vector<int128>& input);
+    static void compress(BitVector& output, const vector<int>& noise);
+
+    SilentOT();
+
+    bool active() { return not generating; }
+
+    /// Correlated OTs with the given choices and the extension's correlation
+    void extend(OTExtensionWithMatrix& ext, int n_OTs,
+            const BitVector& choices);
+};
+
+#endif /* OT_SILENTOT_H_ */
@@ -108,15 +108,17 @@ public:
     {
         assert(a.size() == M);
         this->b = b;
+        // same stream as one randomize() per row
+        octet random[M * U::N_BYTES];
         for (int i = 0; i < N; i++)
         {
             U aa = 0, cc = 0;
+            G.get_octets(random, sizeof(random));
             for (int j = 0; j < M; j++)
             {
                 U r;
-                r.randomize(G);
-                if (a.get_bit(j))
-                    aa += r;
+                r.assign(random + j * U::N_BYTES);
+                aa += r * a.get_bit(j);
                 cc += U::Mul(r, c.rows[j]);
             }
             this->a[i] = aa;
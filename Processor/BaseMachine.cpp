@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <sodium.h>
+#include <math.h>
 using namespace std;
 
 BaseMachine* BaseMachine::singleton = 0;
@@ -104,7 +105,7 @@ int BaseMachine::matrix_requirement(int n_rows, int n_inner, int n_cols)
 }
 
 BaseMachine::BaseMachine() :
-    nthreads(0), multithread(false), nan_warning(0)
+    nthreads(0), multithread(false), parallel_tapes(false), nan_warning(0)
 {
   if (sodium_init() == -1)
     throw runtime_error("couldn't initialize libsodium");
@@ -315,14 +316,63 @@ void BaseMachine::set_thread_comm(const NamedCommStats& stats)
   queue->set_comm_stats(stats);
 }
 
+void BaseMachine::probe_network(Player& P, size_t item_size)
+{
+  auto& opts = OnlineOptions::singleton;
+  bool tune = opts.has_option("auto_tune");
+  if (not (tune or opts.has_option("probe_network")))
+    return;
+
+  network.run(P);
+  if (opts.verbose or not tune)
+    network.print(P);
+  if (not tune)
+    return;
+
+  // all parties derive the same values from the agreed measurement
+  double bdp = network.bandwidth_delay_product();
+
+  // keep the slowest link busy during a preprocessing round
+  long n_items = bdp / max(item_size, size_t(1));
+  if (n_items > opts.batch_size)
+    opts.batch_size = min(long(ceil(n_items / 1000.)) * 1000, 1l << 20);
+
+  // the following only pay off beyond local networks
+  if (network.max_rtt >= 1e-3)
+    {
+      // a deferred check takes a round trip, which should not be more
+      // than a few percent of sending the accumulated values
+      if (opts.mac_check_buffer == 0)
+        opts.mac_check_buffer = min(max(int(ceil(16 * bdp / (1 << 20))), 1),
+            1024);
+
+      if (opts.option_value("coalesce").empty()
+          and not opts.has_option("coalesce")
+          and not opts.has_option("multiplex")
+          and not opts.has_option("io_uring"))
+        opts.options.push_back(
+            "coalesce=" + to_string(min(long(network.max_rtt * 5e4), 1000l)));
+    }
+
+  if (opts.verbose)
+    cerr << "Tuned to network: batch size " << opts.batch_size
+        << ", MAC check buffer " << opts.mac_check_buffer << " MB, "
+        << "coalescing " << opts.option_value("coalesce", "0")
+        << " microseconds" << endl;
+}
+
 void BaseMachine::print_global_comm(Player& P, const NamedCommStats& stats)
 {
   Bundle<octetStream> bundle(P);
   bundle.mine.store(stats.sent);
   P.Broadcast_Receive_no_stats(bundle);
   size_t global = 0;
+  global_sent.clear();
   for (auto& os : bundle)
-    global += os.get_int(8);
+    {
+      global_sent.push_back(os.get_int(8));
+      global += global_sent.back();
+    }
   cerr << "Global data sent = " << global / 1e6 << " MB (all parties)" << endl;
 }
 
@@ -13,6 +13,7 @@
 #include "ThreadQueues.h"
 #include "Program.h"
 #include "OnlineOptions.h"
+#include "Networking/NetworkProbe.h"
 
 #include <map>
 #include <fstream>
@@ -44,19 +45,20 @@ protected:
 
     static BaseMachine get_basics(string progname);
 
-    static DataPositions get_offline_data_used();
-
 public:
     static thread_local int thread_num;
 
     string progname;
     int nthreads;
     bool multithread;
+    // whether tapes of the current program might run at the same time
+    bool parallel_tapes;
 
     ThreadQueues queues;
 
     vector<string> bc_filenames;
 
+    // decoded tapes, shared by all threads
     vector<Program> progs;
 
     bool nan_warning;
@@ -64,6 +66,9 @@ public:
     static BaseMachine& s();
     static bool has_singleton() { return singleton != 0; }
     static bool has_program();
+    // program executed by current thread
+    static const Program* current_program() { return program; }
+    static DataPositions get_offline_data_used();
 
     static string memory_filename(const string& type_short, int my_number);
 
@@ -106,6 +111,14 @@ public:
     NamedCommStats total_comm();
     void set_thread_comm(const NamedCommStats& stats);
 
+    // data sent by every party, set by print_global_comm()
+    vector<size_t> global_sent;
+
+    // measured at startup with -o probe_network or -o auto_tune
+    NetworkProbe network;
+
+    void probe_network(Player& P, size_t item_size);
+
     void print_global_comm(Player& P, const NamedCommStats& stats);
     void print_comm(Player& P, const NamedCommStats& stats);
 
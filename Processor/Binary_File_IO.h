@@ -2,6 +2,7 @@
 #define _FILE_IO_HEADER
 
 #include "Tools/Exceptions.h"
+#include "Tools/AsyncFileWriter.h"
 
 #include <string>
 #include <sstream>
@@ -12,18 +13,33 @@ using namespace std;
 
 /* 
  * Provides generalised file read and write methods for arrays of numeric data types.
- * Stateless and not optimised for multiple reads from file.
+ * Keeps the file open and writes in the background, in blocks per call.
  * Intended for MPC application specific file IO.
  */
 
 template<class T>
 class Binary_File_IO
 {
+  int fd;
+  string open_filename;
+  long data_start;
+
+  void open(const string& filename);
+
   public:
 
   static string filename(int my_number);
   static void reset(int my_number);
 
+  // shared by all threads so that reading waits for all writes
+  static AsyncFileWriter& writer();
+
+  Binary_File_IO();
+  // copies open the file again when needed
+  Binary_File_IO(const Binary_File_IO&) : Binary_File_IO() {}
+  Binary_File_IO& operator=(const Binary_File_IO&) = delete;
+  ~Binary_File_IO();
+
   /*
    * Append the buffer values as binary to the filename.
    * Throws file_error.   
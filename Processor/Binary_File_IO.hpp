@@ -1,8 +1,11 @@
 #include "Processor/Binary_File_IO.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
 /* 
  * Provides generalised file read and write methods for arrays of shares.
- * Stateless and not optimised for multiple reads from file.
  * Intended for application specific file IO.
  */
 
@@ -34,23 +37,74 @@ void Binary_File_IO<T>::reset(int my_number)
 }
 
 template<class T>
-void Binary_File_IO<T>::write_to_file(const string filename,
-    const vector<T>& buffer, long start_pos)
+Binary_File_IO<T>::Binary_File_IO() :
+    fd(-1), data_start(-1)
+{
+}
+
+template<class T>
+Binary_File_IO<T>::~Binary_File_IO()
+{
+  if (fd >= 0)
+    {
+      try
+      {
+          writer().flush();
+      }
+      catch (exception& e)
+      {
+          cerr << "Error in writing to " << open_filename << ": " << e.what()
+              << endl;
+      }
+      close(fd);
+    }
+}
+
+template<class T>
+AsyncFileWriter& Binary_File_IO<T>::writer()
 {
-  ofstream outf;
+  static AsyncFileWriter writer;
+  return writer;
+}
 
-  outf.open(filename, ios::out | ios::binary | ios::ate | ios::in);
-  if (outf.fail()) { throw file_error(filename); }
+template<class T>
+void Binary_File_IO<T>::open(const string& filename)
+{
+  if (fd >= 0 and filename == open_filename)
+    return;
 
-  if (start_pos != -1)
+  if (fd >= 0)
     {
-      long write_pos = file_signature<T>().get_total_length() + start_pos * T::size();
-      // fill with zeros if needed
-      for (long i = outf.tellp(); i < write_pos; i++)
-        outf.put(0);
-      outf.seekp(write_pos);
+      writer().flush();
+      close(fd);
     }
 
+  fd = ::open(filename.c_str(), O_RDWR);
+  if (fd < 0)
+    throw file_missing(filename,
+        "Binary_File_IO expects this file to exist.");
+  open_filename = filename;
+  data_start = -1;
+}
+
+template<class T>
+void Binary_File_IO<T>::write_to_file(const string filename,
+    const vector<T>& buffer, long start_pos)
+{
+  try
+  {
+      open(filename);
+  }
+  catch (file_missing&)
+  {
+      throw file_error(filename);
+  }
+
+  // serialize into one block
+  vector<char> data;
+  data.reserve(buffer.size() * T::size());
+  AsyncFileWriter::OutputBuffer output_buffer(data);
+  ostream outf(&output_buffer);
   for (unsigned int i = 0; i < buffer.size(); i++)
   {
     buffer[i].output(outf, false);
@@ -59,65 +113,66 @@ void Binary_File_IO<T>::write_to_file(const string filename,
   if (outf.fail())
     throw runtime_error("failed writing to " + filename);
 
-  outf.close();
+  // missing data before the position reads as zeros
+  long write_pos = -1;
+  if (start_pos != -1)
+    write_pos = file_signature<T>().get_total_length() + start_pos * T::size();
+  writer().write(fd, filename, write_pos, data);
 }
 
 template<class T>
 void Binary_File_IO<T>::read_from_file(const string filename, vector<T>& buffer,
     const long start_posn, long& end_posn)
 {
-  ifstream inf;
-  inf.open(filename, ios::in | ios::binary);
-  if (inf.fail()) { throw file_missing(filename, "Binary_File_IO.read_from_file expects this file to exist."); }
-
-  try
-  {
-    check_file_signature<T>(inf, filename).get_length();
-  }
-  catch (exception& e)
-  {
-    throw persistence_error(e.what());
-  }
+  // include data written by any thread
+  writer().flush();
+  open(filename);
 
-  auto data_start = inf.tellg();
+  if (data_start < 0)
+    {
+      ifstream inf(filename, ios::in | ios::binary);
+      try
+      {
+        check_file_signature<T>(inf, filename).get_length();
+      }
+      catch (exception& e)
+      {
+        throw persistence_error(e.what());
+      }
+      data_start = inf.tellg();
+    }
 
-  int size_in_bytes = T::size() * buffer.size();
-  int n_read = 0;
-  char* read_buffer = new char[size_in_bytes];
-  inf.seekg(start_posn * T::size(), iostream::cur);
-  do
+  size_t size_in_bytes = T::size() * buffer.size();
+  size_t n_read = 0;
+  vector<char> read_buffer(size_in_bytes);
+  long offset = data_start + start_posn * T::size();
+  while (n_read < size_in_bytes)
   {
-      inf.read(read_buffer + n_read, size_in_bytes - n_read);
-      n_read += inf.gcount();
-
-      if (inf.eof())
+      auto res = pread(fd, read_buffer.data() + n_read,
+          size_in_bytes - n_read, offset + n_read);
+      if (res == 0)
       {
         stringstream ss;
         ss << "Got to EOF when reading from disk (expecting " << size_in_bytes
-            << " bytes from " << (long(data_start) + start_posn * T::size())
-            << ").";
+            << " bytes from " << offset << ").";
         throw persistence_error(ss.str());
       }
-      if (inf.fail())
+      if (res < 0)
       {
         stringstream ss;
         ss << "IO problem when reading from disk";
         throw persistence_error(ss.str());
       }
+      n_read += res;
   }
-  while (n_read < size_in_bytes);
 
-  end_posn = (inf.tellg() - data_start) / T::size();
-  assert (end_posn == start_posn + int(buffer.size()));
+  end_posn = start_posn + buffer.size();
 
-  //Check if at end of file by getting 1 more char.
-  inf.get();
-  if (inf.eof())
+  // check if at end of file
+  struct stat buf;
+  if (fstat(fd, &buf) == 0 and offset + long(size_in_bytes) >= buf.st_size)
     end_posn = -1;
-  inf.close();
 
   for (unsigned int i = 0; i < buffer.size(); i++)
     buffer[i].assign(&read_buffer[i*T::size()]);
-
-  delete[] read_buffer;
 }
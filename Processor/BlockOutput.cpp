@@ -0,0 +1,55 @@
+/*
+ * BlockOutput.cpp
+ *
+ */
+
+#include "BlockOutput.h"
+#include "Tools/Exceptions.h"
+
+#include <iostream>
+#include <cstring>
+#include <cassert>
+#include <fcntl.h>
+#include <unistd.h>
+
+BlockOutput::BlockOutput() :
+        fd(-1)
+{
+}
+
+BlockOutput::~BlockOutput()
+{
+    if (fd < 0)
+        return;
+
+    try
+    {
+        writer.flush();
+    }
+    catch (exception& e)
+    {
+        cerr << "Error in writing to " << filename << ": " << e.what()
+                << endl;
+    }
+    close(fd);
+}
+
+void BlockOutput::write(const string& filename, const int64_t* values,
+        size_t n, int precision)
+{
+    if (fd < 0)
+    {
+        fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            throw file_error(filename);
+        this->filename = filename;
+    }
+    else
+        assert(filename == this->filename);
+
+    int64_t header[] = {int64_t(n), precision};
+    vector<char> block(sizeof(header) + n * sizeof(int64_t));
+    memcpy(block.data(), header, sizeof(header));
+    memcpy(block.data() + sizeof(header), values, n * sizeof(int64_t));
+    writer.write(fd, filename, -1, block);
+}
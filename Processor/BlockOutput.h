@@ -0,0 +1,33 @@
+/*
+ * BlockOutput.h
+ *
+ */
+
+#ifndef PROCESSOR_BLOCKOUTPUT_H_
+#define PROCESSOR_BLOCKOUTPUT_H_
+
+#include "Tools/AsyncFileWriter.h"
+
+/**
+ * Binary output of whole vectors in
+ * ``Player-Data/Block-Output-P<player>-<thread>``. Every block consists
+ * of the number of values and the fixed-point precision followed by
+ * the values, all as 64-bit integers in machine byte order. Blocks are
+ * written by a background thread.
+ */
+class BlockOutput
+{
+    string filename;
+    int fd;
+    AsyncFileWriter writer;
+
+public:
+    BlockOutput();
+    ~BlockOutput();
+
+    /// Queue values for writing, truncating the file on first use
+    void write(const string& filename, const int64_t* values, size_t n,
+            int precision);
+};
+
+#endif /* PROCESSOR_BLOCKOUTPUT_H_ */
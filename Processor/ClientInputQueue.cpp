@@ -0,0 +1,160 @@
+/*
+ * ClientInputQueue.cpp
+ *
+ */
+
+#include "ClientInputQueue.h"
+#include <stdexcept>
+
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+ClientInputQueue::ClientInputQueue() :
+        done(false)
+{
+    if (pipe(wake) != 0)
+        throw runtime_error("cannot create pipe for client input");
+    reader = thread(&ClientInputQueue::run, this);
+}
+
+ClientInputQueue::~ClientInputQueue()
+{
+    {
+        lock_guard<mutex> _(lock);
+        done = true;
+    }
+    notify();
+    reader.join();
+    close(wake[0]);
+    close(wake[1]);
+}
+
+int ClientInputQueue::fd(client_socket* socket)
+{
+#ifdef NO_CLIENT_TLS
+    return socket->socket;
+#else
+    return socket->fd();
+#endif
+}
+
+void ClientInputQueue::notify()
+{
+    char c = 0;
+    if (write(wake[1], &c, 1) != 1)
+        throw runtime_error("cannot wake up client input thread");
+}
+
+void ClientInputQueue::expect(client_socket* socket, int client_id, long slot)
+{
+    {
+        lock_guard<mutex> _(lock);
+        if (not expected.insert({fd(socket), {socket, client_id, slot}}).second)
+            throw runtime_error(
+                    "already expecting input from client "
+                            + to_string(client_id));
+    }
+    notify();
+}
+
+void ClientInputQueue::run()
+{
+    vector<pollfd> fds;
+    while (true)
+    {
+        fds.clear();
+        fds.push_back({wake[0], POLLIN, 0});
+        {
+            lock_guard<mutex> _(lock);
+            if (done)
+                return;
+            for (auto& x : expected)
+                fds.push_back({x.first, POLLIN, 0});
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw runtime_error("poll on client sockets failed");
+        }
+
+        if (fds[0].revents)
+        {
+            char buf[256];
+            if (read(wake[0], buf, sizeof(buf)) < 0)
+                throw runtime_error("cannot read from wake-up pipe");
+        }
+
+        for (size_t i = 1; i < fds.size(); i++)
+        {
+            if (not fds[i].revents)
+                continue;
+
+            Expected source;
+            {
+                lock_guard<mutex> _(lock);
+                source = expected.at(fds[i].fd);
+            }
+
+            // The message is received completely once the first bytes
+            // arrive. This assumes that a TLS layer has not buffered
+            // the data already, which holds because clients only send
+            // after receiving the masks for this message.
+            Submission submission;
+            submission.client_id = source.client_id;
+            submission.slot = source.slot;
+            try
+            {
+                submission.os.Receive(source.socket);
+            }
+            catch (exception& e)
+            {
+                submission.error = e.what();
+            }
+
+            lock_guard<mutex> _(lock);
+            expected.erase(fds[i].fd);
+            ready.push_back(move(submission));
+            ready_cond.notify_all();
+        }
+    }
+}
+
+vector<ClientInputQueue::Submission> ClientInputQueue::take(size_t n)
+{
+    unique_lock<mutex> guard(lock);
+    if (ready.size() + expected.size() < n)
+        throw runtime_error(
+                "waiting for " + to_string(n) + " client inputs but only "
+                        + to_string(ready.size() + expected.size())
+                        + " expected");
+
+    ready_cond.wait(guard, [this, n]() { return ready.size() >= n; });
+
+    vector<Submission> res;
+    for (size_t i = 0; i < n; i++)
+    {
+        auto& submission = ready.front();
+        if (not submission.error.empty())
+            throw runtime_error(
+                    "input from client " + to_string(submission.client_id)
+                            + " failed: " + submission.error);
+        res.push_back(move(submission));
+        ready.pop_front();
+    }
+    return res;
+}
+
+size_t ClientInputQueue::n_expected()
+{
+    lock_guard<mutex> _(lock);
+    return expected.size();
+}
+
+size_t ClientInputQueue::n_ready()
+{
+    lock_guard<mutex> _(lock);
+    return ready.size();
+}
@@ -0,0 +1,78 @@
+/*
+ * ClientInputQueue.h
+ *
+ */
+
+#ifndef PROCESSOR_CLIENTINPUTQUEUE_H_
+#define PROCESSOR_CLIENTINPUTQUEUE_H_
+
+#include "ExternalIO/Client.h"
+#include "Tools/octetStream.h"
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+using namespace std;
+
+/**
+ * Background reception of client submissions. A separate thread
+ * waits for any of the registered sockets to become readable and
+ * receives one message from it, so that the virtual machine can take
+ * submissions in the order they complete instead of waiting for
+ * clients one by one. A socket must not be used otherwise between
+ * registration and taking the submission.
+ */
+class ClientInputQueue
+{
+public:
+    struct Submission
+    {
+        int client_id;
+        long slot;
+        octetStream os;
+        string error;
+    };
+
+private:
+    struct Expected
+    {
+        client_socket* socket;
+        int client_id;
+        long slot;
+    };
+
+    mutex lock;
+    condition_variable ready_cond;
+
+    // by file descriptor
+    map<int, Expected> expected;
+    deque<Submission> ready;
+
+    // wakes up the thread for new registrations and shutdown
+    int wake[2];
+    bool done;
+    thread reader;
+
+    static int fd(client_socket* socket);
+
+    void run();
+    void notify();
+
+public:
+    ClientInputQueue();
+    ~ClientInputQueue();
+
+    /// Receive the next message from ``socket`` in the background
+    void expect(client_socket* socket, int client_id, long slot);
+
+    /// Wait for ``n`` submissions in order of completion
+    vector<Submission> take(size_t n);
+
+    size_t n_expected();
+    size_t n_ready();
+};
+
+#endif /* PROCESSOR_CLIENTINPUTQUEUE_H_ */
@@ -0,0 +1,110 @@
+/*
+ * ClientOutputQueue.cpp
+ *
+ */
+
+#include "ClientOutputQueue.h"
+#include <stdexcept>
+
+ClientOutputQueue::ClientOutputQueue(int n_threads) :
+        done(false)
+{
+    for (int i = 0; i < n_threads; i++)
+        workers.push_back(thread(&ClientOutputQueue::run, this));
+}
+
+ClientOutputQueue::~ClientOutputQueue()
+{
+    {
+        unique_lock<mutex> guard(lock);
+        cond.wait(guard, [this]() { return pending.empty(); });
+        done = true;
+    }
+    cond.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void ClientOutputQueue::send(client_socket* socket, int client_id,
+        octetStream& os)
+{
+    {
+        lock_guard<mutex> _(lock);
+        check();
+        jobs.push_back({socket, client_id, {}});
+        jobs.back().os.swap(os);
+        pending[socket]++;
+    }
+    cond.notify_all();
+}
+
+void ClientOutputQueue::run()
+{
+    unique_lock<mutex> guard(lock);
+    while (true)
+    {
+        // first job for a client not being served by another thread
+        auto it = jobs.begin();
+        while (it != jobs.end() and busy[it->socket])
+            it++;
+
+        if (it == jobs.end())
+        {
+            if (done)
+                return;
+            cond.wait(guard);
+            continue;
+        }
+
+        Job job;
+        job.socket = it->socket;
+        job.client_id = it->client_id;
+        job.os.swap(it->os);
+        jobs.erase(it);
+        busy[job.socket] = true;
+
+        guard.unlock();
+        string message;
+        try
+        {
+            job.os.Send(job.socket);
+        }
+        catch (exception& e)
+        {
+            message = "output to client " + to_string(job.client_id)
+                    + " failed: " + e.what();
+        }
+        guard.lock();
+
+        if (not message.empty() and error.empty())
+            error = message;
+        busy.erase(job.socket);
+        if (--pending[job.socket] == 0)
+            pending.erase(job.socket);
+        cond.notify_all();
+    }
+}
+
+void ClientOutputQueue::check()
+{
+    if (not error.empty())
+    {
+        string message = error;
+        error.clear();
+        throw runtime_error(message);
+    }
+}
+
+void ClientOutputQueue::wait(client_socket* socket)
+{
+    unique_lock<mutex> guard(lock);
+    cond.wait(guard, [this, socket]() { return not pending.count(socket); });
+    check();
+}
+
+void ClientOutputQueue::wait_all()
+{
+    unique_lock<mutex> guard(lock);
+    cond.wait(guard, [this]() { return pending.empty(); });
+    check();
+}
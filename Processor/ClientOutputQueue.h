@@ -0,0 +1,62 @@
+/*
+ * ClientOutputQueue.h
+ *
+ */
+
+#ifndef PROCESSOR_CLIENTOUTPUTQUEUE_H_
+#define PROCESSOR_CLIENTOUTPUTQUEUE_H_
+
+#include "ExternalIO/Client.h"
+#include "Tools/octetStream.h"
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+using namespace std;
+
+/**
+ * Background sending to clients. Several threads send concurrently
+ * so that a slow client only delays its own messages, while messages
+ * to the same client keep their order.
+ */
+class ClientOutputQueue
+{
+    struct Job
+    {
+        client_socket* socket;
+        int client_id;
+        octetStream os;
+    };
+
+    mutex lock;
+    condition_variable cond;
+
+    deque<Job> jobs;
+    // queued or being sent
+    map<client_socket*, size_t> pending;
+    map<client_socket*, bool> busy;
+    string error;
+
+    bool done;
+    vector<thread> workers;
+
+    void run();
+    void check();
+
+public:
+    ClientOutputQueue(int n_threads);
+    ~ClientOutputQueue();
+
+    /// Send ``os`` in the background, which is left empty
+    void send(client_socket* socket, int client_id, octetStream& os);
+
+    /// Wait until all messages to ``socket`` have been sent
+    void wait(client_socket* socket);
+    /// Wait until all messages have been sent
+    void wait_all();
+};
+
+#endif /* PROCESSOR_CLIENTOUTPUTQUEUE_H_ */
@@ -0,0 +1,42 @@
+/*
+ * ColumnFile.h
+ *
+ */
+
+#ifndef PROCESSOR_COLUMNFILE_H_
+#define PROCESSOR_COLUMNFILE_H_
+
+#include <string>
+#include <fstream>
+using namespace std;
+
+/**
+ * Secret-shared table column in
+ * ``Persistence/Columns/<name>-P<player>.data``. The file starts with
+ * the same signature as persistence files followed by the bit length
+ * and fixed-point precision of the column, and the shares follow in
+ * the persistence format. Loading a range only requires reading one
+ * block without parsing.
+ */
+template<class T>
+class ColumnFile
+{
+    string filename;
+    int bit_length, precision;
+
+    // returns the header length
+    size_t check_header(ifstream& file);
+
+public:
+    static string get_filename(const string& name, int my_num);
+
+    ColumnFile(const string& name, int my_num, int bit_length,
+            int precision);
+
+    /// Append ``n`` shares, creating the file if needed
+    void append(const T* source, size_t n);
+    /// Read ``n`` shares from row ``start``
+    void read(T* dest, size_t start, size_t n);
+};
+
+#endif /* PROCESSOR_COLUMNFILE_H_ */
@@ -0,0 +1,109 @@
+/*
+ * ColumnFile.hpp
+ *
+ */
+
+#include "ColumnFile.h"
+#include "Tools/Buffer.h"
+#include "Tools/mkpath.h"
+#include "Tools/AsyncFileWriter.h"
+
+template<class T>
+string ColumnFile<T>::get_filename(const string& name, int my_num)
+{
+    return "Persistence/Columns/" + name + "-P" + to_string(my_num) + ".data";
+}
+
+template<class T>
+ColumnFile<T>::ColumnFile(const string& name, int my_num, int bit_length,
+        int precision) :
+        filename(get_filename(name, my_num)), bit_length(bit_length),
+        precision(precision)
+{
+}
+
+template<class T>
+size_t ColumnFile<T>::check_header(ifstream& file)
+{
+    try
+    {
+        check_file_signature<T>(file, filename);
+    }
+    catch (exception& e)
+    {
+        throw persistence_error(e.what());
+    }
+
+    octetStream metadata;
+    metadata.input(file);
+    int file_bit_length = metadata.get<int>();
+    int file_precision = metadata.get<int>();
+    if (file_bit_length != bit_length or file_precision != precision)
+        throw persistence_error(
+                filename + " has bit length " + to_string(file_bit_length)
+                        + " and precision " + to_string(file_precision)
+                        + " instead of " + to_string(bit_length) + " and "
+                        + to_string(precision));
+
+    return file.tellg();
+}
+
+template<class T>
+void ColumnFile<T>::append(const T* source, size_t n)
+{
+    ifstream in(filename, ios::binary);
+    if (in.good())
+        check_header(in);
+    else
+    {
+        auto dir = filename.substr(0, filename.rfind('/'));
+        mkdir_p(dir.c_str());
+        ofstream out(filename, ios::binary);
+        file_signature<T>().output(out);
+        octetStream metadata;
+        metadata.store(bit_length);
+        metadata.store(precision);
+        metadata.output(out);
+        if (out.fail())
+            throw file_error(filename);
+    }
+
+    // serialize into one block
+    vector<char> data;
+    data.reserve(n * T::size());
+    AsyncFileWriter::OutputBuffer buffer(data);
+    ostream os(&buffer);
+    for (size_t i = 0; i < n; i++)
+        source[i].output(os, false);
+
+    ofstream out(filename, ios::binary | ios::app);
+    out.write(data.data(), data.size());
+    if (out.fail())
+        throw runtime_error("failed writing to " + filename);
+}
+
+template<class T>
+void ColumnFile<T>::read(T* dest, size_t start, size_t n)
+{
+    ifstream in(filename, ios::binary);
+    if (in.fail())
+        throw file_missing(filename, "column not found");
+
+    size_t header_length = check_header(in);
+    in.seekg(0, ios::end);
+    size_t n_rows = (size_t(in.tellg()) - header_length) / T::size();
+    if (start + n > n_rows)
+        throw persistence_error(
+                "cannot read rows " + to_string(start) + " to "
+                        + to_string(start + n) + " from " + filename
+                        + " with " + to_string(n_rows) + " rows");
+
+    vector<char> data(n * T::size());
+    in.seekg(header_length + start * T::size());
+    in.read(data.data(), data.size());
+    if (in.fail())
+        throw persistence_error("IO problem when reading " + filename);
+
+    for (size_t i = 0; i < n; i++)
+        dest[i].assign(&data[i * T::size()]);
+}
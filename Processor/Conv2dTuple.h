@@ -31,6 +31,8 @@ public:
 
     array<int, 3> matrix_dimensions();
 
+    bool same_input(const Conv2dTuple& other) const;
+
     template<class T>
     void pre(StackedVector<T>& S, typename T::Protocol& protocol);
     template<class T>
@@ -38,6 +40,9 @@ public:
 
     template<class T>
     void run_matrix(SubProcessor<T>& processor);
+
+    template<class T>
+    void im2col(StackedVector<T>& S, vector<T>& columns);
 };
 
 #endif /* PROCESSOR_CONV2DTUPLE_H_ */
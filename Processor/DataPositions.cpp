@@ -150,6 +150,49 @@ void DataPositions::print_cost() const
     }
 }
 
+void DataPositions::print_json(ostream& os) const
+{
+  os << "{";
+  for (int i = 0; i < N_DATA_FIELD_TYPE; i++)
+    {
+      if (i)
+        os << ", ";
+      os << "\"" << field_names[i] << "\": {";
+      for (int j = 0; j < N_DTYPE; j++)
+        os << "\"" << dtype_names[j] << "\": " << files[i][j] << ", ";
+      os << "\"Input tuples\": [";
+      for (size_t j = 0; j < inputs.size(); j++)
+        os << (j ? ", " : "") << inputs[j][i];
+      os << "]";
+      for (auto& x : extended[i])
+        os << ", \"" << x.first.get_string() << "\": " << x.second;
+      os << "}";
+    }
+  os << ", \"edaBits\": [";
+  bool first = true;
+  for (auto& x : edabits)
+    if (x.second)
+      {
+        if (not first)
+          os << ", ";
+        first = false;
+        os << "{\"length\": " << x.first.second << ", \"strict\": "
+            << (x.first.first ? "true" : "false") << ", \"number\": "
+            << x.second << "}";
+      }
+  os << "], \"matmuls\": [";
+  first = true;
+  for (auto& x : matmuls)
+    {
+      if (not first)
+        os << ", ";
+      first = false;
+      os << "{\"dimensions\": [" << x.first[0] << ", " << x.first[1] << ", "
+          << x.first[2] << "], \"number\": " << x.second << "}";
+    }
+  os << "]}";
+}
+
 void DataPositions::process_line(long long items_used, const char* name,
     ifstream& file, bool print_verbose, double& total_cost,
     bool& reading_field, string suffix) const
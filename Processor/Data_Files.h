@@ -14,6 +14,7 @@
 #include "PrepBase.h"
 #include "PrepBuffer.h"
 #include "EdabitBuffer.h"
+#include "PrepTelemetry.h"
 #include "Tools/TimerWithComm.h"
 #include "Tools/CheckVector.h"
 
@@ -85,6 +86,7 @@ public:
   DataPositions operator-(const DataPositions& delta) const;
   DataPositions operator+(const DataPositions& delta) const;
   void print_cost() const;
+  void print_json(ostream& os) const;
   bool empty() const;
   bool any_more(const DataPositions& other) const;
 
@@ -110,12 +112,21 @@ protected:
 
   bool do_count;
 
+  // null unless reporting
+  PrepTelemetry::Record* telemetry;
+
   void count(Dtype dtype, int n = 1)
-  { usage.files[T::clear::field_type()][dtype] += do_count * n; }
+  {
+    usage.files[T::clear::field_type()][dtype] += do_count * n;
+    if (telemetry)
+      telemetry->consume(dtype, do_count * n);
+  }
   void count_input(int player)
   {
     usage.inputs.resize(max(size_t(player + 1), usage.inputs.size()));
     usage.inputs[player][T::clear::field_type()] += do_count;
+    if (telemetry)
+      telemetry->consume(PrepTelemetry::INPUTS, do_count);
   }
 
   template<int>
@@ -156,7 +167,7 @@ public:
       DataPositions& usage);
 
   Preprocessing(DataPositions& usage) :
-      PrepBase(usage), do_count(true), buffer_size(0) {}
+      PrepBase(usage), do_count(true), telemetry(0), buffer_size(0) {}
   virtual ~Preprocessing() {}
 
   virtual void set_protocol(typename T::Protocol&) {};
@@ -165,6 +176,8 @@ public:
   virtual void seekg(DataPositions& pos) { (void) pos; }
   virtual void prune() {}
   virtual void purge() {}
+  /// Generate the given requirements in advance
+  virtual void plan(const DataPositions& usage) { (void) usage; }
 
   virtual void get_three_no_count(Dtype, T&, T&, T&)
   { throw not_implemented(); }
@@ -336,6 +349,7 @@ class Data_Files
   void skip(const DataPositions& pos);
   void prune();
   void purge();
+  void plan(const DataPositions& usage);
 
   DataPositions get_usage()
   {
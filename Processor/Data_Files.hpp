@@ -321,6 +321,13 @@ void Data_Files<sint, sgf2n>::prune()
   DataFb.prune();
 }
 
+template<class sint, class sgf2n>
+void Data_Files<sint, sgf2n>::plan(const DataPositions& usage)
+{
+  DataFp.plan(usage);
+  DataF2.plan(usage);
+}
+
 template<class T>
 void Sub_Data_Files<T>::purge()
 {
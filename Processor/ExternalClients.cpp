@@ -8,12 +8,17 @@
 
 ExternalClients::ExternalClients(int party_num):
    party_num(party_num),
-   ctx(0)
+   ctx(0), input_queue(0), output_queue(0)
 {
 }
 
 ExternalClients::~ExternalClients() 
 {
+  // stop background reception before closing sockets
+  if (input_queue)
+    delete input_queue;
+  if (output_queue)
+    delete output_queue;
   // close client sockets
   for (auto it = external_client_sockets.begin();
     it != external_client_sockets.end(); it++)
@@ -42,20 +47,24 @@ void ExternalClients::start_listening(int portnum_base)
         << " for external client connections." << endl;
 }
 
-int ExternalClients::get_client_connection(int portnum_base)
+int ExternalClients::get_client_connection(int portnum_base, int timeout)
 {
-  ScopeLock _(lock);
-  map<int,AnonymousServerSocket*>::iterator it = client_connection_servers.find(portnum_base);
-  if (it == client_connection_servers.end())
+  AnonymousServerSocket* server;
   {
-    cerr << "Thread " << this_thread::get_id() << " didn't find server." << endl; 
-    throw runtime_error("No connection on port " + to_string(portnum_base));
+    ScopeLock _(lock);
+    map<int,AnonymousServerSocket*>::iterator it = client_connection_servers.find(portnum_base);
+    if (it == client_connection_servers.end())
+    {
+      cerr << "Thread " << this_thread::get_id() << " didn't find server." << endl;
+      throw runtime_error("No connection on port " + to_string(portnum_base));
+    }
+    server = it->second;
   }
   int client_id, socket;
   string client;
-  socket = client_connection_servers[portnum_base]->get_connection_socket(
-      client);
+  socket = server->get_connection_socket(client, timeout);
   client_id = stoi(client);
+  ScopeLock _(lock);
   if (ctx == 0)
     ctx = new client_ctx("P" + to_string(get_party_num()));
   external_client_sockets[client_id] = new client_socket(io_service, *ctx, socket,
@@ -94,6 +103,7 @@ int ExternalClients::init_client_connection(const string& host, int portnum,
 
 void ExternalClients::close_connection(int client_id)
 {
+  get_socket(client_id);
   ScopeLock _(lock);
   auto it = external_client_sockets.find(client_id);
   if (it == external_client_sockets.end())
@@ -104,15 +114,59 @@ void ExternalClients::close_connection(int client_id)
       to_string(client_id));
 }
 
+void ExternalClients::expect_input(int client_id, long slot)
+{
+  auto socket = get_socket(client_id);
+  ScopeLock _(lock);
+  if (input_queue == 0)
+    input_queue = new ClientInputQueue;
+  input_queue->expect(socket, client_id, slot);
+}
+
+vector<ClientInputQueue::Submission> ExternalClients::take_inputs(size_t n)
+{
+  ClientInputQueue* queue;
+  {
+    ScopeLock _(lock);
+    if (input_queue == 0)
+      input_queue = new ClientInputQueue;
+    queue = input_queue;
+  }
+  return queue->take(n);
+}
+
 int ExternalClients::get_party_num() 
 {
   return party_num;
 }
 
-client_socket* ExternalClients::get_socket(int id)
+client_socket* ExternalClients::find_socket(int id)
 {
   ScopeLock _(lock);
   if (external_client_sockets.find(id) == external_client_sockets.end())
     throw runtime_error("external connection not found for id " + to_string(id));
   return external_client_sockets[id];
 }
+
+client_socket* ExternalClients::get_socket(int id)
+{
+  auto socket = find_socket(id);
+  ClientOutputQueue* queue;
+  {
+    ScopeLock _(lock);
+    queue = output_queue;
+  }
+  if (queue)
+    queue->wait(socket);
+  return socket;
+}
+
+void ExternalClients::send_output(int client_id, octetStream& os)
+{
+  auto socket = find_socket(client_id);
+  ScopeLock _(lock);
+  if (output_queue == 0)
+    output_queue = new ClientOutputQueue(
+        max(2u, thread::hardware_concurrency()));
+  output_queue->send(socket, client_id, os);
+}
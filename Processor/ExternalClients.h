@@ -6,6 +6,8 @@
 #include "Tools/Exceptions.h"
 #include "Tools/Lock.h"
 #include "ExternalIO/Client.h"
+#include "ClientInputQueue.h"
+#include "ClientOutputQueue.h"
 #include <vector>
 #include <map>
 #include <iostream>
@@ -36,6 +38,11 @@ class ExternalClients
 
   Lock lock;
 
+  ClientInputQueue* input_queue;
+  ClientOutputQueue* output_queue;
+
+  client_socket* find_socket(int socket_id);
+
   public:
 
   ExternalClients(int party_num);
@@ -43,14 +50,26 @@ class ExternalClients
 
   void start_listening(int portnum_base);
 
-  int get_client_connection(int portnum_base);
+  // other threads can use existing connections while waiting,
+  // which is indefinite if timeout is zero
+  int get_client_connection(int portnum_base,
+      int timeout = CONNECTION_TIMEOUT);
   int init_client_connection(const string& host, int portnum, int my_client_id);
 
   void close_connection(int client_id);
 
   // return the socket for a given client or server identifier
+  // after completing background output
   client_socket* get_socket(int socket_id);
 
+  // receive the next message from a client in the background
+  void expect_input(int client_id, long slot);
+  // wait for the next messages received in the background
+  vector<ClientInputQueue::Submission> take_inputs(size_t n);
+
+  // send to a client in the background, which leaves the stream empty
+  void send_output(int client_id, octetStream& os);
+
   int get_party_num();
 };
 
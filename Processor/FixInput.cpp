@@ -6,6 +6,7 @@
 #include "FixInput.h"
 
 #include <math.h>
+#include <sstream>
 
 template<>
 void FixInput_<Integer>::read(std::istream& in, const int* params)
@@ -28,3 +29,24 @@ void FixInput_<bigint>::read(std::istream& in, const int* params)
     items[0] = round(x * exp2(*params));
 #endif
 }
+
+template<>
+bool FixInput_<Integer>::read(const TextInput::Value& value,
+        const int* params)
+{
+    items[0] = round(value.real * exp2(*params));
+    return value.is_real;
+}
+
+template<>
+bool FixInput_<bigint>::read(const TextInput::Value& value, const int* params)
+{
+#ifdef HIGH_PREC_INPUT
+    stringstream ss(value.str());
+    read(ss, params);
+    return not ss.fail();
+#else
+    items[0] = round(value.real * exp2(*params));
+    return value.is_real;
+#endif
+}
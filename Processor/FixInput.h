@@ -10,6 +10,7 @@
 
 #include "Math/bigint.h"
 #include "Math/Integer.h"
+#include "TextInput.h"
 
 template<class T>
 class FixInput_
@@ -24,6 +25,7 @@ public:
     T items[N_DEST];
 
     void read(std::istream& in, const int* params);
+    bool read(const TextInput::Value& value, const int* params);
 };
 
 template<class T>
@@ -13,6 +13,17 @@ void FloatInput::read(std::istream& in, const int* params)
 {
     double x;
     in >> x;
+    set(x, params);
+}
+
+bool FloatInput::read(const TextInput::Value& value, const int* params)
+{
+    set(value.real, params);
+    return value.is_real;
+}
+
+void FloatInput::set(double x, const int* params)
+{
     int exp;
     double mant = fabs(frexp(x, &exp));
 
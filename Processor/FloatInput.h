@@ -7,6 +7,7 @@
 #define PROCESSOR_FLOATINPUT_H_
 
 #include "Math/bigint.h"
+#include "TextInput.h"
 
 #include <iostream>
 
@@ -22,6 +23,9 @@ public:
     long items[N_DEST];
 
     void read(std::istream& in, const int* params);
+    bool read(const TextInput::Value& value, const int* params);
+
+    void set(double x, const int* params);
 };
 
 #endif /* PROCESSOR_FLOATINPUT_H_ */
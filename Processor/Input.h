@@ -75,11 +75,20 @@ public:
     /// Schedule input from all players
     void add_from_all(const typename T::open_type& input, int n_bits = -1);
 
+    /// Schedule several inputs from me
+    virtual void add_mine_vector(const vector<typename T::open_type>& inputs,
+            int n_bits = -1);
+    /// Schedule ``n`` inputs from other player
+    virtual void add_other_vector(int player, size_t n, int n_bits = -1);
+
     /// Run input protocol for all players
     virtual void exchange();
 
     /// Get share for next input from ``player``
     virtual T finalize(int player, int n_bits = -1);
+    /// Get shares for next ``n`` inputs from ``player``
+    virtual void finalize_vector(int player, T* target, size_t n,
+            int n_bits = -1);
 
     void raw_input(SubProcessor<T>& proc, const vector<int>& args, int size);
 };
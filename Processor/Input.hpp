@@ -131,6 +131,21 @@ void InputBase<T>::add_from_all(const typename T::open_type& input, int n_bits)
             add_other(i, n_bits);
 }
 
+template<class T>
+void InputBase<T>::add_mine_vector(const vector<typename T::open_type>& inputs,
+        int n_bits)
+{
+    for (auto& input : inputs)
+        add_mine(input, n_bits);
+}
+
+template<class T>
+void InputBase<T>::add_other_vector(int player, size_t n, int n_bits)
+{
+    for (size_t i = 0; i < n; i++)
+        add_other(player, n_bits);
+}
+
 template<class T>
 void Input<T>::send_mine()
 {
@@ -225,6 +240,14 @@ T InputBase<T>::finalize(int player, int n_bits)
     }
 }
 
+template<class T>
+void InputBase<T>::finalize_vector(int player, T* target, size_t n,
+        int n_bits)
+{
+    for (size_t i = 0; i < n; i++)
+        target[i] = finalize(player, n_bits);
+}
+
 template<class T>
 template<class U>
 void InputBase<T>::prepare(SubProcessor<T>& Proc, int player, const int* params,
@@ -234,6 +257,8 @@ void InputBase<T>::prepare(SubProcessor<T>& Proc, int player, const int* params,
     assert(Proc.Proc != 0);
     if (input.is_me(player))
     {
+        vector<typename T::open_type> inputs;
+        inputs.reserve(U::N_DEST * size);
         for (int j = 0; j < size; j++)
         {
             U tuple;
@@ -241,14 +266,12 @@ void InputBase<T>::prepare(SubProcessor<T>& Proc, int player, const int* params,
                 tuple = Proc.Proc->template get_input<U>(
                         Proc.Proc->use_stdin(), params);
             for (auto x : tuple.items)
-                input.add_mine(x);
+                inputs.push_back(x);
         }
+        input.add_mine_vector(inputs);
     }
     else
-    {
-        for (int j = 0; j < U::N_DEST * size; j++)
-            input.add_other(player);
-    }
+        input.add_other_vector(player, U::N_DEST * size);
 }
 
 template<class T>
@@ -257,6 +280,12 @@ void InputBase<T>::finalize(SubProcessor<T>& Proc, int player, const int* dest,
         int size)
 {
     auto& input = Proc.input;
+    if (U::N_DEST == 1 and size > 0)
+    {
+        // consecutive registers
+        input.finalize_vector(player, &Proc.get_S_ref(dest[0]), size);
+        return;
+    }
     for (int k = 0; k < size; k++)
         for (int j = 0; j < U::N_DEST; j++)
             Proc.get_S_ref(dest[j] + k) = input.finalize(player);
@@ -8,6 +8,7 @@
 #include "Processor.h"
 #include "Memory.h"
 #include "Math/gf2n.h"
+#include "Math/ring_vectors.h"
 #include "GC/instructions.h"
 
 #include "Memory.hpp"
@@ -51,6 +51,7 @@ enum
     PUSHINT = 0xCE,
     POPINT = 0xCF,
     MOVINT = 0xD0,
+    MEMADVISES = 0xD3,
     // Machine
     LDTN = 0x10,
     LDARG = 0x11,
@@ -116,6 +117,7 @@ enum
     MATMULS = 0xAA,
     MATMULSM = 0xAB,
     CONV2DS = 0xAC,
+    MULTRUNCPRS = 0xAE,
     CHECK = 0xAF,
     PRIVATEOUTPUT = 0xAD,
     // Shuffling
@@ -129,6 +131,8 @@ enum
     BIT = 0x51,
     SQUARE = 0x52,
     INV = 0x53,
+    A2B = 0x54,
+    B2A = 0x55,
     INPUTMASK = 0x56,
     INPUTMASKREG = 0x5C,
     PREP = 0x57,
@@ -138,6 +142,7 @@ enum
     RANDOMS = 0x5B,
     RANDOMFULLS = 0x5D,
     UNSPLIT = 0x5E,
+    WRITESOCKETSHAREBATCH = 0x5F,
     // Input
     INPUT = 0x60,
     INPUTFIX = 0xF0,
@@ -153,6 +158,8 @@ enum
     READSOCKETS = 0x64,
     WRITESOCKETC = 0x65,
     WRITESOCKETS = 0x66,
+    READSOCKETCASYNC = 0x67,
+    READSOCKETCBATCH = 0x68,
     READSOCKETINT = 0x69,
     WRITESOCKETINT = 0x6a,
     WRITESOCKETSHARE = 0x6b,
@@ -215,12 +222,15 @@ enum
     PRINTFLOATPLAIN = 0xBC,
     WRITEFILESHARE = 0xBD,
     READFILESHARE = 0xBE,
+    WRITECOLUMN = 0xEE,
+    READCOLUMN = 0xEF,
     CONDPRINTSTR = 0xBF,
     PRINTFLOATPREC = 0xE0,
     CONDPRINTPLAIN = 0xE1,
     INTOUTPUT = 0xE6,
     FLOATOUTPUT = 0xE7,
     FIXINPUT = 0xE8,
+    BLOCKOUTPUT = 0xF7,
 
     // GF(2^n) versions
     
@@ -239,6 +249,7 @@ enum
     GMOVS = 0x10C,
     GPROTECTMEMS = 0x10D,
     GPROTECTMEMC = 0x10E,
+    GMEMADVISES = 0x1D3,
     // Machine
     GREQBL = 0x112,
     GUSE_PREP = 0x11C,
@@ -358,11 +369,12 @@ protected:
   size_t n;             // Possible immediate value
   vector<int>  start; // Values for a start/stop open
   string str;
+  int n_merged;       // Following instructions done by this one
 
   void bytecode_assert(bool condition) const;
 
 public:
-  BaseInstruction() : opcode(0), size(0), n(0) {}
+  BaseInstruction() : opcode(0), size(0), n(0), n_merged(0) {}
   virtual ~BaseInstruction() {};
 
   int get_r(int i) const { return r[i]; }
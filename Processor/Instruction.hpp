@@ -5,6 +5,7 @@
 #include "Processor/Machine.h"
 #include "Processor/Processor.h"
 #include "Processor/IntInput.h"
+#include "Processor/Trace.h"
 #include "Processor/FixInput.h"
 #include "Processor/FloatInput.h"
 #include "Processor/instructions.h"
@@ -17,6 +18,7 @@
 #include "Processor/Binary_File_IO.hpp"
 #include "Processor/PrivateOutput.hpp"
 #include "Math/bigint.hpp"
+#include "Math/ring_vectors.h"
 
 #include <stdlib.h>
 #include <algorithm>
@@ -133,6 +135,7 @@ void BaseInstruction::parse_operands(istream& s, int pos, int file_pos)
       case DABIT:
       case SHUFFLE:
       case ACCEPTCLIENTCONNECTION:
+      case READSOCKETCASYNC:
       case PREFIXSUMS:
       case CMDLINEARG:
         get_ints(r, s, 2);
@@ -321,6 +324,7 @@ void BaseInstruction::parse_operands(istream& s, int pos, int file_pos)
       case SENDPERSONAL:
       case PRIVATEOUTPUT:
       case TRUNC_PR:
+      case MULTRUNCPRS:
       case RUN_TAPE:
       case CONV2DS:
       case MATMULS:
@@ -342,6 +346,24 @@ void BaseInstruction::parse_operands(istream& s, int pos, int file_pos)
         get_vector(num_var_args, start, s);
         break;
 
+      // clients, message type, number of clients, values per client, var1, var2 ...
+      case WRITESOCKETSHAREBATCH:
+        num_var_args = get_int(s) - 4;
+        r[0] = get_int(s);
+        r[1] = get_int(s);
+        n = get_int(s);
+        r[2] = get_int(s);
+        get_vector(num_var_args, start, s);
+        break;
+
+      // slots, values, number of messages, values per message
+      case READSOCKETCBATCH:
+        r[0] = get_int(s);
+        r[1] = get_int(s);
+        n = get_int(s);
+        r[2] = get_int(s);
+        break;
+
       // read from external client, input is : opcode num_args, client_id, var1, var2 ...
       case READSOCKETC:
       case READSOCKETS:
@@ -367,6 +389,35 @@ void BaseInstruction::parse_operands(istream& s, int pos, int file_pos)
         get_ints(r, s, 3);
         get_string(str, s);
         break;
+      // register, rows, bit length, precision, column name
+      case WRITECOLUMN:
+        r[0] = get_int(s);
+        n = get_int(s);
+        r[1] = get_int(s);
+        r[2] = get_int(s);
+        get_string(str, s);
+        break;
+      // player, precision, register
+      case BLOCKOUTPUT:
+        n = get_int(s);
+        r[1] = get_int(s);
+        r[0] = get_int(s);
+        break;
+      // address, length, access pattern
+      case MEMADVISES:
+      case GMEMADVISES:
+        get_ints(r, s, 2);
+        n = get_int(s);
+        break;
+      // register, start row, rows, bit length, precision, column name
+      case READCOLUMN:
+        r[0] = get_int(s);
+        r[1] = get_int(s);
+        n = get_int(s);
+        r[2] = get_int(s);
+        r[3] = get_int(s);
+        get_string(str, s);
+        break;
       case INITSECURESOCKET:
       case RESPSECURESOCKET:
         throw runtime_error("VM-controlled encryption not supported any more");
@@ -403,6 +454,8 @@ void BaseInstruction::parse_operands(istream& s, int pos, int file_pos)
       case BITDECINT:
       case EDABIT:
       case SEDABIT:
+      case A2B:
+      case B2A:
       case WRITEFILESHARE:
       case GWRITEFILESHARE:
       case CONCATS:
@@ -594,6 +647,9 @@ int BaseInstruction::get_reg_type() const
     case CONVCBITVEC:
     case INTOUTPUT:
     case ACCEPTCLIENTCONNECTION:
+    case READSOCKETCASYNC:
+    case MEMADVISES:
+    case GMEMADVISES:
     case GENSECSHUFFLE:
     case CMDLINEARG:
     case CALL_TAPE:
@@ -643,6 +699,7 @@ int BaseInstruction::get_reg_type() const
     case CONVINT:
     case PUBINPUT:
     case FLOATOUTPUT:
+    case BLOCKOUTPUT:
     case READSOCKETC:
     case PRIVATEOUTPUT:
     case FIXINPUT:
@@ -687,6 +744,8 @@ unsigned BaseInstruction::get_max_reg(int reg_type) const
           return 0;
   case EDABIT:
   case SEDABIT:
+  case A2B:
+  case B2A:
       if (reg_type == SBIT)
           skip = 1;
       else if (reg_type == SINT)
@@ -694,6 +753,42 @@ unsigned BaseInstruction::get_max_reg(int reg_type) const
       else
           return 0;
       break;
+  case WRITECOLUMN:
+      if (reg_type == SINT)
+          return r[0] + n;
+      else
+          return 0;
+  case READCOLUMN:
+      if (reg_type == SINT)
+          return r[0] + n;
+      else if (reg_type == INT)
+          return r[1] + 1;
+      else
+          return 0;
+  case WRITESOCKETSHAREBATCH:
+      if (reg_type == INT)
+          return r[0] + n;
+      else if (reg_type == SINT)
+      {
+          unsigned res = 0;
+          for (auto& x : start)
+              res = max(res, unsigned(x + n * r[2]));
+          return res;
+      }
+      else
+          return 0;
+  case READSOCKETCBATCH:
+      if (reg_type == INT)
+          return r[0] + n;
+      else if (reg_type == CINT)
+          return r[1] + n * r[2];
+      else
+          return 0;
+  case BLOCKOUTPUT:
+      if (reg_type == CINT)
+          return r[0] + size;
+      else
+          return 0;
   case INPUTMASKREG:
       if (reg_type == SINT)
           return r[0] + size;
@@ -747,6 +842,11 @@ unsigned BaseInstruction::get_max_reg(int reg_type) const
       offset = 1;
       size_offset = -1;
       break;
+  case MULTRUNCPRS:
+      skip = 6;
+      offset = 1;
+      size_offset = -1;
+      break;
   case DOTPRODS:
   {
       int res = 0;
@@ -1155,28 +1255,43 @@ inline void Instruction::execute(Processor<sint, sgf2n>& Proc) const
         Proc.Proc2.POpen(*this);
         return;
       case MULS:
-        Proc.Procp.muls(start);
+        {
+          // skip merged instructions, see Program::merge_rounds()
+          Proc.PC += n_merged;
+          auto& program = *BaseMachine::current_program();
+          int overlap = program.get_overlap(Proc.last_PC);
+          if (overlap and Proc.P.is_full_duplex())
+            {
+              program.execute_overlap(Proc, start, Proc.PC,
+                  Proc.PC + overlap);
+              Proc.PC += overlap;
+              Proc.executed += overlap;
+            }
+          else
+            Proc.Procp.muls(start);
+        }
         return;
       case GMULS:
         Proc.Proc2.muls(start);
         return;
       case MULRS:
-        Proc.Procp.mulrs(start);
+        Proc.Procp.protocol.mulrs(start, Proc.Procp);
         return;
       case GMULRS:
         Proc.Proc2.protocol.mulrs(start, Proc.Proc2);
         return;
       case DOTPRODS:
         Proc.Procp.dotprods(start, size);
+        Proc.PC += n_merged;
         return;
       case GDOTPRODS:
         Proc.Proc2.dotprods(start, size);
         return;
       case MATMULS:
-        Proc.Procp.matmuls(Proc.Procp.get_S(), *this);
+        Proc.Procp.protocol.matmuls(Proc.Procp, Proc.Procp.get_S(), *this);
         return;
       case GMATMULS:
-        Proc.Proc2.matmuls(Proc.Proc2.get_S(), *this);
+        Proc.Proc2.protocol.matmuls(Proc.Proc2, Proc.Proc2.get_S(), *this);
         return;
       case MATMULSM:
         Proc.Procp.protocol.matmulsm(Proc.Procp, Proc.machine.Mp.MS, *this);
@@ -1190,6 +1305,11 @@ inline void Instruction::execute(Processor<sint, sgf2n>& Proc) const
       case TRUNC_PR:
         Proc.Procp.protocol.trunc_pr(start, size, Proc.Procp,
             sint::clear::characteristic_two);
+        Proc.PC += n_merged;
+        return;
+      case MULTRUNCPRS:
+        Proc.Procp.mul_trunc_pr(start);
+        Proc.PC += n_merged;
         return;
       case SECSHUFFLE:
         Proc.Procp.secure_shuffle(*this);
@@ -1369,6 +1489,16 @@ inline void Instruction::execute(Processor<sint, sgf2n>& Proc) const
       case READSOCKETC:
         Proc.read_socket_vector(Proc.read_Ci(r[0]), start, n);
         break;
+      case READSOCKETCASYNC:
+        Proc.external_clients.expect_input(Proc.read_Ci(r[0]),
+            Proc.read_Ci(r[1]));
+        break;
+      case READSOCKETCBATCH:
+        Proc.read_socket_batch(r[0], r[1], n, r[2]);
+        break;
+      case WRITESOCKETSHAREBATCH:
+        Proc.write_socket_batch(r[0], r[1], n, r[2], start);
+        break;
       case READSOCKETS:
         // read shares and MAC shares
         Proc.read_socket_private(Proc.read_Ci(r[0]), start, n, true);
@@ -1397,6 +1527,23 @@ inline void Instruction::execute(Processor<sint, sgf2n>& Proc) const
         Procp.read_shares_from_file(Proc.read_Ci(r[0]), r[1], start, size,
             Proc);
         return;
+      case WRITECOLUMN:
+        Procp.write_column(str, r[0], n, r[1], r[2]);
+        break;
+      case READCOLUMN:
+        Procp.read_column(str, r[0], n, Proc.read_Ci(r[1]), r[2], r[3]);
+        break;
+      case BLOCKOUTPUT:
+        Proc.write_block_output(n, r[1], r[0], size);
+        return;
+      case MEMADVISES:
+        Proc.machine.Mp.MS.advise(Proc.read_Ci(r[0]), Proc.read_Ci(r[1]),
+            DiskAccessPattern(n));
+        break;
+      case GMEMADVISES:
+        Proc.machine.M2.MS.advise(Proc.read_Ci(r[0]), Proc.read_Ci(r[1]),
+            DiskAccessPattern(n));
+        break;
       case GWRITEFILESHARE:
         // Write shares to file system
         Proc2.write_shares_to_file(Proc.read_Ci(r[0]), start, size);
@@ -1487,6 +1634,25 @@ void Program::execute(Processor<sint, sgf2n>& Proc) const
     }
 }
 
+// dispatch targets, see Program::get_handler()
+enum InstructionHandler
+{
+#define X(NAME, PRE, CODE) NAME##_HANDLER,
+  ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) NAME##_HANDLER,
+  CONTROL_INSTRUCTIONS
+  COMBI_INSTRUCTIONS
+#undef X
+  CLEAR_GF2N_HANDLER,
+  REGINT_HANDLER,
+  OTHER_HANDLER,
+#define X(FIRST, SECOND, N_FIRST, N_SECOND, PRE, CODE) \
+  FIRST##_##SECOND##_HANDLER,
+  FUSED_INSTRUCTIONS
+#undef X
+};
+
 template<class sint, class sgf2n>
 void Program::execute_with_errors(Processor<sint, sgf2n>& Proc) const
 {
@@ -1503,6 +1669,16 @@ void Program::execute_with_errors(Processor<sint, sgf2n>& Proc) const
 
   BaseMachine::program = this;
 
+#if defined(__GNUC__) and not defined(COUNT_INSTRUCTIONS) \
+    and not defined(OUTPUT_INSTRUCTIONS)
+  if (not OnlineOptions::singleton.has_option("switch_dispatch")
+      and not Proc.profiler and not Trace::active())
+    return execute_threaded(Proc);
+#endif
+
+  Trace::InstructionGroup group;
+  bool trace = Trace::active();
+
   while (Proc.PC<size)
     {
       Proc.last_PC = Proc.PC;
@@ -1528,6 +1704,12 @@ void Program::execute_with_errors(Processor<sint, sgf2n>& Proc) const
 #endif
 
       Proc.PC++;
+      Proc.executed++;
+
+      if (trace)
+        group.next(instruction);
+      if (Proc.profiler)
+        Proc.profiler->begin(*this, instruction);
 
       switch(instruction.get_opcode())
         {
@@ -1535,6 +1717,9 @@ void Program::execute_with_errors(Processor<sint, sgf2n>& Proc) const
         case NAME: { PRE; for (int i = 0; i < size; i++) { CODE; } } break;
         ARITHMETIC_INSTRUCTIONS
 #undef X
+#define X(NAME, CODE) case NAME: CODE; break;
+        CONTROL_INSTRUCTIONS
+#undef X
 #define X(NAME, PRE, CODE) case NAME:
         CLEAR_GF2N_INSTRUCTIONS
         instruction.execute_clear_gf2n(Proc2.get_C(), Proc.machine.M2.MC, Proc); break;
@@ -1550,16 +1735,188 @@ void Program::execute_with_errors(Processor<sint, sgf2n>& Proc) const
           instruction.execute(Proc);
         }
 
+      if (Proc.profiler)
+        Proc.profiler->end();
+
 #if defined(COUNT_INSTRUCTIONS) and defined(TIME_INSTRUCTIONS)
       Proc.stats[p[PC].get_opcode()] += timer.elapsed() * 1e9;
 #endif
     }
 }
 
+template<class sint, class sgf2n>
+void Program::execute_threaded(Processor<sint, sgf2n>& Proc) const
+{
+#ifdef __GNUC__
+  unsigned int size = p.size();
+
+  auto& Procp = Proc.Procp;
+  auto& Proc2 = Proc.Proc2;
+
+  // binary instructions
+  typedef typename sint::bit_type T;
+  auto& processor = Proc.Procb;
+  auto& Ci = Proc.get_Ci();
+  (void) Ci;
+
+  size_t executed = 0;
+
+  // same order as InstructionHandler
+  static const void* const labels[] = {
+#define X(NAME, PRE, CODE) &&NAME##_label,
+      ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) &&NAME##_label,
+      CONTROL_INSTRUCTIONS
+      COMBI_INSTRUCTIONS
+#undef X
+      &&clear_gf2n_label,
+      &&regint_label,
+      &&other_label,
+#define X(FIRST, SECOND, N_FIRST, N_SECOND, PRE, CODE) \
+      &&FIRST##_##SECOND##_label,
+      FUSED_INSTRUCTIONS
+#undef X
+  };
+
+  // every handler ends with its own indirect jump
+#define DISPATCH \
+  if (Proc.PC >= size) \
+    goto finish; \
+  Proc.last_PC = Proc.PC; \
+  executed++; \
+  goto *labels[handlers[Proc.PC++]];
+
+#define OPERANDS \
+  auto& instruction = p[Proc.last_PC]; \
+  auto& r = instruction.r; \
+  auto& n = instruction.n; \
+  auto& start = instruction.start; \
+  auto& size = instruction.size; \
+  (void) r; (void) n; (void) start; (void) size;
+
+  DISPATCH
+
+#define X(NAME, PRE, CODE) \
+  NAME##_label: \
+    { OPERANDS PRE; for (int i = 0; i < size; i++) { CODE; } } \
+    DISPATCH
+  ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) \
+  NAME##_label: \
+    { OPERANDS CODE; } \
+    DISPATCH
+  CONTROL_INSTRUCTIONS
+  COMBI_INSTRUCTIONS
+#undef X
+
+clear_gf2n_label:
+  p[Proc.last_PC].execute_clear_gf2n(Proc2.get_C(), Proc.machine.M2.MC, Proc);
+  DISPATCH
+regint_label:
+  p[Proc.last_PC].execute_regint(Proc, Proc.machine.Mi.MC);
+  DISPATCH
+other_label:
+  p[Proc.last_PC].execute(Proc);
+  DISPATCH
+
+  // both instructions per vector element
+#define X(FIRST, SECOND, N_FIRST, N_SECOND, PRE, CODE) \
+  FIRST##_##SECOND##_label: \
+    { \
+      OPERANDS \
+      auto& r2 = p[Proc.last_PC + 1].r; \
+      auto& n2 = p[Proc.last_PC + 1].n; \
+      (void) r2; (void) n2; \
+      PRE; for (int i = 0; i < size; i++) { CODE; } \
+    } \
+    Proc.PC++; \
+    executed++; \
+    DISPATCH
+  FUSED_INSTRUCTIONS
+#undef X
+
+#undef DISPATCH
+#undef OPERANDS
+
+finish:
+  Proc.executed += executed;
+#else
+  execute_with_errors(Proc);
+#endif
+}
+
+template<class sint, class sgf2n>
+void Program::execute_local(Processor<sint, sgf2n>& Proc, size_t begin,
+    size_t end) const
+{
+  auto& Procp = Proc.Procp;
+  auto& Proc2 = Proc.Proc2;
+  (void) Proc2;
+
+  for (size_t pc = begin; pc < end; pc++)
+    {
+      auto& instruction = p[pc];
+      auto& r = instruction.r;
+      auto& n = instruction.n;
+      auto& size = instruction.size;
+      (void) r, (void) n;
+
+      switch (instruction.get_opcode())
+        {
+#define X(NAME, PRE, CODE) \
+        case NAME: { PRE; for (int i = 0; i < size; i++) { CODE; } } break;
+        ARITHMETIC_INSTRUCTIONS
+#undef X
+        default:
+          throw runtime_error("not a local instruction");
+        }
+    }
+}
+
+template<class sint, class sgf2n>
+void Program::execute_overlap(Processor<sint, sgf2n>& Proc,
+    const vector<int>& muls, size_t begin, size_t end) const
+{
+  auto& Procp = Proc.Procp;
+  int window = Procp.init_pipeline();
+  vector<const vector<int>*> in_flight = {&muls};
+  Procp.start_muls(muls);
+
+  auto stop_all = [&]()
+    {
+      for (size_t i = 0; i < in_flight.size(); i++)
+        Procp.stop_muls(*in_flight[i], i);
+      in_flight.clear();
+    };
+
+  for (size_t pc = begin; pc < end; pc++)
+    {
+      auto& instruction = p[pc];
+      if (instruction.get_opcode() == MULS)
+        {
+          // finish in order if the protocol does not support the window
+          if (in_flight.size() >= size_t(window))
+            stop_all();
+          Procp.start_muls(instruction.get_start(), in_flight.size());
+          in_flight.push_back(&instruction.get_start());
+          pc += instruction.get_n();
+        }
+      else
+        execute_local(Proc, pc, pc + 1);
+    }
+
+  stop_all();
+}
+
 template<class T>
 void Program::mulm_check() const
 {
-  if (T::function_dependent and not OnlineOptions::singleton.has_option("allow_mulm"))
+  // the compiler marks programs that only multiply with constants
+  if (T::function_dependent
+      and not OnlineOptions::singleton.has_option("allow_mulm")
+      and BaseMachine::s().relevant_opts.find("prep_mulm") == string::npos)
     throw runtime_error("Mixed multiplication not implemented for function-dependent preprocessing. "
         "Use '-E <protocol>' during compilation or state "
             "'program.use_mulm = False' at the beginning of your high-level program.");
@@ -8,6 +8,8 @@
 
 #include <iostream>
 
+#include "TextInput.h"
+
 template<class T>
 class IntInput
 {
@@ -21,6 +23,7 @@ public:
     T items[N_DEST];
 
     void read(std::istream& in, const int* params);
+    bool read(const TextInput::Value& value, const int* params);
 };
 
 #endif /* PROCESSOR_INTINPUT_H_ */
@@ -8,6 +8,8 @@
 
 #include "IntInput.h"
 
+#include <sstream>
+
 template<class T>
 const char* IntInput<T>::NAME = "integer";
 
@@ -17,4 +19,20 @@ void IntInput<T>::read(std::istream& in, const int*)
     in >> items[0];
 }
 
+template<class T>
+bool IntInput<T>::read(const TextInput::Value& value, const int* params)
+{
+    if constexpr (TextInput::decimal<T>())
+        if (value.is_integer)
+        {
+            items[0] = value.integer;
+            return true;
+        }
+
+    // numbers beyond 64 bits etc.
+    std::stringstream ss(value.str());
+    read(ss, params);
+    return not ss.fail();
+}
+
 #endif
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <map>
+#include <deque>
 #include <atomic>
 using namespace std;
 
@@ -51,9 +52,45 @@ class Machine : public BaseMachine
   Player* P;
 
   RunningTimer setup_timer;
+  // parameters and MAC keys as part of the above
+  Timer key_setup_timer;
 
   NamedCommStats max_comm;
 
+  // decoded and checked tapes by program name with the schedule
+  // information, the tapes of the current program are in progs instead
+  struct PreparedProgram
+  {
+    int nthreads;
+    string compiler, domain, relevant_opts, security, gf2n;
+    vector<Program> progs;
+  };
+  map<string, PreparedProgram> prepared;
+
+  // upper limit on threads running tapes (-o max_threads)
+  int max_threads;
+
+  int physical_thread(int thread_number);
+
+  // logical threads by physical thread in order of scheduling and
+  // results of logical threads finished but not joined yet
+  map<int, deque<int>> scheduled_tapes;
+  map<int, DataPositions> finished_tapes;
+
+  // tapes running in other threads than the main one
+  int running_tapes;
+
+  // time since the last checkpoint of persistent memory
+  Timer checkpoint_timer;
+  void checkpoint(bool force);
+
+  // per-thread statistics kept for --stats-json
+  string thread_stats;
+
+  void write_stats_json(const DataPositions& pos,
+      const NamedCommStats& comm_stats, const TimerWithComm& total_time,
+      double cpu_time);
+
   size_t load_program(const string& threadname, const string& filename);
 
   void prepare(const string& progname_str);
@@ -76,6 +113,7 @@ class Machine : public BaseMachine
   OnlineOptions opts;
 
   ExecutionStats stats;
+  size_t executed;
 
   ExternalClients external_clients;
 
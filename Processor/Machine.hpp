@@ -9,8 +9,11 @@
 #include "Protocols/fake-stuff.hpp"
 
 #include "Tools/Exceptions.h"
+#include "Processor/Metrics.h"
+#include "Processor/Trace.h"
 
 #include <sys/time.h>
+#include <sys/resource.h>
 
 #include "Math/Setup.h"
 #include "Tools/mkpath.h"
@@ -56,10 +59,19 @@ Machine<sint, sgf2n>::Machine(Names& playerNames, bool use_encryption,
     const OnlineOptions opts)
   : my_number(playerNames.my_num()), N(playerNames),
     use_encryption(use_encryption), live_prep(opts.live_prep), opts(opts),
-    external_clients(my_number)
+    executed(0), external_clients(my_number)
 {
   OnlineOptions::singleton = opts;
 
+  // unlimited by default, otherwise at least one besides the main thread
+  max_threads = stoi(OnlineOptions::singleton.option_value("max_threads", "0"));
+  if (max_threads <= 0 or opts.file_prep_per_thread)
+    max_threads = INT_MAX;
+  else
+    max_threads = max(2, max_threads);
+
+  running_tapes = 0;
+
   int min_players = 3 - sint::dishonest_majority;
   if (sint::is_real)
     {
@@ -92,6 +104,11 @@ Machine<sint, sgf2n>::Machine(Names& playerNames, bool use_encryption,
   else
     P = new PlainPlayer(N, id);
 
+  probe_network(*P, sint::size());
+  this->opts = OnlineOptions::singleton;
+
+  key_setup_timer.start();
+
   if (opts.live_prep)
     {
       sint::LivePrep::basic_setup(*P);
@@ -128,8 +145,19 @@ Machine<sint, sgf2n>::Machine(Names& playerNames, bool use_encryption,
   // for OT-based preprocessing
   sint::clear::next::template init<typename sint::clear>(false);
 
+  key_setup_timer.stop();
+
   // Initialize the global memory
   auto memtype = opts.memtype;
+  if (Mp.MS.is_persistent() and sint::real_shares(*P))
+    {
+      bool resume = memtype.compare("old") == 0;
+      Mp.MS.open(memory_filename() + "-Secret", resume);
+      M2.MS.open(
+          BaseMachine::memory_filename(sgf2n::type_short(), my_number)
+              + "-Secret", resume);
+      checkpoint_timer.start();
+    }
   if (memtype.compare("old")==0)
      {
        if (sint::real_shares(*P))
@@ -155,13 +183,52 @@ Machine<sint, sgf2n>::Machine(Names& playerNames, bool use_encryption,
 template<class sint, class sgf2n>
 void Machine<sint, sgf2n>::prepare(const string& progname_str)
 {
+  Metrics::start(my_number);
+  PrepTelemetry::start(my_number);
+  Trace::start(my_number);
+
   int old_n_threads = nthreads;
-  progs.clear();
-  load_schedule(progname_str);
-  check_program();
+
+  // threads, players, and preprocessing persist across calls,
+  // so only load and check tapes for programs not seen before
+  if (not progs.empty())
+    prepared.at(progname).progs.swap(progs);
+  auto it = prepared.find(progname_str);
+  if (it == prepared.end())
+    {
+      progs.clear();
+      load_schedule(progname_str);
+      check_program();
+      prepared[progname_str] = {nthreads, compiler, domain, relevant_opts,
+          security, gf2n, {}};
+    }
+  else
+    {
+      auto& cached = it->second;
+      progname = progname_str;
+      nthreads = cached.nthreads;
+      compiler = cached.compiler;
+      domain = cached.domain;
+      relevant_opts = cached.relevant_opts;
+      security = cached.security;
+      gf2n = cached.gf2n;
+      progs.swap(cached.progs);
+    }
+
+  // other threads could read unchecked values
+  parallel_tapes = nthreads > 1;
+  if (parallel_tapes and opts.mac_check_buffer
+      and not opts.has_option("auto_tune"))
+    {
+      static bool warned = false;
+      if (not warned)
+        cerr << "--mac-check-buffer is ignored for programs running "
+            "several threads at once" << endl;
+      warned = true;
+    }
 
   // keep preprocessing
-  nthreads = max(old_n_threads, nthreads);
+  nthreads = max(old_n_threads, min(nthreads, max_threads));
 
   // initialize persistence if necessary
   for (auto& prog : progs)
@@ -262,6 +329,7 @@ void Machine<sint, sgf2n>::fill_buffers(int thread_number, int tape_number,
     Preprocessing<sint>* prep,
     Preprocessing<typename sint::bit_type>* bit_prep)
 {
+  thread_number = physical_thread(thread_number);
   // central preprocessing
   auto usage = progs[tape_number].get_offline_data_used();
   if (sint::expensive and prep != 0 and OnlineOptions::singleton.bucket_size == 3)
@@ -366,16 +434,31 @@ void Machine<sint, sgf2n>::fill_matmul(int thread_number, int tape_number,
     }
 }
 
+template<class sint, class sgf2n>
+int Machine<sint, sgf2n>::physical_thread(int thread_number)
+{
+  // threads beyond the limit queue up on the others except the main thread
+  if (thread_number >= nthreads and nthreads >= max_threads)
+    return 1 + (thread_number - 1) % (nthreads - 1);
+  else
+    return thread_number;
+}
+
 template<class sint, class sgf2n>
 DataPositions Machine<sint, sgf2n>::run_tape(int thread_number, int tape_number,
     int arg, const DataPositions& pos)
 {
+  int logical_thread = thread_number;
+  thread_number = physical_thread(thread_number);
   if (size_t(thread_number) >= tinfo.size())
     throw overflow("invalid thread number", thread_number, tinfo.size());
   if (size_t(tape_number) >= progs.size())
     throw overflow("invalid tape number", tape_number, progs.size());
 
   queues[thread_number]->schedule({tape_number, arg, pos});
+  scheduled_tapes[thread_number].push_back(logical_thread);
+  if (thread_number != 0)
+    running_tapes++;
   //printf("Send signal to run program %d in thread %d\n",tape_number,thread_number);
   //printf("Running line %d\n",exec);
   if (progs[tape_number].usage_unknown())
@@ -398,13 +481,48 @@ DataPositions Machine<sint, sgf2n>::run_tape(int thread_number, int tape_number,
 template<class sint, class sgf2n>
 DataPositions Machine<sint, sgf2n>::join_tape(int i)
 {
+  int logical_thread = i;
+  i = physical_thread(i);
   join_timer[i].start();
   //printf("Waiting for client to terminate\n");
-  auto pos = queues[i]->result().pos;
+  // results arrive in scheduling order, which might differ from the
+  // joining order if several logical threads share a physical one
+  auto& scheduled = scheduled_tapes[i];
+  while (not finished_tapes.count(logical_thread))
+    {
+      assert(not scheduled.empty());
+      finished_tapes[scheduled.front()] = queues[i]->result().pos;
+      scheduled.pop_front();
+    }
+  auto pos = finished_tapes.at(logical_thread);
+  finished_tapes.erase(logical_thread);
   join_timer[i].stop();
+
+  // only the main thread is running after joining all others
+  if (i != 0 and --running_tapes == 0)
+    checkpoint(false);
+
   return pos;
 }
 
+template<class sint, class sgf2n>
+void Machine<sint, sgf2n>::checkpoint(bool force)
+{
+  if (not Mp.MS.is_persistent() or not checkpoint_timer.is_running())
+    return;
+
+  if (force or checkpoint_timer.elapsed() > PersistentVectorBase::interval())
+    {
+      RunningTimer timer;
+      Mp.MS.checkpoint();
+      M2.MS.checkpoint();
+      if (opts.has_option("time_memory_output"))
+        cerr << "Memory checkpoint took " << timer.elapsed() << " seconds"
+            << endl;
+      checkpoint_timer.reset();
+    }
+}
+
 template<class sint, class sgf2n>
 void Machine<sint, sgf2n>::run_step(const string& progname)
 {
@@ -536,6 +654,13 @@ pair<DataPositions, NamedCommStats> Machine<sint, sgf2n>::stop_threads()
       queues.print_breakdown();
     }
 
+  if (not opts.stats_json.empty())
+    {
+      stringstream ss;
+      queues.print_json(ss);
+      thread_stats = ss.str();
+    }
+
   for (auto& queue : queues)
     if (queue)
       delete queue;
@@ -548,6 +673,51 @@ pair<DataPositions, NamedCommStats> Machine<sint, sgf2n>::stop_threads()
   return {pos, comm_stats};
 }
 
+template<class sint, class sgf2n>
+void Machine<sint, sgf2n>::write_stats_json(const DataPositions& pos,
+    const NamedCommStats& comm_stats, const TimerWithComm& total_time,
+    double cpu_time)
+{
+  ofstream out(opts.stats_json);
+  if (not out.good())
+    throw file_error("cannot open statistics output " + opts.stats_json);
+
+  size_t rounds = 0;
+  for (auto& x : comm_stats)
+    rounds += x.second.rounds;
+
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  out << "{\"program\": \"" << progname << "\", \"party\": " << my_number
+      << ", \"parties\": " << N.num_players() << ", \"threads\": "
+      << thread_stats << ", \"time\": ";
+  total_time.print_json(out);
+  out << ", \"cpu_seconds\": " << cpu_time << ", \"instructions\": "
+      << executed << ", \"bytes_sent\": " << comm_stats.sent
+      << ", \"rounds\": " << rounds << ", \"global_bytes_sent\": [";
+  for (size_t i = 0; i < global_sent.size(); i++)
+    out << (i ? ", " : "") << global_sent[i];
+  out << "], \"communication\": ";
+  comm_stats.print_json(out);
+  out << ", \"max_communication\": ";
+  max_comm.print_json(out);
+  out << ", \"timers\": {";
+  for (auto it = timer.begin(); it != timer.end(); it++)
+    {
+      if (it != timer.begin())
+        out << ", ";
+      out << "\"" << it->first << "\": ";
+      it->second.print_json(out);
+    }
+  out << "}, \"preprocessing\": ";
+  pos.print_json(out);
+  out << ", \"memory\": {\"sint\": " << Mp.size_s() << ", \"cint\": "
+      << Mp.size_c() << ", \"sgf2n\": " << M2.size_s() << ", \"cgf2n\": "
+      << M2.size_c() << ", \"regint\": " << Mi.size_c()
+      << ", \"max_resident_kb\": " << usage.ru_maxrss << "}}" << endl;
+}
+
 template<class sint, class sgf2n>
 void Machine<sint, sgf2n>::run(const string& progname)
 {
@@ -555,7 +725,9 @@ void Machine<sint, sgf2n>::run(const string& progname)
 
   if (opts.verbose and setup_timer.is_running())
     {
-      cerr << "Setup took " << setup_timer.elapsed() << " seconds." << endl;
+      cerr << "Setup took " << setup_timer.elapsed() << " seconds ("
+          << key_setup_timer.elapsed()
+          << " for parameters and MAC keys)." << endl;
       setup_timer.stop();
     }
 
@@ -575,6 +747,8 @@ void Machine<sint, sgf2n>::run(const string& progname)
   multithread = nthreads > 1;
   auto res = stop_threads();
   DataPositions& pos = res.first;
+  PrepTelemetry::stop();
+  Trace::write();
 
   finish_timer.stop();
   
@@ -607,13 +781,22 @@ void Machine<sint, sgf2n>::run(const string& progname)
       if (multithread)
         cerr << " (overall core time)";
       cerr << endl;
+      cerr << "Executed " << executed << " instructions";
+      if (multithread)
+        cerr << " in all threads";
+      cerr << endl;
+      OctetStreamPool::print_stats(cerr);
     }
 
+  auto total_time = timer[0];
   print_timers();
 
   if (sint::is_real)
     this->print_comm(*this->P, comm_stats);
 
+  if (not opts.stats_json.empty())
+    write_stats_json(pos, comm_stats, total_time, proc_timer.elapsed());
+
 #ifdef VERBOSE_OPTIONS
   if (opening_sum < N.num_players() && !direct)
     cerr << "Summed at most " << opening_sum << " shares at once with indirect communication" << endl;
@@ -627,7 +810,8 @@ void Machine<sint, sgf2n>::run(const string& progname)
 #endif
 
   if (not OnlineOptions::singleton.has_option("output_full_memory")
-      and OnlineOptions::singleton.disk_memory.empty())
+      and OnlineOptions::singleton.disk_memory.empty()
+      and not Mp.MS.is_persistent())
     {
       // Reduce memory size to speed up
       unsigned max_size = 1 << 20;
@@ -637,6 +821,8 @@ void Machine<sint, sgf2n>::run(const string& progname)
         Mp.resize_s(max_size);
     }
 
+  checkpoint(true);
+
   if (sint::real_shares(*P) and not opts.has_option("no_memory_output"))
     {
       RunningTimer timer;
@@ -15,6 +15,7 @@ template<class T> istream& operator>>(istream& s,Memory<T>& M);
 #include "Processor/Program.h"
 #include "Tools/CheckVector.h"
 #include "Tools/DiskVector.h"
+#include "Tools/PersistentVector.h"
 
 template<class T>
 class MemoryPart
@@ -51,6 +52,43 @@ public:
       const U& indices);
 
   void minimum_size(size_t size);
+
+  // content kept in a file between runs (-o persistent_memory)
+  virtual bool is_persistent() const { return false; }
+  virtual void open(const string&, bool) {}
+  virtual void checkpoint() {}
+
+  // access pattern hint from the compiler (only used for disk memory)
+  virtual void advise(size_t, size_t, DiskAccessPattern) {}
+};
+
+/**
+ * Strided view of a matrix in memory with rows and columns selected by
+ * lists of indices (e.g., integer registers) to read operands in place
+ */
+template<class T, class U>
+class MemoryMatrixView
+{
+  const MemoryPart<T>& memory;
+  const T* data;
+  size_t base, row_length;
+  const U* rows;
+  const U* cols;
+
+public:
+  MemoryMatrixView(const MemoryPart<T>& memory, size_t base,
+      size_t row_length, const U* rows, const U* cols) :
+      memory(memory), data(memory.data()), base(base),
+      row_length(row_length), rows(rows), cols(cols)
+    {
+    }
+
+  const T& operator()(size_t i, size_t j) const
+    {
+      size_t address = base + rows[i].get() * row_length + cols[j].get();
+      memory.check_index(address);
+      return data[address];
+    }
 };
 
 template<class T, template<class> class V>
@@ -100,13 +138,43 @@ public:
     }
 };
 
+template<class T>
+class DiskMemoryPart : public MemoryPartImpl<T, DiskVector>
+{
+public:
+  void advise(size_t start, size_t n, DiskAccessPattern pattern)
+    {
+      DiskVector<T>::advise(start, n, pattern);
+    }
+};
+
+template<class T>
+class PersistentMemoryPart : public MemoryPartImpl<T, PersistentVector>
+{
+public:
+  bool is_persistent() const
+    {
+      return true;
+    }
+
+  void open(const string& filename, bool resume)
+    {
+      PersistentVector<T>::open(filename, resume);
+    }
+
+  void checkpoint()
+    {
+      PersistentVector<T>::checkpoint();
+    }
+};
+
 template<class T> 
 class Memory
 {
   public:
 
   MemoryPart<T>& MS;
-  MemoryPartImpl<typename T::clear, CheckVector> MC;
+  MemoryPartImpl<typename T::clear, MemoryVector> MC;
 
   Memory();
   ~Memory();
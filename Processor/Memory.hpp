@@ -81,8 +81,10 @@ template<class T>
 Memory<T>::Memory() :
     MS(
         *(OnlineOptions::singleton.disk_memory.size() ?
-            static_cast<MemoryPart<T>*>(new MemoryPartImpl<T, DiskVector>) :
-            static_cast<MemoryPart<T>*>(new MemoryPartImpl<T, CheckVector>)))
+            static_cast<MemoryPart<T>*>(new DiskMemoryPart<T>) :
+            PersistentVectorBase::enabled() ?
+            static_cast<MemoryPart<T>*>(new PersistentMemoryPart<T>) :
+            static_cast<MemoryPart<T>*>(new MemoryPartImpl<T, MemoryVector>)))
 {
 }
 
@@ -95,11 +97,13 @@ Memory<T>::~Memory()
 template<class T>
 ostream& operator<<(ostream& s,const Memory<T>& M)
 {
-  s << M.MS.size() << endl;
+  // persistent secret memory is stored separately
+  size_t size_s = M.MS.is_persistent() ? 0 : M.MS.size();
+  s << size_s << endl;
   s << M.MC.size() << endl;
 
 #ifdef OUTPUT_HUMAN_READABLE_MEMORY
-  for (unsigned int i=0; i<M.MS.size(); i++)
+  for (unsigned int i=0; i<size_s; i++)
     { M.MS[i].output(s,true); s << endl; }
   s << endl;
 
@@ -107,7 +111,7 @@ ostream& operator<<(ostream& s,const Memory<T>& M)
     {  M.MC[i].output(s,true); s << endl; }
   s << endl;
 #else
-  for (unsigned int i=0; i<M.MS.size(); i++)
+  for (unsigned int i=0; i<size_s; i++)
     { M.MS[i].output(s,false); }
 
   for (unsigned int i=0; i<M.MC.size(); i++)
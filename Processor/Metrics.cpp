@@ -0,0 +1,125 @@
+/*
+ * Metrics.cpp
+ *
+ */
+
+#include "Metrics.h"
+#include "BaseMachine.h"
+#include "OnlineOptions.h"
+#include "PrepTelemetry.h"
+#include "Networking/sockets.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <map>
+#include <array>
+#include <sstream>
+
+Metrics* Metrics::singleton = 0;
+thread_local Metrics::Shard* Metrics::shard = 0;
+
+Metrics::Shard::Shard(int thread_num) :
+        thread_num(thread_num), bytes(0), rounds(0), mac_checks(0)
+{
+}
+
+void Metrics::start(int my_num)
+{
+    string port = OnlineOptions::singleton.option_value("metrics_port");
+    if (singleton or port.empty())
+        return;
+    singleton = new Metrics(my_num, stoi(port) + my_num);
+}
+
+Metrics::Metrics(int my_num, int port) :
+        my_num(my_num), start_ns(PrepTelemetry::now())
+{
+    server_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_socket < 0)
+        error("Metrics: socket");
+    int one = 1;
+    setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+    if (bind(server_socket, (sockaddr*) &address, sizeof(address)) < 0)
+        error(("Metrics: cannot bind to port " + to_string(port)).c_str());
+    if (listen(server_socket, 5) < 0)
+        error("Metrics: listen");
+
+    pthread_mutex_init(&mutex, 0);
+    pthread_create(&thread, 0, run, this);
+    pthread_detach(thread);
+}
+
+Metrics::Shard* Metrics::new_shard()
+{
+    pthread_mutex_lock(&mutex);
+    shards.push_back(make_unique<Shard>(BaseMachine::thread_num));
+    auto res = shards.back().get();
+    pthread_mutex_unlock(&mutex);
+    return res;
+}
+
+void* Metrics::run(void* metrics)
+{
+    auto& self = *(Metrics*) metrics;
+    while (true)
+    {
+        int client = accept(self.server_socket, 0, 0);
+        if (client < 0)
+            continue;
+
+        // the request itself doesn't matter
+        char buffer[4096];
+        if (recv(client, buffer, sizeof(buffer), 0) > 0)
+        {
+            string body = self.report();
+            stringstream response;
+            response << "HTTP/1.0 200 OK\r\n"
+                    << "Content-Type: text/plain; version=0.0.4\r\n"
+                    << "Content-Length: " << body.size() << "\r\n\r\n"
+                    << body;
+            string res = response.str();
+            send(client, res.data(), res.size(), MSG_NOSIGNAL);
+        }
+        close(client);
+    }
+    return 0;
+}
+
+string Metrics::report()
+{
+    // threads with the same number can have several shards
+    map<int, array<long long, 3>> totals;
+    pthread_mutex_lock(&mutex);
+    for (auto& shard : shards)
+    {
+        auto& total = totals[shard->thread_num];
+        total[0] += shard->bytes;
+        total[1] += shard->rounds;
+        total[2] += shard->mac_checks;
+    }
+    pthread_mutex_unlock(&mutex);
+
+    stringstream res;
+    res << "# TYPE mpspdz_uptime_seconds gauge\n"
+            << "mpspdz_uptime_seconds{party=\"" << my_num << "\"} "
+            << (PrepTelemetry::now() - start_ns) * 1e-9 << "\n";
+
+    const char* names[] = { "mpspdz_comm_bytes_total",
+            "mpspdz_comm_rounds_total", "mpspdz_mac_checks_total" };
+    for (int i = 0; i < 3; i++)
+    {
+        res << "# TYPE " << names[i] << " counter\n";
+        for (auto& x : totals)
+            res << names[i] << "{thread=\"" << x.first << "\"} "
+                    << x.second[i] << "\n";
+    }
+
+    PrepTelemetry::print_metrics(res);
+    return res.str();
+}
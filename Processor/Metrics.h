@@ -0,0 +1,84 @@
+/*
+ * Metrics.h
+ *
+ */
+
+#ifndef PROCESSOR_METRICS_H_
+#define PROCESSOR_METRICS_H_
+
+#include <pthread.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+using namespace std;
+
+/**
+ * Live metrics for long-running parties (``-o metrics_port=<port>``).
+ * An HTTP endpoint on the given port plus the party number serves the
+ * counters in the Prometheus text format. Every thread updates its own
+ * shard with relaxed atomics, which are only summed when scraping.
+ * Preprocessing counters come from PrepTelemetry.
+ */
+class Metrics
+{
+public:
+    /// Counters of one thread
+    struct Shard
+    {
+        int thread_num;
+        atomic<long long> bytes, rounds, mac_checks;
+
+        Shard(int thread_num);
+    };
+
+    static bool active() { return singleton; }
+
+    /// Data sent in a new round or the same round as before
+    static void count_comm(size_t length, bool new_round)
+    {
+        if (not singleton)
+            return;
+        auto shard = get_shard();
+        shard->bytes.fetch_add(length, memory_order_relaxed);
+        if (new_round)
+            shard->rounds.fetch_add(1, memory_order_relaxed);
+    }
+
+    static void count_mac_check()
+    {
+        if (singleton)
+            get_shard()->mac_checks.fetch_add(1, memory_order_relaxed);
+    }
+
+    /// Start serving if requested
+    static void start(int my_num);
+
+private:
+    static Metrics* singleton;
+    static thread_local Shard* shard;
+
+    int my_num;
+    int server_socket;
+    long long start_ns;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    deque<unique_ptr<Shard>> shards;
+
+    Metrics(int my_num, int port);
+
+    static Shard* get_shard()
+    {
+        if (not shard)
+            shard = singleton->new_shard();
+        return shard;
+    }
+
+    Shard* new_shard();
+
+    static void* run(void* metrics);
+    string report();
+};
+
+#endif /* PROCESSOR_METRICS_H_ */
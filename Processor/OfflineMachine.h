@@ -11,6 +11,8 @@
 #include "BaseMachine.h"
 #include "Networking/CryptoPlayer.h"
 
+#include <signal.h>
+
 template<class W>
 class OfflineMachine : public W, BaseMachine
 {
@@ -18,9 +20,15 @@ class OfflineMachine : public W, BaseMachine
     Names& playerNames;
     Player& P;
 
+    static volatile sig_atomic_t stop_serving;
+    static void stop(int);
+
     template<class T>
     void generate();
 
+    template<class T, class U, class V>
+    void serve(V& binary_MC);
+
     int buffered_total(size_t required, size_t batch);
 
 public:
@@ -9,6 +9,11 @@
 #include "OfflineMachine.h"
 #include "Protocols/mac_key.hpp"
 #include "Tools/Buffer.h"
+#include "PrepServer.hpp"
+
+#include <signal.h>
+#include <unistd.h>
+#include <functional>
 
 template<class W>
 template<class V>
@@ -58,9 +63,15 @@ int OfflineMachine<W>::run()
     T::bit_type::MAC_Check::setup(P);
     U::MAC_Check::setup(P);
 
-    generate<T>();
-    generate<typename T::bit_type::part_type>();
-    generate<U>();
+    auto& opts = this->online_opts;
+    if (opts.has_option("serve") or not opts.option_value("serve").empty())
+        serve<T, U>(*thread.MC);
+    else
+    {
+        generate<T>();
+        generate<typename T::bit_type::part_type>();
+        generate<U>();
+    }
 
     thread.MC->Check(P);
 
@@ -101,28 +112,9 @@ void OfflineMachine<W>::generate()
         {
             ofstream out(filename, iostream::out | iostream::binary);
             file_signature<T>().output(out);
-            if (i == DATA_DABIT)
-            {
-                for (long long j = 0;
-                        j < buffered_total(my_usage, BUFFER_SIZE); j++)
-                {
-                    T a;
-                    typename T::bit_type b;
-                    preprocessing.get_dabit(a, b);
-                    dabit<T>(a, b).output(out, false);
-                }
-            }
-            else if (not (i == DATA_RANDOM or i == DATA_OPEN))
-            {
-                vector<T> tuple(DataPositions::tuple_size[i]);
-                for (long long j = 0;
-                        j < buffered_total(my_usage, BUFFER_SIZE); j++)
-                {
-                    preprocessing.get(dtype, tuple.data());
-                    for (auto& x : tuple)
-                        x.output(out, false);
-                }
-            }
+            if (not (i == DATA_RANDOM or i == DATA_OPEN))
+                PrepServer<T>::write_tuples(preprocessing, dtype, out,
+                        buffered_total(my_usage, BUFFER_SIZE));
         }
         else
             remove(filename.c_str());
@@ -139,15 +131,8 @@ void OfflineMachine<W>::generate()
         {
             ofstream out(filename, iostream::out | iostream::binary);
             file_signature<T>().output(out);
-            InputTuple<T> tuple;
-            for (long long j = 0;
-                    j < buffered_total(n_inputs, BUFFER_SIZE); j++)
-            {
-                preprocessing.get_input(tuple.share, tuple.value, i);
-                tuple.share.output(out, false);
-                if (i == P.my_num())
-                    tuple.value.output(out, false);
-            }
+            PrepServer<T>::write_inputs(preprocessing, i, P.my_num(), out,
+                    buffered_total(n_inputs, BUFFER_SIZE));
         }
         else
             remove(filename.c_str());
@@ -172,9 +157,8 @@ void OfflineMachine<W>::generate()
                 file_signature<T>().output(out);
                 auto& opts = OnlineOptions::singleton;
                 opts.batch_size = DIV_CEIL(opts.batch_size, batch) * batch;
-                for (int i = 0; i < buffered_total(total, batch) / batch; i++)
-                    preprocessing.get_edabitvec(true, n_bits).output(n_bits,
-                            out);
+                PrepServer<T>::write_edabits(preprocessing, n_bits, out,
+                        buffered_total(total, batch) / batch);
             }
             else
                 remove(filename.c_str());
@@ -184,6 +168,96 @@ void OfflineMachine<W>::generate()
     output.Check(P);
 }
 
+template<class W>
+volatile sig_atomic_t OfflineMachine<W>::stop_serving = 0;
+
+template<class W>
+void OfflineMachine<W>::stop(int)
+{
+    stop_serving = 1;
+}
+
+template<class W>
+template<class T, class U, class V>
+void OfflineMachine<W>::serve(V& binary_MC)
+{
+    auto& opts = this->online_opts;
+    string serve = opts.option_value("serve");
+    int n_consumers = max(1, serve.empty() ? 1 : stoi(serve));
+    size_t depth = max(1, stoi(opts.option_value("serve_depth", "10")));
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+
+    vector<DataPositions> served(n_consumers, DataPositions(P));
+    PrepServer<T> arithmetic(playerNames, P, usage, nthreads, served, depth);
+    PrepServer<typename T::bit_type::part_type> binary(playerNames, P, usage,
+            nthreads, served, depth);
+    PrepServer<U> gf2n(playerNames, P, usage, nthreads, served, depth);
+
+    vector<pair<PrepStream*, function<void()>>> streams;
+    for (auto stream : arithmetic.streams)
+        streams.push_back({stream, [&, stream]() { arithmetic.produce(*stream); }});
+    for (auto stream : binary.streams)
+        streams.push_back({stream, [&, stream]() { binary.produce(*stream); }});
+    for (auto stream : gf2n.streams)
+        streams.push_back({stream, [&, stream]() { gf2n.produce(*stream); }});
+
+    cerr << "Serving preprocessing to " << n_consumers << " consumer(s) with "
+            << nthreads << " thread(s) in " << streams.size()
+            << " named pipes" << endl;
+
+    size_t next = 0;
+    while (true)
+    {
+        // agree on which pipe to fill next
+        octetStream os;
+        os.store(int(stop_serving));
+        for (auto& stream : streams)
+            stream.first->report(os);
+        vector<octetStream> reports(P.num_players(), os);
+        P.unchecked_broadcast(reports);
+
+        bool stopping = false;
+        for (auto& report : reports)
+        {
+            int their_stop;
+            report.get(their_stop);
+            stopping |= their_stop;
+        }
+        if (stopping)
+            break;
+
+        vector<bool> wanted;
+        for (auto& stream : streams)
+            wanted.push_back(stream.first->agree(reports));
+
+        bool generated = false;
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            size_t j = (next + i) % streams.size();
+            if (wanted[j])
+            {
+                streams[j].second();
+                binary_MC.Check(P);
+                next = j + 1;
+                generated = true;
+                break;
+            }
+        }
+
+        if (not generated)
+            usleep(10000);
+    }
+
+    for (int i = 0; i < n_consumers; i++)
+    {
+        cerr << "Preprocessing delivered to consumer " << i << ":" << endl;
+        served[i].print_cost();
+    }
+}
+
 template<class W>
 const Names& OfflineMachine<W>::get_N()
 {
@@ -2,10 +2,16 @@
 #include "Processor/Program.h"
 #include "Processor/Online-Thread.h"
 #include "Tools/time-func.h"
+#include "Tools/CpuAffinity.h"
 #include "Processor/Data_Files.h"
 #include "Processor/Machine.h"
 #include "Processor/Processor.h"
+#include "Processor/Trace.h"
 #include "Networking/CryptoPlayer.h"
+#include "Networking/IoUringPlayer.h"
+#include "Networking/MultiplexedPlayer.h"
+#include "Networking/CoalescingPlayer.h"
+#include "Networking/ShapedPlayer.h"
 #include "Protocols/ShuffleSacrifice.h"
 #include "Protocols/LimitedPrep.h"
 #include "FHE/FFT.h"
@@ -14,6 +20,7 @@
 #include "Processor/Instruction.hpp"
 #include "Processor/Input.hpp"
 #include "Protocols/LimitedPrep.hpp"
+#include "Protocols/PrepProducer.hpp"
 #include "Protocols/MalRepRingPrep.hpp"
 #include "GC/BitAdder.hpp"
 
@@ -38,10 +45,12 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
 
   auto tinfo = this;
   Machine<sint, sgf2n>& machine=*(tinfo->machine);
-  vector<Program>& progs                = machine.progs;
+  // decoded once by the main thread and shared read-only by all threads
+  const vector<Program>& progs          = machine.progs;
 
   int num=tinfo->thread_num;
   BaseMachine::s().thread_num = num;
+  CpuAffinity::pin_compute(num);
 
   auto& queues = machine.queues[num];
   auto& opts = machine.opts;
@@ -60,6 +69,37 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
 #endif
       player = new CryptoPlayer(*(tinfo->Nms), id);
     }
+  else if (opts.has_option("multiplex"))
+    {
+#ifdef VERBOSE_OPTIONS
+      cerr << "Using connections shared by all threads" << endl;
+#endif
+      player = new MultiplexedPlayer(*(tinfo->Nms), id);
+    }
+  else if (opts.has_option("io_uring"))
+    {
+#ifdef VERBOSE_OPTIONS
+      cerr << "Using io_uring" << endl;
+#endif
+      player = new IoUringPlayer(*(tinfo->Nms), id);
+    }
+  else if (ShapedPlayer::enabled())
+    {
+#ifdef VERBOSE_OPTIONS
+      cerr << "Emulating network conditions" << endl;
+#endif
+      player = new ShapedPlayer(*(tinfo->Nms), id);
+    }
+  else if (opts.has_option("coalesce") or opts.option_value("coalesce") != "")
+    {
+      long budget = stol(opts.option_value("coalesce",
+          to_string(CoalescingPlayer::DEFAULT_BUDGET)));
+#ifdef VERBOSE_OPTIONS
+      cerr << "Coalescing messages for up to " << budget << " microseconds"
+          << endl;
+#endif
+      player = new CoalescingPlayer(*(tinfo->Nms), id, budget);
+    }
   else if (!opts.receive_threads or opts.direct)
     {
 #ifdef VERBOSE_OPTIONS
@@ -103,6 +143,24 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
   processor = new Processor<sint, sgf2n>(tinfo->thread_num,P,*MC2,*MCp,machine,progs.at(thread_num > 0));
   auto& Proc = *processor;
 
+  // generate triples in a separate thread
+  PrepProducer<sint>* producer = 0;
+  auto prep = dynamic_cast<BufferPrep<sint>*>(&Proc.DataF.DataFp);
+  string prep_thread = opts.option_value("prep_thread");
+  if (prep and sint::Protocol::uses_triples
+      and (opts.has_option("prep_thread") or not prep_thread.empty()))
+    {
+      producer = new PrepProducer<sint>(*(tinfo->Nms), id + "-prep",
+          *(tinfo->alphapi), prep_thread.empty() ? 2 : stoi(prep_thread),
+          machine.use_encryption);
+      prep->set_producer(producer);
+    }
+
+  // unused preprocessing from the last run
+  bool prep_cache = prep and opts.has_option("prep_cache");
+  if (prep_cache)
+    prep->load_cache(P);
+
   // don't count communication for initialization
   P.reset_stats();
 
@@ -127,7 +185,11 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
   while (flag)
     { // Wait until I have a program to run
       wait_timer.start();
-      ThreadJob job = queues->next();
+      ThreadJob job;
+      {
+        Trace::Span span("Waiting for job", Trace::WAIT);
+        job = queues->next();
+      }
       program = job.prognum;
       wait_timer.stop();
 #ifdef DEBUG_THREADS
@@ -208,6 +270,14 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
               job.begin, job.end);
           queues->finished(job);
         }
+      else if (job.type == SANITIZE_VEC_JOB)
+        {
+          dynamic_cast<RingPrep<sint>&>(Proc.DataF.DataFp).template
+                  sanitize<0>(
+              *(vector<edabitvec<sint>>*) job.output, job.length, job.begin,
+              job.end);
+          queues->finished(job);
+        }
       else if (job.type == EDABIT_SACRIFICE_JOB)
         {
           sint::LivePrep::edabit_sacrifice_buckets(
@@ -275,10 +345,17 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
           Proc.DataF.seekg(job.pos);
           // reset for actual usage
           Proc.DataF.reset_usage();
+
+          // generate exactly the preprocessing required by the tape
+          if (opts.has_option("plan_prep") and not progs[program].usage_unknown())
+            Proc.DataF.plan(progs[program].get_offline_data_used());
              
           //printf("\tExecuting program");
           // Execute the program
-          progs[program].execute(Proc);
+          {
+            Trace::Span span(progs[program].get_name().c_str(), Trace::TAPE);
+            progs[program].execute(Proc);
+          }
 
           // make sure values used in other threads are safe
           Proc.check();
@@ -302,6 +379,13 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
           wait_timer.start();
           queues->finished(job, P.total_comm());
 	 wait_timer.stop();
+
+          // prepare for another run of the same tape after handing back,
+          // which has to be independent of timing to keep parties in sync;
+          // thread 0 runs the main tape and distributes helper jobs
+          if (num != 0 and opts.has_option("speculative_prep")
+              and not progs[program].usage_unknown())
+            Proc.DataF.plan(progs[program].get_offline_data_used());
        }  
     }
 
@@ -312,6 +396,19 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
   online_timer.stop(P.total_comm());
   online_prep_timer += Proc.DataF.total_time();
 
+  if (producer)
+    {
+      producer->stop(P);
+      if (opts.verbose)
+        cerr << "Computation thread " << num << " used "
+            << thread_timer.elapsed() << " seconds of CPU time" << endl;
+      prep->set_producer(0);
+      delete producer;
+    }
+
+  if (prep_cache)
+    prep->store_cache(P);
+
   if (machine.opts.file_prep_per_thread)
     Proc.DataF.prune();
 
@@ -350,6 +447,7 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
 
   // wind down thread by thread
   machine.stats += Proc.stats;
+  machine.executed += Proc.executed;
   queues->timers["wait"] = wait_timer + queues->wait_timer;
   timer.stop(P.total_comm());
   queues->timers["online"] = online_timer - online_prep_timer - queues->wait_timer;
@@ -398,6 +496,7 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
   Proc.DataF.set_usage(actual_usage);
   delete processor;
 
+  queues->memory = MemoryAccounting::get();
   queues->finished(actual_usage, P.total_comm(), stats);
 
   delete MC2;
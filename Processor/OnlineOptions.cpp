@@ -9,6 +9,7 @@
 #include "Math/gfpvar.h"
 #include "Protocols/HemiOptions.h"
 #include "Protocols/config.h"
+#include "Tools/CpuAffinity.h"
 
 #include "Math/gfp.hpp"
 
@@ -35,11 +36,16 @@ OnlineOptions::OnlineOptions() : playerno(-1)
     cmd_private_input_file = "Player-Data/Input";
     cmd_private_output_file = "";
     file_prep_per_thread = false;
+    prep_consumer = 0;
+    prefetch = 0;
     trunc_error = DEFAULT_SECURITY;
     opening_sum = 0;
     max_broadcast = 0;
     receive_threads = false;
+    pipeline_window = 1;
+    mac_check_buffer = 0;
     code_locations = false;
+    profile = false;
 #ifdef VERBOSE
     verbose = true;
 #else
@@ -133,6 +139,15 @@ OnlineOptions::OnlineOptions(ez::ezOptionParser& opt, int argc,
             "Output code locations of the most relevant protocols used", // Help description.
             "--code-locations" // Flag token.
     );
+    opt.add(
+            "", // Default.
+            0, // Required?
+            0, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Profile time and communication per instruction and protocol "
+            "function, output in Player-Data/Profile-P<party>-<thread>.folded", // Help description.
+            "--profile" // Flag token.
+    );
 
     if (security)
         opt.add(
@@ -160,8 +175,10 @@ OnlineOptions::OnlineOptions(ez::ezOptionParser& opt, int argc,
 #endif
 
     opt.get("--options")->getStrings(options);
+    prep_consumer = stoi(option_value("prep_consumer", "0"));
 
     code_locations = opt.isSet("--code-locations");
+    profile = opt.isSet("--profile");
 
 #ifdef THROW_EXCEPTIONS
     options.push_back("throw_exceptions");
@@ -246,6 +263,14 @@ OnlineOptions::OnlineOptions(ez::ezOptionParser& opt, int argc,
             "-f", // Flag token.
             "--file-prep-per-thread" // Flag token.
     );
+    opt.add(
+            "0", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Megabytes to read ahead from preprocessing files (default: 0)", // Help description.
+            "--prefetch" // Flag token.
+    );
 
     opt.add(
             to_string(default_batch_size).c_str(), // Default.
@@ -267,6 +292,60 @@ OnlineOptions::OnlineOptions(ez::ezOptionParser& opt, int argc,
             "-m", // Flag token.
             "--memory" // Flag token.
     );
+    opt.add(
+            "", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Back large memory and register files with huge pages "
+            "allocated on the NUMA node of the allocating thread, "
+            "transparent|explicit (default: none)\n\t"
+            "transparent: advise kernel to use transparent huge pages\n\t"
+            "explicit: use reserved huge pages (MAP_HUGETLB) if available", // Help description.
+            "--huge-pages" // Flag token.
+    );
+    opt.add(
+            "", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Pin threads to CPUs, auto|compact|scatter|<list> "
+            "(default: none)\n\t"
+            "compact: fill NUMA nodes one after another\n\t"
+            "scatter: distribute threads over NUMA nodes\n\t"
+            "auto: compact if there is more than one NUMA node\n\t"
+            "<list>: CPUs for threads in order, e.g., 0,2,4-7", // Help description.
+            "--cpu-affinity" // Flag token.
+    );
+    opt.add(
+            "", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Write timing, communication, and preprocessing statistics "
+            "as JSON to file", // Help description.
+            "--stats-json" // Flag token.
+    );
+    opt.add(
+            "1", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Maximum number of independent multiplication rounds "
+            "in flight per thread (default: 1)", // Help description.
+            "-pw", // Flag token.
+            "--pipeline-window" // Flag token.
+    );
+    opt.add(
+            "0", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Megabytes of opened values to accumulate for MAC checking "
+            "instead of checking at every opening, only in programs "
+            "using a single thread (default: 0, i.e., not deferred)", // Help description.
+            "--mac-check-buffer" // Flag token.
+    );
     opt.add(
             "", // Default.
             0, // Required?
@@ -306,8 +385,31 @@ OnlineOptions::OnlineOptions(ez::ezOptionParser& opt, int argc,
         live_prep = false;
         file_prep_per_thread = true;
     }
+    opt.get("--prefetch")->getInt(prefetch);
     opt.get("-b")->getInt(batch_size);
     opt.get("--memory")->getString(memtype);
+    opt.get("--huge-pages")->getString(huge_pages);
+    if (not (huge_pages.empty() or huge_pages == "transparent"
+            or huge_pages == "explicit"))
+    {
+        cerr << "Invalid huge page option: " << huge_pages << endl;
+        exit(1);
+    }
+    opt.get("--cpu-affinity")->getString(cpu_affinity);
+    CpuAffinity::check(cpu_affinity);
+    opt.get("--stats-json")->getString(stats_json);
+    opt.get("--pipeline-window")->getInt(pipeline_window);
+    if (pipeline_window < 1)
+    {
+        cerr << "Invalid pipeline window: " << pipeline_window << endl;
+        exit(1);
+    }
+    opt.get("--mac-check-buffer")->getInt(mac_check_buffer);
+    if (mac_check_buffer < 0)
+    {
+        cerr << "Invalid MAC check buffer: " << mac_check_buffer << endl;
+        exit(1);
+    }
     bits_from_squares = opt.isSet("-Q");
 
     direct = opt.isSet("--direct");
@@ -36,14 +36,22 @@ public:
     std::string cmd_private_output_file;
     bool verbose;
     bool file_prep_per_thread;
+    int prep_consumer;
+    int prefetch;
     int trunc_error;
     int opening_sum, max_broadcast;
     bool receive_threads;
     std::string disk_memory;
+    std::string huge_pages;
+    std::string cpu_affinity;
+    std::string stats_json;
+    int pipeline_window;
+    int mac_check_buffer;
     vector<long> args;
     vector<string> options;
     string executable;
     bool code_locations;
+    bool profile;
 
     OnlineOptions();
     OnlineOptions(ez::ezOptionParser& opt, int argc, const char** argv,
@@ -79,6 +87,15 @@ public:
     {
         return find(options.begin(), options.end(), option) != options.end();
     }
+
+    /// Value of option given as ``name=value``
+    string option_value(const string& name, const string& default_value = "")
+    {
+        for (auto& option : options)
+            if (option.compare(0, name.size() + 1, name + "=") == 0)
+                return option.substr(name.size() + 1);
+        return default_value;
+    }
 };
 
 #endif /* PROCESSOR_ONLINEOPTIONS_H_ */
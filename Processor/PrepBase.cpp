@@ -13,7 +13,12 @@ string PrepBase::get_suffix(int thread_num)
     if (OnlineOptions::singleton.file_prep_per_thread)
     {
         assert(thread_num >= 0);
-        return "-T" + to_string(thread_num);
+        string res;
+        // several consumers of a preprocessing server
+        int consumer = OnlineOptions::singleton.prep_consumer;
+        if (consumer > 0)
+            res += "-C" + to_string(consumer);
+        return res + "-T" + to_string(thread_num);
     }
     else
         return "";
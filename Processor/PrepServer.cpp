@@ -0,0 +1,164 @@
+/*
+ * PrepServer.cpp
+ *
+ */
+
+#include "PrepServer.h"
+#include "Tools/Exceptions.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+pthread_mutex_t PrepStream::served_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+PrepStream::PrepStream(const string& filename, const string& header, int kind,
+        int arg, long long& served, size_t depth) :
+        filename(filename), header(header), served(served), depth(depth),
+        epoch(0), agreed(0), stopping(false), kind(kind), arg(arg)
+{
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) == 0 and not S_ISFIFO(buf.st_mode))
+        remove(filename.c_str());
+    if (mkfifo(filename.c_str(), 0600) != 0 and errno != EEXIST)
+        throw file_error("cannot create named pipe " + filename);
+
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&cond, 0);
+    pthread_create(&thread, 0, run, this);
+}
+
+PrepStream::~PrepStream()
+{
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+    // interrupt waiting for consumer
+    pthread_cancel(thread);
+    pthread_join(thread, 0);
+    pthread_mutex_destroy(&mutex);
+    pthread_cond_destroy(&cond);
+}
+
+void* PrepStream::run(void* stream)
+{
+    // only cancel while blocking on the pipe
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, 0);
+    ((PrepStream*) stream)->serve();
+    return 0;
+}
+
+bool PrepStream::write_all(int fd, const string& data)
+{
+    size_t done = 0;
+    while (done < data.size())
+    {
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+        auto res = write(fd, data.data() + done, data.size() - done);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, 0);
+        if (res < 0 and errno == EINTR)
+            continue;
+        if (res <= 0)
+            return false;
+        done += res;
+    }
+    return true;
+}
+
+void PrepStream::serve()
+{
+    while (true)
+    {
+        // blocks until consumer opens the pipe
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+        int fd = open(filename.c_str(), O_WRONLY);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, 0);
+        if (fd < 0)
+            throw file_error(filename);
+
+        bool alive = write_all(fd, header);
+
+        pthread_mutex_lock(&mutex);
+        while (alive)
+        {
+            while (batches.empty() and not stopping)
+                pthread_cond_wait(&cond, &mutex);
+            if (stopping)
+                break;
+
+            auto batch = move(batches.front());
+            batches.pop_front();
+            // belongs to previous consumer
+            if (batch.epoch != epoch)
+                continue;
+
+            pthread_cond_broadcast(&cond);
+            pthread_mutex_unlock(&mutex);
+            alive = write_all(fd, batch.data);
+            if (alive)
+            {
+                pthread_mutex_lock(&served_mutex);
+                served += batch.n_items;
+                pthread_mutex_unlock(&served_mutex);
+            }
+            pthread_mutex_lock(&mutex);
+        }
+
+        close(fd);
+
+        // consumer closed the pipe, wait for all parties to notice
+        batches.clear();
+        epoch++;
+        while (agreed < epoch and not stopping)
+            pthread_cond_wait(&cond, &mutex);
+        bool stop = stopping;
+        pthread_mutex_unlock(&mutex);
+        if (stop)
+            return;
+    }
+}
+
+void PrepStream::report(octetStream& os)
+{
+    pthread_mutex_lock(&mutex);
+    os.store(int(batches.size() < depth));
+    os.store(epoch);
+    pthread_mutex_unlock(&mutex);
+}
+
+bool PrepStream::agree(vector<octetStream>& reports)
+{
+    bool wanted = true;
+    size_t min_epoch = SIZE_MAX, max_epoch = 0;
+    for (auto& os : reports)
+    {
+        int needs;
+        size_t their_epoch;
+        os.get(needs);
+        os.get(their_epoch);
+        wanted &= needs;
+        min_epoch = min(min_epoch, their_epoch);
+        max_epoch = max(max_epoch, their_epoch);
+    }
+
+    pthread_mutex_lock(&mutex);
+    if (min_epoch > agreed)
+    {
+        agreed = min_epoch;
+        pthread_cond_broadcast(&cond);
+    }
+    pthread_mutex_unlock(&mutex);
+
+    // no generation while a consumer change is pending
+    return wanted and min_epoch == max_epoch;
+}
+
+void PrepStream::push(string&& data, long long n_items)
+{
+    pthread_mutex_lock(&mutex);
+    batches.push_back({move(data), n_items, agreed});
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,124 @@
+/*
+ * PrepServer.h
+ *
+ */
+
+#ifndef PROCESSOR_PREPSERVER_H_
+#define PROCESSOR_PREPSERVER_H_
+
+#include "Data_Files.h"
+#include "Networking/Player.h"
+
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <vector>
+using namespace std;
+
+template<class T> class SubProcessor;
+
+/**
+ * Named pipe filled by a preprocessing server (``-o serve``)
+ * in the format of preprocessing files. Every consumer opening the
+ * pipe receives the header followed by fresh data, and data that is
+ * not delivered when the consumer closes the pipe is discarded.
+ */
+class PrepStream
+{
+    struct Batch
+    {
+        string data;
+        long long n_items;
+        size_t epoch;
+    };
+
+    static pthread_mutex_t served_mutex;
+
+    string filename, header;
+    long long& served;
+    size_t depth;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    deque<Batch> batches;
+
+    // consumers finished locally and at all parties
+    size_t epoch, agreed;
+    bool stopping;
+
+    static void* run(void* stream);
+    void serve();
+    bool write_all(int fd, const string& data);
+
+public:
+    /// Type of preprocessing: tuple type, input player, or edaBit length
+    const int kind, arg;
+
+    /**
+     * Create named pipe and start serving
+     * @param filename file name of preprocessing file
+     * @param header preprocessing file header
+     * @param served counter of items delivered
+     * @param depth number of batches to generate in advance
+     */
+    PrepStream(const string& filename, const string& header, int kind,
+            int arg, long long& served, size_t depth);
+    ~PrepStream();
+
+    /// Local state for agreement
+    void report(octetStream& os);
+    /// Process reports of all parties, returns whether to generate
+    bool agree(vector<octetStream>& reports);
+    /// Queue batch for delivery
+    void push(string&& data, long long n_items);
+};
+
+/**
+ * Preprocessing generation for named pipes in one domain
+ */
+template<class T>
+class PrepServer
+{
+    Player& P;
+    typename T::mac_key_type mac_key;
+    typename T::MAC_Check output;
+    DataPositions generated;
+    typename T::LivePrep preprocessing;
+    SubProcessor<T> processor;
+
+    static typename T::mac_key_type setup(Player& P);
+    static long long batch_size();
+
+public:
+    enum Kind
+    {
+        TUPLE,
+        INPUT,
+        EDABIT,
+    };
+
+    static void write_tuples(Preprocessing<T>& preprocessing, Dtype dtype,
+            ostream& out, long long n);
+    static void write_inputs(Preprocessing<T>& preprocessing, int player,
+            int my_num, ostream& out, long long n);
+    static void write_edabits(Preprocessing<T>& preprocessing, int n_bits,
+            ostream& out, long long n_vecs);
+
+    vector<PrepStream*> streams;
+
+    /**
+     * Set up domain and named pipes for all consumers and threads
+     * @param usage preprocessing required by program per thread
+     * @param served items delivered per consumer
+     */
+    PrepServer(const Names& N, Player& P, const DataPositions& usage,
+            int n_threads, vector<DataPositions>& served, size_t depth);
+    ~PrepServer();
+
+    /// Generate and check a batch for a stream
+    void produce(PrepStream& stream);
+};
+
+#endif /* PROCESSOR_PREPSERVER_H_ */
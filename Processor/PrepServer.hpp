@@ -0,0 +1,181 @@
+/*
+ * PrepServer.hpp
+ *
+ */
+
+#ifndef PROCESSOR_PREPSERVER_HPP_
+#define PROCESSOR_PREPSERVER_HPP_
+
+#include "PrepServer.h"
+#include "Protocols/mac_key.hpp"
+#include "Tools/Buffer.h"
+
+#include <sstream>
+#include <set>
+
+template<class T>
+typename T::mac_key_type PrepServer<T>::setup(Player& P)
+{
+    T::clear::next::template init<typename T::clear>(false);
+    T::clear::template write_setup<T>(P.num_players());
+    return read_generate_write_mac_key<T>(P);
+}
+
+template<class T>
+PrepServer<T>::PrepServer(const Names& N, Player& P,
+        const DataPositions& usage, int n_threads,
+        vector<DataPositions>& served, size_t depth) :
+        P(P), mac_key(setup(P)), output(mac_key), generated(P.num_players()),
+        preprocessing(0, generated), processor(output, preprocessing, P)
+{
+    auto& opts = OnlineOptions::singleton;
+    auto field_type = T::clear::field_type();
+    ostringstream ss;
+    file_signature<T>().output(ss);
+    string header = ss.str();
+
+    opts.file_prep_per_thread = true;
+    long additional_inputs = Sub_Data_Files<T>::additional_inputs(usage);
+
+    // strict and loose edaBits are stored in the same file
+    set<int> edabit_lengths;
+    if (field_type == DATA_INT)
+        for (auto& x : usage.edabits)
+            if (x.second > 0)
+                edabit_lengths.insert(x.first.second);
+
+    if (not edabit_lengths.empty())
+    {
+        int batch = edabitvec<T>::MAX_SIZE;
+        opts.batch_size = DIV_CEIL(opts.batch_size, batch) * batch;
+    }
+
+    for (size_t consumer = 0; consumer < served.size(); consumer++)
+    {
+        opts.prep_consumer = consumer;
+        auto& positions = served[consumer];
+
+        for (int thread = 0; thread < n_threads; thread++)
+        {
+            for (int i = 0; i < N_DTYPE; i++)
+                if (usage.files[field_type][i] > 0
+                        and not (i == DATA_RANDOM or i == DATA_OPEN))
+                    streams.push_back(
+                            new PrepStream(
+                                    Sub_Data_Files<T>::get_filename(N,
+                                            Dtype(i), thread), header, TUPLE,
+                                    i, positions.files[field_type][i], depth));
+
+            for (int i = 0; i < P.num_players(); i++)
+                if (usage.inputs[i][field_type] + additional_inputs > 0)
+                    streams.push_back(
+                            new PrepStream(
+                                    Sub_Data_Files<T>::get_input_filename(N, i,
+                                            thread), header, INPUT, i,
+                                    positions.inputs[i][field_type], depth));
+
+            for (int n_bits : edabit_lengths)
+                streams.push_back(
+                        new PrepStream(
+                                Sub_Data_Files<T>::get_edabit_filename(N,
+                                        n_bits, thread), header, EDABIT,
+                                n_bits, positions.edabits[{true, n_bits}],
+                                depth));
+        }
+    }
+
+    opts.prep_consumer = 0;
+}
+
+template<class T>
+PrepServer<T>::~PrepServer()
+{
+    for (auto stream : streams)
+        delete stream;
+    output.Check(P);
+}
+
+template<class T>
+long long PrepServer<T>::batch_size()
+{
+    return max(OnlineOptions::singleton.batch_size, BUFFER_SIZE);
+}
+
+template<class T>
+void PrepServer<T>::produce(PrepStream& stream)
+{
+    ostringstream out;
+    long long n_items = batch_size();
+    switch (stream.kind)
+    {
+    case TUPLE:
+        write_tuples(preprocessing, Dtype(stream.arg), out, n_items);
+        break;
+    case INPUT:
+        write_inputs(preprocessing, stream.arg, P.my_num(), out, n_items);
+        break;
+    case EDABIT:
+    {
+        long long n_vecs = DIV_CEIL(n_items, edabitvec<T>::MAX_SIZE);
+        write_edabits(preprocessing, stream.arg, out, n_vecs);
+        n_items = n_vecs * edabitvec<T>::MAX_SIZE;
+        break;
+    }
+    default:
+        throw runtime_error("unknown preprocessing kind");
+    }
+
+    // only deliver checked data
+    output.Check(P);
+    stream.push(out.str(), n_items);
+}
+
+template<class T>
+void PrepServer<T>::write_tuples(Preprocessing<T>& preprocessing, Dtype dtype,
+        ostream& out, long long n)
+{
+    if (dtype == DATA_DABIT)
+    {
+        for (long long j = 0; j < n; j++)
+        {
+            T a;
+            typename T::bit_type b;
+            preprocessing.get_dabit(a, b);
+            dabit<T>(a, b).output(out, false);
+        }
+    }
+    else
+    {
+        vector<T> tuple(DataPositions::tuple_size[dtype]);
+        for (long long j = 0; j < n; j++)
+        {
+            preprocessing.get(dtype, tuple.data());
+            for (auto& x : tuple)
+                x.output(out, false);
+        }
+    }
+}
+
+template<class T>
+void PrepServer<T>::write_inputs(Preprocessing<T>& preprocessing, int player,
+        int my_num, ostream& out, long long n)
+{
+    InputTuple<T> tuple;
+    for (long long j = 0; j < n; j++)
+    {
+        preprocessing.get_input(tuple.share, tuple.value, player);
+        tuple.share.output(out, false);
+        if (player == my_num)
+            tuple.value.output(out, false);
+    }
+}
+
+template<class T>
+void PrepServer<T>::write_edabits(Preprocessing<T>& preprocessing, int n_bits,
+        ostream& out, long long n_vecs)
+{
+    for (long long i = 0; i < n_vecs; i++)
+        preprocessing.get_edabitvec(true, n_bits).output(n_bits, out);
+}
+
+#endif /* PROCESSOR_PREPSERVER_HPP_ */
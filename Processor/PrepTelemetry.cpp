@@ -0,0 +1,211 @@
+/*
+ * PrepTelemetry.cpp
+ *
+ */
+
+#include "PrepTelemetry.h"
+#include "BaseMachine.h"
+#include "OnlineOptions.h"
+#include "Data_Files.h"
+#include "Tools/Exceptions.h"
+#include "Metrics.h"
+
+#include <sstream>
+
+PrepTelemetry* PrepTelemetry::singleton = 0;
+thread_local bool PrepTelemetry::ignore = false;
+
+PrepTelemetry::Record::Record(int thread_num, const string& type_string) :
+        thread_num(thread_num), type_string(type_string)
+{
+    for (auto x : {&produced, &consumed, &buffered, &stall_ns})
+        for (auto& y : *x)
+            y = 0;
+}
+
+PrepTelemetry::Record* PrepTelemetry::get(const string& type_string)
+{
+    auto telemetry = singleton;
+    if (not telemetry or ignore)
+        return 0;
+
+    int thread_num = BaseMachine::thread_num;
+    pthread_mutex_lock(&telemetry->mutex);
+    Record* res = 0;
+    for (auto& record : telemetry->records)
+        if (record->thread_num == thread_num
+                and record->type_string == type_string)
+            res = record.get();
+    if (not res)
+    {
+        telemetry->records.push_back(
+                make_unique<Record>(thread_num, type_string));
+        telemetry->last.push_back({});
+        res = telemetry->records.back().get();
+    }
+    pthread_mutex_unlock(&telemetry->mutex);
+    return res;
+}
+
+string PrepTelemetry::kind_name(int kind)
+{
+    if (kind == INPUTS)
+        return "Inputs";
+    else if (kind == EDABITS)
+        return "edaBits";
+    else
+        return DataPositions::dtype_names[kind];
+}
+
+void PrepTelemetry::Refill::trace()
+{
+    // the spans refer to the names until the end
+    static const auto names = []()
+    {
+        vector<string> res;
+        for (int i = 0; i < N_KINDS; i++)
+            res.push_back("Refilling " + kind_name(i));
+        return res;
+    }();
+    Trace::record(names[kind].c_str(), Trace::PREP, trace_start);
+}
+
+void PrepTelemetry::start(int my_num)
+{
+    auto& opts = OnlineOptions::singleton;
+    string filename = opts.option_value("telemetry");
+    // live metrics use the records without periodic reports
+    if (singleton or (filename.empty() and not Metrics::active()))
+        return;
+    singleton = new PrepTelemetry(my_num, filename,
+            stod(opts.option_value("telemetry_interval", "1")));
+}
+
+void PrepTelemetry::stop()
+{
+    // keep records for preprocessing still in use
+    auto telemetry = singleton;
+    if (not telemetry)
+        return;
+    pthread_mutex_lock(&telemetry->mutex);
+    bool running = not telemetry->stopping;
+    telemetry->stopping = true;
+    pthread_cond_broadcast(&telemetry->cond);
+    pthread_mutex_unlock(&telemetry->mutex);
+    if (running)
+        pthread_join(telemetry->thread, 0);
+}
+
+PrepTelemetry::PrepTelemetry(int my_num, const string& filename,
+        double interval) :
+        my_num(my_num), interval(interval), stopping(filename.empty())
+{
+    start_ns = last_ns = now();
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&cond, 0);
+    if (filename.empty())
+        return;
+    out.open(filename, ios::app);
+    if (not out.good())
+        throw file_error("cannot open telemetry output " + filename);
+    pthread_create(&thread, 0, run, this);
+}
+
+void* PrepTelemetry::run(void* telemetry)
+{
+    auto& self = *(PrepTelemetry*) telemetry;
+    pthread_mutex_lock(&self.mutex);
+    while (not self.stopping)
+    {
+        long long next = self.last_ns + self.interval * 1e9;
+        // condition variables use the real-time clock by default
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        long long until = max(next - now(), 0ll)
+                + deadline.tv_sec * 1000000000ll + deadline.tv_nsec;
+        deadline.tv_sec = until / 1000000000;
+        deadline.tv_nsec = until % 1000000000;
+        pthread_cond_timedwait(&self.cond, &self.mutex, &deadline);
+        if (now() >= next or self.stopping)
+            self.report();
+    }
+    pthread_mutex_unlock(&self.mutex);
+    return 0;
+}
+
+void PrepTelemetry::report()
+{
+    long long ns = now();
+    double elapsed = (ns - last_ns) * 1e-9;
+    last_ns = ns;
+
+    out << "{\"time\": " << (ns - start_ns) * 1e-9 << ", \"party\": "
+            << my_num << ", \"stats\": [";
+
+    bool first = true;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        auto& record = *records[i];
+        for (int kind = 0; kind < N_KINDS; kind++)
+        {
+            long long produced = record.produced[kind];
+            long long consumed = record.consumed[kind];
+            if (produced == 0 and consumed == 0)
+                continue;
+
+            auto& previous = last[i][kind];
+            string name = kind_name(kind);
+
+            if (not first)
+                out << ", ";
+            first = false;
+            out << "{\"thread\": " << record.thread_num << ", \"type\": \""
+                    << record.type_string << "\", \"kind\": \"" << name
+                    << "\", \"produced\": " << produced
+                    << ", \"consumed\": " << consumed
+                    << ", \"production_rate\": "
+                    << (produced - previous[0]) / elapsed
+                    << ", \"consumption_rate\": "
+                    << (consumed - previous[1]) / elapsed
+                    << ", \"buffered\": "
+                    << max(record.buffered[kind].load(), 0ll)
+                    << ", \"stall\": " << record.stall_ns[kind] * 1e-9 << "}";
+            previous = {{produced, consumed}};
+        }
+    }
+
+    out << "]}" << endl;
+}
+
+void PrepTelemetry::print_metrics(ostream& os)
+{
+    auto telemetry = singleton;
+    if (not telemetry)
+        return;
+
+    os << "# TYPE mpspdz_prep_produced_total counter\n"
+            << "# TYPE mpspdz_prep_consumed_total counter\n"
+            << "# TYPE mpspdz_prep_buffered gauge\n"
+            << "# TYPE mpspdz_prep_stall_seconds_total counter\n";
+
+    pthread_mutex_lock(&telemetry->mutex);
+    for (auto& record : telemetry->records)
+        for (int kind = 0; kind < N_KINDS; kind++)
+        {
+            if (record->produced[kind] == 0 and record->consumed[kind] == 0)
+                continue;
+            stringstream labels;
+            labels << "{thread=\"" << record->thread_num << "\",type=\""
+                    << record->type_string << "\",kind=\"" << kind_name(kind)
+                    << "\"} ";
+            os << "mpspdz_prep_produced_total" << labels.str()
+                    << record->produced[kind] << "\n";
+            os << "mpspdz_prep_consumed_total" << labels.str()
+                    << record->consumed[kind] << "\n";
+            os << "mpspdz_prep_buffered" << labels.str()
+                    << max(record->buffered[kind].load(), 0ll) << "\n";
+            os << "mpspdz_prep_stall_seconds_total" << labels.str()
+                    << record->stall_ns[kind] * 1e-9 << "\n";
+        }
+    pthread_mutex_unlock(&telemetry->mutex);
+}
@@ -0,0 +1,138 @@
+/*
+ * PrepTelemetry.h
+ *
+ */
+
+#ifndef PROCESSOR_PREPTELEMETRY_H_
+#define PROCESSOR_PREPTELEMETRY_H_
+
+#include "Math/field_types.h"
+#include "Trace.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <atomic>
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+#include <fstream>
+using namespace std;
+
+/**
+ * Periodic report of live preprocessing (``-o telemetry=<file>``).
+ * Every second (or ``-o telemetry_interval=<seconds>``), a line of JSON
+ * with the production and consumption per thread, share type, and
+ * kind of preprocessing is appended to the file, which can also be
+ * a named pipe. The records also feed the live metrics (see Metrics).
+ */
+class PrepTelemetry
+{
+public:
+    // tuple types followed by inputs and edaBits
+    static const int INPUTS = N_DTYPE;
+    static const int EDABITS = N_DTYPE + 1;
+    static const int N_KINDS = N_DTYPE + 2;
+
+    /// Counters of a thread and share type, all in items
+    struct Record
+    {
+        int thread_num;
+        string type_string;
+
+        array<atomic<long long>, N_KINDS> produced, consumed, buffered,
+                stall_ns;
+
+        Record(int thread_num, const string& type_string);
+
+        void consume(int kind, long long n)
+        {
+            consumed[kind].fetch_add(n, memory_order_relaxed);
+            buffered[kind].fetch_sub(n, memory_order_relaxed);
+        }
+    };
+
+    /// Measurement of one buffer refill
+    class Refill
+    {
+        Record* record;
+        int kind;
+        long long before, start, trace_start;
+
+        void trace();
+
+    public:
+        /// @param stall whether consumption waits for the refill
+        Refill(Record* record, int kind, size_t before, bool stall = true) :
+                record(record), kind(kind), before(before),
+                start(record and stall ? now() : 0),
+                trace_start(Trace::active() ? now() : 0)
+        {
+        }
+
+        void done(size_t after);
+    };
+
+    // preprocessing threads only report when delivering
+    static thread_local bool ignore;
+
+    static long long now();
+
+    /// Record for current thread and share type or null if inactive
+    static Record* get(const string& type_string);
+
+    /// Start reporting if requested
+    static void start(int my_num);
+    /// Final report
+    static void stop();
+
+    /// Current counters in the Prometheus text format
+    static void print_metrics(ostream& os);
+
+private:
+    static PrepTelemetry* singleton;
+
+    int my_num;
+    ofstream out;
+    double interval;
+    long long start_ns, last_ns;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool stopping;
+
+    deque<unique_ptr<Record>> records;
+    // state at last report for rates
+    deque<array<array<long long, 2>, N_KINDS>> last;
+
+    PrepTelemetry(int my_num, const string& filename, double interval);
+
+    static string kind_name(int kind);
+
+    static void* run(void* telemetry);
+    void report();
+};
+
+inline long long PrepTelemetry::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+inline void PrepTelemetry::Refill::done(size_t after)
+{
+    if (trace_start)
+        trace();
+    if (not record)
+        return;
+    record->produced[kind].fetch_add((long long) after - before,
+            memory_order_relaxed);
+    record->buffered[kind].store(after, memory_order_relaxed);
+    if (start)
+        record->stall_ns[kind].fetch_add(now() - start,
+                memory_order_relaxed);
+}
+
+#endif /* PROCESSOR_PREPTELEMETRY_H_ */
@@ -13,8 +13,10 @@
 #include "PrivateOutput.h"
 #include "ExternalClients.h"
 #include "Binary_File_IO.h"
+#include "BlockOutput.h"
 #include "Instruction.h"
 #include "ProcessorBase.h"
+#include "Profiler.h"
 #include "OnlineOptions.h"
 #include "Tools/SwitchableOutput.h"
 #include "Tools/CheckVector.h"
@@ -24,6 +26,7 @@
 #include "Tools/NamedStats.h"
 
 class Program;
+template<class T, class U> class MemoryMatrixView;
 
 // synchronize in asymmetric protocols
 template<class T>
@@ -47,7 +50,13 @@ class SubProcessor
   void matmulsm_finalize(int i, int j, const vector<int>& dim,
       typename vector<T>::iterator C);
 
-  void maybe_check();
+  // further instances for rounds in flight, see start_muls()
+  vector<typename T::Protocol*> pipeline;
+
+  typename T::Protocol& get_protocol(int slot);
+
+  void prepare_muls(const vector<int>& reg, typename T::Protocol& protocol);
+  void finalize_muls(const vector<int>& reg, typename T::Protocol& protocol);
 
   template<class sint, class sgf2n> friend class Processor;
   template<class U> friend class SPDZ;
@@ -79,15 +88,25 @@ public:
   ~SubProcessor();
 
   void check();
+  void maybe_check();
 
   // Access to PO (via calls to POpen start/stop)
   void POpen(const Instruction& inst);
 
   void muls(const vector<int>& reg);
+  // split phase, see Program::find_overlaps()
+  // use different slots for several rounds in flight
+  int init_pipeline();
+  void start_muls(const vector<int>& reg, int slot = 0);
+  void stop_muls(const vector<int>& reg, int slot = 0);
   void mulrs(const vector<int>& reg);
+  void mul_trunc_pr(const vector<int>& reg);
   void dotprods(const vector<int>& reg, int size);
   void matmuls(const StackedVector<T>& source, const Instruction& instruction);
   void matmulsm(const MemoryPart<T>& source, const vector<int>& args);
+  // operands of MATMULSM in place (factor 0 or 1)
+  MemoryMatrixView<T, Integer> matmulsm_view(const MemoryPart<T>& source,
+      vector<int>::const_iterator args, int factor);
 
   void matmulsm_finalize_batch(vector<int>::const_iterator startMatmul, int startI, int startJ,
                                vector<int>::const_iterator endMatmul,
@@ -95,6 +114,13 @@ public:
 
   void conv2ds(const Instruction& instruction);
 
+  void cisc(const Instruction& instruction);
+  // less than zero with edaBits, only for computation modulo 2^k
+  template<int>
+  void ltz(const vector<int>& args, false_type, false_type);
+  template<int, class U, class V>
+  void ltz(const vector<int>&, U, V) { throw not_implemented(); }
+
   void secure_shuffle(const Instruction& instruction);
   size_t generate_secure_shuffle(const Instruction& instruction,
       ShuffleStore& shuffle_store);
@@ -137,6 +163,12 @@ public:
       const vector<int>& data_registers, size_t vector_size, U& Proc);
   void write_shares_to_file(long start_pos, const vector<int>& data_registers,
       size_t vector_size);
+
+  // Columns of secret-shared tables
+  void write_column(const string& name, int source, size_t size,
+      int bit_length, int precision);
+  void read_column(const string& name, int dest, size_t size, long start,
+      int bit_length, int precision);
 };
 
 class ArithmeticProcessor : public ProcessorBase
@@ -146,6 +178,7 @@ protected:
 
   ofstream public_output;
   ofstream binary_output;
+  BlockOutput block_output;
 
 public:
   int thread_num;
@@ -241,6 +274,9 @@ class Processor : public ArithmeticProcessor
   CommStats client_stats;
   Timer& client_timer;
 
+  // costs per instruction with --profile
+  Profiler* profiler;
+
   void reset(const Program& program,int arg); // Reset the state of the processor
   string get_filename(const char* basename, bool use_number);
 
@@ -280,6 +316,8 @@ class Processor : public ArithmeticProcessor
 
   void dabit(const Instruction& instruction);
   void edabit(const Instruction& instruction, bool strict = false);
+  void a2b(const Instruction& instruction);
+  void b2a(const Instruction& instruction);
 
   void convcbitvec(const Instruction& instruction);
   void convcintvec(const Instruction& instruction);
@@ -295,6 +333,12 @@ class Processor : public ArithmeticProcessor
 
   void read_socket_vector(int client_id, const vector<int>& registers,
       int size);
+  // one message per client sent in the background
+  void write_socket_batch(int clients, int message_type, int n_clients,
+      int n_values, const vector<int>& registers);
+  // messages received in the background
+  void read_socket_batch(int slots, int values, int n_messages,
+      int n_values);
   void read_socket_private(int client_id, const vector<int>& registers,
       int size, bool send_macs);
 
@@ -308,6 +352,9 @@ class Processor : public ArithmeticProcessor
   ofstream& get_public_output();
   ofstream& get_binary_output();
 
+  // whole vector as one block of 64-bit integers
+  void write_block_output(int player, int precision, int source, int size);
+
   void call_tape(int tape_number, int arg, const vector<int>& results);
 
   private:
@@ -6,12 +6,15 @@
 #include "GC/square64.h"
 #include "SpecificPrivateOutput.h"
 #include "Conv2dTuple.h"
+#include "ColumnFile.hpp"
 #include "Protocols/Replicated.h"
 
 #include "Processor/ProcessorBase.hpp"
 #include "GC/Processor.hpp"
 #include "GC/ShareThread.hpp"
+#include "GC/BitAdder.hpp"
 #include "Protocols/SecureShuffle.hpp"
+#include "Protocols/SemiShuffler.hpp"
 
 #include <sodium.h>
 #include <string>
@@ -48,6 +51,8 @@ SubProcessor<T>::~SubProcessor()
       auto& x = personal_bit_preps[i];
       delete x;
     }
+  for (auto x : pipeline)
+    delete x;
 #ifdef VERBOSE
   if (not bit_usage.empty())
     {
@@ -78,6 +83,22 @@ inline ofstream& Processor<sint, sgf2n>::get_binary_output()
   return binary_output;
 }
 
+template<class sint, class sgf2n>
+void Processor<sint, sgf2n>::write_block_output(int player, int precision,
+    int source, int size)
+{
+  if (player != -1 and player != P.my_num())
+    return;
+
+  vector<int64_t> values;
+  values.reserve(size);
+  for (int i = 0; i < size; i++)
+    values.push_back(Integer(read_Cp(source + i)).get());
+  block_output.write(
+      get_parameterized_filename(P.my_num(), thread_num,
+          PREP_DIR "Block-Output"), values.data(), values.size(), precision);
+}
+
 template<class sint, class sgf2n>
 Processor<sint, sgf2n>::Processor(int thread_num,Player& P,
         typename sgf2n::MAC_Check& MC2,typename sint::MAC_Check& MCp,
@@ -89,10 +110,13 @@ Processor<sint, sgf2n>::Processor(int thread_num,Player& P,
   Procb(machine.bit_memories),
   Proc2(*this,MC2,DataF.DataF2,P),Procp(*this,MCp,DataF.DataFp,P),
   external_clients(machine.external_clients),
-  client_timer(client_stats.timer)
+  client_timer(client_stats.timer), profiler(0)
 {
   reset(program,0);
 
+  if (OnlineOptions::singleton.profile)
+    profiler = new Profiler(P, thread_num);
+
   public_input_filename = get_filename("Programs/Public-Input/",false);
   public_input.open(public_input_filename);
   private_input_filename = (get_filename(PREP_DIR "Private-Input-",true));
@@ -133,6 +157,7 @@ Processor<sint, sgf2n>::~Processor()
     cerr << "Client communication: " << client_stats.data * 1e-6 << " MB in "
         << client_timer.elapsed() << " seconds and " << client_stats.rounds
         << " rounds " << endl;
+  delete profiler;
 }
 
 template<class sint, class sgf2n>
@@ -171,6 +196,8 @@ void SubProcessor<T>::check()
 {
   // protocol check before last MAC check
   protocol.check();
+  for (auto x : pipeline)
+    x->check();
   // MACCheck
   MC.Check(P);
 }
@@ -214,6 +241,149 @@ void Processor<sint, sgf2n>::edabit(const Instruction& instruction, bool strict)
           &Procp.get_S_ref(instruction.get_r(0)), Procb.S, regs);
 }
 
+template<class sint, class sgf2n>
+void Processor<sint, sgf2n>::a2b(const Instruction& instruction)
+{
+  typedef typename sint::bit_type bit_type;
+  typedef typename sint::clear clear;
+  auto& regs = instruction.get_start();
+  int n_bits = regs.size();
+  int size = instruction.get_size();
+  int unit = bit_type::default_length;
+  int n_words = DIV_CEIL(size, unit);
+
+  if constexpr (clear::N_BITS > 0 and not clear::characteristic_two)
+    {
+      int l = clear::N_BITS;
+      assert(unit == 64);
+      if (n_bits > min(l, 64))
+        throw runtime_error("A2B only implemented for up to 64 bits");
+
+      // mask with loose edaBits, whose bits go to the destination
+      vector<sint> masks(size), masked(size);
+      Procp.DataF.get_edabits(false, size, masks.data(), Procb.S, regs);
+      auto source = Procp.get_S().iterator_for_size(instruction.get_r(0),
+          size);
+      for (int i = 0; i < size; i++)
+        masked[i] = (*source++ - masks[i]) << (l - n_bits);
+      vector<typename sint::open_type> opened;
+      Procp.MC.POpen(opened, masked, P);
+
+      // public summand transposed to words of bits
+      vector<vector<long>> public_bits(n_words, vector<long>(n_bits));
+      for (int k = 0; k < n_words; k++)
+        {
+          square64 square;
+          int n_rows = min(size - k * unit, unit);
+          for (int i = 0; i < n_rows; i++)
+            square.rows[i] = Integer::convert_unsigned(
+                clear(opened[k * unit + i]) >> (l - n_bits)).get();
+          square.transpose(n_rows, n_bits);
+          for (int j = 0; j < n_bits; j++)
+            public_bits[k][j] = square.rows[j];
+        }
+
+      // ripple carry with one round per bit except the first and last
+      auto& protocol = *share_thread.protocol;
+      vector<bit_type> carries(n_words), masks_bits(n_words);
+      for (int j = 0; j < n_bits; j++)
+        {
+          for (int k = 0; k < n_words; k++)
+            {
+              auto& dest = Procb.S[regs[j] + k];
+              masks_bits[k] = dest;
+              bit_type public_bit;
+              public_bit.load_clear(min(size - k * unit, unit),
+                  public_bits[k][j]);
+              dest ^= public_bit;
+              dest ^= carries[k];
+            }
+
+          if (j == n_bits - 1)
+            break;
+
+          if (j == 0)
+            {
+              for (int k = 0; k < n_words; k++)
+                carries[k] = masks_bits[k] & GC::Clear(public_bits[k][0]);
+              continue;
+            }
+
+          protocol.init_mul();
+          for (int k = 0; k < n_words; k++)
+            {
+              int n = min(size - k * unit, unit);
+              bit_type x, y;
+              masks_bits[k].mask(x, n);
+              carries[k].mask(y, n);
+              protocol.prepare_mul(x, y, n);
+            }
+          protocol.exchange();
+          for (int k = 0; k < n_words; k++)
+            {
+              bit_type propagate = masks_bits[k];
+              propagate ^= carries[k];
+              carries[k] = protocol.finalize_mul(
+                  min(size - k * unit, unit));
+              carries[k] ^= propagate & GC::Clear(public_bits[k][j]);
+            }
+        }
+    }
+  else
+    {
+      (void) n_bits, (void) n_words;
+      throw runtime_error("A2B instruction only implemented for rings");
+    }
+}
+
+template<class sint, class sgf2n>
+void Processor<sint, sgf2n>::b2a(const Instruction& instruction)
+{
+  typedef typename sint::bit_type bit_type;
+  typedef typename sint::clear clear;
+  auto& regs = instruction.get_start();
+  int n_bits = regs.size();
+  int size = instruction.get_size();
+  int unit = bit_type::default_length;
+  int n_words = DIV_CEIL(size, unit);
+
+  // mask all bits with daBits and open them at once
+  vector<sint> masks(n_bits * size);
+  vector<bit_type> masked(n_bits * n_words);
+  for (int j = 0; j < n_bits; j++)
+    for (int k = 0; k < n_words; k++)
+      Procb.S[regs[j] + k].mask(masked[j * n_words + k],
+          min(size - k * unit, unit));
+  for (int j = 0; j < n_bits; j++)
+    for (int i = 0; i < size; i++)
+      {
+        bit_type tmp;
+        Procp.DataF.get_dabit(masks[j * size + i], tmp);
+        masked[j * n_words + i / unit] ^= tmp << (i % unit);
+      }
+  vector<typename bit_type::open_type> opened;
+  share_thread.MC->POpen(opened, masked, P);
+
+  vector<clear> powers(n_bits, 1);
+  for (int j = 1; j < n_bits; j++)
+    powers[j] = powers[j - 1] + powers[j - 1];
+  auto one = sint::constant(1, P.my_num(), Procp.MC.get_alphai());
+  auto dest = Procp.get_S().iterator_for_size(instruction.get_r(0), size);
+  for (int i = 0; i < size; i++)
+    {
+      sint res;
+      for (int j = 0; j < n_bits; j++)
+        {
+          auto& mask = masks[j * size + i];
+          if ((opened[j * n_words + i / unit].get() >> (i % unit)) & 1)
+            res += (one - mask) * powers[j];
+          else
+            res += mask * powers[j];
+        }
+      *dest++ = res;
+    }
+}
+
 template<class sint, class sgf2n>
 void Processor<sint, sgf2n>::convcintvec(const Instruction& instruction)
 {
@@ -367,6 +537,54 @@ void Processor<sint, sgf2n>::read_socket_vector(int client_id,
     throw runtime_error("unexpected data");
 }
 
+template<class sint, class sgf2n>
+void Processor<sint, sgf2n>::write_socket_batch(int clients, int message_type,
+    int n_clients, int n_values, const vector<int>& registers)
+{
+  auto rec_factor = sint::get_rec_factor(P.my_num(), P.num_players());
+  octetStream os;
+
+  for (int i = 0; i < n_clients; i++)
+    {
+      os.reset_write_head();
+      if (message_type != 0)
+        os.store(message_type);
+
+      // same order as write_socket
+      for (int j = 0; j < n_values; j++)
+        for (auto& reg : registers)
+          get_Sp_ref(reg + j * n_clients + i).pack(os, rec_factor);
+
+      int client_id = read_Ci(clients + i);
+      if (OnlineOptions::singleton.has_option("verbose_comm"))
+        fprintf(stderr, "Send %zu bytes to client %d\n", os.get_length(),
+            client_id);
+
+      TimeScope _(client_stats.add(os.get_length()));
+      external_clients.send_output(client_id, os);
+    }
+}
+
+template<class sint, class sgf2n>
+void Processor<sint, sgf2n>::read_socket_batch(int slots, int values,
+    int n_messages, int n_values)
+{
+  client_timer.start();
+  auto batch = external_clients.take_inputs(n_messages);
+  client_timer.stop();
+  for (int i = 0; i < n_messages; i++)
+    {
+      auto& os = batch[i].os;
+      client_stats.add(os.get_length());
+      write_Ci(slots + i, batch[i].slot);
+      for (int j = 0; j < n_values; j++)
+        get_Cp_ref(values + j * n_messages + i) =
+            os.get<typename sint::share_type::open_type>();
+      if (os.left())
+        throw runtime_error("unexpected data");
+    }
+}
+
 // Receive vector of field element shares over private channel
 template<class sint, class sgf2n>
 void Processor<sint, sgf2n>::read_socket_private(int client_id,
@@ -458,6 +676,32 @@ void SubProcessor<T>::write_shares_to_file(long start_pos,
   binary_file_io.write_to_file(filename, inpbuf, start_pos);
 }
 
+template<class T>
+void SubProcessor<T>::write_column(const string& name, int source,
+    size_t size, int bit_length, int precision)
+{
+  if (not T::real_shares(P))
+    return;
+
+  assert(source + size <= S.size());
+  ColumnFile<T>(name, P.my_num(), bit_length, precision).append(
+      &get_S_ref(source), size);
+}
+
+template<class T>
+void SubProcessor<T>::read_column(const string& name, int dest, size_t size,
+    long start, int bit_length, int precision)
+{
+  if (not T::real_shares(P))
+    return;
+
+  if (start < 0)
+    throw persistence_error("negative row in " + name);
+  assert(dest + size <= S.size());
+  ColumnFile<T>(name, P.my_num(), bit_length, precision).read(
+      &get_S_ref(dest), start, size);
+}
+
 template<class T>
 void SubProcessor<T>::maybe_check()
 {
@@ -468,7 +712,12 @@ void SubProcessor<T>::maybe_check()
 template <class T>
 void SubProcessor<T>::POpen(const Instruction& inst)
 {
-  if (inst.get_n() or BaseMachine::s().nthreads > 0)
+  // deferred to tape end or full buffer with --mac-check-buffer
+  // unless other threads could see unchecked values
+  bool check_threads = BaseMachine::s().nthreads > 0
+      and (BaseMachine::s().parallel_tapes
+          or not OnlineOptions::singleton.mac_check_buffer);
+  if (inst.get_n() or check_threads)
     check();
   auto& reg = inst.get_start();
   int size = inst.get_size();
@@ -482,7 +731,7 @@ void SubProcessor<T>::POpen(const Instruction& inst)
   for (auto it = reg.begin(); it < reg.end(); it += 2)
     for (int i = 0; i < size; i++)
       C[*it + i] = MC.finalize_open();
-  if (inst.get_n() or BaseMachine::s().nthreads > 0)
+  if (inst.get_n() or check_threads)
     check();
 
   if (Proc != 0)
@@ -496,6 +745,77 @@ void SubProcessor<T>::POpen(const Instruction& inst)
 
 template<class T>
 void SubProcessor<T>::muls(const vector<int>& reg)
+{
+    prepare_muls(reg, protocol);
+    protocol.exchange();
+    finalize_muls(reg, protocol);
+}
+
+template<class T>
+void SubProcessor<T>::mul_trunc_pr(const vector<int>& reg)
+{
+    // products straight into the destination, truncated there in one
+    // call per vector size; the truncation is local in the online phase
+    // of Astra and Trio, which makes this a single round
+    assert(reg.size() % 6 == 0);
+    vector<int> mul_args;
+    map<int, vector<int>> trunc_args;
+    for (auto it = reg.begin(); it < reg.end(); it += 6)
+    {
+        mul_args.insert(mul_args.end(), it, it + 4);
+        trunc_args[it[0]].insert(trunc_args[it[0]].end(),
+                {it[1], it[1], it[4], it[5]});
+    }
+    muls(mul_args);
+    for (auto& x : trunc_args)
+        protocol.trunc_pr(x.second, x.first, *this,
+                T::clear::characteristic_two);
+}
+
+template<class T>
+int SubProcessor<T>::init_pipeline()
+{
+    if (not T::Protocol::pipelinable)
+        return 1;
+
+    // set up before any round is in flight because of the communication
+    int window = OnlineOptions::singleton.pipeline_window;
+    while (pipeline.size() + 1 < size_t(window))
+    {
+        pipeline.push_back(new typename T::Protocol(P));
+        pipeline.back()->init(DataF, MC);
+    }
+    return window;
+}
+
+template<class T>
+typename T::Protocol& SubProcessor<T>::get_protocol(int slot)
+{
+    if (slot == 0)
+        return protocol;
+    else
+        return *pipeline.at(slot - 1);
+}
+
+template<class T>
+void SubProcessor<T>::start_muls(const vector<int>& reg, int slot)
+{
+    auto& protocol = get_protocol(slot);
+    prepare_muls(reg, protocol);
+    protocol.start_exchange();
+}
+
+template<class T>
+void SubProcessor<T>::stop_muls(const vector<int>& reg, int slot)
+{
+    auto& protocol = get_protocol(slot);
+    protocol.stop_exchange();
+    finalize_muls(reg, protocol);
+}
+
+template<class T>
+void SubProcessor<T>::prepare_muls(const vector<int>& reg,
+        typename T::Protocol& protocol)
 {
     assert(reg.size() % 4 == 0);
 
@@ -510,13 +830,20 @@ void SubProcessor<T>::muls(const vector<int>& reg)
         for (int j = 0; j < *it; j++)
             protocol.prepare_mul(*x++, *y++);
     }
-    protocol.exchange();
+}
+
+template<class T>
+void SubProcessor<T>::finalize_muls(const vector<int>& reg,
+        typename T::Protocol& protocol)
+{
+    SubProcessor<T>& proc = *this;
     for (auto it = reg.begin(); it < reg.end(); it += 4)
     {
         auto z = proc.S.begin() + *(it + 1);
         for (int j = 0; j < *it; j++)
             *z++ = protocol.finalize_mul();
-        protocol.counter += *it;
+        // counted in main instance
+        this->protocol.counter += *it;
     }
 
     maybe_check();
@@ -628,6 +955,24 @@ void SubProcessor<T>::matmuls(const StackedVector<T>& source,
 }
 
 
+template<class T>
+MemoryMatrixView<T, Integer> SubProcessor<T>::matmulsm_view(
+        const MemoryPart<T>& source, vector<int>::const_iterator args,
+        int factor)
+{
+    assert(Proc);
+    auto& Ci = Proc->get_Ci();
+    int n_rows = factor ? args[4] : args[3];
+    int n_cols = factor ? args[5] : args[4];
+    auto rows = args[6 + 2 * factor], cols = args[7 + 2 * factor];
+    if (n_rows > 0)
+        Ci.at(rows + n_rows - 1);
+    if (n_cols > 0)
+        Ci.at(cols + n_cols - 1);
+    return {source, size_t(Ci.at(args[1 + factor]).get()),
+        size_t(args[10 + factor]), &Ci.at(rows), &Ci.at(cols)};
+}
+
 template<class T>
 void SubProcessor<T>::matmulsm(const MemoryPart<T>& source,
         const vector<int>& start)
@@ -638,44 +983,26 @@ void SubProcessor<T>::matmulsm(const MemoryPart<T>& source,
     int batchStartI = 0;
     int batchStartJ = 0;
 
-    size_t sourceSize = source.size();
-    const T* sourceData = source.data();
-
     protocol.init_dotprod();
     for (auto matmulArgs = start.begin(); matmulArgs < start.end(); matmulArgs += 12) {
         auto output = S.begin() + matmulArgs[0];
-        size_t firstFactorBase  = Proc->get_Ci().at(matmulArgs[1]).get();
-        size_t secondFactorBase = Proc->get_Ci().at(matmulArgs[2]).get();
         auto resultNumberOfRows = matmulArgs[3];
         auto usedNumberOfFirstFactorColumns = matmulArgs[4];
         auto resultNumberOfColumns = matmulArgs[5];
-        auto firstFactorTotalNumberOfColumns = matmulArgs[10];
-        auto secondFactorTotalNumberOfColumns = matmulArgs[11];
 
         assert(output + resultNumberOfRows * resultNumberOfColumns <= S.end());
 
-        for (int i = 0; i < resultNumberOfRows; i += 1) {
-            auto actualFirstFactorRow = Proc->get_Ci().at(matmulArgs[6] + i).get();
+        auto firstFactor = matmulsm_view(source, matmulArgs, 0);
+        auto secondFactor = matmulsm_view(source, matmulArgs, 1);
 
+        for (int i = 0; i < resultNumberOfRows; i += 1) {
             for (int j = 0; j < resultNumberOfColumns; j += 1) {
-                auto actualSecondFactorColumn = Proc->get_Ci().at(matmulArgs[9] + j).get();
-
 #ifdef MATMULSM_DEBUG
                 cout << "Preparing " << i << "," << j << "(buffer size: " << protocol.get_buffer_size() << ")" << endl;
 #endif
 
-                for (int k = 0; k < usedNumberOfFirstFactorColumns; k += 1) {
-                    auto actualFirstFactorColumn = Proc->get_Ci().at(matmulArgs[7] + k).get();
-                    auto actualSecondFactorRow = Proc->get_Ci().at(matmulArgs[8] + k).get();
-
-                    auto firstAddress = firstFactorBase + actualFirstFactorRow * firstFactorTotalNumberOfColumns + actualFirstFactorColumn;
-                    auto secondAddress = secondFactorBase + actualSecondFactorRow * secondFactorTotalNumberOfColumns + actualSecondFactorColumn;
-
-                    assert(firstAddress < sourceSize);
-                    assert(secondAddress < sourceSize);
-
-                    protocol.prepare_dotprod(sourceData[firstAddress], sourceData[secondAddress]);
-                }
+                for (int k = 0; k < usedNumberOfFirstFactorColumns; k += 1)
+                    protocol.prepare_dotprod(firstFactor(i, k), secondFactor(k, j));
                 protocol.next_dotprod();
 
                 if (protocol.get_buffer_size() > OnlineOptions::singleton.batch_size) {
@@ -789,6 +1116,142 @@ void SubProcessor<T>::matmulsm_finalize(int i, int j, const vector<int>& dim,
     *(C + i * dim[2] + j) = protocol.finalize_dotprod(dim[1]);
 }
 
+template<class T>
+void SubProcessor<T>::cisc(const Instruction& instruction)
+{
+    int r0 = instruction.get_r(0);
+    string tag((char*) &r0, 4);
+    if (tag == string("LTZ\0", 4))
+        ltz<0>(instruction.get_start(), T::clear::characteristic_two,
+                T::clear::prime_field);
+    else
+        throw runtime_error(
+                "CISC instruction " + string(tag.c_str()) + " not implemented");
+}
+
+template<class T>
+template<int>
+void SubProcessor<T>::ltz(const vector<int>& args, false_type, false_type)
+{
+    // open c = a - r modulo 2^k for an edaBit r and add c and r in
+    // binary with bits packed as in edaBits, see Compiler/comparison.py
+    auto prep = dynamic_cast<RingPrep<T>*>(&DataF);
+    if (not prep)
+        throw runtime_error(
+                "no native comparison for " + T::type_string()
+                        + ", compile without -K LTZ");
+    auto& bit_proc = prep->get_bit_part_proc();
+    auto& bit_mac_key =
+            GC::ShareThread<typename T::bit_type>::s().MC->get_alphai();
+    int dl = BT::default_length;
+    int my_num = P.my_num();
+
+    vector<vector<edabitvec<T>>> masks;
+    vector<T> to_open;
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        assert(i + args[i] <= args.size());
+        assert(args[i] >= 5);
+        int size = args[i + 1];
+        int k = args[i + 4];
+        if (k > T::clear::N_BITS)
+            throw runtime_error(
+                    "comparison of " + to_string(k) + "-bit numbers needs "
+                            + "larger ring than " + T::clear::type_string());
+        int shift = T::clear::N_BITS - k;
+        masks.push_back({});
+        for (int j = 0; j < size; j++)
+        {
+            if (j % dl == 0)
+                masks.back().push_back(DataF.get_edabitvec(false, k));
+            auto& mask = masks.back().back();
+            assert(size_t(j % dl) < mask.size());
+            to_open.push_back((S[args[i + 3] + j] - mask.a[j % dl]) << shift);
+        }
+    }
+
+    vector<typename T::open_type> opened;
+    MC.POpen(opened, to_open, P);
+
+    // parallel prefix unless requested otherwise
+    BitAdder adder(
+            OnlineOptions::singleton.option_value("bit_adder", "prefix")
+                    == "prefix");
+    vector<T> dabits;
+    vector<BT> to_open_bits;
+    auto oit = opened.begin();
+    auto mit = masks.begin();
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        int size = args[i + 1];
+        int k = args[i + 4];
+        int shift = T::clear::N_BITS - k;
+        auto& unit_masks = *mit++;
+        size_t n_blocks = unit_masks.size();
+        vector<vector<vector<BT>>> summands(k,
+                vector<vector<BT>>(2, vector<BT>(n_blocks)));
+        for (size_t b = 0; b < n_blocks; b++)
+        {
+            vector<long> words(k);
+            for (int j = 0; j < min(dl, int(size - b * dl)); j++)
+            {
+                auto c = *oit++ >> shift;
+                for (int l = 0; l < k; l++)
+                    words[l] |= long(c.get_bit(l)) << j;
+            }
+            for (int l = 0; l < k; l++)
+            {
+                summands[l][0][b] = unit_masks[b].b[l];
+                summands[l][1][b] = BT::constant(words[l], my_num,
+                        bit_mac_key);
+            }
+        }
+
+        vector<vector<BT>> sums(n_blocks);
+        adder.add(sums, summands, bit_proc, dl);
+
+        // most significant bit to arithmetic with daBits
+        for (size_t b = 0; b < n_blocks; b++)
+        {
+            BT bits;
+            for (int j = 0; j < min(dl, int(size - b * dl)); j++)
+            {
+                T a;
+                typename T::bit_type bit;
+                DataF.get_dabit(a, bit);
+                dabits.push_back(a);
+                bits ^= BT(bit) << j;
+            }
+            to_open_bits.push_back(sums[b][k - 1] + bits);
+        }
+    }
+
+    vector<typename BT::open_type> opened_bits;
+    auto& MCB = *BT::new_mc(bit_mac_key);
+    MCB.POpen(opened_bits, to_open_bits, P);
+    vector<Integer> synced(opened_bits.begin(), opened_bits.end());
+    protocol.sync(synced, P);
+
+    auto dit = dabits.begin();
+    auto sit = synced.begin();
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        Integer masked;
+        for (int j = 0; j < args[i + 1]; j++)
+        {
+            if (j % dl == 0)
+                masked = *sit++;
+            int bit = masked.get_bit(j % dl);
+            auto& mask = *dit++;
+            S[args[i + 2] + j] = mask + T::constant(bit, my_num, MC.get_alphai())
+                    - mask * typename T::clear(bit * 2);
+        }
+    }
+
+    MCB.Check(P);
+    delete &MCB;
+}
+
 template<class T>
 void SubProcessor<T>::conv2ds(const Instruction& instruction)
 {
@@ -843,6 +1306,74 @@ Conv2dTuple::Conv2dTuple(const vector<int>& arguments, int start)
     }
 }
 
+inline
+array<int, 3> Conv2dTuple::matrix_dimensions()
+{
+    return {1, weights_h * weights_w * n_channels_in, batch_size * output_h * output_w};
+}
+
+inline
+bool Conv2dTuple::same_input(const Conv2dTuple& other) const
+{
+    return r1 == other.r1 and output_h == other.output_h
+            and output_w == other.output_w and inputs_h == other.inputs_h
+            and inputs_w == other.inputs_w and weights_h == other.weights_h
+            and weights_w == other.weights_w and stride_h == other.stride_h
+            and stride_w == other.stride_w
+            and n_channels_in == other.n_channels_in
+            and padding_h == other.padding_h and padding_w == other.padding_w
+            and batch_size == other.batch_size
+            and filter_stride_h == other.filter_stride_h
+            and filter_stride_w == other.filter_stride_w;
+}
+
+/**
+ * Arrange input patches as columns such that the convolution becomes
+ * the product of the weights (one row per filter) by the result
+ * @param columns (weights_h * weights_w * n_channels_in) times
+ * (batch_size * output_h * output_w) matrix, zero for padding
+ */
+template<class T>
+void Conv2dTuple::im2col(StackedVector<T>& S, vector<T>& columns)
+{
+    size_t n_cols = batch_size * output_h * output_w;
+    columns.clear();
+    columns.resize(weights_h * weights_w * n_channels_in * n_cols);
+    for (int i_batch = 0; i_batch < batch_size; i_batch ++)
+    {
+        size_t base = r1 + i_batch * inputs_w * inputs_h * n_channels_in;
+        assert(base + inputs_w * inputs_h * n_channels_in <= S.size());
+        T* input_base = &S[base];
+        for (int out_y = 0; out_y < output_h; out_y++)
+            for (int out_x = 0; out_x < output_w; out_x++)
+            {
+                int in_x_origin = (out_x * stride_w) - padding_w;
+                int in_y_origin = (out_y * stride_h) - padding_h;
+                size_t col = (i_batch * output_h + out_y) * output_w + out_x;
+
+                for (int filter_y = 0; filter_y < weights_h; filter_y++)
+                {
+                    int in_y = in_y_origin + filter_y * filter_stride_h;
+                    if ((0 <= in_y) and (in_y < inputs_h))
+                        for (int filter_x = 0; filter_x < weights_w; filter_x++)
+                        {
+                            int in_x = in_x_origin + filter_x * filter_stride_w;
+                            if ((0 <= in_x) and (in_x < inputs_w))
+                            {
+                                T* pixel_base = &input_base[(in_y * inputs_w
+                                        + in_x) * n_channels_in];
+                                size_t row = (filter_y * weights_w + filter_x)
+                                        * n_channels_in;
+                                for (int in_c = 0; in_c < n_channels_in; in_c++)
+                                    columns[(row + in_c) * n_cols + col] =
+                                            pixel_base[in_c];
+                            }
+                        }
+                }
+            }
+    }
+}
+
 template<class T>
 void Conv2dTuple::pre(StackedVector<T>& S, typename T::Protocol& protocol)
 {
@@ -1079,18 +1610,21 @@ void Processor<sint, sgf2n>::fixinput(const Instruction& instruction)
         }
       else
         {
-          for (int i = 0; i < instruction.get_size(); i++)
+          // one read per instruction
+          int size = instruction.get_size();
+          vector<double> buf(size);
+          if (use_double)
+            binary_input.read((char*) buf.data(), sizeof(double) * size);
+          else
             {
-              double buf;
-              if (use_double)
-                binary_input.read((char*) &buf, sizeof(double));
-              else
-                {
-                  float x;
-                  binary_input.read((char*) &x, sizeof(float));
-                  buf = x;
-                }
-              tmp = bigint::tmp = round(buf * exp2(instruction.get_r(1)));
+              vector<float> x(size);
+              binary_input.read((char*) x.data(), sizeof(float) * size);
+              copy(x.begin(), x.end(), buf.begin());
+            }
+          double factor = exp2(instruction.get_r(1));
+          for (int i = 0; i < size; i++)
+            {
+              tmp = bigint::tmp = round(buf[i] * factor);
               write_Cp(instruction.get_r(0) + i, tmp);
             }
         }
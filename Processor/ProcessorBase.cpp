@@ -6,10 +6,20 @@
 #include "ProcessorBase.hpp"
 
 ProcessorBase::ProcessorBase() :
-        input_counter(0), arg(0)
+        input_counter(0), arg(0), executed(0)
 {
 }
 
+ProcessorBase::~ProcessorBase()
+{
+    if (OnlineOptions::singleton.verbose and input_timer.elapsed())
+        cerr << "Read " << input_counter << " inputs from " << input_filename
+                << " in " << input_timer.elapsed() << " seconds ("
+                << input_counter / input_timer.elapsed() << " per second"
+                << (text_input.is_open() ? ", parallel parsing" : "") << ")"
+                << endl;
+}
+
 string ProcessorBase::get_parameterized_filename(int my_num, int thread_num, const string& prefix)
 {
     string filename = prefix + "-P" + to_string(my_num) + "-" + to_string(thread_num);
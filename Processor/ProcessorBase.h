@@ -14,7 +14,9 @@ using namespace std;
 #include "Tools/ExecutionStats.h"
 #include "Tools/SwitchableOutput.h"
 #include "OnlineOptions.h"
+#include "TextInput.h"
 #include "Math/Integer.h"
+#include "Tools/time-func.h"
 
 class ProcessorBase
 {
@@ -22,8 +24,10 @@ class ProcessorBase
   stack<Integer> stacki;
 
   ifstream input_file;
+  TextInput text_input;
   string input_filename;
   size_t input_counter;
+  Timer input_timer;
 
 protected:
   // Optional argument to tape
@@ -36,10 +40,13 @@ protected:
 
 public:
   ExecutionStats stats;
+  // number of instructions
+  size_t executed;
 
   ofstream stdout_redirect_file;
 
   ProcessorBase();
+  ~ProcessorBase();
 
   void pushi(Integer x) { stacki.push(x); }
   void popi(Integer& x) { x = stacki.top(); stacki.pop(); }
@@ -61,6 +68,8 @@ public:
   T get_input(bool interactive, const int* params);
   template<class T>
   T get_input(istream& is, const string& input_filename, const int* params);
+  template<class T>
+  T get_input(TextInput& input, const int* params);
 
   void setup_redirection(int my_nu, int thread_num, OnlineOptions& opts,
       SwitchableOutput& out, bool real = true);
@@ -20,7 +20,8 @@ void ProcessorBase::open_input_file(const string& name)
 #ifdef DEBUG_FILES
     cerr << "opening " << name << endl;
 #endif
-    input_file.open(name);
+    if (not (TextInput::n_threads() and text_input.open(name)))
+        input_file.open(name);
     input_filename = name;
 }
 
@@ -29,6 +30,10 @@ T ProcessorBase::get_input(bool interactive, const int* params)
 {
     if (interactive)
         return get_input<T>(cin, "standard input", params);
+
+    TimeScope _(input_timer);
+    if (text_input.is_open())
+        return get_input<T>(text_input, params);
     else
         return get_input<T>(input_file, input_filename, params);
 }
@@ -48,4 +53,17 @@ T ProcessorBase::get_input(istream& input_file, const string& input_filename, co
     return res;
 }
 
+template<class T>
+T ProcessorBase::get_input(TextInput& input, const int* params)
+{
+    T res;
+    if (input.eof())
+        throw IO_Error("not enough inputs in " + input_filename);
+    auto& value = input.next();
+    if (not res.read(value, params))
+        throw input_error(T::NAME, input_filename, value.str(), input_counter);
+    input_counter++;
+    return res;
+}
+
 #endif
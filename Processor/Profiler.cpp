@@ -0,0 +1,244 @@
+/*
+ * Profiler.cpp
+ *
+ */
+
+#include "Profiler.h"
+#include "Program.h"
+#include "Instruction.h"
+#include "OnlineOptions.h"
+
+#include <time.h>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+thread_local Profiler* Profiler::current = 0;
+
+Profiler::Cost& Profiler::Cost::operator+=(const Cost& other)
+{
+    calls += other.calls;
+    ns += other.ns;
+    bytes += other.bytes;
+    rounds += other.rounds;
+    return *this;
+}
+
+void Profiler::maybe_note(const char* function)
+{
+    auto profiler = current;
+    if (profiler and not profiler->stack.empty()
+            and not profiler->stack.back().location)
+    {
+        // until now, the cost belongs to the instruction itself
+        profiler->charge();
+        profiler->stack.back().location = function;
+    }
+}
+
+Profiler::Profiler(const Player& P, int thread_num) :
+        P(P), thread_num(thread_num), last(0)
+{
+    current = this;
+}
+
+Profiler::~Profiler()
+{
+    if (current == this)
+        current = 0;
+
+    string prefix = PREP_DIR "Profile-P" + to_string(P.my_num()) + "-"
+            + to_string(thread_num);
+    write(prefix + ".folded", &Cost::ns);
+    write(prefix + "-bytes.folded", &Cost::bytes);
+    print_summary();
+    print_pairs();
+    cerr << "Profile of thread " << thread_num << " stored in " << prefix
+            << ".folded (nanoseconds) and " << prefix
+            << "-bytes.folded (bytes sent)" << endl;
+}
+
+size_t Profiler::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ul + ts.tv_nsec;
+}
+
+int Profiler::get_child(int parent, FrameType type, const void* id,
+        const Instruction* instruction)
+{
+    auto res = children.insert({{parent, type, id}, int(nodes.size())});
+    if (res.second)
+        nodes.push_back({parent, type, id, instruction, {}});
+    return res.first->second;
+}
+
+void Profiler::charge()
+{
+    auto& frame = stack.back();
+    int node = frame.node;
+    if (frame.location)
+        node = get_child(node, LOCATION, frame.location);
+
+    Cost last = mark;
+    mark.ns = now();
+    tie(mark.bytes, mark.rounds) = P.total_sent_and_rounds();
+
+    auto& cost = nodes[node].cost;
+    cost.ns += mark.ns - last.ns;
+    cost.bytes += mark.bytes - last.bytes;
+    cost.rounds += mark.rounds - last.rounds;
+}
+
+void Profiler::begin(const Program& program, const Instruction& instruction)
+{
+    int parent = -1;
+    if (not stack.empty())
+    {
+        // pause the calling instruction
+        charge();
+        parent = stack.back().node;
+    }
+    else
+    {
+        mark.ns = now();
+        tie(mark.bytes, mark.rounds) = P.total_sent_and_rounds();
+
+        // instructions are stored contiguously per tape
+        if (last and &instruction == last + 1)
+        {
+            auto& count = pairs[{last->get_opcode(), instruction.get_opcode()}];
+            count.first++;
+            count.second = last;
+        }
+        last = &instruction;
+    }
+
+    int tape = get_child(parent, TAPE, &program);
+    auto line = program.get_source_location(instruction);
+    if (line)
+        tape = get_child(tape, LINE, line);
+    int node = get_child(tape, INSTRUCTION,
+            (const void*) size_t(instruction.get_opcode()), &instruction);
+    nodes[node].cost.calls++;
+    stack.push_back({node, 0});
+}
+
+void Profiler::end()
+{
+    charge();
+    stack.pop_back();
+}
+
+string Profiler::get_label(const Node& node) const
+{
+    string res;
+    switch (node.type)
+    {
+    case TAPE:
+        res = ((const Program*) node.id)->get_name();
+        break;
+    case INSTRUCTION:
+        res = node.instruction->get_name();
+        break;
+    case LINE:
+    case LOCATION:
+        res = (const char*) node.id;
+        break;
+    }
+
+    // frame separator in folded format
+    replace(res.begin(), res.end(), ';', ',');
+    return res;
+}
+
+string Profiler::get_path(int node) const
+{
+    string res = get_label(nodes[node]);
+    for (int i = nodes[node].parent; i >= 0; i = nodes[i].parent)
+        res = get_label(nodes[i]) + ";" + res;
+    return res;
+}
+
+void Profiler::write(const string& filename, size_t Cost::* value) const
+{
+    ofstream out(filename);
+    for (size_t i = 0; i < nodes.size(); i++)
+        if (nodes[i].cost.*value)
+            out << get_path(i) << " " << nodes[i].cost.*value << endl;
+    if (not out.good())
+        cerr << "Cannot write profile to " << filename << endl;
+}
+
+void Profiler::print_summary() const
+{
+    map<string, Cost> instructions, locations, lines;
+    for (auto& node : nodes)
+        if (node.type == INSTRUCTION)
+            instructions[get_label(node)] += node.cost;
+        else if (node.type == LOCATION)
+        {
+            locations[get_label(node)] += node.cost;
+            instructions[get_label(nodes[node.parent])] += node.cost;
+        }
+
+    // innermost source line including called tapes
+    for (auto& node : nodes)
+        for (int i = node.parent; i >= 0; i = nodes[i].parent)
+            if (nodes[i].type == LINE)
+            {
+                lines[get_label(nodes[i])] += node.cost;
+                break;
+            }
+
+    size_t n_top = stoul(
+            OnlineOptions::singleton.option_value("profile_top", "10"));
+
+    for (auto x : {make_tuple("Instruction", &instructions, &Cost::ns),
+            make_tuple("Protocol function", &locations, &Cost::ns),
+            make_tuple("Source line", &lines, &Cost::bytes)})
+    {
+        auto& costs = *get<1>(x);
+        if (costs.empty())
+            continue;
+
+        // time for instructions, communication for source lines
+        vector<tuple<size_t, size_t, string>> sorted;
+        for (auto& y : costs)
+            sorted.push_back({y.second.*get<2>(x), y.second.rounds, y.first});
+        sort(sorted.rbegin(), sorted.rend());
+        if (sorted.size() > n_top)
+            sorted.resize(n_top);
+
+        cerr << get<0>(x) << " profile of thread " << thread_num << ":" << endl;
+        for (auto& y : sorted)
+        {
+            auto& cost = costs.at(get<2>(y));
+            cerr << "\t" << get<2>(y) << ": " << cost.ns * 1e-9 << " seconds, "
+                    << cost.bytes * 1e-6 << " MB, " << cost.rounds
+                    << " rounds";
+            if (cost.calls)
+                cerr << ", " << cost.calls << " calls";
+            cerr << endl;
+        }
+    }
+}
+
+void Profiler::print_pairs() const
+{
+    vector<pair<size_t, const Instruction*>> sorted;
+    for (auto& x : pairs)
+        sorted.push_back(x.second);
+    sort(sorted.rbegin(), sorted.rend());
+    size_t n_top = stoul(
+            OnlineOptions::singleton.option_value("profile_top", "10"));
+    if (sorted.size() > n_top)
+        sorted.resize(n_top);
+
+    cerr << "Consecutive instructions in thread " << thread_num << ":" << endl;
+    for (auto& x : sorted)
+        cerr << "\t" << x.second->get_name() << ", "
+                << (x.second + 1)->get_name() << ": " << x.first << " times"
+                << endl;
+}
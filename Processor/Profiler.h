@@ -0,0 +1,104 @@
+/*
+ * Profiler.h
+ *
+ */
+
+#ifndef PROCESSOR_PROFILER_H_
+#define PROCESSOR_PROFILER_H_
+
+#include "Networking/Player.h"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <tuple>
+using namespace std;
+
+class Program;
+class Instruction;
+
+/**
+ * Wall time, communication, and rounds per instruction, activated
+ * by ``--profile``. Costs are attributed to the stack of tapes and
+ * instructions as well as the first protocol function reached (see
+ * :cpp:class:`CodeLocations`), and they are stored in the folded
+ * format of FlameGraph per thread. Programs compiled with
+ * ``--source-locations`` add the high-level source line of every
+ * instruction, and the summary lists the lines with the most
+ * communication. The most frequent pairs of
+ * consecutive instructions are reported as candidates for
+ * ``FUSED_INSTRUCTIONS``.
+ */
+class Profiler
+{
+    enum FrameType
+    {
+        TAPE,
+        LINE,
+        INSTRUCTION,
+        LOCATION,
+    };
+
+    struct Cost
+    {
+        size_t calls, ns, bytes, rounds;
+
+        Cost() : calls(0), ns(0), bytes(0), rounds(0) {}
+        Cost& operator+=(const Cost& other);
+    };
+
+    struct Node
+    {
+        int parent;
+        FrameType type;
+        const void* id;
+        const Instruction* instruction;
+        Cost cost;
+    };
+
+    // an instruction in progress
+    struct Frame
+    {
+        int node;
+        const char* location;
+    };
+
+    static thread_local Profiler* current;
+
+    const Player& P;
+    int thread_num;
+
+    vector<Node> nodes;
+    map<tuple<int, FrameType, const void*>, int> children;
+    vector<Frame> stack;
+
+    Cost mark;
+
+    // adjacent top-level instructions as candidates for fusion
+    const Instruction* last;
+    map<pair<int, int>, pair<size_t, const Instruction*>> pairs;
+
+    static size_t now();
+
+    int get_child(int parent, FrameType type, const void* id,
+            const Instruction* instruction = 0);
+    void charge();
+
+    string get_label(const Node& node) const;
+    string get_path(int node) const;
+    void write(const string& filename, size_t Cost::* value) const;
+    void print_summary() const;
+    void print_pairs() const;
+
+public:
+    /// Associate protocol function with current instruction
+    static void maybe_note(const char* function);
+
+    Profiler(const Player& P, int thread_num);
+    ~Profiler();
+
+    void begin(const Program& program, const Instruction& instruction);
+    void end();
+};
+
+#endif /* PROCESSOR_PROFILER_H_ */
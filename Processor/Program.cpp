@@ -3,6 +3,13 @@
 #include "Processor/Data_Files.h"
 #include "Processor/Processor.h"
 
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <fstream>
+#include <algorithm>
+
 #include "Processor/Instruction.hpp"
 
 void Program::compute_constants()
@@ -52,9 +59,21 @@ void Program::parse(string filename)
 void Program::parse_with_error(string filename)
 {
   name = boost::filesystem::path(filename).stem().string();
-  ifstream pinp(filename);
-  if (pinp.fail())
+
+  // parsing from memory avoids a system call per instruction,
+  // and the pages are shared between processes on the same host
+  boost::iostreams::mapped_file_source file;
+  try
+  {
+    if (boost::filesystem::file_size(filename) > 0)
+      file.open(filename);
+  }
+  catch (exception&)
+  {
     throw file_error(filename);
+  }
+  boost::iostreams::stream<boost::iostreams::array_source> pinp(file.data(),
+      file.size());
 
   try
   {
@@ -72,22 +91,53 @@ void Program::parse_with_error(string filename)
     throw bytecode_error(os.str());
   }
 
-  // compute hash
-  pinp.clear();
-  pinp.seekg(0);
   Hash hasher;
-  while (pinp.peek(), !pinp.eof())
+  hasher.update(file.data(), file.size());
+  hash = hasher.final().str();
+
+  if (OnlineOptions::singleton.profile)
+    read_source_locations(filename.substr(0, filename.rfind(".")) + ".loc");
+}
+
+void Program::read_source_locations(const string& filename)
+{
+  source_locations.clear();
+  ifstream file(filename);
+  size_t start;
+  string location;
+  while (file >> start)
     {
-      char buf[1024];
-      size_t n = pinp.readsome(buf, 1024);
-      hasher.update(buf, n);
+      file.get();
+      getline(file, location);
+      if (start >= p.size())
+        {
+          cerr << "Ignoring outdated source locations in " << filename
+              << endl;
+          source_locations.clear();
+          return;
+        }
+      source_locations.push_back({start, location});
     }
-  hash = hasher.final().str();
+}
+
+const char* Program::get_source_location(const Instruction& instruction) const
+{
+  if (source_locations.empty() or p.empty())
+    return 0;
+  size_t pc = &instruction - p.data();
+  if (pc >= p.size())
+    return 0;
+  auto it = upper_bound(source_locations.begin(), source_locations.end(), pc,
+      [](size_t pc, const pair<size_t, string>& x) { return pc < x.first; });
+  if (it == source_locations.begin() or (it - 1)->second.empty())
+    return 0;
+  return (it - 1)->second.c_str();
 }
 
 void Program::parse(istream& s)
 {
   p.resize(0);
+  handlers.resize(0);
   Instruction instr;
   s.peek();
   while (!s.eof())
@@ -115,11 +165,289 @@ void Program::parse(istream& s)
           throw bytecode_error(os.str());
         }
 
-      p.push_back(instr);
+      handlers.push_back(get_handler(instr.opcode));
+      // no copy of the argument vector
+      p.push_back(move(instr));
       //cerr << "\t" << instr << endl;
       s.peek();
     }
+  if (not OnlineOptions::singleton.has_option("no_fusion"))
+    fuse();
   compute_constants();
+  // after computing the usage to avoid counting twice
+  if (not OnlineOptions::singleton.has_option("no_round_merging"))
+    merge_rounds();
+  if (not OnlineOptions::singleton.has_option("no_overlap"))
+    find_overlaps();
+}
+
+int Program::get_handler(int opcode)
+{
+  switch (opcode)
+    {
+#define X(NAME, PRE, CODE) case NAME: return NAME##_HANDLER;
+      ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) case NAME: return NAME##_HANDLER;
+      CONTROL_INSTRUCTIONS
+      COMBI_INSTRUCTIONS
+#undef X
+#define X(NAME, PRE, CODE) case NAME:
+      CLEAR_GF2N_INSTRUCTIONS
+      return CLEAR_GF2N_HANDLER;
+      REGINT_INSTRUCTIONS
+      return REGINT_HANDLER;
+#undef X
+    default:
+      return OTHER_HANDLER;
+    }
+}
+
+bool Program::fusable(const Instruction& first, const Instruction& second,
+    int n_first, int n_second)
+{
+  if (first.size != second.size)
+    return false;
+
+  // element-wise is only equivalent to one after the other
+  // if registers are the same or disjoint
+  int size = first.size;
+  for (int i = 0; i < n_first; i++)
+    for (int j = 0; j < n_second; j++)
+      {
+        int a = first.r[i], b = second.r[j];
+        if (a != b and a < b + size and b < a + size)
+          return false;
+      }
+
+  return true;
+}
+
+void Program::fuse()
+{
+  // a jump to the second instruction still finds its own handler
+  for (size_t i = 0; i + 1 < p.size(); i++)
+    {
+      auto& first = p[i];
+      auto& second = p[i + 1];
+#define X(FIRST, SECOND, N_FIRST, N_SECOND, PRE, CODE) \
+      if (first.opcode == FIRST and second.opcode == SECOND \
+          and fusable(first, second, N_FIRST, N_SECOND)) \
+        handlers[i] = FIRST##_##SECOND##_HANDLER;
+      FUSED_INSTRUCTIONS
+#undef X
+    }
+}
+
+bool Program::get_ranges(const Instruction& instruction,
+    vector<array<int, 2>>& inputs, vector<array<int, 2>>& outputs)
+{
+  auto& args = instruction.start;
+  int size = instruction.size;
+  switch (instruction.opcode)
+    {
+    case MULS:
+      if (args.size() % 4 != 0)
+        return false;
+      for (size_t i = 0; i < args.size(); i += 4)
+        {
+          outputs.push_back({{args[i + 1], args[i]}});
+          inputs.push_back({{args[i + 2], args[i]}});
+          inputs.push_back({{args[i + 3], args[i]}});
+        }
+      return true;
+    case DOTPRODS:
+      for (size_t i = 0; i < args.size(); i += args[i])
+        {
+          if (args[i] < 2 or i + args[i] > args.size())
+            return false;
+          outputs.push_back({{args[i + 1], size}});
+          for (int j = 2; j < args[i]; j++)
+            inputs.push_back({{args[i + j], size}});
+        }
+      return true;
+    case MULTRUNCPRS:
+      if (args.size() % 6 != 0)
+        return false;
+      for (size_t i = 0; i < args.size(); i += 6)
+        {
+          outputs.push_back({{args[i + 1], args[i]}});
+          inputs.push_back({{args[i + 2], args[i]}});
+          inputs.push_back({{args[i + 3], args[i]}});
+        }
+      return true;
+    case TRUNC_PR:
+      if (args.size() % 4 != 0)
+        return false;
+      for (size_t i = 0; i < args.size(); i += 4)
+        {
+          outputs.push_back({{args[i], size}});
+          inputs.push_back({{args[i + 1], size}});
+        }
+      return true;
+    default:
+      return false;
+    }
+}
+
+void Program::merge_rounds()
+{
+  // Consecutive instructions are always executed together when
+  // starting with the first, so the first can do the communication
+  // for all and skip the others.
+  // A jump to any other one still finds the original.
+  for (size_t i = 0; i < p.size(); i++)
+    {
+      auto& first = p[i];
+      vector<array<int, 2>> inputs, outputs;
+      if (not get_ranges(first, inputs, outputs))
+        continue;
+
+      vector<int> merged = first.start;
+      size_t j;
+      for (j = i + 1; j < p.size(); j++)
+        {
+          auto& next = p[j];
+          if (next.opcode != first.opcode or next.size != first.size)
+            break;
+
+          // inputs of the next may not depend on outputs so far
+          vector<array<int, 2>> next_inputs, next_outputs;
+          if (not get_ranges(next, next_inputs, next_outputs))
+            break;
+          bool independent = true;
+          for (auto& x : next_inputs)
+            for (auto& y : outputs)
+              if (x[0] < y[0] + y[1] and y[0] < x[0] + x[1])
+                independent = false;
+          if (not independent)
+            break;
+
+          outputs.insert(outputs.end(), next_outputs.begin(),
+              next_outputs.end());
+          merged.insert(merged.end(), next.start.begin(), next.start.end());
+        }
+
+      if (j > i + 1)
+        {
+          first.start = merged;
+          first.n_merged = j - i - 1;
+        }
+      i = j - 1;
+    }
+}
+
+bool Program::get_local_ranges(const Instruction& instruction,
+    vector<array<int, 2>>& ranges)
+{
+  auto& r = instruction.r;
+  int size = instruction.size;
+  switch (instruction.opcode)
+    {
+    // clear registers only
+    case LDI:
+    case ADDC:
+    case ADDCI:
+    case SUBC:
+    case SUBCI:
+    case SUBCFI:
+    case MULC:
+    case MULCI:
+    case ANDC:
+    case XORC:
+    case ORC:
+    case ANDCI:
+    case XORCI:
+    case ORCI:
+    case SHLC:
+    case SHRC:
+    case SHLCI:
+    case SHRCI:
+      return true;
+    case LDSI:
+    case LDMS:
+    case STMS:
+      ranges.push_back({{r[0], size}});
+      return true;
+    case MOVS:
+    case ADDM:
+    case ADDSI:
+    case SUBSI:
+    case SUBSFI:
+    case SUBML:
+    case MULM:
+    case MULSI:
+      ranges.push_back({{r[0], size}});
+      ranges.push_back({{r[1], size}});
+      return true;
+    case SUBMR:
+      ranges.push_back({{r[0], size}});
+      ranges.push_back({{r[2], size}});
+      return true;
+    case ADDS:
+    case SUBS:
+      for (int i = 0; i < 3; i++)
+        ranges.push_back({{r[i], size}});
+      return true;
+    default:
+      return false;
+    }
+}
+
+void Program::find_overlaps()
+{
+  // Local instructions following a multiplication that do not touch
+  // its results can run between starting and finishing the
+  // communication. With a pipeline window, this includes further
+  // multiplications whose inputs are not pending.
+  // They are skipped afterwards, but a jump to any of them
+  // still finds the original.
+  auto independent = [](const vector<array<int, 2>>& ranges,
+      const vector<array<int, 2>>& outputs)
+    {
+      for (auto& x : ranges)
+        for (auto& y : outputs)
+          if (x[0] < y[0] + y[1] and y[0] < x[0] + x[1])
+            return false;
+      return true;
+    };
+
+  int window = OnlineOptions::singleton.pipeline_window;
+  overlaps.clear();
+  overlaps.resize(p.size());
+  for (size_t i = 0; i < p.size(); i++)
+    {
+      auto& first = p[i];
+      vector<array<int, 2>> inputs, outputs;
+      if (first.opcode != MULS or not get_ranges(first, inputs, outputs))
+        continue;
+
+      size_t begin = i + 1 + first.n, j = begin;
+      int in_flight = 1;
+      while (j < p.size())
+        {
+          vector<array<int, 2>> ranges, next_outputs;
+          if (get_local_ranges(p[j], ranges))
+            {
+              if (not independent(ranges, outputs))
+                break;
+              j++;
+            }
+          else if (p[j].opcode == MULS and in_flight < window
+              and get_ranges(p[j], ranges, next_outputs)
+              and independent(ranges, outputs))
+            {
+              outputs.insert(outputs.end(), next_outputs.begin(),
+                  next_outputs.end());
+              in_flight++;
+              j += 1 + p[j].n;
+            }
+          else
+            break;
+        }
+
+      overlaps[i] = j - begin;
+    }
 }
 
 void Program::print_offline_cost() const
@@ -4,6 +4,8 @@
 #include "Processor/Instruction.h"
 #include "Processor/Data_Files.h"
 
+#include <array>
+
 template<class sint, class sgf2n> class Machine;
 
 /* A program is a vector of instructions */
@@ -11,6 +13,10 @@ template<class sint, class sgf2n> class Machine;
 class Program
 {
   vector<Instruction> p;
+  // pre-decoded for threaded dispatch, see InstructionHandler
+  vector<int> handlers;
+  // local instructions after multiplications, see find_overlaps()
+  vector<int> overlaps;
   // Here we note the number of bits, squares and triples and input
   // data needed
   //  - This is computed for a whole program sequence to enable
@@ -30,7 +36,24 @@ class Program
 
   string name;
 
+  // first instruction and high-level source line, see --source-locations
+  vector<pair<size_t, string>> source_locations;
+
   void compute_constants();
+  void read_source_locations(const string& filename);
+
+  static int get_handler(int opcode);
+  static bool fusable(const Instruction& first, const Instruction& second,
+      int n_first, int n_second);
+  void fuse();
+
+  static bool get_ranges(const Instruction& instruction,
+      vector<array<int, 2>>& inputs, vector<array<int, 2>>& outputs);
+  void merge_rounds();
+
+  static bool get_local_ranges(const Instruction& instruction,
+      vector<array<int, 2>>& ranges);
+  void find_overlaps();
 
   public:
 
@@ -61,6 +84,16 @@ class Program
   const string& get_hash() const
     { return hash; }
 
+  const string& get_name() const
+    { return name; }
+
+  // source line of instruction if compiled with --source-locations
+  const char* get_source_location(const Instruction& instruction) const;
+
+  // number of instructions to run while instruction at pc communicates
+  int get_overlap(size_t pc) const
+    { return overlaps.empty() ? 0 : overlaps[pc]; }
+
   friend ostream& operator<<(ostream& s,const Program& P);
 
   // Execute this program, updateing the processor and memory
@@ -71,6 +104,19 @@ class Program
   template<class sint, class sgf2n>
   void execute_with_errors(Processor<sint, sgf2n>& Proc) const;
 
+  template<class sint, class sgf2n>
+  void execute_threaded(Processor<sint, sgf2n>& Proc) const;
+
+  // run local instructions without changing the program counter
+  template<class sint, class sgf2n>
+  void execute_local(Processor<sint, sgf2n>& Proc, size_t begin,
+      size_t end) const;
+
+  // run multiplication with following instructions, see find_overlaps()
+  template<class sint, class sgf2n>
+  void execute_overlap(Processor<sint, sgf2n>& Proc, const vector<int>& muls,
+      size_t begin, size_t end) const;
+
   template<class T>
   void mulm_check() const;
 };
@@ -0,0 +1,167 @@
+/*
+ * TextInput.cpp
+ *
+ */
+
+#include "TextInput.h"
+#include "OnlineOptions.h"
+#include "Tools/int.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+int TextInput::n_threads()
+{
+    auto& opts = OnlineOptions::singleton;
+    if (opts.has_option("parallel_input"))
+        return max(1u, thread::hardware_concurrency());
+    return stoi(opts.option_value("parallel_input", "0"));
+}
+
+TextInput::TextInput() :
+        mapped(0), mapped_size(0), pos(0), block_pos(0)
+{
+}
+
+TextInput::~TextInput()
+{
+    close();
+}
+
+bool TextInput::open(const string& filename)
+{
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat buf;
+    if (fstat(fd, &buf) == 0 and S_ISREG(buf.st_mode) and buf.st_size > 0)
+    {
+        void* res = mmap(0, buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (res != MAP_FAILED)
+        {
+            madvise(res, buf.st_size, MADV_SEQUENTIAL);
+            mapped = (const char*) res;
+            mapped_size = buf.st_size;
+        }
+    }
+
+    // the mapping stays valid
+    ::close(fd);
+    return mapped;
+}
+
+void TextInput::close()
+{
+    if (mapped)
+        munmap((void*) mapped, mapped_size);
+    mapped = 0;
+    mapped_size = 0;
+    pos = 0;
+    block.clear();
+    block_pos = 0;
+}
+
+bool TextInput::eof()
+{
+    while (block_pos == block.size() and pos < mapped_size)
+        parse_block();
+    return block_pos == block.size();
+}
+
+const TextInput::Value& TextInput::next()
+{
+    eof();
+    return block.at(block_pos++);
+}
+
+void TextInput::parse_block()
+{
+    // split at whitespace
+    auto split = [this](size_t offset)
+    {
+        offset = min(offset, mapped_size);
+        while (offset < mapped_size and not isspace(mapped[offset]))
+            offset++;
+        return offset;
+    };
+
+    size_t end = split(pos + BLOCK_SIZE);
+    int n_parts = min(max(n_threads(), 1), int(DIV_CEIL(end - pos, 1 << 16)));
+    vector<vector<Value>> parts(n_parts);
+    vector<thread> threads;
+    size_t start = pos;
+    for (int i = 0; i < n_parts; i++)
+    {
+        size_t stop = i == n_parts - 1 ? end :
+                split(pos + (end - pos) * (i + 1) / n_parts);
+        stop = max(stop, start);
+        if (i == n_parts - 1)
+            parse(mapped + start, mapped + stop, parts[i]);
+        else
+            threads.push_back(
+                    thread(parse, mapped + start, mapped + stop,
+                            ref(parts[i])));
+        start = stop;
+    }
+    for (auto& t : threads)
+        t.join();
+
+    block.clear();
+    block_pos = 0;
+    for (auto& part : parts)
+        block.insert(block.end(), part.begin(), part.end());
+    pos = end;
+}
+
+void TextInput::parse(const char* begin, const char* end,
+        vector<Value>& values)
+{
+    auto p = begin;
+    while (true)
+    {
+        while (p < end and isspace(*p))
+            p++;
+        if (p == end)
+            break;
+
+        Value value;
+        value.begin = p;
+        while (p < end and not isspace(*p))
+            p++;
+        value.length = p - value.begin;
+
+        auto token_end = value.begin + value.length;
+        auto res = from_chars(value.begin, token_end, value.integer);
+        value.is_integer = res.ec == errc() and res.ptr == token_end;
+        if (value.is_integer)
+        {
+            value.real = value.integer;
+            value.is_real = true;
+        }
+        else
+        {
+            // from_chars doesn't accept a leading plus
+            auto real_begin = value.begin + (*value.begin == '+');
+#ifdef __cpp_lib_to_chars
+            auto res = from_chars(real_begin, token_end, value.real);
+            value.is_real = res.ec == errc() and res.ptr == token_end;
+#else
+            // no floating-point from_chars in older libraries
+            string token(real_begin, token_end);
+            char* real_end;
+            value.real = strtod(token.c_str(), &real_end);
+            value.is_real = real_end == token.c_str() + token.size();
+#endif
+        }
+
+        values.push_back(value);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * TextInput.h
+ *
+ */
+
+#ifndef PROCESSOR_TEXTINPUT_H_
+#define PROCESSOR_TEXTINPUT_H_
+
+#include <string>
+#include <vector>
+#include <type_traits>
+using namespace std;
+
+/**
+ * Text input file parsed ahead of use by several threads.
+ * The file is mapped into memory and converted in blocks with
+ * ``from_chars``, which avoids the per-value cost of ``istream``.
+ */
+class TextInput
+{
+public:
+    struct Value
+    {
+        const char* begin;
+        size_t length;
+        long integer;
+        double real;
+        // whether the whole token is a 64-bit integer or a real number
+        bool is_integer, is_real;
+
+        string str() const { return string(begin, length); }
+    };
+
+    /// Whether to parse decimal integers directly
+    template<class T>
+    static constexpr bool decimal();
+
+    /// Number of threads from ``-o parallel_input[=<n>]``, zero if off
+    static int n_threads();
+
+private:
+    // bytes per block
+    static const size_t BLOCK_SIZE = 1 << 24;
+
+    const char* mapped;
+    size_t mapped_size;
+    size_t pos;
+
+    vector<Value> block;
+    size_t block_pos;
+
+    void parse_block();
+
+    static void parse(const char* begin, const char* end,
+            vector<Value>& values);
+
+public:
+    TextInput();
+    TextInput(const TextInput&) = delete;
+    ~TextInput();
+
+    /// Returns false if the file cannot be mapped
+    bool open(const string& filename);
+    void close();
+
+    bool is_open() const { return mapped; }
+
+    bool eof();
+    const Value& next();
+};
+
+template<class T, class = void>
+struct has_characteristic_two : false_type
+{
+};
+
+template<class T>
+struct has_characteristic_two<T, decltype(void(T::characteristic_two))> :
+        decay_t<decltype(T::characteristic_two)>
+{
+};
+
+template<class T>
+constexpr bool TextInput::decimal()
+{
+    // characteristic-two fields use hexadecimal
+    return not has_characteristic_two<T>::value;
+}
+
+#endif /* PROCESSOR_TEXTINPUT_H_ */
@@ -18,6 +18,7 @@ enum ThreadJobType
     EDABIT_JOB,
     PERSONAL_JOB,
     SANITIZE_JOB,
+    SANITIZE_VEC_JOB,
     EDABIT_SACRIFICE_JOB,
     PERSONAL_TRIPLE_JOB,
     TRIPLE_SACRIFICE_JOB,
@@ -129,6 +130,17 @@ public:
     }
 };
 
+class SanitizeVecJob : public ThreadJob
+{
+public:
+    SanitizeVecJob(void* edabits, int n_bits)
+    {
+        type = SANITIZE_VEC_JOB;
+        output = edabits;
+        length = n_bits;
+    }
+};
+
 class EdabitSacrificeJob : public ThreadJob
 {
 public:
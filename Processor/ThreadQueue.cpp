@@ -5,17 +5,17 @@
 
 
 #include "ThreadQueue.h"
+#include "Trace.h"
 
 thread_local ThreadQueue* ThreadQueue::thread_queue = 0;
 
 void ThreadQueue::schedule(const ThreadJob& job)
 {
-    lock.lock();
     left++;
 #ifdef DEBUG_THREAD_QUEUE
         cerr << this << ": " << left << " left" << endl;
 #endif
-    lock.unlock();
+    Trace::Span span("Waiting for thread", Trace::WAIT);
     if (thread_queue)
         thread_queue->wait_timer.start();
     in.push(job);
@@ -50,17 +50,16 @@ void ThreadQueue::set_comm_stats(const NamedCommStats& new_comm_stats)
 
 ThreadJob ThreadQueue::result()
 {
+    Trace::Span span("Waiting for thread", Trace::WAIT);
     if (thread_queue)
         thread_queue->wait_timer.start();
     auto res = out.pop();
     if (thread_queue)
         thread_queue->wait_timer.stop();
-    lock.lock();
     left--;
 #ifdef DEBUG_THREAD_QUEUE
         cerr << this << ": " << left << " left" << endl;
 #endif
-    lock.unlock();
     return res;
 }
 
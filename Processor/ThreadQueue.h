@@ -8,12 +8,14 @@
 
 #include "ThreadJob.h"
 #include "Tools/NamedStats.h"
+#include "Tools/SpinWaitQueue.h"
+#include "Tools/MemoryAccounting.h"
 
 class ThreadQueue
 {
-    WaitQueue<ThreadJob> in, out;
+    SpinWaitQueue<ThreadJob> in, out;
     Lock lock;
-    int left;
+    atomic<int> left;
     NamedCommStats comm_stats;
 
 public:
@@ -23,8 +25,15 @@ public:
     Timer wait_timer;
     NamedStats stats;
 
+    // helper jobs distributed by another thread (see ThreadQueues)
+    Timer helper_timer, stall_timer;
+    int n_helper_jobs;
+
+    // allocation in the thread, set when it finishes
+    MemoryAccounting::Counters memory = {};
+
     ThreadQueue() :
-            left(0)
+            left(0), n_helper_jobs(0)
     {
     }
 
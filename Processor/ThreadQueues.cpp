@@ -67,7 +67,10 @@ int ThreadQueues::distribute_no_setup(ThreadJob job, int n_items, int base,
             job.supply = supplies->at(i);
         job.begin = base + i * n_per_thread;
         job.end = base + (i + 1) * n_per_thread;
-        at(available[i])->schedule(job);
+        auto queue = at(available[i]);
+        queue->schedule(job);
+        queue->helper_timer.start();
+        queue->n_helper_jobs++;
     }
     return base + available.size() * n_per_thread;
 }
@@ -79,7 +82,12 @@ void ThreadQueues::wrap_up(ThreadJob job)
 #endif
     for (int i : available)
     {
-        auto result = at(i)->result();
+        // the distributing thread has finished its own part by now
+        auto queue = at(i);
+        queue->stall_timer.start();
+        auto result = queue->result();
+        queue->stall_timer.stop();
+        queue->helper_timer.stop();
         assert(result.output == job.output);
         assert(result.type == job.type);
     }
@@ -116,7 +124,64 @@ void ThreadQueues::print_breakdown()
         if (sum("random").elapsed())
             cerr << "Spent " << sum("random").full()
                     << " on correlated randomness generation." << endl;
+
+        // imbalance of distributed jobs
+        for (size_t i = 1; i < size(); i++)
+        {
+            auto queue = at(i);
+            if (queue->n_helper_jobs)
+                cerr << "Thread " << i << " ran " << queue->n_helper_jobs
+                        << " helper jobs in " << queue->helper_timer.elapsed()
+                        << " seconds, idling for "
+                        << queue->timers["wait"].elapsed()
+                        << " seconds in total. The distributing thread waited "
+                        << queue->stall_timer.elapsed()
+                        << " seconds for it." << endl;
+        }
+
+        for (size_t i = 0; i < size(); i++)
+        {
+            auto& memory = at(i)->memory;
+            if (not memory.empty())
+            {
+                cerr << "Thread " << i << " peak memory: ";
+                memory.print(cerr);
+                cerr << endl;
+            }
+        }
+    }
+}
+
+void ThreadQueues::print_json(ostream& os)
+{
+    os << "[";
+    for (size_t i = 0; i < size(); i++)
+    {
+        auto queue = at(i);
+        if (i)
+            os << ", ";
+        os << "{\"thread\": " << i << ", \"phases\": {";
+        bool first = true;
+        for (auto& timer : queue->timers)
+        {
+            if (not first)
+                os << ", ";
+            first = false;
+            os << "\"" << timer.first << "\": ";
+            timer.second.print_json(os);
+        }
+        os << "}, \"communication\": ";
+        queue->get_comm_stats().print_json(os);
+        os << ", \"costs\": ";
+        queue->stats.print_json(os);
+        os << ", \"helper_jobs\": " << queue->n_helper_jobs
+                << ", \"helper_seconds\": " << queue->helper_timer.elapsed()
+                << ", \"stall_seconds\": " << queue->stall_timer.elapsed()
+                << ", \"memory\": ";
+        queue->memory.print_json(os);
+        os << "}";
     }
+    os << "]";
 }
 
 NamedCommStats ThreadQueues::total_comm()
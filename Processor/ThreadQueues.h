@@ -28,6 +28,7 @@ public:
     TimerWithComm sum(const string& phase);
 
     void print_breakdown();
+    void print_json(ostream& os);
 
     NamedCommStats total_comm();
     NamedCommStats max_comm();
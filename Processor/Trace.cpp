@@ -0,0 +1,128 @@
+/*
+ * Trace.cpp
+ *
+ */
+
+#include "Trace.h"
+#include "BaseMachine.h"
+#include "OnlineOptions.h"
+#include "Instruction.h"
+#include "Tools/Exceptions.h"
+
+#include <fstream>
+#include <algorithm>
+
+Trace* Trace::singleton = 0;
+thread_local Trace::Buffer* Trace::buffer = 0;
+
+Trace::Buffer::Buffer(int thread_num, size_t size) :
+        thread_num(thread_num), events(size), n_events(0)
+{
+}
+
+void Trace::start(int my_num)
+{
+    auto& opts = OnlineOptions::singleton;
+    if (singleton or not (opts.has_option("trace")
+            or not opts.option_value("trace").empty()))
+        return;
+    singleton = new Trace(my_num,
+            opts.option_value("trace", PREP_DIR "Trace"),
+            stoul(opts.option_value("trace_events", "65536")));
+}
+
+Trace::Trace(int my_num, const string& prefix, size_t buffer_size) :
+        my_num(my_num), filename(prefix + "-P" + to_string(my_num) + ".json"),
+        buffer_size(max(buffer_size, size_t(1)))
+{
+    pthread_mutex_init(&mutex, 0);
+}
+
+Trace::Buffer* Trace::new_buffer()
+{
+    pthread_mutex_lock(&mutex);
+    buffers.push_back(make_unique<Buffer>(BaseMachine::thread_num,
+            buffer_size));
+    auto res = buffers.back().get();
+    pthread_mutex_unlock(&mutex);
+    return res;
+}
+
+void Trace::record(const void* id, Category category, long long begin)
+{
+    if (not singleton)
+        return;
+    if (not buffer)
+        buffer = singleton->new_buffer();
+    auto& events = buffer->events;
+    // overwrite the oldest when full
+    events[buffer->n_events++ % events.size()] = {begin, now(), id, category};
+}
+
+void Trace::InstructionGroup::next(const Instruction& instruction)
+{
+    if (first and first->get_opcode() == instruction.get_opcode())
+        return;
+    close();
+    first = &instruction;
+    begin = now();
+}
+
+void Trace::InstructionGroup::close()
+{
+    if (first)
+        record(first, INSTRUCTION, begin);
+    first = 0;
+}
+
+void Trace::write()
+{
+    auto trace = singleton;
+    if (not trace)
+        return;
+
+    const char* categories[] = {"tape", "instruction", "communication",
+            "check", "preprocessing", "wait"};
+
+    ofstream out(trace->filename);
+    out << "{\"traceEvents\": [" << endl;
+    out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": "
+            << trace->my_num << ", \"args\": {\"name\": \"Party "
+            << trace->my_num << "\"}}";
+
+    pthread_mutex_lock(&trace->mutex);
+    for (size_t tid = 0; tid < trace->buffers.size(); tid++)
+    {
+        auto& buffer = *trace->buffers[tid];
+        out << "," << endl << "{\"name\": \"thread_name\", \"ph\": \"M\", "
+                << "\"pid\": " << trace->my_num << ", \"tid\": " << tid
+                << ", \"args\": {\"name\": \"Thread " << buffer.thread_num
+                << "\"}}";
+
+        auto& events = buffer.events;
+        size_t n = min(buffer.n_events, events.size());
+        for (size_t i = buffer.n_events - n; i < buffer.n_events; i++)
+        {
+            auto& event = events[i % events.size()];
+            string name;
+            if (event.category == INSTRUCTION)
+                name = ((const Instruction*) event.id)->get_name();
+            else
+                name = (const char*) event.id;
+            // microseconds of the monotonic clock to align parties
+            // on the same host
+            out << "," << endl << "{\"name\": \"" << name << "\", \"cat\": \""
+                    << categories[event.category] << "\", \"ph\": \"X\", "
+                    << "\"ts\": " << event.begin / 1000 << "."
+                    << event.begin / 100 % 10 << ", \"dur\": "
+                    << (event.end - event.begin) * 1e-3 << ", \"pid\": "
+                    << trace->my_num << ", \"tid\": " << tid << "}";
+        }
+    }
+    pthread_mutex_unlock(&trace->mutex);
+
+    out << endl << "]}" << endl;
+    if (not out.good())
+        throw file_error("cannot write trace to " + trace->filename);
+    cerr << "Trace stored in " << trace->filename << endl;
+}
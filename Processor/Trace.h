@@ -0,0 +1,129 @@
+/*
+ * Trace.h
+ *
+ */
+
+#ifndef PROCESSOR_TRACE_H_
+#define PROCESSOR_TRACE_H_
+
+#include <pthread.h>
+#include <time.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+class Instruction;
+
+/**
+ * Timeline of thread activity (``-o trace``) in the Chrome trace
+ * format, which Perfetto and ``chrome://tracing`` can display. Every
+ * thread records spans of tapes, groups of consecutive instructions
+ * with the same opcode, communication, MAC checks, preprocessing
+ * refills, and waiting for other threads into its own ring buffer,
+ * which keeps the most recent ``-o trace_events=<n>`` spans (65536 by
+ * default). The file ``<prefix>-P<party>.json`` is written at the end
+ * of every run.
+ */
+class Trace
+{
+public:
+    enum Category
+    {
+        TAPE,
+        INSTRUCTION,
+        COMM,
+        CHECK,
+        PREP,
+        WAIT,
+        N_CATEGORIES
+    };
+
+    /// Span from construction to destruction
+    class Span
+    {
+        const char* name;
+        Category category;
+        long long begin;
+
+    public:
+        Span(const char* name, Category category) :
+                name(name), category(category), begin(singleton ? now() : 0)
+        {
+        }
+
+        ~Span()
+        {
+            if (begin)
+                record(name, category, begin);
+        }
+    };
+
+    /// Consecutive instructions with the same opcode
+    class InstructionGroup
+    {
+        const Instruction* first;
+        long long begin;
+
+    public:
+        InstructionGroup() : first(0), begin(0) {}
+        ~InstructionGroup() { close(); }
+
+        void next(const Instruction& instruction);
+        void close();
+    };
+
+    static bool active() { return singleton; }
+
+    static long long now();
+
+    /// Span from ``begin`` until now
+    static void record(const void* id, Category category, long long begin);
+
+    /// Start recording if requested
+    static void start(int my_num);
+    /// Write all recorded spans
+    static void write();
+
+private:
+    struct Event
+    {
+        long long begin, end;
+        const void* id;
+        Category category;
+    };
+
+    // ring buffer of one thread
+    struct Buffer
+    {
+        int thread_num;
+        vector<Event> events;
+        size_t n_events;
+
+        Buffer(int thread_num, size_t size);
+    };
+
+    static Trace* singleton;
+    static thread_local Buffer* buffer;
+
+    int my_num;
+    string filename;
+    size_t buffer_size;
+
+    pthread_mutex_t mutex;
+    deque<unique_ptr<Buffer>> buffers;
+
+    Trace(int my_num, const string& prefix, size_t buffer_size);
+
+    Buffer* new_buffer();
+};
+
+inline long long Trace::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+#endif /* PROCESSOR_TRACE_H_ */
@@ -24,9 +24,8 @@
     X(STMCI, Proc.machine.Mp.MC.indirect_write(instruction, Procp.get_C(), Proc.get_Ci()),) \
     X(MOVS, auto dest = &Procp.get_S()[r[0]]; auto source = &Procp.get_S()[r[1]], \
             *dest++ = *source++) \
-    X(ADDS, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_S()[r[2]], \
-            *dest++ = *op1++ + *op2++) \
+    X(ADDS, vector_add(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            &Procp.get_S()[r[2]], size),) \
     X(ADDM, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
             auto op2 = &Procp.get_C()[r[2]], \
             *dest++ = *op1++ + sint::constant(*op2++, Proc.P.my_num(), Procp.MC.get_alphai())) \
@@ -38,9 +37,8 @@
     X(ADDCI, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
             typename sint::clear op2 = int(n), \
             *dest++ = *op1++ + op2) \
-    X(SUBS, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_S()[r[2]], \
-            *dest++ = *op1++ - *op2++) \
+    X(SUBS, vector_sub(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            &Procp.get_S()[r[2]], size),) \
     X(SUBSI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
             auto op2 = sint::constant(int(n), Proc.P.my_num(), Procp.MC.get_alphai()), \
             *dest++ = *op1++ - op2) \
@@ -67,18 +65,15 @@
             s += *op1++; *dest++ = s) \
     X(PICKS, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1] + r[2]], \
             *dest++ = *op1; op1 += int(n)) \
-    X(MULM, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]]; mulm_check<sint>(), \
-            *dest++ = *op1++ * *op2++) \
-    X(MULC, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ * *op2++) \
+    X(MULM, mulm_check<sint>(); vector_mul(&Procp.get_S()[r[0]], \
+            &Procp.get_S()[r[1]], &Procp.get_C()[r[2]], size),) \
+    X(MULC, vector_mul(&Procp.get_C()[r[0]], &Procp.get_C()[r[1]], \
+            &Procp.get_C()[r[2]], size),) \
     X(MULCI, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
             typename sint::clear op2 = int(n), \
             *dest++ = *op1++ * op2) \
-    X(MULSI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            typename sint::clear op2 = int(n), \
-            *dest++ = *op1++ * op2) \
+    X(MULSI, vector_scale(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            typename sint::clear(int(n)), size),) \
     X(ANDC, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
             auto op2 = &Procp.get_C()[r[2]], \
             *dest++ = *op1++ & *op2++) \
@@ -237,12 +232,8 @@
     X(GSUBCFI, auto dest = &C2[r[0]]; auto op1 = &C2[r[1]]; \
             cgf2n op2 = int(n), \
             *dest++ = op2 - *op1++) \
-    X(GMULC, auto dest = &C2[r[0]]; auto op1 = &C2[r[1]]; \
-            auto op2 = &C2[r[2]], \
-            *dest++ = *op1++ * *op2++) \
-    X(GMULCI, auto dest = &C2[r[0]]; auto op1 = &C2[r[1]]; \
-            cgf2n op2 = int(n), \
-            *dest++ = *op1++ * op2) \
+    X(GMULC, vector_mul(&C2[r[0]], &C2[r[1]], &C2[r[2]], size),) \
+    X(GMULCI, cgf2n::mul(&C2[r[0]], &C2[r[1]], cgf2n(int(n)), size),) \
     X(GANDC, auto dest = &C2[r[0]]; auto op1 = &C2[r[1]]; \
             auto op2 = &C2[r[2]], \
             *dest++ = *op1++ & *op2++) \
@@ -325,6 +316,7 @@
     X(MATMULSM, throw not_implemented(),) \
     X(CONV2DS, throw not_implemented(),) \
     X(TRUNC_PR, throw not_implemented(),) \
+    X(MULTRUNCPRS, throw not_implemented(),) \
     X(CHECK, throw not_implemented(),) \
     X(JMP, throw not_implemented(),) \
     X(JMPI, throw not_implemented(),) \
@@ -395,6 +387,68 @@
     X(GWRITEFILESHARE, throw not_implemented(),) \
     X(GREADFILESHARE, throw not_implemented(),) \
 
+// jumps also handled by the main loop to keep them in one place
+#define CONTROL_INSTRUCTIONS \
+    X(JMP, Proc.PC += (signed int) n) \
+    X(JMPNZ, if (Proc.read_Ci(r[0]) != 0) Proc.PC += (signed int) n) \
+    X(JMPEQZ, if (Proc.read_Ci(r[0]) == 0) Proc.PC += (signed int) n) \
+
+// adjacent instructions executed in one pass by the threaded code if
+// the registers do not partially overlap, see Program::fuse();
+// arguments: opcodes, number of register arguments, setup, vector loop;
+// r2 and n2 refer to the second instruction;
+// the handlers are compiled for the share types of every virtual
+// machine, so candidates from --profile are specialized ahead of time
+#define FUSED_INSTRUCTIONS \
+    X(LDINT, LTC, 1, 3, auto dest = &Ci[r[0]]; auto dest2 = &Ci[r2[0]]; \
+            auto op1 = &Ci[r2[1]]; auto op2 = &Ci[r2[2]], \
+            *dest++ = int(n); *dest2++ = *op1++ < *op2++) \
+    X(LDINT, ADDINT, 1, 3, auto dest = &Ci[r[0]]; auto dest2 = &Ci[r2[0]]; \
+            auto op1 = &Ci[r2[1]]; auto op2 = &Ci[r2[2]], \
+            *dest++ = int(n); *dest2++ = *op1++ + *op2++) \
+    X(LDINT, SUBINT, 1, 3, auto dest = &Ci[r[0]]; auto dest2 = &Ci[r2[0]]; \
+            auto op1 = &Ci[r2[1]]; auto op2 = &Ci[r2[2]], \
+            *dest++ = int(n); *dest2++ = *op1++ - *op2++) \
+    X(LDINT, MULINT, 1, 3, auto dest = &Ci[r[0]]; auto dest2 = &Ci[r2[0]]; \
+            auto op1 = &Ci[r2[1]]; auto op2 = &Ci[r2[2]], \
+            *dest++ = int(n); *dest2++ = *op1++ * *op2++) \
+    X(LDI, LDI, 1, 1, auto dest = &Procp.get_C()[r[0]]; \
+            auto dest2 = &Procp.get_C()[r2[0]]; \
+            typename sint::clear tmp = int(n); typename sint::clear tmp2 = int(n2), \
+            *dest++ = tmp; *dest2++ = tmp2) \
+    X(MULM, ADDS, 3, 3, auto dest = &Procp.get_S()[r[0]]; \
+            auto op1 = &Procp.get_S()[r[1]]; auto op2 = &Procp.get_C()[r[2]]; \
+            auto dest2 = &Procp.get_S()[r2[0]]; auto op3 = &Procp.get_S()[r2[1]]; \
+            auto op4 = &Procp.get_S()[r2[2]]; mulm_check<sint>(), \
+            *dest++ = *op1++ * *op2++; *dest2++ = *op3++ + *op4++) \
+    X(MULM, ADDM, 3, 3, auto dest = &Procp.get_S()[r[0]]; \
+            auto op1 = &Procp.get_S()[r[1]]; auto op2 = &Procp.get_C()[r[2]]; \
+            auto dest2 = &Procp.get_S()[r2[0]]; auto op3 = &Procp.get_S()[r2[1]]; \
+            auto op4 = &Procp.get_C()[r2[2]]; mulm_check<sint>(), \
+            *dest++ = *op1++ * *op2++; \
+            *dest2++ = *op3++ + sint::constant(*op4++, Proc.P.my_num(), \
+                    Procp.MC.get_alphai())) \
+    X(MULSI, ADDS, 2, 3, auto dest = &Procp.get_S()[r[0]]; \
+            auto op1 = &Procp.get_S()[r[1]]; typename sint::clear op2 = int(n); \
+            auto dest2 = &Procp.get_S()[r2[0]]; auto op3 = &Procp.get_S()[r2[1]]; \
+            auto op4 = &Procp.get_S()[r2[2]], \
+            *dest++ = *op1++ * op2; *dest2++ = *op3++ + *op4++) \
+    X(ADDS, ADDS, 3, 3, auto dest = &Procp.get_S()[r[0]]; \
+            auto op1 = &Procp.get_S()[r[1]]; auto op2 = &Procp.get_S()[r[2]]; \
+            auto dest2 = &Procp.get_S()[r2[0]]; auto op3 = &Procp.get_S()[r2[1]]; \
+            auto op4 = &Procp.get_S()[r2[2]], \
+            *dest++ = *op1++ + *op2++; *dest2++ = *op3++ + *op4++) \
+    X(SUBS, SUBS, 3, 3, auto dest = &Procp.get_S()[r[0]]; \
+            auto op1 = &Procp.get_S()[r[1]]; auto op2 = &Procp.get_S()[r[2]]; \
+            auto dest2 = &Procp.get_S()[r2[0]]; auto op3 = &Procp.get_S()[r2[1]]; \
+            auto op4 = &Procp.get_S()[r2[2]], \
+            *dest++ = *op1++ - *op2++; *dest2++ = *op3++ - *op4++) \
+    X(MOVC, MOVC, 2, 2, auto dest = &Procp.get_C()[r[0]]; \
+            auto source = &Procp.get_C()[r[1]]; \
+            auto dest2 = &Procp.get_C()[r2[0]]; \
+            auto source2 = &Procp.get_C()[r2[1]], \
+            *dest++ = *source++; *dest2++ = *source2++) \
+
 #define ALL_INSTRUCTIONS ARITHMETIC_INSTRUCTIONS REGINT_INSTRUCTIONS \
     CLEAR_GF2N_INSTRUCTIONS REMAINING_INSTRUCTIONS
 
@@ -0,0 +1,5 @@
+@export
+def inner_product(x, y):
+    return sint.dot_product(x, y)
+
+inner_product(sint(0, size=3), sint(0, size=3))
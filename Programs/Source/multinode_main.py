@@ -0,0 +1,30 @@
+import random
+from Compiler import multinode
+
+n_nodes = int(program.args[1])
+chunk = int(program.args[2])
+n_chunks = int(program.args[3])
+
+n = chunk * n_chunks
+a = Array.create_from(sint(regint.inc(n)))
+b = Array.create_from(sint(regint.inc(n)))
+
+nodes = multinode.Nodes(n_nodes, chunk)
+c = nodes.mul(a, b)
+
+for i in range(10):
+    index = random.randrange(n)
+    value = c[index].reveal()
+    runtime_error_if(value != index ** 2, '%s != %s', value, index ** 2)
+
+A = sint.Matrix(chunk // 100 * n_chunks, 100)
+B = sint.Matrix(100, 100)
+A.assign_vector(sint(regint.inc(A.total_size())))
+B.assign_vector(sint(regint.inc(B.total_size())))
+C = nodes.matmul(A, B, chunk // 100)
+nodes.stop()
+
+for i in range(3):
+    x, y = (random.randrange(size) for size in C.sizes)
+    expected = sum(A[x][k] * B[k][y] for k in range(100)).reveal()
+    runtime_error_if(C[x][y].reveal() != expected, 'matmul error')
@@ -0,0 +1,13 @@
+from Compiler import multinode
+
+n_threads = int(program.args[1])
+chunk = int(program.args[2])
+node_id = int(program.args[3])
+
+if len(program.args) > 4:
+    host = program.args[4]
+else:
+    host = 'localhost'
+
+multinode.serve(node_id, chunk, host, n_threads=n_threads,
+                matmul=(chunk // 100, 100, 100))
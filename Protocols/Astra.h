@@ -7,12 +7,22 @@
 #define PROTOCOLS_ASTRA_H_
 
 #include "Replicated.h"
+#include "Tools/SharedMemoryRing.h"
+#include "Tools/BufferedWriter.h"
+#include "Networking/StreamChannel.h"
 
 template<class T> class TrioPrepShare;
 template<class T> class AstraPrepShare;
 template<class T> class AstraShare;
 template<class T> class AstraPrepInput;
 
+/**
+ * Suffix for the preprocessing instance given by ``-o astra_instance``,
+ * either an index or ``next``, which takes the index from a counter
+ * file per phase and party. The result is fixed for the whole process.
+ */
+string astra_instance_suffix(bool preprocessing, int player);
+
 template <class T>
 class AstraBase : public ProtocolBase<T>
 {
@@ -35,6 +45,14 @@ protected:
     string get_filename(bool create, const char* name = "Protocol");
     string get_output_filename();
 
+    static bool use_shm();
+    static bool use_chunks();
+    static bool use_network();
+    static bool use_next_instance();
+
+    void open_channel(StreamChannel& channel, const string& filename,
+            bool sender);
+
     void debug();
 
     virtual int my_astra_num() = 0;
@@ -104,6 +122,9 @@ class AstraOnlineBase : public AstraBase<T>
 protected:
     ifstream prep;
     ofstream outputs;
+    SharedMemoryRing prep_ring, outputs_ring;
+    StreamChannel prep_channel, outputs_channel;
+    ChunkedReader* prep_reader;
     int astra_num;
 
     octetStream cs_prep;
@@ -113,6 +134,10 @@ protected:
         return astra_num;
     }
 
+    // preprocessing of the reduced multiplication, followed by the
+    // input0 masks in truncation
+    virtual octetStream& reduced_mul_prep() = 0;
+
     bool local_mul_for(int player)
     {
         return player == my_astra_num();
@@ -130,6 +155,7 @@ protected:
 
 public:
     AstraOnlineBase(Player& P);
+    ~AstraOnlineBase();
 
     void init_prep();
 
@@ -172,11 +198,19 @@ class Astra : public AstraOnlineBase<T>
 
     octetStream os, os_prep, recv_os;
 
-    T pre(const open_type& input);
-
     void init_reduced_mul(size_t n_mul);
     void exchange_reduced_mul(size_t n_mul);
 
+    octetStream& reduced_mul_prep()
+    {
+        return os_prep;
+    }
+
+    void prepare_exchange();
+    template<int MY_NUM>
+    void prepare_exchange(size_t n_mults);
+    void finalize_exchange(octetStream& received);
+
     void unsplit1(StackedVector<T>& dest,
             StackedVector<typename T::bit_type>& source,
             const Instruction& instruction);
@@ -186,6 +220,8 @@ public:
 
     /// Run multiplication protocol
     void exchange();
+    void start_exchange();
+    void stop_exchange();
     /// Get next multiplication result
     T finalize_mul(int n = -1) final;
     T finalize_mul_fast()
@@ -210,6 +246,9 @@ class AstraPrepProtocol : public AstraBase<T>
 
     ReplicatedInput<Rep3Share<typename T::clear>>* unsplit_input;
 
+    // store reduced multiplication and input0 as one message
+    bool input0_pending;
+
     template<int MY_NUM>
     void unsplit_finish(StackedVector<T>& dest, const Instruction& instruction);
 
@@ -223,6 +262,9 @@ class AstraPrepProtocol : public AstraBase<T>
 protected:
     ofstream prep;
     ifstream outputs;
+    SharedMemoryRing prep_ring, outputs_ring;
+    StreamChannel prep_channel, outputs_channel;
+    BufferedWriter* prep_writer;
     ReplicatedBase prng_protocol;
     ReplicatedBase prng_protocol_for_input0;
     int my_num;
@@ -238,21 +280,27 @@ protected:
 
     void add_gen(octetStream& cs, const typename T::open_type& value);
 
+    // for large batches
+    int n_threads;
+
+    template<class U>
+    void run_parallel(size_t n, const U& job);
+
     template<int my_num>
     void pre();
-    template<int my_num>
-    void pre_element(T& res);
-    template<int my_num>
-    void pre_gamma(T& res, open_type& gamma, const open_type& input);
 
     void post(T& res, const open_type& gamma);
 
+    void flush_prep(bool section = false);
+
 public:
     AstraPrepProtocol(Player& P);
     ~AstraPrepProtocol();
 
     void init_prep();
 
+    void check();
+
     virtual bool local_mul_for(int player)
     {
         return player == my_astra_num();
@@ -9,14 +9,50 @@
 #include "Astra.h"
 #include "Tools/files.h"
 #include "Tools/ranges.h"
+#include "Tools/ParallelJobs.h"
+
+inline string astra_instance_suffix(bool preprocessing, int player)
+{
+    static string res = [&]() -> string
+    {
+        auto instance = OnlineOptions::singleton.option_value(
+                "astra_instance");
+        if (instance.empty())
+            return "";
+
+        if (instance == "next")
+        {
+            string filename = string(PREP_DIR "Astra-Instance-")
+                    + (preprocessing ? "Prep" : "Online") + "-P"
+                    + to_string(player);
+            int next = 0;
+            ifstream in(filename);
+            in >> next;
+            in.close();
+            ofstream out(filename);
+            out << next + 1 << endl;
+            if (out.fail())
+                throw file_error(filename);
+            instance = to_string(next);
+        }
+        else if (stoi(instance) < 0)
+            throw runtime_error("invalid instance: " + instance);
+
+        if (OnlineOptions::singleton.verbose)
+            cerr << "Using preprocessing instance " << instance << endl;
+        return "-I" + instance;
+    }();
+    return res;
+}
 
 template<class T>
 string AstraBase<T>::get_filename(bool preprocessing, const char* name)
 {
     int base = 1 - preprocessing;
+    int player = P.my_num() + base;
     auto res = get_prep_sub_dir<T>(P.num_players() + base, preprocessing) + name
-            + suffix + "-P" + to_string(P.my_num() + base) + "-T"
-            + to_string(BaseMachine::thread_num);
+            + suffix + astra_instance_suffix(preprocessing, player) + "-P"
+            + to_string(player) + "-T" + to_string(BaseMachine::thread_num);
     if (OnlineOptions::singleton.has_option("verbose_astra"))
         fprintf(stderr, "astra filename %s\n", res.c_str());
     return res;
@@ -29,6 +65,64 @@ string AstraBase<T>::get_output_filename()
     return get_filename(not T::real_shares(P), "Outputs");
 }
 
+template<class T>
+bool AstraBase<T>::use_shm()
+{
+    return OnlineOptions::singleton.has_option("astra_shm");
+}
+
+template<class T>
+bool AstraBase<T>::use_chunks()
+{
+    return OnlineOptions::singleton.has_option("astra_chunked")
+            or OnlineOptions::singleton.has_option("astra_zstd");
+}
+
+template<class T>
+bool AstraBase<T>::use_next_instance()
+{
+    return OnlineOptions::singleton.option_value("astra_instance") == "next";
+}
+
+template<class T>
+bool AstraBase<T>::use_network()
+{
+    auto& opts = OnlineOptions::singleton;
+    return not (opts.option_value("astra_listen").empty()
+            and opts.option_value("astra_connect").empty());
+}
+
+template<class T>
+void AstraBase<T>::open_channel(StreamChannel& channel, const string& filename,
+        bool sender)
+{
+    auto& opts = OnlineOptions::singleton;
+    // the online phase listens, the preprocessing phase connects
+    auto listen = opts.option_value("astra_listen");
+    int my_num = P.my_num();
+    int other = listen.empty() ? my_num - 1 : my_num + 1;
+    string me, peer;
+    if (opts.has_option("astra_tls"))
+    {
+        me = "P" + to_string(my_num);
+        peer = "P" + to_string(other);
+    }
+    if (listen.empty())
+    {
+        string hostname;
+        int port;
+        StreamChannel::parse_address(opts.option_value("astra_connect"),
+                hostname, port);
+        channel.connect(hostname, port, filename, sender, me, peer);
+    }
+    else
+        channel.accept(stoi(listen), filename, sender, me, peer);
+    if (not sender)
+        channel.start_prefetch(
+                stoi(opts.option_value("astra_prefetch",
+                        to_string(STREAM_CHANNEL_WINDOW))));
+}
+
 template<class T>
 void AstraBase<T>::debug()
 {
@@ -63,17 +157,25 @@ Astra<T>::Astra(Player& P) :
 
 template<class T>
 AstraOnlineBase<T>::AstraOnlineBase(Player& P) :
-        AstraBase<T>(P)
+        AstraBase<T>(P), prep_reader(0)
 {
     astra_num = P.my_num() + 1;
 }
 
+template<class T>
+AstraOnlineBase<T>::~AstraOnlineBase()
+{
+    if (prep_reader)
+        delete prep_reader;
+}
+
 template<class T>
 AstraPrepProtocol<T>::AstraPrepProtocol(Player& P) :
-        AstraBase<T>(P), unsplit_input(0), prng_protocol(P),
-        prng_protocol_for_input0(P)
+        AstraBase<T>(P), unsplit_input(0), input0_pending(false),
+        prep_writer(0), prng_protocol(P), prng_protocol_for_input0(P)
 {
     my_num = P.my_num();
+    n_threads = ParallelJobs::n_threads("astra_prep_threads");
 }
 
 template<class T>
@@ -83,19 +185,84 @@ AstraPrepProtocol<T>::~AstraPrepProtocol()
     prng_protocol_for_input0.output_time<T>();
     if (unsplit_input)
         delete unsplit_input;
+    if (prep_writer)
+    {
+        flush_prep();
+        delete prep_writer;
+    }
 }
 
 template<class T>
 void AstraOnlineBase<T>::init_prep()
 {
-    open_with_check(prep, this->get_filename(false));
+    if (this->use_network())
+        this->open_channel(prep_channel, this->get_filename(false), false);
+    else if (this->use_shm())
+        prep_ring.attach(this->get_filename(false));
+    else
+    {
+        auto filename = this->get_filename(false);
+        open_with_check(prep, filename);
+        if (this->use_chunks())
+        {
+            prep_reader = new ChunkedReader(prep);
+            // partial rerun starting at a tape boundary
+            auto section = OnlineOptions::singleton.option_value(
+                    "astra_section");
+            if (not section.empty())
+                prep_reader->seek_section(stoi(section));
+        }
+        // don't use an instance twice
+        if (this->use_next_instance())
+            remove(filename.c_str());
+    }
 }
 
 template<class T>
 void AstraPrepProtocol<T>::init_prep()
 {
     if (this->P.my_num() > 0)
-        prep.open(this->get_filename(true));
+    {
+        if (this->use_network())
+            this->open_channel(prep_channel, this->get_filename(true), true);
+        else if (this->use_shm())
+            prep_ring.create(this->get_filename(true));
+        else
+        {
+            prep.open(this->get_filename(true));
+            if (this->use_chunks())
+                prep_writer = new BufferedWriter(prep,
+                        OnlineOptions::singleton.has_option("astra_zstd") ?
+                                ChunkedFile::ZSTD : ChunkedFile::RAW);
+            else if (not OnlineOptions::singleton.has_option(
+                    "astra_sync_write"))
+                prep_writer = new BufferedWriter(prep);
+        }
+    }
+}
+
+template<class T>
+void AstraPrepProtocol<T>::flush_prep(bool section)
+{
+    if (prep_writer)
+    {
+        prep_writer->flush(section);
+        auto& stats = this->P.comm_stats.map<string, CommStats>::operator[](
+                "Preprocessing writes");
+        stats.data += prep_writer->n_bytes;
+        stats.rounds += prep_writer->n_writes;
+        stats.timer += prep_writer->timer;
+        prep_writer->n_bytes = 0;
+        prep_writer->n_writes = 0;
+        prep_writer->timer.reset();
+    }
+}
+
+template<class T>
+void AstraPrepProtocol<T>::check()
+{
+    // tape boundary
+    flush_prep(true);
 }
 
 template<class T>
@@ -190,73 +357,82 @@ void AstraBase<T>::prepare_exchange()
     n_mults += this->input_pairs.size();
 }
 
+template<class T>
+template<class U>
+void AstraPrepProtocol<T>::run_parallel(size_t n, const U& job)
+{
+    ParallelJobs::run(n, n_threads,
+            [&](int, size_t begin, size_t end) { job(begin, end); }, 10000);
+}
+
 template<class T>
 template<int my_num>
 void AstraPrepProtocol<T>::pre()
 {
     auto& inputs = this->inputs;
+    auto& input_pairs = this->input_pairs;
     auto& results = this->results;
-    auto& n_mults = this->n_mults;
-
-    n_mults += this->input_pairs.size();
-    results.reserve(n_mults);
 
+    this->n_mults += input_pairs.size();
+    size_t n_inputs = inputs.size();
+    size_t n = n_inputs + input_pairs.size();
+    const size_t size = open_type::size();
+
+    // expand all randomness up front, which results in the same
+    // sequence per PRNG as element by element:
+    // (lambda, gamma) or lambda per product for the first
+    // and lambda for the second (only P0)
+    auto& prngs = prng_protocol.shared_prngs;
+    vector<open_type> first((my_num < 2 ? 2 : 1) * n);
+    vector<open_type> second(my_num == 0 ? n : 0);
+    prngs[my_num % 2].fill(first.data(), first.size());
+    prngs[1].fill(second.data(), second.size());
+
+    results.resize(n);
+    octet* out = 0;
     if (my_num == 0)
     {
         os.clear();
-        os.reserve(n_mults * T::open_type::size());
+        out = os.append(n * size);
     }
     else
     {
         os_prep.clear();
-        os_prep.reserve(n_mults * 2 * T::open_type::size());
-    }
-
-    T res;
-    open_type gamma;
-
-    for (auto& input : inputs)
-    {
-        pre_element<my_num>(res);
-        pre_gamma<my_num>(res, gamma, input);
-        results.push_back(res);
-    }
-
-    for (auto& x : this->input_pairs)
-    {
-        open_type input;
-#define X(I) if (my_num == I) input = x[0].local_mul_P##I(x[1]);
-        X(0) X(1) X(2)
-#undef X
-        pre_element<my_num>(res);
-        pre_gamma<my_num>(res, gamma, input);
-        results.push_back(res);
+        os_prep.reserve(2 * n * size);
+        if (my_num == 1)
+            out = os_prep.append(2 * n * size);
     }
-}
-
-template<class T>
-template<int my_num>
-void AstraPrepProtocol<T>::pre_element(T& res)
-{
-    if (my_num == 0)
-        for (int i = 0; i < 2; i++)
-            res[i].randomize(prng_protocol.shared_prngs[i]);
-    else
-        res[1].randomize(prng_protocol.shared_prngs[2 - my_num]);
-}
 
-template<class T>
-template<int my_num>
-void AstraPrepProtocol<T>::pre_gamma(T& res, open_type& gamma, const open_type& input)
-{
-    if (my_num < 2)
+    run_parallel(n, [&](size_t begin, size_t end)
     {
-        gamma.randomize(prng_protocol.shared_prngs[my_num]);
-        if (my_num == 0)
-            os.store_no_resize(input - gamma);
-        else
-            post(res, gamma);
-    }
+        for (size_t i = begin; i < end; i++)
+        {
+            auto& res = results[i];
+            if (my_num == 0)
+            {
+                open_type input;
+                if (i < n_inputs)
+                    input = inputs[i];
+                else
+                {
+                    auto& x = input_pairs[i - n_inputs];
+                    input = x[0].local_mul_P0(x[1]);
+                }
+                res[0] = first[2 * i];
+                res[1] = second[i];
+                auto masked = input - first[2 * i + 1];
+                memcpy(out + i * size, masked.get_ptr(), size);
+            }
+            else if (my_num == 1)
+            {
+                res[1] = first[2 * i];
+                memcpy(out + 2 * i * size, first[2 * i + 1].get_ptr(), size);
+                memcpy(out + (2 * i + 1) * size, res[1].get_ptr(), size);
+            }
+            else
+                res[1] = first[i];
+        }
+    });
 }
 
 template<class T>
@@ -299,20 +475,6 @@ void AstraPrepProtocol<T>::post(T& res, const open_type& gamma)
     os_prep.store_no_resize(res[1]);
 }
 
-template<class T>
-T Astra<T>::pre(const open_type& input)
-{
-    int my_num = this->astra_num;
-    typename T::open_type gamma;
-    gamma = os_prep.get_no_check<open_type>();
-    T res;
-    res[1] = os_prep.get_no_check<open_type>();
-    auto m_z = input - res.neg_lambda(my_num) + gamma;
-    os.store_no_resize(m_z);
-    res.m(my_num) = m_z;
-    return res;
-}
-
 template<class T>
 void Astra<T>::exchange()
 {
@@ -321,45 +483,134 @@ void Astra<T>::exchange()
         fprintf(stderr, "astra exchange %zu\n", this->inputs.size());
 
     auto& P = this->P;
-    auto& inputs = this->inputs;
-    auto& results = this->results;
-    assert(results.size() == 0);
 
-    size_t n_mults = this->inputs.size() + this->input_pairs.size();
+    if (this->my_astra_num() > 0)
+    {
+        // receive in the background while computing if possible
+        PooledOctetStream recv_os(P.stream_pool);
+        int other = 1 - P.my_num();
+        bool overlap = P.is_full_duplex();
+        if (overlap)
+            P.request_receive(other, recv_os);
 
-    int my_num = this->my_astra_num();
-    if (my_num > 0)
+        prepare_exchange();
+
+        if (overlap)
+        {
+            P.request_send(other, os);
+            P.wait_receive(other, recv_os);
+            P.wait_send(other, os);
+        }
+        else
+            P.exchange(other, os, recv_os);
+
+        finalize_exchange(recv_os);
+    }
+
+    this->results.reset();
+}
+
+template<class T>
+void Astra<T>::start_exchange()
+{
+    CODE_LOCATION
+    auto& P = this->P;
+
+    if (this->my_astra_num() > 0)
     {
-        this->read(os_prep);
-        os.clear();
-        os.reserve(n_mults * T::open_type::size());
+        int other = 1 - P.my_num();
+        P.request_receive(other, recv_os);
+        prepare_exchange();
+        P.request_send(other, os);
+    }
+}
 
-        if (os_prep.left() < open_type::size() * n_mults)
-            throw runtime_error("insufficient preprocessing");
+template<class T>
+void Astra<T>::stop_exchange()
+{
+    auto& P = this->P;
 
-        for (auto& input : inputs)
-            results.push_back(pre(input));
+    if (this->my_astra_num() > 0)
+    {
+        int other = 1 - P.my_num();
+        P.wait_receive(other, recv_os);
+        P.wait_send(other, os);
+        finalize_exchange(recv_os);
+    }
 
-        if (my_num == 1)
-            for (auto& x : this->input_pairs)
-                results.push_back(pre(x[0].local_mul_P1(x[1])));
-        else
-            for (auto& x : this->input_pairs)
-                results.push_back(pre(x[0].local_mul_P2(x[1])));
+    this->results.reset();
+}
 
-        octetStream recv_os;
-        P.exchange(1 - P.my_num(), os, recv_os);
+template<class T>
+void Astra<T>::prepare_exchange()
+{
+    assert(this->results.size() == 0);
 
-        if (recv_os.left() < open_type::size() * results.size())
-            throw runtime_error("insufficient data in Astra");
+    size_t n_mults = this->inputs.size() + this->input_pairs.size();
 
-        for (auto& res : results)
-            res.m(my_num) += recv_os.get_no_check<typename T::open_type>();
+    this->read(os_prep);
+    os.reset_write_head();
+
+    if (os_prep.left() < 2 * open_type::size() * n_mults)
+        throw runtime_error("insufficient preprocessing");
+
+    if (this->my_astra_num() == 1)
+        prepare_exchange<1>(n_mults);
+    else
+        prepare_exchange<2>(n_mults);
+}
+
+template<class T>
+template<int MY_NUM>
+void Astra<T>::prepare_exchange(size_t n_mults)
+{
+    auto& inputs = this->inputs;
+    auto& input_pairs = this->input_pairs;
+    auto& results = this->results;
+    size_t n_inputs = inputs.size();
+    const size_t size = open_type::size();
 
-        assert(not os_prep.left());
+    // whole batch in one go: (gamma, -lambda) per product in, m_z out
+    results.resize(n_mults);
+    const octet* prep = os_prep.consume_no_check(2 * size * n_mults);
+    octet* out = os.append(size * n_mults);
+
+    auto finish = [&](size_t i, const open_type& input)
+    {
+        open_type gamma;
+        gamma.assign(prep + 2 * i * size);
+        auto& res = results[i];
+        res[1].assign(prep + (2 * i + 1) * size);
+        res[0] = input - res[1] + gamma;
+        memcpy(out + i * size, res[0].get_ptr(), size);
+    };
+
+    for (size_t i = 0; i < n_inputs; i++)
+        finish(i, inputs[i]);
+
+    for (size_t i = 0; i < input_pairs.size(); i++)
+    {
+        auto& x = input_pairs[i];
+        if (MY_NUM == 1)
+            finish(n_inputs + i, x[0].local_mul_P1(x[1]));
+        else
+            finish(n_inputs + i, x[0].local_mul_P2(x[1]));
     }
+}
 
-    results.reset();
+template<class T>
+void Astra<T>::finalize_exchange(octetStream& received)
+{
+    auto& results = this->results;
+    int my_num = this->my_astra_num();
+
+    if (received.left() < open_type::size() * results.size())
+        throw runtime_error("insufficient data in Astra");
+
+    for (auto& res : results)
+        res.m(my_num) += received.get_no_check<typename T::open_type>();
+
+    assert(not os_prep.left());
 }
 
 template<class T>
@@ -389,14 +640,23 @@ U AstraOnlineBase<T>::read()
 template<class T>
 void AstraOnlineBase<T>::read(octetStream& os)
 {
-    if (not prep.is_open())
+    if (not (prep.is_open() or prep_ring.is_open() or prep_channel.is_open()))
         init_prep();
     Timer timer;
     TimeScope ts(timer);
     this->debug();
-    os.input(prep);
-    if (not prep.good())
-        throw runtime_error("error in preprocessing reading");
+    if (prep_channel.is_open())
+        prep_channel.read(os);
+    else if (prep_ring.is_open())
+        prep_ring.read(os);
+    else if (prep_reader)
+        prep_reader->read(os);
+    else
+    {
+        os.input(prep);
+        if (not prep.good())
+            throw runtime_error("error in preprocessing reading");
+    }
     this->P.comm_stats["Preprocessing transmission"].add(os, ts);
 }
 
@@ -417,14 +677,24 @@ void AstraPrepProtocol<T>::store(const octetStream& os)
 {
     if (this->P.my_num() > 0)
     {
-        if (not prep.is_open())
+        if (not (prep.is_open() or prep_ring.is_open()
+                or prep_channel.is_open()))
             init_prep();
         TimeScope ts(this->P.comm_stats["Preprocessing transmission"].add(os));
         this->debug();
-        os.output(prep);
-        prep.flush();
-        if (not prep.good())
-            throw runtime_error("error in preprocessing storing");
+        if (prep_channel.is_open())
+            prep_channel.write(os);
+        else if (prep_ring.is_open())
+            prep_ring.write(os);
+        else if (prep_writer)
+            prep_writer->write(os);
+        else
+        {
+            os.output(prep);
+            prep.flush();
+            if (not prep.good())
+                throw runtime_error("error in preprocessing storing");
+        }
     }
 }
 
@@ -432,15 +702,34 @@ template<class T>
 template<class U>
 void AstraPrepProtocol<T>::sync(vector<U>& values, Player& P)
 {
+    // the online phase might need everything up to here
+    BufferedWriter::flush_all();
+
     if (P.my_num() == 1)
     {
-        if (not outputs.is_open())
+        if (this->use_network())
+        {
+            if (not outputs_channel.is_open())
+                this->open_channel(outputs_channel,
+                        this->get_output_filename(), false);
+        }
+        else if (this->use_shm())
+        {
+            if (not outputs_ring.is_open())
+                outputs_ring.attach(this->get_output_filename());
+        }
+        else if (not outputs.is_open())
             open_with_check(outputs, this->get_output_filename());
 
         Timer timer;
         TimeScope ts(timer);
         octetStream os;
-        os.input(outputs);
+        if (outputs_channel.is_open())
+            outputs_channel.read(os);
+        else if (outputs_ring.is_open())
+            outputs_ring.read(os);
+        else
+            os.input(outputs);
         os.get(values);
         this->P.comm_stats["Output transmission"].add(os, ts);
         P.send_all(os);
@@ -459,14 +748,32 @@ void AstraOnlineBase<T>::sync(vector<U>& values, Player& P)
 {
     if (P.my_num() == 0)
     {
-        if (not outputs.is_open())
+        if (this->use_network())
+        {
+            if (not outputs_channel.is_open())
+                this->open_channel(outputs_channel,
+                        this->get_output_filename(), true);
+        }
+        else if (this->use_shm())
+        {
+            if (not outputs_ring.is_open())
+                outputs_ring.create(this->get_output_filename());
+        }
+        else if (not outputs.is_open())
             outputs.open(this->get_output_filename());
 
         octetStream os;
         os.store(values);
         TimeScope ts(this->P.comm_stats["Output transmission"].add(os));
-        os.output(outputs);
-        outputs.flush();
+        if (outputs_channel.is_open())
+            outputs_channel.write(os);
+        else if (outputs_ring.is_open())
+            outputs_ring.write(os);
+        else
+        {
+            os.output(outputs);
+            outputs.flush();
+        }
     }
 }
 
@@ -824,6 +1131,7 @@ void AstraPrepProtocol<T>::init_input0(size_t n_inputs)
 {
     cs.reset_write_head();
     cs.reserve<open_type>(n_inputs);
+    input0_pending = true;
 }
 
 template<class T>
@@ -850,17 +1158,24 @@ void AstraPrepProtocol<T>::finalize_input0(size_t n_inputs)
     {
         cs.reset_read_head();
         cs.require<open_type>(n_inputs);
-        store(cs);
+        os_prep.concat(cs);
+        store(os_prep);
     }
 
+    input0_pending = false;
     assert(not this->gen_values.left());
 }
 
 template<class T>
 void AstraOnlineBase<T>::exchange_input0(size_t n_inputs)
 {
-    read(cs_prep);
-    cs_prep.require<open_type>(n_inputs);
+    // rest of the message of the reduced multiplication
+    octetStream& source = reduced_mul_prep();
+    source.require<open_type>(n_inputs);
+    size_t length = n_inputs * open_type::size();
+    cs_prep.reset_write_head();
+    cs_prep.append(source.consume(length), length);
+    assert(not source.left());
 }
 
 template<class T>
@@ -954,7 +1269,7 @@ void AstraOnlineBase<T>::unsplit(StackedVector<T>& dest,
         // conversion symmetric in binary
         auto x = T::bit_type::from_rep3(source.at(instruction.get_r(0) + i));
         int left = min(unit, n_bits - unit * i);
-        typename vector<T>::iterator its[2];
+        typename StackedVector<T>::iterator its[2];
         for (int k = 0; k < 2; k++)
             its[k] = dest.iterator_for_size(
                     instruction.get_start()[k] + i * unit, left);
@@ -30,9 +30,12 @@ public:
     void reset(int player);
     void add_mine(const typename T::open_type& input, int n_bits = -1) final;
     void add_other(int player, int n_bits = -1) final;
+    void add_mine_vector(const vector<open_type>& inputs, int n_bits = -1) final;
+    void add_other_vector(int player, size_t n, int n_bits = -1) final;
 
     void exchange();
     T finalize(int player, int n_bits = -1) final;
+    void finalize_vector(int player, T* target, size_t n, int n_bits = -1);
     virtual T finalize_offset(int offset);
 };
 
@@ -57,9 +60,12 @@ public:
     void reset(int player);
     void add_mine(const typename T::open_type& input, int n_bits = -1) final;
     void add_other(int player, int n_bits = -1) final;
+    void add_mine_vector(const vector<open_type>& inputs, int n_bits = -1) final;
+    void add_other_vector(int player, size_t n, int n_bits = -1) final;
 
     void exchange();
     T finalize(int player, int n_bits = -1) final;
+    void finalize_vector(int player, T* target, size_t n, int n_bits = -1) final;
     T finalize_offset(int player);
 };
 
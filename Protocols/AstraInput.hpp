@@ -86,6 +86,19 @@ void AstraPrepInput<T>::add_other(int player, int)
     n_inputs.at(player)++;
 }
 
+template<class T>
+void AstraPrepInput<T>::add_mine_vector(const vector<open_type>& inputs, int)
+{
+    add_other_vector(this->P->my_num() - 1, inputs.size());
+}
+
+template<class T>
+void AstraPrepInput<T>::add_other_vector(int player, size_t n, int)
+{
+    assert(player != 2);
+    n_inputs.at(player) += n;
+}
+
 template<class T>
 void AstraInput<T>::add_mine(const typename T::open_type& input,
         int)
@@ -99,6 +112,18 @@ void AstraInput<T>::add_other(int, int)
     results.push_back({});
 }
 
+template<class T>
+void AstraInput<T>::add_mine_vector(const vector<open_type>& inputs, int)
+{
+    this->inputs.insert(this->inputs.end(), inputs.begin(), inputs.end());
+}
+
+template<class T>
+void AstraInput<T>::add_other_vector(int, size_t n, int)
+{
+    results.resize(results.size() + n);
+}
+
 template<class T>
 void AstraPrepInput<T>::exchange()
 {
@@ -206,12 +231,28 @@ T AstraPrepInput<T>::finalize(int player, int)
     return finalize_offset((player - (this->P->my_num() - 1) + 3) % 3);
 }
 
+template<class T>
+void AstraPrepInput<T>::finalize_vector(int player, T* target, size_t n, int)
+{
+    auto& source = results[(player - (this->P->my_num() - 1) + 3) % 3];
+    for (size_t i = 0; i < n; i++)
+        target[i] = source.next();
+}
+
 template<class T>
 T AstraInput<T>::finalize(int player, int)
 {
     return finalize_offset(player - this->P->my_num());
 }
 
+template<class T>
+void AstraInput<T>::finalize_vector(int player, T* target, size_t n, int)
+{
+    int offset = player - this->P->my_num();
+    for (size_t i = 0; i < n; i++)
+        target[i] = AstraInput<T>::finalize_offset(offset);
+}
+
 template<class T>
 T AstraInput<T>::finalize_offset(int offset)
 {
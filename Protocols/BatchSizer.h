@@ -0,0 +1,109 @@
+/*
+ * BatchSizer.h
+ *
+ */
+
+#ifndef PROTOCOLS_BATCHSIZER_H_
+#define PROTOCOLS_BATCHSIZER_H_
+
+#include "Networking/Player.h"
+#include "Tools/time-func.h"
+
+#include <algorithm>
+using namespace std;
+
+/**
+ * Batch size controller for one type of preprocessing
+ * (``-o adaptive_batch``). The batch size doubles as long as this
+ * reduces the time per item, and it falls back otherwise. It is
+ * bounded by the items consumed in a second and a memory budget.
+ * All parties use the maximum of the measurements in order to agree
+ * on the batch sizes.
+ */
+class BatchSizer
+{
+    // batch size and time per item of the last two batches
+    size_t size, last_size;
+    double cost, last_cost;
+
+    // consumption of the last batch
+    size_t n_consumed;
+    Timer consumption_timer;
+    double consumption, rate;
+
+    bool stable;
+
+public:
+    // horizon of consumption to generate for in seconds
+    static constexpr double horizon = 1;
+
+    BatchSizer() :
+            size(0), last_size(0), cost(0), last_cost(0), n_consumed(0),
+            consumption(0), rate(0), stable(false)
+    {
+    }
+
+    size_t get_size() const
+    {
+        return size;
+    }
+
+    /// Size of next batch given the static size and a memory bound
+    size_t next(size_t initial, size_t max_size)
+    {
+        if (consumption_timer.is_running())
+        {
+            consumption_timer.stop();
+            consumption = consumption_timer.elapsed_then_reset();
+        }
+
+        if (size == 0)
+            size = initial;
+        else if (not stable)
+        {
+            if (last_size == 0 or cost < 0.9 * last_cost)
+            {
+                last_size = size;
+                last_cost = cost;
+                if (rate == 0 or size < rate * horizon)
+                    size *= 2;
+            }
+            else
+            {
+                // no improvement
+                size = last_size;
+                stable = true;
+            }
+        }
+
+        size = max(min(size, max_size), size_t(1));
+        return size;
+    }
+
+    /// Agree on the time to produce a batch and to consume the previous
+    void update(size_t n_items, double seconds, Player& P)
+    {
+        octetStream os;
+        os.store(size_t(seconds * 1e9));
+        os.store(size_t(consumption * 1e9));
+        vector<octetStream> all(P.num_players(), os);
+        P.unchecked_broadcast(all);
+
+        size_t production_ns = 0, consumption_ns = 0;
+        for (auto& x : all)
+        {
+            production_ns = max(production_ns, x.get_int(sizeof(size_t)));
+            consumption_ns = max(consumption_ns, x.get_int(sizeof(size_t)));
+        }
+
+        if (n_items > 0)
+            cost = production_ns * 1e-9 / n_items;
+        if (consumption_ns > 0)
+            rate = n_consumed / (consumption_ns * 1e-9);
+
+        n_consumed = n_items;
+        consumption_timer.start();
+    }
+};
+
+#endif /* PROTOCOLS_BATCHSIZER_H_ */
@@ -6,6 +6,7 @@
 #include "BrainPrep.h"
 #include "Processor/Processor.h"
 #include "Protocols/MaliciousRepMC.h"
+#include "Protocols/MaliciousRepPrep.hpp"
 #include "Tools/Subroutines.h"
 #include "Math/gfp.h"
 
@@ -137,45 +138,52 @@ void BrainPrep<T>::buffer_triples()
                         + to_string(ZProtocol<T>::share_type::clear::N_BITS)
                         + "-bit integer computation");
     typedef Rep3Share<gfp2> pShare;
-    auto buffer_size = BaseMachine::batch_size<T>(DATA_TRIPLE);
+    size_t buffer_size = BaseMachine::batch_size<T>(DATA_TRIPLE);
     Player& P = this->protocol->P;
     vector<array<ZShare<T>, 3>> triples;
-    vector<array<Rep3Share<gfp2>, 3>> check_triples;
+    // modulus switch of the whole batch and the check triples
+    // [a, b, a * b] with a random in the prime field
+    vector<array<pShare, 3>> converted(buffer_size), check_triples(buffer_size);
     DataPositions usage;
     HashMaliciousRepMC<pShare> MC;
-    vector<Rep3Share<gfp2>> masked, checks;
+    vector<pShare> masked(buffer_size), checks(buffer_size);
     vector<gfp2> opened;
     ZProtocol<T> Z_protocol(P);
     Replicated<pShare> p_protocol(P);
     generate_triples(triples, buffer_size, &Z_protocol);
-    check_triples.resize(buffer_size);
+    sacrifice_parallel(buffer_size, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            for (int j = 0; j < 3; j++)
+                converted[i][j] = triples[i][j];
+    });
     p_protocol.init_mul();
-    for (int i = 0; i < buffer_size; i++)
+    for (size_t i = 0; i < buffer_size; i++)
     {
-        pShare a = p_protocol.get_random();
-        pShare b = triples[i][1];
+        auto& a = check_triples[i][0] = p_protocol.get_random();
+        auto& b = check_triples[i][1] = converted[i][1];
         p_protocol.prepare_mul(a, b);
-        check_triples[i][0] = a;
-        check_triples[i][1] = b;
     }
     p_protocol.exchange();
+    for (size_t i = 0; i < buffer_size; i++)
+        check_triples[i][2] = p_protocol.finalize_mul();
     auto t = Create_Random<gfp2>(P);
-    for (int i = 0; i < buffer_size; i++)
+    sacrifice_parallel(buffer_size, [&](size_t begin, size_t end)
     {
-        check_triples[i][2] = p_protocol.finalize_mul();
-        pShare a = triples[i][0];
-        auto& f = check_triples[i][0];
-        masked.push_back(a * t - f);
-    }
+        for (size_t i = begin; i < end; i++)
+            masked[i] = converted[i][0] * t - check_triples[i][0];
+    });
     MC.POpen(opened, masked, P);
-    for (int i = 0; i < buffer_size; i++)
+    sacrifice_parallel(buffer_size, [&](size_t begin, size_t end)
     {
-        auto& b = check_triples[i][1];
-        pShare c = triples[i][2];
-        auto& h = check_triples[i][2];
-        auto& rho = opened[i];
-        checks.push_back(t * c - h - rho * b);
-    }
+        for (size_t i = begin; i < end; i++)
+        {
+            auto& b = check_triples[i][1];
+            auto& c = converted[i][2];
+            auto& h = check_triples[i][2];
+            checks[i] = t * c - h - opened[i] * b;
+        }
+    });
     MC.CheckFor(0, checks, P);
     MC.Check(P);
     for (auto& x : triples)
@@ -15,6 +15,9 @@ class DabitSacrifice
 
     size_t n_masks, n_produced;
 
+    // threads for combining daBits (-o sacrifice_threads)
+    int n_threads;
+
 public:
     DabitSacrifice();
     ~DabitSacrifice();
@@ -10,6 +10,7 @@
 #include "BufferScope.h"
 #include "Tools/PointerVector.h"
 #include "Tools/CodeLocations.h"
+#include "Tools/ParallelJobs.h"
 
 #include <math.h>
 
@@ -18,6 +19,7 @@ DabitSacrifice<T>::DabitSacrifice() :
         S(OnlineOptions::singleton.security_parameter),
         n_masks(0), n_produced()
 {
+    n_threads = ParallelJobs::n_threads("sacrifice_threads");
 }
 
 template<class T>
@@ -49,15 +51,33 @@ void DabitSacrifice<T>::sacrifice_without_bit_check(vector<dabit<T> >& dabits,
     if (T::clear::N_BITS <= 0)
         dynamic_cast<BufferPrep<T>&>(proc.DataF).buffer_extra(DATA_BIT,
                 S * (ceil(log2(n)) + S));
-    for (int i = 0; i < S; i++)
+
+    // random coefficients for all combinations at once
+    size_t row_bytes = DIV_CEIL(S, 8);
+    vector<octet> coeffs(n * row_bytes);
+    G.get_octets(coeffs.data(), coeffs.size());
+
+    // one pass over the daBits for all combinations
+    vector<vector<dabit<T>>> partial_sums(n_threads, vector<dabit<T>>(S));
+    auto job = [&](int k, size_t begin, size_t end)
     {
-        dabit<T> to_check;
-        for (int j = 0; j < n; j++)
+        auto& sums = partial_sums[k];
+        for (size_t j = begin; j < end; j++)
         {
-            if (G.get_bit())
-                to_check += check_dabits[j];
+            auto row = &coeffs[j * row_bytes];
+            for (int i = 0; i < S; i++)
+                if ((row[i / 8] >> (i % 8)) & 1)
+                    sums[i] += check_dabits[j];
         }
-        to_check += check_dabits[n + i];
+    };
+
+    int n_jobs = ParallelJobs::run(n, n_threads, job, 10000);
+
+    for (int i = 0; i < S; i++)
+    {
+        dabit<T> to_check = check_dabits[n + i];
+        for (int k = 0; k < n_jobs; k++)
+            to_check += partial_sums[k][i];
         T masked = to_check.first;
         if (T::clear::N_BITS > 0)
             masked = masked << (T::clear::N_BITS - 1);
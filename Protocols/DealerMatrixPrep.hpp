@@ -4,6 +4,7 @@
  */
 
 #include "DealerMatrixPrep.h"
+#include "DealerPrep.h"
 
 template<class T>
 DealerMatrixPrep<T>::DealerMatrixPrep(int n_rows, int n_inner, int n_cols,
@@ -16,29 +17,19 @@ DealerMatrixPrep<T>::DealerMatrixPrep(int n_rows, int n_inner, int n_cols,
 }
 
 template<class T>
-void append_shares(vector<octetStream>& os,
-        ValueMatrix<typename T::clear>& M, PRNG& G)
+void append_shares(DealerDistribution& distribution,
+        ValueMatrix<typename T::clear>& M)
 {
-    size_t n = os.size();
     for (auto& value : M.entries)
-    {
-        T sum;
-        for (size_t i = 0; i < n - 2; i++)
-        {
-            auto share = G.get<T>();
-            sum += share;
-            share.pack(os[i]);
-        }
-        (value - sum).pack(os[n - 2]);
-    }
+        distribution.share(value);
 }
 
 template<class T>
-ShareMatrix<T> receive_shares(octetStream& o, int n, int m)
+ShareMatrix<T> receive_shares(DealerDistribution& distribution, int n, int m)
 {
     ShareMatrix<T> res(n, m);
     for (size_t i = 0; i < res.entries.size(); i++)
-        res.entries.v.push_back(o.get<T>());
+        res.entries.v.push_back(distribution.get<typename T::clear>());
     return res;
 }
 
@@ -59,19 +50,19 @@ void DealerMatrixPrep<T>::buffer_triples()
         SeededPRNG G;
         ValueMatrix<typename T::clear> A(n_rows, n_inner), B(n_inner, n_cols),
                 C(n_rows, n_cols);
-        for (int i = 0; i < P.num_players() - 1; i++)
-            os[i].reserve(
-                    batch_size * T::size()
-                            * (A.entries.size() + B.entries.size()
-                                    + C.entries.size()));
+        os[P.num_players() - 2].reserve(
+                batch_size * T::size()
+                        * (A.entries.size() + B.entries.size()
+                                + C.entries.size()));
+        DealerDistribution distribution(os);
         for (int i = 0; i < batch_size; i++)
         {
             A.randomize(G);
             B.randomize(G);
             C = A * B;
-            append_shares<T>(os, A, G);
-            append_shares<T>(os, B, G);
-            append_shares<T>(os, C, G);
+            append_shares<T>(distribution, A);
+            append_shares<T>(distribution, B);
+            append_shares<T>(distribution, C);
             this->triples.push_back({{{n_rows, n_inner}, {n_inner, n_cols},
                 {n_rows, n_cols}}});
         }
@@ -80,12 +71,13 @@ void DealerMatrixPrep<T>::buffer_triples()
     else
     {
         P.send_receive_all(senders, os, to_receive);
+        DealerDistribution distribution(P, to_receive.back());
         for (int i = 0; i < batch_size; i++)
         {
-            auto& o = to_receive.back();
-            this->triples.push_back({{receive_shares<T>(o, n_rows, n_inner),
-                receive_shares<T>(o, n_inner, n_cols),
-                receive_shares<T>(o, n_rows, n_cols)}});
+            auto& d = distribution;
+            this->triples.push_back({{receive_shares<T>(d, n_rows, n_inner),
+                receive_shares<T>(d, n_inner, n_cols),
+                receive_shares<T>(d, n_rows, n_cols)}});
         }
     }
 }
@@ -9,6 +9,29 @@
 #include "ReplicatedPrep.h"
 #include "DealerMatrixPrep.h"
 
+/**
+ * Distribution of correlated randomness by the dealer.
+ * All computing parties but the last derive their shares from a seed
+ * per batch, and only the last receives actual values.
+ */
+class DealerDistribution
+{
+    vector<PRNG> prngs;
+    octetStream* correction;
+
+public:
+    // dealer
+    DealerDistribution(octetStreams& os);
+    // computing party
+    DealerDistribution(Player& P, octetStream& os);
+
+    template<class U>
+    void share(const U& value);
+
+    template<class U>
+    U get();
+};
+
 template<class T>
 class DealerPrep : virtual public BitPrep<T>
 {
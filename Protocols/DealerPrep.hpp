@@ -9,6 +9,52 @@
 #include "DealerPrep.h"
 #include "GC/SemiSecret.h"
 
+inline DealerDistribution::DealerDistribution(octetStreams& os) :
+        prngs(os.size() - 2), correction(&os.at(os.size() - 2))
+{
+    for (size_t i = 0; i < prngs.size(); i++)
+    {
+        prngs[i].ReSeed();
+        os[i].append(prngs[i].get_seed(), SEED_SIZE);
+    }
+}
+
+inline DealerDistribution::DealerDistribution(Player& P, octetStream& os) :
+        correction(0)
+{
+    if (P.my_num() < P.num_players() - 2)
+    {
+        prngs.resize(1);
+        prngs[0].SetSeed(os.consume(SEED_SIZE));
+    }
+    else
+        correction = &os;
+}
+
+template<class U>
+void DealerDistribution::share(const U& value)
+{
+    U sum;
+    for (auto& G : prngs)
+        sum += G.get<U>();
+    (value - sum).pack(*correction);
+}
+
+template<class U>
+U DealerDistribution::get()
+{
+    if (correction)
+        return correction->get<U>();
+    else
+        return prngs[0].get<U>();
+}
+
+template<class T>
+T receive_share(DealerDistribution& distribution)
+{
+    return distribution.get<typename T::clear>();
+}
+
 template<class T>
 void DealerPrep<T>::buffer_triples()
 {
@@ -23,20 +69,15 @@ void DealerPrep<T>::buffer_triples()
     if (this->proc->input.is_dealer())
     {
         SeededPRNG G;
-        vector<SemiShare<typename T::clear>> shares(P.num_players() - 1);
+        DealerDistribution distribution(os);
         for (int i = 0; i < buffer_size; i++)
         {
-            T triples[3];
+            typename T::clear triples[3];
             for (int i = 0; i < 2; i++)
-                triples[i] = G.get<T>();
+                triples[i] = G.get<typename T::clear>();
             triples[2] = triples[0] * triples[1];
             for (auto& value : triples)
-            {
-                make_share(shares.data(), typename T::clear(value),
-                        P.num_players() - 1, 0, G);
-                for (int i = 1; i < P.num_players(); i++)
-                    shares.at(i - 1).pack(os[i - 1]);
-            }
+                distribution.share(value);
             this->triples.push_back({});
         }
         P.send_receive_all(senders, os, to_receive);
@@ -44,8 +85,11 @@ void DealerPrep<T>::buffer_triples()
     else
     {
         P.send_receive_all(senders, os, to_receive);
+        DealerDistribution distribution(P, to_receive.back());
         for (int i = 0; i < buffer_size; i++)
-            this->triples.push_back(to_receive.back().get<FixedVec<T, 3>>().get());
+            this->triples.push_back({{receive_share<T>(distribution),
+                receive_share<T>(distribution),
+                receive_share<T>(distribution)}});
     }
 }
 
@@ -76,20 +120,15 @@ void DealerPrep<T>::buffer_inverses(true_type)
     if (this->proc->input.is_dealer())
     {
         SeededPRNG G;
-        vector<SemiShare<typename T::clear>> shares(P.num_players() - 1);
+        DealerDistribution distribution(os);
         for (int i = 0; i < buffer_size; i++)
         {
-            T tuple[2];
+            typename T::clear tuple[2];
             while (tuple[0] == 0)
-                tuple[0] = G.get<T>();
+                tuple[0] = G.get<typename T::clear>();
             tuple[1] = tuple[0].invert();
             for (auto& value : tuple)
-            {
-                make_share(shares.data(), typename T::clear(value),
-                        P.num_players() - 1, 0, G);
-                for (int i = 1; i < P.num_players(); i++)
-                    shares.at(i - 1).pack(os[i - 1]);
-            }
+                distribution.share(value);
             this->inverses.push_back({});
         }
         P.send_receive_all(senders, os, to_receive);
@@ -97,8 +136,10 @@ void DealerPrep<T>::buffer_inverses(true_type)
     else
     {
         P.send_receive_all(senders, os, to_receive);
+        DealerDistribution distribution(P, to_receive.back());
         for (int i = 0; i < buffer_size; i++)
-            this->inverses.push_back(to_receive.back().get<FixedVec<T, 2>>().get());
+            this->inverses.push_back({{receive_share<T>(distribution),
+                receive_share<T>(distribution)}});
     }
 }
 
@@ -115,14 +156,10 @@ void DealerPrep<T>::buffer_bits()
     if (this->proc->input.is_dealer())
     {
         SeededPRNG G;
-        vector<SemiShare<typename T::clear>> shares(P.num_players() - 1);
+        DealerDistribution distribution(os);
         for (int i = 0; i < buffer_size; i++)
         {
-            T bit = G.get_bit();
-            make_share(shares.data(), typename T::clear(bit),
-                    P.num_players() - 1, 0, G);
-            for (int i = 1; i < P.num_players(); i++)
-                shares.at(i - 1).pack(os[i - 1]);
+            distribution.share(typename T::clear(G.get_bit()));
             this->bits.push_back({});
         }
         P.send_receive_all(senders, os, to_receive);
@@ -130,8 +167,9 @@ void DealerPrep<T>::buffer_bits()
     else
     {
         P.send_receive_all(senders, os, to_receive);
+        DealerDistribution distribution(P, to_receive.back());
         for (int i = 0; i < buffer_size; i++)
-            this->bits.push_back(to_receive.back().get<T>());
+            this->bits.push_back(receive_share<T>(distribution));
     }
 }
 
@@ -148,20 +186,12 @@ void DealerPrep<T>::buffer_dabits(ThreadQueues*)
     if (this->proc->input.is_dealer())
     {
         SeededPRNG G;
-        vector<SemiShare<typename T::clear>> shares(P.num_players() - 1);
-        vector<GC::SemiSecret> bit_shares(P.num_players() - 1);
+        DealerDistribution distribution(os);
         for (int i = 0; i < buffer_size; i++)
         {
             auto bit = G.get_bit();
-            make_share(shares.data(), typename T::clear(bit),
-                    P.num_players() - 1, 0, G);
-            make_share(bit_shares.data(), typename T::bit_type::clear(bit),
-                    P.num_players() - 1, 0, G);
-            for (int i = 1; i < P.num_players(); i++)
-            {
-                shares.at(i - 1).pack(os[i - 1]);
-                bit_shares.at(i - 1).pack(os[i - 1]);
-            }
+            distribution.share(typename T::clear(bit));
+            distribution.share(typename T::bit_type::clear(bit));
             this->dabits.push_back({});
         }
         P.send_receive_all(senders, os, to_receive);
@@ -169,10 +199,12 @@ void DealerPrep<T>::buffer_dabits(ThreadQueues*)
     else
     {
         P.send_receive_all(senders, os, to_receive);
+        DealerDistribution distribution(P, to_receive.back());
         for (int i = 0; i < buffer_size; i++)
         {
-            this->dabits.push_back({to_receive.back().get<T>(),
-                to_receive.back().get<typename T::bit_type>()});
+            auto a = receive_share<T>(distribution);
+            this->dabits.push_back({a,
+                receive_share<typename T::bit_type>(distribution)});
         }
     }
 }
@@ -216,25 +248,16 @@ void DealerPrep<T>::buffer_edabits(int length, false_type)
     if (this->proc->input.is_dealer())
     {
         SeededPRNG G;
-        vector<SemiShare<typename T::clear>> shares(P.num_players() - 1);
-        vector<GC::SemiSecret> bit_shares(P.num_players() - 1);
+        DealerDistribution distribution(os);
         for (int i = 0; i < n_vecs; i++)
         {
             vector<typename T::clear> as;
             vector<typename T::bit_type::part_type::clear> bs;
             plain_edabits(as, bs, length, G, edabitvec<T>::MAX_SIZE);
             for (auto& a : as)
-            {
-                make_share(shares.data(), a, P.num_players() - 1, 0, G);
-                for (int i = 1; i < P.num_players(); i++)
-                    shares.at(i - 1).pack(os[i - 1]);
-            }
+                distribution.share(a);
             for (auto& b : bs)
-            {
-                make_share(bit_shares.data(), b, P.num_players() - 1, 0, G);
-                for (int i = 1; i < P.num_players(); i++)
-                    bit_shares.at(i - 1).pack(os[i - 1]);
-            }
+                distribution.share(b);
             buffer.push_back({});
             buffer.back().a.resize(edabitvec<T>::MAX_SIZE);
             buffer.back().b.resize(length);
@@ -244,14 +267,15 @@ void DealerPrep<T>::buffer_edabits(int length, false_type)
     else
     {
         P.send_receive_all(senders, os, to_receive);
+        DealerDistribution distribution(P, to_receive.back());
         for (int i = 0; i < n_vecs; i++)
         {
             buffer.push_back({});
             for (int j = 0; j < edabitvec<T>::MAX_SIZE; j++)
-                buffer.back().a.push_back(to_receive.back().get<typename T::clear>());
+                buffer.back().a.push_back(receive_share<T>(distribution));
             for (int j = 0; j < length; j++)
                 buffer.back().b.push_back(
-                        to_receive.back().get<typename T::bit_type::part_type::clear>());
+                        distribution.get<typename T::bit_type::part_type::clear>());
         }
     }
 }
@@ -12,8 +12,10 @@
 #include "Processor/Instruction.h"
 #include "Processor/TruncPrTuple.h"
 #include "FHE/tools.h"
+#include "Math/ring_vectors.h"
 
 #include <cmath>
+#include <thread>
 
 template<class T>
 class FakeShuffle
@@ -35,7 +37,7 @@ public:
 
     size_t generate(size_t, store_type& store)
     {
-        return store.add();
+        return store.add(0);
     }
 
     void apply(StackedVector<T>& a, size_t n, size_t unit_size, size_t output_base,
@@ -86,7 +88,10 @@ class FakeProtocol : public ProtocolBase<T>
 
     T trunc_max;
 
-    int fails;
+    int fails, n_threads;
+
+    // only collect statistics if they are output
+    bool verbose;
 
     vector<vector<size_t>> trunc_stats;
 
@@ -102,11 +107,14 @@ public:
             fails(0), trunc_stats(T::MAX_N_BITS + 1,
                     vector<size_t>(T::MAX_N_BITS + 1)), P(P)
     {
+        auto& opts = OnlineOptions::singleton;
+        verbose = opts.has_option("verbose_fake");
+        n_threads = max(1, stoi(opts.option_value("matmul_threads", "1")));
     }
 
     ~FakeProtocol()
     {
-        if (not OnlineOptions::singleton.has_option("verbose_fake"))
+        if (not verbose)
             return;
 
         output_trunc_max<0>(T::invertible);
@@ -221,6 +229,84 @@ public:
         return 1;
     }
 
+    /// Product of matrices given as views into ``C`` (row-major)
+    template<class U, class V>
+    void matmul(T* C, size_t n_rows, size_t n_inner, size_t n_cols,
+            const U& a, const V& b)
+    {
+        vector<T> A(n_rows * n_inner), B(n_inner * n_cols);
+        for (size_t i = 0; i < n_rows; i++)
+            for (size_t k = 0; k < n_inner; k++)
+                A[i * n_inner + k] = a(i, k);
+        for (size_t k = 0; k < n_inner; k++)
+            for (size_t j = 0; j < n_cols; j++)
+                B[k * n_cols + j] = b(k, j);
+        for (size_t i = 0; i < n_rows * n_cols; i++)
+            C[i] = {};
+
+        auto job = [&](size_t begin, size_t end)
+        {
+            if constexpr (ring_words<T>() == 1)
+                ring_gemm((uint64_t*) C + begin * n_cols,
+                        (uint64_t*) A.data() + begin * n_inner,
+                        (uint64_t*) B.data(), end - begin, n_inner, n_cols);
+            else
+                for (size_t i = begin; i < end; i++)
+                    for (size_t k = 0; k < n_inner; k++)
+                    {
+                        auto& x = A[i * n_inner + k];
+                        for (size_t j = 0; j < n_cols; j++)
+                            C[i * n_cols + j] += x * B[k * n_cols + j];
+                    }
+        };
+
+        // threads only pay off for large products
+        size_t n_jobs = min(size_t(n_threads), n_rows);
+        if (n_rows * n_inner * n_cols < (1 << 20) or n_jobs == 0)
+            n_jobs = 1;
+        vector<thread> threads;
+        for (size_t i = 1; i < n_jobs; i++)
+            threads.push_back(
+                    thread(job, n_rows * i / n_jobs, n_rows * (i + 1) / n_jobs));
+        job(0, n_rows / n_jobs);
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    template<int = 0>
+    void matmuls(SubProcessor<T>& proc, const StackedVector<T>& source,
+            const Instruction& instruction)
+    {
+        auto& start = instruction.get_start();
+        assert(start.size() % 6 == 0);
+        for (auto it = start.begin(); it < start.end(); it += 6)
+        {
+            auto dim = it + 3;
+            auto A = source.begin() + *(it + 1);
+            auto B = source.begin() + *(it + 2);
+            assert(A + dim[0] * dim[1] <= source.end());
+            assert(B + dim[1] * dim[2] <= source.end());
+            assert(proc.get_S().begin() + *it + dim[0] * dim[2] <= proc.get_S().end());
+            matmul(&proc.get_S()[*it], dim[0], dim[1], dim[2],
+                    row_major_view(&*A, dim[1]), row_major_view(&*B, dim[2]));
+        }
+    }
+
+    template<int = 0>
+    void matmulsm(SubProcessor<T>& proc, MemoryPart<T>& source,
+            const Instruction& instruction)
+    {
+        auto& start = instruction.get_start();
+        assert(start.size() % 12 == 0);
+        for (auto it = start.begin(); it < start.end(); it += 12)
+        {
+            auto A = proc.matmulsm_view(source, it, 0);
+            auto B = proc.matmulsm_view(source, it, 1);
+            assert(proc.get_S().begin() + it[0] + it[3] * it[5] <= proc.get_S().end());
+            matmul(&proc.get_S()[it[0]], it[3], it[4], it[5], A, B);
+        }
+    }
+
     template<int = 0>
     void trunc_pr(const vector<int>&, int, SubProcessor<T>&, true_type)
     {
@@ -238,7 +324,8 @@ public:
                 auto& source = proc.get_S_ref(regs[i + 1] + l);
                 T tmp = source;
                 tmp = tmp < T() ? (T() - tmp) : tmp;
-                trunc_max = max(trunc_max, tmp);
+                if (verbose)
+                    trunc_max = max(trunc_max, tmp);
 #ifdef TRUNC_PR_EMULATION_STATS
                 trunc_stats.at(regs[i + 2]).at(tmp == T() ? 0 : tmp.bit_length())++;
 #endif
@@ -325,13 +412,15 @@ public:
     {
         int r0 = instruction.get_r(0);
         string tag((char*)&r0, 4);
-        cisc_stats[tag.c_str()]++;
+        if (verbose)
+            cisc_stats[tag.c_str()]++;
         auto& args = instruction.get_start();
         if (tag == string("LTZ\0", 4))
         {
             for (size_t i = 0; i < args.size(); i += args[i])
             {
-                ltz_stats[args[i + 4]] += args[i + 1];
+                if (verbose)
+                    ltz_stats[args[i + 4]] += args[i + 1];
                 assert(i + args[i] <= args.size());
                 assert(args[i] >= 5);
                 for (int j = 0; j < args[i + 1]; j++)
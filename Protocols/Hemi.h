@@ -42,6 +42,7 @@ public:
 
     void matmulsm(SubProcessor<T>& processor, MemoryPart<T>& source,
             const Instruction& instruction);
+    void mulrs(const vector<int>& reg, SubProcessor<T>& processor);
     void conv2ds(SubProcessor<T>& processor, const Instruction& instruction);
 };
 
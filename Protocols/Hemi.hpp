@@ -184,6 +184,52 @@ void Hemi<T>::matmulsm(SubProcessor<T>& processor, MemoryPart<T>& source,
     }
 }
 
+/**
+ * Vector times scalar as matrix product with a column vector, which
+ * uses triples with the same mask for the scalar and thus only opens
+ * it once per vector
+ */
+template<class T>
+void Hemi<T>::mulrs(const vector<int>& reg, SubProcessor<T>& processor)
+{
+    CODE_LOCATION
+    assert(reg.size() % 4 == 0);
+    vector<int> plain_args;
+    auto& S = processor.get_S();
+    bool for_real = T::real_shares(processor.P);
+
+    for (auto it = reg.begin(); it < reg.end(); it += 4)
+    {
+        int n = it[0];
+        if (n < 2 or use_plain_matmul({{n, 1, 1}}, processor))
+        {
+            plain_args.insert(plain_args.end(), it, it + 4);
+            continue;
+        }
+
+        ShareMatrix<T> A(n, 1), B(1, 1);
+        if (for_real)
+        {
+            assert(S.begin() + it[2] + n <= S.end());
+            A.entries.v.insert(A.entries.v.end(), S.begin() + it[2],
+                    S.begin() + it[2] + n);
+            B.entries.v.push_back(S.at(it[3]));
+        }
+
+        auto res = matrix_multiply(A, B, processor);
+
+        if (for_real)
+        {
+            assert(S.begin() + it[1] + n <= S.end());
+            for (int i = 0; i < n; i++)
+                S[it[1] + i] = res[{i, 0}];
+        }
+    }
+
+    if (not plain_args.empty())
+        processor.mulrs(plain_args);
+}
+
 template<class T>
 ShareMatrix<T> Hemi<T>::matrix_multiply(const ShareMatrix<T>& A,
         const ShareMatrix<T>& B, SubProcessor<T>& processor)
@@ -273,12 +319,6 @@ void Hemi<T>::conv2ds(SubProcessor<T>& processor,
         tuple.run_matrix(processor);
 }
 
-inline
-array<int, 3> Conv2dTuple::matrix_dimensions()
-{
-    return {1, weights_h * weights_w * n_channels_in, batch_size * output_h * output_w};
-}
-
 template<class T>
 void Conv2dTuple::run_matrix(SubProcessor<T>& processor)
 {
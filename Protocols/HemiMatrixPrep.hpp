@@ -11,6 +11,8 @@
 #include "FHE/Diagonalizer.h"
 #include "Tools/Bundle.h"
 
+#include <thread>
+
 class CipherPlainMultJob : public ThreadJob
 {
 public:
@@ -106,6 +108,17 @@ void HemiMatrixPrep<T>::buffer_triples()
     auto& pk = prep->get_pk();
     int n_matrices = minimum_batch();
 
+    // -o he_threads replaces the computation threads as helpers
+    auto& opts = OnlineOptions::singleton;
+    string he_threads = opts.option_value("he_threads");
+    bool own_threads = opts.has_option("he_threads") or not he_threads.empty();
+    int n_threads = 1;
+    if (own_threads)
+        n_threads = max(1, he_threads.empty() ?
+                int(thread::hardware_concurrency()) : stoi(he_threads));
+    bool use_queues = not own_threads and BaseMachine::thread_num == 0
+            and BaseMachine::has_singleton();
+
     if (OnlineOptions::singleton.has_option("verbose_he"))
     {
         fprintf(stderr, "creating %d %dx%d * %dx%d triples\n", n_matrices,
@@ -142,7 +155,7 @@ void HemiMatrixPrep<T>::buffer_triples()
     fflush(stderr);
 #endif
 
-    Diagonalizer diag(A, FTD, pk);
+    Diagonalizer diag(A, FTD, pk, n_threads);
 
     vector<Plaintext_<FFT_Data>> products(n_cols, FTD);
     assert(prep->proc);
@@ -177,7 +190,7 @@ void HemiMatrixPrep<T>::buffer_triples()
 #endif
             Ciphertext C(pk);
             auto& multiplicands = m->get_multiplicands(others_ct, pk);
-            if (BaseMachine::thread_num == 0 and BaseMachine::has_singleton())
+            if (use_queues)
             {
                 auto& queues = BaseMachine::s().queues;
                 vector<Ciphertext> products(n_inner, pk);
@@ -202,8 +215,7 @@ void HemiMatrixPrep<T>::buffer_triples()
                     C += products[i];
             }
             else
-                for (int i = 0; i < n_inner; i++)
-                    C += multiplicands.at(i) * diag.get_plaintext(B, i, j);
+                C = diag.multiply(multiplicands, B, j, pk, n_threads);
 
 #ifdef VERBOSE_HE
             fprintf(stderr, "adding column %d with party offset %d at %f\n", j,
@@ -229,6 +241,14 @@ void HemiMatrixPrep<T>::buffer_triples()
     fprintf(stderr, "done at %f\n", timer.elapsed());
     fflush(stderr);
 #endif
+
+    if (OnlineOptions::singleton.has_option("verbose_he"))
+    {
+        fprintf(stderr, "%d %dx%d * %dx%d triples in %f seconds "
+                "(%f per second)\n", n_matrices, n_rows, n_inner, n_inner,
+                n_cols, timer.elapsed(), n_matrices / timer.elapsed());
+        fflush(stderr);
+    }
 }
 
 #endif
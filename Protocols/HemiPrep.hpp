@@ -105,12 +105,27 @@ void HemiPrep<T>::buffer_triples()
     b.randomize(G);
     c.mul(a, b);
     Bundle<octetStream> bundle(P);
-    pairwise_machine->pk.encrypt(a).pack(bundle.mine);
+    auto& pk = pairwise_machine->pk;
+    // own key, so the ciphertext can be compressed using a seed
+    bool seeded = pk.get_params().n_mults() == 0;
+    if (seeded)
+    {
+        SeededPRNG seed_prng;
+        auto seed = seed_prng.get_seed();
+        pairwise_machine->sk.encrypt(a, pk, seed).pack_seeded(bundle.mine,
+                seed);
+    }
+    else
+        pk.encrypt(a).pack(bundle.mine);
     P.unchecked_broadcast(bundle);
-    Ciphertext C(pairwise_machine->pk);
+    Ciphertext C(pk);
     for (auto m : multipliers)
     {
-        C.unpack(bundle[P.get_player(-m->get_offset())]);
+        auto& os = bundle[P.get_player(-m->get_offset())];
+        if (seeded)
+            C.unpack_seeded(os);
+        else
+            C.unpack(os);
         m->multiply_and_add(c, C, b);
     }
     assert(b.num_slots() == a.num_slots());
@@ -99,15 +99,22 @@ void HighGearKeyGen<L, M>::run(PartSetup<FD>& setup, MachineBase& machine)
 
     vector_type0 sk0;
     vector_type1 sk1;
-    proto0.secret_key(sk0, factory0);
-    proto1.secret_key(sk1, factory1);
+    proto0.secret_key(sk0, factory0, false);
+    proto1.secret_key(sk1, factory1, false);
 
     vector_type0 e0, e0_prime;
     vector_type1 e1, e1_prime;
-    proto0.binomial(e0, factory0);
-    proto0.binomial(e0_prime, factory0);
-    proto1.binomial(e1, factory1);
-    proto1.binomial(e1_prime, factory1);
+    proto0.binomial(e0, factory0, false);
+    proto0.binomial(e0_prime, factory0, false);
+    proto1.binomial(e1, factory1, false);
+    proto1.binomial(e1_prime, factory1, false);
+
+    // local transforms for both primes at once
+    thread fft1([&]() {
+        Proto1::fft({{&proto1, &sk1}, {&proto1, &e1}, {&proto1, &e1_prime}});
+    });
+    Proto0::fft({{&proto0, &sk0}, {&proto0, &e0}, {&proto0, &e0_prime}});
+    fft1.join();
 
     auto f0 = sk0;
     auto f0_prime = proto0.schur_product(f0, f0);
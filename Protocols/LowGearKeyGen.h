@@ -14,6 +14,8 @@
 #include "Math/gfp.h"
 #include "Math/gfpvar.h"
 
+#include <thread>
+
 /**
  * Homomorphic key component generation (modulo a prime) using MASCOT
  */
@@ -27,6 +29,9 @@ public:
 
     int backup_batch_size;
 
+    /// Transform several vectors at once
+    static void fft(const vector<pair<KeyGenProtocol*, vector_type*>>& jobs);
+
 protected:
     Player& P;
     const FHE_Params& params;
@@ -50,9 +55,10 @@ public:
 
     void input(vector<vector_type>& shares, const Rq_Element& secret);
     template<class T>
-    void binomial(vector_type& shares, T& prep);
+    void binomial(vector_type& shares, T& prep, bool transform = true);
     template<class T>
-    void secret_key(vector_type& shares, T& prep);
+    void secret_key(vector_type& shares, T& prep, bool transform = true);
+    void fft(vector_type& shares);
     vector_type schur_product(const vector_type& x, const vector_type& y);
     void output_to(int player, vector<open_type>& opened,
             vector<share_type>& shares);
@@ -29,7 +29,9 @@ KeyGenProtocol<X, L>::KeyGenProtocol(Player& P, const FHE_Params& params,
 
     auto& batch_size = OnlineOptions::singleton.batch_size;
     backup_batch_size = batch_size;
-    batch_size = min(100, batch_size);
+    batch_size = min(max(1,
+            stoi(OnlineOptions::singleton.option_value("keygen_batch_size",
+                    "100"))), batch_size);
 
     if (OnlineOptions::singleton.live_prep)
     {
@@ -91,7 +93,8 @@ void KeyGenProtocol<X, L>::input(vector<vector_type>& shares, const Rq_Element&
  */
 template<int X, int L>
 template<class T>
-void KeyGenProtocol<X, L>::binomial(vector_type& shares, T& prep)
+void KeyGenProtocol<X, L>::binomial(vector_type& shares, T& prep,
+        bool transform)
 {
     shares.resize(params.phi_m());
     RunningTimer timer, total;
@@ -114,16 +117,35 @@ void KeyGenProtocol<X, L>::binomial(vector_type& shares, T& prep)
             share -= prep.get_bit();
         }
     }
-    shares.fft(fftd);
+    if (transform)
+        fft(shares);
 }
 
 template<int X, int L>
 template<class T>
-void KeyGenProtocol<X, L>::secret_key(vector_type& shares, T& prep)
+void KeyGenProtocol<X, L>::secret_key(vector_type& shares, T& prep,
+        bool transform)
 {
     cerr << "Generate secret key by ";
     cerr << "binomial" << endl;
-    binomial(shares, prep);
+    binomial(shares, prep, transform);
+}
+
+template<int X, int L>
+void KeyGenProtocol<X, L>::fft(vector_type& shares)
+{
+    shares.fft(fftd);
+}
+
+template<int X, int L>
+void KeyGenProtocol<X, L>::fft(
+        const vector<pair<KeyGenProtocol*, vector_type*>>& jobs)
+{
+    vector<thread> threads;
+    for (auto& job : jobs)
+        threads.push_back(thread([job]() { job.first->fft(*job.second); }));
+    for (auto& thread : threads)
+        thread.join();
 }
 
 template<int X, int L>
@@ -166,14 +188,14 @@ void LowGearKeyGen<L>::generate_keys(FHE_Params& params)
 
     for (int i = 0; i < P.num_players(); i++)
     {
-        vector_type sk;
-        this->secret_key(sk, *this);
+        vector_type sk, e0;
+        this->secret_key(sk, *this, false);
+        this->binomial(e0, *this, false);
+        super::fft({{this, &sk}, {this, &e0}});
         vector<open_type> open_sk;
         this->output_to(i, open_sk, sk);
         if (P.my_num() == i)
             machine.sk.assign(Ring_Element(FFTD, evaluation, open_sk));
-        vector_type e0;
-        this->binomial(e0, *this);
         AddableVector<open_type> a0(pk.get_params().phi_m());
         a0.randomize(global_prng);
         vector<open_type> b0;
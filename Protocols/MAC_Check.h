@@ -48,6 +48,8 @@ protected:
   octetStream os;
 
   vector<int> lengths;
+  // received values in summing phase
+  vector<T> summands;
 
   void ReceiveValues(vector<T>& values, const Player& P, int sender);
   virtual void AddToValues(vector<T>& values) { (void)values; }
@@ -280,7 +282,7 @@ void TreeSum<T>::add_openings(vector<T>& values, const Player& P,
   oss.resize(P.num_players());
   vector<int> senders;
   senders.reserve(P.num_players());
-  bool use_lengths = values.size() == lengths.size();
+  const int* lens = values.size() == lengths.size() ? lengths.data() : 0;
 
   for (int relative_sender = positive_modulo(P.my_num() - send_player, P.num_players()) + sum_players;
       relative_sender < last_sum_players; relative_sender += sum_players)
@@ -299,12 +301,10 @@ void TreeSum<T>::add_openings(vector<T>& values, const Player& P,
       P.wait_receive(sender, oss[j]);
       MC.player_timers[sender].stop();
       MC.timers[SUM].start();
-      T tmp = values.at(0);
+      summands.resize(values.size(), values.at(0));
+      oss[j].get_range(summands.data(), values.size(), lens);
       for (unsigned int i=0; i<values.size(); i++)
-        {
-          tmp.unpack(oss[j], use_lengths ? lengths[i] : -1);
-          values[i] += tmp;
-        }
+        values[i] += summands[i];
       post_add_process(values);
       MC.timers[SUM].stop();
     }
@@ -322,7 +322,7 @@ void TreeSum<T>::start(vector<T>& values, const Player& P)
   os.reset_write_head();
   int sum_players = P.num_players();
   int my_relative_num = positive_modulo(P.my_num() - base_player, P.num_players());
-  bool use_lengths = values.size() == lengths.size();
+  const int* lens = values.size() == lengths.size() ? lengths.data() : 0;
   while (true)
     {
       // summing phase
@@ -333,8 +333,7 @@ void TreeSum<T>::start(vector<T>& values, const Player& P)
       if (my_relative_num >= sum_players && my_relative_num < last_sum_players)
         {
           // send to the player up the tree
-          for (unsigned int i=0; i<values.size(); i++)
-            values[i].pack(os, use_lengths ? lengths[i] : -1);
+          os.store_range(values.data(), values.size(), lens);
           os.append(0);
           int receiver = positive_modulo(base_player + my_relative_num % sum_players, P.num_players());
           timers[SEND].start();
@@ -355,9 +354,7 @@ void TreeSum<T>::start(vector<T>& values, const Player& P)
     {
       // send from the root player
       os.reset_write_head();
-      size_t n = values.size();
-      for (unsigned int i=0; i<n; i++)
-        values[i].pack(os, use_lengths ? lengths[i] : -1);
+      os.store_range(values.data(), values.size(), lens);
       os.append(0);
       timers[BCAST].start();
       for (int i = 1; i < max_broadcast && i < P.num_players(); i++)
@@ -404,9 +401,8 @@ void TreeSum<T>::ReceiveValues(vector<T>& values, const Player& P, int sender)
   timers[RECV_SUM].start();
   P.receive_player(sender, os);
   timers[RECV_SUM].stop();
-  bool use_lengths = values.size() == lengths.size();
-  for (unsigned int i = 0; i < values.size(); i++)
-    values[i].unpack(os, use_lengths ? lengths[i] : -1);
+  const int* lens = values.size() == lengths.size() ? lengths.data() : 0;
+  os.get_range(values.data(), values.size(), lens);
   AddToValues(values);
 }
 
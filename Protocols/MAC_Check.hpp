@@ -10,6 +10,9 @@
 #include "Tools/int.h"
 #include "Tools/benchmarking.h"
 #include "Tools/Bundle.h"
+#include "Processor/Metrics.h"
+#include "Processor/Trace.h"
+#include "Math/ring_vectors.h"
 
 #include <algorithm>
 
@@ -128,7 +131,11 @@ void Tree_MAC_Check<U>::AddToValues(vector<T>& values)
 template<class T>
 void Tree_MAC_Check<T>::CheckIfNeeded(const Player& P)
 {
-  if (WaitingForCheck() >= POPEN_MAX)
+  size_t max_waiting = POPEN_MAX;
+  if (OnlineOptions::singleton.mac_check_buffer)
+    max_waiting = (size_t(OnlineOptions::singleton.mac_check_buffer) << 20)
+        / (sizeof(T) + sizeof(macs.front()));
+  if (size_t(WaitingForCheck()) >= max(max_waiting, size_t(1)))
     Check(P);
 }
 
@@ -162,6 +169,9 @@ void MAC_Check_<U>::Check(const Player& P)
   if (this->WaitingForCheck() == 0)
     return;
 
+  Metrics::count_mac_check();
+  Trace::Span span("MAC check", Trace::CHECK);
+
   //cerr << "In MAC Check : " << popen_cnt << endl;
 
   CODE_LOCATION
@@ -175,7 +185,7 @@ void MAC_Check_<U>::Check(const Player& P)
     {
       // no random combination with few values
       vector<typename U::mac_type> deltas;
-      Bundle<octetStream> bundle(P);
+      PooledBundle bundle(P);
       for (int i = 0; i < popen_cnt; i++)
         {
           deltas.push_back(vals[i] * this->alphai - macs[i]);
@@ -205,17 +215,31 @@ void MAC_Check_<U>::Check(const Player& P)
 
       U sj;
       typename U::mac_type a,gami,temp;
-      typename U::mac_type::Scalar h;
+      vector<typename U::mac_type::Scalar> h(popen_cnt);
       vector<typename U::mac_type> tau(P.num_players());
-      for (int i=0; i<popen_cnt; i++)
-        {
-          h.almost_randomize(G);
-          temp = vals[i] * h;
-          a = (a + temp);
+      for (auto& x : h)
+        x.almost_randomize(G);
 
-          temp = h * macs[i];
-          gami = (gami + temp);
+      // batched for prime fields
+      if constexpr (is_same<typename U::open_type, typename U::mac_type>::value)
+        {
+          vector<typename U::mac_type> products(popen_cnt);
+          vector_mul(products.data(), vals.data(), h.data(), popen_cnt);
+          for (auto& x : products)
+            a += x;
+          vector_mul(products.data(), macs.data(), h.data(), popen_cnt);
+          for (auto& x : products)
+            gami += x;
         }
+      else
+        for (int i=0; i<popen_cnt; i++)
+          {
+            temp = vals[i] * h[i];
+            a = (a + temp);
+
+            temp = h[i] * macs[i];
+            gami = (gami + temp);
+          }
 
       temp = this->alphai * a;
       tau[P.my_num()] = (gami - temp);
@@ -303,6 +327,9 @@ void MAC_Check_Z2k<T, U, V, W>::Check(const Player& P)
   if (this->WaitingForCheck() == 0)
     return;
 
+  Metrics::count_mac_check();
+  Trace::Span span("MAC check", Trace::CHECK);
+
   CODE_LOCATION
 #ifdef DEBUG_MAC
   cout << "Checking " << shares[0] << " " << this->vals[0] << " " << this->macs[0] << endl;
@@ -313,18 +340,11 @@ void MAC_Check_Z2k<T, U, V, W>::Check(const Player& P)
   PRNG G;
   G.SetSeed(seed);
 
-  T y, mj;
-  y.assign_zero();
-  mj.assign_zero();
-  for (int i = 0; i < this->popen_cnt; ++i)
-  {
-    U temp_chi;
-    temp_chi.randomize(G);
-    T xi = this->vals[i];
-    y += xi * temp_chi;
-    T mji = this->macs[i];
-    mj += temp_chi * mji;
-  }
+  vector<U> chi(this->popen_cnt);
+  for (auto& x : chi)
+    x.randomize(G);
+  T y = vector_dot(this->vals.data(), chi.data(), this->popen_cnt);
+  T mj = vector_dot(this->macs.data(), chi.data(), this->popen_cnt);
 
   T zj = mj - this->alphai * y;
   vector<T> zjs(P.num_players());
@@ -386,8 +406,7 @@ void Direct_MAC_Check<T>::pre_exchange(const Player& P)
   oss[P.my_num()].reset_write_head();
   oss[P.my_num()].reserve(this->values.size() * T::open_type::size());
 
-  for (auto& x : this->values)
-    x.pack(oss[P.my_num()]);
+  oss[P.my_num()].store_range(this->values.data(), this->values.size());
   oss[P.my_num()].append(0);
 }
 
@@ -195,43 +195,49 @@ void TripleShuffleSacrifice<T>::triple_sacrifice(vector<array<T, 3>>& triples,
     cerr << "sacrificing triples " << begin << " to " << end << endl;
 #endif
     // sacrifice buckets
-    vector<T> masked;
     int buffer_size = check_triples.size();
     int N = buffer_size / B;
     int size = end - begin;
-    masked.reserve(2 * size);
+    vector<T> masked(2 * (B - 1) * size);
     assert(size_t(end * B) <= check_triples.size());
-    for (int i = begin; i < end; i++)
+    run_parallel(size, [&](size_t first, size_t last)
     {
-        T& a = check_triples[i][0];
-        T& b = check_triples[i][1];
-        for (int j = 1; j < B; j++)
+        auto it = masked.begin() + 2 * (B - 1) * first;
+        for (size_t i = begin + first; i < begin + last; i++)
         {
-            T& f = check_triples[i + N * j][0];
-            T& g = check_triples[i + N * j][1];
-            masked.push_back(a - f);
-            masked.push_back(b - g);
+            T& a = check_triples[i][0];
+            T& b = check_triples[i][1];
+            for (int j = 1; j < B; j++)
+            {
+                T& f = check_triples[i + N * j][0];
+                T& g = check_triples[i + N * j][1];
+                *(it++) = a - f;
+                *(it++) = b - g;
+            }
         }
-    }
+    });
     vector<typename T::open_type> opened;
     MC.POpen(opened, masked, P);
-    auto it = opened.begin();
-    vector<T> checks;
-    checks.reserve(2 * size);
-    for (int i = begin; i < end; i++)
+    vector<T> checks((B - 1) * size);
+    run_parallel(size, [&](size_t first, size_t last)
     {
-        T& b = check_triples[i][1];
-        T& c = check_triples[i][2];
-        for (int j = 1; j < B; j++)
+        auto it = opened.begin() + 2 * (B - 1) * first;
+        auto check = checks.begin() + (B - 1) * first;
+        for (size_t i = begin + first; i < begin + last; i++)
         {
-            T& f = check_triples[i + N * j][0];
-            T& h = check_triples[i + N * j][2];
-            typename T::open_type& rho = *(it++);
-            typename T::open_type& sigma = *(it++);
-            checks.push_back(c - h - b * rho - f * sigma);
+            T& b = check_triples[i][1];
+            T& c = check_triples[i][2];
+            for (int j = 1; j < B; j++)
+            {
+                T& f = check_triples[i + N * j][0];
+                T& h = check_triples[i + N * j][2];
+                typename T::open_type& rho = *(it++);
+                typename T::open_type& sigma = *(it++);
+                *(check++) = c - h - b * rho - f * sigma;
+            }
+            triples[i] = check_triples[i];
         }
-        triples[i] = check_triples[i];
-    }
+    });
     MC.CheckFor(0, checks, P);
 }
 
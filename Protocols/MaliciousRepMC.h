@@ -57,6 +57,9 @@ class HashMaliciousRepMC : public MaliciousRepMC<T>
 
     bool needs_checking;
 
+    // threads for hashing large batches (-o hash_threads)
+    int n_threads;
+
     void reset();
     void update();
 
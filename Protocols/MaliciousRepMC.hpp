@@ -9,6 +9,9 @@
 #include "MaliciousRepMC.h"
 #include "GC/Machine.h"
 #include "Math/BitVec.h"
+#include "Processor/Metrics.h"
+#include "Processor/OnlineOptions.h"
+#include "Processor/Trace.h"
 
 #include "ReplicatedMC.hpp"
 #include "MAC_Check_Base.hpp"
@@ -25,6 +28,8 @@ void MaliciousRepMC<T>::POpen_Begin(vector<typename T::open_type>& values,
 template<class T>
 HashMaliciousRepMC<T>::HashMaliciousRepMC()
 {
+    n_threads = max(1,
+            stoi(OnlineOptions::singleton.option_value("hash_threads", "1")));
     reset();
 }
 
@@ -74,6 +79,18 @@ typename T::open_type HashMaliciousRepMC<T>::finalize_raw()
 template<class T>
 void HashMaliciousRepMC<T>::finalize(const vector<typename T::open_type>& values)
 {
+    typedef typename T::open_type open_type;
+
+    // same bytes as packing without copying
+    if constexpr (flat_packing(static_cast<const open_type*>(nullptr)))
+        if (size_t(open_type::size()) == sizeof(open_type))
+        {
+            hash.update_chunked(values.data(), values.size() * sizeof(open_type),
+                    n_threads);
+            needs_checking = true;
+            return;
+        }
+
     os.reset_write_head();
     os.reserve(values.size() * T::open_type::size());
     for (auto& value : values)
@@ -84,7 +101,7 @@ void HashMaliciousRepMC<T>::finalize(const vector<typename T::open_type>& values
 template<class T>
 void HashMaliciousRepMC<T>::update()
 {
-    hash.update(os);
+    hash.update_chunked(os, n_threads);
     needs_checking = true;
 }
 
@@ -116,6 +133,8 @@ void HashMaliciousRepMC<T>::Check(const Player& P)
 {
     if (needs_checking)
     {
+        Metrics::count_mac_check();
+        Trace::Span span("MAC check", Trace::CHECK);
         CODE_LOCATION
         vector<octetStream> os(P.num_players());
         hash.final(os[P.my_num()]);
@@ -9,6 +9,7 @@
 #include "MaliciousRepPrep.h"
 #include "BufferScope.h"
 #include "Tools/Subroutines.h"
+#include "Tools/ParallelJobs.h"
 #include "Processor/OnlineOptions.h"
 
 #include "mac_key.hpp"
@@ -109,33 +110,42 @@ void MaliciousRepPrep<T>::buffer_triples()
         triples.push_back({{tuple[0], tuple[2], tuple[3]}});
 }
 
+template<class U>
+void sacrifice_parallel(size_t n, const U& job)
+{
+    ParallelJobs::run(n, ParallelJobs::n_threads("sacrifice_threads"),
+            [&](int, size_t begin, size_t end) { job(begin, end); }, 1 << 12);
+}
+
 template<class T, class U>
 void sacrifice(const vector<array<T, 5>>& check_triples, Player& P)
 {
     CODE_LOCATION
     check_field_size<U>();
-    vector<T> masked, checks;
-    vector <typename T::open_type> opened;
     typename T::MAC_Check MC;
-    int buffer_size = check_triples.size();
+    size_t buffer_size = check_triples.size();
     auto t = Create_Random<U>(P);
-    masked.reserve(buffer_size);
-    for (int i = 0; i < buffer_size; i++)
+    vector<T> masked(buffer_size), checks(buffer_size);
+    vector <typename T::open_type> opened;
+
+    // the local computation is independent per tuple
+    sacrifice_parallel(buffer_size, [&](size_t begin, size_t end)
     {
-        const T& a = check_triples[i][0];
-        const T& a_prime = check_triples[i][1];
-        masked.push_back(T::Mul(a, t) - a_prime);
-    }
+        for (size_t i = begin; i < end; i++)
+        {
+            auto& tuple = check_triples[i];
+            masked[i] = T::Mul(tuple[0], t) - tuple[1];
+        }
+    });
     MC.POpen(opened, masked, P);
-    checks.reserve(buffer_size);
-    for (int i = 0; i < buffer_size; i++)
+    sacrifice_parallel(buffer_size, [&](size_t begin, size_t end)
     {
-        const T& b = check_triples[i][2];
-        const T& c = check_triples[i][3];
-        const T& c_prime = check_triples[i][4];
-        typename T::open_type& rho = opened[i];
-        checks.push_back(T::Mul(c, t) - c_prime - rho * b);
-    }
+        for (size_t i = begin; i < end; i++)
+        {
+            auto& tuple = check_triples[i];
+            checks[i] = T::Mul(tuple[3], t) - tuple[4] - opened[i] * tuple[2];
+        }
+    });
     MC.CheckFor(0, checks, P);
     MC.Check(P);
 }
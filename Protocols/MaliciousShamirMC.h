@@ -18,11 +18,13 @@ class MaliciousShamirMC : public ShamirMC<T>
 
     vector<vector<typename T::open_type::Scalar>> reconstructions;
 
-    vector<typename T::open_type> shares;
+    vector<typename T::open_type> shares, check;
 
     void finalize(vector<typename T::open_type>& values, const vector<T>& S,
             const Player& P);
 
+    void finalize_all();
+
 public:
     MaliciousShamirMC();
 
@@ -38,7 +40,6 @@ public:
     { (void)_; (void)__; (void)___; (void)____; }
 
     void init_open(const Player& P, int n = 0);
-    typename T::open_type finalize_raw();
 
     typename T::open_type reconstruct(const vector<open_type>& shares);
 };
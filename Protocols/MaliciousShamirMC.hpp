@@ -33,13 +33,24 @@ void MaliciousShamirMC<T>::init_open(const Player& P, int n)
 }
 
 template<class T>
-typename T::open_type MaliciousShamirMC<T>::finalize_raw()
+void MaliciousShamirMC<T>::finalize_all()
 {
+    // same as reconstruct() for all values at once
     int threshold = ShamirMachine::s().threshold;
-    shares.resize(2 * threshold + 1);
-    for (size_t j = 0; j < shares.size(); j++)
-        shares[j].unpack((*this->os)[this->player->get_player(j)]);
-    return reconstruct(shares);
+    auto& values = this->values;
+    size_t n = this->n_values;
+    this->get_shares(2 * threshold + 1);
+    values.clear();
+    values.resize(n);
+    this->combine(values.data(), reconstructions[threshold + 1]);
+    check.resize(n);
+    for (int j = threshold + 2; j <= 2 * threshold + 1; j++)
+    {
+        this->combine(check.data(), reconstructions[j]);
+        for (size_t i = 0; i < n; i++)
+            if (check[i] != values[i])
+                throw mac_fail("inconsistent Shamir secret sharing");
+    }
 }
 
 template<class T>
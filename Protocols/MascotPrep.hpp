@@ -63,15 +63,23 @@ void MascotTriplePrep<T>::buffer_triples()
     auto& params = this->params;
     auto& triple_generator = this->triple_generator;
     params.generateBits = false;
-    triple_generator->set_batch_size(
-            BaseMachine::batch_size<T>(DATA_TRIPLE, this->buffer_size));
-    triple_generator->generate();
-    triple_generator->unlock();
+    size_t required = BaseMachine::batch_size<T>(DATA_TRIPLE,
+            this->buffer_size);
+
+    // the generator limits the batch to bound memory
+    size_t n_done = 0;
+    while (n_done < required)
+    {
+        triple_generator->set_batch_size(required - n_done);
+        triple_generator->generate();
+        triple_generator->unlock();
+        assert(triple_generator->uncheckedTriples.size() != 0);
+        for (auto& triple : triple_generator->uncheckedTriples)
+            this->triples.push_back(
+            {{ triple.a[0], triple.b, triple.c[0] }});
+        n_done += triple_generator->uncheckedTriples.size();
+    }
     triple_generator->set_batch_size(OnlineOptions::singleton.batch_size);
-    assert(triple_generator->uncheckedTriples.size() != 0);
-    for (auto& triple : triple_generator->uncheckedTriples)
-        this->triples.push_back(
-        {{ triple.a[0], triple.b, triple.c[0] }});
 }
 
 template<class T>
@@ -9,36 +9,135 @@
 #include "Processor/Data_Files.h"
 #include "ShareMatrix.h"
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <memory>
+
+/**
+ * File of matrix triples mapped into memory once per process.
+ * Threads take triples in turn with an atomic cursor, so they share
+ * the pool of given dimensions without splitting the file.
+ */
 template<class T>
-class MatrixFile : public Preprocessing<ShareMatrix<T>>
+class MatrixFileStore
 {
-    typedef Preprocessing<ShareMatrix<T>> super;
+    class MemoryBuffer : public streambuf
+    {
+    public:
+        MemoryBuffer(const char* begin, const char* end)
+        {
+            setg((char*) begin, (char*) begin, (char*) end);
+        }
+    };
 
     array<int, 3> dims;
+    string filename;
 
-    ifstream file;
+    const char* mapped;
+    size_t mapped_size, start, tuple_size;
+    atomic<size_t> next;
+
+    size_t read(size_t offset, ShareMatrix<T>& A, ShareMatrix<T>& B,
+            ShareMatrix<T>& C)
+    {
+        MemoryBuffer buffer(mapped + offset, mapped + mapped_size);
+        istream is(&buffer);
+        A = {dims[0], dims[1]};
+        B = {dims[1], dims[2]};
+        C = {dims[0], dims[2]};
+        A.input(is);
+        B.input(is);
+        C.input(is);
+        if (is.fail())
+            throw not_enough_to_buffer("matrix triples", filename);
+        return is.tellg();
+    }
+
+    MatrixFileStore(array<int, 3> dims, const string& filename) :
+            dims(dims), filename(filename), mapped(0), mapped_size(0),
+            start(0), tuple_size(0), next(0)
+    {
+        ifstream file(filename);
+        check_file_signature<T>(file, filename);
+        start = file.tellg();
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        struct stat buf;
+        if (fd >= 0 and fstat(fd, &buf) == 0 and buf.st_size > 0)
+        {
+            void* res = mmap(0, buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (res != MAP_FAILED)
+            {
+                mapped = (const char*) res;
+                mapped_size = buf.st_size;
+            }
+        }
+        if (fd >= 0)
+            close(fd);
+        if (not mapped)
+            throw runtime_error("cannot map " + filename);
+
+        // all triples in a file have the same length
+        if (start < mapped_size)
+        {
+            ShareMatrix<T> A, B, C;
+            tuple_size = read(start, A, B, C);
+        }
+    }
 
 public:
-    MatrixFile(array<int, 3> dims, DataPositions& usage, Player& P) :
-            super(usage), dims(dims)
+    static MatrixFileStore& get(array<int, 3> dims, Player& P)
     {
+        static mutex lock;
+        static map<string, unique_ptr<MatrixFileStore>> stores;
+
         string filename = PrepBase::get_matrix_prefix(
                         get_prep_sub_dir<T>(P.num_players()), dims) + "-P"
                         + to_string(P.my_num());
-        file.open(filename);
-        check_file_signature<T>(file, filename);
+        lock_guard<mutex> _(lock);
+        auto& res = stores[filename];
+        if (not res)
+            res.reset(new MatrixFileStore(dims, filename));
+        return *res;
+    }
+
+    ~MatrixFileStore()
+    {
+        if (mapped)
+            munmap((void*) mapped, mapped_size);
+    }
+
+    void take(ShareMatrix<T>& A, ShareMatrix<T>& B, ShareMatrix<T>& C)
+    {
+        size_t offset = start + next++ * tuple_size;
+        if (tuple_size == 0 or offset + tuple_size > mapped_size)
+            throw not_enough_to_buffer("matrix triples", filename);
+        read(offset, A, B, C);
+    }
+};
+
+template<class T>
+class MatrixFile : public Preprocessing<ShareMatrix<T>>
+{
+    typedef Preprocessing<ShareMatrix<T>> super;
+
+    MatrixFileStore<T>& store;
+
+public:
+    MatrixFile(array<int, 3> dims, DataPositions& usage, Player& P) :
+            super(usage), store(MatrixFileStore<T>::get(dims, P))
+    {
     }
 
     void get_three_no_count(Dtype type, ShareMatrix<T>& A, ShareMatrix<T>& B,
             ShareMatrix<T>& C)
     {
         assert(type == DATA_TRIPLE);
-        A = {dims[0], dims[1]};
-        B = {dims[1], dims[2]};
-        C = {dims[0], dims[2]};
-        A.input(file);
-        B.input(file);
-        C.input(file);
+        store.take(A, B, C);
     }
 };
 
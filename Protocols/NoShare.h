@@ -93,14 +93,14 @@ public:
     }
 
     // share addition
-    This operator+(const This&)
+    This operator+(const This&) const
     {
         throw runtime_error("no share addition");
         return {};
     }
 
     // share subtraction
-    This operator-(const This&)
+    This operator-(const This&) const
     {
         throw runtime_error("no share subtraction");
         return {};
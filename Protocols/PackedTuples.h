@@ -0,0 +1,113 @@
+/*
+ * PackedTuples.h
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDTUPLES_H_
+#define PROTOCOLS_PACKEDTUPLES_H_
+
+#include <array>
+#include <deque>
+#include <streambuf>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+/**
+ * Tuples stored in the serialization of preprocessing files
+ * (``-o compact_triples``), which only uses as many limbs as
+ * the modulus requires. Tuples are unpacked in chunks on demand.
+ */
+template<class T, int L>
+class PackedTuples
+{
+    // read access without copying
+    class InputBuffer : public streambuf
+    {
+    public:
+        InputBuffer(string& data, size_t start)
+        {
+            setg(&data[0], &data[start], &data[0] + data.size());
+        }
+
+        size_t position()
+        {
+            return gptr() - eback();
+        }
+    };
+
+    deque<string> chunks;
+    size_t n_tuples, position;
+
+public:
+    PackedTuples() :
+            n_tuples(0), position(0)
+    {
+    }
+
+    size_t size() const
+    {
+        return n_tuples;
+    }
+
+    bool empty() const
+    {
+        return n_tuples == 0;
+    }
+
+    static bool saves_memory()
+    {
+        ostringstream out;
+        T().output(out, false);
+        return out.str().size() < sizeof(T);
+    }
+
+    /// Pack and free all tuples
+    void push(vector<array<T, L>>& tuples)
+    {
+        if (tuples.empty())
+            return;
+
+        ostringstream out;
+        for (auto& tuple : tuples)
+            for (auto& x : tuple)
+                x.output(out, false);
+        chunks.push_back(out.str());
+        n_tuples += tuples.size();
+
+        tuples.clear();
+        tuples.shrink_to_fit();
+    }
+
+    /// Unpack up to ``n`` tuples
+    void pop(vector<array<T, L>>& tuples, size_t n)
+    {
+        size_t done = 0;
+        while (done < n and not chunks.empty())
+        {
+            auto& chunk = chunks.front();
+            InputBuffer buffer(chunk, position);
+            istream in(&buffer);
+            while (done < n and buffer.position() < chunk.size())
+            {
+                tuples.push_back({});
+                for (auto& x : tuples.back())
+                    x.input(in, false);
+                done++;
+            }
+
+            position = buffer.position();
+            if (position >= chunk.size())
+            {
+                chunks.pop_front();
+                position = 0;
+            }
+        }
+
+        n_tuples -= done;
+    }
+};
+
+#endif /* PROTOCOLS_PACKEDTUPLES_H_ */
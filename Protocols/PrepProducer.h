@@ -0,0 +1,94 @@
+/*
+ * PrepProducer.h
+ *
+ */
+
+#ifndef PROTOCOLS_PREPPRODUCER_H_
+#define PROTOCOLS_PREPPRODUCER_H_
+
+#include "Networking/Player.h"
+#include "Tools/time-func.h"
+
+#include <pthread.h>
+#include <array>
+#include <deque>
+#include <vector>
+using namespace std;
+
+/**
+ * Triple generation in a separate thread with separate communication
+ * (``-o prep_thread[=<batches>]``), which keeps a number of batches
+ * ahead of the online phase. The online phase only waits if the
+ * generation cannot keep up.
+ */
+template<class T>
+class PrepProducer
+{
+    typedef vector<array<T, 3>> Batch;
+
+    Player* P;
+    typename T::mac_key_type mac_key;
+    size_t depth;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    deque<Batch> batches;
+
+    // all parties have to generate the same number of batches
+    size_t started, limit;
+    bool stopping, have_limit, joined;
+    // stop without agreement or check, e.g., after an exception
+    bool cancelled;
+
+    // queue statistics
+    size_t n_waits, max_depth;
+    Timer wait_timer;
+
+    // generation only, e.g., homomorphic encryption in Hemi
+    Timer cpu_timer;
+
+    static void* run(void* producer);
+    void produce();
+
+    void finish(size_t limit);
+    bool is_cancelled();
+
+public:
+    /**
+     * Start generation
+     * @param N network setup
+     * @param id unique identifier for the connections
+     * @param mac_key MAC key share
+     * @param depth number of batches to generate in advance
+     * @param encrypted whether to use encrypted connections
+     */
+    PrepProducer(const Names& N, const string& id,
+            typename T::mac_key_type mac_key, size_t depth, bool encrypted);
+    ~PrepProducer();
+
+    /// Wait for a batch of triples
+    void get_triples(vector<array<T, 3>>& triples)
+    {
+        pthread_mutex_lock(&mutex);
+        if (batches.empty())
+        {
+            n_waits++;
+            wait_timer.start();
+            while (batches.empty())
+                pthread_cond_wait(&cond, &mutex);
+            wait_timer.stop();
+        }
+        triples.insert(triples.end(), batches.front().begin(),
+                batches.front().end());
+        batches.pop_front();
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /// Agree on the number of batches with the other parties and wait
+    void stop(Player& online_player);
+};
+
+#endif /* PROTOCOLS_PREPPRODUCER_H_ */
@@ -0,0 +1,172 @@
+/*
+ * PrepProducer.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_PREPPRODUCER_HPP_
+#define PROTOCOLS_PREPPRODUCER_HPP_
+
+#include "PrepProducer.h"
+#include "ProtocolSet.h"
+#include "Tools/CpuAffinity.h"
+
+template<class T>
+PrepProducer<T>::PrepProducer(const Names& N, const string& id,
+        typename T::mac_key_type mac_key, size_t depth, bool encrypted) :
+        mac_key(mac_key), depth(max(depth, size_t(1))), started(0), limit(0),
+        stopping(false), have_limit(false), joined(false), cancelled(false),
+        n_waits(0), max_depth(0),
+        cpu_timer(CLOCK_THREAD_CPUTIME_ID)
+{
+    if (encrypted)
+        P = new CryptoPlayer(N, id);
+    else
+        P = new PlainPlayer(N, id);
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&cond, 0);
+    pthread_create(&thread, 0, run, this);
+}
+
+template<class T>
+PrepProducer<T>::~PrepProducer()
+{
+    // no communication when unwinding after an exception because
+    // the other parties might have aborted already
+    if (not joined)
+    {
+        pthread_mutex_lock(&mutex);
+        cancelled = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mutex);
+        pthread_join(thread, 0);
+        joined = true;
+        batches.clear();
+    }
+
+    pthread_mutex_destroy(&mutex);
+    pthread_cond_destroy(&cond);
+    delete P;
+}
+
+template<class T>
+void* PrepProducer<T>::run(void* producer)
+{
+    bigint::init_thread();
+    CpuAffinity::pin_helper();
+    // counted when passed to the computation thread
+    PrepTelemetry::ignore = true;
+    auto& self = *(PrepProducer<T>*) producer;
+    if (OnlineOptions::singleton.has_option("throw_exceptions"))
+        self.produce();
+    else
+    {
+        try
+        {
+            self.produce();
+        }
+        catch (exception& e)
+        {
+            // connections closed by aborting parties
+            if (self.is_cancelled())
+                return 0;
+            cerr << "Fatal error in preprocessing thread: " << e.what()
+                    << endl;
+            exit(1);
+        }
+    }
+    return 0;
+}
+
+template<class T>
+bool PrepProducer<T>::is_cancelled()
+{
+    pthread_mutex_lock(&mutex);
+    bool res = cancelled;
+    pthread_mutex_unlock(&mutex);
+    return res;
+}
+
+template<class T>
+void PrepProducer<T>::produce()
+{
+    ProtocolSet<T> set(*P, mac_key);
+    BufferPrep<T>& prep = set.preprocessing;
+
+    pthread_mutex_lock(&mutex);
+    while (true)
+    {
+        if (cancelled or (stopping and have_limit and started >= limit))
+            break;
+
+        // wait for space or the agreed number of batches
+        if ((not stopping and batches.size() >= depth)
+                or (stopping and not have_limit))
+        {
+            pthread_cond_wait(&cond, &mutex);
+            continue;
+        }
+
+        started++;
+        pthread_mutex_unlock(&mutex);
+
+        // take whatever the generator produces in one go, e.g., a
+        // whole OT extension batch for Semi and Semi2k
+        Batch batch;
+        cpu_timer.start();
+        prep.refill(DATA_TRIPLE);
+        cpu_timer.stop();
+        batch.swap(prep.triples);
+
+        pthread_mutex_lock(&mutex);
+        batches.push_back(batch);
+        max_depth = max(max_depth, batches.size());
+        pthread_cond_broadcast(&cond);
+    }
+    bool check = not cancelled;
+    pthread_mutex_unlock(&mutex);
+
+    if (check)
+        set.check();
+}
+
+template<class T>
+void PrepProducer<T>::stop(Player& online_player)
+{
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    octetStream os;
+    os.store(started);
+    pthread_mutex_unlock(&mutex);
+
+    // the others might have started more
+    vector<octetStream> all(online_player.num_players(), os);
+    online_player.unchecked_broadcast(all);
+    size_t agreed = 0;
+    for (auto& x : all)
+        agreed = max(agreed, x.get_int(sizeof(size_t)));
+
+    finish(agreed);
+
+    if (OnlineOptions::singleton.verbose)
+        cerr << "Preprocessing thread generated " << started << " batches of "
+                << T::type_string() << " triples, the online phase waited "
+                << n_waits << " times for " << wait_timer.elapsed()
+                << " seconds, maximal queue depth " << max_depth << " of "
+                << depth << ", CPU time " << cpu_timer.elapsed()
+                << " seconds" << endl;
+}
+
+template<class T>
+void PrepProducer<T>::finish(size_t limit)
+{
+    pthread_mutex_lock(&mutex);
+    this->limit = limit;
+    have_limit = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_join(thread, 0);
+    joined = true;
+}
+
+#endif /* PROTOCOLS_PREPPRODUCER_HPP_ */
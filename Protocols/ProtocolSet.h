@@ -137,6 +137,7 @@ public:
 
     typename T::MAC_Check& output;
     typename T::LivePrep& preprocessing;
+    SubProcessor<T>& processor;
     typename T::Protocol& protocol;
     typename T::Input& input;
 
@@ -146,7 +147,8 @@ public:
      */
     MixedProtocolSet(Player& P, const MixedProtocolSetup<T>& setup) :
             arithmetic(P, setup), binary(P, setup.binary), output(
-                    arithmetic.output), preprocessing(arithmetic.preprocessing), protocol(
+                    arithmetic.output), preprocessing(arithmetic.preprocessing), processor(
+                    arithmetic.processor), protocol(
                     arithmetic.protocol), input(arithmetic.input)
     {
     }
@@ -158,7 +160,8 @@ public:
     template<class sgf2n>
     MixedProtocolSet(Player& P, const Machine<T, sgf2n>& machine) :
             arithmetic(P, machine), binary(P, machine), output(
-                    arithmetic.output), preprocessing(arithmetic.preprocessing), protocol(
+                    arithmetic.output), preprocessing(arithmetic.preprocessing), processor(
+                    arithmetic.processor), protocol(
                     arithmetic.protocol), input(arithmetic.input)
     {
     }
@@ -166,7 +169,8 @@ public:
     MixedProtocolSet(Player& P, typename T::mac_key_type arithmetic_mac_key,
             typename T::bit_type::mac_key_type binary_mac_key) :
             arithmetic(P, arithmetic_mac_key), binary(P, binary_mac_key), output(
-                    arithmetic.output), preprocessing(arithmetic.preprocessing), protocol(
+                    arithmetic.output), preprocessing(arithmetic.preprocessing), processor(
+                    arithmetic.processor), protocol(
                     arithmetic.protocol), input(arithmetic.input)
     {
     }
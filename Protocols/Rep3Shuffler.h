@@ -7,17 +7,67 @@
 #define PROTOCOLS_REP3SHUFFLER_H_
 
 #include "SecureShuffle.h"
+#include "Tools/random.h"
+
+/**
+ * Permutations known to the pairs including this player, stored as
+ * seeds and expanded when applied
+ */
+class Rep3Permutations
+{
+    array<array<octet, SEED_SIZE>, 2> seeds;
+    int n = -1;
+
+public:
+    Rep3Permutations() {}
+
+    Rep3Permutations(int n, array<PRNG, 2>& G) :
+            n(n)
+    {
+        for (int i = 0; i < 2; i++)
+            G[i].get_octets(seeds[i].data(), SEED_SIZE);
+    }
+
+    bool empty() const
+    {
+        return n < 0;
+    }
+
+    array<vector<int>, 2> expand() const
+    {
+        assert(not empty());
+        array<vector<int>, 2> res;
+        for (int i = 0; i < 2; i++)
+        {
+            PRNG G;
+            G.SetSeed(seeds[i].data());
+            auto& perm = res[i];
+            for (int j = 0; j < n; j++)
+                perm.push_back(j);
+            for (int j = 0; j < n; j++)
+            {
+                int k = G.get_uint(n - j);
+                swap(perm[j], perm[k + j]);
+            }
+        }
+        return res;
+    }
+};
 
 template<class T>
 class Rep3Shuffler
 {
 public:
-    typedef array<vector<int>, 2> shuffle_type;
+    typedef Rep3Permutations shuffle_type;
     typedef ShuffleStore<shuffle_type> store_type;
 
 private:
     SubProcessor<T>& proc;
 
+    template<class U>
+    static void permute_locally(vector<U>& x, const vector<int>& perm,
+            size_t unit_size, bool reverse);
+
 public:
     map<long, long> stats;
 
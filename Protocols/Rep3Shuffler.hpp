@@ -18,7 +18,7 @@ Rep3Shuffler<T>::Rep3Shuffler(StackedVector<T> &a, size_t n, int unit_size,
     vector<size_t> unit_sizes{static_cast<size_t>(unit_size)};
     vector<size_t> destinations{output_base};
     vector<size_t> sources{input_base};
-    vector<shuffle_type> shuffles{store.get(handle)};
+    vector<shuffle_type> shuffles{*store.get(handle)};
     vector<bool> reverses{true};
     this->apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles, reverses);
 }
@@ -29,18 +29,7 @@ Rep3Shuffler<T>::Rep3Shuffler(SubProcessor<T> &proc) : proc(proc) {
 
 template<class T>
 int Rep3Shuffler<T>::generate(int n_shuffle, store_type &store) {
-    int res = store.add();
-    auto &shuffle = store.get(res);
-    for (int i = 0; i < 2; i++) {
-        auto &perm = shuffle[i];
-        for (int j = 0; j < n_shuffle; j++)
-            perm.push_back(j);
-        for (int j = 0; j < n_shuffle; j++) {
-            int k = proc.protocol.shared_prngs[i].get_uint(n_shuffle - j);
-            swap(perm[j], perm[k + j]);
-        }
-    }
-    return res;
+    return store.add(shuffle_type(n_shuffle, proc.protocol.shared_prngs));
 }
 
 template<class T>
@@ -50,8 +39,7 @@ void Rep3Shuffler<T>::apply_multiple(StackedVector<T> &a, vector<size_t> &sizes,
                                     store_type &store) {
     vector<shuffle_type> shuffles;
     for (size_t &handle: handles) {
-        shuffle_type &shuffle = store.get(handle);
-        shuffles.push_back(shuffle);
+        shuffles.push_back(*store.get(handle));
     }
 
     apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles, reverses);
@@ -73,99 +61,188 @@ void Rep3Shuffler<T>::apply_multiple(StackedVector<T> &a, vector<size_t> &sizes,
     assert(not T::malicious);
     assert(not T::dishonest_majority);
 
-    // for (size_t i = 0; i < n_shuffles; i++) {
-    // this->apply(a, sizes[i], unit_sizes[i], destinations[i], sources[i], store.get(handles[i]), reverses[i]);
-    // }
-
-    vector<vector<T> > to_shuffle;
+    typedef typename T::clear clear;
+    auto& P = proc.P;
+    auto& prngs = proc.protocol.shared_prngs;
+    int my_num = P.my_num();
+
+    auto in_pair = [](int i, int player) { return player == i or player == (i + 1) % 3; };
+    auto prng = [&](int other) -> PRNG& { return prngs[P.get_offset(other) - 1]; };
+    auto randomize = [](vector<clear>& x, PRNG& G)
+    {
+        for (auto& y : x)
+            y.randomize(G);
+    };
+
+    // the three pairs of players taking turns, each pair knowing one permutation
+    vector<array<int, 3>> pairs(n_shuffles);
+    // players leaving the first pair, staying for the second, and joining it
+    vector<array<int, 3>> roles(n_shuffles);
+    vector<vector<clear>> parts(n_shuffles), masks(n_shuffles), finals(n_shuffles);
+    vector<array<vector<int>, 2>> perms(n_shuffles);
+    vector<octetStream> to_send(3), to_receive(3);
+
+    // round one: both players leaving a pair send their permuted parts
     for (size_t current_shuffle = 0; current_shuffle < n_shuffles; current_shuffle++) {
         assert(sizes[current_shuffle] % unit_sizes[current_shuffle] == 0);
-        vector<T> x;
-        for (size_t j = 0; j < sizes[current_shuffle]; j++)
-            x.push_back(a[sources[current_shuffle] + j]);
-        to_shuffle.push_back(x);
-
         const auto &shuffle = shuffles[current_shuffle];
         if (shuffle.empty())
             throw runtime_error("shuffle has been deleted");
+        auto& perm = perms[current_shuffle];
+        perm = shuffle.expand();
 
-        stats[sizes[current_shuffle] / unit_sizes[current_shuffle]] += unit_sizes[current_shuffle];
-    }
-
-    typename T::Input input(proc);
-
-    for (int pass = 0; pass < 3; pass++) {
-        input.reset_all(proc.P);
-
-        for (size_t current_shuffle = 0; current_shuffle < n_shuffles; current_shuffle++) {
-            const auto n = sizes[current_shuffle];
-            const auto unit_size = unit_sizes[current_shuffle];
-            const auto &shuffle = shuffles[current_shuffle];
-            const auto reverse = reverses[current_shuffle];
-            const auto current_to_shuffle = to_shuffle[current_shuffle];
-
-            vector<typename T::clear> to_share(n);
-            int i;
-            if (reverse)
-                i = 2 - pass;
-            else
-                i = pass;
-
-            if (proc.P.get_player(i) == 0) {
-                for (size_t j = 0; j < n / unit_size; j++)
-                    for (size_t k = 0; k < unit_size; k++)
-                        if (reverse)
-                            to_share.at(j * unit_size + k) = current_to_shuffle.at(
-                                shuffle[0].at(j) * unit_size + k).sum();
-                        else
-                            to_share.at(shuffle[0].at(j) * unit_size + k) =
-                                    current_to_shuffle.at(j * unit_size + k).sum();
-            } else if (proc.P.get_player(i) == 1) {
-                for (size_t j = 0; j < n / unit_size; j++)
-                    for (size_t k = 0; k < unit_size; k++)
-                        if (reverse)
-                            to_share[j * unit_size + k] = current_to_shuffle[shuffle[1][j] * unit_size + k][0];
-                        else
-                            to_share[shuffle[1][j] * unit_size + k] = current_to_shuffle[j * unit_size + k][0];
+        const auto n = sizes[current_shuffle];
+        const auto unit_size = unit_sizes[current_shuffle];
+        const auto reverse = reverses[current_shuffle];
+        auto& pair = pairs[current_shuffle];
+        auto& role = roles[current_shuffle];
+        auto& part = parts[current_shuffle];
+        auto& mask = masks[current_shuffle];
+        auto& final = finals[current_shuffle];
+
+        stats[n / unit_size] += unit_size;
+
+        pair = reverse ? array<int, 3>{2, 1, 0} : array<int, 3>{0, 1, 2};
+        int& leaver = role[0], & stayer = role[1], & joiner = role[2];
+        stayer = in_pair(pair[1], pair[0]) ? pair[0] : (pair[0] + 1) % 3;
+        leaver = pair[0] + (pair[0] + 1) % 3 - stayer;
+        joiner = 3 - stayer - leaver;
+        assert(stayer == (pair[2] + 2) % 3);
+
+        auto permute = [&](int i)
+        {
+            permute_locally(part, perm[my_num != pair[i]], unit_size, reverse);
+        };
+
+        if (in_pair(pair[0], my_num))
+        {
+            part.resize(n);
+            for (size_t j = 0; j < n; j++)
+            {
+                auto& x = a[sources[current_shuffle] + j];
+                part[j] = my_num == pair[0] ? x.sum() : x[0];
             }
-
-            if (proc.P.get_player(i) < 2)
-                for (auto &x: to_share)
-                    input.add_mine(x);
-            for (int k = 0; k < 2; k++)
-                input.add_other((-i + 3 + k) % 3);
+            permute(0);
         }
 
-        input.exchange();
-        to_shuffle.clear();
+        mask.resize(n);
+        final.resize(n);
+        if (my_num == leaver)
+        {
+            randomize(mask, prng(stayer));
+            randomize(final, prng(stayer));
+            for (size_t j = 0; j < n; j++)
+                (part[j] + mask[j]).pack(to_send[joiner]);
+        }
+        else if (my_num == stayer)
+        {
+            randomize(mask, prng(leaver));
+            for (size_t j = 0; j < n; j++)
+                part[j] -= mask[j];
+            permute(1);
+            randomize(mask, prng(joiner));
+            for (size_t j = 0; j < n; j++)
+                (part[j] + mask[j]).pack(to_send[leaver]);
+            final.resize(2 * n);
+            for (int i = 0; i < 2; i++)
+                for (size_t j = 0; j < n; j++)
+                    final[i * n + j].randomize(prngs[i]);
+        }
+        else
+        {
+            randomize(mask, prng(stayer));
+            randomize(final, prng(stayer));
+        }
+    }
 
-        for (size_t current_shuffle = 0; current_shuffle < n_shuffles; current_shuffle++) {
-            const auto n = sizes[current_shuffle];
-            const auto reverse = reverses[current_shuffle];
+    P.send_receive_all(to_send, to_receive);
+    vector<octetStream> to_exchange(3), exchanged(3);
 
-            int i;
-            if (reverse)
-                i = 2 - pass;
-            else
-                i = pass;
-
-            vector<T> tmp;
-            for (size_t j = 0; j < n; j++) {
-                T x = input.finalize((-i + 3) % 3) + input.finalize((-i + 4) % 3);
-                tmp.push_back(x);
-            }
-            to_shuffle.push_back(tmp);
+    // round two: the last pair converts its parts to replicated shares
+    for (size_t current_shuffle = 0; current_shuffle < n_shuffles; current_shuffle++) {
+        const auto n = sizes[current_shuffle];
+        const auto unit_size = unit_sizes[current_shuffle];
+        const auto reverse = reverses[current_shuffle];
+        auto& pair = pairs[current_shuffle];
+        auto& role = roles[current_shuffle];
+        auto& part = parts[current_shuffle];
+        auto& mask = masks[current_shuffle];
+        auto& final = finals[current_shuffle];
+        auto& perm = perms[current_shuffle];
+
+        if (my_num == role[1])
+            continue;
+
+        auto permute = [&](int i)
+        {
+            permute_locally(part, perm[my_num != pair[i]], unit_size, reverse);
+        };
+
+        part.resize(n);
+        if (my_num == role[2])
+        {
+            for (auto& x : part)
+                x.unpack(to_receive[role[0]]);
+            permute(1);
+            for (size_t j = 0; j < n; j++)
+                part[j] -= mask[j];
+        }
+        else
+            for (auto& x : part)
+                x.unpack(to_receive[role[1]]);
+        permute(2);
+
+        int other = role[0] + role[2] - my_num;
+        for (size_t j = 0; j < n; j++)
+        {
+            part[j] -= final[j];
+            part[j].pack(to_exchange[other]);
         }
     }
 
+    P.send_receive_all(to_exchange, exchanged);
+
     for (size_t current_shuffle = 0; current_shuffle < n_shuffles; current_shuffle++) {
         const auto n = sizes[current_shuffle];
-
-        for (size_t i = 0; i < n; i++)
-            a[destinations[current_shuffle] + i] = to_shuffle[current_shuffle][i];
+        auto& role = roles[current_shuffle];
+        auto& part = parts[current_shuffle];
+        auto& final = finals[current_shuffle];
+        int k = pairs[current_shuffle][2];
+
+        for (size_t j = 0; j < n; j++)
+        {
+            T& x = a[destinations[current_shuffle] + j];
+            if (my_num == role[1])
+            {
+                x[0] = final[j];
+                x[1] = final[n + j];
+            }
+            else
+            {
+                clear y;
+                y.unpack(exchanged[role[0] + role[2] - my_num]);
+                x[my_num != k] = part[j] + y;
+                x[my_num == k] = final[j];
+            }
+        }
     }
 }
 
+template<class T>
+template<class U>
+void Rep3Shuffler<T>::permute_locally(vector<U>& x, const vector<int>& perm,
+        size_t unit_size, bool reverse)
+{
+    vector<U> tmp(x.size());
+    for (size_t j = 0; j < x.size() / unit_size; j++)
+        for (size_t k = 0; k < unit_size; k++)
+            if (reverse)
+                tmp[j * unit_size + k] = x[perm[j] * unit_size + k];
+            else
+                tmp[perm[j] * unit_size + k] = x[j * unit_size + k];
+    swap(x, tmp);
+}
+
 template<class T>
 void Rep3Shuffler<T>::inverse_permutation(StackedVector<T> &, size_t, size_t, size_t) {
     throw runtime_error("inverse permutation not implemented");
@@ -27,6 +27,7 @@ class Rep4 : public ProtocolBase<T>
     array<vector<open_type>, 5> add_shares;
     array<open_type, 5> dotprod_shares;
     vector<int> bit_lengths;
+    vector<open_type> received;
 
     class ResTuple
     {
@@ -53,6 +54,9 @@ class Rep4 : public ProtocolBase<T>
 
     int get_player(int offset);
 
+    void prepare_exchange();
+    void finalize_exchange();
+
     template<int = 0>
     T finalize_mul(int n_bits, true_type);
     template<int = 0>
@@ -62,6 +66,7 @@ class Rep4 : public ProtocolBase<T>
 
 public:
     static const bool uses_triples = false;
+    static const bool pipelinable = true;
 
     prngs_type rep_prngs;
     Player& P;
@@ -75,6 +80,8 @@ public:
     void init_mul();
     void prepare_mul(const T& x, const T& y, int n = -1);
     void exchange();
+    void start_exchange();
+    void stop_exchange();
     T finalize_mul(int n = -1);
     void check();
 
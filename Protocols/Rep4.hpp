@@ -133,12 +133,12 @@ void Rep4<T>::prepare_joint_input(int sender, int backup, int receiver,
         switch (P.get_offset(backup))
         {
         case 2:
-            for (size_t i = 0; i < inputs.size(); i++)
-                inputs[i].pack(send_os[3 - my_num], bit_lengths[i]);
+            send_os[3 - my_num].store_range(inputs.data(), inputs.size(),
+                    bit_lengths.data());
             break;
         case 1:
-            for (size_t i = 0; i < inputs.size(); i++)
-                inputs[i].pack(send_os[get_player(-1)], bit_lengths[i]);
+            send_os[get_player(-1)].store_range(inputs.data(), inputs.size(),
+                    bit_lengths.data());
             break;
         default:
             throw not_implemented();
@@ -163,7 +163,6 @@ void Rep4<T>::finalize_joint_input(int sender, int backup, int receiver,
     if (P.my_num() == receiver)
     {
         assert(results.size() == bit_lengths.size());
-        T res;
         size_t n_results = results.size();
         octetStream* os;
         int index;
@@ -180,12 +179,10 @@ void Rep4<T>::finalize_joint_input(int sender, int backup, int receiver,
         }
 
         auto start = os->get_data_ptr();
+        received.resize(n_results);
+        os->get_range(received.data(), n_results, bit_lengths.data());
         for (size_t i = 0; i < n_results; i++)
-        {
-            auto& x = results[i];
-            res[1].unpack(*os, bit_lengths[i]);
-            x.res[index] += res[1];
-        }
+            results[i].res[index] += received[i];
 
         os->consume(0);
         receive_hashes[sender][backup].update(start,
@@ -247,6 +244,45 @@ template<class T>
 void Rep4<T>::exchange()
 {
     CODE_LOCATION
+    prepare_exchange();
+    P.send_receive_all(channels, send_os, receive_os);
+    finalize_exchange();
+}
+
+template<class T>
+void Rep4<T>::start_exchange()
+{
+    CODE_LOCATION
+    prepare_exchange();
+    int me = P.my_num();
+    for (int i = 0; i < P.num_players(); i++)
+        if (i != me)
+        {
+            if (channels[me][i])
+                P.request_send(i, send_os[i]);
+            if (channels[i][me])
+                P.request_receive(i, receive_os[i]);
+        }
+}
+
+template<class T>
+void Rep4<T>::stop_exchange()
+{
+    int me = P.my_num();
+    for (int i = 0; i < P.num_players(); i++)
+        if (i != me)
+        {
+            if (channels[i][me])
+                P.wait_receive(i, receive_os[i]);
+            if (channels[me][i])
+                P.wait_send(i, send_os[i]);
+        }
+    finalize_exchange();
+}
+
+template<class T>
+void Rep4<T>::prepare_exchange()
+{
     auto& a = add_shares;
     results.clear();
     results.resize(a[4].size());
@@ -256,7 +292,11 @@ void Rep4<T>::exchange()
     prepare_joint_input(3, 0, 2, 1, a[3]);
     prepare_joint_input(0, 2, 3, 1, a[4]);
     prepare_joint_input(1, 3, 2, 0, a[4]);
-    P.send_receive_all(channels, send_os, receive_os);
+}
+
+template<class T>
+void Rep4<T>::finalize_exchange()
+{
     finalize_joint_input(0, 1, 3, 2);
     finalize_joint_input(1, 2, 0, 3);
     finalize_joint_input(2, 3, 1, 0);
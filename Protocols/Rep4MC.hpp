@@ -7,6 +7,8 @@
 #define PROTOCOLS_REP4MC_HPP_
 
 #include "Rep4MC.h"
+#include "Processor/Metrics.h"
+#include "Processor/Trace.h"
 
 template<class T>
 void Rep4MC<T>::exchange(const Player& P)
@@ -39,6 +41,8 @@ void Rep4MC<T>::Check(const Player& P)
     if (check_hash.size == 0)
         return;
 
+    Metrics::count_mac_check();
+    Trace::Span span("MAC check", Trace::CHECK);
     CODE_LOCATION
     octetStream left;
     check_hash.final(left);
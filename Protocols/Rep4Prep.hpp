@@ -46,7 +46,8 @@ void Rep4RingPrep<T>::buffer_inputs(int player)
 template<class T>
 void Rep4RingPrep<T>::buffer_triples()
 {
-    generate_triples(this->triples, BaseMachine::batch_size<T>(DATA_TRIPLE),
+    generate_triples(this->triples,
+            BaseMachine::batch_size<T>(DATA_TRIPLE, this->buffer_size),
             this->protocol);
 }
 
@@ -56,6 +56,16 @@ public:
     virtual double randomness_time();
 };
 
+// view of row-major matrix for local matrix multiplication
+template<class T>
+auto row_major_view(const T* data, size_t n_cols)
+{
+    return [data, n_cols](size_t i, size_t j) -> const T&
+    {
+        return data[i * n_cols + j];
+    };
+}
+
 /**
  * Abstract base class for multiplication protocols
  */
@@ -74,6 +84,10 @@ public:
 
     typedef SecureShuffle<T> Shuffler;
 
+    static const bool uses_triples = false;
+    // several instances can have rounds in flight at the same time
+    static const bool pipelinable = false;
+
     long trunc_pr_counter, trunc_pr_big_counter;
     long rounds, trunc_rounds;
     long dot_counter;
@@ -135,6 +149,11 @@ public:
     virtual void randoms(T&, int) { throw runtime_error("randoms not implemented"); }
     virtual void randoms_inst(StackedVector<T>&, const Instruction&);
 
+    template<int = 0>
+    void matmuls(SubProcessor<T>& proc, const StackedVector<T>& source,
+            const Instruction& instruction)
+    { proc.matmuls(source, instruction); }
+
     template<int = 0>
     void matmulsm(SubProcessor<T> & proc, MemoryPart<T>& source,
             const Instruction& instruction)
@@ -149,8 +168,9 @@ public:
 
     virtual void check() {}
 
-    virtual void cisc(SubProcessor<T>&, const Instruction&)
-    { throw runtime_error("CISC instructions not implemented"); }
+    template<int = 0>
+    void cisc(SubProcessor<T>& proc, const Instruction& instruction)
+    { proc.cisc(instruction); }
 
     virtual vector<int> get_relevant_players();
 
@@ -192,6 +212,9 @@ class Replicated : public ReplicatedBase, public ProtocolBase<T>
 
     vector<ReplicatedInput<T>*> helper_inputs;
 
+    vector<value_type> trunc_masks;
+    array<vector<uint64_t>, 2> matmul_operands[2];
+
     template<int MY_NUM>
     void trunc_pr_finish(TruncPrTupleList<T>& infos, ReplicatedInput<T>& input);
 
@@ -202,6 +225,7 @@ class Replicated : public ReplicatedBase, public ProtocolBase<T>
 
 public:
     static const bool uses_triples = false;
+    static const bool pipelinable = true;
 
     typedef Rep3Shuffler<T> Shuffler;
 
@@ -223,6 +247,10 @@ public:
     T finalize_mul(int n = -1) final;
 
     void prepare_reshare(const typename T::clear& share, int n = -1);
+    // a(i, k) and b(k, j) return operand shares
+    template<class U, class V>
+    void prepare_matmul(const U& a, const V& b, size_t n_rows,
+            size_t n_inner, size_t n_cols);
     void prepare_mul_fast(const T& x, const T& y);
     T finalize_mul_fast();
 
@@ -231,6 +259,15 @@ public:
     void next_dotprod();
     T finalize_dotprod(int length);
 
+    template<int = 0>
+    void matmuls(SubProcessor<T>& proc, const StackedVector<T>& source,
+            const Instruction& instruction);
+    template<int = 0>
+    void matmulsm(SubProcessor<T>& proc, MemoryPart<T>& source,
+            const Instruction& instruction);
+    template<int = 0>
+    void conv2ds(SubProcessor<T>& proc, const Instruction& instruction);
+
     template<class U>
     void trunc_pr(const vector<int>& regs, int size, U& proc);
 
@@ -9,6 +9,7 @@
 #include "Replicated.h"
 #include "Processor/Processor.h"
 #include "Processor/TruncPrTuple.h"
+#include "Processor/Conv2dTuple.h"
 #include "Tools/benchmarking.h"
 #include "Tools/Bundle.h"
 #include "Tools/DoubleRange.h"
@@ -20,6 +21,9 @@
 
 #include "ReplicatedPO.hpp"
 #include "Math/Z2k.hpp"
+#include "Math/ring_vectors.h"
+
+#include <thread>
 
 template<class T>
 ProtocolBase<T>::ProtocolBase() :
@@ -260,12 +264,21 @@ void Replicated<T>::prepare_exchange()
     if (not T::clear::binary or fast_mode)
     {
         os[0].reserve(add_shares.size() * T::clear::size());
-        for (auto& add_share : add_shares)
+        // masks in batches to use the PRNG bulk output
+        const size_t N = max(size_t(1), 4096 / sizeof(typename T::clear));
+        typename T::clear masks[2][N];
+        for (size_t i = 0; i < add_shares.size(); i += N)
         {
-            add_share += shared_prngs[0];
-            add_share -= shared_prngs[1];
-            os[0].append_no_resize((octet*) add_share.get_ptr(),
-                    add_share.size());
+            size_t n = min(N, add_shares.size() - i);
+            for (int j = 0; j < 2; j++)
+                shared_prngs[j].fill(masks[j], n);
+            for (size_t k = 0; k < n; k++)
+            {
+                auto& add_share = add_shares[i + k];
+                add_share += masks[0][k] - masks[1][k];
+                os[0].append_no_resize((octet*) add_share.get_ptr(),
+                        add_share.size());
+            }
         }
     }
     add_shares.reset();
@@ -288,14 +301,16 @@ void Replicated<T>::start_exchange()
 {
     prepare_exchange();
     os[0].append(0);
-    P.send_relative(1, os[0]);
+    P.request_send(P.get_player(1), os[0]);
+    P.request_receive(P.get_player(-1), os[1]);
     this->rounds++;
 }
 
 template<class T>
 void Replicated<T>::stop_exchange()
 {
-    P.receive_relative(-1, os[1]);
+    P.wait_receive(P.get_player(-1), os[1]);
+    P.wait_send(P.get_player(1), os[0]);
     check_received();
 }
 
@@ -368,6 +383,209 @@ inline T Replicated<T>::finalize_dotprod(int length)
     return finalize_mul();
 }
 
+template<class T>
+template<class U, class V>
+void Replicated<T>::prepare_matmul(const U& a, const V& b, size_t n_rows,
+        size_t n_inner, size_t n_cols)
+{
+    static_assert(ring_words<T>() == 2 and ring_words<value_type>() == 1,
+            "replicated shares modulo 2^64 required");
+
+    // local product x[0] * (y[0] + y[1]) + x[1] * y[0]
+    // as two products of plain matrices
+    size_t n_A = n_rows * n_inner, n_B = n_inner * n_cols;
+    auto& A = matmul_operands[0], &B = matmul_operands[1];
+    for (int l = 0; l < 2; l++)
+    {
+        A[l].resize(n_A);
+        B[l].resize(n_B);
+    }
+    for (size_t i = 0; i < n_rows; i++)
+        for (size_t k = 0; k < n_inner; k++)
+        {
+            auto& x = a(i, k);
+            for (int l = 0; l < 2; l++)
+                A[l][i * n_inner + k] = x[l].get_limb(0);
+        }
+    for (size_t k = 0; k < n_inner; k++)
+        for (size_t j = 0; j < n_cols; j++)
+        {
+            auto& y = b(k, j);
+            B[0][k * n_cols + j] = (y[0] + y[1]).get_limb(0);
+            B[1][k * n_cols + j] = y[0].get_limb(0);
+        }
+
+    // directly into the buffer for resharing
+    size_t offset = add_shares.size();
+    add_shares.resize(offset + n_rows * n_cols);
+    auto C = (uint64_t*) &add_shares[offset];
+
+    auto job = [&](size_t begin, size_t end)
+    {
+        for (int l = 0; l < 2; l++)
+            ring_gemm(C + begin * n_cols, A[l].data() + begin * n_inner,
+                    B[l].data(), end - begin, n_inner, n_cols);
+    };
+
+    // threads only pay off for large products
+    size_t n_jobs = min(size_t(max(1,
+            stoi(OnlineOptions::singleton.option_value("matmul_threads",
+                    "1")))), n_rows);
+    if (n_A * n_cols < (1 << 20))
+        n_jobs = 1;
+    vector<thread> threads;
+    for (size_t i = 1; i < n_jobs; i++)
+        threads.push_back(
+                thread(job, n_rows * i / n_jobs, n_rows * (i + 1) / n_jobs));
+    job(0, n_rows / n_jobs);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+template<class T>
+template<int>
+void Replicated<T>::matmuls(SubProcessor<T>& proc,
+        const StackedVector<T>& source, const Instruction& instruction)
+{
+    if constexpr (ring_words<T>() == 2 and ring_words<value_type>() == 1)
+    {
+        CODE_LOCATION
+        auto& start = instruction.get_start();
+        assert(start.size() % 6 == 0);
+
+        init_mul();
+        for (auto it = start.begin(); it < start.end(); it += 6)
+        {
+            assert(source.begin() + it[1] + it[3] * it[4] <= source.end());
+            assert(source.begin() + it[2] + it[4] * it[5] <= source.end());
+            prepare_matmul(
+                    row_major_view(&*(source.begin() + it[1]), it[4]),
+                    row_major_view(&*(source.begin() + it[2]), it[5]),
+                    it[3], it[4], it[5]);
+        }
+
+        exchange();
+
+        auto& S = proc.get_S();
+        for (auto it = start.begin(); it < start.end(); it += 6)
+        {
+            auto C = S.begin() + it[0];
+            assert(C + it[3] * it[5] <= S.end());
+            for (int i = 0; i < it[3] * it[5]; i++)
+                *(C + i) = finalize_dotprod(it[4]);
+        }
+
+        proc.maybe_check();
+    }
+    else
+        proc.matmuls(source, instruction);
+}
+
+template<class T>
+template<int>
+void Replicated<T>::matmulsm(SubProcessor<T>& proc, MemoryPart<T>& source,
+        const Instruction& instruction)
+{
+    if constexpr (ring_words<T>() == 2 and ring_words<value_type>() == 1)
+    {
+        CODE_LOCATION
+        auto& start = instruction.get_start();
+        assert(start.size() % 12 == 0);
+
+        // operands in place, resharing in batches of whole matrices
+        auto done = start.begin();
+        init_mul();
+        for (auto args = start.begin(); args < start.end(); args += 12)
+        {
+            prepare_matmul(proc.matmulsm_view(source, args, 0),
+                    proc.matmulsm_view(source, args, 1), args[3], args[4],
+                    args[5]);
+
+            if (add_shares.size() > size_t(OnlineOptions::singleton.batch_size)
+                    or args + 12 == start.end())
+            {
+                exchange();
+                auto& S = proc.get_S();
+                for (; done <= args; done += 12)
+                {
+                    auto C = S.begin() + done[0];
+                    assert(C + done[3] * done[5] <= S.end());
+                    for (int i = 0; i < done[3] * done[5]; i++)
+                        *(C + i) = finalize_dotprod(done[4]);
+                }
+                init_mul();
+            }
+        }
+
+        proc.maybe_check();
+    }
+    else
+        proc.matmulsm(source, instruction.get_start());
+}
+
+template<class T>
+template<int>
+void Replicated<T>::conv2ds(SubProcessor<T>& proc,
+        const Instruction& instruction)
+{
+    if constexpr (ring_words<T>() == 2 and ring_words<value_type>() == 1)
+    {
+        CODE_LOCATION
+        auto& args = instruction.get_start();
+        vector<Conv2dTuple> tuples;
+        for (size_t i = 0; i < args.size(); i += 15)
+            tuples.push_back(Conv2dTuple(args, i));
+
+        // filters on the same input become one matrix product
+        // of the weights by the input patches (im2col)
+        auto& S = proc.get_S();
+        vector<T> weights, columns;
+        size_t done = 0;
+        init_mul();
+        for (size_t begin = 0; begin < tuples.size();)
+        {
+            auto& tuple = tuples[begin];
+            size_t end = begin + 1;
+            while (end < tuples.size() and tuple.same_input(tuples[end]))
+                end++;
+
+            auto dim = tuple.matrix_dimensions();
+            size_t n_inner = dim[1];
+            weights.resize((end - begin) * n_inner);
+            for (size_t i = begin; i < end; i++)
+            {
+                assert(tuples[i].r2 + n_inner <= S.size());
+                copy_n(&S[tuples[i].r2], n_inner,
+                        &weights[(i - begin) * n_inner]);
+            }
+            tuple.im2col(S, columns);
+            prepare_matmul(row_major_view(weights.data(), n_inner),
+                    row_major_view(columns.data(), dim[2]), end - begin,
+                    n_inner, dim[2]);
+            begin = end;
+
+            if (add_shares.size() > size_t(OnlineOptions::singleton.batch_size)
+                    or begin == tuples.size())
+            {
+                exchange();
+                for (; done < begin; done++)
+                {
+                    auto& tuple = tuples[done];
+                    auto dim = tuple.matrix_dimensions();
+                    assert(tuple.r0 + dim[2] <= S.size());
+                    for (int i = 0; i < dim[2]; i++)
+                        S[tuple.r0 + i] = finalize_dotprod(dim[1]);
+                }
+                init_mul();
+            }
+        }
+
+        proc.maybe_check();
+    }
+    else
+        proc.conv2ds(instruction);
+}
+
 template<class T>
 T Replicated<T>::get_random()
 {
@@ -423,13 +641,15 @@ void Replicated<T>::trunc_pr(const vector<int>& regs, int size, U& proc,
     CODE_LOCATION
     assert(regs.size() % 4 == 0);
     assert(proc.P.num_players() == 3);
-    assert(proc.Proc != 0);
+    // vectorized on contiguous registers modulo 2^64
+    constexpr bool flat_trunc = ring_words<T>() == 2
+            and ring_words<value_type>() == 1;
     bool generate = P.my_num() == gen_player;
     bool compute = P.my_num() == comp_player;
     auto& S = proc.get_S();
     TruncPrTupleList<T> infos(regs, S, size);
 
-    octetStream cs;
+    PooledOctetStream cs(P.stream_pool);
 
     auto& input = get_helper_input();
     input.reset_all(P);
@@ -455,6 +675,23 @@ void Replicated<T>::trunc_pr(const vector<int>& regs, int size, U& proc,
         {
             if (info.big_gap())
             {
+                if constexpr (flat_trunc)
+                {
+                    auto& r = trunc_masks;
+                    r.resize(size);
+                    this->shared_prngs[0].fill(r.data(), size);
+                    auto c = (uint64_t*) cs.append(size * sizeof(uint64_t));
+                    auto dest = (uint64_t*) &S[info.dest_base];
+                    ring_trunc_pr_sum(c, (uint64_t*) &S[info.source_base],
+                            (uint64_t*) r.data(), info.m, size);
+                    for (int i = 0; i < size; i++)
+                    {
+                        dest[2 * i] = r[i].get_limb(0);
+                        dest[2 * i + 1] = c[i];
+                    }
+                    continue;
+                }
+
                 auto dest_it = info.dest_range.begin();
                 cs.reserve(size * value_type::size());
                 for (auto& x : info.source_range)
@@ -487,10 +724,20 @@ void Replicated<T>::trunc_pr(const vector<int>& regs, int size, U& proc,
                 }
             else
             {
-                auto dest_it = info.dest_range.begin();
                 if (cs.left() < size_t(value_type::size() * size))
                     throw runtime_error("insufficient data in trunc_pr");
 
+                if constexpr (flat_trunc)
+                {
+                    auto c = cs.consume(size * sizeof(uint64_t));
+                    ring_trunc_pr_share<1>((uint64_t*) &S[info.dest_base],
+                            (uint64_t*) &S[info.source_base], (uint64_t*) c,
+                            info.m, size);
+                    continue;
+                }
+
+                auto dest_it = info.dest_range.begin();
+
                 for (auto& x: info.source_range)
                 {
                     auto& y = *dest_it++;
@@ -505,6 +752,19 @@ void Replicated<T>::trunc_pr(const vector<int>& regs, int size, U& proc,
     {
         for (auto info : infos)
             if (info.big_gap())
+            {
+                if constexpr (flat_trunc)
+                {
+                    auto& r = trunc_masks;
+                    r.resize(size);
+                    this->shared_prngs[1].fill(r.data(), size);
+                    ring_trunc_pr_share<0>(
+                            (uint64_t*) &S[info.dest_base],
+                            (uint64_t*) &S[info.source_base],
+                            (uint64_t*) r.data(), info.m, size);
+                    continue;
+                }
+
                 for (int i = 0; i < size; i++)
                 {
                     auto& x = S[info.source_base + i];
@@ -512,6 +772,7 @@ void Replicated<T>::trunc_pr(const vector<int>& regs, int size, U& proc,
                     y[0] = x[0].signed_rshift(info.m);
                     y[1] = this->shared_prngs[1].template get<value_type>();
                 }
+            }
     }
 
 #define X(I) if (P.my_num() == I) trunc_pr_finish<I>(infos, input);
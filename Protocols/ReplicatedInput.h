@@ -101,9 +101,13 @@ public:
     void add_mine(const typename T::open_type& input, int n_bits = -1) final;
     void add_mine_prepared(T& share, const typename T::open_type& input);
     void add_other(int player, int n_bits = -1);
+    void add_mine_vector(const vector<typename T::open_type>& inputs,
+            int n_bits = -1) final;
+    void add_other_vector(int player, size_t n, int n_bits = -1) final;
     void send_mine();
     void exchange();
     void finalize_other(int player, T& target, octetStream& o, int n_bits = -1);
+    void finalize_vector(int player, T* target, size_t n, int n_bits = -1) final;
     T finalize_offset(int offset);
 
     double randomness_time()
@@ -59,6 +59,34 @@ void ReplicatedInput<T>::add_other(int player, int)
     expect[player] = true;
 }
 
+template<class T>
+void ReplicatedInput<T>::add_mine_vector(
+        const vector<typename T::open_type>& inputs, int n_bits)
+{
+    if (T::clear::binary)
+    {
+        for (auto& input : inputs)
+            add_mine(input, n_bits);
+        return;
+    }
+
+    // masked in exchange()
+    auto& shares = this->shares;
+    shares.reserve(shares.size() + inputs.size());
+    T my_share;
+    for (auto& input : inputs)
+    {
+        my_share[1] = input;
+        shares.push_back(my_share);
+    }
+}
+
+template<class T>
+void ReplicatedInput<T>::add_other_vector(int player, size_t, int)
+{
+    expect[player] = true;
+}
+
 template<class T>
 void ReplicatedInput<T>::send_mine()
 {
@@ -90,10 +118,17 @@ void ReplicatedInput<T>::exchange()
     CODE_LOCATION
     if (not T::clear::binary and not to_send)
     {
-        prepare(this->shares.size());
-        for (auto& share : this->shares)
+        // same randomness as add_mine_prepared() per input
+        auto& shares = this->shares;
+        prepare(shares.size());
+        vector<typename T::value_type> masks(shares.size());
+        protocol.shared_prngs[0].fill(masks.data(), masks.size());
+        for (size_t i = 0; i < shares.size(); i++)
         {
-            add_mine_prepared(share, share[1]);
+            auto& share = shares[i];
+            share[0] = masks[i];
+            share[1] -= masks[i];
+            to_send->store_no_resize(share[1]);
         }
     }
 
@@ -132,6 +167,47 @@ inline void ReplicatedInput<T>::finalize_other(int player, T& target,
     }
 }
 
+template<class T>
+void ReplicatedInput<T>::finalize_vector(int player, T* target, size_t n,
+        int n_bits)
+{
+    if (T::clear::binary and n_bits >= 0)
+    {
+        for (size_t i = 0; i < n; i++)
+            target[i] = this->finalize(player, n_bits);
+        return;
+    }
+
+    typedef typename T::value_type value_type;
+    switch ((player - this->my_num + 3) % 3)
+    {
+    case 0:
+        for (size_t i = 0; i < n; i++)
+            target[i] = this->shares.next();
+        break;
+    case 1:
+        if (dest.left() < n * value_type::size())
+            throw runtime_error("insufficient data in replicated input");
+        for (size_t i = 0; i < n; i++)
+        {
+            target[i][0] = dest.get_no_check<value_type>();
+            target[i][1] = {};
+        }
+        break;
+    case 2:
+    {
+        vector<value_type> r(n);
+        protocol.shared_prngs[1].fill(r.data(), n);
+        for (size_t i = 0; i < n; i++)
+        {
+            target[i][0] = {};
+            target[i][1] = r[i];
+        }
+        break;
+    }
+    }
+}
+
 template<class T>
 T ReplicatedInput<T>::finalize_offset(int offset)
 {
@@ -58,12 +58,9 @@ void ReplicatedMC<T>::finalize(vector<typename T::open_type>& values,
         const vector<T>& S)
 {
     values.resize(S.size());
+    o.get_range(values.data(), S.size());
     for (size_t i = 0; i < S.size(); i++)
-    {
-        typename T::open_type tmp;
-        tmp.unpack(o);
-        values[i] = S[i].sum() + tmp;
-    }
+        values[i] += S[i].sum();
 }
 
 template<class T>
@@ -13,7 +13,11 @@
 #include "Protocols/ShuffleSacrifice.h"
 #include "Protocols/MAC_Check_Base.h"
 #include "Protocols/ShuffleSacrifice.h"
+#include "Protocols/PrepProducer.h"
+#include "Protocols/BatchSizer.h"
+#include "Protocols/PackedTuples.h"
 #include "Tools/TimerWithComm.h"
+#include "Tools/MemoryAccounting.h"
 #include "edabit.h"
 #include "DabitSacrifice.h"
 
@@ -35,6 +39,7 @@ template<class T>
 class BufferPrep : public Preprocessing<T>
 {
     template<class U, class V> friend class Machine;
+    friend class PrepProducer<T>;
 
     friend class InScope;
 
@@ -60,6 +65,34 @@ protected:
     SubProcessor<T>* proc;
     Player* P;
 
+    // triples from another thread if set
+    PrepProducer<T>* producer;
+
+    array<BatchSizer, N_DTYPE> batch_sizers;
+
+    // triples beyond the current chunk if compact
+    PackedTuples<T, 3> packed_triples;
+    static const size_t unpack_size = 1000;
+
+    // capacity of buffers after refills
+    MemoryAccounting::Account memory{MemoryAccounting::PREPROCESSING};
+    void account_memory();
+
+    // buffer triples, squares, or bits with adaptive batch size if desired
+    void refill(Dtype type);
+    size_t n_buffered(Dtype type);
+    static size_t n_edabits(vector<edabitvec<T>>& buffer);
+    void compact_triples() { compact_triples<0>(T::clear::prime_field); }
+    template<int>
+    void compact_triples(true_type);
+    template<int>
+    void compact_triples(false_type) {}
+    void unpack_triples(size_t n) { unpack_triples<0>(n, T::clear::prime_field); }
+    template<int>
+    void unpack_triples(size_t n, true_type);
+    template<int>
+    void unpack_triples(size_t, false_type) {}
+
     virtual void buffer_triples() { throw runtime_error("no triples"); }
     virtual void buffer_squares() { throw runtime_error("no squares"); }
     virtual void buffer_inverses();
@@ -82,6 +115,8 @@ protected:
     virtual void buffer_personal_dabits(int)
     { throw runtime_error("no personal daBits"); }
 
+    void plan(size_t required, Dtype type);
+
     void push_edabits(vector<edabitvec<T>>& edabits,
             const vector<T>& sums,
             const vector<vector<typename T::bit_type::part_type>>& bits);
@@ -135,6 +170,8 @@ public:
 
     void shrink_to_fit();
 
+    void set_producer(PrepProducer<T>* producer) { this->producer = producer; }
+
     void buffer_personal_triples(int, ThreadQueues*) {}
     void buffer_personal_triples(vector<array<T, 3>>&, int, int) {}
 
@@ -142,6 +179,14 @@ public:
     void set_proc(SubProcessor<T>* proc) { this->proc = proc; }
 
     void buffer_extra(Dtype type, int n_items);
+
+    void plan(const DataPositions& usage);
+
+    string get_cache_filename(Player& P);
+    /// Store unused preprocessing for the next run
+    void store_cache(Player& P);
+    /// Use preprocessing stored by an earlier run
+    void load_cache(Player& P);
 };
 
 /**
@@ -179,6 +224,8 @@ class RingPrep : public virtual BitPrep<T>
 {
     typedef typename T::bit_type::part_type BT;
 
+    friend class SubProcessor<T>;
+
     SubProcessor<BT>& get_bit_part_proc();
 
 protected:
@@ -190,22 +237,24 @@ protected:
             ThreadQueues* queues = 0);
     template<int>
     void buffer_edabits_without_check(int n_bits, vector<edabitvec<T>>& edabits,
-            int buffer_size);
+            int buffer_size, ThreadQueues* queues = 0);
 
-    void buffer_sedabits_from_edabits(int n_bits)
+    void buffer_sedabits_from_edabits(int n_bits, ThreadQueues* queues = 0)
     {
-        this->template buffer_sedabits_from_edabits<0>(n_bits,
+        this->template buffer_sedabits_from_edabits<0>(n_bits, queues,
                 T::clear::characteristic_two,
                 is_same<typename T::bit_type, GC::NoShare>());
     }
     template<int>
-    void buffer_sedabits_from_edabits(int n_bits, false_type, false_type);
+    void buffer_sedabits_from_edabits(int n_bits, ThreadQueues* queues,
+            false_type, false_type);
     template<int>
-    void buffer_sedabits_from_edabits(int, bool, bool)
+    void buffer_sedabits_from_edabits(int, ThreadQueues*, bool, bool)
     { throw not_implemented(); }
 
     template<int>
-    void sanitize(vector<edabitvec<T>>& edabits, int n_bits);
+    void sanitize(vector<edabitvec<T>>& edabits, int n_bits,
+            ThreadQueues* queues = 0);
 
     template<int = 0>
     void buffer_personal_edabits_without_check_pre(int n_bits,
@@ -231,6 +280,19 @@ public:
     template<int>
     void sanitize(vector<edabit<T>>& edabits, int n_bits, int player, int begin,
             int end);
+    template<int>
+    void sanitize(vector<edabitvec<T>>& edabits, int n_bits, int begin,
+            int end)
+    {
+        sanitize<0>(edabits, n_bits, begin, end,
+                is_same<typename T::bit_type, GC::NoShare>());
+    }
+    template<int>
+    void sanitize(vector<edabitvec<T>>& edabits, int n_bits, int begin,
+            int end, false_type);
+    template<int>
+    void sanitize(vector<edabitvec<T>>&, int, int, int, true_type)
+    { throw not_implemented(); }
 
     /// Generic daBit generation with semi-honest security
     void buffer_dabits_without_check(vector<dabit<T>>& dabits,
@@ -279,18 +341,19 @@ public:
 
     virtual void buffer_dabits(ThreadQueues*)
     { this->buffer_dabits_without_check(this->dabits); }
-    virtual void buffer_edabits(int n_bits, ThreadQueues*)
-    { buffer_edabits<0>(n_bits, T::clear::characteristic_two); }
+    virtual void buffer_edabits(int n_bits, ThreadQueues* queues)
+    { buffer_edabits<0>(n_bits, queues, T::clear::characteristic_two); }
     template<int>
-    void buffer_edabits(int n_bits, false_type)
+    void buffer_edabits(int n_bits, ThreadQueues* queues, false_type)
     { this->template buffer_edabits_without_check<0>(n_bits,
             this->edabits[{false, n_bits}],
-            BaseMachine::edabit_batch_size<T>(n_bits, this->buffer_size)); }
+            BaseMachine::edabit_batch_size<T>(n_bits, this->buffer_size),
+            queues); }
     template<int>
-    void buffer_edabits(int, true_type)
+    void buffer_edabits(int, ThreadQueues*, true_type)
     { throw not_implemented(); }
-    virtual void buffer_sedabits(int n_bits, ThreadQueues*)
-    { this->buffer_sedabits_from_edabits(n_bits); }
+    virtual void buffer_sedabits(int n_bits, ThreadQueues* queues)
+    { this->buffer_sedabits_from_edabits(n_bits, queues); }
 };
 
 /**
@@ -14,6 +14,7 @@
 #include "Spdz2kPrep.h"
 #include "GC/BitAdder.h"
 #include "Processor/OnlineOptions.h"
+#include "Tools/Hash.h"
 #include "Protocols/Rep3Share.h"
 
 #include "MaliciousRingPrep.hpp"
@@ -62,8 +63,9 @@ public:
 template<class T>
 BufferPrep<T>::BufferPrep(DataPositions& usage) :
         Preprocessing<T>(usage), n_bit_rounds(0),
-		proc(0), P(0)
+		proc(0), P(0), producer(0)
 {
+    this->telemetry = PrepTelemetry::get(T::type_string());
 }
 
 template<class T>
@@ -80,7 +82,9 @@ BufferPrep<T>::~BufferPrep()
     auto field_type = T::clear::field_type();
     auto& my_usage = this->usage.files.at(field_type);
 
-    this->print_left("triples", triples.size() * T::default_length, type_string,
+    this->print_left("triples",
+            (triples.size() + packed_triples.size()) * T::default_length,
+            type_string,
             this->usage.files.at(T::clear::field_type()).at(DATA_TRIPLE)
                     * T::default_length,
             T::LivePrep::homomorphic or T::expensive_triples);
@@ -99,6 +103,13 @@ BufferPrep<T>::~BufferPrep()
     this->print_left("bits", bits.size(), type_string, used_bits);
     this->print_left("dabits", dabits.size(), type_string, used_dabits);
 
+    if (OnlineOptions::singleton.verbose)
+        for (auto type : {DATA_TRIPLE, DATA_SQUARE, DATA_BIT})
+            if (batch_sizers[type].get_size())
+                cerr << "Final batch size for " << type_string << " "
+                        << DataPositions::dtype_names[type] << ": "
+                        << batch_sizers[type].get_size() << endl;
+
 #define X(KIND, TYPE) \
     this->print_left(#KIND, KIND.size(), type_string, \
             this->usage.files.at(T::clear::field_type()).at(TYPE));
@@ -170,10 +181,12 @@ template<class T>
 void BufferPrep<T>::clear()
 {
     triples.clear();
+    packed_triples = {};
     inverses.clear();
     bits.clear();
     squares.clear();
     inputs.clear();
+    account_memory();
 }
 
 template<class T>
@@ -184,12 +197,14 @@ void ReplicatedRingPrep<T>::buffer_triples()
     {
         // independent instance to avoid conflicts
         typename T::Protocol protocol(this->protocol->branch());
-        generate_triples(this->triples, BaseMachine::batch_size<T>(DATA_TRIPLE),
+        generate_triples(this->triples,
+                BaseMachine::batch_size<T>(DATA_TRIPLE, this->buffer_size),
                 &protocol);
     }
     catch (not_implemented&)
     {
-        generate_triples(this->triples, BaseMachine::batch_size<T>(DATA_TRIPLE),
+        generate_triples(this->triples,
+                BaseMachine::batch_size<T>(DATA_TRIPLE, this->buffer_size),
                 this->protocol);
     }
 }
@@ -227,12 +242,23 @@ void BufferPrep<T>::get_three_no_count(Dtype dtype, T& a, T& b, T& c)
     if (dtype != DATA_TRIPLE)
         throw not_implemented();
 
+    if (triples.empty())
+        unpack_triples(unpack_size);
+
     if (triples.empty())
     {
         if (OnlineOptions::singleton.has_option("verbose_triples"))
             fprintf(stderr, "out of %s triples\n", T::type_string().c_str());
         InScope in_scope(this->do_count, false, *this);
-        buffer_triples();
+        PrepTelemetry::Refill telemetry(this->telemetry, DATA_TRIPLE, 0);
+        if (producer)
+            producer->get_triples(triples);
+        else
+            refill(DATA_TRIPLE);
+        compact_triples();
+        telemetry.done(n_buffered(DATA_TRIPLE));
+        account_memory();
+        unpack_triples(unpack_size);
         assert(not triples.empty());
     }
 
@@ -290,6 +316,35 @@ void generate_squares(vector<array<T, 2>>& squares, int n_squares,
         squares[i][1] = protocol->finalize_mul();
 }
 
+/**
+ * Inverts all non-zero values in place with a single inversion
+ * (Montgomery's trick), leaving zeros unchanged
+ */
+template<class T>
+void invert_non_zero(vector<T>& values)
+{
+    vector<T> prefixes;
+    prefixes.reserve(values.size());
+    T product = 1;
+    for (auto& x : values)
+    {
+        prefixes.push_back(product);
+        if (x != 0)
+            product *= x;
+    }
+    T inverse = product.invert();
+    for (size_t i = values.size(); i-- > 0;)
+    {
+        auto& x = values[i];
+        if (x != 0)
+        {
+            T x_inverse = inverse * prefixes[i];
+            inverse *= x;
+            x = x_inverse;
+        }
+    }
+}
+
 template<class T>
 void BufferPrep<T>::buffer_inverses()
 {
@@ -308,6 +363,7 @@ void BufferPrep<T>::buffer_inverses(true_type)
     int buffer_size = BaseMachine::batch_size<T>(DATA_INVERSE);
     vector<array<T, 3>> triples(buffer_size);
     vector<T> c;
+    c.reserve(buffer_size);
     for (int i = 0; i < buffer_size; i++)
     {
         prep.get_three_no_count(DATA_TRIPLE, triples[i][0], triples[i][1],
@@ -317,9 +373,10 @@ void BufferPrep<T>::buffer_inverses(true_type)
     vector<typename T::open_type> c_open;
     MC.POpen(c_open, c, P);
     proc->protocol.sync(c_open, P);
+    invert_non_zero(c_open);
     for (size_t i = 0; i < c.size(); i++)
         if (c_open[i] != 0)
-            inverses.push_back({{triples[i][0], triples[i][1] / c_open[i]}});
+            inverses.push_back({{triples[i][0], triples[i][1] * c_open[i]}});
     triples.clear();
     if (inverses.empty())
         throw runtime_error("products were all zero");
@@ -336,7 +393,10 @@ void BufferPrep<T>::get_two_no_count(Dtype dtype, T& a, T& b)
         if (squares.empty())
         {
             InScope in_scope(this->do_count, false, *this);
-            buffer_squares();
+            PrepTelemetry::Refill telemetry(this->telemetry, DATA_SQUARE, 0);
+            refill(DATA_SQUARE);
+            telemetry.done(squares.size());
+            account_memory();
         }
 
         a = squares.back()[0];
@@ -349,7 +409,10 @@ void BufferPrep<T>::get_two_no_count(Dtype dtype, T& a, T& b)
         while (inverses.empty())
         {
             InScope in_scope(this->do_count, false, *this);
+            PrepTelemetry::Refill telemetry(this->telemetry, DATA_INVERSE, 0);
             buffer_inverses();
+            telemetry.done(inverses.size());
+            account_memory();
         }
 
         a = inverses.back()[0];
@@ -975,7 +1038,7 @@ void RingPrep<T>::buffer_edabits_without_check(int n_bits, vector<T>& sums,
 template<class T>
 template<int>
 void RingPrep<T>::buffer_edabits_without_check(int n_bits, vector<edabitvec<T>>& edabits,
-        int buffer_size)
+        int buffer_size, ThreadQueues* queues)
 {
     if (OnlineOptions::singleton.has_option("verbose_eda"))
         fprintf(stderr, "edabit buffer size %d\n", buffer_size);
@@ -983,7 +1046,7 @@ void RingPrep<T>::buffer_edabits_without_check(int n_bits, vector<edabitvec<T>>&
     typedef typename T::bit_type::part_type bit_type;
     vector<vector<bit_type>> bits;
     vector<T> sums;
-    buffer_edabits_without_check<0>(n_bits, sums, bits, buffer_size);
+    buffer_edabits_without_check<0>(n_bits, sums, bits, buffer_size, queues);
     this->push_edabits(edabits, sums, bits);
     (void) stat;
 #ifdef VERBOSE_PREP
@@ -1008,7 +1071,8 @@ void BufferPrep<T>::push_edabits(vector<edabitvec<T>>& edabits,
 
 template<class T>
 template<int>
-void RingPrep<T>::buffer_sedabits_from_edabits(int n_bits, false_type, false_type)
+void RingPrep<T>::buffer_sedabits_from_edabits(int n_bits,
+        ThreadQueues* queues, false_type, false_type)
 {
     assert(this->proc != 0);
     size_t buffer_size = DIV_CEIL(BaseMachine::edabit_batch_size<T>(n_bits),
@@ -1019,8 +1083,8 @@ void RingPrep<T>::buffer_sedabits_from_edabits(int n_bits, false_type, false_typ
     auto& loose = this->edabits[{false, n_bits}];
     BufferScope scope(*this, buffer_size * edabitvec<T>::MAX_SIZE);
     while (loose.size() < buffer_size)
-        this->buffer_edabits(false, n_bits);
-    sanitize<0>(loose, n_bits);
+        this->buffer_edabits(false, n_bits, queues);
+    sanitize<0>(loose, n_bits, queues);
     for (auto& x : loose)
     {
         this->edabits[{true, n_bits}].push_back(x);
@@ -1103,20 +1167,46 @@ void RingPrep<T>::sanitize(vector<edabit<T>>& edabits, int n_bits, int player,
 
 template<class T>
 template<int>
-void RingPrep<T>::sanitize(vector<edabitvec<T>>& edabits, int n_bits)
+void RingPrep<T>::sanitize(vector<edabitvec<T>>& edabits, int n_bits,
+        ThreadQueues* queues)
+{
+    if (queues)
+    {
+        SanitizeVecJob job(&edabits, n_bits);
+        int start = queues->distribute(job, edabits.size());
+        sanitize<0>(edabits, n_bits, start, edabits.size());
+        if (start)
+            queues->wrap_up(job);
+    }
+    else
+        sanitize<0>(edabits, n_bits, 0, edabits.size());
+}
+
+template<class T>
+template<int>
+void RingPrep<T>::sanitize(vector<edabitvec<T>>& edabits, int n_bits,
+        int begin, int end, false_type)
 {
     CODE_LOCATION
+    if (begin >= end)
+        return;
+
+    if (OnlineOptions::singleton.has_option("verbose_eda"))
+        fprintf(stderr, "sanitize edaBit vectors %d to %d in %d\n", begin,
+                end, BaseMachine::thread_num);
+
     vector<T> dabits;
     typedef typename T::bit_type::part_type BT;
     vector<BT> to_open;
-    BufferScope scope(*this, edabits.size() * edabits[0].size());
+    BufferScope scope(*this, (end - begin) * edabits[begin].size());
 
 #ifdef DEBUG_BATCH_SIZE
     cerr << this->dabits.size() << " daBits left before" << endl;
 #endif
 
-    for (auto& x : edabits)
+    for (int k = begin; k < end; k++)
     {
+        auto& x = edabits[k];
         for (size_t j = n_bits; j < x.b.size(); j++)
         {
             BT bits;
@@ -1144,8 +1234,9 @@ void RingPrep<T>::sanitize(vector<edabitvec<T>>& edabits, int n_bits)
     this->proc->protocol.sync(synced, this->proc->P);
     auto dit = dabits.begin();
     auto oit = synced.begin();
-    for (auto& x : edabits)
+    for (int k = begin; k < end; k++)
     {
+        auto& x = edabits[k];
         for (size_t j = n_bits; j < x.b.size(); j++)
         {
             auto masked = (*oit++);
@@ -1209,7 +1300,10 @@ void BufferPrep<T>::get_one_no_count(Dtype dtype, T& a)
     while (bits.empty())
     {
         InScope in_scope(this->do_count, false, *this);
-        buffer_bits();
+        PrepTelemetry::Refill telemetry(this->telemetry, DATA_BIT, 0);
+        refill(DATA_BIT);
+        telemetry.done(bits.size());
+        account_memory();
         n_bit_rounds++;
     }
 
@@ -1226,7 +1320,11 @@ void BufferPrep<T>::get_input_no_count(T& a, typename T::open_type& x, int i)
     if (inputs.at(i).empty())
     {
         InScope in_scope(this->do_count, false, *this);
+        PrepTelemetry::Refill telemetry(this->telemetry, PrepTelemetry::INPUTS,
+                0);
         buffer_inputs(i);
+        telemetry.done(inputs.at(i).size());
+        account_memory();
         assert(not inputs.empty());
     }
     a = inputs[i].back().share;
@@ -1240,8 +1338,11 @@ void BufferPrep<T>::get_dabit_no_count(T& a, typename T::bit_type& b)
     if (dabits.empty())
     {
         InScope in_scope(this->do_count, false, *this);
+        PrepTelemetry::Refill telemetry(this->telemetry, DATA_DABIT, 0);
         ThreadQueues* queues = 0;
         buffer_dabits(queues);
+        telemetry.done(dabits.size());
+        account_memory();
         assert(not dabits.empty());
     }
     a = dabits.back().first;
@@ -1277,7 +1378,11 @@ edabitvec<T> BufferPrep<T>::get_edabitvec(bool strict, int n_bits)
     if (buffer.empty())
     {
         InScope in_scope(this->do_count, false, *this);
+        PrepTelemetry::Refill telemetry(this->telemetry,
+                PrepTelemetry::EDABITS, 0);
         buffer_edabits_with_queues(strict, n_bits);
+        telemetry.done(n_edabits(buffer));
+        account_memory();
     }
     assert(not buffer.empty());
     auto res = buffer.back();
@@ -1356,6 +1461,8 @@ void Preprocessing<T>::get_edabits(bool strict, size_t size, T* a,
 
     for (size_t i = 0; i < size; i++)
         this->usage.count_edabit(strict, n_bits);
+    if (this->telemetry)
+        this->telemetry->consume(PrepTelemetry::EDABITS, size);
 }
 
 template<class T>
@@ -1388,15 +1495,10 @@ void BufferPrep<T>::buffer_inputs_as_usual(int player, SubProcessor<T>* proc)
     if (input.is_me(player))
     {
         SeededPRNG G;
-        vector<typename T::clear> rs;
-        rs.reserve(buffer_size);
-        for (int i = 0; i < buffer_size; i++)
-        {
-            typename T::clear r;
-            r.randomize(G);
+        vector<typename T::clear> rs(buffer_size);
+        G.fill(rs.data(), buffer_size);
+        for (auto& r : rs)
             input.add_mine(r);
-            rs.push_back(r);
-        }
         input.exchange();
         for (auto& r : rs)
             this->inputs[player].push_back({input.finalize(player), r});
@@ -1426,6 +1528,22 @@ template<class T>
 void BufferPrep<T>::shrink_to_fit()
 {
     triples.shrink_to_fit();
+    account_memory();
+}
+
+template<class T>
+void BufferPrep<T>::account_memory()
+{
+    size_t size = triples.capacity() * sizeof(triples[0])
+            + squares.capacity() * sizeof(squares[0])
+            + inverses.capacity() * sizeof(inverses[0])
+            + bits.capacity() * sizeof(T)
+            + dabits.capacity() * sizeof(dabit<T>);
+    for (auto& x : inputs)
+        size += x.capacity() * sizeof(InputTuple<T>);
+    for (auto& x : edabits)
+        size += x.second.capacity() * sizeof(edabitvec<T>);
+    memory.set(size);
 }
 
 template<class T>
@@ -1465,4 +1583,291 @@ void BufferPrep<T>::buffer_extra(Dtype type, int n_items)
     }
 }
 
+template<class T>
+size_t BufferPrep<T>::n_edabits(vector<edabitvec<T>>& buffer)
+{
+    size_t res = 0;
+    for (auto& x : buffer)
+        res += x.size();
+    return res;
+}
+
+template<class T>
+size_t BufferPrep<T>::n_buffered(Dtype type)
+{
+    switch (type)
+    {
+    case DATA_TRIPLE:
+        return triples.size() + packed_triples.size();
+    case DATA_SQUARE:
+        return squares.size();
+    case DATA_BIT:
+        return bits.size();
+    default:
+        throw not_implemented();
+    }
+}
+
+template<class T>
+void BufferPrep<T>::refill(Dtype type)
+{
+    auto& opts = OnlineOptions::singleton;
+
+    Player* P = proc ? &proc->P : this->P;
+
+    // keep explicit sizes
+    if (this->buffer_size or not P or not opts.has_option("adaptive_batch"))
+    {
+        switch (type)
+        {
+        case DATA_TRIPLE:
+            buffer_triples();
+            break;
+        case DATA_SQUARE:
+            buffer_squares();
+            break;
+        case DATA_BIT:
+            buffer_bits();
+            break;
+        default:
+            throw not_implemented();
+        }
+        return;
+    }
+
+    size_t budget = stol(opts.option_value("batch_memory", "100")) * 1000000;
+    size_t max_size = budget / (DataPositions::tuple_size[type] * sizeof(T));
+    size_t initial = BaseMachine::batch_size<T>(type);
+
+    // no more than the rest of the tape unless the static size is more
+    if (BaseMachine::has_program())
+    {
+        auto field_type = T::clear::field_type();
+        long long rest = BaseMachine::get_offline_data_used().files[field_type][type]
+                - this->usage.files[field_type][type];
+        if (rest > 0)
+            max_size = min(max_size, max(size_t(rest), initial));
+    }
+
+    auto& sizer = batch_sizers.at(type);
+    size_t size = sizer.next(initial, max_size);
+
+    size_t before = n_buffered(type);
+    Timer timer;
+    timer.start();
+    buffer_extra(type, size);
+    timer.stop();
+    sizer.update(n_buffered(type) - before, timer.elapsed(), *P);
+}
+
+template<class T>
+template<int>
+void BufferPrep<T>::compact_triples(true_type)
+{
+    // only if the modulus uses fewer limbs than available
+    static bool saves_memory = PackedTuples<T, 3>::saves_memory();
+    if (saves_memory
+            and OnlineOptions::singleton.has_option("compact_triples"))
+        packed_triples.push(triples);
+}
+
+template<class T>
+template<int>
+void BufferPrep<T>::unpack_triples(size_t n, true_type)
+{
+    packed_triples.pop(triples, n);
+}
+
+template<class T>
+void BufferPrep<T>::plan(size_t required, Dtype type)
+{
+    // usual batch size except for the remainder
+    int batch_size = BaseMachine::batch_size<T>(type);
+    PrepTelemetry::Refill telemetry(this->telemetry, type, n_buffered(type),
+            false);
+    while (n_buffered(type) < required)
+    {
+        buffer_extra(type,
+                min(required - n_buffered(type), size_t(batch_size)));
+        if (type == DATA_TRIPLE)
+            compact_triples();
+    }
+    telemetry.done(n_buffered(type));
+    account_memory();
+}
+
+template<class T>
+void BufferPrep<T>::plan(const DataPositions& usage)
+{
+    InScope in_scope(this->do_count, false, *this);
+
+    auto& files = usage.files[T::clear::field_type()];
+    // the compiler counts triples for all multiplications
+    if (not producer and T::Protocol::uses_triples)
+        plan(files[DATA_TRIPLE], DATA_TRIPLE);
+    plan(files[DATA_SQUARE], DATA_SQUARE);
+    plan(files[DATA_BIT], DATA_BIT);
+
+    if (T::clear::characteristic_two)
+        return;
+
+    for (auto& x : usage.edabits)
+    {
+        auto& buffer = edabits[x.first];
+        size_t required = DIV_CEIL(x.second,
+                T::bit_type::part_type::default_length);
+        PrepTelemetry::Refill telemetry(this->telemetry,
+                PrepTelemetry::EDABITS, n_edabits(buffer), false);
+        while (buffer.size() < required)
+            buffer_edabits_with_queues(x.first.first, x.first.second);
+        telemetry.done(n_edabits(buffer));
+        account_memory();
+    }
+}
+
+inline octetStream cache_tag(const octetStream& signature,
+        const octetStream& content)
+{
+    Hash hash;
+    hash.update(signature);
+    hash.update(content);
+    return hash.final();
+}
+
+template<class T>
+string BufferPrep<T>::get_cache_filename(Player& P)
+{
+    return get_prep_sub_dir<T>(P.num_players(), true) + "Cache-P"
+            + to_string(P.my_num()) + "-T" + to_string(BaseMachine::thread_num);
+}
+
+template<class T>
+void BufferPrep<T>::store_cache(Player& P)
+{
+    // identify the run with contributions by all parties
+    octetStream mine;
+    mine.append_random(SEED_SIZE);
+    vector<octetStream> all(P.num_players(), mine);
+    P.unchecked_broadcast(all);
+    octetStream id;
+    for (auto& x : all)
+        id.concat(x);
+
+    // unpack remaining triples
+    unpack_triples(packed_triples.size());
+
+    octetStream os;
+    os.concat(id.hash());
+    os.store(triples.size());
+    for (auto& x : triples)
+        for (auto& y : x)
+            y.pack(os);
+    os.store(squares.size());
+    for (auto& x : squares)
+        for (auto& y : x)
+            y.pack(os);
+    os.store(bits.size());
+    for (auto& x : bits)
+        x.pack(os);
+    os.store(edabits.size());
+    for (auto& x : edabits)
+    {
+        os.store(int(x.first.first));
+        os.store(x.first.second);
+        os.store(x.second.size());
+        for (auto& y : x.second)
+            y.pack(os);
+    }
+
+    auto signature = file_signature<T>();
+    string filename = get_cache_filename(P);
+    ofstream out(filename, ios::binary);
+    signature.output(out);
+    os.output(out);
+    cache_tag(signature, os).output(out);
+    if (not out.good())
+        throw file_error(filename);
+
+    if (OnlineOptions::singleton.verbose)
+        cerr << "Stored " << triples.size() << " triples, " << squares.size()
+                << " squares, " << bits.size() << " bits, and "
+                << edabits.size() << " types of edaBits of " << T::type_string()
+                << " in " << filename << endl;
+}
+
+template<class T>
+void BufferPrep<T>::load_cache(Player& P)
+{
+    string filename = get_cache_filename(P);
+    octetStream signature, os, tag;
+    ifstream in(filename, ios::binary);
+    bool valid = false;
+    if (in.good())
+    {
+        try
+        {
+            signature.input(in);
+            os.input(in);
+            tag.input(in);
+            valid = signature == file_signature<T>()
+                    and tag == cache_tag(signature, os);
+        }
+        catch (exception&)
+        {
+        }
+    }
+
+    // never use the same preprocessing twice
+    in.close();
+    remove(filename.c_str());
+
+    // all parties must have stored in the same run
+    octetStream id;
+    if (valid)
+        os.consume(id, crypto_generichash_BYTES_MIN);
+    vector<octetStream> all(P.num_players(), id);
+    P.unchecked_broadcast(all);
+    for (auto& x : all)
+        valid &= x == id;
+
+    if (not valid)
+    {
+        if (signature.get_length())
+            cerr << "Ignoring " << filename << " from another run or setting"
+                    << endl;
+        return;
+    }
+
+    triples.resize(os.get_int(sizeof(size_t)));
+    for (auto& x : triples)
+        for (auto& y : x)
+            y.unpack(os);
+    squares.resize(os.get_int(sizeof(size_t)));
+    for (auto& x : squares)
+        for (auto& y : x)
+            y.unpack(os);
+    bits.resize(os.get_int(sizeof(size_t)));
+    for (auto& x : bits)
+        x.unpack(os);
+    size_t n_types = os.get_int(sizeof(size_t));
+    for (size_t i = 0; i < n_types; i++)
+    {
+        int strict, n_bits;
+        os.get(strict);
+        os.get(n_bits);
+        auto& buffer = edabits[{strict, n_bits}];
+        buffer.resize(os.get_int(sizeof(size_t)));
+        for (auto& x : buffer)
+        {
+            x.a.unpack(os);
+            x.b.unpack(os);
+        }
+    }
+
+    if (OnlineOptions::singleton.verbose)
+        cerr << "Loaded " << triples.size() << " triples, " << squares.size()
+                << " squares, and " << bits.size() << " bits of "
+                << T::type_string() << " from " << filename << endl;
+}
+
 #endif
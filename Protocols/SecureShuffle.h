@@ -7,27 +7,47 @@
 #define PROTOCOLS_SECURESHUFFLE_H_
 
 #include <vector>
+#include <set>
+#include <array>
+#include <atomic>
+#include <memory>
 using namespace std;
 
 #include "Tools/Lock.h"
 
 template<class T> class SubProcessor;
 
+/**
+ * Immutable shuffles by handle. Only adding and deleting take the lock,
+ * while lookups read reference-counted pointers from chunks that are
+ * never moved.
+ */
 template<class T>
 class ShuffleStore
 {
     typedef T shuffle_type;
+    typedef shared_ptr<const shuffle_type> pointer;
+
+    static const int CHUNK_SIZE = 1 << 10;
+    static const int MAX_CHUNKS = 1 << 12;
+
+    typedef array<pointer, CHUNK_SIZE> chunk_type;
 
-    deque<shuffle_type> shuffles;
+    array<atomic<chunk_type*>, MAX_CHUNKS> chunks;
+    int n_handles;
+    // deleted handles to be reused
+    set<int> free_handles;
 
     Lock store_lock;
 
-    void lock();
-    void unlock();
+    pointer& slot(int handle) const;
 
 public:
-    int add();
-    shuffle_type& get(int handle);
+    ShuffleStore();
+    ~ShuffleStore();
+
+    int add(shuffle_type&& shuffle);
+    pointer get(int handle) const;
     void del(int handle);
 };
 
@@ -41,6 +61,11 @@ public:
 private:
     SubProcessor<T>& proc;
 
+    int n_threads;
+
+    template<class U>
+    void run_parallel(size_t n, const U& job);
+
     /**
      * Generates and returns a newly generated random permutation. This permutation is generated locally.
      *
@@ -9,59 +9,91 @@
 #include "SecureShuffle.h"
 #include "Tools/Waksman.h"
 #include "Tools/CodeLocations.h"
+#include "Tools/ParallelJobs.h"
+#include "Processor/OnlineOptions.h"
 
 #include <math.h>
 #include <algorithm>
 
 template<class T>
-void ShuffleStore<T>::lock()
+ShuffleStore<T>::ShuffleStore() :
+        n_handles(0)
 {
-    store_lock.lock();
+    for (auto& chunk : chunks)
+        chunk = 0;
 }
 
 template<class T>
-void ShuffleStore<T>::unlock()
+ShuffleStore<T>::~ShuffleStore()
 {
-    store_lock.unlock();
+    for (auto& chunk : chunks)
+        delete chunk.load();
 }
 
 template<class T>
-int ShuffleStore<T>::add()
+typename ShuffleStore<T>::pointer& ShuffleStore<T>::slot(int handle) const
 {
-    lock();
-    int res = shuffles.size();
-    shuffles.push_back({});
-    unlock();
+    chunk_type* chunk = 0;
+    if (handle >= 0 and handle < CHUNK_SIZE * MAX_CHUNKS)
+        chunk = chunks[handle / CHUNK_SIZE].load();
+    if (chunk == 0)
+        throw runtime_error("invalid shuffle handle");
+    return (*chunk)[handle % CHUNK_SIZE];
+}
+
+template<class T>
+int ShuffleStore<T>::add(shuffle_type&& shuffle)
+{
+    auto res_pointer = make_shared<const shuffle_type>(move(shuffle));
+    ScopeLock _(store_lock);
+    int res;
+    if (free_handles.empty())
+    {
+        res = n_handles++;
+        if (res >= CHUNK_SIZE * MAX_CHUNKS)
+            throw runtime_error("too many shuffles");
+        auto& chunk = chunks[res / CHUNK_SIZE];
+        if (chunk.load() == 0)
+            chunk = new chunk_type;
+    }
+    else
+    {
+        res = *free_handles.begin();
+        free_handles.erase(free_handles.begin());
+    }
+    atomic_store(&slot(res), res_pointer);
     return res;
 }
 
 template<class T>
-typename ShuffleStore<T>::shuffle_type& ShuffleStore<T>::get(int handle)
+typename ShuffleStore<T>::pointer ShuffleStore<T>::get(int handle) const
 {
-    lock();
-    auto& res = shuffles.at(handle);
-    unlock();
+    auto res = atomic_load(&slot(handle));
+    if (not res)
+        throw runtime_error("shuffle has been deleted");
     return res;
 }
 
 template<class T>
 void ShuffleStore<T>::del(int handle)
 {
-    lock();
-    shuffles.at(handle) = {};
-    unlock();
+    ScopeLock _(store_lock);
+    // threads still using the shuffle keep their reference
+    atomic_store(&slot(handle), pointer());
+    free_handles.insert(handle);
 }
 
 template<class T>
 SecureShuffle<T>::SecureShuffle(SubProcessor<T>& proc) :
         proc(proc)
 {
+    n_threads = ParallelJobs::n_threads("shuffle_threads");
 }
 
 template<class T>
 SecureShuffle<T>::SecureShuffle(StackedVector<T>& a, size_t n, int unit_size,
         size_t output_base, size_t input_base, SubProcessor<T>& proc) :
-        proc(proc)
+        SecureShuffle(proc)
 {
     store_type store;
     int handle = generate(n / unit_size, store);
@@ -70,7 +102,7 @@ SecureShuffle<T>::SecureShuffle(StackedVector<T>& a, size_t n, int unit_size,
     vector<size_t> unit_sizes{static_cast<size_t>(unit_size)};
     vector<size_t> destinations{output_base};
     vector<size_t> sources{input_base};
-    vector<shuffle_type> shuffles{store.get(handle)};
+    vector<shuffle_type> shuffles{*store.get(handle)};
     vector<bool> reverses{true};
     this->apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles, reverses);
 }
@@ -80,7 +112,7 @@ void SecureShuffle<T>::apply_multiple(StackedVector<T>& a, vector<size_t>& sizes
                                     vector<size_t>& unit_sizes, vector<size_t>& handles, vector<bool>& reverse, store_type& store) {
     vector<shuffle_type> shuffles;
     for (size_t &handle : handles)
-        shuffles.push_back(store.get(handle));
+        shuffles.push_back(*store.get(handle));
 
     this->apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles, reverse);
 }
@@ -336,8 +368,7 @@ vector<int> SecureShuffle<T>::generate_random_permutation(int n) {
 template<class T>
 int SecureShuffle<T>::generate(int n_shuffle, store_type& store)
 {
-    int res = store.add();
-    auto& shuffle = store.get(res);
+    shuffle_type shuffle;
 
     for (auto i: proc.protocol.get_relevant_players()) {
         vector<int> perm;
@@ -347,7 +378,7 @@ int SecureShuffle<T>::generate(int n_shuffle, store_type& store)
         shuffle.push_back(config);
     }
 
-    return res;
+    return store.add(move(shuffle));
 }
 
 template<class T>
@@ -461,6 +492,14 @@ void SecureShuffle<T>::parallel_waksman_round(size_t pass, int depth, bool inwar
     }
 }
 
+template<class T>
+template<class U>
+void SecureShuffle<T>::run_parallel(size_t n, const U& job)
+{
+    ParallelJobs::run(n, n_threads,
+            [&](int, size_t begin, size_t end) { job(begin, end); }, 1 << 12);
+}
+
 template<class T>
 vector<array<int, 5>> SecureShuffle<T>::waksman_round_init(vector<T> &toShuffle, size_t shuffle_unit_size, int depth, vector<vector<T>> &iter_waksman_config, bool inwards, bool reverse) {
     int n = toShuffle.size() / shuffle_unit_size;
@@ -468,28 +507,40 @@ vector<array<int, 5>> SecureShuffle<T>::waksman_round_init(vector<T> &toShuffle,
     int n_blocks = 1 << depth;
     int size = n / (2 * n_blocks);
     bool outwards = !inwards;
-    vector<array<int, 5>> indices;
-    indices.reserve(n / 2);
+    vector<array<int, 5>> indices(n / 2);
+    vector<T> diffs(toShuffle.size() / 2);
+    vector<int> bits(n / 2);
     Waksman waksman(n);
-    for (int k = 0; k < n / 2; k++)
+
+    // the local part of the layer is independent per switch
+    run_parallel(n / 2, [&](size_t begin, size_t end)
     {
-        int j = k % size;
-        int i = k / size;
-        int base = 2 * i * size;
-        int in1 = base + j + j * inwards;
-        int in2 = in1 + inwards + size * outwards;
-        int out1 = base + j + j * outwards;
-        int out2 = out1 + outwards + size * inwards;
-        int i_bit = base + j + size * (outwards ^ reverse);
-        bool run = waksman.matters(depth, i_bit);
-        if (run)
+        for (size_t k = begin; k < end; k++)
         {
-            for (size_t l = 0; l < shuffle_unit_size; l++)
-                proc.protocol.prepare_mul(iter_waksman_config.at(depth).at(i_bit),
-                        toShuffle.at(in1 * shuffle_unit_size + l) - toShuffle.at(in2 * shuffle_unit_size + l));
+            int j = k % size;
+            int i = k / size;
+            int base = 2 * i * size;
+            int in1 = base + j + j * inwards;
+            int in2 = in1 + inwards + size * outwards;
+            int out1 = base + j + j * outwards;
+            int out2 = out1 + outwards + size * inwards;
+            int i_bit = base + j + size * (outwards ^ reverse);
+            bool run = waksman.matters(depth, i_bit);
+            if (run)
+                for (size_t l = 0; l < shuffle_unit_size; l++)
+                    diffs[k * shuffle_unit_size + l] = toShuffle[in1
+                            * shuffle_unit_size + l]
+                            - toShuffle[in2 * shuffle_unit_size + l];
+            indices[k] = {in1, in2, out1, out2, run};
+            bits[k] = i_bit;
         }
-        indices.push_back({in1, in2, out1, out2, run});
-    }
+    });
+
+    for (int k = 0; k < n / 2; k++)
+        if (indices[k][4])
+            for (size_t l = 0; l < shuffle_unit_size; l++)
+                proc.protocol.prepare_mul(iter_waksman_config.at(depth).at(bits[k]),
+                        diffs[k * shuffle_unit_size + l]);
     return indices;
 }
 
@@ -497,24 +548,31 @@ template<class T>
 void SecureShuffle<T>::waksman_round_finish(vector<T> &toShuffle, size_t unit_size, vector<array<int, 5>> indices) {
     int n = toShuffle.size() / unit_size;
 
-    vector<T> tmp(toShuffle.size());
+    // results have to be taken in order
+    vector<T> diffs(toShuffle.size() / 2);
     for (int k = 0; k < n / 2; k++)
+        if (indices[k][4])
+            for (size_t l = 0; l < unit_size; l++)
+                diffs[k * unit_size + l] = proc.protocol.finalize_mul();
+
+    vector<T> tmp(toShuffle.size());
+    run_parallel(n / 2, [&](size_t begin, size_t end)
     {
-        auto idx = indices.at(k);
-        for (size_t l = 0; l < unit_size; l++)
+        for (size_t k = begin; k < end; k++)
         {
-            T diff;
-            if (idx[4])
-                diff = proc.protocol.finalize_mul();
-            tmp.at(idx[2] * unit_size + l) = toShuffle.at(
-                    idx[0] * unit_size + l) - diff;
-            tmp.at(idx[3] * unit_size + l) = toShuffle.at(
-                    idx[1] * unit_size + l) + diff;
+            auto& idx = indices[k];
+            for (size_t l = 0; l < unit_size; l++)
+            {
+                auto& diff = diffs[k * unit_size + l];
+                tmp[idx[2] * unit_size + l] = toShuffle[idx[0] * unit_size + l]
+                        - diff;
+                tmp[idx[3] * unit_size + l] = toShuffle[idx[1] * unit_size + l]
+                        + diff;
+            }
         }
-    }
+    });
 
     swap(tmp, toShuffle);
 }
 
-
 #endif /* PROTOCOLS_SECURESHUFFLE_HPP_ */
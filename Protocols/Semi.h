@@ -7,6 +7,7 @@
 #define PROTOCOLS_SEMI_H_
 
 #include "Beaver.h"
+#include "SemiShuffler.h"
 #include "Processor/TruncPrTuple.h"
 
 /**
@@ -18,6 +19,8 @@ class Semi : public Beaver<T>
     SeededPRNG G;
 
 public:
+    typedef SemiShuffler<T> Shuffler;
+
     Semi(Player& P) :
             Beaver<T>(P)
     {
@@ -16,10 +16,13 @@ template<class T>
 class SemiMC : public TreeSum<typename T::open_type>, public MAC_Check_Base<T>
 {
 protected:
+    // change the party summing the shares with every opening
+    bool rotate;
 
 public:
     // emulate MAC_Check
-    SemiMC(const typename T::mac_key_type& _ = {}, int __ = 0, int ___ = 0)
+    SemiMC(const typename T::mac_key_type& _ = {}, int __ = 0, int ___ = 0) :
+            rotate(OnlineOptions::singleton.has_option("rotate_opening"))
     { (void)_; (void)__; (void)___; }
     virtual ~SemiMC() {}
 
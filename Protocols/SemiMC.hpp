@@ -29,6 +29,8 @@ template<class T>
 void SemiMC<T>::exchange(const Player& P)
 {
     this->run(this->values, P);
+    if (rotate and not this->values.empty())
+        this->base_player = (this->base_player + 1) % P.num_players();
 }
 
 template<class T>
@@ -49,11 +51,11 @@ template<class T>
 void DirectSemiMC<T>::exchange_(const PlayerBase& P)
 {
     CODE_LOCATION
-    Bundle<octetStream> oss(P);
+    PooledBundle oss(P);
     oss.mine.reserve(this->values.size());
     assert(this->values.size() == this->lengths.size());
-    for (size_t i = 0; i < this->lengths.size(); i++)
-        this->values[i].pack(oss.mine, this->lengths[i]);
+    oss.mine.store_range(this->values.data(), this->values.size(),
+            this->lengths.data());
     oss.mine.append(0);
     P.unchecked_broadcast(oss);
     size_t n = P.num_players();
@@ -74,9 +76,8 @@ void DirectSemiMC<T>::POpen_Begin(vector<typename T::open_type>& values,
 {
     values.clear();
     values.insert(values.begin(), S.begin(), S.end());
-    octetStream os;
-    for (auto& x : values)
-        x.pack(os);
+    PooledOctetStream os(P.stream_pool);
+    os.store_range(values.data(), values.size());
     P.send_all(os);
 }
 
@@ -84,7 +85,7 @@ template<class T>
 void DirectSemiMC<T>::POpen_End(vector<typename T::open_type>& values,
         const vector<T>&, const Player& P)
 {
-    Bundle<octetStream> oss(P);
+    PooledBundle oss(P);
     P.receive_all(oss);
     direct_add_openings<typename T::open_type>(values, P, oss);
 }
@@ -25,15 +25,23 @@ void SemiPrep<T>::buffer_triples()
 {
     CODE_LOCATION
     assert(this->triple_generator);
-    this->triple_generator->set_batch_size(
-            BaseMachine::batch_size<T>(DATA_TRIPLE));
-    this->triple_generator->generatePlainTriples();
-    this->triple_generator->set_batch_size(OnlineOptions::singleton.batch_size);
-    for (auto& x : this->triple_generator->plainTriples)
+    size_t required = BaseMachine::batch_size<T>(DATA_TRIPLE,
+            this->buffer_size);
+
+    // the generator limits the batch to bound memory
+    size_t n_done = 0;
+    while (n_done < required)
     {
-        this->triples.push_back({{x[0], x[1], x[2]}});
+        this->triple_generator->set_batch_size(required - n_done);
+        this->triple_generator->generatePlainTriples();
+        for (auto& x : this->triple_generator->plainTriples)
+        {
+            this->triples.push_back({{x[0], x[1], x[2]}});
+        }
+        this->triple_generator->unlock();
+        n_done += this->triple_generator->plainTriples.size();
     }
-    this->triple_generator->unlock();
+    this->triple_generator->set_batch_size(OnlineOptions::singleton.batch_size);
 }
 
 template<class T>
@@ -25,9 +25,9 @@ class SemiPrep2k : public SemiPrep<T>, public RepRingOnlyEdabitPrep<T>
         BufferPrep<T>::buffer_edabits(strict, n_bits, queues);
     }
 
-    void buffer_sedabits(int n_bits, ThreadQueues*)
+    void buffer_sedabits(int n_bits, ThreadQueues* queues)
     {
-        this->buffer_sedabits_from_edabits(n_bits);
+        this->buffer_sedabits_from_edabits(n_bits, queues);
     }
 
 public:
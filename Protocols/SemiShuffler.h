@@ -0,0 +1,173 @@
+/*
+ * SemiShuffler.h
+ *
+ */
+
+#ifndef PROTOCOLS_SEMISHUFFLER_H_
+#define PROTOCOLS_SEMISHUFFLER_H_
+
+#include "SecureShuffle.h"
+#include "Tools/random.h"
+
+#include <math.h>
+#include <atomic>
+#include <memory>
+
+class OTExtensionWithMatrix;
+class VirtualTwoPartyPlayer;
+
+/**
+ * Masks and shares of the permuted masks for applying a permutation
+ * once in one direction with one element per unit
+ */
+template<class T>
+struct SemiCorrelation
+{
+    // only used by the generating thread to keep the parties in sync
+    int thread;
+    atomic<bool> used;
+    // per other player: input and output masks for their pass,
+    // shares of the permuted masks for my pass
+    vector<vector<T>> inputs, outputs, sums;
+
+    SemiCorrelation(int thread) : thread(thread), used(false) {}
+};
+
+/**
+ * Permutation known to this player only, stored as seed and expanded
+ * when applied, with correlations generated in advance
+ */
+template<class T>
+class SemiPermutation
+{
+    array<octet, SEED_SIZE> seed;
+    int n = -1;
+
+public:
+    // by direction (forward or reverse)
+    array<shared_ptr<SemiCorrelation<T>>, 2> correlations;
+
+    SemiPermutation() {}
+
+    SemiPermutation(int n, PRNG& G) :
+            n(n)
+    {
+        G.get_octets(seed.data(), SEED_SIZE);
+    }
+
+    bool empty() const
+    {
+        return n < 0;
+    }
+
+    /// Padded to a power of two, element ``i`` goes to position ``res[i]``
+    vector<int> expand(bool reverse) const
+    {
+        assert(not empty());
+        vector<int> res;
+        int n_pow2 = n ? 1 << int(ceil(log2(n))) : 0;
+        for (int i = 0; i < n_pow2; i++)
+            res.push_back(i);
+        PRNG G;
+        G.SetSeed(seed.data());
+        for (int i = 0; i < n; i++)
+            swap(res[i], res[i + G.get_uint(n - i)]);
+        if (reverse)
+        {
+            vector<int> inverse(n_pow2);
+            for (int i = 0; i < n_pow2; i++)
+                inverse[res[i]] = i;
+            return inverse;
+        }
+        return res;
+    }
+
+    /// Correlation for one application if still available to this thread
+    shared_ptr<SemiCorrelation<T>> take_correlation(bool reverse,
+            size_t unit_size, int thread) const
+    {
+        auto& res = correlations.at(reverse);
+        if (res and unit_size == 1 and res->thread == thread
+                and not res->used.exchange(true))
+            return res;
+        else
+            return {};
+    }
+};
+
+/**
+ * Shuffling for semi-honest additive secret sharing. Every player
+ * applies its own permutation in turn using a correlation consisting
+ * of random masks and shares of the permuted masks. The correlations are
+ * generated with random OT along a Waksman network, one pair of players
+ * after the other, after which every pass only requires sending the
+ * masked shares to the player knowing the permutation. Generating a
+ * shuffle includes one correlation per direction for one element per
+ * unit. Further applications generate their correlations when applying.
+ */
+template<class T>
+class SemiShuffler
+{
+public:
+    typedef SemiPermutation<T> shuffle_type;
+    typedef ShuffleStore<shuffle_type> store_type;
+
+private:
+    struct Network
+    {
+        size_t n, unit_size;
+        int depth;
+        // element i goes to position perm[i]
+        vector<int> perm;
+        vector<vector<bool>> config;
+        vector<T> data;
+        // per other player: input and output masks for their pass,
+        // shares of the permuted masks for my pass
+        vector<vector<T>> inputs, outputs, sums;
+    };
+
+    // switches per OT extension
+    static const size_t OT_BATCH = 1 << 20;
+
+    SubProcessor<T>& proc;
+
+    SeededPRNG G;
+
+    vector<unique_ptr<VirtualTwoPartyPlayer>> players;
+    vector<unique_ptr<OTExtensionWithMatrix>> ot_exts;
+
+    OTExtensionWithMatrix& get_ot(int other);
+
+    // inputs, outputs, and index of configuration bit (-1 if fixed)
+    static vector<array<int, 5>> get_switches(int n, int depth, bool inwards);
+
+    static void pad(vector<T>& res, const octet* key);
+
+    void init(Network& network, const shuffle_type& shuffle, bool reverse,
+            size_t unit_size);
+
+    void correlate(vector<Network*>& networks);
+    void correlate(int other, vector<Network*>& networks,
+            const vector<pair<int, bool>>& layers);
+
+public:
+    map<long, long> stats;
+
+    SemiShuffler(StackedVector<T>& a, size_t n, int unit_size, size_t output_base,
+            size_t input_base, SubProcessor<T>& proc);
+
+    SemiShuffler(SubProcessor<T>& proc);
+    ~SemiShuffler();
+
+    int generate(int n_shuffle, store_type& store);
+
+    void apply_multiple(StackedVector<T>& a, vector<size_t>& sizes, vector<size_t>& destinations, vector<size_t>& sources,
+                       vector<size_t>& unit_sizes, vector<size_t>& handles, vector<bool>& reverse, store_type& store);
+    void apply_multiple(StackedVector<T>& a, vector<size_t>& sizes, vector<size_t>& destinations, vector<size_t>& sources,
+                       vector<size_t>& unit_sizes, vector<shuffle_type>& shuffles, vector<bool>& reverse);
+
+    void inverse_permutation(StackedVector<T>& stack, size_t n, size_t output_base,
+            size_t input_base);
+};
+
+#endif /* PROTOCOLS_SEMISHUFFLER_H_ */
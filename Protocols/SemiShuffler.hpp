@@ -0,0 +1,462 @@
+/*
+ * SemiShuffler.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_SEMISHUFFLER_HPP_
+#define PROTOCOLS_SEMISHUFFLER_HPP_
+
+#include "SemiShuffler.h"
+#include "SecureShuffle.hpp"
+#include "OT/OTExtensionWithMatrix.h"
+#include "Networking/Player.h"
+#include "Tools/Waksman.h"
+#include "Tools/CodeLocations.h"
+#include "Processor/BaseMachine.h"
+
+template<class T>
+SemiShuffler<T>::SemiShuffler(StackedVector<T>& a, size_t n, int unit_size,
+        size_t output_base, size_t input_base, SubProcessor<T>& proc) :
+        SemiShuffler(proc)
+{
+    // used once, so the correlation is generated when applying
+    vector<size_t> sizes{n};
+    vector<size_t> unit_sizes{static_cast<size_t>(unit_size)};
+    vector<size_t> destinations{output_base};
+    vector<size_t> sources{input_base};
+    vector<shuffle_type> shuffles{shuffle_type(n / unit_size, G)};
+    vector<bool> reverses{true};
+    apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles,
+            reverses);
+}
+
+template<class T>
+SemiShuffler<T>::SemiShuffler(SubProcessor<T>& proc) :
+        proc(proc)
+{
+}
+
+template<class T>
+SemiShuffler<T>::~SemiShuffler()
+{
+}
+
+template<class T>
+int SemiShuffler<T>::generate(int n_shuffle, store_type& store)
+{
+    CODE_LOCATION
+    // everyone only knows their own permutation
+    shuffle_type shuffle(n_shuffle, G);
+
+    // correlations for applying in both directions, so that applying
+    // only requires the passes
+    vector<Network> networks(2);
+    vector<Network*> pointers;
+    for (int reverse = 0; reverse < 2; reverse++)
+    {
+        init(networks[reverse], shuffle, reverse, 1);
+        pointers.push_back(&networks[reverse]);
+    }
+
+    correlate(pointers);
+
+    for (int reverse = 0; reverse < 2; reverse++)
+    {
+        auto& network = networks[reverse];
+        auto correlation = make_shared<SemiCorrelation<T>>(
+                BaseMachine::thread_num);
+        correlation->inputs = move(network.inputs);
+        correlation->outputs = move(network.outputs);
+        correlation->sums = move(network.sums);
+        shuffle.correlations[reverse] = correlation;
+    }
+
+    return store.add(move(shuffle));
+}
+
+template<class T>
+void SemiShuffler<T>::init(Network& network, const shuffle_type& shuffle,
+        bool reverse, size_t unit_size)
+{
+    if (shuffle.empty())
+        throw runtime_error("shuffle has been deleted");
+
+    int n_players = proc.P.num_players();
+    network.unit_size = unit_size;
+    network.perm = shuffle.expand(reverse);
+    network.n = network.perm.size();
+    network.depth = network.n ? log2(network.n) : 0;
+    if (network.n > 1)
+        network.config = Waksman::configure(network.perm);
+    network.data.resize(network.n * unit_size);
+    network.inputs.resize(n_players);
+    network.outputs.resize(n_players);
+    network.sums.resize(n_players);
+}
+
+template<class T>
+OTExtensionWithMatrix& SemiShuffler<T>::get_ot(int other)
+{
+    auto& P = proc.P;
+    if (ot_exts.empty())
+    {
+        players.resize(P.num_players());
+        ot_exts.resize(P.num_players());
+    }
+
+    if (not ot_exts[other])
+    {
+        players[other].reset(new VirtualTwoPartyPlayer(P, other));
+        ot_exts[other].reset(
+                new OTExtensionWithMatrix(
+                        OTExtensionWithMatrix::setup(*players[other],
+                                G.get_doubleword(), BOTH, true)));
+    }
+
+    return *ot_exts[other];
+}
+
+template<class T>
+vector<array<int, 5>> SemiShuffler<T>::get_switches(int n, int depth,
+        bool inwards)
+{
+    // same layout as SecureShuffle
+    int n_blocks = 1 << depth;
+    int size = n / (2 * n_blocks);
+    bool outwards = not inwards;
+    Waksman waksman(n);
+    vector<array<int, 5>> res;
+    for (int k = 0; k < n / 2; k++)
+    {
+        int j = k % size;
+        int base = 2 * (k / size) * size;
+        int in1 = base + j + j * inwards;
+        int in2 = in1 + inwards + size * outwards;
+        int out1 = base + j + j * outwards;
+        int out2 = out1 + outwards + size * inwards;
+        int i_bit = base + j + size * outwards;
+        res.push_back({in1, in2, out1, out2,
+            waksman.matters(depth, i_bit) ? i_bit : -1});
+    }
+    return res;
+}
+
+template<class T>
+void SemiShuffler<T>::pad(vector<T>& res, const octet* key)
+{
+    octet seed[SEED_SIZE] = {};
+    memcpy(seed, key, min(SEED_SIZE, 16));
+    PRNG G;
+    G.SetSeed(seed);
+    for (auto& x : res)
+        x.randomize(G);
+}
+
+template<class T>
+void SemiShuffler<T>::correlate(vector<Network*>& networks)
+{
+    if (networks.empty())
+        return;
+
+    int max_depth = 0;
+    for (auto network : networks)
+        max_depth = max(max_depth, network->depth);
+
+    vector<pair<int, bool>> layers;
+    for (int depth = 0; depth < max_depth; depth++)
+        layers.push_back({depth, true});
+    for (int depth = max_depth - 2; depth >= 0; depth--)
+        layers.push_back({depth, false});
+
+    // all pairs in the same order to avoid deadlocks,
+    // so the rounds grow with the number of players
+    auto& P = proc.P;
+    for (int other = 0; other < P.num_players(); other++)
+        if (other != P.my_num())
+            correlate(other, networks, layers);
+}
+
+template<class T>
+void SemiShuffler<T>::correlate(int other, vector<Network*>& networks,
+        const vector<pair<int, bool>>& layers)
+{
+    auto& ot_ext = get_ot(other);
+    auto applies = [](Network& network, const pair<int, bool>& layer)
+    {
+        return layer.first < network.depth - not layer.second;
+    };
+
+    // As the OT sender, this player chooses random masks for every wire
+    // and sends the differences to the next wire according to both
+    // choices of every switch. As the OT receiver, the other player
+    // thus learns the differences according to its configuration,
+    // which it adds up along the network.
+    vector<vector<T>> masks, sums;
+    for (auto network : networks)
+    {
+        auto& input = network->inputs[other];
+        input.resize(network->data.size());
+        for (auto& x : input)
+            x.randomize(G);
+        masks.push_back(input);
+        sums.push_back(vector<T>(network->data.size()));
+    }
+
+    size_t begin = 0;
+    while (begin < layers.size())
+    {
+        // limit the memory used by OT extension
+        size_t end = begin, n_ots = 0;
+        while (end < layers.size())
+        {
+            size_t n_layer = 0;
+            for (auto network : networks)
+                if (applies(*network, layers[end]))
+                    for (auto& s : get_switches(network->n, layers[end].first,
+                            layers[end].second))
+                        n_layer += s[4] >= 0;
+            if (n_ots > 0 and n_ots + n_layer > OT_BATCH)
+                break;
+            n_ots += n_layer;
+            end++;
+        }
+
+        BitVector choices(n_ots);
+        size_t i_ot = 0;
+        for (size_t l = begin; l < end; l++)
+            for (auto network : networks)
+                if (applies(*network, layers[l]))
+                    for (auto& s : get_switches(network->n, layers[l].first,
+                            layers[l].second))
+                        if (s[4] >= 0)
+                            choices.set_bit(i_ot++,
+                                    network->config[layers[l].first][s[4]]);
+
+        ot_ext.extend(n_ots, choices);
+
+        octetStream to_send, received;
+        i_ot = 0;
+        for (size_t l = begin; l < end; l++)
+            for (size_t k = 0; k < networks.size(); k++)
+            {
+                auto& network = *networks[k];
+                if (not applies(network, layers[l]))
+                    continue;
+                size_t unit_size = network.unit_size;
+                auto& mask = masks[k];
+                vector<T> next(mask.size()), key_pad(2 * unit_size);
+                for (auto& s : get_switches(network.n, layers[l].first,
+                        layers[l].second))
+                {
+                    if (s[4] < 0)
+                    {
+                        for (int i = 0; i < 2; i++)
+                            for (size_t j = 0; j < unit_size; j++)
+                                next[s[2 + i] * unit_size + j] = mask[s[i]
+                                        * unit_size + j];
+                        continue;
+                    }
+                    for (int i = 0; i < 2; i++)
+                        for (size_t j = 0; j < unit_size; j++)
+                            next[s[2 + i] * unit_size + j].randomize(G);
+                    for (int b = 0; b < 2; b++)
+                    {
+                        pad(key_pad, ot_ext.get_sender_output(b, i_ot));
+                        for (size_t j = 0; j < unit_size; j++)
+                            for (int i = 0; i < 2; i++)
+                                (mask[s[i ^ b] * unit_size + j]
+                                        - next[s[2 + i] * unit_size + j]
+                                        + key_pad[i * unit_size + j]).pack(
+                                        to_send);
+                    }
+                    i_ot++;
+                }
+                swap(mask, next);
+            }
+
+        proc.P.exchange(other, to_send, received);
+
+        i_ot = 0;
+        for (size_t l = begin; l < end; l++)
+            for (size_t k = 0; k < networks.size(); k++)
+            {
+                auto& network = *networks[k];
+                if (not applies(network, layers[l]))
+                    continue;
+                size_t unit_size = network.unit_size;
+                auto& sum = sums[k];
+                vector<T> next(sum.size()), key_pad(2 * unit_size);
+                for (auto& s : get_switches(network.n, layers[l].first,
+                        layers[l].second))
+                {
+                    if (s[4] < 0)
+                    {
+                        for (int i = 0; i < 2; i++)
+                            for (size_t j = 0; j < unit_size; j++)
+                                next[s[2 + i] * unit_size + j] = sum[s[i]
+                                        * unit_size + j];
+                        continue;
+                    }
+                    int my_bit = network.config[layers[l].first][s[4]];
+                    pad(key_pad, ot_ext.get_receiver_output(i_ot++));
+                    for (int b = 0; b < 2; b++)
+                        for (size_t j = 0; j < unit_size; j++)
+                            for (int i = 0; i < 2; i++)
+                            {
+                                T x;
+                                x.unpack(received);
+                                if (b == my_bit)
+                                    next[s[2 + i] * unit_size + j] = sum[s[i
+                                            ^ b] * unit_size + j] + x
+                                            - key_pad[i * unit_size + j];
+                            }
+                }
+                swap(sum, next);
+            }
+
+        begin = end;
+    }
+
+    for (size_t k = 0; k < networks.size(); k++)
+    {
+        networks[k]->outputs[other] = masks[k];
+        networks[k]->sums[other] = sums[k];
+    }
+}
+
+template<class T>
+void SemiShuffler<T>::apply_multiple(StackedVector<T>& a, vector<size_t>& sizes,
+        vector<size_t>& destinations, vector<size_t>& sources,
+        vector<size_t>& unit_sizes, vector<size_t>& handles,
+        vector<bool>& reverses, store_type& store)
+{
+    vector<shuffle_type> shuffles;
+    for (size_t& handle : handles)
+        shuffles.push_back(*store.get(handle));
+
+    apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles,
+            reverses);
+}
+
+template<class T>
+void SemiShuffler<T>::apply_multiple(StackedVector<T>& a, vector<size_t>& sizes,
+        vector<size_t>& destinations, vector<size_t>& sources,
+        vector<size_t>& unit_sizes, vector<shuffle_type>& shuffles,
+        vector<bool>& reverses)
+{
+    CODE_LOCATION
+    const auto n_shuffles = sizes.size();
+    assert(sources.size() == n_shuffles);
+    assert(destinations.size() == n_shuffles);
+    assert(unit_sizes.size() == n_shuffles);
+    assert(shuffles.size() == n_shuffles);
+    assert(reverses.size() == n_shuffles);
+
+    assert(not T::malicious);
+
+    auto& P = proc.P;
+    int n_players = P.num_players();
+    int my_num = P.my_num();
+
+    vector<Network> networks(n_shuffles);
+    vector<Network*> to_correlate;
+    for (size_t current_shuffle = 0; current_shuffle < n_shuffles;
+            current_shuffle++)
+    {
+        const auto& shuffle = shuffles[current_shuffle];
+        const auto n = sizes[current_shuffle];
+        const auto unit_size = unit_sizes[current_shuffle];
+        const bool reverse = reverses[current_shuffle];
+        assert(n % unit_size == 0);
+        stats[n / unit_size] += unit_size;
+
+        auto& network = networks[current_shuffle];
+        init(network, shuffle, reverse, unit_size);
+        if (network.n < n / unit_size)
+            throw runtime_error("shuffle too small");
+        for (size_t j = 0; j < n; j++)
+            network.data[j] = a[sources[current_shuffle] + j];
+
+        // generated with the shuffle if available
+        auto correlation = shuffle.take_correlation(reverse, unit_size,
+                BaseMachine::thread_num);
+        if (correlation)
+        {
+            network.inputs = move(correlation->inputs);
+            network.outputs = move(correlation->outputs);
+            network.sums = move(correlation->sums);
+        }
+        else
+            to_correlate.push_back(&network);
+    }
+
+    correlate(to_correlate);
+
+    // one round per player, sending the masked shares to it
+    for (int pass = 0; pass < n_players; pass++)
+    {
+        vector<octetStream> to_send(n_players), to_receive(n_players);
+        vector<int> owners(n_shuffles);
+
+        for (size_t current_shuffle = 0; current_shuffle < n_shuffles;
+                current_shuffle++)
+        {
+            int& owner = owners[current_shuffle];
+            owner = reverses[current_shuffle] ? n_players - 1 - pass : pass;
+            if (owner == my_num)
+                continue;
+
+            auto& network = networks[current_shuffle];
+            auto& input = network.inputs[owner];
+            for (size_t j = 0; j < network.data.size(); j++)
+                (network.data[j] - input[j]).pack(to_send[owner]);
+            network.data = network.outputs[owner];
+        }
+
+        P.send_receive_all(to_send, to_receive);
+
+        for (size_t current_shuffle = 0; current_shuffle < n_shuffles;
+                current_shuffle++)
+        {
+            if (owners[current_shuffle] != my_num)
+                continue;
+
+            auto& network = networks[current_shuffle];
+            auto& data = network.data;
+            const auto unit_size = network.unit_size;
+            for (int other = 0; other < n_players; other++)
+                if (other != my_num)
+                    for (auto& x : data)
+                        x += to_receive[other].get<T>();
+
+            vector<T> res(data.size());
+            for (size_t i = 0; i < network.n; i++)
+                for (size_t j = 0; j < unit_size; j++)
+                    res[network.perm[i] * unit_size + j] = data[i * unit_size
+                            + j];
+
+            for (int other = 0; other < n_players; other++)
+                if (other != my_num)
+                    for (size_t j = 0; j < res.size(); j++)
+                        res[j] += network.sums[other][j];
+
+            swap(data, res);
+        }
+    }
+
+    for (size_t current_shuffle = 0; current_shuffle < n_shuffles;
+            current_shuffle++)
+        for (size_t j = 0; j < sizes[current_shuffle]; j++)
+            a[destinations[current_shuffle] + j] =
+                    networks[current_shuffle].data[j];
+}
+
+template<class T>
+void SemiShuffler<T>::inverse_permutation(StackedVector<T>& stack, size_t n,
+        size_t output_base, size_t input_base)
+{
+    SecureShuffle<T>(proc).inverse_permutation(stack, n, output_base,
+            input_base);
+}
+
+#endif /* PROTOCOLS_SEMISHUFFLER_HPP_ */
@@ -16,6 +16,7 @@ template<class T> class ShamirMC;
 template<class T> class ShamirShare;
 template<class T> class ShamirInput;
 template<class T> class IndirectShamirMC;
+template<class T> class Atlas;
 
 class Player;
 
@@ -32,12 +33,20 @@ class Shamir : public ProtocolBase<T>
     ShamirInput<T>* resharing;
     ShamirInput<T>* random_input;
 
+    // degree reduction via kings, see ShamirOptions::king
+    Atlas<T>* king;
+
     SeededPRNG secure_prng;
 
     map<int, vector<vector<typename T::open_type>>> hypers;
 
     typename T::open_type dotprod_share;
 
+    // reshared together, see ShamirInput::add_mine()
+    vector<typename T::open_type> products;
+
+    void reshare();
+
     void buffer_random();
 
     int threshold;
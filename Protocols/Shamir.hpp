@@ -10,6 +10,7 @@
 #include "ShamirInput.h"
 #include "ShamirOptions.h"
 #include "ShamirShare.h"
+#include "Atlas.hpp"
 #include "Tools/benchmarking.h"
 
 template<class T>
@@ -45,15 +46,18 @@ template<class T>
 vector<typename T::open_type::Scalar> Shamir<T>::get_rec_factors(
         const vector<int>& points, int target)
 {
-    vector<U> res;
-    for (auto& point : points)
-        res.push_back(get_rec_factor(point, points, target));
+    // one inversion per factor and point otherwise
+    static thread_local map<pair<vector<int>, int>, vector<U>> cache;
+    auto& res = cache[{points, target}];
+    if (res.empty())
+        for (auto& point : points)
+            res.push_back(get_rec_factor(point, points, target));
     return res;
 }
 
 template<class T>
 Shamir<T>::Shamir(Player& P, int t) :
-        resharing(0), random_input(0), P(P)
+        resharing(0), random_input(0), king(0), P(P)
 {
     if (not P.is_encrypted())
         insecure("unencrypted communication");
@@ -73,6 +77,8 @@ Shamir<T>::~Shamir()
         delete resharing;
     if (random_input != 0)
         delete random_input;
+    if (king != 0)
+        delete king;
 }
 
 template<class T>
@@ -100,7 +106,14 @@ void Shamir<T>::reset()
 template<class T>
 void Shamir<T>::init_mul()
 {
+    // only created here because Atlas contains Shamir instances
+    if (ShamirMachine::s().king and not king)
+        king = new Atlas<T>(P);
+    if (king)
+        return king->init_mul();
+
     reset();
+    products.clear();
     if (rec_factor == 0 and P.my_num() < n_mul_players)
         rec_factor = get_rec_factor(P.my_num(), n_mul_players);
 }
@@ -109,34 +122,53 @@ template<class T>
 void Shamir<T>::prepare_mul(const T& x, const T& y, int n)
 {
     (void) n;
-    if (P.my_num() < n_mul_players)
-        resharing->add_mine(x * y * rec_factor);
+    if (king)
+        king->prepare_mul(x, y);
+    else if (P.my_num() < n_mul_players)
+        products.push_back(x * y * rec_factor);
+}
+
+template<class T>
+void Shamir<T>::reshare()
+{
+    resharing->add_mine(products);
+    products.clear();
 }
 
 template<class T>
 void Shamir<T>::exchange()
 {
     CODE_LOCATION
+    if (king)
+        return king->exchange();
     assert(resharing);
+    reshare();
     resharing->exchange();
 }
 
 template<class T>
 void Shamir<T>::start_exchange()
 {
+    // two rounds that cannot be split
+    if (king)
+        return king->exchange();
+    reshare();
     resharing->start_exchange();
 }
 
 template<class T>
 void Shamir<T>::stop_exchange()
 {
-    resharing->stop_exchange();
+    if (not king)
+        resharing->stop_exchange();
 }
 
 template<class T>
 T Shamir<T>::finalize_mul(int n)
 {
     (void) n;
+    if (king)
+        return king->finalize_mul();
     return finalize(n_mul_players);
 }
 
@@ -159,14 +191,19 @@ void Shamir<T>::init_dotprod()
 template<class T>
 void Shamir<T>::prepare_dotprod(const T& x, const T& y)
 {
-    dotprod_share += x * y * rec_factor;
+    if (king)
+        dotprod_share += x * y;
+    else
+        dotprod_share += x * y * rec_factor;
 }
 
 template<class T>
 void Shamir<T>::next_dotprod()
 {
-    if (P.my_num() < n_mul_players)
-        resharing->add_mine(dotprod_share);
+    if (king)
+        king->prepare(dotprod_share);
+    else if (P.my_num() < n_mul_players)
+        products.push_back(dotprod_share);
     dotprod_share = 0;
 }
 
@@ -57,6 +57,10 @@ class ShamirInput : public IndividualInput<T>
 
     vector<typename T::Scalar> randomness;
 
+    // for batched resharing
+    vector<vector<typename T::open_type>> batch_randomness;
+    vector<typename T::open_type> batch_row, batch_tmp;
+
     int threshold;
 
     void init();
@@ -88,6 +92,7 @@ public:
     }
 
     void add_mine(const typename T::open_type& input, int n_bits = -1);
+    void add_mine(const vector<typename T::open_type>& inputs);
     void finalize_other(int player, T& target, octetStream& o, int n_bits = -1);
 };
 
@@ -10,6 +10,7 @@
 #include "ShamirOptions.h"
 #include "Protocols/ReplicatedInput.hpp"
 #include "Protocols/SemiInput.hpp"
+#include "Math/ring_vectors.h"
 
 template<class U>
 void IndividualInput<U>::reset(int player)
@@ -94,6 +95,57 @@ void ShamirInput<T>::add_mine(const typename T::open_type& input, int n_bits)
     this->senders[P.my_num()] = true;
 }
 
+template<class T>
+void ShamirInput<T>::add_mine(const vector<typename T::open_type>& inputs)
+{
+    if (inputs.empty())
+        return;
+
+    this->maybe_init(this->P);
+
+    // same as above but as products of the reconstruction matrix
+    // with whole vectors of coefficients
+    auto& P = this->P;
+    int n = P.num_players();
+    int t = threshold;
+    int n_inputs = inputs.size();
+
+    // the same sequence per PRNG as one by one
+    batch_randomness.resize(t);
+    for (int offset = 0; offset < t; offset++)
+    {
+        auto& G = this->send_prngs[P.get_player(1 + offset)];
+        auto& randomness = batch_randomness[offset];
+        randomness.resize(n_inputs);
+        for (auto& x : randomness)
+            x.randomize(G);
+    }
+
+    auto& row = batch_row;
+    auto& tmp = batch_tmp;
+    row.resize(n_inputs);
+    tmp.resize(n_inputs);
+    for (int i = threshold; i < n; i++)
+    {
+        int player = P.get_player(1 + i);
+        auto& factors = reconstruction.at(i - threshold);
+        vector_scale(row.data(), inputs.data(), factors.at(0), n_inputs);
+        for (int j = 0; j < t; j++)
+        {
+            vector_scale(tmp.data(), batch_randomness[j].data(),
+                    factors.at(j + 1), n_inputs);
+            vector_add(row.data(), row.data(), tmp.data(), n_inputs);
+        }
+        if (player == P.my_num())
+            for (auto& x : row)
+                this->shares.push_back(x);
+        else
+            this->os[player].store_range(row.data(), n_inputs);
+    }
+
+    this->senders[P.my_num()] = true;
+}
+
 template<class T>
 void ShamirInput<T>::finalize_other(int player, T& target,
         octetStream& o, int n_bits)
@@ -45,9 +45,18 @@ protected:
     Bundle<octetStream>* os;
     const Player* player;
     int threshold;
+    size_t n_values;
+
+    // received shares per relevant player
+    vector<vector<open_type>> received;
+    vector<open_type> tmp;
 
     void prepare(const vector<T>& S, const Player& P);
 
+    void get_shares(int n_relevant_players);
+    void combine(open_type* res, const vector<rec_type>& factors);
+    virtual void finalize_all();
+
 public:
     ShamirMC(int threshold = 0);
 
@@ -69,8 +78,6 @@ public:
     virtual void init_open(const Player& P, int n = 0);
     virtual void prepare_open(const T& secret, int = -1);
     virtual void exchange(const Player& P);
-    virtual typename T::open_type finalize_raw();
-    virtual array<typename T::open_type*, 2> finalize_several(size_t n);
 
     void Check(const Player& P) { (void)P; }
 
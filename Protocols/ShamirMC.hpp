@@ -10,10 +10,11 @@
 
 #include "MAC_Check_Base.hpp"
 #include "Shamir.hpp"
+#include "Math/ring_vectors.h"
 
 template<class T>
 ShamirMC<T>::ShamirMC(int t) :
-        os(0), player(0), threshold()
+        os(0), player(0), threshold(), n_values(0)
 {
     if (t > 0)
         threshold = t;
@@ -65,6 +66,7 @@ void ShamirMC<T>::init_open(const Player& P, int n)
         o.reset_write_head();
     os->mine.reserve(n * T::size());
     this->player = &P;
+    n_values = 0;
 }
 
 template<class T>
@@ -79,6 +81,7 @@ template<class T>
 void ShamirMC<T>::prepare_open(const T& share, int)
 {
     share.pack(os->mine);
+    n_values++;
 }
 
 template<class T>
@@ -101,6 +104,7 @@ void ShamirMC<T>::exchange(const Player& P)
         my_receivers[i] = P.get_offset(i) >= P.num_players() - threshold;
     }
     P.partial_broadcast(my_senders, my_receivers, *os);
+    finalize_all();
 }
 
 template<class T>
@@ -108,6 +112,7 @@ void ShamirMC<T>::POpen_End(vector<typename T::open_type>& values,
         const vector<T>& S, const Player& P)
 {
     P.receive_all(*os);
+    finalize_all();
     finalize(values, S);
 }
 
@@ -117,30 +122,43 @@ void ShamirMC<T>::finalize(vector<typename T::open_type>& values,
 {
     values.clear();
     for (size_t i = 0; i < S.size(); i++)
-        values.push_back(finalize_raw());
+        values.push_back(this->values.next());
 }
 
 template<class T>
-array<typename T::open_type*, 2> ShamirMC<T>::finalize_several(size_t n)
+void ShamirMC<T>::get_shares(int n_relevant_players)
 {
-    this->values.clear();
-    finalize(this->values, vector<T>(n));
-    return MAC_Check_Base<T>::finalize_several(n);
+    received.resize(n_relevant_players);
+    for (int j = 0; j < n_relevant_players; j++)
+    {
+        received[j].resize(n_values);
+        (*os)[player->get_player(j)].get_range(received[j].data(), n_values);
+    }
 }
 
 template<class T>
-typename T::open_type ShamirMC<T>::finalize_raw()
+void ShamirMC<T>::combine(open_type* res, const vector<rec_type>& factors)
 {
-    assert(reconstruction.size());
-    typename T::open_type res;
-    for (size_t j = 0; j < reconstruction.size(); j++)
+    // matrix-vector product with shares of all values at once
+    assert(received.size() >= factors.size());
+    assert(not factors.empty());
+    vector_scale(res, received[0].data(), factors[0], n_values);
+    tmp.resize(n_values);
+    for (size_t j = 1; j < factors.size(); j++)
     {
-        res +=
-                (*os)[player->get_player(j)].template get<typename T::open_type>()
-                        * reconstruction[j];
+        vector_scale(tmp.data(), received[j].data(), factors[j], n_values);
+        vector_add(res, res, tmp.data(), n_values);
     }
+}
 
-    return res;
+template<class T>
+void ShamirMC<T>::finalize_all()
+{
+    assert(reconstruction.size());
+    get_shares(reconstruction.size());
+    this->values.clear();
+    this->values.resize(n_values);
+    combine(this->values.data(), reconstruction);
 }
 
 template<class T>
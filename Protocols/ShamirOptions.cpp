@@ -16,7 +16,7 @@ ShamirOptions& ShamirOptions::s()
 }
 
 ShamirOptions::ShamirOptions(int nparties, int threshold) :
-        nparties(nparties), threshold(threshold)
+        nparties(nparties), threshold(threshold), king(false)
 {
 }
 
@@ -40,6 +40,16 @@ ShamirOptions::ShamirOptions(ez::ezOptionParser& opt, int argc, const char** arg
             "-T", // Flag token.
             "--threshold" // Flag token.
     );
+    opt.add(
+            "", // Default.
+            0, // Required?
+            0, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Multiplication via one king per product and double sharings "
+            "(ATLAS-style) instead of resharing to all parties", // Help description.
+            "-K", // Flag token.
+            "--king" // Flag token.
+    );
     opt.parse(argc, argv);
     opt.get("-N")->getInt(nparties);
     if (nparties < 3)
@@ -49,6 +59,7 @@ ShamirOptions::ShamirOptions(ez::ezOptionParser& opt, int argc, const char** arg
         exit(1);
     }
     set_threshold(opt);
+    king = opt.isSet("--king");
     opt.resetArgs();
 }
 
@@ -16,6 +16,7 @@ public:
 
     int nparties;
     int threshold;
+    bool king;
 
     ShamirOptions(int nparties = 3, int threshold = 1);
     ShamirOptions(ez::ezOptionParser& opt, int argc, const char** argv);
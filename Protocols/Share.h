@@ -24,6 +24,7 @@ template<class T> class MascotPrep;
 template<class T> class MascotTriplePrep;
 
 union square128;
+template<int K> class Z2;
 
 class gf2n_mac_key;
 
@@ -201,6 +202,13 @@ public:
             super(share, mac) {}
 };
 
+// for vector operations in Math/ring_vectors.h
+template<int K>
+constexpr int flat_z2k_bits(const Share<Z2<K>>*)
+{
+    return K <= 128 ? K : 0;
+}
+
 template<class T>
 class ArithmeticOnlyMascotShare : public Share<T>
 {
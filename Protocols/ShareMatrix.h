@@ -11,6 +11,7 @@ using namespace std;
 
 #include "Share.h"
 #include "FHE/AddableVector.h"
+#include "Math/ring_vectors.h"
 
 template<class T> class MatrixMC;
 
@@ -214,12 +215,19 @@ public:
         if (a.entries.v.empty() or b.entries.v.empty())
             return;
         res.entries.init();
-        for (int i = 0; i < a.n_rows; i++)
-        {
-            for (int j = 0; j < b.n_cols; j++)
-                for (int k = 0; k < a.n_cols; k++)
-                    res[{i, j}] += a[{i, k}] * b[{k, j}];
-        }
+        if constexpr (ring_words<T>() == 1 and ring_words<U>() == 1
+                and ring_words<V>() == 1)
+            ring_gemm((uint64_t*) res.entries.v.data(),
+                    (const uint64_t*) a.entries.v.data(),
+                    (const uint64_t*) b.entries.v.data(), a.n_rows, a.n_cols,
+                    b.n_cols);
+        else
+            for (int i = 0; i < a.n_rows; i++)
+            {
+                for (int j = 0; j < b.n_cols; j++)
+                    for (int k = 0; k < a.n_cols; k++)
+                        res[{i, j}] += a[{i, k}] * b[{k, j}];
+            }
         res.check();
     }
 
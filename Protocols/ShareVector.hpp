@@ -6,6 +6,8 @@
 #include "ShareVector.h"
 #include "FHE/FFT.h"
 
+#include <thread>
+
 template<class U>
 void ShareVector<U>::fft(const FFT_Data& fftd)
 {
@@ -16,13 +18,18 @@ void ShareVector<U>::fft(const FFT_Data& fftd)
         data[1].push_back({share.get_mac(), fftd.get_prD()});
     }
 
-    for (auto& x : data)
+    auto transform = [&fftd](vector<modp>& x)
     {
         if (fftd.get_twop() == 0)
             FFT_Iter2(x, fftd.phi_m(), fftd.get_root(0), fftd.get_prD());
         else
             FFT_non_power_of_two(x, x, fftd);
-    }
+    };
+
+    // shares and MACs are independent
+    thread mac_thread(transform, ref(data[1]));
+    transform(data[0]);
+    mac_thread.join();
 
     for (int i = 0; i < fftd.phi_m(); i++)
     {
@@ -29,6 +29,9 @@ protected:
 public:
     const int C;
 
+    // threads for the local computation (-o sacrifice_threads)
+    int n_threads;
+
     ShuffleSacrifice();
     ShuffleSacrifice(int B, int C = 3);
 
@@ -54,6 +57,9 @@ public:
 
     template<class U>
     void shuffle(vector<U>& items, Player& P);
+
+    template<class U>
+    void run_parallel(size_t n, const U& job, size_t min_per_thread = 4096);
 };
 
 template<class T>
@@ -10,6 +10,7 @@
 #include "BufferScope.h"
 #include "Tools/PointerVector.h"
 #include "Tools/CodeLocations.h"
+#include "Tools/ParallelJobs.h"
 #include "GC/BitAdder.h"
 
 #include "LimitedPrep.hpp"
@@ -27,6 +28,16 @@ ShuffleSacrifice::ShuffleSacrifice(int B, int C) :
     if (OnlineOptions::singleton.security_parameter > 40)
         throw runtime_error("shuffle sacrifice not implemented for more than "
                 "40-bit security");
+    n_threads = ParallelJobs::n_threads("sacrifice_threads");
+}
+
+template<class U>
+void ShuffleSacrifice::run_parallel(size_t n, const U& job,
+        size_t min_per_thread)
+{
+    ParallelJobs::run(n, n_threads,
+            [&](int, size_t begin, size_t end) { job(begin, end); },
+            min_per_thread);
 }
 
 template<class U>
@@ -57,32 +68,37 @@ void TripleShuffleSacrifice<T>::triple_combine(vector<array<T, 3> >& triples,
     shuffle(to_combine, P);
 
     vector<typename T::open_type> opened;
-    vector<T> masked;
-    masked.reserve(N);
-    for (int i = 0; i < N; i++)
+    vector<T> masked((B - 1) * N);
+    run_parallel(N, [&](size_t begin, size_t end)
     {
-        T& b = to_combine[i][1];
-        for (int j = 1; j < B; j++)
+        for (size_t i = begin; i < end; i++)
         {
-            T& g = to_combine[i + N * j][1];
-            masked.push_back(b - g);
+            T& b = to_combine[i][1];
+            for (int j = 1; j < B; j++)
+            {
+                T& g = to_combine[i + N * j][1];
+                masked[i * (B - 1) + j - 1] = b - g;
+            }
         }
-    }
+    });
     MC.POpen(opened, masked, P);
-    auto it = opened.begin();
-    for (int i = 0; i < N; i++)
+    run_parallel(N, [&](size_t begin, size_t end)
     {
-        T& a = to_combine[i][0];
-        T& c = to_combine[i][2];
-        for (int j = 1; j < B; j++)
+        auto it = opened.begin() + begin * (B - 1);
+        for (size_t i = begin; i < end; i++)
         {
-            T& f = to_combine[i + N * j][0];
-            T& h = to_combine[i + N * j][2];
-            auto& rho = *(it++);
-            a += f;
-            c += h + f * rho;
+            T& a = to_combine[i][0];
+            T& c = to_combine[i][2];
+            for (int j = 1; j < B; j++)
+            {
+                T& f = to_combine[i + N * j][0];
+                T& h = to_combine[i + N * j][2];
+                auto& rho = *(it++);
+                a += f;
+                c += h + f * rho;
+            }
         }
-    }
+    });
     to_combine.resize(N);
     triples = to_combine;
 }
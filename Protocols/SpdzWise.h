@@ -18,6 +18,7 @@ template<class T>
 class SpdzWise : public ProtocolBase<T>
 {
     typedef typename T::part_type check_type;
+    typedef typename check_type::Honest combined_type;
 
     friend class SpdzWiseInput<T>;
 
@@ -29,8 +30,13 @@ class SpdzWise : public ProtocolBase<T>
 
     vector<typename T::part_type> coefficients;
 
+    int check_interval, n_threads;
+
     void buffer_random();
 
+    array<combined_type, 2> combine(false_type);
+    array<combined_type, 2> combine(true_type);
+
     virtual void zero_check(check_type t);
 
 public:
@@ -51,6 +57,8 @@ public:
     void init_mul();
     void prepare_mul(const T& x, const T& y, int n = -1);
     void exchange();
+    void start_exchange();
+    void stop_exchange();
     T finalize_mul(int n = -1);
 
     void init_dotprod();
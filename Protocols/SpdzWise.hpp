@@ -9,11 +9,17 @@
 
 #include "mac_key.hpp"
 
+#include <thread>
+
 template<class T>
 SpdzWise<T>::SpdzWise(Player& P) :
         internal(P), internal2(P), P(P)
 {
-    results.reserve(OnlineOptions::singleton.batch_size);
+    auto& opts = OnlineOptions::singleton;
+    check_interval = max(1, stoi(opts.option_value("spdzwise_check",
+            to_string(opts.batch_size))));
+    n_threads = max(1, stoi(opts.option_value("spdzwise_threads", "1")));
+    results.reserve(min(check_interval, opts.batch_size));
 }
 
 template<class T>
@@ -40,7 +46,7 @@ template<class T>
 void SpdzWise<T>::maybe_check()
 {
     assert(not mac_key.is_zero());
-    if ((int) results.size() >= OnlineOptions::singleton.batch_size)
+    if ((int) results.size() >= check_interval)
         check();
 }
 
@@ -76,6 +82,20 @@ void SpdzWise<T>::exchange()
     internal2.exchange();
 }
 
+template<class T>
+void SpdzWise<T>::start_exchange()
+{
+    // one outstanding round per channel
+    internal.exchange();
+    internal2.start_exchange();
+}
+
+template<class T>
+void SpdzWise<T>::stop_exchange()
+{
+    internal2.stop_exchange();
+}
+
 template<class T>
 void SpdzWise<T>::init_dotprod()
 {
@@ -121,6 +141,15 @@ void SpdzWise<T>::check()
         return;
 
     CODE_LOCATION
+    auto wu = combine(is_base_of<ReplicatedBase, decltype(internal)>());
+    auto t = wu[1] - internal.mul(mac_key, wu[0]);
+    zero_check(t);
+    results.clear();
+}
+
+template<class T>
+array<typename SpdzWise<T>::combined_type, 2> SpdzWise<T>::combine(false_type)
+{
     internal.init_dotprod();
     coefficients.clear();
 
@@ -138,11 +167,77 @@ void SpdzWise<T>::check()
     internal.next_dotprod();
 
     internal.exchange();
-    auto w = internal.finalize_dotprod(results.size());
-    auto u = internal.finalize_dotprod(results.size());
-    auto t = u - internal.mul(mac_key, w);
-    zero_check(t);
-    results.clear();
+    array<combined_type, 2> res;
+    for (auto& x : res)
+        x = internal.finalize_dotprod(results.size());
+    return res;
+}
+
+template<class T>
+array<typename SpdzWise<T>::combined_type, 2> SpdzWise<T>::combine(true_type)
+{
+    typedef typename combined_type::clear value_type;
+
+    // the coefficients are local with replicated secret sharing,
+    // so chunks can be combined in parallel with independent coins;
+    // the chunks don't depend on the number of threads
+    // to keep the parties in sync
+    const size_t chunk_size = 1 << 14;
+    size_t n_chunks = DIV_CEIL(results.size(), chunk_size);
+    vector<ReplicatedBase> coins;
+    coins.reserve(n_chunks);
+    for (size_t i = 0; i < n_chunks; i++)
+        coins.push_back(internal.branch());
+
+    int n_threads = min(size_t(this->n_threads), n_chunks);
+    vector<array<value_type, 2>> sums(n_threads);
+
+    auto job = [&](int thread_num)
+    {
+        const size_t N = max(size_t(1), 4096 / sizeof(value_type));
+        value_type coeffs[2][N];
+        auto& sum = sums[thread_num];
+        for (size_t i = thread_num; i < n_chunks; i += n_threads)
+        {
+            size_t end = min(results.size(), (i + 1) * chunk_size);
+            for (size_t j = i * chunk_size; j < end; j += N)
+            {
+                size_t n = min(N, end - j);
+                for (int k = 0; k < 2; k++)
+                    coins[i].shared_prngs[k].fill(coeffs[k], n);
+                for (size_t l = 0; l < n; l++)
+                {
+                    combined_type r;
+                    for (int k = 0; k < 2; k++)
+                        r[k] = coeffs[k][l];
+                    auto& res = results[j + l];
+                    sum[0] += res.get_share().local_mul(r);
+                    sum[1] += res.get_mac().local_mul(r);
+                }
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int i = 1; i < n_threads; i++)
+        threads.push_back(thread(job, i));
+    job(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    internal.init_mul();
+    for (int k = 0; k < 2; k++)
+    {
+        value_type sum;
+        for (auto& x : sums)
+            sum += x[k];
+        internal.prepare_reshare(sum);
+    }
+    internal.exchange();
+    array<combined_type, 2> res;
+    for (auto& x : res)
+        x = internal.finalize_mul();
+    return res;
 }
 
 template<class T>
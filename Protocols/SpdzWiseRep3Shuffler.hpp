@@ -18,7 +18,7 @@ SpdzWiseRep3Shuffler<T>::SpdzWiseRep3Shuffler(StackedVector<T>& a, size_t n,
     vector<size_t> unit_sizes{static_cast<size_t>(unit_size)};
     vector<size_t> destinations{output_base};
     vector<size_t> sources{input_base};
-    vector<shuffle_type> shuffles{store.get(handle)};
+    vector<shuffle_type> shuffles{*store.get(handle)};
     vector<bool> reverses{true};
     this->apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles, reverses);
 }
@@ -40,8 +40,7 @@ void SpdzWiseRep3Shuffler<T>::apply_multiple(StackedVector<T>& a, vector<size_t>
                                     vector<size_t>& unit_sizes, vector<size_t>& handles, vector<bool>& reverses, store_type& store) {
     vector<shuffle_type> shuffles;
     for (size_t &handle : handles) {
-        shuffle_type& shuffle = store.get(handle);
-        shuffles.push_back(shuffle);
+        shuffles.push_back(*store.get(handle));
     }
 
     apply_multiple(a, sizes, destinations, sources, unit_sizes, shuffles, reverses);
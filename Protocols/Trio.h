@@ -34,6 +34,14 @@ class Trio : public AstraOnlineBase<T>
     void init_reduced_mul(size_t n_mul);
     void exchange_reduced_mul(size_t n_mul);
 
+    octetStream& reduced_mul_prep()
+    {
+        return prep;
+    }
+
+    void prepare_exchange();
+    void finalize_exchange();
+
 public:
     Trio(Player& P) :
             AstraOnlineBase<T>(P)
@@ -41,6 +49,8 @@ public:
     }
 
     void exchange();
+    void start_exchange();
+    void stop_exchange();
 
     T finalize_mul(int = -1) final;
     T finalize_mul_fast()
@@ -62,8 +72,6 @@ class TrioPrepProtocol : public AstraPrepProtocol<T>
 
     octetStream os, prep_os;
 
-    void pre_P0(open_type& r01, const open_type& input);
-
 public:
     TrioPrepProtocol(Player& P) :
             AstraPrepProtocol<T>(P)
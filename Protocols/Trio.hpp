@@ -87,7 +87,33 @@ template<class T>
 void Trio<T>::exchange()
 {
     CODE_LOCATION
+    prepare_exchange();
+    this->P.pass_around(os[0], os[1], 1);
+    finalize_exchange();
+}
+
+template<class T>
+void Trio<T>::start_exchange()
+{
+    CODE_LOCATION
+    auto& P = this->P;
+    prepare_exchange();
+    P.request_send(P.get_player(1), os[0]);
+    P.request_receive(P.get_player(-1), os[1]);
+}
+
+template<class T>
+void Trio<T>::stop_exchange()
+{
     auto& P = this->P;
+    P.wait_receive(P.get_player(-1), os[1]);
+    P.wait_send(P.get_player(1), os[0]);
+    finalize_exchange();
+}
+
+template<class T>
+void Trio<T>::prepare_exchange()
+{
     auto& inputs = this->inputs;
     int my_num = this->astra_num;
 
@@ -110,8 +136,13 @@ void Trio<T>::exchange()
             results.push_back(pre_dot<Pi>(x)); \
     }
     X(1) X(2)
+#undef X
+}
 
-    P.pass_around(os[0], os[1], 1);
+template<class T>
+void Trio<T>::finalize_exchange()
+{
+    int my_num = this->astra_num;
 
     if (os[1].left() < open_type::size() * this->n_mults())
         throw runtime_error("insufficient data in Trio");
@@ -136,20 +167,13 @@ T Trio<T>::finalize_mul(int)
     return results.next().first;
 }
 
-template<class T>
-void TrioPrepProtocol<T>::pre_P0(typename T::open_type& r01,
-        const typename T::open_type& input)
-{
-    r01.randomize(this->prng_protocol.shared_prngs[0]);
-    this->os.store_no_resize(input + r01);
-}
-
 template<class T>
 void TrioPrepProtocol<T>::exchange()
 {
     CODE_LOCATION
     auto& P = this->P;
     auto& inputs = this->inputs;
+    auto& input_pairs = this->input_pairs;
     auto& results = this->results;
     int my_num = P.my_num();
     octetStream& os = this->os;
@@ -160,38 +184,57 @@ void TrioPrepProtocol<T>::exchange()
 
     this->prepare_exchange();
 
-    results.reserve(this->n_mults);
-    os.reserve(open_type::size() * 2 * this->n_mults);
+    size_t n = this->n_mults;
+    size_t n_inputs = inputs.size();
+    const size_t size = open_type::size();
+    assert(n == n_inputs + input_pairs.size());
+    results.resize(n);
 
-    T z;
-    open_type r01;
+    // expand all randomness up front, which results in the same
+    // sequence per PRNG as element by element
+    vector<open_type> first((my_num < 2 ? 2 : 1) * n);
+    vector<open_type> second(my_num == 0 ? n : 0);
+    shared_prngs[my_num % 2].fill(first.data(), first.size());
+    shared_prngs[1].fill(second.data(), second.size());
 
     if (my_num == 0)
     {
-        for (auto& x : inputs)
-        {
-            pre_P0(r01, x);
-            this->prng_protocol.randomize(z);
-            results.push_back(z);
-        }
-        for (auto& x : this->input_pairs)
+        // (r01, z[0]) from the first, z[1] from the second
+        octet* out = os.append(n * size);
+        this->run_parallel(n, [&](size_t begin, size_t end)
         {
-            pre_P0(r01, x[0].local_mul_P0(x[1]));
-            this->prng_protocol.randomize(z);
-            results.push_back(z);
-        }
+            for (size_t i = begin; i < end; i++)
+            {
+                open_type input;
+                if (i < n_inputs)
+                    input = inputs[i];
+                else
+                {
+                    auto& x = input_pairs[i - n_inputs];
+                    input = x[0].local_mul_P0(x[1]);
+                }
+                auto masked = input + first[2 * i];
+                memcpy(out + i * size, masked.get_ptr(), size);
+                results[i][0] = first[2 * i + 1];
+                results[i][1] = second[i];
+            }
+        });
         P.send_to(2, os);
     }
     else if (my_num == 1)
     {
-        for (size_t i = 0; i < this->n_mults; i++)
+        // (r01, -lambda) are stored as they come
+        octet* out = os.append(2 * n * size);
+        this->run_parallel(n, [&](size_t begin, size_t end)
         {
-            r01.randomize(shared_prngs[1]);
-            z.neg_lambda(my_num).randomize(shared_prngs[1]);
-            results.push_back(z);
-            os.store_no_resize(r01);
-            os.store_no_resize(z.neg_lambda(my_num));
-        }
+            for (size_t i = begin; i < end; i++)
+            {
+                results[i].neg_lambda(my_num) = first[2 * i + 1];
+                for (int j = 0; j < 2; j++)
+                    memcpy(out + (2 * i + j) * size, first[2 * i + j].get_ptr(),
+                            size);
+            }
+        });
         this->store(os);
     }
     else
@@ -199,16 +242,20 @@ void TrioPrepProtocol<T>::exchange()
         assert(my_num == 2);
         P.receive_player(0, os);
         octetStream prep_os;
-        prep_os.reserve(this->n_mults * 2 * open_type::size());
-        if (os.left() < this->n_mults * open_type::size())
+        if (os.left() < n * size)
             throw runtime_error("insufficient data in multiplication");
-        for (size_t i = 0; i < this->n_mults; i++)
+        const octet* in = os.consume_no_check(n * size);
+        octet* out = prep_os.append(2 * n * size);
+        this->run_parallel(n, [&](size_t begin, size_t end)
         {
-            prep_os.store_no_resize(os.get_no_check<open_type>());
-            z.neg_lambda(my_num).randomize(shared_prngs[0]);
-            prep_os.store_no_resize(z.neg_lambda(my_num));
-            results.push_back(z);
-        }
+            for (size_t i = begin; i < end; i++)
+            {
+                auto& neg_lambda = results[i].neg_lambda(my_num);
+                neg_lambda = first[i];
+                memcpy(out + 2 * i * size, in + i * size, size);
+                memcpy(out + (2 * i + 1) * size, neg_lambda.get_ptr(), size);
+            }
+        });
         this->store(prep_os);
     }
 
@@ -321,7 +368,8 @@ void AstraPrepProtocol<T>::exchange_reduced_mul(size_t)
     if (P.my_num() == 2)
         assert(not os.left());
 
-    this->store(os_prep);
+    if (not input0_pending)
+        this->store(os_prep);
 }
 
 template<class T>
@@ -28,6 +28,8 @@ public:
     {
     }
 
+    void finalize_vector(int player, T* target, size_t n, int n_bits = -1)
+            final;
     T finalize_offset(int offset) final;
 };
 
@@ -120,7 +120,7 @@ public:
         delete[] buffer;
     }
 
-    void output(int length, ofstream& s)
+    void output(int length, ostream& s)
     {
         assert(size() == MAX_SIZE);
         for (auto& x : a)
@@ -3,12 +3,15 @@
 #define _fake_stuff
 
 #include <fstream>
+#include <deque>
+#include <thread>
 using namespace std;
 
 #include "Networking/Player.h"
 #include "Processor/Data_Files.h"
 #include "Math/Setup.h"
 #include "Tools/benchmarking.h"
+#include "Tools/AsyncFileWriter.h"
 
 template<class T>
 void check_share(vector<T>& Sa, typename T::clear& value,
@@ -77,6 +80,44 @@ class Files : public FilesBase
   }
 
 public:
+  /**
+   * Shares for a block of items in memory, generated with a separate PRNG
+   * seeded from the one of the files
+   */
+  class Buffer
+  {
+    Files& files;
+    deque<AsyncFileWriter::OutputBuffer> buffers;
+    deque<ostream> streams;
+
+  public:
+    vector<vector<char>> data;
+    PRNG G;
+
+    Buffer(Files& files) :
+        files(files), data(files.N)
+    {
+      G.SetSeed(files.G);
+      for (auto& x : data)
+        {
+          buffers.emplace_back(x);
+          streams.emplace_back(&buffers.back());
+        }
+    }
+
+    void output_shares(word a)
+    {
+      output_shares(typename T::open_type(a));
+    }
+    void output_shares(const typename T::open_type& a)
+    {
+      vector<T> Sa(files.N);
+      make_share(Sa, a, files.N, files.key.key, G);
+      for (int j = 0; j < files.N; j++)
+        Sa[j].output(streams[j], false);
+    }
+  };
+
   ofstream* outf;
   int N;
   KeySetup<T> key;
@@ -134,6 +175,48 @@ public:
     for (int j=0; j<N; j++)
       Sa[j].output(outf[j],false);
   }
+
+  /**
+   * Call ``job(output, G, n_items)`` for ``n`` items in total. With more
+   * than one thread, blocks of items are generated in parallel and
+   * written in order, one block per file at a time.
+   */
+  template<class U>
+  void generate(size_t n, int n_threads, const U& job)
+  {
+    if (n_threads <= 1)
+      {
+        job(*this, G, n);
+        return;
+      }
+
+    const size_t block_size = 1 << 16;
+    size_t done = 0;
+    while (done < n)
+      {
+        deque<Buffer> blocks;
+        vector<size_t> sizes;
+        for (int i = 0; i < n_threads and done < n; i++)
+          {
+            blocks.emplace_back(*this);
+            sizes.push_back(min(block_size, n - done));
+            done += sizes.back();
+          }
+
+        vector<thread> threads;
+        for (size_t i = 1; i < blocks.size(); i++)
+          threads.push_back(thread([&, i]() {
+            job(blocks[i], blocks[i].G, sizes[i]);
+          }));
+        job(blocks[0], blocks[0].G, sizes[0]);
+        for (auto& t : threads)
+          t.join();
+
+        for (auto& block : blocks)
+          for (int j = 0; j < N; j++)
+            outf[j].write(block.data[j].data(), block.data[j].size());
+      }
+  }
 };
 
 #endif
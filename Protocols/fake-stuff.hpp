@@ -11,6 +11,7 @@
 #include "Protocols/ShamirInput.hpp"
 
 #include <fstream>
+#include <mutex>
 
 template<class T> class Share;
 template<class T> class SemiShare;
@@ -154,18 +155,23 @@ class VanderStore
 {
 public:
   static vector<vector<T>> vandermonde;
+  static once_flag initialized;
 };
 
 template<class T>
 vector<vector<T>> VanderStore<T>::vandermonde;
+template<class T>
+once_flag VanderStore<T>::initialized;
 
 template<class T, class V>
 void make_share(ShamirShare<T>* Sa, const V& a, int N,
     const GC::NoValue&, PRNG& G)
 {
   auto& vandermonde = VanderStore<T>::vandermonde;
-  if (vandermonde.empty())
+  // shares might be generated in several threads
+  call_once(VanderStore<T>::initialized, [&]() {
       vandermonde = ShamirInput<ShamirShare<T>>::get_vandermonde(N / 2, N);
+  });
   vector<T> randomness(N / 2);
   for (auto& x : randomness)
       x.randomize(G);
@@ -524,24 +530,28 @@ inline void check_files(ofstream* outf, int N)
  */
 template<class T>
 void make_mult_triples(const KeySetup<T>& key, int N, int ntrip,
-    bool zero, string prep_data_prefix, PRNG& G, int thread_num = -1)
+    bool zero, string prep_data_prefix, PRNG& G, int thread_num = -1,
+    int n_threads = 1)
 {
   T::clear::write_setup(get_prep_sub_dir<T>(prep_data_prefix, N));
   Files<T> files(N, key, prep_data_prefix, DATA_TRIPLE, G, thread_num);
 
-  typename T::clear a,b,c;
-  /* Generate Triples */
-  for (int i=0; i<ntrip; i++)
-    {
-      if (!zero)
-        a.randomize(G);
-      if (!zero)
-        b.randomize(G);
-      auto c = typename T::open_type(a) * b;
-      files.output_shares(a);
-      files.output_shares(b);
-      files.output_shares(c);
-    }
+  files.generate(ntrip, n_threads, [zero](auto& out, PRNG& G, size_t n)
+  {
+    typename T::clear a,b;
+    /* Generate Triples */
+    for (size_t i=0; i<n; i++)
+      {
+        if (!zero)
+          a.randomize(G);
+        if (!zero)
+          b.randomize(G);
+        auto c = typename T::open_type(a) * b;
+        out.output_shares(a);
+        out.output_shares(b);
+        out.output_shares(c);
+      }
+  });
   check_files(files.outf, N);
 }
 
@@ -550,23 +560,26 @@ void make_mult_triples(const KeySetup<T>& key, int N, int ntrip,
  */
 template<class T>
 void make_inverse(const KeySetup<T>& key, int N, int ntrip, bool zero,
-    string prep_data_prefix, PRNG& G)
+    string prep_data_prefix, PRNG& G, int n_threads = 1)
 {
 
   Files<T> files(N, key, prep_data_prefix, DATA_INVERSE, G);
-  typename T::clear a,b;
-  for (int i=0; i<ntrip; i++)
-    {
-      if (zero)
-        // ironic?
-        a.assign_one();
-      else
-        do
-          a.randomize(G);
-        while (a.is_zero());
-      files.output_shares(a);
-      files.output_shares(a.invert());
-    }
+  files.generate(ntrip, n_threads, [zero](auto& out, PRNG& G, size_t n)
+  {
+    typename T::clear a;
+    for (size_t i=0; i<n; i++)
+      {
+        if (zero)
+          // ironic?
+          a.assign_one();
+        else
+          do
+            a.randomize(G);
+          while (a.is_zero());
+        out.output_shares(a);
+        out.output_shares(a.invert());
+      }
+  });
   check_files(files.outf, N);
 }
 
@@ -5,6 +5,9 @@ SPDZROOT=$HERE/..
 
 killall $PROTOCOL-party.x $PROTOCOL-prep-party.x
 
+# stale segments from -o astra_shm
+rm -f /dev/shm/mp-spdz-Player-Data_3-$PROTOCOL-* 2> /dev/null
+
 for dir in Player-Data/3-$PROTOCOL-{{R,B}-64,2-{40,128}}; do
     mkdir $dir 2> /dev/null
     rm $dir/*
@@ -3,7 +3,11 @@
 HERE=$(cd `dirname $0`; pwd)
 SPDZROOT=$HERE/..
 
-rm Player-Data/3-astra-*/*
+# keep earlier instances from -o astra_instance
+case "$*" in
+    *astra_instance*) ;;
+    *) rm Player-Data/3-astra-*/* ;;
+esac
 
 export PLAYERS=3
 
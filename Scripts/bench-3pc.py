@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+
+# Run a program with three-party replicated secret sharing (Rep3),
+# Astra, and Trio on localhost and compare them, e.g.,
+#
+#   Scripts/bench-3pc.py tutorial -r 3 -- -b 10000
+#
+# Arguments after "--" are passed to the virtual machines. Astra and
+# Trio run their preprocessing and online phases in separate
+# processes, which are reported separately. Communication is the
+# global data sent by all parties in the respective phase.
+
+import os, sys, re, json, time, argparse, subprocess, statistics
+
+root = os.path.dirname(os.path.abspath(__file__)) + '/..'
+
+protocols = (('ring', 'Rep3', ['replicated-ring-party.x']),
+             ('astra', 'Astra', ['astra-party.x', 'astra-prep-party.x']),
+             ('trio', 'Trio', ['trio-party.x', 'trio-prep-party.x']))
+
+if '--' in sys.argv:
+    split = sys.argv.index('--')
+    runtime_args = sys.argv[split + 1:]
+    argv = sys.argv[1:split]
+else:
+    runtime_args = []
+    argv = sys.argv[1:]
+
+parser = argparse.ArgumentParser(
+    description='Compare Rep3, Astra, and Trio on the same program',
+    epilog='Arguments after -- are passed to the virtual machines.')
+parser.add_argument('program', nargs='+',
+                    help='program name and compile-time arguments')
+parser.add_argument('-r', '--repeat', type=int, default=3,
+                    help='runs per protocol (default: %(default)s)')
+parser.add_argument('-c', '--compile-args', default='',
+                    help='additional arguments for compile.py')
+parser.add_argument('-o', '--output', default='bench-3pc.txt',
+                    help='report file (default: %(default)s)')
+parser.add_argument('--json', help='also store the results in JSON')
+parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                    help='parallel jobs for make')
+args = parser.parse_args(argv)
+
+def compile_program(protocol):
+    out = subprocess.run(
+        [root + '/compile.py', '-E', protocol] + args.compile_args.split() +
+        args.program, cwd=root, check=True, stdout=subprocess.PIPE,
+        universal_newlines=True).stdout
+    return re.search(r'Schedules/(.*)\.sch', out).group(1)
+
+def parse(output):
+    res = {}
+    for regex, field in ((r'^Time = (\S+)', 'time'),
+                         (r'^Data sent = \S+ MB in ~(\d+) rounds', 'rounds'),
+                         (r'^Global data sent = (\S+) MB', 'global_data_mb')):
+        match = re.search(regex, output, re.M)
+        if match:
+            res[field] = float(match.group(1))
+    return res
+
+def prep_output(name):
+    # the preprocessing parties only finish after the online phase
+    log = root + '/logs/%s-prep-0' % name
+    for i in range(100):
+        if os.path.exists(log):
+            output = open(log).read()
+            if re.search(r'^Global data sent', output, re.M):
+                return output
+        time.sleep(0.1)
+    raise Exception('no result in ' + log)
+
+def run(protocol, name):
+    log = root + '/logs/%s-prep-0' % name
+    if os.path.exists(log):
+        os.remove(log)
+    out = subprocess.run(
+        [root + '/Scripts/%s.sh' % protocol, name] + runtime_args, cwd=root,
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        universal_newlines=True)
+    if out.returncode:
+        print(out.stdout)
+        raise Exception('%s failed with %s' % (name, protocol))
+    res = dict(online=parse(out.stdout))
+    if protocol != 'ring':
+        res['prep'] = parse(prep_output(name))
+    return res
+
+def mean(runs, phase, field):
+    values = [x[phase][field] for x in runs if field in x.get(phase, {})]
+    return statistics.mean(values) if values else None
+
+executables = sum((x[2] for x in protocols), [])
+subprocess.run(['make', '-j%d' % args.jobs] + executables, cwd=root,
+               check=True, stdout=subprocess.DEVNULL)
+
+results = []
+for protocol, label, _ in protocols:
+    name = compile_program(protocol)
+    runs = [run(protocol, name) for i in range(args.repeat)]
+    result = dict(protocol=label, program=' '.join(args.program), runs=runs)
+    for phase in 'prep', 'online':
+        for field in 'time', 'global_data_mb', 'rounds':
+            result['%s_%s' % (phase, field)] = mean(runs, phase, field)
+    results.append(result)
+    print('%s: %s seconds online' % (label, result['online_time']))
+
+def fmt(x, precision='%.3g'):
+    return '-' if x is None else precision % x
+
+columns = ('Protocol', 'Prep time (s)', 'Prep data (MB)', 'Online time (s)',
+           'Online data (MB)', 'Online rounds', 'Total time (s)',
+           'Total data (MB)')
+rows = []
+for result in results:
+    total = [sum(result['%s_%s' % (phase, field)] or 0
+                 for phase in ('prep', 'online'))
+             for field in ('time', 'global_data_mb')]
+    rows.append((result['protocol'], fmt(result['prep_time']),
+                 fmt(result['prep_global_data_mb']),
+                 fmt(result['online_time']),
+                 fmt(result['online_global_data_mb']),
+                 fmt(result['online_rounds'], '%d'),
+                 fmt(total[0]), fmt(total[1])))
+
+widths = [max(len(row[i]) for row in rows + [columns])
+          for i in range(len(columns))]
+lines = ['Program: %s' % ' '.join(args.program),
+         'Runtime arguments: %s' % (' '.join(runtime_args) or '-'),
+         'Runs per protocol: %d (mean)' % args.repeat, '']
+for row in [columns, ['-' * width for width in widths]] + rows:
+    lines.append('  '.join(x.ljust(width) for x, width in zip(row, widths)))
+fastest = min(results, key=lambda x: x['online_time'])
+lines += ['', 'Fastest online phase: %s' % fastest['protocol']]
+report = '\n'.join(lines) + '\n'
+
+print()
+print(report, end='')
+open(args.output, 'w').write(report)
+print('Report stored in', args.output)
+
+if args.json:
+    json.dump(results, open(args.json, 'w'), indent=1)
+    print('Results stored in', args.json)
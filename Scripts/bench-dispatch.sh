@@ -0,0 +1,20 @@
+#!/usr/bin/env bash
+
+# Compare the instruction throughput of threaded dispatch with and
+# without fused instructions and switch dispatch
+# in the emulator, e.g., Scripts/bench-dispatch.sh oram_tutorial
+
+progs=${*:-oram_tutorial dijkstra_example}
+
+make -j8 emulate.x || exit 1
+
+for prog in $progs; do
+    ./compile.py -R 64 $prog > /dev/null || exit 1
+    for opt in "" "-o no_fusion" "-o switch_dispatch"; do
+	log=$(./emulate.x -v $opt $prog 2>&1) || { echo "$log"; exit 1; }
+	time=$(echo "$log" | grep '^Time = ' | awk '{print $3}')
+	n=$(echo "$log" | grep '^Executed ' | awk '{print $2}')
+	echo "$prog ${opt:-threaded}: $n instructions in $time seconds," \
+	     $(awk "BEGIN { printf \"%.3g\", $n / $time }") per second
+    done
+done
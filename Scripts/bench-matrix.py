@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+
+# Run a matrix of programs, protocols, and thread counts on localhost
+# and compare with a baseline, e.g.,
+#
+#   Scripts/bench-matrix.py Scripts/bench-matrix.json -o new.json -b old.json
+#
+# The configuration is a JSON object with the following keys:
+#
+#   programs: program names with compile-time arguments, where
+#             "{threads}" is replaced by every thread count
+#   protocols: protocol names as for Scripts/compile-run.py
+#   threads: thread counts (default [1])
+#   repeat: number of runs per combination (default 3)
+#   compile_args: additional arguments for compile.py (default [])
+#   runtime_args: additional arguments for the virtual machine
+#
+# Arguments after "--" are appended to runtime_args, which allows
+# comparing runtime options with the same configuration.
+#
+# Running time is compared by mean with Welch's t-test, and
+# communication is compared exactly because it is deterministic.
+# The exit code is 1 if there is a regression.
+
+import os, sys, re, json, math, argparse, subprocess, statistics
+
+root = os.path.dirname(os.path.abspath(__file__)) + '/..'
+sys.path.insert(0, root)
+
+from Compiler.compilerLib import Compiler
+
+parser = argparse.ArgumentParser(
+    description='Benchmark matrix with baseline comparison')
+parser.add_argument('config', help='matrix in JSON')
+parser.add_argument('-o', '--output', default='bench-results.json',
+                    help='results file (default: %(default)s)')
+parser.add_argument('-b', '--baseline', help='results to compare with')
+parser.add_argument('--threshold', type=float, default=0.05,
+                    help='relative slowdown to report (default: %(default)s)')
+parser.add_argument('--t-value', type=float, default=2,
+                    help='minimal t statistic for time differences to be '
+                    'significant (default: %(default)s)')
+parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                    help='parallel jobs for make')
+
+if '--' in sys.argv:
+    split = sys.argv.index('--')
+    extra_args = sys.argv[split + 1:]
+    args = parser.parse_args(sys.argv[1:split])
+else:
+    extra_args = []
+    args = parser.parse_args()
+
+config = json.load(open(args.config))
+config['runtime_args'] = config.get('runtime_args', []) + extra_args
+
+def key(result):
+    return result['program'], result['protocol'], result['threads']
+
+def compile_program(protocol, program):
+    out = subprocess.run(
+        [root + '/compile.py', '-E', protocol] + config.get('compile_args', []) +
+        program.split(), cwd=root, check=True, stdout=subprocess.PIPE,
+        universal_newlines=True).stdout
+    return re.search(r'Schedules/(.*)\.sch', out).group(1)
+
+def run(protocol, name):
+    out = subprocess.run(
+        [root + '/Scripts/%s.sh' % protocol, name] +
+        config.get('runtime_args', []), cwd=root,
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        universal_newlines=True)
+    if out.returncode:
+        print(out.stdout)
+        raise Exception('%s failed with %s' % (name, protocol))
+    res = {}
+    for regex, field in ((r'^Time = (\S+)', 'time'),
+                         (r'^Data sent = (\S+) MB in ~(\d+) rounds', 'data'),
+                         (r'^Global data sent = (\S+) MB', 'global_data')):
+        match = re.search(regex, out.stdout, re.M)
+        if match:
+            res[field] = [float(x) for x in match.groups()]
+    return res
+
+results = []
+for protocol in config['protocols']:
+    executable = Compiler.executable_from_protocol(protocol)
+    subprocess.run(['make', '-j%d' % args.jobs, executable], cwd=root,
+                   check=True, stdout=subprocess.DEVNULL)
+    for program in config['programs']:
+        threads = config.get('threads', [1]) if '{threads}' in program \
+            else [None]
+        for n_threads in threads:
+            spec = program.replace('{threads}', str(n_threads))
+            name = compile_program(protocol, spec)
+            runs = [run(protocol, name) for i in range(config.get('repeat', 3))]
+            result = dict(program=spec, protocol=protocol, threads=n_threads,
+                          times=[x['time'][0] for x in runs])
+            if 'data' in runs[0]:
+                result['data_mb'], result['rounds'] = runs[0]['data']
+            if 'global_data' in runs[0]:
+                result['global_data_mb'] = runs[0]['global_data'][0]
+            print('%s with %s: %.3g seconds, %s MB, %s rounds' % (
+                spec, protocol, statistics.mean(result['times']),
+                result.get('global_data_mb', result.get('data_mb')),
+                result.get('rounds')))
+            results.append(result)
+
+json.dump(results, open(args.output, 'w'), indent=1)
+print('Results stored in', args.output)
+
+if not args.baseline:
+    sys.exit(0)
+
+def t_statistic(a, b):
+    # Welch's t-test, infinite if both are constant
+    if len(a) < 2 or len(b) < 2:
+        return math.inf
+    var = statistics.variance(a) / len(a) + statistics.variance(b) / len(b)
+    diff = statistics.mean(b) - statistics.mean(a)
+    if var == 0:
+        return math.copysign(math.inf, diff) if diff else 0
+    return diff / math.sqrt(var)
+
+baseline = dict((key(x), x) for x in json.load(open(args.baseline)))
+regression = False
+
+for result in results:
+    old = baseline.get(key(result))
+    if not old:
+        print('%s with %s: no baseline' % key(result)[:2])
+        continue
+    messages = []
+    old_mean = statistics.mean(old['times'])
+    new_mean = statistics.mean(result['times'])
+    change = new_mean / old_mean - 1
+    t = t_statistic(old['times'], result['times'])
+    if abs(change) > args.threshold and abs(t) >= args.t_value:
+        messages.append('time %+.1f%% (t = %.3g)' % (100 * change, t))
+        regression |= change > 0
+    for field in 'global_data_mb', 'data_mb', 'rounds':
+        if field in old and field in result and old[field] != result[field]:
+            messages.append('%s %s -> %s' % (field, old[field], result[field]))
+            regression |= result[field] > old[field]
+    if messages:
+        print('%s with %s (%s threads): %s' % (
+            result['program'], result['protocol'], result['threads'],
+            ', '.join(messages)))
+
+if regression:
+    print('Regression compared to', args.baseline)
+    sys.exit(1)
+else:
+    print('No regression compared to', args.baseline)
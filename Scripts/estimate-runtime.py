@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+
+# Estimate the running time and communication of a program for the
+# protocols in calibration data from Utils/bench-primitives.cpp, e.g.,
+#
+#   ./bench-primitives.x 0 3 Rep3 > bench.csv & ...
+#   Scripts/estimate-runtime.py bench.csv -l 10 -b 1000 -- -R 64 tutorial
+#
+# The arguments after "--" are passed to compile.py. The estimate
+# combines the compiler's count of multiplications, dot products,
+# inputs, edaBits, and rounds with the time and communication per item
+# measured for the largest vector size with the requested number of
+# threads. Latency is charged once per round and bandwidth for the
+# data sent by one party. Requirements without calibration data such
+# as binary circuits are listed but not included in the estimate.
+
+import os, sys, csv, json, argparse, contextlib
+from collections import defaultdict
+
+root = os.path.dirname(os.path.abspath(__file__)) + '/..'
+sys.path.insert(0, root)
+
+from Compiler.compilerLib import Compiler
+
+parser = argparse.ArgumentParser(
+    description='Runtime estimation from compiler costs and calibration')
+parser.add_argument('calibration', nargs='+',
+                    help='CSV output of bench-primitives.x')
+parser.add_argument('-p', '--protocol', action='append',
+                    help='only estimate for this protocol (default: all)')
+parser.add_argument('-t', '--threads', type=int, default=1,
+                    help='threads in calibration (default: %(default)s)')
+parser.add_argument('-N', '--parties', type=int, default=3,
+                    help='parties in calibration (default: %(default)s)')
+parser.add_argument('-l', '--latency', type=float, default=0,
+                    help='one-way latency in ms (default: %(default)s)')
+parser.add_argument('-b', '--bandwidth', type=float,
+                    help='bandwidth in Mbit/s (default: unlimited)')
+parser.add_argument('-v', '--verbose', action='store_true',
+                    help='output the estimate per primitive')
+parser.add_argument('--json', help='store estimates in JSON file')
+parser.usage = parser.format_usage()[7:].strip() + \
+    ' -- <compile.py arguments>'
+
+if '--' not in sys.argv:
+    parser.error('no program to compile')
+split = sys.argv.index('--')
+args = parser.parse_args(sys.argv[1:split])
+compile_args = sys.argv[split + 1:]
+
+# largest size per protocol and primitive
+calibration = defaultdict(dict)
+for filename in args.calibration:
+    for row in csv.DictReader(open(filename)):
+        if int(row['threads']) != args.threads:
+            continue
+        old = calibration[row['protocol']].get(row['primitive'])
+        if not old or int(old['size']) < int(row['size']):
+            calibration[row['protocol']][row['primitive']] = row
+
+if args.json:
+    json_file = os.path.abspath(args.json)
+
+if not calibration:
+    print('No calibration data for %d threads' % args.threads)
+    sys.exit(1)
+
+os.chdir(root)
+with contextlib.redirect_stdout(sys.stderr):
+    compiler = Compiler(custom_args=compile_args)
+    compiler.prep_compile()
+    prog = compiler.compile_file()
+
+# requirement to primitive and items per requirement
+def primitive(req):
+    if req[0] == 'modp':
+        if req[1] == 'simple multiplication':
+            return 'mul', 1
+        elif req[1] == 'dot product':
+            return 'dotprod', 1
+        elif req[1] == 'input':
+            # calibration has inputs from all parties per item
+            return 'input', 1 / args.parties
+    elif req[0] in ('edabit', 'sedabit'):
+        # calibration uses strict edaBits of length 32
+        return 'edabits', req[1] / 32
+    return None, None
+
+requirements = prog.req_num or {}
+rounds = requirements.get(('all', 'round'), 0)
+usage = defaultdict(lambda: 0)
+uncalibrated = []
+for req, num in sorted(requirements.items(), key=str):
+    name, factor = primitive(req)
+    if name:
+        usage[name] += num * factor
+    elif req[0] != 'all' and num and req[1] != 'triple':
+        uncalibrated.append((req, num))
+
+if 'mul' not in usage:
+    # older programs only count triples
+    usage['mul'] = requirements.get(('modp', 'triple'), 0)
+
+estimates = []
+for protocol, primitives in sorted(calibration.items()):
+    if args.protocol and protocol not in args.protocol:
+        continue
+    estimate = dict(protocol=protocol, compute=0, data=0, rounds=rounds,
+                    missing=[], breakdown={})
+    for name, num in usage.items():
+        if not num:
+            continue
+        row = primitives.get(name)
+        if not row:
+            estimate['missing'].append(name)
+            continue
+        size = int(row['size'])
+        seconds = num * float(row['seconds']) / size
+        data = num * int(row['bytes_sent']) / size
+        estimate['compute'] += seconds
+        estimate['data'] += data
+        estimate['breakdown'][name] = dict(items=num, seconds=seconds,
+                                           bytes=data)
+    estimate['latency'] = rounds * args.latency * 1e-3
+    if args.bandwidth:
+        estimate['transfer'] = estimate['data'] * 8 / args.bandwidth * 1e-6
+    else:
+        estimate['transfer'] = 0
+    estimate['time'] = estimate['compute'] + estimate['latency'] + \
+        estimate['transfer']
+    estimates.append(estimate)
+
+for estimate in sorted(estimates, key=lambda x: x['time']):
+    print('%s: %.3g seconds (%.3g computation, %.3g latency, '
+          '%.3g bandwidth), %.3g MB, %d rounds' % (
+              estimate['protocol'], estimate['time'], estimate['compute'],
+              estimate['latency'], estimate['transfer'],
+              estimate['data'] * 1e-6, estimate['rounds']))
+    if args.verbose:
+        for name, x in sorted(estimate['breakdown'].items()):
+            print('  %s: %.0f items, %.3g seconds, %.3g MB' % (
+                name, x['items'], x['seconds'], x['bytes'] * 1e-6))
+    if estimate['missing']:
+        print('  no calibration for', ', '.join(estimate['missing']))
+
+if uncalibrated:
+    print('Not included:', ', '.join(
+        '%s %s' % (num, ' '.join(str(x) for x in req))
+        for req, num in uncalibrated))
+
+if args.json:
+    json.dump(estimates, open(json_file, 'w'), indent=1)
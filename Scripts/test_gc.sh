@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# Run test_gc with Yao's garbled circuits for every garbling scheme
+# in Yao/config.h and compare the outputs with the default (half
+# gates). yao-party.x is rebuilt for every scheme and left in the
+# default configuration.
+
+./compile.py -G test_gc || exit 1
+mkdir -p logs
+
+function build
+{
+    rm -f Yao/*.o Machines/yao-party.o yao-party.x
+    # appended to by CONFIG.mine
+    MY_CFLAGS="$1" make -j$(nproc) yao-party.x > /dev/null || exit 1
+}
+
+function run
+{
+    if ! Scripts/yao.sh test_gc > /dev/null; then
+	cat logs/test_gc-0
+	exit 1
+    fi
+    grep expected logs/test_gc-0
+}
+
+build
+run > logs/test_gc-half
+
+for flag in -DTHREE_HALVES_GATES -DFULL_GATES; do
+    build $flag
+    if ! run | diff logs/test_gc-half -; then
+	echo Different output with $flag
+	build
+	exit 1
+    fi
+done
+
+build
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# secure shuffling and its inverse with semi-honest additive secret
+# sharing, including lengths that are not a power of two and matrix
+# rows (more than one element per unit)
+
+make -j$(nproc) semi-party.x semi2k-party.x || exit 1
+
+./compile.py -R 64 test_permute || exit 1
+
+for players in 2 3; do
+    Scripts/semi2k.sh -N $players test_permute || exit 1
+done
+
+./compile.py test_permute || exit 1
+
+for players in 2 3; do
+    Scripts/semi.sh -N $players test_permute || exit 1
+done
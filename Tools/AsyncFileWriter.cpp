@@ -0,0 +1,102 @@
+/*
+ * AsyncFileWriter.cpp
+ *
+ */
+
+#include "AsyncFileWriter.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/stat.h>
+
+AsyncFileWriter::AsyncFileWriter() :
+        busy(false), done(false)
+{
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    {
+        lock_guard<mutex> _(lock);
+        done = true;
+    }
+    cond.notify_all();
+    if (writer.joinable())
+        writer.join();
+}
+
+void AsyncFileWriter::write(int fd, const string& filename, long offset,
+        vector<char>& data)
+{
+    {
+        lock_guard<mutex> _(lock);
+
+        auto& end = ends[filename];
+        if (offset < 0)
+        {
+            struct stat buf;
+            if (fstat(fd, &buf))
+                throw runtime_error("cannot access " + filename);
+            offset = max(end, long(buf.st_size));
+        }
+        end = max(end, offset + long(data.size()));
+
+        blocks.push_back({fd, offset, {}});
+        blocks.back().data.swap(data);
+
+        if (not writer.joinable())
+            writer = thread(&AsyncFileWriter::run, this);
+    }
+    cond.notify_all();
+}
+
+void AsyncFileWriter::run()
+{
+    unique_lock<mutex> guard(lock);
+    while (true)
+    {
+        if (blocks.empty())
+        {
+            if (done)
+                return;
+            cond.wait(guard);
+            continue;
+        }
+
+        auto block = move(blocks.front());
+        blocks.pop_front();
+        busy = true;
+        guard.unlock();
+
+        size_t written = 0;
+        while (written < block.data.size())
+        {
+            auto res = pwrite(block.fd, block.data.data() + written,
+                    block.data.size() - written, block.offset + written);
+            if (res <= 0)
+                break;
+            written += res;
+        }
+
+        guard.lock();
+        if (written < block.data.size() and error.empty())
+            error = string("writing failed: ") + strerror(errno);
+        busy = false;
+        cond.notify_all();
+    }
+}
+
+void AsyncFileWriter::flush()
+{
+    unique_lock<mutex> guard(lock);
+    cond.wait(guard, [this]() { return blocks.empty() and not busy; });
+    // file sizes are accurate again
+    ends.clear();
+    if (not error.empty())
+    {
+        string message = error;
+        error.clear();
+        throw runtime_error(message);
+    }
+}
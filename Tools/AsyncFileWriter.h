@@ -0,0 +1,80 @@
+/*
+ * AsyncFileWriter.h
+ *
+ */
+
+#ifndef TOOLS_ASYNCFILEWRITER_H_
+#define TOOLS_ASYNCFILEWRITER_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <streambuf>
+using namespace std;
+
+/**
+ * Background thread writing blocks to files with ``pwrite``. Blocks
+ * to the same file are written in order, and appending blocks get
+ * their offset when queued, so that later reads only need to wait
+ * for completion with :cpp:func:`flush`.
+ */
+class AsyncFileWriter
+{
+    struct Block
+    {
+        int fd;
+        long offset;
+        vector<char> data;
+    };
+
+    mutex lock;
+    condition_variable cond;
+    deque<Block> blocks;
+    // end of data including queued blocks by file name
+    map<string, long> ends;
+    bool busy, done;
+    string error;
+    thread writer;
+
+    void run();
+
+public:
+    /// Stream buffer for serializing into a block
+    class OutputBuffer : public streambuf
+    {
+        vector<char>& data;
+
+    public:
+        OutputBuffer(vector<char>& data) : data(data) {}
+
+    protected:
+        int_type overflow(int_type c)
+        {
+            if (c != traits_type::eof())
+                data.push_back(c);
+            return c;
+        }
+
+        streamsize xsputn(const char* s, streamsize n)
+        {
+            data.insert(data.end(), s, s + n);
+            return n;
+        }
+    };
+
+    AsyncFileWriter();
+    ~AsyncFileWriter();
+
+    /// Queue ``data`` for writing at ``offset`` or at the end if negative
+    void write(int fd, const string& filename, long offset,
+            vector<char>& data);
+
+    /// Wait for all writes and throw on errors
+    void flush();
+};
+
+#endif /* TOOLS_ASYNCFILEWRITER_H_ */
@@ -9,6 +9,8 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 bool BufferBase::rewind = false;
 
@@ -48,6 +50,16 @@ void BufferBase::seekg(int pos)
             file = open();
     }
 
+    prefetched = 0;
+    if (mapped)
+    {
+        mapped_pos = header_length + size_t(pos) * tuple_length;
+        if (mapped_pos > mapped_size and pos != 0)
+            try_rewind();
+        next = BUFFER_SIZE;
+        return;
+    }
+
     file->seekg(header_length + pos * tuple_length);
     if (file->eof() || file->fail())
     {
@@ -73,10 +85,19 @@ void BufferBase::try_rewind()
         type = (string)" of " + field_type + " " + data_type;
     throw not_enough_to_buffer(type, filename);
 #endif
-    file->clear(); // unset EOF flag
-    file->seekg(header_length);
-    if (file->peek() == ifstream::traits_type::eof())
-        throw runtime_error("empty file: " + filename);
+    if (mapped)
+    {
+        mapped_pos = header_length;
+        if (mapped_pos >= mapped_size)
+            throw runtime_error("empty file: " + filename);
+    }
+    else
+    {
+        file->clear(); // unset EOF flag
+        file->seekg(header_length);
+        if (file->peek() == ifstream::traits_type::eof())
+            throw runtime_error("empty file: " + filename);
+    }
     if (!rewind)
         cerr << "REUSING DATA - ONLY FOR BENCHMARKING" << endl;
     rewind = true;
@@ -93,6 +114,13 @@ void BufferBase::prune()
     if (is_pipe())
         return;
 
+    if (file and mapped)
+    {
+        // continue with stream where reading ended
+        file->seekg(mapped_pos);
+        unmap();
+    }
+
     if (file and (not file->good() or file->peek() == EOF))
         purge();
     else if (file and file->tellg() != header_length)
@@ -116,6 +144,7 @@ void BufferBase::prune()
                             + to_string(start) + " of " + filename);
         tmp.close();
         file->close();
+        stop_prefetch();
         rename(tmp_name.c_str(), filename.c_str());
         file->open(filename.c_str(), ios::in | ios::binary);
         delete[] buf;
@@ -141,6 +170,8 @@ void BufferBase::purge()
         if (verbose)
             cerr << "Removing " << filename << endl;
         unlink(filename.c_str());
+        stop_prefetch();
+        unmap();
         if (file)
         {
             file->close();
@@ -161,3 +192,81 @@ void BufferBase::check_tuple_length(int tuple_length)
     if (tuple_length != this->tuple_length)
         throw Processor_Error("inconsistent tuple length");
 }
+
+void BufferBase::prefetch()
+{
+#ifdef POSIX_FADV_WILLNEED
+    size_t window = size_t(OnlineOptions::singleton.prefetch) << 20;
+    if (not window or not file)
+        return;
+
+    // renew hint when half of the window is consumed
+    size_t pos = mapped ? mapped_pos : size_t(file->tellg());
+    if (pos + window / 2 < prefetched)
+        return;
+
+    if (mapped)
+    {
+        size_t start = pos - pos % sysconf(_SC_PAGESIZE);
+        madvise((void*) (mapped + start),
+                min(window, mapped_size - start), MADV_WILLNEED);
+        prefetched = pos + window;
+        return;
+    }
+
+    if (prefetch_fd < 0)
+    {
+        prefetch_fd = ::open(filename.c_str(), O_RDONLY);
+        if (prefetch_fd < 0)
+            return;
+    }
+
+    // asynchronous, failure (e.g., for pipes) is not a problem
+    posix_fadvise(prefetch_fd, pos, window, POSIX_FADV_WILLNEED);
+    prefetched = pos + window;
+#endif
+}
+
+void BufferBase::stop_prefetch()
+{
+    if (prefetch_fd >= 0)
+        close(prefetch_fd);
+    prefetch_fd = -1;
+    prefetched = 0;
+}
+
+void BufferBase::map()
+{
+    if (not file or not file->good() or is_pipe())
+        return;
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat buf;
+    if (fstat(fd, &buf) == 0 and buf.st_size > 0)
+    {
+        void* res = mmap(0, buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (res != MAP_FAILED)
+        {
+            madvise(res, buf.st_size, MADV_SEQUENTIAL);
+            mapped = (const char*) res;
+            mapped_size = buf.st_size;
+            // continue where the stream is
+            mapped_pos = file->tellg();
+        }
+    }
+
+    // the mapping stays valid
+    close(fd);
+}
+
+void BufferBase::unmap()
+{
+    if (mapped)
+        munmap((void*) mapped, mapped_size);
+    mapped = 0;
+    mapped_size = 0;
+    mapped_pos = 0;
+}
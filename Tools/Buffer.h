@@ -9,6 +9,7 @@
 #include <fstream>
 #include <iostream>
 #include <assert.h>
+#include <string.h>
 using namespace std;
 
 #include "Math/field_types.h"
@@ -35,13 +36,26 @@ protected:
     string filename;
     int header_length;
 
+    // separate descriptor for read-ahead hints
+    int prefetch_fd;
+    size_t prefetched;
+
+    // whole file if mapped, see map()
+    const char* mapped;
+    size_t mapped_size, mapped_pos;
+
     virtual int element_length() = 0;
 
+    void prefetch();
+    void map();
+
 public:
     bool eof;
 
     BufferBase() : file(0), next(BUFFER_SIZE),
-            tuple_length(-1), header_length(0), eof(false) {}
+            tuple_length(-1), header_length(0), prefetch_fd(-1),
+            prefetched(0), mapped(0), mapped_size(0), mapped_pos(0),
+            eof(false) {}
     ~BufferBase() {}
     virtual ifstream* open() = 0;
     void setup(ifstream* f, int length, const string& filename,
@@ -53,6 +67,8 @@ public:
     void prune();
     void purge();
     void check_tuple_length(int tuple_length);
+    void stop_prefetch();
+    void unmap();
 };
 
 
@@ -180,6 +196,8 @@ public:
         if (file)
             delete file;
         file = 0;
+        this->stop_prefetch();
+        this->unmap();
     }
 };
 
@@ -226,7 +244,19 @@ inline void Buffer<T, U>::read(char* read_buffer)
     timer.start();
     if (not file)
         file = open();
-    do
+    if (not mapped and OnlineOptions::singleton.has_option("mmap_prep"))
+        map();
+    while (mapped and n_read < size_in_bytes)
+    {
+        size_t left = mapped_pos < mapped_size ? mapped_size - mapped_pos : 0;
+        size_t n = min(size_t(size_in_bytes - n_read), left);
+        memcpy(read_buffer + n_read, mapped + mapped_pos, n);
+        n_read += n;
+        mapped_pos += n;
+        if (n_read < size_in_bytes)
+            try_rewind();
+    }
+    while (n_read < size_in_bytes)
     {
         file->read(read_buffer + n_read, size_in_bytes - n_read);
         n_read += file->gcount();
@@ -247,7 +277,7 @@ inline void Buffer<T, U>::read(char* read_buffer)
             throw file_error(ss.str());
           }
     }
-    while (n_read < size_in_bytes);
+    prefetch();
     timer.stop();
 }
 
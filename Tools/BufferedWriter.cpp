@@ -0,0 +1,152 @@
+/*
+ * BufferedWriter.cpp
+ *
+ */
+
+#include "BufferedWriter.h"
+
+#include <set>
+
+namespace
+{
+thread_local std::set<BufferedWriter*> writers;
+}
+
+void* BufferedWriter::run_thread(void* writer)
+{
+    ((BufferedWriter*) writer)->run();
+    return 0;
+}
+
+void BufferedWriter::flush_all()
+{
+    for (auto writer : writers)
+        writer->flush();
+}
+
+BufferedWriter::BufferedWriter(ostream& stream, size_t threshold) :
+        stream(stream), front(0), busy(false), failed(false),
+        threshold(threshold), chunked(false), type(ChunkedFile::RAW),
+        section_end{false, false}, offset(0), n_writes(0), n_bytes(0)
+{
+    pthread_create(&thread, 0, run_thread, this);
+    writers.insert(this);
+}
+
+BufferedWriter::BufferedWriter(ostream& stream, ChunkedFile::Type type,
+        size_t threshold) :
+        BufferedWriter(stream, threshold)
+{
+    if (type == ChunkedFile::ZSTD and not ChunkedFile::have_zstd())
+        throw runtime_error("compile with USE_ZSTD for compression");
+    chunked = true;
+    this->type = type;
+    octet magic[8];
+    encode_length(magic, ChunkedFile::MAGIC, 8);
+    stream.write((char*) magic, 8);
+    offset = 8;
+    sections.push_back(offset);
+}
+
+BufferedWriter::~BufferedWriter()
+{
+    writers.erase(this);
+    try
+    {
+        flush(true);
+        if (chunked)
+        {
+            ChunkedFile::write_index(stream, sections, offset);
+            stream.flush();
+        }
+    }
+    catch (exception& e)
+    {
+        cerr << "Error in background writing: " << e.what() << endl;
+    }
+    in.stop();
+    pthread_join(thread, 0);
+}
+
+void BufferedWriter::run()
+{
+    octetStream* buffer;
+    while (in.pop(buffer))
+    {
+        try
+        {
+            TimeScope ts(timer);
+            if (chunked)
+                offset += ChunkedFile::write_chunk(stream, *buffer, type,
+                        compressed);
+            else
+                stream.write((char*) buffer->get_data(), buffer->get_length());
+        }
+        catch (exception& e)
+        {
+            cerr << "Background writing: " << e.what() << endl;
+            failed = true;
+        }
+        if (not stream.good())
+            failed = true;
+        if (section_end[buffer - buffers])
+        {
+            end_section();
+            section_end[buffer - buffers] = false;
+        }
+        n_writes++;
+        n_bytes += buffer->get_length();
+        buffer->reset_write_head();
+        out.push(buffer);
+    }
+}
+
+void BufferedWriter::wait()
+{
+    if (busy)
+    {
+        out.pop();
+        busy = false;
+    }
+    if (failed)
+        throw runtime_error("error in background writing");
+}
+
+void BufferedWriter::end_section()
+{
+    if (chunked and sections.back() != offset)
+        sections.push_back(offset);
+}
+
+void BufferedWriter::dispatch()
+{
+    wait();
+    in.push(&buffers[front]);
+    busy = true;
+    front = 1 - front;
+}
+
+void BufferedWriter::write(const octetStream& os)
+{
+    auto& buffer = buffers[front];
+    size_t length = os.get_length();
+    buffer.append((octet*) &length, sizeof(length));
+    buffer.append(os.get_data(), length);
+    if (buffer.get_length() >= threshold)
+        dispatch();
+}
+
+void BufferedWriter::flush(bool section)
+{
+    if (buffers[front].get_length())
+    {
+        section_end[front] = section;
+        dispatch();
+    }
+    wait();
+    if (section)
+        end_section();
+    stream.flush();
+    if (not stream.good())
+        throw runtime_error("error in background writing");
+}
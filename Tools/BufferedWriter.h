@@ -0,0 +1,79 @@
+/*
+ * BufferedWriter.h
+ *
+ */
+
+#ifndef TOOLS_BUFFEREDWRITER_H_
+#define TOOLS_BUFFEREDWRITER_H_
+
+#include <pthread.h>
+#include <ostream>
+
+#include "Tools/octetStream.h"
+#include "Tools/WaitQueue.h"
+#include "Tools/time-func.h"
+#include "Tools/ChunkedFile.h"
+
+#ifndef BUFFERED_WRITER_SIZE
+#define BUFFERED_WRITER_SIZE (1 << 20)
+#endif
+
+/**
+ * Background writer with a bounded double buffer.
+ * Length-prefixed octetStreams are coalesced in the same format
+ * as ``octetStream::output()`` and written in large chunks.
+ * Calling ``flush()`` makes sure that everything has been written.
+ * In chunked mode, the output follows the format in ChunkedFile.h
+ * with optional compression done by the background thread.
+ */
+class BufferedWriter
+{
+    std::ostream& stream;
+    octetStream buffers[2];
+    int front;
+    bool busy;
+    bool failed;
+    size_t threshold;
+
+    bool chunked;
+    ChunkedFile::Type type;
+    bool section_end[2];
+    std::vector<uint64_t> sections;
+    uint64_t offset;
+    octetStream compressed;
+
+    WaitQueue<octetStream*> in, out;
+    pthread_t thread;
+
+    static void* run_thread(void* writer);
+
+    // prevent copying
+    BufferedWriter(const BufferedWriter& other);
+
+    void run();
+    void dispatch();
+    void wait();
+    void end_section();
+
+public:
+    // written in background, only access when flushed
+    size_t n_writes, n_bytes;
+    Timer timer;
+
+    /// Flush all writers in this thread
+    static void flush_all();
+
+    BufferedWriter(std::ostream& stream, size_t threshold = BUFFERED_WRITER_SIZE);
+    /// Chunked mode (``ChunkedFile::RAW`` or ``ChunkedFile::ZSTD``)
+    BufferedWriter(std::ostream& stream, ChunkedFile::Type type,
+            size_t threshold = BUFFERED_WRITER_SIZE);
+    ~BufferedWriter();
+
+    /// Queue content for writing with length prefix
+    void write(const octetStream& os);
+    /// Wait until everything has been written and flush the stream,
+    /// optionally marking the end of a section (tape) in the index
+    void flush(bool section = false);
+};
+
+#endif /* TOOLS_BUFFEREDWRITER_H_ */
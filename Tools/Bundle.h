@@ -46,4 +46,28 @@ public:
     }
 };
 
+/**
+ * Bundle with buffers leased from the player's pool until destruction
+ */
+class PooledBundle : public Bundle<octetStream>
+{
+    OctetStreamPool& pool;
+
+public:
+    PooledBundle(const PlayerBase& P) :
+            Bundle<octetStream>(P), pool(P.stream_pool)
+    {
+        for (auto& os : *this)
+            pool.take(os);
+    }
+
+    ~PooledBundle()
+    {
+        for (auto& os : *this)
+            pool.give(os);
+    }
+
+    PooledBundle(const PooledBundle&) = delete;
+};
+
 #endif /* TOOLS_BUNDLE_H_ */
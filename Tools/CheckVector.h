@@ -12,14 +12,16 @@ using namespace std;
 #include "Math/Integer.h"
 #include "Processor/Instruction.h"
 #include "Processor/OnlineOptions.h"
+#include "Tools/HugePages.h"
+#include "Tools/MemoryAccounting.h"
 
-template <class T>
-class CheckVector : public vector<T>
+template <class T, class A = allocator<T>>
+class CheckVector : public vector<T, A>
 {
 public:
-    CheckVector() : vector<T>() {}
-    CheckVector(size_t size) : vector<T>(size) {}
-    CheckVector(size_t size, const T& def) : vector<T>(size, def) {}
+    CheckVector() : vector<T, A>() {}
+    CheckVector(size_t size) : vector<T, A>(size) {}
+    CheckVector(size_t size, const T& def) : vector<T, A>(size, def) {}
 #ifndef NO_CHECK_SIZE
     T& operator[](size_t i) { return this->at(i); }
     const T& operator[](size_t i) const { return this->at(i); }
@@ -29,15 +31,27 @@ public:
 #endif
 };
 
+// for large memory
+template<class T>
+using HugePageVector = CheckVector<T, HugePageAllocator<T>>;
+
+// accounted per subsystem, see MemoryAccounting
+template<class T>
+using RegisterVector = CheckVector<T, AccountingAllocator<T,
+        MemoryAccounting::REGISTERS, HugePageAllocator<T>>>;
+template<class T>
+using MemoryVector = CheckVector<T, AccountingAllocator<T,
+        MemoryAccounting::MEMORY, HugePageAllocator<T>>>;
+
 template <class T>
-class StackedVector : CheckVector<T>
+class StackedVector : RegisterVector<T>
 {
     vector<size_t> stack;
-    CheckVector<T>& full;
+    RegisterVector<T>& full;
     size_t start, finish;
 
 public:
-    typedef typename CheckVector<T>::iterator iterator;
+    typedef typename RegisterVector<T>::iterator iterator;
 
     StackedVector() :
             StackedVector<T>(0)
@@ -48,7 +62,7 @@ public:
     {
     }
     StackedVector(size_t size, const T& def) :
-            CheckVector<T>(size, def), full(*this), start(0), finish(size)
+            RegisterVector<T>(size, def), full(*this), start(0), finish(size)
     {
     }
 
@@ -0,0 +1,270 @@
+/*
+ * ChunkedFile.cpp
+ *
+ */
+
+#include "ChunkedFile.h"
+
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifndef ZSTD_LEVEL
+#define ZSTD_LEVEL 1
+#endif
+
+using namespace std;
+
+namespace ChunkedFile
+{
+
+void Header::write(ostream& s) const
+{
+    octet buffer[N_BYTES];
+    buffer[0] = type;
+    encode_length(buffer + 1, raw_length, 8);
+    encode_length(buffer + 9, stored_length, 8);
+    s.write((char*) buffer, N_BYTES);
+}
+
+bool Header::read(istream& s)
+{
+    octet buffer[N_BYTES];
+    s.read((char*) buffer, N_BYTES);
+    if (not s.good())
+        return false;
+    type = buffer[0];
+    raw_length = decode_length(buffer + 1, 8);
+    stored_length = decode_length(buffer + 9, 8);
+    return true;
+}
+
+bool have_zstd()
+{
+#ifdef USE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t write_chunk(ostream& s, const octetStream& data, Type type,
+        octetStream& buffer)
+{
+    Header header;
+    header.type = type;
+    header.raw_length = data.get_length();
+    const octetStream* stored = &data;
+
+    if (type == ZSTD)
+    {
+#ifdef USE_ZSTD
+        buffer.reset_write_head();
+        buffer.resize_min(ZSTD_compressBound(data.get_length()));
+        size_t res = ZSTD_compress(buffer.get_data(), buffer.get_max_length(),
+                data.get_data(), data.get_length(), ZSTD_LEVEL);
+        if (ZSTD_isError(res))
+            throw runtime_error(
+                    string("compression error: ") + ZSTD_getErrorName(res));
+        buffer.append(res);
+        stored = &buffer;
+#else
+        (void) buffer;
+        throw runtime_error("compile with USE_ZSTD for compression");
+#endif
+    }
+    else
+        assert(type == RAW);
+
+    header.stored_length = stored->get_length();
+    header.write(s);
+    s.write((char*) stored->get_data(), stored->get_length());
+    return Header::N_BYTES + stored->get_length();
+}
+
+void write_index(ostream& s, const vector<uint64_t>& sections, uint64_t offset)
+{
+    octetStream os;
+    for (auto& x : sections)
+        os.store_int(x, 8);
+    Header header;
+    header.type = INDEX;
+    header.raw_length = header.stored_length = os.get_length();
+    header.write(s);
+    s.write((char*) os.get_data(), os.get_length());
+    octet trailer[16];
+    encode_length(trailer, offset, 8);
+    encode_length(trailer + 8, MAGIC, 8);
+    s.write((char*) trailer, 16);
+}
+
+}
+
+using namespace ChunkedFile;
+
+void* ChunkedReader::run_thread(void* reader)
+{
+    ((ChunkedReader*) reader)->run();
+    return 0;
+}
+
+ChunkedReader::ChunkedReader(istream& stream) :
+        stream(stream), current(0), outstanding(0), failed(false),
+        finished(false)
+{
+    octet magic[8];
+    stream.read((char*) magic, 8);
+    if (not stream.good() or decode_length(magic, 8) != MAGIC)
+        throw runtime_error("preprocessing not in chunked format, "
+                "use the same options for both phases");
+    pthread_create(&thread, 0, run_thread, this);
+    for (auto& buffer : buffers)
+    {
+        in.push(&buffer);
+        outstanding++;
+    }
+}
+
+ChunkedReader::~ChunkedReader()
+{
+    in.stop();
+    pthread_join(thread, 0);
+}
+
+bool ChunkedReader::read_chunk(octetStream& buffer)
+{
+    Header header;
+    if (not header.read(stream) or header.type == INDEX)
+        return false;
+
+    buffer.reset_write_head();
+
+    switch (header.type)
+    {
+    case RAW:
+        if (header.stored_length != header.raw_length)
+            throw runtime_error("inconsistent chunk header");
+        stream.read((char*) buffer.append(header.raw_length),
+                header.raw_length);
+        break;
+    case ZSTD:
+    {
+#ifdef USE_ZSTD
+        compressed.reset_write_head();
+        stream.read((char*) compressed.append(header.stored_length),
+                header.stored_length);
+        size_t res = ZSTD_decompress(buffer.append(header.raw_length),
+                header.raw_length, compressed.get_data(),
+                header.stored_length);
+        if (ZSTD_isError(res) or res != header.raw_length)
+            throw runtime_error("decompression error");
+#else
+        throw runtime_error("compile with USE_ZSTD for decompression");
+#endif
+        break;
+    }
+    default:
+        throw runtime_error("unknown chunk type");
+    }
+
+    if (not stream.good())
+        throw runtime_error("truncated chunk");
+    return true;
+}
+
+void ChunkedReader::run()
+{
+    octetStream* buffer;
+    while (in.pop(buffer))
+    {
+        buffer->reset_write_head();
+        if (not finished)
+        {
+            try
+            {
+                finished = not read_chunk(*buffer);
+            }
+            catch (exception& e)
+            {
+                buffer->reset_write_head();
+                error = e.what();
+                failed = finished = true;
+            }
+        }
+        out.push(buffer);
+    }
+}
+
+void ChunkedReader::next_chunk()
+{
+    if (current)
+    {
+        in.push(current);
+        outstanding++;
+    }
+    current = out.pop();
+    outstanding--;
+    if (current->done())
+    {
+        if (failed)
+            throw runtime_error("error in preprocessing reading: " + error);
+        else
+            throw IO_Error("not enough data");
+    }
+}
+
+void ChunkedReader::read(octetStream& os)
+{
+    while (current == 0 or current->done())
+        next_chunk();
+    size_t length;
+    current->consume((octet*) &length, sizeof(length));
+    os.reset_write_head();
+    current->consume(os, length);
+}
+
+void ChunkedReader::drain()
+{
+    while (outstanding)
+    {
+        out.pop();
+        outstanding--;
+    }
+    current = 0;
+}
+
+vector<uint64_t> ChunkedReader::sections()
+{
+    drain();
+    stream.clear();
+    stream.seekg(-16, ios::end);
+    octet trailer[16];
+    stream.read((char*) trailer, 16);
+    if (not stream.good() or decode_length(trailer + 8, 8) != MAGIC)
+        throw runtime_error("no index in preprocessing file");
+    stream.seekg(decode_length(trailer, 8));
+    Header header;
+    if (not header.read(stream) or header.type != INDEX)
+        throw runtime_error("invalid index in preprocessing file");
+    octetStream os;
+    stream.read((char*) os.append(header.raw_length), header.raw_length);
+    vector<uint64_t> res;
+    while (os.left())
+        res.push_back(os.get_int(8));
+    return res;
+}
+
+void ChunkedReader::seek_section(size_t section)
+{
+    auto offsets = sections();
+    if (section >= offsets.size())
+        throw runtime_error("section " + to_string(section) + " not in index");
+    stream.clear();
+    stream.seekg(offsets[section]);
+    finished = failed = false;
+    for (auto& buffer : buffers)
+    {
+        in.push(&buffer);
+        outstanding++;
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * ChunkedFile.h
+ *
+ */
+
+#ifndef TOOLS_CHUNKEDFILE_H_
+#define TOOLS_CHUNKEDFILE_H_
+
+#include <pthread.h>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "Tools/octetStream.h"
+#include "Tools/WaitQueue.h"
+
+/**
+ * Container for a sequence of length-prefixed octetStreams.
+ * After an eight-byte magic number, the file consists of chunks
+ * with a header (type, raw length, stored length) and the content in
+ * ``octetStream::output()`` format, optionally compressed.
+ * The last chunk is an index of section (tape) offsets,
+ * which is followed by the offset of the index chunk.
+ */
+namespace ChunkedFile
+{
+
+const uint64_t MAGIC = 0x31464b4e48435a53;
+
+enum Type : octet
+{
+    RAW, ZSTD, INDEX
+};
+
+struct Header
+{
+    octet type;
+    uint64_t raw_length;
+    uint64_t stored_length;
+
+    static const int N_BYTES = 17;
+
+    void write(std::ostream& s) const;
+    bool read(std::istream& s);
+};
+
+/// Write chunk, compressing if requested and supported
+size_t write_chunk(std::ostream& s, const octetStream& data, Type type,
+        octetStream& buffer);
+/// Write index and trailer
+void write_index(std::ostream& s, const std::vector<uint64_t>& sections,
+        uint64_t offset);
+/// Whether compression is available
+bool have_zstd();
+
+}
+
+/**
+ * Reads a chunked file with prefetching and decompression
+ * in a background thread
+ */
+class ChunkedReader
+{
+    std::istream& stream;
+    octetStream buffers[2];
+    octetStream* current;
+    octetStream compressed;
+    int outstanding;
+    bool failed, finished;
+    std::string error;
+
+    WaitQueue<octetStream*> in, out;
+    pthread_t thread;
+
+    static void* run_thread(void* reader);
+
+    // prevent copying
+    ChunkedReader(const ChunkedReader& other);
+
+    void run();
+    bool read_chunk(octetStream& buffer);
+    void next_chunk();
+    void drain();
+
+public:
+    ChunkedReader(std::istream& stream);
+    ~ChunkedReader();
+
+    /// Read next message
+    void read(octetStream& os);
+
+    /// Section offsets from index (only for seekable files)
+    std::vector<uint64_t> sections();
+    /// Continue reading at the beginning of a section (tape)
+    void seek_section(size_t section);
+};
+
+#endif /* TOOLS_CHUNKEDFILE_H_ */
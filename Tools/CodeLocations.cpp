@@ -5,6 +5,7 @@
 
 #include "CodeLocations.h"
 #include "Processor/OnlineOptions.h"
+#include "Processor/Profiler.h"
 
 CodeLocations CodeLocations::singleton;
 
@@ -13,6 +14,8 @@ void CodeLocations::maybe_output(const char* file, int line,
 {
     if (OnlineOptions::singleton.code_locations)
         singleton.output(file, line, function);
+    if (OnlineOptions::singleton.profile)
+        Profiler::maybe_note(function);
 }
 
 void CodeLocations::output(const char* file, int line,
@@ -6,6 +6,7 @@
 #include "Coordinator.h"
 #include "Bundle.h"
 #include "Processor/OnlineOptions.h"
+#include "Tools/CpuAffinity.h"
 
 void* Coordinator::run_thread(void* coordinator)
 {
@@ -29,6 +30,7 @@ Coordinator::~Coordinator()
 
 void Coordinator::run()
 {
+    CpuAffinity::pin_helper();
     string id;
     while (in.pop(id))
     {
@@ -0,0 +1,159 @@
+/*
+ * CpuAffinity.cpp
+ *
+ */
+
+#include "CpuAffinity.h"
+#include "Processor/OnlineOptions.h"
+
+#include <sched.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <algorithm>
+
+using namespace std;
+
+vector<int> CpuAffinity::parse_list(const string& list)
+{
+    // format of /sys/devices/system/node/node*/cpulist, e.g., 0-3,8,10-11
+    vector<int> res;
+    size_t pos = 0;
+    while (pos < list.size())
+    {
+        size_t end = list.find(',', pos);
+        if (end == string::npos)
+            end = list.size();
+        string range = list.substr(pos, end - pos);
+        pos = end + 1;
+        if (range.empty() or range == "\n")
+            continue;
+        size_t dash = range.find('-');
+        int first = stoi(range.substr(0, dash));
+        int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+        if (first < 0 or last < first)
+            throw invalid_argument(range);
+        for (int i = first; i <= last; i++)
+            res.push_back(i);
+    }
+    return res;
+}
+
+CpuAffinity::CpuAffinity(const string& policy)
+{
+    if (policy.empty())
+        return;
+
+    // mask of main thread, which is never pinned
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(getpid(), sizeof(allowed), &allowed))
+        return;
+
+    for (int i = 0;; i++)
+    {
+        ifstream file(
+                "/sys/devices/system/node/node" + to_string(i) + "/cpulist");
+        if (not file.good())
+            break;
+        string list;
+        getline(file, list);
+        vector<int> node;
+        for (int cpu : parse_list(list))
+            if (cpu < CPU_SETSIZE and CPU_ISSET(cpu, &allowed))
+                node.push_back(cpu);
+        if (not node.empty())
+            nodes.push_back(node);
+    }
+
+    if (nodes.empty())
+    {
+        nodes.push_back({});
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &allowed))
+                nodes[0].push_back(cpu);
+    }
+
+    if (policy == "compact" or (policy == "auto" and nodes.size() > 1))
+    {
+        for (auto& node : nodes)
+            order.insert(order.end(), node.begin(), node.end());
+    }
+    else if (policy == "scatter")
+    {
+        for (size_t i = 0; order.size() < (size_t) CPU_COUNT(&allowed); i++)
+            for (auto& node : nodes)
+                if (i < node.size())
+                    order.push_back(node[i]);
+    }
+    else if (policy != "auto")
+    {
+        order = parse_list(policy);
+        // helpers only use listed CPUs as well
+        set<int> listed(order.begin(), order.end());
+        for (auto& node : nodes)
+        {
+            vector<int> left;
+            for (int cpu : node)
+                if (listed.count(cpu))
+                    left.push_back(cpu);
+            node = left;
+        }
+    }
+}
+
+CpuAffinity& CpuAffinity::s()
+{
+    static CpuAffinity singleton(OnlineOptions::singleton.cpu_affinity);
+    return singleton;
+}
+
+void CpuAffinity::check(const string& policy)
+{
+    if (policy.empty() or policy == "auto" or policy == "compact"
+            or policy == "scatter")
+        return;
+    try
+    {
+        auto cpus = parse_list(policy);
+        if (not cpus.empty()
+                and *max_element(cpus.begin(), cpus.end()) < CPU_SETSIZE)
+            return;
+    }
+    catch (logic_error&)
+    {
+    }
+    cerr << "Invalid CPU affinity: " << policy << endl;
+    exit(1);
+}
+
+void CpuAffinity::pin_compute(int thread_num)
+{
+    auto& order = s().order;
+    if (order.empty())
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(order[thread_num % order.size()], &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+void CpuAffinity::pin_helper()
+{
+    auto& affinity = s();
+    if (affinity.order.empty())
+        return;
+    int current = sched_getcpu();
+    for (auto& node : affinity.nodes)
+        for (int cpu : node)
+            if (cpu == current)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (int x : node)
+                    CPU_SET(x, &set);
+                sched_setaffinity(0, sizeof(set), &set);
+                return;
+            }
+}
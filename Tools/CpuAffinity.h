@@ -0,0 +1,41 @@
+/*
+ * CpuAffinity.h
+ *
+ */
+
+#ifndef TOOLS_CPUAFFINITY_H_
+#define TOOLS_CPUAFFINITY_H_
+
+#include <string>
+#include <vector>
+
+/**
+ * Placement of threads on CPUs according to ``--cpu-affinity``.
+ * Computation threads are pinned to one CPU each in the order given
+ * by the policy, while helper threads (communication, preprocessing)
+ * may run on any CPU on the NUMA node of the thread creating them.
+ */
+class CpuAffinity
+{
+    // allowed CPUs per NUMA node
+    std::vector<std::vector<int>> nodes;
+    // CPUs for computation threads in order
+    std::vector<int> order;
+
+    CpuAffinity(const std::string& policy);
+
+    static std::vector<int> parse_list(const std::string& list);
+
+public:
+    static CpuAffinity& s();
+
+    /// Pin calling computation thread to CPU by thread number
+    static void pin_compute(int thread_num);
+    /// Restrict calling helper thread to the node of the current CPU
+    static void pin_helper();
+
+    /// Check option value and exit if invalid
+    static void check(const std::string& policy);
+};
+
+#endif /* TOOLS_CPUAFFINITY_H_ */
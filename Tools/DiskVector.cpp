@@ -7,6 +7,8 @@
 #include "Processor/OnlineOptions.h"
 
 #include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 void sigbus_handler(int)
 {
@@ -16,6 +18,13 @@ void sigbus_handler(int)
     exit(1);
 }
 
+DiskVectorBase::~DiskVectorBase()
+{
+    if (fd >= 0)
+        close(fd);
+    boost::filesystem::remove(path);
+}
+
 void DiskVectorBase::init(size_t byte_size)
 {
     if (file.is_open())
@@ -42,7 +51,53 @@ void DiskVectorBase::init(size_t byte_size)
     file.open(path, boost::iostreams::mapped_file::readwrite, byte_size);
     assert(file.size() == byte_size);
 
+    fd = ::open(path.native().c_str(), O_RDWR);
     boost::filesystem::remove(path);
 
     signal(SIGBUS, sigbus_handler);
 }
+
+void DiskVectorBase::advise(size_t byte_start, size_t byte_length,
+        DiskAccessPattern pattern)
+{
+    if (not file.is_open() or byte_length == 0)
+        return;
+
+    // madvise requires page alignment
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t offset = byte_start / page_size * page_size;
+    size_t length = min(byte_start + byte_length, file.size()) - offset;
+    auto start = file.data() + offset;
+
+    int res = 0;
+    switch (pattern)
+    {
+    case DISK_NORMAL:
+        res = madvise(start, length, MADV_NORMAL);
+        break;
+    case DISK_SEQUENTIAL:
+        res = madvise(start, length, MADV_SEQUENTIAL);
+        break;
+    case DISK_RANDOM:
+        res = madvise(start, length, MADV_RANDOM);
+        break;
+    case DISK_WILLNEED:
+        // the kernel reads ahead asynchronously
+        res = madvise(start, length, MADV_WILLNEED);
+        break;
+    case DISK_DONE:
+#ifdef __linux__
+        if (fd >= 0)
+            res = sync_file_range(fd, offset, length, SYNC_FILE_RANGE_WRITE);
+#else
+        res = msync(start, length, MS_ASYNC);
+#endif
+        break;
+    default:
+        throw runtime_error("unknown access pattern: " + to_string(pattern));
+    }
+
+    // hints are optional
+    if (res and OnlineOptions::singleton.verbose)
+        cerr << "disk memory hint failed: " << strerror(errno) << endl;
+}
@@ -8,20 +8,39 @@
 
 #include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
+
+/// Access pattern hints for disk memory
+enum DiskAccessPattern
+{
+    DISK_NORMAL,
+    DISK_SEQUENTIAL,
+    DISK_RANDOM,
+    // prefetch in the background
+    DISK_WILLNEED,
+    // start writing back in the background
+    DISK_DONE,
+};
 
 class DiskVectorBase
 {
 protected:
     boost::iostreams::mapped_file file;
     boost::filesystem::path path;
+    // kept for write-behind after the path is removed
+    int fd;
 
 public:
-    ~DiskVectorBase()
+    DiskVectorBase() : fd(-1)
     {
-        boost::filesystem::remove(path);
     }
 
+    ~DiskVectorBase();
+
     void init(size_t byte_size);
+
+    void advise(size_t byte_start, size_t byte_length,
+            DiskAccessPattern pattern);
 };
 
 template<class T>
@@ -79,6 +98,15 @@ public:
         assert(index <= size_);
         return data_[index];
     }
+
+    /// Hint how ``n`` items from ``start`` are going to be accessed
+    void advise(size_t start, size_t n, DiskAccessPattern pattern)
+    {
+        if (start >= size_)
+            return;
+        n = std::min(n, size_ - start);
+        DiskVectorBase::advise(start * sizeof(T), n * sizeof(T), pattern);
+    }
 };
 
 #endif /* TOOLS_DISKVECTOR_H_ */
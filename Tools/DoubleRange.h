@@ -9,7 +9,7 @@
 template<class T>
 class DoubleIterator
 {
-    typedef typename vector<T>::iterator iterator;
+    typedef typename StackedVector<T>::iterator iterator;
 
 public:
     iterator left, right;
@@ -70,6 +70,12 @@ input_error::input_error(const char* name, const string& filename,
     input_file.clear();
     string token;
     input_file >> token;
+    *this = input_error(name, filename, token, input_counter);
+}
+
+input_error::input_error(const char* name, const string& filename,
+        const string& token, size_t input_counter)
+{
     msg += string() + "cannot read " + name + " from " + filename
             + ", problem with '" + token + "' after "
             + to_string(input_counter);
@@ -262,6 +262,8 @@ class input_error : public exception
 public:
     input_error(const char* name, const string& filename,
             istream& input_file, size_t input_counter);
+    input_error(const char* name, const string& filename,
+            const string& token, size_t input_counter);
 
     const char* what() const throw()
     {
@@ -128,6 +128,7 @@ inline void FlexBuffer::operator=(octetStream& os)
 	ptr = (char*)os.get_data() + os.get_ptr();
 	len = os.get_length();
 	max_len = os.get_max_length();
+	MemoryAccounting::remove(MemoryAccounting::COMMUNICATION, max_len);
 	os.reset();
 }
 
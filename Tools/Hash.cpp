@@ -1,6 +1,8 @@
 #include "Hash.h"
 #include "octetStream.h"
 
+#include <thread>
+
 void hash_update(Hash *ctx, const void *data, unsigned long len)
 {
     ctx->update(data, len);
@@ -40,6 +42,42 @@ void Hash::update(const string& str)
     update(str.data(), str.size());
 }
 
+void Hash::update_chunked(const void* dataIn, size_t len, int n_threads)
+{
+    uint64_t length = len;
+    update(&length, sizeof(length));
+
+    if (len < 2 * CHUNK_SIZE)
+        return update(dataIn, len);
+
+    size_t n_chunks = (len + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    vector<unsigned char> digests(n_chunks * hash_length);
+    auto job = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            crypto_generichash(&digests[i * hash_length], hash_length,
+                    (const unsigned char*) dataIn + i * CHUNK_SIZE,
+                    min(CHUNK_SIZE, len - i * CHUNK_SIZE), 0, 0);
+    };
+
+    size_t n_jobs = min(n_chunks, size_t(max(n_threads, 1)));
+    vector<thread> threads;
+    for (size_t i = 1; i < n_jobs; i++)
+        threads.push_back(
+                thread(job, n_chunks * i / n_jobs,
+                        n_chunks * (i + 1) / n_jobs));
+    job(0, n_chunks / n_jobs);
+    for (auto& thread : threads)
+        thread.join();
+
+    update(digests.data(), digests.size());
+}
+
+void Hash::update_chunked(const octetStream& os, int n_threads)
+{
+    update_chunked(os.get_data(), os.get_length(), n_threads);
+}
+
 void Hash::final(octetStream& os)
 {
     os.resize_precise(hash_length);
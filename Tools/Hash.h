@@ -9,8 +9,12 @@ using namespace std;
 
 class Hash
 {
+	static const size_t CHUNK_SIZE = 1 << 20;
+
 	crypto_generichash_state* state;
 
+	octetStream buffer;
+
 public:
 	static const int hash_length = crypto_generichash_BYTES;
 
@@ -36,15 +40,27 @@ public:
 	void update(const vector<T>& v, const vector<int>& bit_lengths)
 	{
 	    assert(v.size() == bit_lengths.size());
-	    octetStream tmp;
+	    // same bytes as packing without copying
+	    if constexpr (flat_packing(static_cast<const T*>(nullptr)))
+	        if (size_t(T::size()) == sizeof(T))
+	            return update(v.data(), v.size() * sizeof(T));
+	    auto& tmp = buffer;
+	    tmp.reset_write_head();
 	    tmp.reserve(v.size() * sizeof(T));
 	    for (size_t i = 0; i < v.size(); i++)
 	        v[i].pack(tmp, bit_lengths[i]);
-	    tmp.append(0);
 	    update(tmp);
 	}
 	void update(const string& str);
 
+	/**
+	 * Length-prefixed update that hashes inputs of at least two chunks
+	 * as chunk digests computed by ``n_threads`` threads, which does
+	 * not depend on the number of threads
+	 */
+	void update_chunked(const void* dataIn, size_t len, int n_threads = 1);
+	void update_chunked(const octetStream& os, int n_threads = 1);
+
 	void final(unsigned char hashout[hash_length])
 	{
 		final(hashout, hash_length);
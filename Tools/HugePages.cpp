@@ -0,0 +1,74 @@
+/*
+ * HugePages.cpp
+ *
+ */
+
+#include "HugePages.h"
+#include "Processor/OnlineOptions.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+
+// same size for allocation and deallocation
+inline size_t mapping_size(size_t byte_size)
+{
+    return (byte_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+// prefer node of current CPU over policy of process
+void bind_to_local_node(void* p, size_t size)
+{
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, 0) or node >= 64)
+        return;
+    unsigned long mask = 1ul << node;
+    syscall(SYS_mbind, p, size, MPOL_PREFERRED, &mask, 64, 0);
+#else
+    (void) p, (void) size;
+#endif
+}
+
+void* huge_page_alloc(size_t byte_size)
+{
+    if (byte_size < HUGE_PAGE_SIZE)
+        return ::operator new(byte_size);
+
+    size_t size = mapping_size(byte_size);
+    auto& mode = OnlineOptions::singleton.huge_pages;
+    void* res = MAP_FAILED;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#ifdef MAP_HUGETLB
+    // fails if no huge pages are reserved
+    if (mode == "explicit")
+        res = mmap(0, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1,
+                0);
+#endif
+
+    if (res == MAP_FAILED)
+    {
+        res = mmap(0, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (res == MAP_FAILED)
+            throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        if (not mode.empty())
+            madvise(res, size, MADV_HUGEPAGE);
+#endif
+    }
+
+    if (not mode.empty())
+        bind_to_local_node(res, size);
+
+    return res;
+}
+
+void huge_page_free(void* p, size_t byte_size)
+{
+    if (byte_size < HUGE_PAGE_SIZE)
+        ::operator delete(p);
+    else
+        munmap(p, mapping_size(byte_size));
+}
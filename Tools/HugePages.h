@@ -0,0 +1,49 @@
+/*
+ * HugePages.h
+ *
+ */
+
+#ifndef TOOLS_HUGEPAGES_H_
+#define TOOLS_HUGEPAGES_H_
+
+#include <cstddef>
+#include <new>
+
+// allocations from this size use separate mappings
+const size_t HUGE_PAGE_SIZE = 1 << 21;
+
+// page-aligned mapping for large sizes, operator new otherwise
+void* huge_page_alloc(size_t byte_size);
+void huge_page_free(void* p, size_t byte_size);
+
+/**
+ * Allocator for large containers that uses huge pages on the NUMA node
+ * of the allocating thread if requested by ``--huge-pages``
+ */
+template<class T>
+class HugePageAllocator
+{
+public:
+    typedef T value_type;
+
+    HugePageAllocator() {}
+    template<class U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        return (T*) huge_page_alloc(n * sizeof(T));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        huge_page_free(p, n * sizeof(T));
+    }
+
+    template<class U>
+    bool operator==(const HugePageAllocator<U>&) const { return true; }
+    template<class U>
+    bool operator!=(const HugePageAllocator<U>&) const { return false; }
+};
+
+#endif /* TOOLS_HUGEPAGES_H_ */
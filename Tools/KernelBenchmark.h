@@ -0,0 +1,67 @@
+/*
+ * KernelBenchmark.h
+ *
+ */
+
+#ifndef TOOLS_KERNELBENCHMARK_H_
+#define TOOLS_KERNELBENCHMARK_H_
+
+#include "Tools/time-func.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+/**
+ * Best time of several runs for variants of a kernel
+ * (e.g., scalar and vectorized) for the kernel benchmarks in ``Utils``
+ */
+class KernelBenchmark
+{
+    vector<double> best;
+
+public:
+    const int n_runs;
+
+    KernelBenchmark(int n_variants, int n_runs = 10) :
+            best(n_variants, 1e9), n_runs(n_runs)
+    {
+    }
+
+    /// Record time of one run of variant ``i``
+    void record(int i, double seconds)
+    {
+        best.at(i) = min(best.at(i), seconds);
+    }
+
+    /// Time one run of variant ``i``
+    template<class T>
+    void measure(int i, const T& f)
+    {
+        Timer timer;
+        timer.start();
+        f();
+        record(i, timer.elapsed());
+    }
+
+    /// Best time of variant ``i`` in seconds
+    double operator[](int i) const
+    {
+        return best.at(i);
+    }
+
+    /// Output ``<label>: <time> <unit> <name>, ...`` with times scaled
+    /// by ``factor``, e.g., ``1e9 / n`` for nanoseconds per item
+    void print(const string& label, const vector<string>& names,
+            double factor, const string& unit = "ns") const
+    {
+        cout << label << ":";
+        for (size_t i = 0; i < best.size(); i++)
+            cout << (i ? ", " : " ") << best[i] * factor << " " << unit << " "
+                    << names.at(i);
+        cout << endl;
+    }
+};
+
+#endif /* TOOLS_KERNELBENCHMARK_H_ */
@@ -20,6 +20,9 @@ class MMO
 
     octet IV[N_KEYS][176]  __attribute__((aligned (16)));
 
+    // blocks in flight when hashing many
+    static const int BATCH = 16;
+
     template<int N>
     static void encrypt_and_xor(__m128i* output, const __m128i* input,
             const octet* key);
@@ -50,6 +53,8 @@ public:
     void hashEightBlocks(gfpvar_<X, L>* output, const void* input);
     template <class T>
     void outputOneBlock(octet* output);
+    void hashBlocks(__m128i* output, const __m128i* input, size_t n,
+            __m128i offset = _mm_setzero_si128());
     Key hash(const Key& input);
     template <int N>
     void hash(Key* output, const Key* input);
@@ -58,7 +63,7 @@ public:
 template<int N>
 inline void MMO::encrypt_and_xor(__m128i* out, const __m128i* in, const octet* key)
 {
-    ecb_aes_128_encrypt<N>(out, in, key);
+    wide_ecb_aes_128_encrypt<N>(out, in, key);
     for (int i = 0; i < N; i++)
         out[i] = _mm_xor_si128(out[i], in[i]);
 }
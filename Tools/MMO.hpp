@@ -30,6 +30,32 @@ void MMO::setIV(int i, octet key[AES_BLK_SIZE])
 }
 
 
+/*
+ * Hash n blocks XORed with offset using the first key, which
+ * might be in place.
+ */
+inline
+void MMO::hashBlocks(__m128i* output, const __m128i* input, size_t n,
+        __m128i offset)
+{
+    __m128i in[BATCH], out[BATCH];
+    size_t i = 0;
+    for (; i + BATCH <= n; i += BATCH)
+    {
+        for (int j = 0; j < BATCH; j++)
+            in[j] = _mm_loadu_si128(input + i + j) ^ offset;
+        wide_ecb_aes_128_encrypt<BATCH>(out, in, IV[0]);
+        for (int j = 0; j < BATCH; j++)
+            _mm_storeu_si128(output + i + j, out[j] ^ in[j]);
+    }
+    for (; i < n; i++)
+    {
+        in[0] = _mm_loadu_si128(input + i) ^ offset;
+        encrypt_and_xor<1>(out, in, IV[0]);
+        _mm_storeu_si128(output + i, out[0]);
+    }
+}
+
 template<int N>
 void MMO::encrypt_and_xor(void* output, const void* input, const octet* key,
         const int* indices)
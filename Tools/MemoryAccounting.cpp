@@ -0,0 +1,33 @@
+/*
+ * MemoryAccounting.cpp
+ *
+ */
+
+#include "MemoryAccounting.h"
+
+thread_local MemoryAccounting::Counters MemoryAccounting::counters;
+
+const char* MemoryAccounting::names[N_SUBSYSTEMS] = { "registers", "memory",
+        "preprocessing", "communication" };
+
+bool MemoryAccounting::Counters::empty() const
+{
+    for (int i = 0; i < N_SUBSYSTEMS; i++)
+        if (peak[i])
+            return false;
+    return true;
+}
+
+void MemoryAccounting::Counters::print(ostream& os) const
+{
+    for (int i = 0; i < N_SUBSYSTEMS; i++)
+        os << (i ? ", " : "") << names[i] << " " << peak[i] * 1e-6 << " MB";
+}
+
+void MemoryAccounting::Counters::print_json(ostream& os) const
+{
+    os << "{";
+    for (int i = 0; i < N_SUBSYSTEMS; i++)
+        os << (i ? ", " : "") << "\"" << names[i] << "\": " << peak[i];
+    os << "}";
+}
@@ -0,0 +1,131 @@
+/*
+ * MemoryAccounting.h
+ *
+ */
+
+#ifndef TOOLS_MEMORYACCOUNTING_H_
+#define TOOLS_MEMORYACCOUNTING_H_
+
+#include <cstddef>
+#include <memory>
+#include <iostream>
+using namespace std;
+
+/**
+ * Current and peak bytes allocated per subsystem and thread. Changes
+ * are attributed to the thread that allocates or frees, so moving
+ * buffers between threads can shift usage. Allocation only costs an
+ * addition and comparison in thread-local storage.
+ */
+class MemoryAccounting
+{
+public:
+    enum Subsystem
+    {
+        REGISTERS,
+        MEMORY,
+        PREPROCESSING,
+        COMMUNICATION,
+        N_SUBSYSTEMS
+    };
+
+    static const char* names[N_SUBSYSTEMS];
+
+    struct Counters
+    {
+        long long current[N_SUBSYSTEMS];
+        long long peak[N_SUBSYSTEMS];
+
+        bool empty() const;
+        void print(ostream& os) const;
+        void print_json(ostream& os) const;
+    };
+
+    /// Size held by an object that changes size as a whole
+    class Account
+    {
+        Subsystem subsystem;
+        size_t size;
+
+    public:
+        Account(Subsystem subsystem) : subsystem(subsystem), size(0) {}
+        Account(const Account& other) : Account(other.subsystem) {}
+        ~Account() { set(0); }
+
+        Account& operator=(const Account&) { return *this; }
+
+        void set(size_t new_size)
+        {
+            remove(subsystem, size);
+            add(subsystem, new_size);
+            size = new_size;
+        }
+    };
+
+    static void add(Subsystem subsystem, size_t size)
+    {
+        auto& current = counters.current[subsystem];
+        current += size;
+        if (current > counters.peak[subsystem])
+            counters.peak[subsystem] = current;
+    }
+
+    static void remove(Subsystem subsystem, size_t size)
+    {
+        counters.current[subsystem] -= size;
+    }
+
+    /// Counters of the calling thread
+    static const Counters& get() { return counters; }
+
+private:
+    static thread_local Counters counters;
+};
+
+/**
+ * Allocator that accounts for its allocations in a subsystem
+ */
+template<class T, MemoryAccounting::Subsystem SUBSYSTEM,
+        class A = allocator<T>>
+class AccountingAllocator : public A
+{
+public:
+    typedef T value_type;
+
+    template<class U>
+    struct rebind
+    {
+        typedef AccountingAllocator<U, SUBSYSTEM,
+                typename allocator_traits<A>::template rebind_alloc<U>> other;
+    };
+
+    AccountingAllocator() {}
+    template<class U, class B>
+    AccountingAllocator(const AccountingAllocator<U, SUBSYSTEM, B>&) {}
+
+    T* allocate(size_t n)
+    {
+        T* res = A::allocate(n);
+        MemoryAccounting::add(SUBSYSTEM, n * sizeof(T));
+        return res;
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        MemoryAccounting::remove(SUBSYSTEM, n * sizeof(T));
+        A::deallocate(p, n);
+    }
+
+    template<class U, class B>
+    bool operator==(const AccountingAllocator<U, SUBSYSTEM, B>&) const
+    {
+        return true;
+    }
+    template<class U, class B>
+    bool operator!=(const AccountingAllocator<U, SUBSYSTEM, B>&) const
+    {
+        return false;
+    }
+};
+
+#endif /* TOOLS_MEMORYACCOUNTING_H_ */
@@ -32,3 +32,17 @@ void NamedStats::print()
         }
     }
 }
+
+void NamedStats::print_json(ostream& os) const
+{
+    os << "{";
+    bool first = true;
+    for (auto x : *this)
+    {
+        if (not first)
+            os << ", ";
+        first = false;
+        os << "\"" << x.first << "\": " << x.second;
+    }
+    os << "}";
+}
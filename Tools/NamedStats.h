@@ -8,6 +8,7 @@
 
 #include <map>
 #include <string>
+#include <iostream>
 
 using namespace std;
 
@@ -17,6 +18,7 @@ public:
     NamedStats& operator+=(const NamedStats& other);
 
     void print();
+    void print_json(ostream& os) const;
 };
 
 #endif /* TOOLS_NAMEDSTATS_H_ */
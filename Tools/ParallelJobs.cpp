@@ -0,0 +1,13 @@
+/*
+ * ParallelJobs.cpp
+ *
+ */
+
+#include "ParallelJobs.h"
+#include "Processor/OnlineOptions.h"
+
+int ParallelJobs::n_threads(const std::string& option)
+{
+    return std::max(1,
+            stoi(OnlineOptions::singleton.option_value(option, "1")));
+}
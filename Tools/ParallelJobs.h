@@ -0,0 +1,51 @@
+/*
+ * ParallelJobs.h
+ *
+ */
+
+#ifndef TOOLS_PARALLELJOBS_H_
+#define TOOLS_PARALLELJOBS_H_
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Local computation on contiguous ranges in several threads,
+ * e.g., the local part of sacrifices and shuffles
+ */
+class ParallelJobs
+{
+public:
+    /// Number of threads given by ``-o <option>=<n>`` (at least one)
+    static int n_threads(const std::string& option);
+
+    /**
+     * Call ``job(k, begin, end)`` on consecutive ranges covering
+     * ``[0, n)`` with thread ``k`` out of at most ``n_threads``
+     * @param n number of items
+     * @param n_threads maximum number of threads including the caller
+     * @param job function of the job number and range
+     * @param min_per_job minimum number of items to use another thread
+     * @returns number of jobs
+     */
+    template<class U>
+    static int run(size_t n, int n_threads, const U& job,
+            size_t min_per_job)
+    {
+        // not worth the overhead for small batches
+        int n_jobs = std::min(size_t(std::max(n_threads, 1)),
+                std::max(n / std::max(min_per_job, size_t(1)), size_t(1)));
+        std::vector<std::thread> threads;
+        for (int k = 1; k < n_jobs; k++)
+            threads.push_back(
+                    std::thread(job, k, n * k / n_jobs, n * (k + 1) / n_jobs));
+        job(0, size_t(0), n / n_jobs);
+        for (auto& thread : threads)
+            thread.join();
+        return n_jobs;
+    }
+};
+
+#endif /* TOOLS_PARALLELJOBS_H_ */
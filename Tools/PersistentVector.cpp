@@ -0,0 +1,263 @@
+/*
+ * PersistentVector.cpp
+ *
+ */
+
+#include "PersistentVector.h"
+#include "Processor/OnlineOptions.h"
+#include "Tools/int.h"
+#include "Tools/Exceptions.h"
+
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+
+struct Header
+{
+    char magic[16];
+    uint64_t element_size;
+    uint64_t byte_size;
+    uint64_t complete;
+    char type_string[64];
+};
+
+const char magic[16] = "MP-SPDZ memory";
+
+// vectors to check on write faults
+const int MAX_VECTORS = 16;
+atomic<PersistentVectorBase*> vectors[MAX_VECTORS];
+struct sigaction previous_action;
+once_flag handler_flag;
+
+void write_fault_handler(int signal, siginfo_t* info, void* context)
+{
+    for (auto& vector : vectors)
+    {
+        auto v = vector.load();
+        if (v and v->track_write(info->si_addr))
+            return;
+    }
+
+    // not ours, fault again with previous handler
+    (void) signal, (void) context;
+    sigaction(SIGSEGV, &previous_action, 0);
+}
+
+void install_handler()
+{
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = write_fault_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, &previous_action);
+}
+
+}
+
+bool PersistentVectorBase::enabled()
+{
+    auto& opts = OnlineOptions::singleton;
+    return opts.has_option("persistent_memory")
+            or not opts.option_value("persistent_memory").empty();
+}
+
+double PersistentVectorBase::interval()
+{
+    return stod(
+            OnlineOptions::singleton.option_value("persistent_memory", "60"));
+}
+
+PersistentVectorBase::PersistentVectorBase(const string& type_string,
+        size_t element_size) :
+        type_string(type_string), element_size(element_size), fd(-1),
+        n_written(0), mapped_size(0), mapped(0), byte_size(0)
+{
+}
+
+PersistentVectorBase::~PersistentVectorBase()
+{
+    for (auto& vector : vectors)
+    {
+        PersistentVectorBase* expected = this;
+        vector.compare_exchange_strong(expected, 0);
+    }
+    unmap();
+    if (fd >= 0)
+        close(fd);
+}
+
+void PersistentVectorBase::open(const string& filename, bool resume)
+{
+    if (is_open())
+        throw runtime_error("persistent memory already open");
+
+    this->filename = filename;
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0)
+        throw runtime_error("cannot open " + filename + ": " + strerror(errno));
+
+    struct stat buf;
+    if (resume and fstat(fd, &buf) == 0 and size_t(buf.st_size) >= CHUNK_SIZE)
+    {
+        Header header;
+        if (pread(fd, &header, sizeof(header), 0) != sizeof(header)
+                or memcmp(header.magic, magic, sizeof(magic)))
+            throw runtime_error(filename + " is not a memory file");
+        if (header.element_size != element_size
+                or type_string.compare(0, sizeof(header.type_string) - 1,
+                        header.type_string) != 0)
+            throw runtime_error(
+                    filename + " contains " + header.type_string
+                            + " instead of " + type_string);
+        if (not header.complete)
+            throw runtime_error(
+                    "incomplete checkpoint in " + filename
+                            + ", run with '-m empty'");
+        byte_size = header.byte_size;
+    }
+    else
+    {
+        if (ftruncate(fd, CHUNK_SIZE))
+            throw runtime_error(
+                    "cannot truncate " + filename + ": " + strerror(errno));
+        byte_size = 0;
+        write_header(true);
+    }
+
+    map();
+
+    call_once(handler_flag, install_handler);
+    for (auto& vector : vectors)
+    {
+        PersistentVectorBase* expected = 0;
+        if (vector.compare_exchange_strong(expected, this))
+            return;
+    }
+    throw runtime_error("too many persistent memories");
+}
+
+void PersistentVectorBase::write_header(bool complete)
+{
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.element_size = element_size;
+    header.byte_size = byte_size;
+    header.complete = complete;
+    strncpy(header.type_string, type_string.c_str(),
+            sizeof(header.type_string) - 1);
+    if (pwrite(fd, &header, sizeof(header), 0) != sizeof(header))
+        throw runtime_error(
+                "cannot write header to " + filename + ": " + strerror(errno));
+    sync();
+}
+
+void PersistentVectorBase::sync()
+{
+    if (fsync(fd))
+        throw runtime_error("cannot sync " + filename + ": " + strerror(errno));
+}
+
+void PersistentVectorBase::map()
+{
+    mapped_size = multiple_minimum(byte_size, CHUNK_SIZE);
+    dirty.assign(mapped_size / CHUNK_SIZE, 0);
+    if (mapped_size == 0)
+        return;
+
+    // read-only until the first write to every chunk
+    void* res = mmap(0, mapped_size, PROT_READ, MAP_PRIVATE, fd, CHUNK_SIZE);
+    if (res == MAP_FAILED)
+        throw runtime_error("cannot map " + filename + ": " + strerror(errno));
+    mapped = (char*) res;
+}
+
+void PersistentVectorBase::unmap()
+{
+    if (mapped)
+        munmap(mapped, mapped_size);
+    mapped = 0;
+    mapped_size = 0;
+    dirty.clear();
+}
+
+bool PersistentVectorBase::track_write(void* address)
+{
+    char* p = (char*) address;
+    if (p < mapped or p >= mapped + mapped_size)
+        return false;
+
+    size_t chunk = (p - mapped) / CHUNK_SIZE;
+    dirty[chunk] = 1;
+    return mprotect(mapped + chunk * CHUNK_SIZE, CHUNK_SIZE,
+            PROT_READ | PROT_WRITE) == 0;
+}
+
+void PersistentVectorBase::resize_bytes(size_t new_byte_size)
+{
+    if (not is_open())
+        throw runtime_error("persistent memory not opened");
+
+    if (new_byte_size == byte_size)
+        return;
+
+    // private changes would be lost otherwise
+    checkpoint();
+    unmap();
+
+    if (ftruncate(fd, CHUNK_SIZE + multiple_minimum(new_byte_size, CHUNK_SIZE)))
+        throw insufficient_memory(new_byte_size, type_string + " on disk");
+
+    byte_size = new_byte_size;
+    write_header(true);
+    map();
+}
+
+void PersistentVectorBase::checkpoint()
+{
+    vector<size_t> chunks;
+    for (size_t i = 0; i < dirty.size(); i++)
+        if (dirty[i])
+            chunks.push_back(i);
+
+    if (chunks.empty())
+        return;
+
+    write_header(false);
+
+    for (auto chunk : chunks)
+    {
+        size_t offset = chunk * CHUNK_SIZE;
+        size_t length = min(CHUNK_SIZE, byte_size - offset);
+        if (pwrite(fd, mapped + offset, length, CHUNK_SIZE + offset)
+                != ssize_t(length))
+            throw runtime_error(
+                    "cannot write checkpoint to " + filename + ": "
+                            + strerror(errno));
+        n_written += length;
+    }
+
+    sync();
+    write_header(true);
+
+    for (auto chunk : chunks)
+    {
+        auto start = mapped + chunk * CHUNK_SIZE;
+        mprotect(start, CHUNK_SIZE, PROT_READ);
+#ifdef __linux__
+        // replace private copy by file content
+        madvise(start, CHUNK_SIZE, MADV_DONTNEED);
+#endif
+        dirty[chunk] = 0;
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * PersistentVector.h
+ *
+ */
+
+#ifndef TOOLS_PERSISTENTVECTOR_H_
+#define TOOLS_PERSISTENTVECTOR_H_
+
+#include <string>
+#include <vector>
+#include <assert.h>
+using namespace std;
+
+/**
+ * Memory-mapped vector that keeps its content in a file between runs.
+ * The mapping is private, so the file only changes in checkpoints.
+ * Writes are tracked per chunk by write-protecting the mapping, and a
+ * checkpoint only writes the chunks changed since the last one.
+ */
+class PersistentVectorBase
+{
+public:
+    // also the size of the header
+    static const size_t CHUNK_SIZE = 1 << 16;
+
+    /// Whether to use persistent memory (``-o persistent_memory``)
+    static bool enabled();
+    /// Seconds between checkpoints
+    static double interval();
+
+private:
+    string filename;
+    string type_string;
+    size_t element_size;
+    int fd;
+
+    vector<char> dirty;
+    size_t n_written;
+    size_t mapped_size;
+
+    void write_header(bool complete);
+    void sync();
+    void map();
+    void unmap();
+
+protected:
+    char* mapped;
+    size_t byte_size;
+
+    void resize_bytes(size_t new_byte_size);
+
+public:
+    PersistentVectorBase(const string& type_string, size_t element_size);
+    PersistentVectorBase(const PersistentVectorBase&) = delete;
+    ~PersistentVectorBase();
+
+    /// Map ``filename``, keeping existing content if ``resume``
+    void open(const string& filename, bool resume);
+    bool is_open() const { return fd >= 0; }
+
+    /// Write changed chunks to the file
+    void checkpoint();
+
+    /// Bytes written in checkpoints so far
+    size_t written() const { return n_written; }
+
+    // called on write faults, returns false for other addresses
+    bool track_write(void* address);
+};
+
+template<class T>
+class PersistentVector : public PersistentVectorBase
+{
+public:
+    PersistentVector() :
+            PersistentVectorBase(T::type_string(), sizeof(T))
+    {
+    }
+
+    size_t size() const
+    {
+        return byte_size / sizeof(T);
+    }
+
+    void resize(size_t new_size)
+    {
+        resize_bytes(new_size * sizeof(T));
+    }
+
+    T* data()
+    {
+        return (T*) mapped;
+    }
+
+    const T* data() const
+    {
+        return (T*) mapped;
+    }
+
+    T& operator[](size_t index)
+    {
+        return data()[index];
+    }
+
+    const T& operator[](size_t index) const
+    {
+        return data()[index];
+    }
+
+    T& at(size_t index)
+    {
+        assert(index < size());
+        return data()[index];
+    }
+
+    const T& at(size_t index) const
+    {
+        assert(index < size());
+        return data()[index];
+    }
+};
+
+#endif /* TOOLS_PERSISTENTVECTOR_H_ */
@@ -0,0 +1,226 @@
+/*
+ * SharedMemoryRing.cpp
+ *
+ */
+
+#include "SharedMemoryRing.h"
+#include "Tools/octetStream.h"
+#include "Tools/Exceptions.h"
+
+#include <sys/mman.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+
+class Backoff
+{
+    long wait;
+
+public:
+    Backoff() : wait(1) {}
+
+    void operator()()
+    {
+        usleep(wait);
+        wait = min(2 * wait, 1000l);
+    }
+};
+
+}
+
+string SharedMemoryRing::shm_name(const string& filename)
+{
+    string res = "/mp-spdz-";
+    for (char c : filename)
+        res += c == '/' ? '_' : c;
+    return res;
+}
+
+SharedMemoryRing::SharedMemoryRing() :
+        header(0), buffer(0), mapped_size(0), writer(false)
+{
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    close();
+}
+
+void SharedMemoryRing::map(int fd, size_t size)
+{
+    void* res = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (res == MAP_FAILED)
+        throw runtime_error("cannot map " + name + ": " + strerror(errno));
+    header = (Header*) res;
+    buffer = (octet*) res + sizeof(Header);
+    mapped_size = size;
+}
+
+void SharedMemoryRing::create(const string& filename, size_t capacity)
+{
+    assert(not is_open());
+    name = shm_name(filename);
+    writer = true;
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        throw runtime_error("cannot create " + name + ": " + strerror(errno));
+    size_t size = sizeof(Header) + capacity;
+    if (ftruncate(fd, size))
+        throw runtime_error("cannot allocate " + to_string(size) + " bytes for "
+                + name + ": " + strerror(errno));
+    map(fd, size);
+    header->head = 0;
+    header->tail = 0;
+    header->closed = false;
+    header->capacity = capacity;
+    header->owner = getpid();
+    header->magic.store(Header::MAGIC, memory_order_release);
+}
+
+int SharedMemoryRing::open(struct stat& st)
+{
+    Backoff backoff;
+    while (true)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd >= 0 and fstat(fd, &st) == 0 and st.st_size > (off_t) sizeof(Header))
+            return fd;
+        if (fd >= 0)
+            ::close(fd);
+        else if (errno != ENOENT)
+            throw runtime_error("cannot open " + name + ": " + strerror(errno));
+        backoff();
+    }
+}
+
+bool SharedMemoryRing::is_current()
+{
+    if (header->magic.load(memory_order_acquire) != Header::MAGIC
+            or sizeof(Header) + header->capacity != mapped_size)
+        return false;
+    // a finished writer is fine but not one that stopped halfway
+    return header->closed.load(memory_order_acquire)
+            or kill(header->owner, 0) == 0 or errno != ESRCH;
+}
+
+bool SharedMemoryRing::is_replaced(const struct stat& st)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0600);
+    if (fd < 0)
+        return true;
+    struct stat current;
+    bool res = fstat(fd, &current) != 0 or current.st_ino != st.st_ino
+            or current.st_dev != st.st_dev;
+    ::close(fd);
+    return res;
+}
+
+void SharedMemoryRing::attach(const string& filename)
+{
+    assert(not is_open());
+    name = shm_name(filename);
+    writer = false;
+    while (true)
+    {
+        struct stat st;
+        map(open(st), st.st_size);
+        Backoff backoff;
+        // wait for initialization or for the writer to replace the segment
+        while (not is_current() and not is_replaced(st))
+            backoff();
+        if (is_current())
+            break;
+        munmap(header, mapped_size);
+        header = 0;
+        buffer = 0;
+    }
+    // both sides are mapped, no need to keep the name
+    shm_unlink(name.c_str());
+}
+
+void SharedMemoryRing::close()
+{
+    if (not is_open())
+        return;
+    if (writer)
+        header->closed.store(true, memory_order_release);
+    munmap(header, mapped_size);
+    header = 0;
+    buffer = 0;
+}
+
+void SharedMemoryRing::write(const octet* data, size_t length)
+{
+    auto capacity = header->capacity;
+    uint64_t head = header->head.load(memory_order_relaxed);
+    Backoff backoff;
+    while (length)
+    {
+        uint64_t tail = header->tail.load(memory_order_acquire);
+        size_t space = capacity - (head - tail);
+        if (space == 0)
+        {
+            backoff();
+            continue;
+        }
+        size_t pos = head % capacity;
+        size_t chunk = min(min(length, space), capacity - pos);
+        memcpy(buffer + pos, data, chunk);
+        head += chunk;
+        data += chunk;
+        length -= chunk;
+        header->head.store(head, memory_order_release);
+    }
+}
+
+void SharedMemoryRing::read(octet* data, size_t length)
+{
+    auto capacity = header->capacity;
+    uint64_t tail = header->tail.load(memory_order_relaxed);
+    Backoff backoff;
+    while (length)
+    {
+        uint64_t head = header->head.load(memory_order_acquire);
+        size_t available = head - tail;
+        if (available == 0)
+        {
+            if (header->closed.load(memory_order_acquire)
+                    and header->head.load(memory_order_acquire) == tail)
+                throw IO_Error("not enough data in " + name);
+            backoff();
+            continue;
+        }
+        size_t pos = tail % capacity;
+        size_t chunk = min(min(length, available), capacity - pos);
+        memcpy(data, buffer + pos, chunk);
+        tail += chunk;
+        data += chunk;
+        length -= chunk;
+        header->tail.store(tail, memory_order_release);
+    }
+}
+
+void SharedMemoryRing::write(const octetStream& os)
+{
+    assert(writer);
+    uint64_t length = os.get_length();
+    write((octet*) &length, sizeof(length));
+    write(os.get_data(), length);
+}
+
+void SharedMemoryRing::read(octetStream& os)
+{
+    assert(not writer);
+    uint64_t length;
+    read((octet*) &length, sizeof(length));
+    os.reset_write_head();
+    read(os.append(length), length);
+    os.reset_read_head();
+}
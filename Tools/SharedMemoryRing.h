@@ -0,0 +1,85 @@
+/*
+ * SharedMemoryRing.h
+ *
+ */
+
+#ifndef TOOLS_SHAREDMEMORYRING_H_
+#define TOOLS_SHAREDMEMORYRING_H_
+
+#include <string>
+#include <atomic>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include "Tools/int.h"
+
+class octetStream;
+
+#ifndef SHM_RING_SIZE
+#define SHM_RING_SIZE (1 << 24)
+#endif
+
+/**
+ * Single-producer/single-consumer ring buffer in POSIX shared memory
+ * for streaming length-prefixed messages between two processes on the
+ * same host. The writer creates the segment, the reader attaches to it.
+ * A segment left by a crashed writer is ignored until replaced, which
+ * requires both processes to see the same process IDs.
+ */
+class SharedMemoryRing
+{
+    struct Header
+    {
+        static const uint64_t MAGIC = 0x53505a44524e4731;
+
+        std::atomic<uint64_t> magic;
+        std::atomic<uint64_t> head;
+        char head_padding[64 - sizeof(uint64_t)];
+        std::atomic<uint64_t> tail;
+        char tail_padding[64 - sizeof(uint64_t)];
+        std::atomic<bool> closed;
+        uint64_t capacity;
+        // process ID of the writer
+        int64_t owner;
+    };
+
+    std::string name;
+    Header* header;
+    octet* buffer;
+    size_t mapped_size;
+    bool writer;
+
+    void map(int fd, size_t size);
+
+    int open(struct stat& st);
+    bool is_current();
+    bool is_replaced(const struct stat& st);
+
+    void write(const octet* data, size_t length);
+    void read(octet* data, size_t length);
+
+public:
+    static std::string shm_name(const std::string& filename);
+
+    SharedMemoryRing();
+    ~SharedMemoryRing();
+
+    bool is_open() const
+    {
+        return header;
+    }
+
+    /// Create segment for writing, replacing any stale one
+    void create(const std::string& filename, size_t capacity = SHM_RING_SIZE);
+    /// Wait for writer and attach
+    void attach(const std::string& filename);
+    /// Signal end of stream if writing and unmap
+    void close();
+
+    /// Append message, blocking while the ring is full
+    void write(const octetStream& os);
+    /// Read next message, blocking until complete
+    void read(octetStream& os);
+};
+
+#endif /* TOOLS_SHAREDMEMORYRING_H_ */
@@ -0,0 +1,75 @@
+/*
+ * SpinWaitQueue.h
+ *
+ */
+
+#ifndef TOOLS_SPINWAITQUEUE_H_
+#define TOOLS_SPINWAITQUEUE_H_
+
+#include "intrinsics.h"
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+using namespace std;
+
+/**
+ * Queue for handing over jobs between threads with low latency.
+ * Waiting spins for a while before sleeping, and pushing only wakes up
+ * sleeping threads, so small jobs avoid the kernel altogether.
+ */
+template<class T>
+class SpinWaitQueue
+{
+    // about 100 microseconds
+    static const int N_SPINS = 1 << 14;
+
+    mutex lock;
+    condition_variable cond;
+    deque<T> queue;
+    atomic<size_t> size;
+    int n_sleeping;
+
+public:
+    SpinWaitQueue() :
+            size(0), n_sleeping(0)
+    {
+    }
+
+    SpinWaitQueue(const SpinWaitQueue&) = delete;
+
+    void push(const T& value)
+    {
+        unique_lock<mutex> _(lock);
+        queue.push_back(value);
+        size++;
+        if (n_sleeping)
+            cond.notify_one();
+    }
+
+    T pop()
+    {
+        // yield regularly in case the other thread shares the core
+        for (int i = 0; i < N_SPINS and size == 0; i++)
+            if (i % 64 == 63)
+                this_thread::yield();
+            else
+                _mm_pause();
+
+        unique_lock<mutex> guard(lock);
+        while (queue.empty())
+        {
+            n_sleeping++;
+            cond.wait(guard);
+            n_sleeping--;
+        }
+        T res = queue.front();
+        queue.pop_front();
+        size--;
+        return res;
+    }
+};
+
+#endif /* TOOLS_SPINWAITQUEUE_H_ */
@@ -81,6 +81,12 @@ string TimerWithComm::full()
     return tmp.str();
 }
 
+void TimerWithComm::print_json(ostream& os) const
+{
+    os << "{\"seconds\": " << elapsed() << ", \"bytes\": "
+            << total_stats.sent << ", \"rounds\": " << rounds() << "}";
+}
+
 ostream& operator<<(ostream& os, const TimerWithComm& stats)
 {
     os << stats.mb_sent() << " MB, " << stats.rounds() << " rounds";
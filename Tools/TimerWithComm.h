@@ -30,6 +30,7 @@ public:
     TimerWithComm& operator-=(const TimerWithComm& other);
 
     string full();
+    void print_json(ostream& os) const;
 
     friend ostream& operator<<(ostream& os, const TimerWithComm& stats);
 };
@@ -79,7 +79,7 @@ public:
 
     T pop()
     {
-        T res;
+        T res = {};
         assert(pop(res));
         return res;
     }
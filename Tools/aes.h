@@ -104,6 +104,35 @@ inline void ecb_aes_128_encrypt(__m128i* out, const __m128i* in, const octet* ke
         software_ecb_aes_128_encrypt<N>(out, in, (uint*) key);
 }
 
+// four blocks per instruction if available
+template <int N>
+inline void wide_ecb_aes_128_encrypt(__m128i* out, const __m128i* in, const octet* key)
+{
+#if defined(__VAES__) && defined(__AVX512F__)
+    if (N % 4 == 0 and cpu_has_vaes() and cpu_has_avx512())
+    {
+        const int M = N / 4;
+        __m512i tmp[M];
+        __m512i round_key = _mm512_broadcast_i32x4(((__m128i*)key)[0]);
+        for (int i = 0; i < M; i++)
+            tmp[i] = _mm512_loadu_si512(in + 4 * i) ^ round_key;
+        int j;
+        for (j = 1; j < 10; j++)
+        {
+            round_key = _mm512_broadcast_i32x4(((__m128i*)key)[j]);
+            for (int i = 0; i < M; i++)
+                tmp[i] = _mm512_aesenc_epi128(tmp[i], round_key);
+        }
+        round_key = _mm512_broadcast_i32x4(((__m128i*)key)[j]);
+        for (int i = 0; i < M; i++)
+            _mm512_storeu_si512(out + 4 * i,
+                    _mm512_aesenclast_epi128(tmp[i], round_key));
+        return;
+    }
+#endif
+    ecb_aes_128_encrypt<N>(out, in, key);
+}
+
 template <int N>
 inline void ecb_aes_128_encrypt(__m128i* out, const __m128i* in, const octet* key, const int* indices)
 {
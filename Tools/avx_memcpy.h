@@ -79,4 +79,32 @@ inline void avx_memzero(void* dest, size_t length)
 	}
 }
 
+// bitwise XOR of buffers, which may overlap exactly
+inline void avx_xor(void* dest, const void* x, const void* y, size_t length)
+{
+	char* d = (char*)dest;
+	const char* a = (const char*)x, *b = (const char*)y;
+#ifdef __AVX512F__
+	for (; length >= 64; length -= 64, d += 64, a += 64, b += 64)
+		_mm512_storeu_si512(d, _mm512_xor_si512(_mm512_loadu_si512(a),
+				_mm512_loadu_si512(b)));
+#endif
+#ifdef __AVX2__
+	for (; length >= 32; length -= 32, d += 32, a += 32, b += 32)
+		_mm256_storeu_si256((__m256i*)d,
+				_mm256_xor_si256(_mm256_loadu_si256((__m256i*)a),
+						_mm256_loadu_si256((__m256i*)b)));
+#endif
+	for (; length >= 8; length -= 8, d += 8, a += 8, b += 8)
+	{
+		int64_t tmp[2];
+		memcpy(tmp, a, 8);
+		memcpy(tmp + 1, b, 8);
+		tmp[0] ^= tmp[1];
+		memcpy(d, tmp, 8);
+	}
+	for (size_t i = 0; i < length; i++)
+		d[i] = a[i] ^ b[i];
+}
+
 #endif /* TOOLS_AVX_MEMCPY_H_ */
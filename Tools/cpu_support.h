@@ -48,6 +48,66 @@ inline bool cpu_has_avx2()
 #endif
 }
 
+// foundation and doubleword/quadword instructions
+inline bool cpu_has_avx512()
+{
+#ifdef CHECK_AVX512
+    return check_cpu(7, false, 16) and check_cpu(7, false, 17);
+#else
+    return true;
+#endif
+}
+
+// byte permutations
+inline bool cpu_has_avx512vbmi()
+{
+#ifdef CHECK_AVX512
+    return check_cpu(7, true, 1);
+#else
+    return true;
+#endif
+}
+
+// 52-bit integer multiplication
+inline bool cpu_has_avx512ifma()
+{
+#ifdef CHECK_AVX512
+    return check_cpu(7, false, 21);
+#else
+    return true;
+#endif
+}
+
+// Galois field instructions
+inline bool cpu_has_gfni()
+{
+#ifdef CHECK_GFNI
+    return check_cpu(7, true, 8);
+#else
+    return true;
+#endif
+}
+
+// carryless multiplication on 256 and 512 bits
+inline bool cpu_has_vpclmul()
+{
+#ifdef CHECK_VPCLMUL
+    return check_cpu(7, true, 10);
+#else
+    return true;
+#endif
+}
+
+// AES on 256 and 512 bits
+inline bool cpu_has_vaes()
+{
+#ifdef CHECK_VAES
+    return check_cpu(7, true, 9);
+#else
+    return true;
+#endif
+}
+
 inline bool cpu_has_avx(bool force = false)
 {
     (void) force;
@@ -26,7 +26,10 @@ void octetStream::reset()
 void octetStream::clear()
 {
     if (data)
+      {
+        free_accounted();
         delete[] data;
+      }
     reset();
 }
 
@@ -36,9 +39,13 @@ void octetStream::assign(const octetStream& os)
   if (os.get_length() >= get_max_length())
     {
       if (data)
-        delete[] data;
+        {
+          free_accounted();
+          delete[] data;
+        }
       data=new octet[os.get_max_length()];
       set_max_length(os.get_max_length());
+      MemoryAccounting::add(MemoryAccounting::COMMUNICATION, get_max_length());
     }
   set_length(os.get_length());
   memcpy(data,os.data,get_length()*sizeof(octet));
@@ -46,6 +53,15 @@ void octetStream::assign(const octetStream& os)
   bits = os.bits;
 }
 
+void octetStream::swap(octetStream& other)
+{
+  std::swap(ptr, other.ptr);
+  std::swap(end, other.end);
+  std::swap(data, other.data);
+  std::swap(data_end, other.data_end);
+  std::swap(bits, other.bits);
+}
+
 
 octetStream::octetStream(size_t maxlen)
 {
@@ -53,6 +69,7 @@ octetStream::octetStream(size_t maxlen)
   ptr=data;
   set_length(0);
   set_max_length(maxlen);
+  MemoryAccounting::add(MemoryAccounting::COMMUNICATION, maxlen);
 }
 
 octetStream::octetStream(size_t len, const octet* source) :
@@ -71,6 +88,7 @@ octetStream::octetStream(const octetStream& os)
   data=new octet[os.get_max_length()];
   set_length(os.get_length());
   set_max_length(os.get_max_length());
+  MemoryAccounting::add(MemoryAccounting::COMMUNICATION, get_max_length());
   memcpy(data,os.data,get_length()*sizeof(octet));
   ptr = data + os.get_ptr();
   bits = os.bits;
@@ -81,6 +99,7 @@ octetStream::octetStream(FlexBuffer& buffer)
   data = (octet*)buffer.data();
   set_length(buffer.size());
   set_max_length(buffer.capacity());
+  MemoryAccounting::add(MemoryAccounting::COMMUNICATION, get_max_length());
   ptr = (octet*)buffer.ptr;
   buffer.reset();
 }
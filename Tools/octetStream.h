@@ -20,10 +20,12 @@
 #include "Networking/data.h"
 #include "Networking/sockets.h"
 #include "Tools/avx_memcpy.h"
+#include "Tools/MemoryAccounting.h"
 
 #include <string.h>
 #include <vector>
 #include <array>
+#include <type_traits>
 #include <stdio.h>
 #include <iostream>
 #include <assert.h>
@@ -35,6 +37,13 @@ using namespace std;
 class bigint;
 class FlexBuffer;
 
+// whether pack() copies the memory representation of size() bytes
+// irrespective of the bit length, overloaded for the value types
+constexpr bool flat_packing(const void*)
+{
+  return false;
+}
+
 /**
  * Buffer for network communication with a pointer for sequential reading.
  * When sent over the network or stored in a file, the length is prefixed
@@ -70,6 +79,9 @@ class octetStream
   void set_length(size_t len) { end = data + len; }
   void set_max_length(size_t mxlen) { data_end = data + mxlen; }
 
+  void free_accounted()
+    { MemoryAccounting::remove(MemoryAccounting::COMMUNICATION, get_max_length()); }
+
   public:
 
   /// Increase allocation if needed
@@ -85,6 +97,8 @@ class octetStream
   void clear();
 
   void assign(const octetStream& os);
+  /// Exchange buffers without copying
+  void swap(octetStream& other);
 
   octetStream() : ptr(0), end(0), data(0), data_end(0) {}
   /// Initial buffer
@@ -97,7 +111,7 @@ class octetStream
     { if (this!=&os) { assign(os); }
       return *this;
     }
-  ~octetStream() { if(data) delete[] data; }
+  ~octetStream() { if(data) { free_accounted(); delete[] data; } }
   
   /// Number of bytes already read
   size_t get_ptr() const     { return ptr - data; }
@@ -201,6 +215,11 @@ class octetStream
   void store_bits(char a, int n_bits);
   char get_bits(int n_bits);
 
+  /// Append lower ``n_bits`` bits (up to 64) without padding to bytes
+  void store_packed_bits(uint64_t a, int n_bits);
+  /// Read ``n_bits`` bits (up to 64) stored without padding
+  uint64_t get_packed_bits(int n_bits);
+
   /// Append big integer
   void store(const bigint& x);
   /// Read big integer
@@ -247,6 +266,15 @@ class octetStream
   template <class T, size_t L>
   void get(array<T, L>& v);
 
+  /// Append contiguous elements, in one copy if possible
+  /// @param lengths bit lengths (optional)
+  template <class T>
+  void store_range(const T* x, size_t n, const int* lengths = 0);
+  /// Read contiguous elements, in one copy if possible
+  /// @param lengths bit lengths (optional)
+  template <class T>
+  void get_range(T* x, size_t n, const int* lengths = 0);
+
   /// Read ``l`` bytes into separate buffer
   void consume(octetStream& s,size_t l)
     { s.resize(l);
@@ -314,9 +342,11 @@ inline void octetStream::resize_precise(size_t l)
   auto read = get_ptr();
   auto len = get_length();
   octet* nd=new octet[l];
+  MemoryAccounting::add(MemoryAccounting::COMMUNICATION, l);
   if (data)
     {
       memcpy(nd, data, min(get_length(), l) * sizeof(octet));
+      free_accounted();
       delete[] data;
     }
   data=nd;
@@ -492,12 +522,86 @@ inline char octetStream::get_bits(int n_bits)
   }
 }
 
+inline void octetStream::store_packed_bits(uint64_t a, int n_bits)
+{
+  assert(n_bits <= 64);
+  auto& n = bits[0].n;
+  auto& buffer = bits[0].buffer;
+
+  // complete partial byte
+  if (n > 0 and n < 8)
+    {
+      int k = min(8 - n, n_bits);
+      buffer |= (a & ((1 << k) - 1)) << n;
+      n += k;
+      a >>= k;
+      n_bits -= k;
+    }
+
+  // whole bytes, flushing the buffer if needed
+  int n_bytes = n_bits / 8;
+  if (n_bytes > 0)
+    {
+      uint64_t tmp = htole64(a);
+      memcpy(append(n_bytes), &tmp, n_bytes);
+      a = n_bytes < 8 ? a >> (8 * n_bytes) : 0;
+      n_bits -= 8 * n_bytes;
+    }
+
+  if (n_bits > 0)
+    {
+      if (n > 0)
+        flush_bits();
+      buffer = a & ((1 << n_bits) - 1);
+      n = n_bits;
+    }
+}
+
+inline uint64_t octetStream::get_packed_bits(int n_bits)
+{
+  assert(n_bits <= 64);
+  auto& n = bits[1].n;
+  auto& buffer = bits[1].buffer;
+  uint64_t res = 0;
+  int done = 0;
+
+  // rest of partial byte
+  if (n > 0)
+    {
+      int k = min(int(n), n_bits);
+      res = (buffer >> (8 - n)) & ((1 << k) - 1);
+      n -= k;
+      done = k;
+    }
+
+  // whole bytes resetting the buffer
+  int n_bytes = (n_bits - done) / 8;
+  if (n_bytes > 0)
+    {
+      uint64_t tmp = 0;
+      memcpy(&tmp, consume(n_bytes), n_bytes);
+      res |= le64toh(tmp) << done;
+      done += 8 * n_bytes;
+    }
+
+  if (done < n_bits)
+    {
+      int k = n_bits - done;
+      buffer = get_int<1>();
+      res |= uint64_t(buffer & ((1 << k) - 1)) << done;
+      n = 8 - k;
+    }
+  return res;
+}
+
 
 template<class T>
 inline void octetStream::Send(T socket_num) const
 {
-  send(socket_num,get_length(),LENGTH_SIZE);
-  send(socket_num, get_data(), get_length());
+  octet blen[LENGTH_SIZE];
+  encode_length(blen, get_length(), LENGTH_SIZE);
+  struct iovec iov[] = {{blen, LENGTH_SIZE}, {get_data(), get_length()}};
+  send(socket_num, iov, 2);
 }
 
 
@@ -619,5 +723,31 @@ void octetStream::get(array<T, L>& v)
     get(x);
 }
 
+template<class T>
+void octetStream::store_range(const T* x, size_t n, const int* lengths)
+{
+  if constexpr (flat_packing(static_cast<const T*>(nullptr)))
+    {
+      static_assert(is_trivially_copyable<T>::value, "cannot copy memory");
+      if (size_t(T::size()) == sizeof(T))
+        return append((const octet*) x, n * sizeof(T));
+    }
+  for (size_t i = 0; i < n; i++)
+    x[i].pack(*this, lengths ? lengths[i] : -1);
+}
+
+template<class T>
+void octetStream::get_range(T* x, size_t n, const int* lengths)
+{
+  if constexpr (flat_packing(static_cast<const T*>(nullptr)))
+    {
+      static_assert(is_trivially_copyable<T>::value, "cannot copy memory");
+      if (size_t(T::size()) == sizeof(T))
+        return consume((octet*) x, n * sizeof(T));
+    }
+  for (size_t i = 0; i < n; i++)
+    x[i].unpack(*this, lengths ? lengths[i] : -1);
+}
+
 #endif
 
@@ -44,15 +44,14 @@ inline void get_vector(unsigned m, vector<int>& start, istream& s)
 {
   if (s.fail())
     throw runtime_error("error when parsing vector");
-  int* buffer = new int[m];
-  s.read((char*) buffer, 4 * m);
-  if (not s.fail())
-    {
-      start.resize(m);
-      for (unsigned i = 0; i < m; i++)
-        start[i] = be32toh(buffer[i]);
-    }
-  delete[] buffer;
+  // read in place to avoid a temporary buffer per instruction
+  start.resize(m);
+  s.read((char*) start.data(), 4 * m);
+  if (s.fail())
+    start.clear();
+  else
+    for (unsigned i = 0; i < m; i++)
+      start[i] = be32toh(start[i]);
 }
 
 inline void get_string(string& res, istream& s)
@@ -127,6 +127,22 @@ void PRNG::print_state() const
 }
 
 
+bool PRNG::wide_hash(octet* out)
+{
+#if defined(USE_AES) && defined(__VAES__) && defined(__AVX512F__)
+  const int N = PIPELINES * N_CACHE / 2;
+  if (N % 4 == 0 and not useC and cpu_has_vaes() and cpu_has_avx512())
+    {
+      for (int i = 0; i < 2; i++)
+        wide_ecb_aes_128_encrypt<N>((__m128i*) (out + i * N * AES_BLK_SIZE),
+            (__m128i*) (state + i * N * AES_BLK_SIZE), KeySchedule);
+      return true;
+    }
+#endif
+  (void) out;
+  return false;
+}
+
 void PRNG::hash()
 {
   assert(initialized);
@@ -136,15 +152,18 @@ void PRNG::hash()
     memcpy(random, tmp, RAND_SIZE);
     memcpy(seed, tmp + RAND_SIZE, SEED_SIZE);
   #else
-    for (int i = 0; i < N_CACHE; i++)
-      if (useC)
-        software_ecb_aes_128_encrypt<PIPELINES>(
-            (__m128i*) (random + i * CALL_SIZE),
-            (__m128i*) (state + i * CALL_SIZE), KeyScheduleC);
-      else
-        ecb_aes_128_encrypt<PIPELINES>(
-            (__m128i*) (random + i * CALL_SIZE),
-            (__m128i*) (state + i * CALL_SIZE), KeySchedule);
+    if (not wide_hash(random))
+      {
+        for (int i = 0; i < N_CACHE; i++)
+          if (useC)
+            software_ecb_aes_128_encrypt<PIPELINES>(
+                (__m128i*) (random + i * CALL_SIZE),
+                (__m128i*) (state + i * CALL_SIZE), KeyScheduleC);
+          else
+            ecb_aes_128_encrypt<PIPELINES>(
+                (__m128i*) (random + i * CALL_SIZE),
+                (__m128i*) (state + i * CALL_SIZE), KeySchedule);
+      }
   #endif
   // This is a new random value so we have not used any of it yet
   cnt=0;
@@ -154,9 +173,18 @@ void PRNG::hash()
 
 void PRNG::next()
 {
+#ifdef PRNG_TIMER
   timer.start();
+#endif
   hash();
-  // Increment state
+  increment();
+#ifdef PRNG_TIMER
+  timer.stop();
+#endif
+}
+
+void PRNG::increment()
+{
   for (int i = 0; i < PIPELINES * N_CACHE; i++)
     {
       int64_t* s = (int64_t*)&state[i*AES_BLK_SIZE];
@@ -164,7 +192,29 @@ void PRNG::next()
       if (s[0] == 0)
           s[1]++;
     }
-  timer.stop();
+}
+
+void PRNG::fill_octets(octet* ans, size_t len)
+{
+  // rest of buffer
+  size_t step = min(len, size_t(RAND_SIZE - cnt));
+  memcpy(ans, random + cnt, step);
+  cnt += step;
+  ans += step;
+  len -= step;
+
+  // whole batches directly to destination
+#ifdef USE_AES
+  while (len >= size_t(RAND_SIZE) and wide_hash(ans))
+    {
+      increment();
+      ans += RAND_SIZE;
+      len -= RAND_SIZE;
+    }
+#endif
+
+  if (len)
+    get_octets(ans, len);
 }
 
 
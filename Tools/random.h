@@ -29,6 +29,13 @@
 class Player;
 class PlayerBase;
 
+// whether randomize() fills the memory representation with
+// sizeof(T) random bytes, overloaded for value types
+constexpr bool flat_random(const void*)
+{
+  return false;
+}
+
 /* This basically defines a randomness expander, if using
  * as a real PRG on an input stream you should first collapse
  * the input stream down to a SEED, say via CBC-MAC (under 0 key)
@@ -73,6 +80,9 @@ class PRNG
 
    void hash(); // Hashes state to random and sets cnt=0
    void next();
+   void increment();
+   // encrypt state to any buffer using VAES if available
+   bool wide_hash(octet* out);
 
    public:
 
@@ -161,6 +171,22 @@ class PRNG
    // non-inlined version
    void get_octets_call(octet* ans, int len);
 
+   /**
+    * Fill array with random data, bypassing the buffer for large requests
+    * @param ans result
+    * @param len byte length
+    */
+   void fill_octets(octet* ans, size_t len);
+
+   /**
+    * Fill array with random elements, with the same result as
+    * ``randomize()`` on every element
+    * @param out result
+    * @param n number of elements
+    */
+   template<class T>
+   void fill(T* out, size_t n);
+
    /**
     * Fill array with random data (compile-time length)
     * @param ans result
@@ -265,6 +291,17 @@ inline void PRNG::get_octets(octet* ans)
      get_octets_call(ans, L);
 }
 
+template<class T>
+void PRNG::fill(T* out, size_t n)
+{
+  if constexpr ((is_integral<T>::value and not is_same<T, bool>::value)
+      or flat_random(static_cast<const T*>(nullptr)))
+    fill_octets((octet*) out, n * sizeof(T));
+  else
+    for (size_t i = 0; i < n; i++)
+      out[i].randomize(*this);
+}
+
 template<int N_BYTES>
 inline void PRNG::randomBnd(mp_limb_t* res, const mp_limb_t* B, mp_limb_t mask)
 {
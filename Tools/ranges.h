@@ -9,7 +9,7 @@
 template<class T>
 class BlockRange
 {
-    typename vector<T>::iterator begin_, end_;
+    typename StackedVector<T>::iterator begin_, end_;
 
 public:
     const int n_bits;
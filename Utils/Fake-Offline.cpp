@@ -47,7 +47,7 @@ string prep_data_prefix;
 
 class FakeParams
 {
-  int nplayers, default_num;
+  int nplayers, default_num, n_threads;
   bool zero;
 
 public:
@@ -137,7 +137,7 @@ void FakeParams::make_mult_triples(const KeySetup<T>& key, int N,
     int ntrip, bool zero, const string& prep_data_prefix, PRNG& G, int thread_num)
 {
   ::make_mult_triples(key, N, get_usage<T>(DATA_TRIPLE, ntrip), zero,
-      prep_data_prefix, G, thread_num);
+      prep_data_prefix, G, thread_num, n_threads);
 }
 
 template<class T>
@@ -145,7 +145,7 @@ void FakeParams::make_inverse(const KeySetup<T>& key, int N,
     int ntrip, bool zero, const string& prep_data_prefix, PRNG& G)
 {
   ::make_inverse(key, N, get_usage<T>(DATA_INVERSE, ntrip), zero,
-      prep_data_prefix, G);
+      prep_data_prefix, G, n_threads);
 }
 
 /* N      = Number players
@@ -158,16 +158,19 @@ void FakeParams::make_square_tuples(const KeySetup<T>& key, int N, int ntrip,
   (void) str;
   ntrip = get_usage<T>(DATA_SQUARE, ntrip);
   Files<T> files(N, key, prep_data_prefix, DATA_SQUARE, G);
-  typename T::clear a,c;
-  /* Generate Squares */
-  for (int i=0; i<ntrip; i++)
-    {
-      if (!zero)
-        a.randomize(G);
-      c = a * a;
-      files.output_shares(a);
-      files.output_shares(c);
-    }
+  files.generate(ntrip, n_threads, [zero](auto& out, PRNG& G, size_t n)
+  {
+    typename T::clear a,c;
+    /* Generate Squares */
+    for (size_t i=0; i<n; i++)
+      {
+        if (!zero)
+          a.randomize(G);
+        c = a * a;
+        out.output_shares(a);
+        out.output_shares(c);
+      }
+  });
   check_files(files.outf, N);
 }
 
@@ -181,13 +184,16 @@ void FakeParams::make_bits(const KeySetup<T>& key, int N, int ntrip, bool zero,
   ntrip = get_usage<T>(DATA_BIT, ntrip);
 
   Files<T> files(N, key, prep_data_prefix, DATA_BIT, G, thread_num);
-  typename T::clear a;
-  /* Generate Bits */
-  for (int i=0; i<ntrip; i++)
-    { if ((G.get_uchar()&1)==0 || zero) { a.assign_zero(); }
-      else                       { a.assign_one();  }
-      files.output_shares(a);
-    }
+  files.generate(ntrip, n_threads, [zero](auto& out, PRNG& G, size_t n)
+  {
+    typename T::clear a;
+    /* Generate Bits */
+    for (size_t i=0; i<n; i++)
+      { if ((G.get_uchar()&1)==0 || zero) { a.assign_zero(); }
+        else                       { a.assign_one();  }
+        out.output_shares(a);
+      }
+  });
   check_files(files.outf, N);
 }
 
@@ -711,6 +717,16 @@ int main(int argc, const char** argv)
           "-p", // Flag token.
           "--program" // Flag token.
   );
+  opt.add(
+          "1", // Default.
+          0, // Required?
+          1, // Number of args expected.
+          0, // Delimiter if expecting multiple args.
+          "Number of threads for triples, squares, bits, and inverses "
+          "(default: 1)", // Help description.
+          "-j", // Flag token.
+          "--threads" // Flag token.
+  );
   opt.parse(argc, argv);
 
   int lgp;
@@ -804,6 +820,7 @@ int FakeParams::generate()
   opt.get("--lg2")->getInt(lg2);
 
   opt.get("--default")->getInt(default_num);
+  opt.get("--threads")->getInt(n_threads);
   ntrip2 = ntripp = nbits2 = nbitsp = nsqr2 = nsqrp = ninp2 = ninpp = ninv =
       default_num;
   
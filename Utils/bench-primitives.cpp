@@ -0,0 +1,286 @@
+/*
+ * bench-primitives.cpp
+ *
+ * Throughput of protocol primitives for a range of vector sizes and
+ * numbers of threads. Party 0 outputs CSV with one line per primitive,
+ * number of threads, and size, for example:
+ *
+ *   for i in 0 1 2; do
+ *     ./bench-primitives.x $i 3 Rep3 1,4 1000,100000 > bench-$i.csv & true
+ *   done
+ *
+ * Every thread uses its own connections and preprocessing, and the
+ * items are split evenly between threads. Primitives not supported by
+ * a protocol are skipped.
+ *
+ */
+
+#include "Machines/maximal.hpp"
+
+#include <thread>
+
+// products per dot product
+const int DOTPROD_LENGTH = 10;
+
+template<class T>
+class PrimitiveBench
+{
+    MixedProtocolSet<T>& set;
+    Player& P;
+    size_t n;
+    vector<T> a, b, c;
+
+public:
+    typedef void (PrimitiveBench::*Primitive)();
+
+    static const vector<pair<string, Primitive>> primitives;
+
+    PrimitiveBench(MixedProtocolSet<T>& set, Player& P, size_t n) :
+            set(set), P(P), n(n), a(n), b(n), c(n)
+    {
+    }
+
+    void input()
+    {
+        auto& input = set.input;
+        input.reset_all(P);
+        vector<typename T::open_type> values(n);
+        for (size_t i = 0; i < n; i++)
+            values[i] = i;
+        for (int j = 0; j < P.num_players(); j++)
+            if (j == P.my_num())
+                input.add_mine_vector(values);
+            else
+                input.add_other_vector(j, n);
+        input.exchange();
+        for (int j = 0; j < P.num_players(); j++)
+            input.finalize_vector(j, j == 0 ? a.data() : j == 1 ? b.data() :
+                    c.data(), n);
+    }
+
+    void mul()
+    {
+        auto& protocol = set.protocol;
+        protocol.init_mul();
+        for (size_t i = 0; i < n; i++)
+            protocol.prepare_mul(a[i], b[i]);
+        protocol.exchange();
+        for (size_t i = 0; i < n; i++)
+            c[i] = protocol.finalize_mul();
+    }
+
+    void dotprod()
+    {
+        auto& protocol = set.protocol;
+        protocol.init_dotprod();
+        for (size_t i = 0; i < n; i++)
+        {
+            for (int j = 0; j < DOTPROD_LENGTH; j++)
+                protocol.prepare_dotprod(a[(i + j) % n], b[i]);
+            protocol.next_dotprod();
+        }
+        protocol.exchange();
+        for (size_t i = 0; i < n; i++)
+            c[i] = protocol.finalize_dotprod(DOTPROD_LENGTH);
+    }
+
+    void open()
+    {
+        auto& output = set.output;
+        output.init_open(P, n);
+        for (auto& x : c)
+            output.prepare_open(x);
+        output.exchange(P);
+        for (size_t i = 0; i < n; i++)
+            output.finalize_open();
+    }
+
+    void trunc_pr()
+    {
+        auto& S = set.processor.get_S();
+        S.resize(2 * n);
+        copy(a.begin(), a.end(), S.begin());
+        // 32-bit values truncated by 16 bits
+        set.protocol.trunc_pr({int(n), 0, 32, 16}, n, set.processor,
+                T::clear::characteristic_two);
+    }
+
+    void edabits()
+    {
+        // the most expensive part of comparisons
+        for (size_t i = 0; i < n; i += edabitvec<T>::MAX_SIZE)
+            set.preprocessing.get_edabitvec(true, 32);
+    }
+
+    void shuffle()
+    {
+        auto& S = set.processor.get_S();
+        S.resize(2 * n);
+        copy(a.begin(), a.end(), S.begin());
+        typename T::Protocol::Shuffler(S, n, 1, n, 0, set.processor);
+    }
+};
+
+template<class T>
+const vector<pair<string, typename PrimitiveBench<T>::Primitive>> PrimitiveBench<T>::primitives =
+{
+        {"input", &PrimitiveBench::input},
+        {"mul", &PrimitiveBench::mul},
+        {"dotprod", &PrimitiveBench::dotprod},
+        {"open", &PrimitiveBench::open},
+        {"trunc_pr", &PrimitiveBench::trunc_pr},
+        {"edabits", &PrimitiveBench::edabits},
+        {"shuffle", &PrimitiveBench::shuffle},
+};
+
+struct BenchResult
+{
+    double seconds;
+    size_t sent, rounds;
+    bool failed;
+
+    BenchResult() :
+            seconds(0), sent(0), rounds(0), failed(false)
+    {
+    }
+};
+
+template<class T>
+void bench_thread(int thread, int n_threads, Names& N,
+        MixedProtocolSetup<T>& setup, const vector<size_t>& sizes,
+        pthread_barrier_t& barrier, vector<BenchResult>& results)
+{
+    BaseMachine::thread_num = thread;
+    PlainPlayer P(N, "bench-" + to_string(n_threads) + "-" + to_string(thread));
+    MixedProtocolSet<T> set(P, setup);
+    auto& primitives = PrimitiveBench<T>::primitives;
+
+    for (size_t i = 0; i < sizes.size(); i++)
+    {
+        PrimitiveBench<T> bench(set, P, max(sizes[i] / n_threads, size_t(1)));
+        for (size_t j = 0; j < primitives.size(); j++)
+        {
+            auto& result = results.at(i * primitives.size() + j);
+            pthread_barrier_wait(&barrier);
+            auto before = P.total_sent_and_rounds();
+            Timer timer;
+            timer.start();
+            try
+            {
+                (bench.*primitives[j].second)();
+                set.check();
+            }
+            catch (exception& e)
+            {
+                result.failed = true;
+            }
+            result.seconds = timer.elapsed();
+            auto after = P.total_sent_and_rounds();
+            result.sent = after.first - before.first;
+            result.rounds = after.second - before.second;
+        }
+    }
+}
+
+vector<size_t> parse_list(const char* arg)
+{
+    vector<size_t> res;
+    stringstream ss(arg);
+    string item;
+    while (getline(ss, item, ','))
+        res.push_back(stoul(item));
+    return res;
+}
+
+template<class T>
+void run(int argc, char** argv)
+{
+    int my_number = atoi(argv[1]);
+    int n_parties = atoi(argv[2]);
+    vector<size_t> threads = {1}, sizes = {1000, 100000};
+    if (argc > 4)
+        threads = parse_list(argv[4]);
+    if (argc > 5)
+        sizes = parse_list(argv[5]);
+
+    int port_base = 9999;
+    Names N(my_number, n_parties, "localhost", port_base);
+    PlainPlayer P(N, "main");
+    MixedProtocolSetup<T> setup(P);
+
+    auto& primitives = PrimitiveBench<T>::primitives;
+    if (my_number == 0)
+        cout << "protocol,primitive,threads,size,seconds,per_second,"
+                << "bytes_sent,rounds" << endl;
+
+    for (auto n_threads : threads)
+    {
+        vector<vector<BenchResult>> results(n_threads,
+                vector<BenchResult>(sizes.size() * primitives.size()));
+        pthread_barrier_t barrier;
+        pthread_barrier_init(&barrier, 0, n_threads);
+        vector<thread> workers;
+        for (size_t i = 0; i < n_threads; i++)
+            workers.push_back(
+                    thread(bench_thread<T>, i, n_threads, ref(N), ref(setup),
+                            cref(sizes), ref(barrier), ref(results[i])));
+        for (auto& worker : workers)
+            worker.join();
+        pthread_barrier_destroy(&barrier);
+
+        if (my_number != 0)
+            continue;
+
+        for (size_t i = 0; i < sizes.size(); i++)
+            for (size_t j = 0; j < primitives.size(); j++)
+            {
+                // slowest thread with communication of all threads
+                BenchResult total;
+                for (auto& thread_results : results)
+                {
+                    auto& result = thread_results[i * primitives.size() + j];
+                    total.seconds = max(total.seconds, result.seconds);
+                    total.sent += result.sent;
+                    total.rounds = max(total.rounds, result.rounds);
+                    total.failed |= result.failed;
+                }
+                if (total.failed)
+                    continue;
+                cout << argv[3] << "," << primitives[j].first << ","
+                        << n_threads << "," << sizes[i] << "," << total.seconds
+                        << "," << sizes[i] / total.seconds << "," << total.sent
+                        << "," << total.rounds << endl;
+            }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        cerr << "Usage: " << argv[0]
+                << " <my number: 0/1/...> <total number of players> <protocol>"
+                << " [threads, e.g., 1,2,4 [sizes, e.g., 1000,100000]]"
+                << endl
+                << "Protocols: Rep3, Rep4, Semi2k, SPDZ2k, Atlas" << endl;
+        exit(1);
+    }
+
+    string protocol = argv[3];
+
+    if (protocol == "Rep3")
+        run<Rep3Share2<64>>(argc, argv);
+    else if (protocol == "Rep4")
+        run<Rep4Share2<64>>(argc, argv);
+    else if (protocol == "Semi2k")
+        run<Semi2kShare<64>>(argc, argv);
+    else if (protocol == "SPDZ2k")
+        run<Spdz2kShare<64, 64>>(argc, argv);
+    else if (protocol == "Atlas")
+        run<AtlasShare<gfp_<0, 2>>>(argc, argv);
+    else
+    {
+        cerr << "Unknown protocol: " << protocol << endl;
+        exit(1);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * gf2n-kernels.cpp
+ *
+ * Benchmark and cross-check batched multiplication in GF(2^n)
+ *
+ */
+
+#include "Math/gf2n.h"
+#include "Math/gf2n_vectors.h"
+#include "Tools/random.h"
+#include "Tools/KernelBenchmark.h"
+
+#include <iostream>
+#include <vector>
+using namespace std;
+
+template<class T>
+bool run(int degree, size_t n)
+{
+    T::reset();
+    T::init_field(degree);
+
+    SeededPRNG G;
+    vector<T> x(n), y(n), expected(n), res(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i].randomize(G);
+        y[i].randomize(G);
+    }
+    // largest values for the reduction
+    x[0] = 0;
+    for (int i = 0; i < T::degree(); i++)
+        x[0] += T(1) << i;
+    y[0] = x[0];
+
+    KernelBenchmark bench(3);
+    for (int run = 0; run < bench.n_runs; run++)
+    {
+        bench.measure(0, [&]() {
+            for (size_t i = 0; i < n; i++)
+                expected[i] = x[i] * y[i];
+        });
+        bench.measure(1, [&]() { T::mul(res.data(), x.data(), y.data(), n); });
+    }
+    for (size_t i = 0; i < n; i++)
+        if (res[i] != expected[i])
+            return false;
+
+    for (int run = 0; run < bench.n_runs; run++)
+        bench.measure(2, [&]() { T::mul(res.data(), x.data(), y[0], n); });
+    for (size_t i = 0; i < n; i++)
+        if (res[i] != x[i] * y[0])
+            return false;
+
+    bench.print("GF(2^" + to_string(T::degree()) + ")",
+            {"scalar", "batched", "with same factor per product"}, 1e9 / n);
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t n = argc > 1 ? atoi(argv[1]) : 100000;
+
+    cout << "VPCLMULQDQ multiplication "
+            << (gf2n_vectors::available() ? "enabled" : "not available")
+            << endl;
+
+    bool ok = run<gf2n_short>(40, n) and run<gf2n_short>(64, n)
+            and run<gf2n_short>(63, n) and run<gf2n_long>(128, n)
+            and run<gf2n_short>(64, n + 3) and run<gf2n_long>(128, n + 3);
+    if (not ok)
+    {
+        cerr << "wrong products" << endl;
+        return 1;
+    }
+}
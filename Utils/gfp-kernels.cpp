@@ -0,0 +1,83 @@
+/*
+ * gfp-kernels.cpp
+ *
+ * Benchmark and cross-check batched multiplication modulo a prime
+ * as well as reduction modulo primes close to a power of two
+ *
+ */
+
+#include "Math/gfp.hpp"
+#include "Math/Setup.h"
+#include "Tools/random.h"
+#include "Tools/KernelBenchmark.h"
+
+#include <iostream>
+#include <vector>
+using namespace std;
+
+template<int X, int L>
+bool run(const bigint& prime, size_t n)
+{
+    typedef gfp_<X, L> T;
+    T::init_field(prime);
+
+    SeededPRNG G;
+    vector<T> x(n), y(n), expected(n), res(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i].randomize(G);
+        y[i].randomize(G);
+    }
+    // largest values for carries
+    x[0] = -1;
+    y[0] = -1;
+
+    KernelBenchmark bench(3);
+    for (int run = 0; run < bench.n_runs; run++)
+    {
+        bench.measure(0, [&]() {
+            for (size_t i = 0; i < n; i++)
+                expected[i] = x[i] * y[i];
+        });
+        bench.measure(1, [&]() { T::mul(res.data(), x.data(), y.data(), n); });
+    }
+    if (res != expected)
+        return false;
+    for (size_t i = 0; i < min(n, size_t(1000)); i++)
+        if (bigint(expected[i]) != bigint(x[i]) * bigint(y[i]) % prime)
+            return false;
+
+    for (int run = 0; run < bench.n_runs; run++)
+        bench.measure(2, [&]() { T::mul(res.data(), x.data(), y[0], n); });
+    for (size_t i = 0; i < n; i++)
+        if (res[i] != x[i] * y[0])
+            return false;
+
+    bench.print(to_string(prime.numBits()) + "-bit "
+            + (T::get_ZpD().is_special() ? "special" : "generic")
+            + " prime (L=" + to_string(L) + ")",
+            {"scalar", "batched", "with same factor per product"}, 1e9 / n);
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t n = argc > 1 ? atoi(argv[1]) : 100000;
+
+    cout << "IFMA multiplication "
+            << (MontgomeryVectors::available() ? "enabled" : "not available")
+            << endl;
+
+    bool ok = run<0, 1>(SPDZ_Data_Setup_Primes(40), n)
+            and run<1, 1>(SPDZ_Data_Setup_Primes(64), n)
+            and run<2, 1>(generate_special_prime(64), n)
+            and run<0, 2>(SPDZ_Data_Setup_Primes(128), n)
+            and run<1, 2>(generate_special_prime(128), n)
+            and run<0, 4>(SPDZ_Data_Setup_Primes(256), n)
+            and run<1, 4>(generate_special_prime(256), n);
+    if (not ok)
+    {
+        cerr << "wrong products" << endl;
+        return 1;
+    }
+}
@@ -7,9 +7,11 @@
 #include "FHE/NTL-Subs.h"
 #include "FHE/FHE_Keys.h"
 #include "FHE/Plaintext.h"
+#include "Tools/time-func.h"
 
 void first_phase(string filename, int n_mults, int circuit_sec);
 void second_phase(string filename);
+void benchmark();
 
 int main()
 {
@@ -20,6 +22,8 @@ int main()
             first_phase(filename, n_mults, sec);
             second_phase(filename);
         }
+
+    benchmark();
 }
 
 void first_phase(string filename, int n_mults, int circuit_sec)
@@ -95,3 +99,41 @@ void second_phase(string filename)
     assert(plaintext.element(0) == 16);
     assert(plaintext.element(1) == 1);
 }
+
+// compile with USE_HEXL = 1 in CONFIG for comparison
+void benchmark()
+{
+    FHE_Params params(1);
+    params.basic_generation_mod_prime(32);
+    FHE_KeyPair pair(params);
+    pair.generate();
+
+    SeededPRNG G;
+    Plaintext_mod_prime plaintext(params);
+    plaintext.randomize(G);
+    Ciphertext ciphertext = pair.pk.encrypt(plaintext), product(params);
+
+    const int n_runs = 10;
+    double times[4] = {};
+    for (int i = 0; i < n_runs; i++)
+    {
+        Timer timer;
+        timer.start();
+        ciphertext = pair.pk.encrypt(plaintext);
+        times[0] += timer.elapsed();
+        product = ciphertext * plaintext;
+        times[1] += timer.elapsed();
+        product = ciphertext.mul(pair.pk, ciphertext);
+        times[2] += timer.elapsed();
+        pair.sk.decrypt(product);
+        times[3] += timer.elapsed();
+    }
+
+    string names[] = {"encryption", "plaintext multiplication",
+            "ciphertext multiplication", "decryption"};
+    cout << "ring dimension " << params.phi_m() << endl;
+    for (int i = 0; i < 4; i++)
+        cout << names[i] << ": "
+                << 1e3 * (times[i] - (i ? times[i - 1] : 0)) / n_runs << " ms"
+                << endl;
+}
@@ -0,0 +1,91 @@
+/*
+ * he-matmul.cpp
+ *
+ * Benchmark the local part of matrix triple generation with
+ * semi-homomorphic encryption as in hemi-party.x
+ *
+ */
+
+#include "FHE/FHE_Params.h"
+#include "FHE/NTL-Subs.h"
+#include "FHE/FHE_Keys.h"
+#include "FHE/Diagonalizer.h"
+#include "Tools/time-func.h"
+
+#include <iostream>
+#include <thread>
+using namespace std;
+
+int main(int argc, const char** argv)
+{
+    if (argc < 4)
+    {
+        cerr << "usage: " << argv[0]
+                << " <rows> <inner> <columns> [<threads>...]" << endl;
+        return 1;
+    }
+
+    int n_rows = atoi(argv[1]), n_inner = atoi(argv[2]),
+            n_cols = atoi(argv[3]);
+    vector<int> n_threads;
+    for (int i = 4; i < argc; i++)
+        n_threads.push_back(atoi(argv[i]));
+    if (n_threads.empty())
+        n_threads = {1, int(thread::hardware_concurrency())};
+
+    // same orientation as HemiMatrixPrep
+    if (n_rows > n_cols)
+        swap(n_rows, n_cols);
+
+    FHE_Params params(0);
+    params.set_matrix_dim(n_inner);
+    params.basic_generation_mod_prime(128);
+    auto& FTD = params.get_plaintext_field_data<FFT_Data>();
+    gfpvar::init_field(FTD.get_prime());
+
+    FHE_KeyPair pair(params);
+    pair.generate();
+
+    int n_matrices = FTD.num_slots() / n_rows;
+    Diagonalizer::MatrixVector A(n_matrices, {n_rows, n_inner}),
+            B(n_matrices, {n_inner, n_cols});
+    SeededPRNG G;
+    for (auto& x : A)
+        x.randomize(G);
+    for (auto& x : B)
+        x.randomize(G);
+
+    cout << n_matrices << " " << n_rows << "x" << n_inner << " * " << n_inner
+            << "x" << n_cols << " triples per batch with phi(m) = "
+            << params.phi_m() << endl;
+
+    for (int threads : n_threads)
+    {
+        Timer timer;
+        timer.start();
+        Diagonalizer diag(A, FTD, pair.pk, threads);
+        double encryption = timer.elapsed();
+        vector<Ciphertext> products;
+        for (int j = 0; j < n_cols; j++)
+            products.push_back(
+                    diag.multiply(diag.ciphertexts, B, j, pair.pk, threads));
+        double total = timer.elapsed();
+
+        cout << threads << " threads: " << encryption
+                << " seconds encryption, " << total - encryption
+                << " seconds products, " << n_matrices / total
+                << " triples per second" << endl;
+
+        auto C = diag.decrypt(products, n_matrices, pair.sk);
+        for (int i = 0; i < n_matrices; i++)
+        {
+            auto D = A[i] * B[i];
+            for (size_t k = 0; k < D.entries.size(); k++)
+                if (C[i].entries[k] != D.entries[k])
+                {
+                    cerr << "wrong product" << endl;
+                    return 1;
+                }
+        }
+    }
+}
@@ -0,0 +1,172 @@
+/*
+ * he-params.cpp
+ *
+ * Benchmark candidate ring dimensions for homomorphic triple generation
+ * and store the one with the best estimated throughput
+ *
+ */
+
+#include "FHE/FHE_Params.h"
+#include "FHE/NTL-Subs.h"
+#include "FHE/FHE_Keys.h"
+#include "FHEOffline/Proof.h"
+#include "Math/Setup.h"
+#include "Tools/time-func.h"
+
+#include <iostream>
+using namespace std;
+
+// best of several runs
+const int N_RUNS = 5;
+
+template<class T>
+void measure(double& best, const T& f)
+{
+    Timer timer;
+    timer.start();
+    f();
+    best = min(best, timer.elapsed());
+}
+
+class Costs
+{
+public:
+    double enc, plain_mul, rerandomize, dec, mul;
+    size_t ciphertext;
+
+    Costs(const FHE_Params& params, const FFT_Data& FTD);
+};
+
+Costs::Costs(const FHE_Params& params, const FFT_Data& FTD) :
+        enc(1e9), plain_mul(1e9), rerandomize(1e9), dec(1e9), mul(1e9)
+{
+    FHE_KeyPair pair(params, FTD.get_prime());
+    pair.generate();
+    SeededPRNG G;
+    Plaintext_<FFT_Data> a(FTD), b(FTD);
+    a.randomize(G);
+    b.randomize(G);
+
+    Ciphertext c(params), product(params);
+    for (int run = 0; run < N_RUNS; run++)
+    {
+        measure(enc, [&]() { c = pair.pk.encrypt(a); });
+        measure(plain_mul, [&]() { product = c * b; });
+        if (params.n_mults() > 0)
+            measure(mul, [&]() { product = c.mul(pair.pk, c); });
+        else
+            measure(rerandomize, [&]() { product.rerandomize(pair.pk); });
+        measure(dec, [&]() { pair.sk.decrypt_any(a, product); });
+
+        octetStream os;
+        c.pack(os);
+        ciphertext = os.get_length();
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        cerr << "usage: " << argv[0] << " lowgear|highgear|hemi "
+                << "[<plaintext length> [<parties> [<Mbit/s> [<security>]]]]"
+                << endl;
+        return 1;
+    }
+
+    string protocol = argv[1];
+    int plaintext_length = argc > 2 ? atoi(argv[2]) : 128;
+    int n_parties = argc > 3 ? atoi(argv[3]) : 2;
+    double bandwidth = 1e6 * (argc > 4 ? atof(argv[4]) : 1000);
+    int sec = argc > 5 ? atoi(argv[5]) : DEFAULT_SECURITY;
+
+    bool highgear = protocol == "highgear";
+    if (protocol == "hemi")
+        sec = 0;
+    else if (protocol != "lowgear" and not highgear)
+    {
+        cerr << "unknown protocol: " << protocol << endl;
+        return 1;
+    }
+    int n_mults = highgear;
+
+    // the minimum and two larger ones
+    int best_m = 0;
+    double best = 0;
+    for (int min_m = 0, i = 0; i < 3; i++)
+    {
+        FHE_Params params(n_mults);
+        FFT_Data FTD;
+        if (protocol == "hemi")
+            params.set_matrix_dim_from_options();
+        if (highgear)
+        {
+            Parameters parameters(n_parties, plaintext_length, sec,
+                    INTERACTIVE_SPDZ1_SLACK);
+            parameters.min_m = min_m;
+            parameters.generate_setup(params, FTD);
+        }
+        else
+            generate_semi_setup(plaintext_length, sec, params, FTD, true, 1,
+                    min_m);
+
+        int m = params.get_ring().m();
+        Costs costs(params, FTD);
+        double local, sent;
+        int others = n_parties - 1;
+        if (protocol == "hemi")
+        {
+            // seeded encryption and masked product per party
+            local = costs.enc
+                    + others * (costs.plain_mul + costs.rerandomize + costs.dec);
+            sent = others * 1.5 * costs.ciphertext;
+        }
+        else
+        {
+            // proof approximated by its additional encryptions
+            FHE_PK pk(params, FTD.get_prime());
+            NonInteractiveProof proof(max(sec, 1), pk, 0);
+            double proof_factor = double(proof.V) / proof.U;
+            if (highgear)
+            {
+                // a and b with proofs, products with MACs, decryption of
+                // c and the MACs, and resharing of c
+                local = 2 * costs.enc * (1 + proof_factor)
+                        + 2 * others * costs.enc * proof_factor
+                        + 4 * costs.mul + 4 * costs.dec + costs.enc;
+                sent = others * costs.ciphertext
+                        * (2 * (1 + 2 * proof_factor) + 2 + 1);
+            }
+            else
+            {
+                // a with proof, products with b and MACs per party
+                local = costs.enc * (1 + proof_factor)
+                        + others * (costs.enc * proof_factor
+                                + 4 * (costs.plain_mul + costs.rerandomize
+                                        + costs.dec));
+                sent = others * costs.ciphertext * (1 + 2 * proof_factor + 4);
+            }
+        }
+
+        double network = 8 * sent / bandwidth;
+        double triples = FTD.num_slots() / (local + network);
+        cout << "m = " << m << ", phi(m) = " << params.phi_m()
+                << ", ciphertext modulus " << numBits(params.Q()) << " bits, "
+                << costs.ciphertext << " bytes per ciphertext: "
+                << local * 1e3 << " ms computation, " << network * 1e3
+                << " ms communication, " << triples << " triples per second"
+                << endl;
+
+        if (triples > best)
+        {
+            best = triples;
+            best_m = m;
+        }
+        min_m = 2 * m;
+    }
+
+    store_tuned_cyclotomic_index(plaintext_length, n_mults, best_m);
+    cout << "Stored m = " << best_m << " for parameter generation, "
+            << "remove setups in " << PREP_DIR << " from previous runs to "
+            << "apply it" << endl;
+}
@@ -0,0 +1,85 @@
+/*
+ * matmul-kernels.cpp
+ *
+ * Benchmark and cross-check the blocked matrix product modulo 2^64
+ * as used for local products of replicated shares
+ *
+ */
+
+#include "Math/Z2k.hpp"
+#include "Math/ring_vectors.h"
+#include "Tools/random.h"
+#include "Tools/KernelBenchmark.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+using namespace std;
+
+bool run(size_t n, int n_threads)
+{
+    SeededPRNG G;
+    vector<uint64_t> A(n * n), B(n * n), expected(n * n), res(n * n);
+    G.get_octets((octet*) A.data(), A.size() * sizeof(uint64_t));
+    G.get_octets((octet*) B.data(), B.size() * sizeof(uint64_t));
+
+    // naive, blocked, and blocked with threads
+    KernelBenchmark bench(3, 5);
+    for (int run = 0; run < bench.n_runs; run++)
+    {
+        bench.measure(0, [&]() {
+            for (size_t i = 0; i < n; i++)
+                for (size_t j = 0; j < n; j++)
+                {
+                    uint64_t sum = 0;
+                    for (size_t k = 0; k < n; k++)
+                        sum += A[i * n + k] * B[k * n + j];
+                    expected[i * n + j] = sum;
+                }
+        });
+
+        bench.measure(1, [&]() {
+            fill(res.begin(), res.end(), 0);
+            ring_gemm(res.data(), A.data(), B.data(), n, n, n);
+        });
+        if (res != expected)
+            return false;
+
+        bench.measure(2, [&]() {
+            fill(res.begin(), res.end(), 0);
+            auto job = [&](size_t begin, size_t end)
+            {
+                ring_gemm(res.data() + begin * n, A.data() + begin * n,
+                        B.data(), end - begin, n, n);
+            };
+            vector<thread> threads;
+            for (int i = 1; i < n_threads; i++)
+                threads.push_back(
+                        thread(job, n * i / n_threads,
+                                n * (i + 1) / n_threads));
+            job(0, n / n_threads);
+            for (auto& thread : threads)
+                thread.join();
+        });
+        if (res != expected)
+            return false;
+    }
+
+    bench.print(to_string(n) + "x" + to_string(n),
+            {"naive", "blocked", "with " + to_string(n_threads) + " threads"},
+            1e3, "ms");
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    int n_threads = argc > 1 ? atoi(argv[1]) : thread::hardware_concurrency();
+    n_threads = max(n_threads, 1);
+
+    for (size_t n : {64, 128, 256, 512})
+        if (not run(n, n_threads))
+        {
+            cerr << "wrong results" << endl;
+            return 1;
+        }
+}
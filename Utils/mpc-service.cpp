@@ -0,0 +1,171 @@
+/*
+ * mpc-service.cpp
+ *
+ * Long-running party that keeps the connections and threads of one
+ * machine instance and executes exported functions on request by
+ * external clients (see ExternalIO/service-client.cpp)
+ *
+ */
+
+#include "Machines/maximal.hpp"
+#include "Processor/ExternalClients.h"
+#include "Tools/WaitQueue.h"
+
+#include <thread>
+
+struct Request
+{
+    int client_id;
+    client_socket* socket;
+    string function;
+    // sizes of vector arguments and result
+    vector<size_t> sizes;
+    size_t n_results;
+
+    size_t n_inputs() const
+    {
+        size_t res = 0;
+        for (auto& size : sizes)
+            res += size;
+        return res;
+    }
+};
+
+// accept clients and read their requests while computation is running
+void accept_requests(ExternalClients& clients, int port_base,
+        WaitQueue<Request>& requests)
+{
+    while (true)
+    {
+        Request request;
+        request.client_id = clients.get_client_connection(port_base, 0);
+        request.socket = clients.get_socket(request.client_id);
+
+        // domain specification as with acceptclientconnection
+        typedef Rep3Share2<64> share_type;
+        octetStream os;
+        os.store(int(share_type::open_type::type_char()));
+        share_type::specification(os);
+        share_type::clear::specification(os);
+        os.Send(request.socket);
+
+        os.Receive(request.socket);
+        os.get(request.function);
+        request.sizes.resize(os.get_int(4));
+        for (auto& size : request.sizes)
+            size = os.get_int(4);
+        request.n_results = os.get_int(4);
+        requests.push(request);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0]
+                << " <party number> [<client port base>]" << endl;
+        exit(1);
+    }
+
+    int my_number = atoi(argv[1]);
+    int port_base = 9999;
+    int client_port_base = argc > 2 ? atoi(argv[2]) : 14000;
+    Names N(my_number, 3, "localhost", port_base);
+
+    typedef Rep3Share2<64> share_type;
+    Machine<share_type> machine(N);
+    auto& P = machine.get_player();
+    ProtocolSet<share_type> set(P, machine);
+    auto rec_factor = share_type::get_rec_factor(P.my_num(), P.num_players());
+
+    ExternalClients clients(my_number);
+    clients.start_listening(client_port_base);
+    WaitQueue<Request> requests;
+    thread(accept_requests, ref(clients), client_port_base,
+            ref(requests)).detach();
+
+    // requests received here but not yet scheduled by party 0
+    map<int, Request> pending;
+
+    while (true)
+    {
+        // all parties process requests in the order seen by party 0
+        Request request;
+        octetStream os;
+        if (P.my_num() == 0)
+        {
+            request = requests.pop();
+            os.store_int(request.client_id, 4);
+            P.send_all(os);
+        }
+        else
+        {
+            P.receive_player(0, os);
+            int client_id = os.get_int(4);
+            while (pending.find(client_id) == pending.end())
+            {
+                auto next = requests.pop();
+                pending[next.client_id] = next;
+            }
+            request = pending[client_id];
+            pending.erase(client_id);
+        }
+
+        Timer timer;
+        timer.start();
+
+        // masked input as with sint.receive_from_client
+        size_t n_inputs = request.n_inputs();
+        vector<share_type> masks(n_inputs);
+        os.reset_write_head();
+        for (auto& mask : masks)
+        {
+            mask = set.preprocessing.get_random();
+            mask.pack(os, rec_factor);
+        }
+        os.Send(request.socket);
+        os.reset_write_head();
+        os.Receive(request.socket);
+        vector<share_type> inputs(n_inputs);
+        for (size_t i = 0; i < n_inputs; i++)
+            inputs[i] = share_type::constant(
+                    os.get<share_type::open_type>(), P.my_num(),
+                    machine.get_sint_mac_key()) - masks[i];
+
+        vector<FunctionArgument> args;
+        auto data = inputs.data();
+        for (auto& size : request.sizes)
+        {
+            args.push_back({data, size, false});
+            data += size;
+        }
+
+        vector<share_type> results(request.n_results);
+        FunctionArgument res;
+        if (request.n_results)
+            res = results;
+
+        os.reset_write_head();
+        try
+        {
+            machine.run_function(request.function, res, args);
+            for (auto& x : results)
+                x.pack(os, rec_factor);
+        }
+        catch (exception& e)
+        {
+            // all parties fail before communication in the function,
+            // the client sees a message of unexpected length
+            cerr << "Request by client " << request.client_id << " failed: "
+                    << e.what() << endl;
+        }
+        os.Send(request.socket);
+        clients.close_connection(request.client_id);
+
+        if (OnlineOptions::singleton.verbose)
+            cerr << "Served " << request.function << " for client "
+                    << request.client_id << " in " << timer.elapsed()
+                    << " seconds" << endl;
+    }
+}
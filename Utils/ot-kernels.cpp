@@ -0,0 +1,238 @@
+/*
+ * ot-kernels.cpp
+ *
+ * Benchmark and cross-check vectorized kernels used in OT extension
+ *
+ */
+
+#include "OT/BitMatrix.hpp"
+#include "Math/gf2nlong.h"
+#include "Tools/random.h"
+#include "Tools/KernelBenchmark.h"
+#include "Tools/MMO.hpp"
+#include "OT/Rectangle.hpp"
+#include "OT/Triple.hpp"
+#include "Math/Z2k.hpp"
+
+#include <iostream>
+#include <vector>
+using namespace std;
+
+bool transpose(const vector<square128>& input, bool wide)
+{
+    vector<square128> squares;
+    KernelBenchmark bench(1);
+    for (int run = 0; run < bench.n_runs; run++)
+    {
+        squares = input;
+        bench.measure(0, [&]() {
+            for (auto& square : squares)
+                square.transpose(wide);
+        });
+    }
+    bench.print(string("transpose (") + (wide ? "wide" : "narrow") + ")",
+            {"per 128x128"}, 1e9 / squares.size());
+
+    for (size_t i = 0; i < squares.size(); i++)
+        for (int j = 0; j < 128; j++)
+            for (int k = 0; k < 128; k++)
+                if (squares[i].get_bit(j, k)
+                        != const_cast<square128&>(input[i]).get_bit(k, j))
+                    return false;
+    return true;
+}
+
+bool mul(const vector<int128>& a, const vector<int128>& b)
+{
+    __m128i res[2][2];
+    KernelBenchmark bench(2);
+
+    for (int run = 0; run < bench.n_runs; run++)
+    {
+        memset(res, 0, sizeof(res));
+        bench.measure(0, [&]() {
+            for (size_t i = 0; i < a.size(); i++)
+            {
+                __m128i lo, hi;
+                mul128(a[i].a, b[i].a, &lo, &hi);
+                res[0][0] ^= lo;
+                res[0][1] ^= hi;
+            }
+        });
+        bench.measure(1, [&]() {
+            add_mul128(res[1], (__m128i*) a.data(), (__m128i*) b.data(),
+                    a.size());
+        });
+    }
+
+    bench.print("carryless multiplication per product", {"single", "batched"},
+            1e9 / a.size());
+
+    return int128(res[0][0]) == res[1][0] and int128(res[0][1]) == res[1][1];
+}
+
+bool mmo_hash(const vector<int128>& input)
+{
+    MMO mmo;
+    vector<int128> res[2];
+    KernelBenchmark bench(2);
+
+    for (int run = 0; run < bench.n_runs; run++)
+    {
+        res[0].resize(input.size());
+        bench.measure(0, [&]() {
+            for (size_t i = 0; i < input.size(); i += 8)
+                mmo.hashEightBlocks(&res[0][i].a, &input[i]);
+        });
+
+        res[1] = input;
+        bench.measure(1, [&]() {
+            mmo.hashBlocks(&res[1][0].a, &res[1][0].a, res[1].size());
+        });
+    }
+
+    bench.print("MMO hashing per OT", {"eight blocks", "batched"},
+            1e9 / input.size());
+
+    return res[0] == res[1];
+}
+
+bool expand(int n_squares)
+{
+    vector<PRNG> G(128);
+    BitMatrix res[2];
+    KernelBenchmark bench(2);
+
+    for (int i = 0; i < 2; i++)
+    {
+        res[i].resize(128 * n_squares);
+        for (int run = 0; run < bench.n_runs; run++)
+        {
+            octet seed[SEED_SIZE] = {};
+            for (auto& prng : G)
+                prng.SetSeed(seed);
+            Slice<BitMatrix> slice(res[i], 0, n_squares);
+            bench.measure(i, [&]() {
+                if (i)
+                    slice.randomize(128,
+                            [&](int j) -> PRNG& { return G[j]; });
+                else
+                    for (int j = 0; j < 128; j++)
+                        slice.randomize(j, G[j]);
+            });
+        }
+    }
+
+    bench.print("PRG expansion per OT", {"by row", "by square"},
+            1e9 / (128 * n_squares));
+
+    return res[0] == res[1];
+}
+
+// per-triple kernels of SPDZ2k triple generation for one parameter set
+template<int K, int S>
+bool spdz2k(int n_triples)
+{
+    const int TAU = TAU(K, S);
+    typedef Z2kRectangle<TAU, K + S> rectangle_type;
+    SeededPRNG G;
+    vector<rectangle_type> outputs(n_triples);
+    vector<Z2<K + S>> bs(n_triples);
+    BitVector as(TAU * n_triples);
+    for (auto& x : outputs)
+        x.randomize(G);
+    for (auto& x : bs)
+        x.randomize(G);
+    as.randomize(G);
+
+    vector<PlainTriple_<Z2<K + 2 * S>, Z2<K + S>, 2>> triples(n_triples);
+    rectangle_type c;
+    KernelBenchmark bench(3);
+    bool ok = true;
+    for (int run = 0; run < bench.n_runs; run++)
+    {
+        octet seed[SEED_SIZE] = {};
+        PRNG shared;
+        shared.SetSeed(seed);
+        Timer timers[3];
+        for (int j = 0; j < n_triples; j++)
+        {
+            BitVector a(as.get_ptr_to_bit(j, TAU), TAU);
+            timers[0].start();
+            c.mul(a, bs[j]);
+            timers[0].stop();
+            timers[1].start();
+            c += outputs[j];
+            timers[1].stop();
+            timers[2].start();
+            triples[j].amplify(a, bs[j], c, shared);
+            timers[2].stop();
+        }
+        for (int i = 0; i < 3; i++)
+            bench.record(i, timers[i].elapsed());
+    }
+
+    // reference for the last triple
+    octet seed[SEED_SIZE] = {};
+    PRNG shared;
+    shared.SetSeed(seed);
+    for (int j = 0; j < n_triples - 1; j++)
+        for (int k = 0; k < 2 * TAU; k++)
+            Z2<K + S>().randomize(shared);
+    BitVector a(as.get_ptr_to_bit(n_triples - 1, TAU), TAU);
+    for (int i = 0; i < 2; i++)
+    {
+        Z2<K + S> aa, cc;
+        for (int k = 0; k < TAU; k++)
+        {
+            Z2<K + S> r;
+            r.randomize(shared);
+            if (a.get_bit(k))
+            {
+                aa += r;
+                ok &= c.rows[k] == outputs.back().rows[k] + bs.back();
+            }
+            else
+                ok &= c.rows[k] == outputs.back().rows[k];
+            cc += Z2<K + S>::Mul(r, c.rows[k]);
+        }
+        ok &= aa == triples.back().a[i] and cc == triples.back().c[i];
+    }
+
+    bench.print("SPDZ2k " + to_string(K) + "+" + to_string(S) + " per triple",
+            {"bit products", "addition", "amplification"}, 1e9 / n_triples);
+    return ok;
+}
+
+int main(int argc, const char** argv)
+{
+    int n_squares = argc > 1 ? atoi(argv[1]) : 1000;
+    SeededPRNG G;
+
+    vector<square128> squares(n_squares);
+    for (auto& square : squares)
+        square.randomize(G);
+
+    vector<int128> a(128 * n_squares), b(a.size());
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        a[i] = G.get_doubleword();
+        b[i] = G.get_doubleword();
+    }
+
+    bool ok = true;
+    for (bool wide : {false, true})
+        ok &= transpose(squares, wide);
+    ok &= mul(a, b);
+    ok &= mmo_hash(a);
+    ok &= expand(n_squares);
+    ok &= spdz2k<64, 64>(n_squares);
+    ok &= spdz2k<64, 48>(n_squares);
+    ok &= spdz2k<72, 48>(n_squares);
+
+    if (not ok)
+    {
+        cerr << "kernel mismatch" << endl;
+        return 1;
+    }
+}
@@ -11,7 +11,9 @@ int main(int argc, char** argv)
     int lgp = gfp0::size_in_bits();
     if (argc > 1)
         lgp = atoi(argv[1]);
-    if (argc > 2)
+    if (argc > 3 and string(argv[3]) == "special")
+        cout << generate_special_prime(lgp, 1 << abs(atoi(argv[2]))) << endl;
+    else if (argc > 2)
         cout << generate_prime(lgp, 1 << abs(atoi(argv[2])), atoi(argv[2]) <= 0) << endl;
     else
         cout << SPDZ_Data_Setup_Primes(lgp) << endl;
@@ -0,0 +1,82 @@
+/*
+ * z2k-kernels.cpp
+ *
+ * Benchmark and cross-check vectorized arithmetic modulo 2^k
+ *
+ */
+
+#include "Math/Z2k.hpp"
+#include "Math/ring_vectors.h"
+#include "Tools/random.h"
+#include "Tools/KernelBenchmark.h"
+
+#include <iostream>
+#include <vector>
+using namespace std;
+
+template<int K, int S>
+bool run(size_t n)
+{
+    typedef Z2<K> T;
+    typedef Z2<S> U;
+
+    SeededPRNG G;
+    vector<T> x(n), y(n), expected(n), res(n);
+    vector<U> chi(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i].randomize(G);
+        y[i].randomize(G);
+        chi[i].randomize(G);
+    }
+
+    // scalar and vectorized
+    KernelBenchmark add(2), mul(2), dot(2);
+    T dot_expected, dot_res;
+    for (int run = 0; run < add.n_runs; run++)
+    {
+        add.measure(0, [&]() {
+            for (size_t i = 0; i < n; i++)
+                expected[i] = x[i] + y[i];
+        });
+        add.measure(1, [&]() { vector_add(res.data(), x.data(), y.data(), n); });
+        if (res != expected)
+            return false;
+
+        mul.measure(0, [&]() {
+            for (size_t i = 0; i < n; i++)
+                expected[i] = x[i] * y[i];
+        });
+        mul.measure(1, [&]() { vector_mul(res.data(), x.data(), y.data(), n); });
+        if (res != expected)
+            return false;
+
+        dot.measure(0, [&]() {
+            dot_expected = {};
+            for (size_t i = 0; i < n; i++)
+                dot_expected += x[i] * chi[i];
+        });
+        dot.measure(1, [&]() { dot_res = vector_dot(x.data(), chi.data(), n); });
+        if (dot_res != dot_expected)
+            return false;
+    }
+
+    string label = "Z2^" + to_string(K) + " and Z2^" + to_string(S) + " ";
+    add.print(label + "add", {"scalar", "vectorized"}, 1e9 / n);
+    mul.print(label + "mul", {"scalar", "vectorized"}, 1e9 / n);
+    dot.print(label + "dot", {"scalar", "vectorized"}, 1e9 / n);
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t n = argc > 1 ? atoi(argv[1]) : 100000;
+
+    bool ok = run<40, 40>(n) and run<72, 72>(n) and run<112, 48>(n)
+            and run<128, 64>(n) and run<128, 128>(n);
+    if (not ok)
+    {
+        cerr << "wrong results" << endl;
+        return 1;
+    }
+}
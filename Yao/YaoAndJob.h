@@ -29,13 +29,16 @@ class YaoAndJob
 	bool repeat;
 	typename T::Party& party;
 	YaoJobType type;
+	size_t total_gates;
 
 public:
 	Worker<YaoAndJob> worker;
+	Timer busy;
 
 	YaoAndJob(typename T::Party& party) :
 			processor(0), args(0), start(0), end(0), n_gates(0), gate(0),
-			counter(0), repeat(0), party(party), type(YAO_NO_JOB)
+			counter(0), repeat(0), party(party), type(YAO_NO_JOB),
+			total_gates(0)
 	{
 		prng.ReSeed();
 	}
@@ -65,14 +68,30 @@ public:
 		worker.request(*this);
 	}
 
+	size_t get_n_gates()
+	{
+		return total_gates;
+	}
+
 	int run()
 	{
+		TimeScope ts(busy);
 		switch(type)
 		{
 		case YAO_AND_JOB:
-			T::and_(processor->S, *args, start, end, n_gates, gate, counter,
-					prng, timers, repeat, party);
+		{
+			// take chunks until none are left
+			typename T::Party::AndChunk chunk;
+			while (party.next_chunk(chunk))
+			{
+				long chunk_counter = counter + chunk.offset;
+				T::and_(processor->S, *args, chunk.start, chunk.end,
+						chunk.n_gates, gate + chunk.offset, chunk_counter,
+						prng, timers, repeat, party);
+				total_gates += chunk.n_gates;
+			}
 			break;
+		}
 		case YAO_XOR_JOB:
 			T::xors(*processor, *args, start, end);
 			break;
@@ -14,9 +14,11 @@
 #include "Tools/Exceptions.h"
 #include "GC/RuntimeBranching.h"
 #include "GC/ThreadMaster.h"
+#include "Tools/time-func.h"
 #include "YaoAndJob.h"
 
 #include <thread>
+#include <atomic>
 
 template<class T>
 class YaoCommon : public GC::RuntimeBranching
@@ -25,7 +27,15 @@ class YaoCommon : public GC::RuntimeBranching
 
     GC::ThreadMaster<GC::Secret<T>>& master;
 
+    atomic<size_t> next_and_chunk;
+
 public:
+    // part of AND arguments with the offset of its first gate
+    struct AndChunk
+    {
+        size_t start, end, n_gates, offset;
+    };
+
     static const int DONE = -1;
     static const int MORE = -2;
 
@@ -33,13 +43,25 @@ public:
 
     vector<YaoAndJob<T>*> jobs;
 
+    // AND arguments split in small chunks for the worker threads to take
+    vector<int> and_args;
+    vector<AndChunk> and_chunks;
+    Timer and_jobs_timer;
+
     YaoCommon(GC::ThreadMaster<GC::Secret<T>>& master) :
-        log_n_threads(8), master(master), counter(0)
+        log_n_threads(8), master(master), next_and_chunk(0), counter(0)
     {
     }
 
     ~YaoCommon()
     {
+#ifdef VERBOSE
+        if (and_jobs_timer.elapsed())
+            for (size_t i = 0; i < jobs.size(); i++)
+                cerr << "AND worker " << i << ": " << jobs[i]->get_n_gates()
+                        << " gates, " << 100 * jobs[i]->busy.elapsed()
+                                / and_jobs_timer.elapsed() << "% busy" << endl;
+#endif
         for (auto& job : jobs)
             delete job;
     }
@@ -66,8 +88,20 @@ public:
         return max(1u, thread::hardware_concurrency() / master.machine.nthreads);
     }
 
-    vector<array<size_t, 2>> get_splits(const vector<int>& args, int threshold,
-            int total);
+    int split_ands(const vector<int>& args, bool repeat, size_t grain);
+
+    bool next_chunk(AndChunk& chunk)
+    {
+        size_t i = next_and_chunk++;
+        if (i >= and_chunks.size())
+            return false;
+        chunk = and_chunks[i];
+        return true;
+    }
+
+    void run_and_jobs(GC::Processor<GC::Secret<T>>& processor,
+            const vector<int>& args, YaoGate* gates, long counter,
+            bool repeat, size_t grain);
 
     void wait(int n_threads)
     {
@@ -5,23 +5,65 @@
 
 #include "YaoCommon.h"
 
+/*
+ * Split tuples of AND arguments at register boundaries
+ * so that every chunk contains about the same number of gates.
+ */
 template<class T>
-vector<array<size_t, 2> > YaoCommon<T>::get_splits(const vector<int>& args,
-		int threshold, int total)
+int YaoCommon<T>::split_ands(const vector<int>& args, bool repeat,
+		size_t grain)
 {
-	vector<array<size_t, 2>> res;
-	size_t max_gates_per_thread = max(threshold / 2,
-			(total + get_n_worker_threads() - 1) / get_n_worker_threads());
-	size_t i_gate = 0;
+	int dl = GC::Secret<T>::default_length;
+	grain = max(grain / dl, size_t(1)) * dl;
+	and_args.clear();
+	and_chunks.clear();
+	next_and_chunk = 0;
+	size_t start = 0, n_gates = 0, offset = 0;
+
+	auto finish_chunk = [&]()
+	{
+		if (n_gates)
+			and_chunks.push_back({start, and_args.size(), n_gates, offset});
+		offset += n_gates;
+		start = and_args.size();
+		n_gates = 0;
+	};
+
 	for (auto it = args.begin(); it < args.end(); it += 4)
 	{
-		i_gate += *it;
-		auto end = it + 4;
-		if (i_gate >= max_gates_per_thread or end >= args.end())
+		size_t n = *it;
+		for (size_t done = 0; done < n;)
 		{
-			res.push_back({{i_gate, size_t(end - args.begin())}});
-			i_gate = 0;
+			size_t m = min(n - done, (grain - n_gates) / dl * dl);
+			if (m == 0)
+			{
+				finish_chunk();
+				continue;
+			}
+			int j = done / dl;
+			and_args.insert(and_args.end(), {int(m), *(it + 1) + j,
+					*(it + 2) + j, *(it + 3) + (repeat ? 0 : j)});
+			n_gates += m;
+			done += m;
+			if (n_gates >= grain)
+				finish_chunk();
 		}
 	}
-	return res;
+
+	finish_chunk();
+	return offset;
+}
+
+template<class T>
+void YaoCommon<T>::run_and_jobs(GC::Processor<GC::Secret<T>>& processor,
+		const vector<int>& args, YaoGate* gates, long counter, bool repeat,
+		size_t grain)
+{
+	TimeScope ts(and_jobs_timer);
+	split_ands(args, repeat, grain);
+	int n_jobs = min(jobs.size(), and_chunks.size());
+	for (int i = 0; i < n_jobs; i++)
+		jobs[i]->dispatch(YAO_AND_JOB, processor, and_args, 0, 0, 0, gates,
+				counter, repeat);
+	wait(n_jobs);
 }
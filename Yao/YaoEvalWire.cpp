@@ -46,19 +46,10 @@ void YaoEvalWire::and_(GC::Processor<GC::Secret<YaoEvalWire> >& processor,
 	}
 
 	processor.complexity += total;
-	int i_thread = 0, start = 0;
-	for (auto& x : party.get_splits(args, threshold, total))
-	{
-		auto i_gate = x[0];
-		auto end = x[1];
-		YaoGate* gate = (YaoGate*) party.gates.consume(
-				i_gate * sizeof(YaoGate));
-		party.jobs[i_thread++]->dispatch(YAO_AND_JOB, processor, args, start,
-				end, i_gate, gate, party.get_gate_id(), repeat);
-		party.counter += i_gate;
-		start = end;
-	}
-	party.wait(i_thread);
+	YaoGate* gate = (YaoGate*) party.gates.consume(total * sizeof(YaoGate));
+	party.run_and_jobs(processor, args, gate, party.get_gate_id(), repeat,
+			threshold / 2);
+	party.counter += total;
 }
 
 template<bool repeat>
@@ -86,23 +77,43 @@ void YaoEvalWire::and_(StackedVector<GC::Secret<YaoEvalWire> >& S,
 {
 	int dl = GC::Secret<YaoEvalWire>::default_length;
 	MMO& mmo = evaluator.mmo;
+	const int N = YaoGate::N_EVAL_HASHES;
+	Key labels[YAO_HASH_BATCH * N];
+	Key hashes[YAO_HASH_BATCH * N];
+	array<YaoEvalWire*, 3> wires[YAO_HASH_BATCH];
+	int n_gates = 0;
+
+	// hash for several gates at once to fill the AES pipeline
+	auto eval = [&]()
+	{
+		if (n_gates == YAO_HASH_BATCH)
+			mmo.hash<YAO_HASH_BATCH * N>(hashes, labels);
+		else
+			for (int i = 0; i < n_gates; i++)
+				mmo.hash<N>(hashes + i * N, labels + i * N);
+		for (int i = 0; i < n_gates; i++)
+			(gates++)->eval(*wires[i][0], hashes + i * N, *wires[i][1],
+					*wires[i][2]);
+		n_gates = 0;
+	};
+
+	auto add = [&](YaoEvalWire& out, YaoEvalWire& left, YaoEvalWire& right)
+	{
+		gate_id++;
+		YaoGate::eval_inputs(labels + n_gates * N, left.key(), right.key(),
+				gate_id);
+		wires[n_gates++] = {{&out, &left, &right}};
+		if (n_gates == YAO_HASH_BATCH)
+			eval();
+	};
+
 	for (auto it = args.begin() + start; it < args.begin() + end; it += 4)
 	{
 		if (*it == 1)
 		{
-			Key label[YaoGate::N_EVAL_HASHES];
-			Key hash[YaoGate::N_EVAL_HASHES];
-			gate_id++;
-			YaoGate::eval_inputs(label,
-					S[*(it + 2)].get_reg(0).key(),
-					S[*(it + 3)].get_reg(0).key(),
-					gate_id);
-			mmo.hash<YaoGate::N_EVAL_HASHES>(hash, label);
 			auto& out = S[*(it + 1)];
 			out.resize_regs(1);
-			YaoGate& gate = *gates;
-			gates++;
-			gate.eval(out.get_reg(0), hash, S[*(it + 2)].get_reg(0),
+			add(out.get_reg(0), S[*(it + 2)].get_reg(0),
 					S[*(it + 3)].get_reg(0));
 		}
 		else
@@ -116,23 +127,13 @@ void YaoEvalWire::and_(StackedVector<GC::Secret<YaoEvalWire> >& S,
 				int n = min(dl, *it - j * dl);
 				out.resize_regs(n);
 				for (int k = 0; k < n; k++)
-				{
-					Key label[YaoGate::N_EVAL_HASHES];
-					Key hash[YaoGate::N_EVAL_HASHES];
-					auto& left_wire = left.get_reg(k);
-					auto& right_key = right.get_reg(repeat ? 0 : k).key();
-					gate_id++;
-					YaoGate::eval_inputs(label, left_wire.key(), right_key,
-							gate_id);
-					mmo.hash<YaoGate::N_EVAL_HASHES>(hash, label);
-					auto& right_wire = right.get_reg(repeat ? 0 : k);
-					YaoGate& gate = *gates;
-					gates++;
-					gate.eval(out.get_reg(k), hash, left_wire, right_wire);
-				}
+					add(out.get_reg(k), left.get_reg(k),
+							right.get_reg(repeat ? 0 : k));
 			}
 		}
 	}
+
+	eval();
 }
 
 template<class T>
@@ -55,26 +55,13 @@ void YaoGarbleWire::and_multithread(GC::Processor<GC::Secret<YaoGarbleWire> >& p
 
 	party.and_prepare_timer.start();
 	processor.complexity += total;
-	SendBuffer& gates = party.gates;
-	gates.allocate(total * sizeof(YaoGate));
-	int i_thread = 0, start = 0;
-	for (auto& x : party.get_splits(args, party.get_threshold(), total))
-	{
-		int i_gate = x[0];
-		int end = x[1];
-		YaoGate* gate = (YaoGate*)gates.end();
-		gates.skip(i_gate * sizeof(YaoGate));
-		party.timers["Dispatch"].start();
-		party.jobs[i_thread++]->dispatch(YAO_AND_JOB, processor, args, start,
-				end, i_gate, gate, party.get_gate_id(), repeat);
-		party.timers["Dispatch"].stop();
-		party.counter += i_gate;
-		i_gate = 0;
-		start = end;
-	}
+	YaoGate* gate = (YaoGate*) party.gates.allocate_and_skip(
+			total * sizeof(YaoGate));
 	party.and_prepare_timer.stop();
 	party.and_wait_timer.start();
-	party.wait(i_thread);
+	party.run_and_jobs(processor, args, gate, party.get_gate_id(), repeat,
+			party.get_threshold() / 2);
+	party.counter += total;
 	party.and_wait_timer.stop();
 }
 
@@ -105,24 +92,50 @@ void YaoGarbleWire::and_(StackedVector<GC::Secret<YaoGarbleWire> >& S,
 	int dl = GC::Secret<YaoGarbleWire>::default_length;
 	Key left_delta = delta.doubling(1);
 	Key right_delta = delta.doubling(2);
-	Key labels[4];
-	Key hashes[4];
+	const int N = YaoGate::N_GARBLE_HASHES;
+	Key labels[YAO_HASH_BATCH * N];
+	Key hashes[YAO_HASH_BATCH * N];
+	array<YaoGarbleWire*, 3> wires[YAO_HASH_BATCH];
+	int n_gates = 0;
 	MMO& mmo = garbler.mmo;
+
+	// hash for several gates at once to fill the AES pipeline
+	auto garble = [&]()
+	{
+		if (n_gates == YAO_HASH_BATCH)
+			mmo.hash<YAO_HASH_BATCH * N>(hashes, labels);
+		else
+			for (int i = 0; i < n_gates; i++)
+				mmo.hash<N>(hashes + i * N, labels + i * N);
+		for (int i = 0; i < n_gates; i++)
+		{
+			auto& out = *wires[i][0];
+			YaoGate::randomize(out, prng);
+			(gate++)->and_garble(out, hashes + i * N, *wires[i][1],
+					*wires[i][2], delta);
+		}
+		n_gates = 0;
+	};
+
+	auto add = [&](YaoGarbleWire& out, YaoGarbleWire& left,
+			YaoGarbleWire& right)
+	{
+		counter++;
+		YaoGate::E_inputs(labels + n_gates * N, left, right, left_delta,
+				right_delta, counter);
+		wires[n_gates++] = {{&out, &left, &right}};
+		if (n_gates == YAO_HASH_BATCH)
+			garble();
+	};
+
 	for (auto it = args.begin() + start; it < args.begin() + end; it += 4)
 	{
 		if (*it == 1)
 		{
-			counter++;
-			YaoGate::E_inputs(labels, S[*(it + 2)].get_reg(0),
-					S[*(it + 3)].get_reg(0), left_delta, right_delta,
-					counter);
-			mmo.hash<4>(hashes, labels);
 			auto& out = S[*(it + 1)];
 			out.resize_regs(1);
-			YaoGate::randomize(out.get_reg(0), prng);
-			(gate++)->and_garble(out.get_reg(0), hashes,
-					S[*(it + 2)].get_reg(0),
-					S[*(it + 3)].get_reg(0), garbler.get_delta());
+			add(out.get_reg(0), S[*(it + 2)].get_reg(0),
+					S[*(it + 3)].get_reg(0));
 		}
 		else
 		{
@@ -137,24 +150,13 @@ void YaoGarbleWire::and_(StackedVector<GC::Secret<YaoGarbleWire> >& S,
 					auto& left_wire = S[*(it + 2) + j].get_reg(k);
 					auto& right_wire = S[*(it + 3) + (repeat ? 0 : j)].get_reg(
 							repeat ? 0 : k);
-					counter++;
-					YaoGate::E_inputs(labels, left_wire,
-							right_wire, left_delta, right_delta, counter);
-					mmo.hash<4>(hashes, labels);
-					//timers["Inner ref"].start();
-					//timers["Inner ref"].stop();
-					//timers["Randomizing"].start();
-					out.get_reg(k).randomize(prng);
-					//timers["Randomizing"].stop();
-					//timers["Gate computation"].start();
-					(gate++)->and_garble(out.get_reg(k), hashes,
-							left_wire, right_wire,
-							garbler.get_delta());
-					//timers["Gate computation"].stop();
+					add(out.get_reg(k), left_wire, right_wire);
 				}
 			}
 		}
 	}
+
+	garble();
 }
 
 
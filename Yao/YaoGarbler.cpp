@@ -20,7 +20,7 @@ thread_local YaoGarbler* YaoGarbler::singleton = 0;
 YaoGarbler::YaoGarbler(int thread_num, YaoGarbleMaster& master) :
 		GC::Thread<GC::Secret<YaoGarbleWire>>(thread_num, master),
 		YaoCommon<YaoGarbleWire>(master),
-		master(master),
+		master(master), sender(0), in_flight(0),
 		and_proc_timer(CLOCK_PROCESS_CPUTIME_ID),
 		and_main_thread_timer(CLOCK_THREAD_CPUTIME_ID),
 		player(master.N, 1, "thread" + to_string(thread_num)),
@@ -28,6 +28,8 @@ YaoGarbler::YaoGarbler(int thread_num, YaoGarbleMaster& master) :
 				master.get_delta().get<__m128i>(), SENDER, true))
 {
 	prng.ReSeed();
+	send_ahead = stoi(
+			OnlineOptions::singleton.option_value("yao_send_ahead", "0"));
 	set_n_program_threads(master.machine.nthreads);
 	this->init(*this);
 	if (continuous())
@@ -43,6 +45,12 @@ YaoGarbler::YaoGarbler(int thread_num, YaoGarbleMaster& master) :
 
 YaoGarbler::~YaoGarbler()
 {
+	if (sender)
+	{
+		to_send.stop();
+		sender->join();
+		delete sender;
+	}
 #ifdef VERBOSE
 	cerr << "Number of AND gates: " << counter << endl;
 #endif
@@ -64,6 +72,7 @@ void YaoGarbler::run(GC::Program& program)
 	GC::BreakType b = GC::TIME_BREAK;
 	while(GC::DONE_BREAK != b)
 	{
+		bool round_trip = false;
 		try
 		{
 			b = program.execute(processor, master.memory, -1);
@@ -73,8 +82,12 @@ void YaoGarbler::run(GC::Program& program)
 			if (not continuous())
 				throw runtime_error("run-time branching impossible with garbling at once");
 			processor.PC--;
+			round_trip = true;
 		}
 		send(*P);
+		// the main thread is going to use the connection
+		if (round_trip or GC::DONE_BREAK == b)
+			finish_sending();
 		gates.clear();
 		output_masks.clear();
 		if (continuous())
@@ -98,13 +111,51 @@ void YaoGarbler::send(Player& P)
 			<< output_masks.size() << " output masks at " << processor.PC
 			<< " in thread " << thread_num << endl;
 #endif
-	P.send_long(1, YaoCommon::MORE);
 	size_t size = gates.size();
+	if (send_ahead > 0)
+	{
+		if (not sender)
+			sender = new std::thread(&YaoGarbler::send_thread, this);
+		if (in_flight >= send_ahead)
+		{
+			batch_type* batch;
+			sent.pop(batch);
+			delete batch;
+			in_flight--;
+		}
+		to_send.push(new batch_type{{gates, output_masks}});
+		in_flight++;
+		gates.allocate(2 * size);
+		return;
+	}
+	P.send_long(1, YaoCommon::MORE);
 	P.send_to(1, gates);
 	gates.allocate(2 * size);
 	P.send_to(1, output_masks);
 }
 
+void YaoGarbler::send_thread()
+{
+	batch_type* batch;
+	while (to_send.pop(batch))
+	{
+		P->send_long(1, YaoCommon::MORE);
+		for (auto& os : *batch)
+			P->send_to(1, os);
+		sent.push(batch);
+	}
+}
+
+void YaoGarbler::finish_sending()
+{
+	for (; in_flight > 0; in_flight--)
+	{
+		batch_type* batch;
+		sent.pop(batch);
+		delete batch;
+	}
+}
+
 void YaoGarbler::process_receiver_inputs()
 {
 	while (not receiver_input_keys.empty())
@@ -15,6 +15,7 @@
 #include "GC/Secret.h"
 #include "Networking/Player.h"
 #include "OT/OTExtensionWithMatrix.h"
+#include "Tools/WaitQueue.h"
 
 #include <thread>
 
@@ -33,6 +34,15 @@ protected:
 
 	SendBuffer gates;
 
+	// batches of gates and output masks handed to the sender thread
+	typedef array<octetStream, 2> batch_type;
+	WaitQueue<batch_type*> to_send, sent;
+	std::thread* sender;
+	int send_ahead, in_flight;
+
+	void send_thread();
+	void finish_sending();
+
 	Timer and_timer;
 	Timer and_proc_timer;
 	Timer and_main_thread_timer;
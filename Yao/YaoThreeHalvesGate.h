@@ -0,0 +1,199 @@
+/*
+ * YaoThreeHalvesGate.h
+ *
+ */
+
+#ifndef YAO_YAOTHREEHALVESGATE_H_
+#define YAO_YAOTHREEHALVESGATE_H_
+
+#include "BMR/Key.h"
+#include "YaoGarbleWire.h"
+#include "YaoEvalWire.h"
+
+/**
+ * Garbled AND gate after Rosulek and Roy
+ * (https://eprint.iacr.org/2021/749), i.e., three half-size
+ * ciphertexts plus 15 encrypted control bits.
+ * The evaluator computes each half of the output label from
+ * the halves of the input labels as selected by the control bits,
+ * which are randomized such that they do not reveal the inputs.
+ */
+class YaoThreeHalvesGate
+{
+	uint64_t G[3];
+	uint16_t control;
+
+	static uint64_t low(const Key& key)
+	{
+		return _mm_cvtsi128_si64(key.r);
+	}
+
+	static uint64_t high(const Key& key)
+	{
+		return _mm_cvtsi128_si64(_mm_unpackhi_epi64(key.r, key.r));
+	}
+
+	// pad for the control bits
+	static int pad(const Key& hash)
+	{
+		return high(hash) & 31;
+	}
+
+	static uint64_t left_half(int R, const Key& left, const Key& right);
+	static uint64_t right_half(int R, const Key& left, const Key& right);
+
+public:
+	static const int N_EVAL_HASHES = 3;
+	static const int N_GARBLE_HASHES = 6;
+
+	static void eval_inputs(Key* output, const Key& left, const Key& right,
+			long T);
+	static void E_inputs(Key* output, const YaoGarbleWire& left,
+			const YaoGarbleWire& right, const Key& left_delta,
+			const Key& right_delta, long T);
+	static void randomize(YaoGarbleWire& out, PRNG& prng)
+	{
+		out.randomize(prng);
+	}
+	static Key garble_public_input(bool value, Key delta)
+	{
+		return value ? delta : 0;
+	}
+
+	YaoThreeHalvesGate() {}
+	YaoThreeHalvesGate(YaoGarbleWire&, const YaoGarbleWire&,
+			const YaoGarbleWire&, Function);
+	void and_garble(YaoGarbleWire& out, const Key* hashes,
+			const YaoGarbleWire& left, const YaoGarbleWire& right, Key delta);
+	void eval(YaoEvalWire&, const YaoEvalWire&,
+			const YaoEvalWire&);
+	void eval(YaoEvalWire& out, const Key* hashes, const YaoEvalWire& left,
+			const YaoEvalWire& right);
+} __attribute__((packed));
+
+/*
+ * Control bits R[L,1], R[L,2], R[L,3], R[R,0], R[R,1] select
+ * the halves (A_L, A_R, B_L, B_R) of the input labels,
+ * with R[L,0] = R[R,3] = 0 and R[R,2] = R[L,1].
+ */
+inline uint64_t YaoThreeHalvesGate::left_half(int R, const Key& left,
+		const Key& right)
+{
+	uint64_t res = 0;
+	if (R & 1)
+		res ^= high(left);
+	if (R & 2)
+		res ^= low(right);
+	if (R & 4)
+		res ^= high(right);
+	return res;
+}
+
+inline uint64_t YaoThreeHalvesGate::right_half(int R, const Key& left,
+		const Key& right)
+{
+	uint64_t res = 0;
+	if (R & 8)
+		res ^= low(left);
+	if (R & 16)
+		res ^= high(left);
+	if (R & 1)
+		res ^= low(right);
+	return res;
+}
+
+inline void YaoThreeHalvesGate::E_inputs(Key* output,
+		const YaoGarbleWire& left, const YaoGarbleWire& right,
+		const Key& left_delta, const Key&, long T)
+{
+	auto l = left.full_key().doubling(1);
+	auto r = right.full_key().doubling(1);
+	long j = 3 * T;
+	output[0] = l ^ j;
+	output[1] = output[0] ^ left_delta;
+	output[2] = r ^ (j + 1);
+	output[3] = output[2] ^ left_delta;
+	output[4] = l ^ r ^ (j + 2);
+	output[5] = output[4] ^ left_delta;
+}
+
+inline void YaoThreeHalvesGate::and_garble(YaoGarbleWire& out,
+		const Key* hashes, const YaoGarbleWire& left,
+		const YaoGarbleWire& right, Key delta)
+{
+	bool pa = left.mask();
+	bool pb = right.mask();
+
+	// output label has been randomized, use it for the control matrix
+	uint64_t random = low(out.full_key());
+	bool u = random & 1, v = random & 2;
+	int c = (random >> 2) & 7;
+
+	Key W[2][2];
+	control = 0;
+	for (int i = 0; i < 2; i++)
+		for (int j = 0; j < 2; j++)
+		{
+			bool a = i ^ pa;
+			bool b = j ^ pb;
+			int R = (c & 1) ^ ((u & a) ^ (v & b));
+			R |= (((c >> 1) & 1) ^ a ^ (u & b)) << 1;
+			R |= (((c >> 2) & 1) ^ (v & a)) << 2;
+			R |= (((c >> 1) & 1) ^ u ^ (u & b)) << 3;
+			R |= (((c >> 2) & 1) ^ v ^ (v & a) ^ b) << 4;
+			if (2 * i + j < 3)
+				control |= (R ^ pad(hashes[a]) ^ pad(hashes[2 + b]))
+						<< (5 * (2 * i + j));
+			Key A = left.full_key() ^ (a ? delta : 0);
+			Key B = right.full_key() ^ (b ? delta : 0);
+			uint64_t ab = low(hashes[4 + (a ^ b)]);
+			W[i][j] = {
+					(long long) (low(hashes[2 + b]) ^ ab ^ right_half(R, A, B)),
+					(long long) (low(hashes[a]) ^ ab ^ left_half(R, A, B)) };
+			if (a & b)
+				W[i][j] ^= delta;
+		}
+
+	Key C = W[0][0];
+	Key U = W[1][1] ^ C;
+	G[0] = low(U);
+	G[1] = high(U);
+	G[2] = high(W[1][0] ^ C);
+	out.set_full_key(C);
+}
+
+inline void YaoThreeHalvesGate::eval_inputs(Key* output, const Key& left,
+		const Key& right, long T)
+{
+	long j = 3 * T;
+	output[0] = left.doubling(1) ^ j;
+	output[1] = right.doubling(1) ^ (j + 1);
+	output[2] = (left ^ right).doubling(1) ^ (j + 2);
+}
+
+inline void YaoThreeHalvesGate::eval(YaoEvalWire& out, const Key* hashes,
+		const YaoEvalWire& left, const YaoEvalWire& right)
+{
+	bool sa = left.external();
+	bool sb = right.external();
+	int row = 2 * sa + sb;
+	int E = control ^ (control >> 5) ^ (control >> 10);
+	if (row < 3)
+		E = control >> (5 * row);
+	int R = (E ^ pad(hashes[0]) ^ pad(hashes[1])) & 31;
+	uint64_t ab = low(hashes[2]);
+	uint64_t L = low(hashes[0]) ^ ab ^ left_half(R, left.key(), right.key());
+	uint64_t H = low(hashes[1]) ^ ab ^ right_half(R, left.key(), right.key());
+	if (sa)
+		L ^= G[0];
+	if (sb)
+		H ^= G[1];
+	if (sa ^ sb)
+	{
+		L ^= G[2];
+		H ^= G[2];
+	}
+	out.set(Key((long long) H, (long long) L));
+}
+
+#endif /* YAO_YAOTHREEHALVESGATE_H_ */
@@ -29,6 +29,9 @@ public:
 	static void andm(GC::Processor<T>& processor,
 			const BaseInstruction& instruction);
 
+	template<class T>
+	static void andrsvec(GC::Processor<T>& processor, const vector<int>& args);
+
 	void XOR(const YaoWire& left, const YaoWire& right)
 	{
 		key_ = left.key_ ^ right.key_;
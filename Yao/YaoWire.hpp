@@ -46,6 +46,25 @@ void YaoWire::xors(GC::Processor<T>& processor, const vector<int>& args,
 	processor.xors(args, start, end);
 }
 
+template<class T>
+void YaoWire::andrsvec(GC::Processor<T>& processor, const vector<int>& args)
+{
+	// same as ANDS with the common operand on the right
+	vector<int> and_args;
+	auto it = args.begin();
+	while (it < args.end())
+	{
+		int n_args = (*it++ - 3) / 2;
+		int size = *it++;
+		int base = *(it + n_args);
+		for (int j = 0; j < n_args; j++)
+			and_args.insert(and_args.end(),
+					{size, *(it + j), *(it + n_args + 1 + j), base});
+		it += 2 * n_args + 1;
+	}
+	T::part_type::ands(processor, and_args);
+}
+
 template<class T>
 void YaoWire::andm(GC::Processor<T>& processor,
 		const BaseInstruction& instruction)
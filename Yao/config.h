@@ -10,13 +10,21 @@
 
 //#define CHECK_BUFFER
 
+// number of AND gates to hash at once
+#ifndef YAO_HASH_BATCH
+#define YAO_HASH_BATCH 8
+#endif
+
 class YaoFullGate;
 class YaoHalfGate;
+class YaoThreeHalvesGate;
 
-#ifndef FULL_GATES
-typedef YaoHalfGate YaoGate;
-#else
+#if defined(FULL_GATES)
 typedef YaoFullGate YaoGate;
+#elif defined(THREE_HALVES_GATES)
+typedef YaoThreeHalvesGate YaoGate;
+#else
+typedef YaoHalfGate YaoGate;
 #endif
 
 #endif /* YAO_CONFIG_H_ */